@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Allocation tracking shared by the benchmarks. This replaces the global
+operator new and delete, so it must be included by exactly one source file
+of each benchmark executable. Define STBI_MALLOC, STBI_REALLOC, and STBI_FREE
+as alloc_stats::allocate, reallocate, and release to also count stb_image's
+allocations.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// We count allocations through operator new, and through stb_image by
+// overriding its allocator. Libraries that call malloc() directly (Zstandard,
+// Basis Universal) aren't counted.
+namespace alloc_stats {
+std::atomic<uint64_t> g_count{0};
+std::atomic<int64_t>  g_current{0};
+std::atomic<int64_t>  g_peak{0};
+
+// Each allocation stores its size in a header, so that frees can be tracked.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+void* allocate(size_t size)
+{
+  char* block = static_cast<char*>(std::malloc(size + kHeaderSize));
+  if(block == nullptr)
+  {
+    return nullptr;
+  }
+  memcpy(block, &size, sizeof(size));
+  g_count++;
+  const int64_t current = (g_current += int64_t(size));
+  int64_t       peak    = g_peak.load();
+  while(current > peak && !g_peak.compare_exchange_weak(peak, current))
+  {
+  }
+  return block + kHeaderSize;
+}
+
+void release(void* p)
+{
+  if(p == nullptr)
+  {
+    return;
+  }
+  char*  block = static_cast<char*>(p) - kHeaderSize;
+  size_t size  = 0;
+  memcpy(&size, block, sizeof(size));
+  g_current -= int64_t(size);
+  std::free(block);
+}
+
+void* reallocate(void* p, size_t newSize)
+{
+  void* result = allocate(newSize);
+  if(result != nullptr && p != nullptr)
+  {
+    size_t oldSize = 0;
+    memcpy(&oldSize, static_cast<char*>(p) - kHeaderSize, sizeof(oldSize));
+    memcpy(result, p, std::min(oldSize, newSize));
+    release(p);
+  }
+  return result;
+}
+
+// Starts a new measurement; peak usage is measured relative to now.
+void reset()
+{
+  g_count = 0;
+  g_peak  = g_current.load();
+}
+}  // namespace alloc_stats
+
+void* operator new(size_t size)
+{
+  void* p = alloc_stats::allocate(size);
+  if(p == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+void operator delete(void* p) noexcept
+{
+  alloc_stats::release(p);
+}
+void operator delete[](void* p) noexcept
+{
+  alloc_stats::release(p);
+}
+void operator delete(void* p, size_t) noexcept
+{
+  alloc_stats::release(p);
+}
+void operator delete[](void* p, size_t) noexcept
+{
+  alloc_stats::release(p);
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Compares two ways of batching BLAS builds without a device: building in
+input order, as nvvk::AccelerationStructureBuilder::cmdCreateBlas did before
+it used nvutils::planBuildBatches, and the planned order.
+
+For each distribution of BLAS sizes, `--count` BLAS are generated from a
+triangle count per BLAS, using rough bytes-per-triangle factors for the
+scratch and acceleration structure sizes. The scratch buffer is sized like
+AccelerationStructureBuilder::getScratchSize(`--scratch` MiB), and passes
+are limited to `--budget` MiB of acceleration structures.
+
+Distributions:
+- lognormal: a wide spread of sizes, as in scanned or CAD scenes
+- props: many small props and a few very large meshes (terrain, buildings)
+- uniform: sizes within one order of magnitude
+
+For each, this reports the number of batches (one build command and barrier
+each), the number of passes (one submit and compaction each), the largest
+pass (building in order overshoots the budget by up to one BLAS), how much
+of the scratch buffer the batches use on average, and the time to plan, as
+JSON.
+
+Example:
+  nvpro2_blas_batching_benchmark --count 20000 --scratch 128 --budget 512 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nvutils/build_batch_planner.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+// Rough sizes of an opaque, fast-trace BLAS per triangle
+constexpr uint64_t kScratchBytesPerTriangle = 64;
+constexpr uint64_t kResultBytesPerTriangle  = 112;
+// A common minAccelerationStructureScratchOffsetAlignment
+constexpr uint64_t kScratchAlignment = 128;
+
+struct Summary
+{
+  uint64_t batches     = 0;
+  uint64_t passes      = 0;
+  uint64_t maxPassSize = 0;    // Largest sum of acceleration structure sizes of a pass
+  double   scratchUsed = 0.0;  // Mean fraction of the scratch buffer used by a batch
+  double   planMs      = 0.0;
+};
+
+struct Result
+{
+  std::string distribution;
+  uint64_t    scratchCapacity = 0;
+  Summary     inOrder;
+  Summary     planned;
+  bool        ok = true;
+};
+
+uint64_t alignUp(uint64_t value)
+{
+  return (value + kScratchAlignment - 1) / kScratchAlignment * kScratchAlignment;
+}
+
+std::vector<nvutils::BuildBatchItem> generate(const std::string& distribution, uint32_t count, uint32_t seed)
+{
+  std::mt19937                         rng(seed);
+  std::vector<nvutils::BuildBatchItem> items(count);
+  for(nvutils::BuildBatchItem& item : items)
+  {
+    double triangles = 0;
+    if(distribution == "lognormal")
+    {
+      triangles = std::lognormal_distribution<double>(std::log(5000.0), 1.5)(rng);
+    }
+    else if(distribution == "props")
+    {
+      const bool large = std::uniform_real_distribution<double>(0.0, 1.0)(rng) < 0.02;
+      triangles = std::lognormal_distribution<double>(std::log(large ? 1'000'000.0 : 2000.0), large ? 0.7 : 0.8)(rng);
+    }
+    else
+    {
+      triangles = std::uniform_real_distribution<double>(10'000.0, 100'000.0)(rng);
+    }
+    const uint64_t t = std::clamp(uint64_t(triangles), uint64_t(1), uint64_t(20'000'000));
+    item             = {t * kScratchBytesPerTriangle + 4096, t * kResultBytesPerTriangle + 1024};
+  }
+  return items;
+}
+
+// Same as AccelerationStructureBuilder::getScratchSize
+uint64_t getScratchSize(uint64_t hintMaxBudget, const std::vector<nvutils::BuildBatchItem>& items)
+{
+  uint64_t maxScratch   = 0;
+  uint64_t totalScratch = 0;
+  for(const nvutils::BuildBatchItem& item : items)
+  {
+    maxScratch = std::max(maxScratch, alignUp(item.scratchSize));
+    totalScratch += alignUp(item.scratchSize);
+  }
+  return totalScratch <= hintMaxBudget ? totalScratch : std::max(maxScratch, hintMaxBudget);
+}
+
+// The loops of the former cmdCreateBlas / cmdBuildAccelerationStructures:
+// a batch ends when the next BLAS doesn't fit the scratch buffer, a pass
+// once the budget is used up.
+Summary buildInOrder(const std::vector<nvutils::BuildBatchItem>& items, uint64_t scratchCapacity, uint64_t budget)
+{
+  Summary summary;
+  double  usedSum = 0.0;
+  size_t  next    = 0;
+  while(next < items.size())
+  {
+    uint64_t budgetUsed = 0;
+    while(next < items.size() && budgetUsed < budget)
+    {
+      uint64_t scratchEnd = 0;
+      while(next < items.size() && budgetUsed < budget)
+      {
+        const uint64_t offset = alignUp(scratchEnd);
+        if(offset + items[next].scratchSize > scratchCapacity)
+        {
+          break;
+        }
+        scratchEnd = offset + items[next].scratchSize;
+        budgetUsed += items[next].resultSize;
+        next++;
+      }
+      summary.batches++;
+      usedSum += double(scratchEnd) / double(scratchCapacity);
+    }
+    summary.passes++;
+    summary.maxPassSize = std::max(summary.maxPassSize, budgetUsed);
+  }
+  summary.scratchUsed = summary.batches ? usedSum / double(summary.batches) : 0.0;
+  return summary;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              count          = 20000;
+  uint32_t              scratchMiB     = 128;
+  uint32_t              budgetMiB      = 512;
+  uint32_t              seed           = 1;
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "blas_batching_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Compares in-order and planned BLAS build batching; writes JSON.");
+  parameterRegistry.add({"count", "number of BLAS"}, &count, 1u);
+  parameterRegistry.add({"scratch", "scratch budget in MiB, as passed to getScratchSize"}, &scratchMiB, 1u);
+  parameterRegistry.add({"budget", "acceleration structure MiB per pass (hintMaxBudget)"}, &budgetMiB, 1u);
+  parameterRegistry.add({"seed", "random seed for the BLAS sizes"}, &seed);
+  parameterRegistry.add({"iterations", "timed planning runs per distribution"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const uint64_t budget = uint64_t(budgetMiB) << 20;
+
+  std::vector<Result> results;
+  for(const char* distribution : {"lognormal", "props", "uniform"})
+  {
+    Result result;
+    result.distribution = distribution;
+
+    const std::vector<nvutils::BuildBatchItem> items = generate(distribution, count, seed);
+    result.scratchCapacity                           = getScratchSize(uint64_t(scratchMiB) << 20, items);
+
+    result.inOrder = buildInOrder(items, result.scratchCapacity, budget);
+
+    const nvutils::BuildBatchSettings settings{.scratchCapacity  = result.scratchCapacity,
+                                               .scratchAlignment = kScratchAlignment,
+                                               .resultBudget     = budget};
+    nvutils::BuildBatchPlan           plan;
+    std::vector<double>               times;
+    for(uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+      nvutils::PerformanceTimer timer;
+      plan = nvutils::planBuildBatches(items, settings);
+      times.push_back(timer.getMilliseconds());
+    }
+    std::sort(times.begin(), times.end());
+
+    result.planned.batches = plan.batches.size();
+    result.planned.passes  = plan.passes.size();
+    result.planned.planMs  = times[times.size() / 2];
+    for(const nvutils::BuildPass& pass : plan.passes)
+    {
+      result.planned.maxPassSize = std::max(result.planned.maxPassSize, pass.resultSize);
+    }
+    double usedSum         = 0.0;
+    for(const nvutils::BuildBatch& batch : plan.batches)
+    {
+      usedSum += double(batch.scratchSize) / double(result.scratchCapacity);
+    }
+    result.planned.scratchUsed = plan.batches.empty() ? 0.0 : usedSum / double(plan.batches.size());
+
+    // Every BLAS must be built once, within the scratch buffer
+    std::vector<uint32_t> built(items.size(), 0);
+    for(const nvutils::PlannedBuild& build : plan.builds)
+    {
+      built[build.item]++;
+      result.ok = result.ok && build.scratchOffset + items[build.item].scratchSize <= result.scratchCapacity;
+    }
+    result.ok = result.ok && std::all_of(built.begin(), built.end(), [](uint32_t n) { return n == 1; });
+    results.push_back(result);
+  }
+
+  std::string json = "{\n  \"benchmark\": \"blas_batching\",\n  \"count\": " + std::to_string(count)
+                     + ",\n  \"scratch_mib\": " + std::to_string(scratchMiB) + ",\n  \"budget_mib\": "
+                     + std::to_string(budgetMiB) + ",\n  \"seed\": " + std::to_string(seed) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    const double mib = 1024.0 * 1024.0;
+    LOGI("%-10s scratch %8.2f MiB\n", r.distribution.c_str(), double(r.scratchCapacity) / mib);
+    LOGI("  in order: %6llu batches %5llu passes, largest %8.2f MiB, %5.1f%% scratch used\n",
+         static_cast<unsigned long long>(r.inOrder.batches), static_cast<unsigned long long>(r.inOrder.passes),
+         double(r.inOrder.maxPassSize) / mib, r.inOrder.scratchUsed * 100.0);
+    LOGI("  planned:  %6llu batches %5llu passes, largest %8.2f MiB, %5.1f%% scratch used, %.3f ms%s\n",
+         static_cast<unsigned long long>(r.planned.batches), static_cast<unsigned long long>(r.planned.passes),
+         double(r.planned.maxPassSize) / mib, r.planned.scratchUsed * 100.0, r.planned.planMs, r.ok ? "" : " (FAILED)");
+
+    char numbers[512];
+    snprintf(numbers, sizeof(numbers),
+             "\"distribution\": \"%s\", \"scratch_capacity\": %llu, \"in_order_batches\": %llu, "
+             "\"in_order_passes\": %llu, \"in_order_max_pass_size\": %llu, \"in_order_scratch_used\": %.4f, "
+             "\"planned_batches\": %llu, \"planned_passes\": %llu, \"planned_max_pass_size\": %llu, "
+             "\"planned_scratch_used\": %.4f, \"plan_median_ms\": %.4f, \"ok\": %s",
+             r.distribution.c_str(), static_cast<unsigned long long>(r.scratchCapacity),
+             static_cast<unsigned long long>(r.inOrder.batches), static_cast<unsigned long long>(r.inOrder.passes),
+             static_cast<unsigned long long>(r.inOrder.maxPassSize), r.inOrder.scratchUsed,
+             static_cast<unsigned long long>(r.planned.batches), static_cast<unsigned long long>(r.planned.passes),
+             static_cast<unsigned long long>(r.planned.maxPassSize), r.planned.scratchUsed, r.planned.planMs,
+             r.ok ? "true" : "false");
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
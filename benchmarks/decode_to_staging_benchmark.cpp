@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the copies SceneVk makes between decoding a glTF image and writing
+it into staging memory, without a device. Textures are decoded with
+stb_image on worker threads and written into a simulated staging ring on the
+calling thread, through nvutils::parallel_produce_consume, as in
+SceneVk::createTextureImages.
+
+Two strategies are compared, for RGBA PNGs and RGB JPEGs:
+* "copy to mipData": stb_image's buffer is copied (or, for RGB, expanded to
+  RGBA) into the image's mipData, which is then copied into staging memory;
+  this is how SceneVk::loadImage and createImage used to work
+* "direct to staging": stb_image's buffer is handed over to the consumer,
+  which copies (or expands) it straight into staging memory, as createImage
+  does through StagingUploader::appendImageSubMapping
+
+For each, this reports the median and minimum wall-clock time, the peak
+bytes allocated through operator new and stb_image, and memory-traffic
+counters per run: bytes decoded by stb_image, bytes written to intermediate
+buffers, and bytes written to staging memory, as JSON.
+
+The default set is 64 2048 x 2048 RGBA8 textures, 1 GiB decoded; since
+decode time doesn't depend on the copies, textures are synthesized from a
+few unique images.
+
+Example:
+  nvpro2_decode_to_staging_benchmark --count 64 --size 2048 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "nvimageformats/texture_conversion.h"
+#include "nvutils/bounded_pipeline.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "alloc_stats.hpp"
+
+#define STBI_MALLOC(size) alloc_stats::allocate(size)
+#define STBI_REALLOC(p, newSize) alloc_stats::reallocate(p, newSize)
+#define STBI_FREE(p) alloc_stats::release(p)
+// Use static definitions to avoid conflicts with other libraries' copies of
+// stb_image.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "fixtures.hpp"
+
+namespace {
+
+// Bytes written per run; reads are the same amounts again, since every
+// write after decoding copies from a buffer of the same size (or 3/4 of it).
+struct Traffic
+{
+  std::atomic<uint64_t> decodedBytes{0};
+  std::atomic<uint64_t> intermediateBytes{0};
+  std::atomic<uint64_t> stagingBytes{0};
+};
+
+// Stands in for the staging buffer: space is acquired contiguously from a
+// fixed-size ring, wrapping around as if each full ring were submitted and
+// reused.
+struct StagingRing
+{
+  std::vector<char> memory;
+  size_t            offset = 0;
+
+  std::span<char> acquire(size_t size)
+  {
+    if(size > memory.size())
+    {
+      memory.resize(size);
+    }
+    if(offset + size > memory.size())
+    {
+      offset = 0;
+    }
+    std::span<char> space(memory.data() + offset, size);
+    offset += size;
+    return space;
+  }
+};
+
+// One decoded texture waiting for the consumer.
+struct Decoded
+{
+  uint32_t              width    = 0;
+  uint32_t              height   = 0;
+  uint32_t              channels = 0;
+  std::vector<char>     mipData;  // "copy to mipData"
+  std::shared_ptr<void> owner;    // "direct to staging"
+  std::span<const char> view;
+  bool                  ok = false;
+
+  std::span<const char> texels() const { return owner ? view : std::span<const char>(mipData); }
+};
+
+// Writes `texels` (RGB or RGBA) as RGBA8 into `dst`.
+bool writeRGBA(const Decoded& decoded, std::span<const char> texels, std::span<char> dst)
+{
+  if(decoded.channels == 4)
+  {
+    memcpy(dst.data(), texels.data(), texels.size());
+    return true;
+  }
+  texture_conversion::ConversionSettings settings;
+  settings.numThreads = 1;
+  return !texture_conversion::convert(VK_FORMAT_R8G8B8_UNORM, texels, VK_FORMAT_R8G8B8A8_UNORM, dst, decoded.width,
+                                      decoded.height, settings)
+              .has_value();
+}
+
+// Decodes `file` the way SceneVk::loadImage does: 8-bit RGB as RGB, anything
+// else as RGBA.
+void decode(const std::vector<char>& file, bool direct, Decoded& decoded, Traffic& traffic)
+{
+  const stbi_uc* fileData = reinterpret_cast<const stbi_uc*>(file.data());
+  int            w = 0, h = 0, comp = 0;
+  if(!stbi_info_from_memory(fileData, int(file.size()), &w, &h, &comp))
+  {
+    return;
+  }
+  decoded.channels = (comp == 3) ? 3 : 4;
+  stbi_uc* data    = stbi_load_from_memory(fileData, int(file.size()), &w, &h, &comp, int(decoded.channels));
+  if(data == nullptr)
+  {
+    return;
+  }
+  decoded.width  = uint32_t(w);
+  decoded.height = uint32_t(h);
+  const std::span<const char> texels(reinterpret_cast<const char*>(data), size_t(w) * h * decoded.channels);
+  traffic.decodedBytes += texels.size();
+
+  if(direct)
+  {
+    decoded.owner = std::shared_ptr<void>(data, stbi_image_free);
+    decoded.view  = texels;
+    decoded.ok    = true;
+    return;
+  }
+
+  decoded.mipData.resize(size_t(w) * h * 4);
+  decoded.ok = writeRGBA(decoded, texels, decoded.mipData);
+  traffic.intermediateBytes += decoded.mipData.size();
+  stbi_image_free(data);
+  decoded.channels = 4;
+}
+
+struct Result
+{
+  std::string format;
+  std::string strategy;
+  uint32_t    threads           = 0;
+  double      medianMs          = 0.0;
+  double      minMs             = 0.0;
+  int64_t     peakAllocBytes    = 0;
+  uint64_t    decodedBytes      = 0;
+  uint64_t    intermediateBytes = 0;
+  uint64_t    stagingBytes      = 0;
+  bool        ok                = true;
+};
+
+// Runs one strategy once; returns whether all textures decoded and uploaded.
+bool runOnce(const std::vector<const std::vector<char>*>& files,
+             bool                                         direct,
+             uint32_t                                     numThreads,
+             uint64_t                                     budget,
+             StagingRing&                                 staging,
+             Traffic&                                     traffic)
+{
+  std::vector<Decoded> decoded(files.size());
+  std::atomic<bool>    ok{true};
+
+  nvutils::BoundedPipelineSettings settings;
+  settings.memoryBudget = budget;
+  settings.numWorkers   = numThreads;
+  nvutils::parallel_produce_consume(
+      files.size(),
+      [&](uint64_t i) -> uint64_t {
+        decode(*files[i], direct, decoded[i], traffic);
+        return decoded[i].texels().size();
+      },
+      [&](uint64_t i) {
+        Decoded& image = decoded[i];
+        if(image.ok)
+        {
+          const std::span<char> space = staging.acquire(size_t(image.width) * image.height * 4);
+          image.ok                    = writeRGBA(image, image.texels(), space);
+          traffic.stagingBytes += space.size();
+        }
+        if(!image.ok)
+        {
+          ok = false;
+        }
+        image = Decoded();
+      },
+      settings);
+  return ok;
+}
+
+Result runCase(const std::string&                           format,
+               const std::vector<const std::vector<char>*>& files,
+               bool                                         direct,
+               uint32_t                                     numThreads,
+               uint64_t                                     budget,
+               uint32_t                                     iterations,
+               StagingRing&                                 staging)
+{
+  Result result;
+  result.format   = format;
+  result.strategy = direct ? "direct to staging" : "copy to mipData";
+  result.threads  = numThreads;
+
+  Traffic traffic;
+  alloc_stats::reset();
+  const int64_t baseline   = alloc_stats::g_current.load();
+  result.ok                = runOnce(files, direct, numThreads, budget, staging, traffic);
+  result.peakAllocBytes    = alloc_stats::g_peak.load() - baseline;
+  result.decodedBytes      = traffic.decodedBytes;
+  result.intermediateBytes = traffic.intermediateBytes;
+  result.stagingBytes      = traffic.stagingBytes;
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    Traffic                   ignored;
+    nvutils::PerformanceTimer timer;
+    result.ok = runOnce(files, direct, numThreads, budget, staging, ignored) && result.ok;
+    times.push_back(timer.getMilliseconds());
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::string toJSON(const std::vector<Result>& results, uint32_t count, uint32_t size, uint32_t iterations)
+{
+  fixtures::JSONObject settings;
+  settings.add("count", count).add("size", size).add("iterations", iterations);
+  std::vector<fixtures::JSONObject> jsonResults;
+  for(const Result& r : results)
+  {
+    jsonResults.emplace_back()
+        .add("format", r.format)
+        .add("strategy", r.strategy)
+        .add("threads", r.threads)
+        .add("median_ms", r.medianMs)
+        .add("min_ms", r.minMs)
+        .add("peak_alloc_bytes", r.peakAllocBytes)
+        .add("decoded_bytes", r.decodedBytes)
+        .add("intermediate_bytes", r.intermediateBytes)
+        .add("staging_bytes", r.stagingBytes)
+        .add("ok", r.ok);
+  }
+  return fixtures::toJSON("decode_to_staging", settings, jsonResults);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              count          = 64;
+  uint32_t              size           = 2048;
+  uint32_t              unique         = 4;
+  uint32_t              threads        = 0;
+  uint32_t              budgetMiB      = 256;
+  uint32_t              stagingMiB     = 64;
+  uint32_t              iterations     = 3;
+  std::filesystem::path outputFilename = "decode_to_staging_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser parameterParser("Measures copies between image decode and staging memory; writes JSON.");
+  parameterRegistry.add({"count", "number of textures in the set"}, &count, 1u);
+  parameterRegistry.add({"size", "width (and height) of each texture"}, &size, 1u);
+  parameterRegistry.add({"unique", "number of distinct images the set is built from"}, &unique, 1u);
+  parameterRegistry.add({"threads", "decode threads; 0 means all hardware threads"}, &threads);
+  parameterRegistry.add({"budget", "pipeline memory budget in MiB; 0 means unlimited"}, &budgetMiB);
+  parameterRegistry.add({"staging", "size of the simulated staging ring in MiB"}, &stagingMiB, 1u);
+  parameterRegistry.add({"iterations", "timed runs per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  unique = std::min(unique, count);
+
+  StagingRing staging;
+  staging.memory.resize(size_t(stagingMiB) << 20);
+
+  std::vector<Result> results;
+  for(const bool jpeg : {false, true})
+  {
+    const char* format = jpeg ? "jpeg rgb" : "png rgba";
+    LOGI("Synthesizing %u %u x %u %s images\n", unique, size, size, format);
+    std::vector<std::vector<char>> uniqueFiles(unique);
+    nvutils::parallel_batches<1>(unique, [&](uint64_t i) { uniqueFiles[i] = jpeg ? fixtures::makeJPG(size, uint32_t(i)) : fixtures::makePNG(size, uint32_t(i)); });
+    std::vector<const std::vector<char>*> files(count);
+    for(uint32_t i = 0; i < count; i++)
+    {
+      files[i] = &uniqueFiles[i % unique];
+    }
+
+    for(const bool direct : {false, true})
+    {
+      results.push_back(runCase(format, files, direct, threads, uint64_t(budgetMiB) << 20, iterations, staging));
+    }
+  }
+
+  for(const Result& r : results)
+  {
+    LOGI("%-8s %-18s %10.3f ms  peak alloc %8.1f MiB  decoded %8.1f MiB  intermediate %8.1f MiB  staging %8.1f MiB%s\n",
+         r.format.c_str(), r.strategy.c_str(), r.medianMs, double(r.peakAllocBytes) / (1024.0 * 1024.0),
+         double(r.decodedBytes) / (1024.0 * 1024.0), double(r.intermediateBytes) / (1024.0 * 1024.0),
+         double(r.stagingBytes) / (1024.0 * 1024.0), r.ok ? "" : " (FAILED)");
+  }
+
+  if(!fixtures::writeJSON(outputFilename, toJSON(results, count, size, iterations)))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Simulates a long-running session that streams geometry in and out of an
+nvvk::BufferSubAllocator, without a device: the blocks are only their
+OffsetAllocators, with the same units and first-fit order over blocks as
+BufferSubAllocator uses.
+
+Allocations with log-uniform sizes between `--min-size` and `--max-size`
+bytes are made until `--live` MiB are in use. Then, for `--rounds` rounds,
+`--churn` percent of them are freed at random and replaced by new ones.
+Finally `--unload` percent are freed, as when leaving a part of the scene,
+which leaves many blocks mostly empty.
+
+The live allocations are then compacted the way
+BufferSubAllocator::cmdDefragment does: nvutils::planCompaction plans the
+moves, which are applied to fresh OffsetAllocators, and the copies that are
+contiguous in both blocks are merged.
+
+This reports the blocks and reserved size before and after, the planning
+time (median and minimum), the bytes moved and the number of copy regions,
+as JSON. The compacted blocks are checked for overlaps.
+
+Example:
+  nvpro2_defragment_benchmark --live 4096 --unload 70 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <offsetallocator/offsetAllocator.hpp>
+
+#include "nvutils/compaction_planner.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+// Same as BufferSubAllocator's defaults
+constexpr uint64_t kUnit              = 16;
+constexpr uint32_t kPerBlockAllocations = 128 * 1024;
+
+struct Allocation
+{
+  uint32_t                    block = 0;
+  OffsetAllocator::Allocation allocation;
+  uint64_t                    size = 0;  // In bytes
+};
+
+// Blocks of OffsetAllocators, searched newest first like
+// BufferSubAllocator's active block list
+struct SimulatedAllocator
+{
+  uint32_t                                                blockUnits = 0;
+  std::vector<std::unique_ptr<OffsetAllocator::Allocator>> blocks;  // null when released
+  std::vector<uint32_t>                                   active;     // newest last
+
+  uint32_t addBlock()
+  {
+    uint32_t index = 0;
+    while(index < blocks.size() && blocks[index])
+    {
+      index++;
+    }
+    if(index == blocks.size())
+    {
+      blocks.emplace_back();
+    }
+    blocks[index] = std::make_unique<OffsetAllocator::Allocator>(blockUnits, kPerBlockAllocations);
+    active.push_back(index);
+    return index;
+  }
+
+  Allocation allocate(uint64_t size)
+  {
+    const uint32_t units = uint32_t((size + kUnit - 1) / kUnit);
+    for(size_t i = active.size(); i-- > 0;)
+    {
+      OffsetAllocator::Allocation allocation = blocks[active[i]]->allocate(units);
+      if(allocation.offset != OffsetAllocator::Allocation::NO_SPACE)
+      {
+        return {active[i], allocation, size};
+      }
+    }
+    const uint32_t block = addBlock();
+    return {block, blocks[block]->allocate(units), size};
+  }
+
+  void free(const Allocation& allocation)
+  {
+    OffsetAllocator::Allocator& block = *blocks[allocation.block];
+    block.free(allocation.allocation);
+    // Like BufferSubAllocator with keepLastBlock
+    if(block.storageReport().totalFreeSpace == blockUnits && active.size() > 1)
+    {
+      blocks[allocation.block].reset();
+      active.erase(std::find(active.begin(), active.end(), allocation.block));
+    }
+  }
+
+  uint64_t reservedSize() const
+  {
+    uint64_t reserved = 0;
+    for(uint32_t block : active)
+    {
+      reserved += uint64_t(blockUnits - blocks[block]->storageReport().totalFreeSpace) * kUnit;
+    }
+    return reserved;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              liveMiB        = 2048;
+  uint32_t              blockMiB       = 128;
+  uint32_t              minSize        = 1024;
+  uint32_t              maxSize        = 4 << 20;
+  uint32_t              rounds         = 20;
+  uint32_t              churnPercent   = 20;
+  uint32_t              unloadPercent  = 70;
+  float                 maxOccupancy   = 0.5f;
+  uint32_t              iterations     = 5;
+  uint32_t              seed           = 1;
+  std::filesystem::path outputFilename = "defragment_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Simulates BufferSubAllocator fragmentation and compaction; writes JSON.");
+  parameterRegistry.add({"live", "MiB allocated before the churn"}, &liveMiB, 1u);
+  parameterRegistry.add({"block", "block size in MiB"}, &blockMiB, 1u);
+  parameterRegistry.add({"min-size", "smallest allocation in bytes"}, &minSize, 1u);
+  parameterRegistry.add({"max-size", "largest allocation in bytes; must be less than the block size"}, &maxSize, 1u);
+  parameterRegistry.add({"rounds", "rounds of freeing and reallocating"}, &rounds);
+  parameterRegistry.add({"churn", "percent of the allocations replaced per round"}, &churnPercent, 0u, 100u);
+  parameterRegistry.add({"unload", "percent of the allocations freed at the end"}, &unloadPercent, 0u, 100u);
+  parameterRegistry.add({"occupancy", "DefragmentInfo::maxBlockOccupancy"}, &maxOccupancy, 0.f, 1.f);
+  parameterRegistry.add({"iterations", "timed planCompaction calls"}, &iterations, 1u);
+  parameterRegistry.add({"seed", "random seed"}, &seed);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const uint64_t blockSize = uint64_t(blockMiB) << 20;
+  if(maxSize >= blockSize || minSize > maxSize)
+  {
+    LOGE("Allocation sizes must be at most --max-size, which must be less than the block size.\n");
+    return EXIT_FAILURE;
+  }
+
+  std::mt19937                          rng(seed);
+  std::uniform_real_distribution<double> logSize(std::log(double(minSize)), std::log(double(maxSize)));
+  auto                                  randomSize = [&]() { return uint64_t(std::exp(logSize(rng))); };
+
+  SimulatedAllocator allocator;
+  allocator.blockUnits = uint32_t(blockSize / kUnit);
+  allocator.addBlock();
+
+  std::vector<Allocation> live;
+  uint64_t                liveSize = 0;
+  while(liveSize < (uint64_t(liveMiB) << 20))
+  {
+    live.push_back(allocator.allocate(randomSize()));
+    liveSize += live.back().size;
+  }
+
+  auto freeRandom = [&](uint32_t percent) {
+    std::shuffle(live.begin(), live.end(), rng);
+    const size_t count = live.size() * percent / 100;
+    for(size_t i = live.size() - count; i < live.size(); i++)
+    {
+      allocator.free(live[i]);
+      liveSize -= live[i].size;
+    }
+    live.resize(live.size() - count);
+    return count;
+  };
+
+  for(uint32_t round = 0; round < rounds; round++)
+  {
+    const size_t count = freeRandom(churnPercent);
+    for(size_t i = 0; i < count; i++)
+    {
+      live.push_back(allocator.allocate(randomSize()));
+      liveSize += live.back().size;
+    }
+  }
+  freeRandom(unloadPercent);
+
+  const size_t   blocksBefore   = allocator.active.size();
+  const uint64_t reservedBefore = allocator.reservedSize();
+
+  // Plan, as in cmdDefragment
+  std::vector<nvutils::CompactionItem> items;
+  for(const Allocation& allocation : live)
+  {
+    items.push_back({allocation.block, allocation.allocation.offset,
+                     allocator.blocks[allocation.block]->allocationSize(allocation.allocation)});
+  }
+  const nvutils::CompactionSettings settings{.blockCapacity    = allocator.blockUnits,
+                                             .maxItemsPerBlock = kPerBlockAllocations - 1,
+                                             .maxOccupancy     = maxOccupancy};
+  nvutils::CompactionPlan plan;
+  std::vector<double>     planTimes;
+  for(uint32_t iteration = 0; iteration < iterations; iteration++)
+  {
+    nvutils::PerformanceTimer timer;
+    plan = nvutils::planCompaction(items, settings);
+    planTimes.push_back(timer.getMilliseconds());
+  }
+  std::sort(planTimes.begin(), planTimes.end());
+
+  // Apply it to fresh OffsetAllocators, with an overflow block for what
+  // they can't fit due to their size rounding
+  struct Copy
+  {
+    uint32_t srcBlock;
+    uint32_t dstBlock;
+    uint64_t srcOffset;
+    uint64_t dstOffset;
+    uint64_t size;
+  };
+  std::vector<Copy>     copies;
+  std::vector<uint32_t> newBlocks(plan.newBlockCount, ~0u);
+  uint32_t              overflowBlock  = ~0u;
+  uint32_t              overflowBlocks = 0;
+  bool                  ok             = true;
+  for(const nvutils::CompactionMove& move : plan.moves)
+  {
+    if(newBlocks[move.dstBlock] == ~0u)
+    {
+      newBlocks[move.dstBlock] = allocator.addBlock();
+    }
+    const uint32_t              units      = uint32_t(items[move.item].size);
+    uint32_t                    dstBlock   = newBlocks[move.dstBlock];
+    OffsetAllocator::Allocation allocation = allocator.blocks[dstBlock]->allocate(units);
+    if(allocation.offset == OffsetAllocator::Allocation::NO_SPACE)
+    {
+      if(overflowBlock != ~0u)
+      {
+        allocation = allocator.blocks[overflowBlock]->allocate(units);
+      }
+      if(allocation.offset == OffsetAllocator::Allocation::NO_SPACE)
+      {
+        overflowBlock = allocator.addBlock();
+        overflowBlocks++;
+        allocation = allocator.blocks[overflowBlock]->allocate(units);
+      }
+      dstBlock = overflowBlock;
+    }
+    ok = ok && allocation.offset != OffsetAllocator::Allocation::NO_SPACE;
+
+    Allocation& moved = live[move.item];
+    copies.push_back({moved.block, dstBlock, moved.allocation.offset * kUnit, allocation.offset * kUnit, moved.size});
+    moved.block      = dstBlock;
+    moved.allocation = allocation;
+  }
+  for(uint32_t block : plan.sourceBlocks)
+  {
+    allocator.blocks[block].reset();
+    allocator.active.erase(std::find(allocator.active.begin(), allocator.active.end(), block));
+  }
+
+  std::sort(copies.begin(), copies.end(), [](const Copy& a, const Copy& b) {
+    if(a.srcBlock != b.srcBlock)
+      return a.srcBlock < b.srcBlock;
+    if(a.dstBlock != b.dstBlock)
+      return a.dstBlock < b.dstBlock;
+    return a.srcOffset < b.srcOffset;
+  });
+  uint64_t regions = 0;
+  for(size_t i = 0; i < copies.size(); i++)
+  {
+    const bool merges = i > 0 && copies[i - 1].srcBlock == copies[i].srcBlock && copies[i - 1].dstBlock == copies[i].dstBlock
+                        && copies[i - 1].srcOffset + copies[i - 1].size == copies[i].srcOffset
+                        && copies[i - 1].dstOffset + copies[i - 1].size == copies[i].dstOffset;
+    regions += merges ? 0 : 1;
+  }
+
+  // No two live allocations may overlap after compaction
+  std::sort(live.begin(), live.end(), [](const Allocation& a, const Allocation& b) {
+    return a.block != b.block ? a.block < b.block : a.allocation.offset < b.allocation.offset;
+  });
+  for(size_t i = 1; i < live.size(); i++)
+  {
+    if(live[i - 1].block == live[i].block && (live[i - 1].allocation.offset * kUnit + live[i - 1].size > live[i].allocation.offset * kUnit))
+    {
+      ok = false;
+    }
+  }
+
+  const size_t   blocksAfter   = allocator.active.size();
+  const uint64_t reservedAfter = allocator.reservedSize();
+
+  LOGI("live %.1f MiB in %zu allocations\n", double(liveSize) / (1 << 20), live.size());
+  LOGI("before: %zu blocks (%.1f MiB), %.1f MiB reserved\n", blocksBefore, double(blocksBefore * blockSize) / (1 << 20),
+       double(reservedBefore) / (1 << 20));
+  LOGI("after:  %zu blocks (%.1f MiB), %.1f MiB reserved\n", blocksAfter, double(blocksAfter * blockSize) / (1 << 20),
+       double(reservedAfter) / (1 << 20));
+  LOGI("plan: %.3f ms median, %zu blocks -> %u (+%u overflow), %.1f MiB in %zu moves, %llu copy regions%s\n",
+       planTimes[planTimes.size() / 2], plan.sourceBlocks.size(), plan.newBlockCount, overflowBlocks,
+       double(plan.movedSize * kUnit) / (1 << 20), plan.moves.size(), static_cast<unsigned long long>(regions),
+       ok ? "" : " (FAILED)");
+
+  char json[2048];
+  snprintf(json, sizeof(json),
+           "{\n  \"benchmark\": \"defragment\",\n  \"live_mib\": %u,\n  \"block_mib\": %u,\n  \"min_size\": %u,\n"
+           "  \"max_size\": %u,\n  \"rounds\": %u,\n  \"churn_percent\": %u,\n  \"unload_percent\": %u,\n"
+           "  \"max_occupancy\": %.3f,\n  \"allocations\": %zu,\n  \"live_bytes\": %llu,\n"
+           "  \"blocks_before\": %zu,\n  \"reserved_bytes_before\": %llu,\n  \"blocks_after\": %zu,\n"
+           "  \"reserved_bytes_after\": %llu,\n  \"source_blocks\": %zu,\n  \"new_blocks\": %u,\n"
+           "  \"overflow_blocks\": %u,\n  \"moves\": %zu,\n  \"moved_bytes\": %llu,\n  \"copy_regions\": %llu,\n"
+           "  \"plan_median_ms\": %.4f,\n  \"plan_min_ms\": %.4f,\n  \"ok\": %s\n}\n",
+           liveMiB, blockMiB, minSize, maxSize, rounds, churnPercent, unloadPercent, maxOccupancy, live.size(),
+           static_cast<unsigned long long>(liveSize), blocksBefore, static_cast<unsigned long long>(reservedBefore),
+           blocksAfter, static_cast<unsigned long long>(reservedAfter), plan.sourceBlocks.size(), plan.newBlockCount,
+           overflowBlocks, plan.moves.size(), static_cast<unsigned long long>(plan.movedSize * kUnit),
+           static_cast<unsigned long long>(regions), planTimes[planTimes.size() / 2], planTimes.front(), ok ? "true" : "false");
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fputs(json, file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
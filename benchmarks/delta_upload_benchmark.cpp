@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU side of SceneVk::updateRenderNodesBuffer when only a few
+nodes moved since the last frame, without a device. Uploads are simulated by
+copying into a host array that stands in for the GPU buffer.
+
+Two strategies are compared:
+* "full": every GltfRenderNode is rebuilt with glm::inverse() and the whole
+  array is uploaded; this is how updateRenderNodesBuffer used to work
+* "delta": the nodes whose revision (see nvvkgltf::Scene::getRenderNodeRevisions())
+  is newer than the last upload are marked in parallel, and only the ranges
+  nvutils::coalesceDirtyRanges returns for them are rebuilt (with the scalar
+  affine inverse) and uploaded
+
+Changed nodes are either spread at random over the scene, or clustered in
+runs of 64, as when a sub-tree of the scene is animated.
+
+For each, this reports the median and minimum CPU time per frame, and the
+bytes and ranges uploaded per frame, as JSON. After each delta frame, the
+simulated GPU buffer is checked against a full rebuild.
+
+Example:
+  nvpro2_delta_upload_benchmark --nodes 1000000 --changed 1 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "nvshaders/gltf_scene_io.h.slang"
+#include "nvutils/bit_array.hpp"
+#include "nvutils/dirty_ranges.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+// Same as in SceneVk
+constexpr uint64_t kDeltaUploadMaxGapBytes = 512;
+
+// The parts of nvvkgltf::RenderNode that updateRenderNodesBuffer reads
+struct RenderNode
+{
+  glm::mat4 worldMatrix{1};
+  int       materialID   = 0;
+  int       renderPrimID = 0;
+};
+
+// Same as in SceneVk
+glm::mat4 inverseWorldMatrix(const glm::mat4& m)
+{
+  if(m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f)
+  {
+    return glm::inverse(m);
+  }
+  const glm::mat3 inv = glm::inverse(glm::mat3(m));
+  glm::mat4       result(inv);
+  result[3] = glm::vec4(-(inv * glm::vec3(m[3])), 1.0f);
+  return result;
+}
+
+glm::mat4 makeTransform(uint32_t seed)
+{
+  const float angle = float(seed % 360) * 0.0174533f;
+  const float scale = 0.5f + float(seed % 7) * 0.25f;
+  glm::mat4   m     = glm::translate(glm::mat4(1), glm::vec3(float(seed % 1000), float(seed % 97), float(seed % 13)));
+  m                 = glm::rotate(m, angle, glm::normalize(glm::vec3(1.0f, float(seed % 5), 2.0f)));
+  return glm::scale(m, glm::vec3(scale));
+}
+
+struct Upload
+{
+  uint64_t bytes  = 0;
+  uint32_t ranges = 0;
+};
+
+// The old updateRenderNodesBuffer
+Upload fullUpload(const std::vector<RenderNode>& renderNodes, std::vector<shaderio::GltfRenderNode>& gpuBuffer)
+{
+  std::vector<shaderio::GltfRenderNode> instanceInfo;
+  for(const RenderNode& renderNode : renderNodes)
+  {
+    shaderio::GltfRenderNode info{};
+    info.objectToWorld = renderNode.worldMatrix;
+    info.worldToObject = glm::inverse(renderNode.worldMatrix);
+    info.materialID    = renderNode.materialID;
+    info.renderPrimID  = renderNode.renderPrimID;
+    instanceInfo.emplace_back(info);
+  }
+  memcpy(gpuBuffer.data(), instanceInfo.data(), instanceInfo.size() * sizeof(shaderio::GltfRenderNode));
+  return {instanceInfo.size() * sizeof(shaderio::GltfRenderNode), 1};
+}
+
+// The new updateRenderNodesBuffer; `uploadedRevision` persists between frames
+Upload deltaUpload(const std::vector<RenderNode>&         renderNodes,
+                   const std::vector<uint64_t>&           revisions,
+                   uint64_t&                              uploadedRevision,
+                   uint64_t                               revision,
+                   std::vector<shaderio::GltfRenderNode>& gpuBuffer)
+{
+  nvutils::BitArray dirty(renderNodes.size());
+  nvutils::parallel_batches<2048>(renderNodes.size(), [&](uint64_t i) {
+    if(revisions[i] > uploadedRevision)
+    {
+      dirty.enableBit(i);
+    }
+  });
+
+  Upload upload;
+  for(const nvutils::DirtyRange& range :
+      nvutils::coalesceDirtyRanges(dirty, kDeltaUploadMaxGapBytes / sizeof(shaderio::GltfRenderNode)))
+  {
+    // Written straight to the (simulated) staging memory
+    nvutils::parallel_batches<2048>(range.count, [&](uint64_t i) {
+      const RenderNode&        renderNode = renderNodes[range.first + i];
+      shaderio::GltfRenderNode info{};
+      info.objectToWorld         = renderNode.worldMatrix;
+      info.worldToObject         = inverseWorldMatrix(renderNode.worldMatrix);
+      info.materialID            = renderNode.materialID;
+      info.renderPrimID          = renderNode.renderPrimID;
+      gpuBuffer[range.first + i] = info;
+    });
+    upload.bytes += range.count * sizeof(shaderio::GltfRenderNode);
+    upload.ranges++;
+  }
+  uploadedRevision = revision;
+  return upload;
+}
+
+bool matches(const std::vector<shaderio::GltfRenderNode>& a, const std::vector<shaderio::GltfRenderNode>& b)
+{
+  for(size_t i = 0; i < a.size(); i++)
+  {
+    if(a[i].objectToWorld != b[i].objectToWorld || a[i].materialID != b[i].materialID || a[i].renderPrimID != b[i].renderPrimID)
+    {
+      return false;
+    }
+    for(int c = 0; c < 4; c++)
+    {
+      for(int r = 0; r < 4; r++)
+      {
+        if(std::abs(a[i].worldToObject[c][r] - b[i].worldToObject[c][r]) > 1e-3f)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Indices of the nodes that move in frame `frame`
+std::vector<uint64_t> pickChanged(uint64_t nodeCount, uint64_t changedCount, bool clustered, uint32_t frame)
+{
+  std::vector<uint64_t> changed;
+  uint32_t              rng = 777 + frame * 2654435761u;
+  const uint64_t        run = clustered ? 64 : 1;
+  while(changed.size() < changedCount)
+  {
+    rng                  = rng * 1664525u + 1013904223u;
+    const uint64_t first = (uint64_t(rng) * nodeCount >> 32) / run * run;
+    for(uint64_t i = first; i < std::min(first + run, nodeCount) && changed.size() < changedCount; i++)
+    {
+      changed.push_back(i);
+    }
+  }
+  return changed;
+}
+
+struct Result
+{
+  std::string pattern;
+  std::string strategy;
+  double      medianMs      = 0.0;
+  double      minMs         = 0.0;
+  uint64_t    uploadedBytes = 0;  // Per frame
+  uint32_t    rangeCount    = 0;  // Per frame
+  bool        ok            = true;
+};
+
+Result runCase(uint64_t nodeCount, uint64_t changedCount, bool clustered, bool delta, uint32_t frames)
+{
+  Result result;
+  result.pattern  = clustered ? "clustered" : "random";
+  result.strategy = delta ? "delta" : "full";
+
+  std::vector<RenderNode> renderNodes(nodeCount);
+  for(uint64_t i = 0; i < nodeCount; i++)
+  {
+    renderNodes[i].worldMatrix  = makeTransform(uint32_t(i));
+    renderNodes[i].materialID   = int(i % 100);
+    renderNodes[i].renderPrimID = int(i % 1000);
+  }
+
+  // As nvvkgltf::Scene tracks them: revision 1 is the parse of the scene
+  uint64_t              revision = 1;
+  std::vector<uint64_t> revisions(nodeCount, revision);
+  uint64_t              uploadedRevision = 0;
+
+  std::vector<shaderio::GltfRenderNode> gpuBuffer(nodeCount);
+  std::vector<shaderio::GltfRenderNode> reference(nodeCount);
+  // First upload, not timed
+  if(delta)
+  {
+    deltaUpload(renderNodes, revisions, uploadedRevision, revision, gpuBuffer);
+  }
+  else
+  {
+    fullUpload(renderNodes, gpuBuffer);
+  }
+
+  std::vector<double> times;
+  for(uint32_t frame = 0; frame < frames; frame++)
+  {
+    // Not timed: this is Scene::updateRenderNodes()
+    revision++;
+    for(uint64_t i : pickChanged(nodeCount, changedCount, clustered, frame))
+    {
+      renderNodes[i].worldMatrix = makeTransform(uint32_t(i * 31 + frame + 1));
+      revisions[i]               = revision;
+    }
+
+    nvutils::PerformanceTimer timer;
+    const Upload              upload = delta ? deltaUpload(renderNodes, revisions, uploadedRevision, revision, gpuBuffer) :
+                                               fullUpload(renderNodes, gpuBuffer);
+    times.push_back(timer.getMilliseconds());
+    result.uploadedBytes = upload.bytes;
+    result.rangeCount    = upload.ranges;
+
+    if(delta)
+    {
+      fullUpload(renderNodes, reference);
+      result.ok = matches(gpuBuffer, reference) && result.ok;
+    }
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::string toJSON(const std::vector<Result>& results, uint64_t nodeCount, uint64_t changedCount, uint32_t frames)
+{
+  fixtures::JSONObject settings;
+  settings.add("nodes", nodeCount).add("changed", changedCount).add("frames", frames);
+  std::vector<fixtures::JSONObject> jsonResults;
+  for(const Result& r : results)
+  {
+    jsonResults.emplace_back()
+        .add("pattern", r.pattern)
+        .add("strategy", r.strategy)
+        .add("median_ms", r.medianMs)
+        .add("min_ms", r.minMs)
+        .add("uploaded_bytes", r.uploadedBytes)
+        .add("ranges", r.rangeCount)
+        .add("ok", r.ok);
+  }
+  return fixtures::toJSON("delta_upload", settings, jsonResults);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              nodes          = 1000000;
+  float                 changedPercent = 1.0f;
+  uint32_t              frames         = 10;
+  std::filesystem::path outputFilename = "delta_upload_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures delta uploads of SceneVk's render node buffer; writes JSON.");
+  parameterRegistry.add({"nodes", "number of render nodes"}, &nodes, 1u);
+  parameterRegistry.add({"changed", "percentage of nodes that move each frame"}, &changedPercent, 0.0f, 100.0f);
+  parameterRegistry.add({"frames", "timed frames per case"}, &frames, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const uint64_t changedCount = std::max<uint64_t>(1, uint64_t(double(nodes) * changedPercent / 100.0));
+
+  std::vector<Result> results;
+  bool                allOk = true;
+  for(const bool clustered : {false, true})
+  {
+    for(const bool delta : {false, true})
+    {
+      results.push_back(runCase(nodes, changedCount, clustered, delta, frames));
+      allOk = allOk && results.back().ok;
+    }
+  }
+
+  for(const Result& r : results)
+  {
+    LOGI("%-9s %-5s %10.3f ms  uploaded %10.3f MiB in %7u ranges%s\n", r.pattern.c_str(), r.strategy.c_str(),
+         r.medianMs, double(r.uploadedBytes) / (1024.0 * 1024.0), r.rangeCount, r.ok ? "" : " (MISMATCH)");
+  }
+
+  if(!fixtures::writeJSON(outputFilename, toJSON(results, nodes, changedCount, frames)))
+  {
+    return EXIT_FAILURE;
+  }
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Measures nvvk::createEnvironmentAccel, which builds the importance sampling
+alias table of an HDR environment on the CPU, against the serial
+implementation it replaced (copied below), for environments of `--min` to
+`--max` texels wide (doubling; twice as wide as high).
+
+The environments are synthetic: a sky gradient with noise and a small sun
+that is many times brighter, which gives the alias table a few texels with
+a large excess and many small ones.
+
+For each size, this reports the median and minimum time of both, and how
+closely each samples the importance of the texels (max(r, g, b) times
+their solid angle, computed in double precision):
+* exactly, by deriving the probability of each texel from the table (its
+  own ratio q, plus 1 - q of each texel it's the alias of), as the total
+  variation distance to the importance
+* statistically, by drawing `--samples` texels with the table as
+  hdr_env_sampling.h.slang does, and comparing the counts over 64 x 32
+  regions to the importance with a chi-squared test
+The new version must also get the average luminance, integral and PDFs
+right to 1e-4; the serial one sums in float, which shows on large sizes.
+
+Example:
+  nvpro2_environment_accel_benchmark --min 1024 --max 16384 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/hdr_ibl.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// The serial implementation createEnvironmentAccel used before
+
+float buildAliasmapSerial(const std::vector<float>& data, std::vector<shaderio::EnvAccel>& accel)
+{
+  auto  size = static_cast<uint32_t>(data.size());
+  float sum  = std::accumulate(data.begin(), data.end(), 0.F);
+  if(sum == 0.0f)
+  {
+    sum = 1.0f;
+  }
+  float inverse_average = static_cast<float>(size) / sum;
+  for(uint32_t i = 0; i < size; ++i)
+  {
+    accel[i].q     = data[i] * inverse_average;
+    accel[i].alias = i;
+  }
+  std::vector<uint32_t> partition_table(size);
+  uint32_t              s     = 0U;
+  uint32_t              large = size;
+  for(uint32_t i = 0; i < size; ++i)
+  {
+    if(accel[i].q < 1.F)
+      partition_table[s++] = i;
+    else
+      partition_table[--large] = i;
+  }
+  for(s = 0; s < large && large < size; ++s)
+  {
+    const uint32_t small_energy_index = partition_table[s];
+    const uint32_t high_energy_index  = partition_table[large];
+    accel[small_energy_index].alias   = high_energy_index;
+    accel[high_energy_index].q -= 1.F - accel[small_energy_index].q;
+    if(accel[high_energy_index].q < 1.0F)
+      large++;
+  }
+  return sum;
+}
+
+std::vector<shaderio::EnvAccel> createEnvironmentAccelSerial(float* pixels, uint32_t rx, uint32_t ry, float& average, float& integral)
+{
+  std::vector<shaderio::EnvAccel> env_accel(size_t(rx) * ry);
+  std::vector<float>              importance_data(size_t(rx) * ry);
+  float                           cos_theta0 = 1.0F;
+  const float                     step_phi   = glm::two_pi<float>() / static_cast<float>(rx);
+  const float                     step_theta = glm::pi<float>() / static_cast<float>(ry);
+  double                          total      = 0.0;
+  for(uint32_t y = 0; y < ry; ++y)
+  {
+    const float theta1     = static_cast<float>(y + 1) * step_theta;
+    const float cos_theta1 = std::cos(theta1);
+    const float area       = (cos_theta0 - cos_theta1) * step_phi;
+    cos_theta0             = cos_theta1;
+    for(uint32_t x = 0; x < rx; ++x)
+    {
+      const size_t idx     = size_t(y) * rx + x;
+      const float* texel   = &pixels[idx * 4];
+      importance_data[idx] = area * std::max(texel[0], std::max(texel[1], texel[2]));
+      total += texel[0] * 0.2126F + texel[1] * 0.7152F + texel[2] * 0.0722F;
+    }
+  }
+  average  = static_cast<float>(total) / static_cast<float>(size_t(rx) * ry);
+  integral = buildAliasmapSerial(importance_data, env_accel);
+  if(integral == 0.0f)
+  {
+    integral = 1.0f;
+  }
+  const float inv_env_integral = 1.0F / integral;
+  for(size_t i = 0; i < size_t(rx) * ry; ++i)
+  {
+    pixels[i * 4 + 3] = std::max(pixels[i * 4], std::max(pixels[i * 4 + 1], pixels[i * 4 + 2])) * inv_env_integral;
+  }
+  return env_accel;
+}
+
+//-----------------------------------------------------------------------------
+
+// Probability with which each texel is sampled with `accel`
+std::vector<double> texelProbabilities(const std::vector<shaderio::EnvAccel>& accel)
+{
+  const double        inverseSize = 1.0 / double(accel.size());
+  std::vector<double> probabilities(accel.size(), 0.0);
+  for(size_t i = 0; i < accel.size(); i++)
+  {
+    const double q = std::clamp(double(accel[i].q), 0.0, 1.0);
+    probabilities[i] += q * inverseSize;
+    probabilities[accel[i].alias] += (1.0 - q) * inverseSize;
+  }
+  return probabilities;
+}
+
+// What the tables should sample, computed in double precision
+struct Reference
+{
+  std::vector<double> probabilities;  // Per texel: max(r, g, b) times its solid angle, normalized
+  double              integral = 0.0;
+  double              average  = 0.0;
+};
+
+Reference makeReference(const std::vector<float>& rgba, uint32_t width, uint32_t height)
+{
+  Reference reference;
+  reference.probabilities.resize(size_t(width) * height);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    const double area = (std::cos(glm::pi<double>() * y / height) - std::cos(glm::pi<double>() * (y + 1) / height))
+                        * glm::two_pi<double>() / width;
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const size_t i     = size_t(y) * width + x;
+      const float* texel = &rgba[i * 4];
+      reference.probabilities[i] = area * std::max(texel[0], std::max(texel[1], texel[2]));
+      reference.integral += reference.probabilities[i];
+      reference.average += texel[0] * 0.2126 + texel[1] * 0.7152 + texel[2] * 0.0722;
+    }
+  }
+  for(double& probability : reference.probabilities)
+  {
+    probability /= reference.integral;
+  }
+  reference.average /= double(width) * height;
+  return reference;
+}
+
+// Total variation distance between the texel probabilities of `accel` and
+// the reference
+double totalVariationDistance(const std::vector<shaderio::EnvAccel>& accel, const Reference& reference)
+{
+  const std::vector<double> probabilities = texelProbabilities(accel);
+  double                    distance      = 0.0;
+  for(size_t i = 0; i < accel.size(); i++)
+  {
+    distance += std::abs(probabilities[i] - reference.probabilities[i]);
+  }
+  return distance * 0.5;
+}
+
+// Chi-squared statistic of `samples` texels drawn with `accel`, counted over
+// 64 x 32 regions, against the reference, divided by the degrees of freedom;
+// around 1 if the table samples the reference distribution
+double chiSquaredPerDof(const std::vector<shaderio::EnvAccel>& accel, const Reference& reference, uint32_t width, uint32_t height, uint64_t samples, uint64_t seed)
+{
+  auto region = [&](size_t texel) { return (texel / width * 32 / height) * 64 + (texel % width) * 64 / width; };
+
+  std::vector<double> observed(64 * 32, 0.0);
+  uint64_t            rng = seed;
+  for(uint64_t s = 0; s < samples; s++)
+  {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    const double xi0   = double(rng >> 11) / 9007199254740992.0;
+    const float  xi1   = float(rng & 0xFFFFFF) / 16777216.0f;
+    uint32_t     texel = std::min(uint32_t(xi0 * double(accel.size())), uint32_t(accel.size() - 1));
+    if(!(xi1 < accel[texel].q))
+    {
+      texel = accel[texel].alias;
+    }
+    observed[region(texel)] += 1.0;
+  }
+
+  std::vector<double> expected(64 * 32, 0.0);
+  for(size_t i = 0; i < reference.probabilities.size(); i++)
+  {
+    expected[region(i)] += reference.probabilities[i] * double(samples);
+  }
+
+  double   chi2 = 0.0;
+  uint32_t dof  = 0;
+  for(size_t i = 0; i < expected.size(); i++)
+  {
+    if(expected[i] > 0.0)
+    {
+      chi2 += (observed[i] - expected[i]) * (observed[i] - expected[i]) / expected[i];
+      dof++;
+    }
+  }
+  return dof > 1 ? chi2 / double(dof - 1) : 0.0;
+}
+
+struct Result
+{
+  uint32_t width            = 0;
+  uint32_t height           = 0;
+  double   serialMedianMs   = 0.0;
+  double   serialMinMs      = 0.0;
+  double   parallelMedianMs = 0.0;
+  double   parallelMinMs    = 0.0;
+  double   serialDistance   = 0.0;  // Total variation distance to the reference
+  double   parallelDistance = 0.0;
+  double   serialChi2       = 0.0;  // Per degree of freedom, of samples against the reference
+  double   parallelChi2     = 0.0;
+  bool     ok               = true;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              minWidth       = 1024;
+  uint32_t              maxWidth       = 8192;
+  uint32_t              iterations     = 3;
+  uint32_t              samples        = 10000000;
+  std::filesystem::path outputFilename = "environment_accel_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures environment importance sampling construction; writes JSON.");
+  parameterRegistry.add({"min", "width of the smallest environment"}, &minWidth, 2u);
+  parameterRegistry.add({"max", "width of the largest environment"}, &maxWidth, 2u);
+  parameterRegistry.add({"iterations", "timed runs per size"}, &iterations, 1u);
+  parameterRegistry.add({"samples", "texels drawn with each table to compare their distributions"}, &samples, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  std::vector<Result> results;
+  for(uint32_t width = minWidth; width <= maxWidth; width *= 2)
+  {
+    Result result;
+    result.width  = width;
+    result.height = width / 2;
+
+    const std::vector<float>        source = fixtures::makeEnvironment(result.width, result.height);
+    std::vector<float>              serialPixels, parallelPixels;
+    std::vector<shaderio::EnvAccel> serialAccel, parallelAccel;
+    float                           serialAverage = 0, serialIntegral = 0, parallelAverage = 0, parallelIntegral = 0;
+    std::vector<double>             serialTimes, parallelTimes;
+    for(uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+      serialPixels = source;
+      nvutils::PerformanceTimer serialTimer;
+      serialAccel = createEnvironmentAccelSerial(serialPixels.data(), result.width, result.height, serialAverage, serialIntegral);
+      serialTimes.push_back(serialTimer.getMilliseconds());
+
+      parallelPixels = source;
+      nvutils::PerformanceTimer parallelTimer;
+      parallelAccel = nvvk::createEnvironmentAccel(parallelPixels.data(), result.width, result.height, parallelAverage, parallelIntegral);
+      parallelTimes.push_back(parallelTimer.getMilliseconds());
+    }
+    std::sort(serialTimes.begin(), serialTimes.end());
+    std::sort(parallelTimes.begin(), parallelTimes.end());
+    result.serialMinMs      = serialTimes.front();
+    result.serialMedianMs   = serialTimes[serialTimes.size() / 2];
+    result.parallelMinMs    = parallelTimes.front();
+    result.parallelMedianMs = parallelTimes[parallelTimes.size() / 2];
+
+    const Reference reference = makeReference(source, result.width, result.height);
+    result.serialDistance     = totalVariationDistance(serialAccel, reference);
+    result.parallelDistance   = totalVariationDistance(parallelAccel, reference);
+    result.serialChi2   = chiSquaredPerDof(serialAccel, reference, result.width, result.height, samples, 0x9E3779B97F4A7C15ull);
+    result.parallelChi2 = chiSquaredPerDof(parallelAccel, reference, result.width, result.height, samples, 0xD1B54A32D192ED03ull);
+
+    // Only the new version is checked: the serial one sums the importance and
+    // updates the ratios in float, which shows in its distance on large sizes
+    auto close = [](double a, double b) { return std::abs(a - b) <= 1e-4 * std::abs(b); };
+    result.ok  = close(parallelAverage, reference.average) && close(parallelIntegral, reference.integral)
+                && result.parallelDistance < 1e-4 && result.parallelChi2 < 1.5;
+    for(size_t i = 0; i < source.size() && result.ok; i += 4)
+    {
+      const float maxComponent = std::max(source[i], std::max(source[i + 1], source[i + 2]));
+      result.ok                = close(parallelPixels[i + 3], maxComponent / reference.integral);
+    }
+    results.push_back(result);
+  }
+
+  LOGI("%u hardware threads\n", std::thread::hardware_concurrency());
+  std::string json = "{\n  \"benchmark\": \"environment_accel\",\n  \"iterations\": " + std::to_string(iterations)
+                     + ",\n  \"samples\": " + std::to_string(samples) + ",\n  \"hardware_threads\": "
+                     + std::to_string(std::thread::hardware_concurrency()) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%5u x %-5u  serial %10.3f ms  parallel %10.3f ms  distance %.2e / %.2e  chi2/dof %.3f / %.3f%s\n",
+         r.width, r.height, r.serialMedianMs, r.parallelMedianMs, r.serialDistance, r.parallelDistance, r.serialChi2,
+         r.parallelChi2, r.ok ? "" : " (MISMATCH)");
+
+    char numbers[512];
+    snprintf(numbers, sizeof(numbers),
+             "\"width\": %u, \"height\": %u, \"serial_median_ms\": %.4f, \"serial_min_ms\": %.4f, "
+             "\"parallel_median_ms\": %.4f, \"parallel_min_ms\": %.4f, \"serial_distance\": %.4e, "
+             "\"parallel_distance\": %.4e, \"serial_chi_squared_per_dof\": %.4f, "
+             "\"parallel_chi_squared_per_dof\": %.4f, \"ok\": %s",
+             r.width, r.height, r.serialMedianMs, r.serialMinMs, r.parallelMedianMs, r.parallelMinMs, r.serialDistance,
+             r.parallelDistance, r.serialChi2, r.parallelChi2, r.ok ? "true" : "false");
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU environment baker of nvshaders_host (hdr_env_bake.hpp) on a
+synthetic `--width` x `--width` / 2 environment (a sky gradient with noise
+and a small sun), on one thread and on all of nvutils' thread pool:
+* projectEnvironmentSH, in millions of texels per second
+* bakeDiffuseCube at `--diffuse`^2 per face
+* prefilterGlossyCube at `--glossy`^2 per face with `--samples` samples
+* integrateBrdfLut at `--lut`^2 with 1024 samples, as HdrEnvDome
+
+It fails if a result isn't finite or doesn't convert to a KTX2 image;
+tests/environment_bake_test.cpp checks the results themselves.
+
+Example:
+  nvpro2_environment_bake_benchmark --width 4096 --glossy 512 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvshaders_host/hdr_env_bake.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+struct Result
+{
+  uint32_t threads          = 0;
+  double   shMs             = 0.0;
+  double   shTexelsPerSec   = 0.0;
+  double   diffuseMs        = 0.0;
+  double   glossyMs         = 0.0;
+  double   glossySamplesSec = 0.0;
+  double   lutMs            = 0.0;
+};
+
+bool allFinite(const std::vector<float>& values)
+{
+  return std::all_of(values.begin(), values.end(), [](float v) { return std::isfinite(v); });
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              width          = 4096;
+  uint32_t              diffuseSize    = 128;
+  uint32_t              glossySize     = 512;
+  uint32_t              samples        = 64;
+  uint32_t              lutSize        = 512;
+  std::filesystem::path outputFilename = "environment_bake_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures the CPU environment baker; writes JSON.");
+  parameterRegistry.add({"width", "width of the environment; it's half as high"}, &width, 4u);
+  parameterRegistry.add({"diffuse", "size of the diffuse cube faces"}, &diffuseSize, 1u);
+  parameterRegistry.add({"glossy", "size of mip 0 of the glossy cube faces"}, &glossySize, 1u);
+  parameterRegistry.add({"samples", "samples per glossy texel"}, &samples, 1u);
+  parameterRegistry.add({"lut", "size of the BRDF table"}, &lutSize, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  // Report failures through the exit status rather than a debugger break
+  nvutils::Logger::getInstance().breakOnError(false);
+
+  const uint32_t           height      = width / 2;
+  const std::vector<float> environment = fixtures::makeEnvironment(width, height);
+
+  std::vector<Result>             results;
+  nvshaders::SphericalHarmonicsL2 sh;
+  nvshaders::CubeMap              diffuse, glossy;
+  std::vector<float>              lut;
+  for(uint32_t threads : {1u, 0u})
+  {
+    Result result;
+    result.threads = threads;
+
+    nvutils::PerformanceTimer shTimer;
+    sh                    = nvshaders::projectEnvironmentSH(environment.data(), width, height, threads);
+    result.shMs           = shTimer.getMilliseconds();
+    result.shTexelsPerSec = double(width) * height / (result.shMs / 1000.0);
+
+    nvutils::PerformanceTimer diffuseTimer;
+    diffuse          = nvshaders::bakeDiffuseCube(sh, diffuseSize, threads);
+    result.diffuseMs = diffuseTimer.getMilliseconds();
+
+    nvutils::PerformanceTimer glossyTimer;
+    glossy          = nvshaders::prefilterGlossyCube(environment.data(), width, height, glossySize, samples, threads);
+    result.glossyMs = glossyTimer.getMilliseconds();
+    // Mip 0 takes one sample per texel
+    double glossySamples = 6.0 * glossySize * glossySize;
+    for(size_t mip = 1; mip < glossy.mips.size(); mip++)
+    {
+      glossySamples += double(glossy.mips[mip].size() / 4) * samples;
+    }
+    result.glossySamplesSec = glossySamples / (result.glossyMs / 1000.0);
+
+    nvutils::PerformanceTimer lutTimer;
+    lut          = nvshaders::integrateBrdfLut(lutSize, 1024, threads);
+    result.lutMs = lutTimer.getMilliseconds();
+    results.push_back(result);
+  }
+
+  bool finite = true;
+  for(const glm::vec3& coefficient : sh.coefficients)
+  {
+    finite = finite && std::isfinite(coefficient.x) && std::isfinite(coefficient.y) && std::isfinite(coefficient.z);
+  }
+  for(const std::vector<float>& mip : diffuse.mips)
+  {
+    finite = finite && allFinite(mip);
+  }
+  for(const std::vector<float>& mip : glossy.mips)
+  {
+    finite = finite && allFinite(mip);
+  }
+  finite = finite && allFinite(lut);
+  if(!finite)
+  {
+    LOGE("The baked environment has values that aren't finite.\n");
+    return EXIT_FAILURE;
+  }
+
+  nv_ktx::KTXImage image;
+  if(nv_ktx::ErrorWithText error = nvshaders::cubeMapToKTX(diffuse, image))
+  {
+    LOGE("Converting the diffuse cube to KTX2 failed: %s\n", error->c_str());
+    return EXIT_FAILURE;
+  }
+  if(nv_ktx::ErrorWithText error = nvshaders::cubeMapToKTX(glossy, image))
+  {
+    LOGE("Converting the glossy cube to KTX2 failed: %s\n", error->c_str());
+    return EXIT_FAILURE;
+  }
+  if(nv_ktx::ErrorWithText error = nvshaders::brdfLutToKTX(lut, lutSize, image))
+  {
+    LOGE("Converting the BRDF table to KTX2 failed: %s\n", error->c_str());
+    return EXIT_FAILURE;
+  }
+
+  LOGI("%u hardware threads\n", std::thread::hardware_concurrency());
+  std::string json = "{\n  \"benchmark\": \"environment_bake\",\n  \"width\": " + std::to_string(width)
+                     + ",\n  \"height\": " + std::to_string(height) + ",\n  \"diffuse_size\": " + std::to_string(diffuseSize)
+                     + ",\n  \"glossy_size\": " + std::to_string(glossySize) + ",\n  \"glossy_samples\": "
+                     + std::to_string(samples) + ",\n  \"lut_size\": " + std::to_string(lutSize)
+                     + ",\n  \"hardware_threads\": " + std::to_string(std::thread::hardware_concurrency());
+  json += ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%s  SH %9.3f ms %8.1f Mtexels/s  diffuse %8.3f ms  glossy %10.3f ms %7.1f Msamples/s  BRDF %9.3f ms\n",
+         r.threads == 1 ? "1 thread   " : "all threads", r.shMs, r.shTexelsPerSec / 1e6, r.diffuseMs, r.glossyMs,
+         r.glossySamplesSec / 1e6, r.lutMs);
+
+    char numbers[512];
+    snprintf(numbers, sizeof(numbers),
+             "\"threads\": %u, \"sh_ms\": %.4f, \"sh_texels_per_second\": %.1f, \"diffuse_ms\": %.4f, "
+             "\"glossy_ms\": %.4f, \"glossy_samples_per_second\": %.1f, \"lut_ms\": %.4f",
+             r.threads, r.shMs, r.shTexelsPerSec, r.diffuseMs, r.glossyMs, r.glossySamplesSec, r.lutMs);
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
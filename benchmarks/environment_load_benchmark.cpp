@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU side of HdrIbl::loadEnvironment for Radiance .hdr files of
+`--min` to `--max` texels wide (doubling; twice as wide as high), from the
+file on disk to the texels and importance sampling data it uploads:
+* as it used to: nvutils::loadFile, stbi_loadf_from_memory to RGBA32F, and
+  nvvk::createEnvironmentAccel
+* as it does now: nvutils::FileReadMapping and nvvk::decodeEnvironment,
+  which decodes to RGBA16F and builds the importance map in the same pass
+
+The environments are synthetic (a sky gradient with noise and a small sun),
+written with stb_image_write to the temporary directory.
+
+For each size, this reports the median and minimum time of both, and the
+peak heap usage through operator new and stb_image (the mapped file isn't
+on the heap), as JSON. The average luminance and integral of both must
+agree to 1e-3, and the decoded texels to half-float precision.
+
+Example:
+  nvpro2_environment_load_benchmark --min 1024 --max 8192 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nvutils/file_mapping.hpp"
+#include "nvutils/file_operations.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/hdr_ibl.hpp"
+
+#include "alloc_stats.hpp"
+
+#define STBI_MALLOC(size) alloc_stats::allocate(size)
+#define STBI_REALLOC(p, newSize) alloc_stats::reallocate(p, newSize)
+#define STBI_FREE(p) alloc_stats::release(p)
+// Use static definitions to avoid conflicts with other libraries' copies of
+// stb_image.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace {
+
+struct Result
+{
+  uint32_t width          = 0;
+  uint32_t height         = 0;
+  uint64_t fileBytes      = 0;
+  double   stbMedianMs    = 0.0;
+  double   stbMinMs       = 0.0;
+  int64_t  stbPeakBytes   = 0;
+  double   rgbeMedianMs   = 0.0;
+  double   rgbeMinMs      = 0.0;
+  int64_t  rgbePeakBytes  = 0;
+  uint64_t rgbeTexelBytes = 0;
+  bool     ok             = true;
+};
+
+// Writes a sky gradient with noise and a sun to `path` as a Radiance file.
+bool writeEnvironment(const std::filesystem::path& path, uint32_t width, uint32_t height)
+{
+  std::vector<float> rgb(size_t(width) * height * 3);
+  uint32_t           rng = 12345;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    const float v = (float(y) + 0.5f) / float(height);
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const float u     = (float(x) + 0.5f) / float(width);
+      rng               = rng * 1664525u + 1013904223u;
+      const float noise = 1.0f + 0.25f * (float(rng >> 8) / float(1 << 24) - 0.5f);
+      const float du    = u - 0.3f;
+      const float dv    = v - 0.25f;
+      const float sun   = (du * du + dv * dv < 1e-4f) ? 5000.0f : 0.0f;
+      float*      texel = &rgb[(size_t(y) * width + x) * 3];
+      texel[0]          = (0.2f + 0.8f * v) * noise + sun;
+      texel[1]          = (0.4f + 0.6f * v) * noise + sun;
+      texel[2]          = (1.0f - 0.5f * v) * noise + sun;
+    }
+  }
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, path.c_str(), L"wb");
+#else
+  file = fopen(path.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    return false;
+  }
+  auto writeToFile = [](void* context, void* data, int size) { fwrite(data, 1, size_t(size), static_cast<FILE*>(context)); };
+  const bool ok = stbi_write_hdr_to_func(writeToFile, file, int(width), int(height), 3, rgb.data()) != 0;
+  fclose(file);
+  return ok;
+}
+
+struct StbFree
+{
+  void operator()(float* pixels) const { stbi_image_free(pixels); }
+};
+using StbPixels = std::unique_ptr<float, StbFree>;
+
+// What loadEnvironment did before decodeEnvironment; returns the RGBA32F texels.
+StbPixels loadStb(const std::filesystem::path& path, float& average, float& integral, size_t& accelSize)
+{
+  const std::string fileContents = nvutils::loadFile(path);
+  int               w = 0, h = 0, comp = 0;
+  StbPixels         pixels(stbi_loadf_from_memory(reinterpret_cast<const stbi_uc*>(fileContents.data()),
+                                                  int(fileContents.size()), &w, &h, &comp, STBI_rgb_alpha));
+  if(pixels)
+  {
+    accelSize = nvvk::createEnvironmentAccel(pixels.get(), uint32_t(w), uint32_t(h), average, integral).size();
+  }
+  return pixels;
+}
+
+bool loadRgbe(const std::filesystem::path& path, nvvk::EnvironmentImage& image)
+{
+  nvutils::FileReadMapping mapping;
+  if(!mapping.open(path))
+  {
+    return false;
+  }
+  const nvutils::RgbeError error =
+      nvvk::decodeEnvironment(std::span<const char>(static_cast<const char*>(mapping.data()), mapping.size()), image);
+  if(error)
+  {
+    LOGE("decodeEnvironment failed: %s\n", error->c_str());
+  }
+  return !error;
+}
+
+// Compares loadRgbe's texels with loadStb's.
+bool texelsMatch(const nvvk::EnvironmentImage& image, const float* reference)
+{
+  const size_t       count = size_t(image.width) * image.height * 4;
+  std::vector<float> texels(count);
+  if(image.format == VK_FORMAT_R16G16B16A16_SFLOAT)
+  {
+    nvutils::halfToFloat(reinterpret_cast<const uint16_t*>(image.texels.data()), count, texels.data());
+  }
+  else
+  {
+    memcpy(texels.data(), image.texels.data(), count * sizeof(float));
+  }
+  for(size_t i = 0; i < count; i++)
+  {
+    // Alpha holds the PDF, which loadStb's createEnvironmentAccel wrote too
+    if(std::abs(texels[i] - reference[i]) > 1e-3f * std::abs(reference[i]) + 1e-7f)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              minWidth       = 1024;
+  uint32_t              maxWidth       = 8192;
+  uint32_t              iterations     = 3;
+  std::filesystem::path outputFilename = "environment_load_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures loading HDR environments; writes JSON.");
+  parameterRegistry.add({"min", "width of the smallest environment"}, &minWidth, 2u);
+  parameterRegistry.add({"max", "width of the largest environment"}, &maxWidth, 2u);
+  parameterRegistry.add({"iterations", "timed runs per size"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const std::filesystem::path hdrPath = std::filesystem::temp_directory_path() / "nvpro2_environment_load_benchmark.hdr";
+
+  std::vector<Result> results;
+  for(uint32_t width = minWidth; width <= maxWidth; width *= 2)
+  {
+    Result result;
+    result.width  = width;
+    result.height = width / 2;
+    if(!writeEnvironment(hdrPath, result.width, result.height))
+    {
+      LOGE("Could not write %s.\n", hdrPath.string().c_str());
+      return EXIT_FAILURE;
+    }
+    result.fileBytes = std::filesystem::file_size(hdrPath);
+
+    std::vector<double> stbTimes, rgbeTimes;
+    StbPixels           stbTexels;
+    float               stbAverage = 0, stbIntegral = 0;
+    size_t              stbAccelSize = 0;
+    for(uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+      stbTexels.reset();
+      alloc_stats::reset();
+      const int64_t             before = alloc_stats::g_current;
+      nvutils::PerformanceTimer stbTimer;
+      stbTexels = loadStb(hdrPath, stbAverage, stbIntegral, stbAccelSize);
+      stbTimes.push_back(stbTimer.getMilliseconds());
+      result.stbPeakBytes = alloc_stats::g_peak - before;
+    }
+
+    nvvk::EnvironmentImage image;
+    for(uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+      image = {};
+      alloc_stats::reset();
+      const int64_t             before = alloc_stats::g_current;
+      nvutils::PerformanceTimer rgbeTimer;
+      result.ok = loadRgbe(hdrPath, image) && result.ok;
+      rgbeTimes.push_back(rgbeTimer.getMilliseconds());
+      result.rgbePeakBytes = alloc_stats::g_peak - before;
+    }
+    result.rgbeTexelBytes = image.texels.size();
+    std::filesystem::remove(hdrPath);
+
+    std::sort(stbTimes.begin(), stbTimes.end());
+    std::sort(rgbeTimes.begin(), rgbeTimes.end());
+    result.stbMinMs     = stbTimes.front();
+    result.stbMedianMs  = stbTimes[stbTimes.size() / 2];
+    result.rgbeMinMs    = rgbeTimes.front();
+    result.rgbeMedianMs = rgbeTimes[rgbeTimes.size() / 2];
+
+    auto close = [](double a, double b) { return std::abs(a - b) <= 1e-3 * std::abs(b); };
+    result.ok  = result.ok && stbTexels && image.accel.size() == stbAccelSize
+                && close(image.average, stbAverage) && close(image.integral, stbIntegral) && texelsMatch(image, stbTexels.get());
+    results.push_back(result);
+  }
+
+  LOGI("%u hardware threads\n", std::thread::hardware_concurrency());
+  std::string json = "{\n  \"benchmark\": \"environment_load\",\n  \"iterations\": " + std::to_string(iterations)
+                     + ",\n  \"hardware_threads\": " + std::to_string(std::thread::hardware_concurrency())
+                     + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%5u x %-5u  stb %10.3f ms %8.1f MiB peak  decodeEnvironment %10.3f ms %8.1f MiB peak%s\n", r.width,
+         r.height, r.stbMedianMs, double(r.stbPeakBytes) / (1024.0 * 1024.0), r.rgbeMedianMs,
+         double(r.rgbePeakBytes) / (1024.0 * 1024.0), r.ok ? "" : " (MISMATCH)");
+
+    char numbers[512];
+    snprintf(numbers, sizeof(numbers),
+             "\"width\": %u, \"height\": %u, \"file_bytes\": %llu, \"stb_median_ms\": %.4f, \"stb_min_ms\": %.4f, "
+             "\"stb_peak_bytes\": %lld, \"rgbe_median_ms\": %.4f, \"rgbe_min_ms\": %.4f, \"rgbe_peak_bytes\": %lld, "
+             "\"rgbe_texel_bytes\": %llu, \"ok\": %s",
+             r.width, r.height, static_cast<unsigned long long>(r.fileBytes), r.stbMedianMs, r.stbMinMs,
+             static_cast<long long>(r.stbPeakBytes), r.rgbeMedianMs, r.rgbeMinMs, static_cast<long long>(r.rgbePeakBytes),
+             static_cast<unsigned long long>(r.rgbeTexelBytes), r.ok ? "true" : "false");
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
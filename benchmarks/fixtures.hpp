@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Synthetic inputs shared by the benchmarks: texture files and images made up
+on the fly, so that the benchmarks don't depend on assets; and the JSON
+writer for their results.
+
+The PNG and JPEG functions need stb_image_write: include <stb_image_write.h>
+(with STB_IMAGE_WRITE_IMPLEMENTATION in one file) before this header.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <directx/dxgiformat.h>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_dds.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+
+namespace fixtures {
+
+// The number of mips of a full chain for a `size` x `size` texture
+inline uint32_t getMipCount(uint32_t size)
+{
+  uint32_t mips = 1;
+  while((size >> mips) > 0)
+  {
+    mips++;
+  }
+  return mips;
+}
+
+// Writes a `size` x `size` DDS file with a full mip chain in `format`;
+// `makeMip` returns the bytes of the mip of the given size.
+inline bool writeDDS(const std::filesystem::path&                        path,
+                     uint32_t                                            size,
+                     DXGI_FORMAT                                         format,
+                     const std::function<std::vector<char>(uint32_t)>& makeMip)
+{
+  nv_dds::Image image;
+  image.mip0Width  = size;
+  image.mip0Height = size;
+  image.mip0Depth  = 1;
+  image.dxgiFormat = format;
+  image.allocate(getMipCount(size), 1, 1);
+  for(uint32_t mip = 0; mip < getMipCount(size); mip++)
+  {
+    const std::vector<char> data = makeMip(std::max(1u, size >> mip));
+    image.subresource(mip).create(data.size(), data.data());
+  }
+  std::ofstream stream(path, std::ios::binary);
+  return !image.writeToStream(stream, {}).has_value() && stream.good();
+}
+
+// Returns a mipmapped texture array of `format`, which must have RGBA8
+// texels, with gradients and some noise, so that it's compressible, but not
+// trivially so. Each layer is a little different, and so is each `seed`.
+inline nv_ktx::KTXImage makeTextureArray(uint32_t size, uint32_t layers, VkFormat format, uint32_t seed = 0)
+{
+  nv_ktx::KTXImage image;
+  image.format       = format;
+  image.mip_0_width  = size;
+  image.mip_0_height = size;
+  image.allocate(1, layers, 1);
+  uint32_t rng = 12345 + seed;
+  for(uint32_t layer = 0; layer < layers; layer++)
+  {
+    std::vector<char>& pixels = image.subresource(0, layer, 0);
+    pixels.resize(size_t(size) * size * 4);
+    for(uint32_t y = 0; y < size; y++)
+    {
+      for(uint32_t x = 0; x < size; x++)
+      {
+        rng              = rng * 1664525u + 1013904223u;
+        const int noise  = int(rng >> 28) - 8;
+        char*     texel  = &pixels[(size_t(y) * size + x) * 4];
+        const int circle = (((x + layer * 8 + seed) / 32 + y / 32) % 2) * 64;
+        texel[0]         = char(std::clamp(int(x * 255 / std::max(1u, size - 1)) + noise, 0, 255));
+        texel[1]         = char(std::clamp(int(y * 255 / std::max(1u, size - 1)) + noise, 0, 255));
+        texel[2]         = char(std::clamp(128 + circle + noise, 0, 255));
+        texel[3]         = char(255);
+      }
+    }
+  }
+  mip_generation::Settings mipSettings;
+  mipSettings.filter = mip_generation::Filter::eBox;
+  mip_generation::generateMips(image, mipSettings);
+  return image;
+}
+
+// Returns a `width` x `height` RGBA32F environment: a sky gradient with noise
+// and a small, very bright sun.
+inline std::vector<float> makeEnvironment(uint32_t width, uint32_t height)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  uint32_t           rng = 1234;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      rng               = rng * 1664525u + 1013904223u;
+      const float noise = float(rng >> 8) / 16777216.0f;
+      const float sky   = 0.2f + 0.8f * float(height - y) / float(height);
+      const float dx    = float(x) / float(width) - 0.3f;
+      const float dy    = float(y) / float(height) - 0.25f;
+      const bool  sun   = dx * dx + dy * dy < 0.0001f;
+      float*      texel = &rgba[(size_t(y) * width + x) * 4];
+      texel[0]          = sun ? 20000.0f : sky * (0.5f + 0.5f * noise);
+      texel[1]          = sun ? 18000.0f : sky * (0.6f + 0.4f * noise);
+      texel[2]          = sun ? 15000.0f : sky * (0.9f + 0.2f * noise);
+      texel[3]          = 1.0f;
+    }
+  }
+  return rgba;
+}
+
+#ifdef INCLUDE_STB_IMAGE_WRITE_H
+// stb_image_write callback that appends to a std::vector<char>
+inline void appendToVector(void* context, void* data, int size)
+{
+  std::vector<char>* out = static_cast<std::vector<char>*>(context);
+  out->insert(out->end(), static_cast<char*>(data), static_cast<char*>(data) + size);
+}
+
+// Encodes `width` x `height` RGBA8 texels as a PNG file.
+inline std::vector<char> encodePNG(uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba)
+{
+  std::vector<char> file;
+  stbi_write_png_to_func(appendToVector, &file, int(width), int(height), 4, rgba.data(), int(width * 4));
+  return file;
+}
+
+// Encodes `width` x `height` RGB8 texels as a JPEG file of quality 90.
+inline std::vector<char> encodeJPG(uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb)
+{
+  std::vector<char> file;
+  stbi_write_jpg_to_func(appendToVector, &file, int(width), int(height), 3, rgb.data(), 90);
+  return file;
+}
+
+// Returns `size` x `size` texels of `channels` (3 or 4) 8-bit channels, with
+// gradients and noise; `seed` makes each image of a set different.
+inline std::vector<uint8_t> makeTexels(uint32_t size, uint32_t channels, uint32_t seed)
+{
+  std::vector<uint8_t> pixels(size_t(size) * size * channels);
+  uint32_t             rng = 12345 + seed * 7919;
+  for(uint32_t y = 0; y < size; y++)
+  {
+    for(uint32_t x = 0; x < size; x++)
+    {
+      rng             = rng * 1664525u + 1013904223u;
+      const int noise = int(rng >> 28) - 8;
+      uint8_t*  texel = &pixels[(size_t(y) * size + x) * channels];
+      texel[0]        = uint8_t(std::clamp(int((x + seed * 16) % size * 255 / std::max(1u, size - 1)) + noise, 0, 255));
+      texel[1]        = uint8_t(std::clamp(int(y * 255 / std::max(1u, size - 1)) + noise, 0, 255));
+      texel[2]        = uint8_t(std::clamp(int(seed * 37 % 256) + noise, 0, 255));
+      if(channels == 4)
+      {
+        texel[3] = 255;
+      }
+    }
+  }
+  return pixels;
+}
+
+// A `size` x `size` PNG (RGBA) or JPEG (RGB) file of makeTexels().
+inline std::vector<char> makePNG(uint32_t size, uint32_t seed)
+{
+  return encodePNG(size, size, makeTexels(size, 4, seed));
+}
+
+inline std::vector<char> makeJPG(uint32_t size, uint32_t seed)
+{
+  return encodeJPG(size, size, makeTexels(size, 3, seed));
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// JSON output
+//-----------------------------------------------------------------------------
+
+// The members of a JSON object, added in order.
+class JSONObject
+{
+public:
+  JSONObject& add(const char* key, const std::string& value)
+  {
+    std::string quoted = "\"";
+    for(char c : value)
+    {
+      if(c == '"' || c == '\\')
+      {
+        quoted += '\\';
+      }
+      quoted += c;
+    }
+    return addJSON(key, quoted + "\"");
+  }
+  JSONObject& add(const char* key, const char* value) { return add(key, std::string(value)); }
+  JSONObject& add(const char* key, bool value) { return addJSON(key, value ? "true" : "false"); }
+  template <typename T>
+    requires std::is_integral_v<T>
+  JSONObject& add(const char* key, T value)
+  {
+    return addJSON(key, std::to_string(value));
+  }
+  // A number with `decimals` digits after the point
+  JSONObject& add(const char* key, double value, int decimals = 4)
+  {
+    char number[64];
+    snprintf(number, sizeof(number), "%.*f", decimals, value);
+    return addJSON(key, number);
+  }
+  // A value that's JSON already, such as an array
+  JSONObject& addJSON(const char* key, const std::string& json)
+  {
+    members.push_back("\"" + std::string(key) + "\": " + json);
+    return *this;
+  }
+
+  // "key": value strings
+  std::vector<std::string> members;
+};
+
+// Formats the results of benchmark `name`, as all the benchmarks write them:
+// an object with the benchmark's name and `settings`, one member per line,
+// then "results", an array of `results` with one object per line.
+inline std::string toJSON(const char* name, const JSONObject& settings, const std::vector<JSONObject>& results)
+{
+  std::string json = "{\n  \"benchmark\": \"" + std::string(name) + "\"";
+  for(const std::string& member : settings.members)
+  {
+    json += ",\n  " + member;
+  }
+  json += ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    json += "    {";
+    for(size_t m = 0; m < results[i].members.size(); m++)
+    {
+      json += (m ? ", " : "") + results[i].members[m];
+    }
+    json += (i + 1 < results.size()) ? "},\n" : "}\n";
+  }
+  json += "  ]\n}\n";
+  return json;
+}
+
+// Writes `json` to `path`; logs and returns false if that fails.
+inline bool writeJSON(const std::filesystem::path& path, const std::string& json)
+{
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, path.c_str(), L"wb");
+#else
+  file = fopen(path.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", path.string().c_str());
+    return false;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", path.string().c_str());
+  return true;
+}
+
+}  // namespace fixtures
@@ -0,0 +1,542 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures how long each image decoding path takes:
+* nv_dds reads (copying and memory view)
+* nv_ktx KTX1 and KTX2 reads, with no supercompression, Zstandard, UASTC,
+  and ETC1S; UASTC and ETC1S also with a warm nv_ktx::TranscodeCache
+* The stb_image PNG and JPEG paths used by SceneVk::loadImage
+* Radiance .hdr files with stb_image, as HdrIbl::loadEnvironment used to
+  load them, and with nvutils::decodeRgbe to RGBA16F and RGBA32F, which it
+  uses now (without the importance map it builds in the same pass)
+
+Test images are synthesized at startup, so no data files are needed. For
+each path, size, and thread count, this reports the median and minimum
+decode time, throughput, and the number and peak size of allocations made
+through operator new and stb_image, as JSON.
+
+Example:
+  nvpro2_image_decode_benchmark --sizes 256,1024,4096 --threads 1,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <directx/dxgiformat.h>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_dds.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvimageformats/texture_conversion.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/rgbe_decode.hpp"
+#include "nvutils/timers.hpp"
+
+#include "alloc_stats.hpp"
+
+#define STBI_MALLOC(size) alloc_stats::allocate(size)
+#define STBI_REALLOC(p, newSize) alloc_stats::reallocate(p, newSize)
+#define STBI_FREE(p) alloc_stats::release(p)
+// Use static definitions to avoid conflicts with other libraries' copies of
+// stb_image.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "fixtures.hpp"
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Test image synthesis
+//-----------------------------------------------------------------------------
+
+// Returns an RGBA8 image with gradients and some noise, so that it's
+// compressible, but not trivially so.
+std::vector<uint8_t> makeRGBA8(uint32_t width, uint32_t height)
+{
+  std::vector<uint8_t> pixels(size_t(width) * height * 4);
+  uint32_t             rng = 12345;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      rng              = rng * 1664525u + 1013904223u;
+      const int noise  = int(rng >> 28) - 8;
+      uint8_t*  texel  = &pixels[(size_t(y) * width + x) * 4];
+      const int circle = ((x / 32 + y / 32) % 2) * 64;
+      texel[0]         = uint8_t(std::clamp(int(x * 255 / std::max(1u, width - 1)) + noise, 0, 255));
+      texel[1]         = uint8_t(std::clamp(int(y * 255 / std::max(1u, height - 1)) + noise, 0, 255));
+      texel[2]         = uint8_t(std::clamp(128 + circle + noise, 0, 255));
+      texel[3]         = 255;
+    }
+  }
+  return pixels;
+}
+
+std::vector<char> toChars(const std::string& s)
+{
+  return std::vector<char>(s.begin(), s.end());
+}
+
+std::vector<char> makeDDS(uint32_t width, uint32_t height, DXGI_FORMAT format)
+{
+  nv_dds::Image image;
+  image.mip0Width  = width;
+  image.mip0Height = height;
+  image.mip0Depth  = 1;
+  image.dxgiFormat = format;
+  if(format == DXGI_FORMAT_R8G8B8A8_UNORM)
+  {
+    const std::vector<uint8_t> pixels = makeRGBA8(width, height);
+    image.allocate(1, 1, 1);
+    image.subresource(0).create(pixels.size(), pixels.data());
+    mip_generation::Settings mipSettings;
+    mipSettings.filter = mip_generation::Filter::eBox;
+    mip_generation::generateMips(image, mipSettings);
+  }
+  else
+  {
+    // Block-compressed payloads aren't decoded by the reader, so random
+    // bytes measure the same work.
+    const uint32_t numMips = mip_generation::getFullMipCount(width, height);
+    image.allocate(numMips, 1, 1);
+    for(uint32_t mip = 0; mip < numMips; mip++)
+    {
+      const size_t blocks = size_t((image.getWidth(mip) + 3) / 4) * ((image.getHeight(mip) + 3) / 4);
+      std::vector<uint8_t> data(blocks * 16);
+      for(size_t i = 0; i < data.size(); i++)
+      {
+        data[i] = uint8_t(i * 2654435761u >> 13);
+      }
+      image.subresource(mip).create(data.size(), data.data());
+    }
+  }
+  std::ostringstream stream;
+  image.writeToStream(stream, {});
+  return toChars(stream.str());
+}
+
+std::vector<char> makeKTX2(uint32_t width, uint32_t height, const nv_ktx::WriteSettings& writeSettings)
+{
+  const bool       encodeBasis = writeSettings.encode_rgba8_to_format != nv_ktx::EncodeRGBA8ToFormat::NO;
+  nv_ktx::KTXImage image;
+  image.format       = encodeBasis ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_R8G8B8A8_SRGB;
+  image.mip_0_width  = width;
+  image.mip_0_height = height;
+  image.allocate(1, 0, 1);
+  const std::vector<uint8_t> pixels = makeRGBA8(width, height);
+  image.subresource(0).assign(pixels.begin(), pixels.end());
+  mip_generation::Settings mipSettings;
+  mipSettings.filter = mip_generation::Filter::eBox;
+  mip_generation::generateMips(image, mipSettings);
+
+  std::ostringstream          stream;
+  const nv_ktx::ErrorWithText error = image.writeKTX2Stream(stream, writeSettings);
+  if(error.has_value())
+  {
+    LOGE("Writing a KTX2 test image failed: %s\n", error->c_str());
+    return {};
+  }
+  return toChars(stream.str());
+}
+
+// The writer only writes KTX2, so we write a KTX1 RGBA8 file by hand.
+std::vector<char> makeKTX1(uint32_t width, uint32_t height)
+{
+  const std::vector<uint8_t> pixels       = makeRGBA8(width, height);
+  const uint8_t              identifier[] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+  const uint32_t             header[]     = {
+      0x04030201,  // endianness
+      0x1401,      // glType = GL_UNSIGNED_BYTE
+      1,           // glTypeSize
+      0x1908,      // glFormat = GL_RGBA
+      0x8058,      // glInternalFormat = GL_RGBA8
+      0x1908,      // glBaseInternalFormat = GL_RGBA
+      width,       // pixelWidth
+      height,      // pixelHeight
+      0,           // pixelDepth
+      0,           // numberOfArrayElements
+      1,           // numberOfFaces
+      1,           // numberOfMipmapLevels
+      0,           // bytesOfKeyValueData
+  };
+  const uint32_t imageSize = uint32_t(pixels.size());
+
+  std::vector<char> file;
+  file.insert(file.end(), reinterpret_cast<const char*>(identifier), reinterpret_cast<const char*>(identifier) + sizeof(identifier));
+  file.insert(file.end(), reinterpret_cast<const char*>(header), reinterpret_cast<const char*>(header) + sizeof(header));
+  file.insert(file.end(), reinterpret_cast<const char*>(&imageSize), reinterpret_cast<const char*>(&imageSize) + sizeof(imageSize));
+  file.insert(file.end(), reinterpret_cast<const char*>(pixels.data()), reinterpret_cast<const char*>(pixels.data()) + pixels.size());
+  return file;
+}
+
+std::vector<char> makePNG(uint32_t width, uint32_t height)
+{
+  return fixtures::encodePNG(width, height, makeRGBA8(width, height));
+}
+
+std::vector<char> makeJPG(uint32_t width, uint32_t height)
+{
+  const std::vector<uint8_t> rgba = makeRGBA8(width, height);
+  std::vector<uint8_t>       rgb(size_t(width) * height * 3);
+  for(size_t i = 0; i < size_t(width) * height; i++)
+  {
+    memcpy(&rgb[i * 3], &rgba[i * 4], 3);
+  }
+  return fixtures::encodeJPG(width, height, rgb);
+}
+
+std::vector<char> makeHDR(uint32_t width, uint32_t height)
+{
+  const std::vector<uint8_t> rgba = makeRGBA8(width, height);
+  std::vector<float>         rgb(size_t(width) * height * 3);
+  for(size_t i = 0; i < size_t(width) * height; i++)
+  {
+    for(size_t c = 0; c < 3; c++)
+    {
+      // Spread values over a high dynamic range.
+      rgb[i * 3 + c] = std::exp2(float(rgba[i * 4 + c]) / 16.0f - 8.0f);
+    }
+  }
+  std::vector<char> file;
+  stbi_write_hdr_to_func(fixtures::appendToVector, &file, int(width), int(height), 3, rgb.data());
+  return file;
+}
+
+//-----------------------------------------------------------------------------
+// Decoding paths
+//-----------------------------------------------------------------------------
+
+using DecodeFunc = std::function<bool(const std::vector<char>& file, uint32_t numThreads)>;
+
+bool decodeDDS(const std::vector<char>& file, bool view)
+{
+  nv_dds::Image         image;
+  nv_dds::ErrorWithText error;
+  if(view)
+  {
+    error = image.readFromMemoryView({reinterpret_cast<const std::byte*>(file.data()), file.size()}, {});
+  }
+  else
+  {
+    error = image.readFromMemory(file.data(), file.size(), {});
+  }
+  return !error.has_value();
+}
+
+bool decodeKTX(const std::vector<char>& file, uint32_t numThreads)
+{
+  nv_ktx::KTXImage     image;
+  nv_ktx::ReadSettings readSettings;
+  readSettings.num_threads = numThreads;
+  return !image.readFromMemoryView({reinterpret_cast<const std::byte*>(file.data()), file.size()}, readSettings).has_value();
+}
+
+// Like decodeKTX, but with a TranscodeCache that persists across runs, as
+// when an app reloads the same textures. The warm-up run fills the cache.
+bool decodeKTXCached(const std::vector<char>& file, uint32_t numThreads)
+{
+  static nv_ktx::TranscodeCache cache;
+  nv_ktx::KTXImage              image;
+  nv_ktx::ReadSettings          readSettings;
+  readSettings.num_threads     = numThreads;
+  readSettings.transcode_cache = &cache;
+  return !image.readFromMemoryView({reinterpret_cast<const std::byte*>(file.data()), file.size()}, readSettings).has_value();
+}
+
+// Like SceneVk::loadImage: 8-bit RGB images are loaded as RGB and expanded to
+// RGBA with texture_conversion; other images are loaded as RGBA.
+bool decodeStb8(const std::vector<char>& file, uint32_t numThreads)
+{
+  int w = 0, h = 0, comp = 0;
+  if(!stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), int(file.size()), &w, &h, &comp))
+  {
+    return false;
+  }
+  const int requiredComponents = (comp == 3) ? 3 : 4;
+  stbi_uc*  data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), int(file.size()), &w, &h, &comp,
+                                         requiredComponents);
+  if(data == nullptr)
+  {
+    return false;
+  }
+  std::vector<char> rgba(size_t(w) * h * 4);
+  if(requiredComponents == 3)
+  {
+    texture_conversion::ConversionSettings settings;
+    settings.numThreads = numThreads;
+    texture_conversion::convert(VK_FORMAT_R8G8B8_UNORM, {reinterpret_cast<const char*>(data), size_t(w) * h * 3},
+                                VK_FORMAT_R8G8B8A8_UNORM, rgba, uint32_t(w), uint32_t(h), settings);
+  }
+  else
+  {
+    memcpy(rgba.data(), data, rgba.size());
+  }
+  stbi_image_free(data);
+  return true;
+}
+
+// Like HdrIbl::loadEnvironment used to.
+bool decodeStbHDR(const std::vector<char>& file, uint32_t)
+{
+  int    w = 0, h = 0, comp = 0;
+  float* pixels = stbi_loadf_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), int(file.size()), &w, &h, &comp, STBI_rgb_alpha);
+  if(pixels == nullptr)
+  {
+    return false;
+  }
+  stbi_image_free(pixels);
+  return true;
+}
+
+bool decodeRgbe(const std::vector<char>& file, uint32_t numThreads, nvutils::RgbeTarget target)
+{
+  nvutils::RgbeImage image;
+  if(nvutils::parseRgbe(file, image))
+  {
+    return false;
+  }
+  std::vector<char> texels(nvutils::rgbeDecodedSizeBytes(target, image.width, image.height));
+  return !nvutils::decodeRgbe(file, image, target, texels, {}, numThreads);
+}
+
+bool decodeRgbeHalf(const std::vector<char>& file, uint32_t numThreads)
+{
+  return decodeRgbe(file, numThreads, nvutils::RgbeTarget::eRGBA16F);
+}
+
+bool decodeRgbeFloat(const std::vector<char>& file, uint32_t numThreads)
+{
+  return decodeRgbe(file, numThreads, nvutils::RgbeTarget::eRGBA32F);
+}
+
+//-----------------------------------------------------------------------------
+// Running and reporting
+//-----------------------------------------------------------------------------
+
+struct Case
+{
+  std::string       path;    // The decoding path, e.g. "nv_ktx.readFromMemoryView"
+  std::string       format;  // The file format, e.g. "KTX2 RGBA8 Zstd"
+  uint32_t          size = 0;
+  bool              threaded = false;  // Whether the path uses numThreads
+  std::vector<char> file;
+  DecodeFunc        decode;
+};
+
+struct Result
+{
+  std::string path;
+  std::string format;
+  uint32_t    size         = 0;
+  uint32_t    threads      = 0;
+  size_t      fileBytes    = 0;
+  double      medianMs     = 0.0;
+  double      minMs        = 0.0;
+  uint64_t    allocations  = 0;
+  int64_t     peakBytes    = 0;
+  bool        ok           = true;
+};
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+std::string toJSON(const std::vector<Result>& results, uint32_t iterations)
+{
+  fixtures::JSONObject settings;
+  settings.add("iterations", iterations);
+  std::vector<fixtures::JSONObject> jsonResults;
+  for(const Result& r : results)
+  {
+    const double megapixels   = double(r.size) * double(r.size) * 1e-6;
+    const double mpixPerSec   = (r.medianMs > 0.0) ? megapixels / (r.medianMs * 1e-3) : 0.0;
+    const double fileMBPerSec = (r.medianMs > 0.0) ? double(r.fileBytes) * 1e-6 / (r.medianMs * 1e-3) : 0.0;
+    jsonResults.emplace_back()
+        .add("path", r.path)
+        .add("format", r.format)
+        .add("width", r.size)
+        .add("height", r.size)
+        .add("threads", r.threads)
+        .add("file_bytes", r.fileBytes)
+        .add("median_ms", r.medianMs)
+        .add("min_ms", r.minMs)
+        .add("mpixels_per_s", mpixPerSec, 3)
+        .add("file_mb_per_s", fileMBPerSec, 3)
+        .add("allocations", r.allocations)
+        .add("peak_alloc_bytes", r.peakBytes)
+        .add("ok", r.ok);
+  }
+  return fixtures::toJSON("image_decode", settings, jsonResults);
+}
+
+Result runCase(const Case& c, uint32_t numThreads, uint32_t iterations)
+{
+  Result result;
+  result.path      = c.path;
+  result.format    = c.format;
+  result.size      = c.size;
+  result.threads   = numThreads;
+  result.fileBytes = c.file.size();
+
+  // Measure allocations on a warm-up run, so lazily initialized tables
+  // aren't counted.
+  result.ok = c.decode(c.file, numThreads);
+  alloc_stats::reset();
+  const int64_t baseline = alloc_stats::g_current.load();
+  result.ok              = c.decode(c.file, numThreads) && result.ok;
+  result.allocations     = alloc_stats::g_count.load();
+  result.peakBytes       = alloc_stats::g_peak.load() - baseline;
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    nvutils::PerformanceTimer timer;
+    result.ok = c.decode(c.file, numThreads) && result.ok;
+    times.push_back(timer.getMilliseconds());
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::string           sizesList      = "256,1024,2048";
+  std::string           threadsList    = "1,0";
+  uint32_t              iterations     = 5;
+  uint32_t              basisMaxSize   = 1024;
+  std::filesystem::path outputFilename = "image_decode_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures nvimageformats and stb_image decode times; writes JSON.");
+  parameterRegistry.add({"sizes", "comma-separated widths (and heights) of square test images"}, &sizesList);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed decodes per case"}, &iterations, 1u);
+  parameterRegistry.add({"basismaxsize", "largest size to encode with UASTC and ETC1S, which is slow"}, &basisMaxSize);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const std::vector<uint32_t> sizes   = parseList(sizesList);
+  const std::vector<uint32_t> threads = parseList(threadsList);
+
+  std::vector<Result> results;
+  for(uint32_t size : sizes)
+  {
+    LOGI("Synthesizing %u x %u test images\n", size, size);
+    std::vector<Case> cases;
+
+    const DecodeFunc ddsCopy = [](const std::vector<char>& file, uint32_t) { return decodeDDS(file, false); };
+    const DecodeFunc ddsView = [](const std::vector<char>& file, uint32_t) { return decodeDDS(file, true); };
+    for(const auto& [format, name] : {std::pair{DXGI_FORMAT_R8G8B8A8_UNORM, "DDS RGBA8"}, std::pair{DXGI_FORMAT_BC7_UNORM, "DDS BC7"}})
+    {
+      std::vector<char> file = makeDDS(size, size, format);
+      cases.push_back({"nv_dds.readFromMemory", name, size, false, file, ddsCopy});
+      cases.push_back({"nv_dds.readFromMemoryView", name, size, false, std::move(file), ddsView});
+    }
+
+    cases.push_back({"nv_ktx.readFromMemoryView", "KTX1 RGBA8", size, true, makeKTX1(size, size), decodeKTX});
+
+    nv_ktx::WriteSettings ktxSettings;
+    cases.push_back({"nv_ktx.readFromMemoryView", "KTX2 RGBA8", size, true, makeKTX2(size, size, ktxSettings), decodeKTX});
+    ktxSettings.supercompression = nv_ktx::WriteSupercompressionType::ZSTD;
+    ktxSettings.supercompression_level = 10;
+    cases.push_back({"nv_ktx.readFromMemoryView", "KTX2 RGBA8 Zstd", size, true, makeKTX2(size, size, ktxSettings), decodeKTX});
+    if(size <= basisMaxSize)
+    {
+      nv_ktx::WriteSettings basisSettings;
+      basisSettings.encode_rgba8_to_format = nv_ktx::EncodeRGBA8ToFormat::UASTC;
+      basisSettings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+      basisSettings.supercompression_level = 10;
+      std::vector<char> uastcFile = makeKTX2(size, size, basisSettings);
+      cases.push_back({"nv_ktx.readFromMemoryView", "KTX2 UASTC", size, true, uastcFile, decodeKTX});
+      cases.push_back({"nv_ktx.readFromMemoryView (transcode cache)", "KTX2 UASTC", size, true, std::move(uastcFile), decodeKTXCached});
+      basisSettings.encode_rgba8_to_format = nv_ktx::EncodeRGBA8ToFormat::ETC1S_RGBA;
+      basisSettings.etc1s_encoding_level   = 1;
+      std::vector<char> etc1sFile          = makeKTX2(size, size, basisSettings);
+      cases.push_back({"nv_ktx.readFromMemoryView", "KTX2 ETC1S", size, true, etc1sFile, decodeKTX});
+      cases.push_back({"nv_ktx.readFromMemoryView (transcode cache)", "KTX2 ETC1S", size, true, std::move(etc1sFile), decodeKTXCached});
+    }
+
+    cases.push_back({"SceneVk::loadImage (stb_image)", "PNG RGBA8", size, false, makePNG(size, size), decodeStb8});
+    cases.push_back({"SceneVk::loadImage (stb_image)", "JPEG RGB8", size, true, makeJPG(size, size), decodeStb8});
+    std::vector<char> hdrFile = makeHDR(size, size);
+    cases.push_back({"stbi_loadf_from_memory", "Radiance HDR", size, false, hdrFile, decodeStbHDR});
+    cases.push_back({"nvutils::decodeRgbe", "Radiance HDR to RGBA16F", size, true, hdrFile, decodeRgbeHalf});
+    cases.push_back({"nvutils::decodeRgbe", "Radiance HDR to RGBA32F", size, true, std::move(hdrFile), decodeRgbeFloat});
+
+    for(const Case& c : cases)
+    {
+      if(c.file.empty())
+      {
+        continue;
+      }
+      for(uint32_t numThreads : threads)
+      {
+        // Paths that don't use threads run once, single-threaded.
+        if(!c.threaded && numThreads != threads.front())
+        {
+          continue;
+        }
+        Result result = runCase(c, c.threaded ? numThreads : 1, iterations);
+        LOGI("%-46s %-18s %5u threads %-3u %10.3f ms%s\n", result.path.c_str(), result.format.c_str(), result.size,
+             result.threads, result.medianMs, result.ok ? "" : " (FAILED)");
+        results.push_back(std::move(result));
+      }
+    }
+  }
+
+  if(!fixtures::writeJSON(outputFilename, toJSON(results, iterations)))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
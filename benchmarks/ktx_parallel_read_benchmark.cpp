@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures KTX2 decode throughput against the number of threads, for texture
+arrays whose levels nv_ktx inflates and transcodes in parallel:
+* RGBA8 with Zstandard supercompression
+* RGBA8 with zlib supercompression (which nv_ktx can read, but not write, so
+  the benchmark recompresses the levels of an uncompressed file)
+* UASTC, transcoded to BC7
+
+Test textures are synthesized at startup. For each file and thread count,
+this reports the median and minimum read time, throughput in MPixels/s over
+all subresources, and the peak size of the reader's temporary allocations
+(everything but the image itself), which
+nv_ktx::ReadSettings::parallel_read_budget_in_bytes bounds, as JSON.
+
+Example:
+  nvpro2_ktx_parallel_read_benchmark --size 4096 --layers 16 --threads 1,2,4,8,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "alloc_stats.hpp"
+#include "fixtures.hpp"
+
+namespace {
+
+std::vector<char> writeKTX2(nv_ktx::KTXImage& image, const nv_ktx::WriteSettings& writeSettings)
+{
+  std::ostringstream          stream;
+  const nv_ktx::ErrorWithText error = image.writeKTX2Stream(stream, writeSettings);
+  if(error.has_value())
+  {
+    LOGW("Writing a KTX2 test texture failed: %s\n", error->c_str());
+    return {};
+  }
+  const std::string data = stream.str();
+  return std::vector<char>(data.begin(), data.end());
+}
+
+// Offsets in a KTX2 file; see the KTX 2.0 specification, section 3.
+constexpr size_t kSupercompressionSchemeOffset = 44;
+constexpr size_t kLevelIndexOffset             = 80;
+constexpr size_t kLevelCountOffset             = 40;
+
+// Returns a copy of an uncompressed KTX2 file with each level compressed
+// with zlib (supercompression scheme 3), or an empty vector on failure.
+std::vector<char> recompressWithZlib(const std::vector<char>& file)
+{
+  uint32_t levelCount = 0;
+  memcpy(&levelCount, file.data() + kLevelCountOffset, sizeof(levelCount));
+  levelCount = std::max(1u, levelCount);
+
+  struct LevelIndex
+  {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+  };
+  std::vector<LevelIndex> levels(levelCount);
+  memcpy(levels.data(), file.data() + kLevelIndexOffset, levelCount * sizeof(LevelIndex));
+  uint64_t firstLevelOffset = file.size();
+  for(const LevelIndex& level : levels)
+  {
+    firstLevelOffset = std::min(firstLevelOffset, level.byteOffset);
+  }
+
+  // Everything up to the level data stays the same; the levels follow in
+  // the same order as in the original file, smallest first.
+  std::vector<char> result(file.begin(), file.begin() + ptrdiff_t(firstLevelOffset));
+  const uint32_t    scheme = 3;
+  memcpy(result.data() + kSupercompressionSchemeOffset, &scheme, sizeof(scheme));
+  for(uint32_t mip = levelCount; mip-- > 0;)
+  {
+    LevelIndex& level       = levels[mip];
+    uLongf      deflatedLen = compressBound(uLong(level.byteLength));
+    std::vector<char> deflated(deflatedLen);
+    if(compress2(reinterpret_cast<Bytef*>(deflated.data()), &deflatedLen,
+                 reinterpret_cast<const Bytef*>(file.data() + level.byteOffset), uLong(level.byteLength), 6)
+       != Z_OK)
+    {
+      return {};
+    }
+    level.uncompressedByteLength = level.byteLength;
+    level.byteOffset             = result.size();
+    level.byteLength             = deflatedLen;
+    result.insert(result.end(), deflated.begin(), deflated.begin() + ptrdiff_t(deflatedLen));
+  }
+  memcpy(result.data() + kLevelIndexOffset, levels.data(), levelCount * sizeof(LevelIndex));
+  return result;
+}
+
+struct Case
+{
+  std::string       format;  // e.g. "RGBA8 Zstd"
+  std::vector<char> file;
+};
+
+struct Result
+{
+  std::string format;
+  uint32_t    threads       = 0;
+  size_t      fileBytes     = 0;
+  double      megapixels    = 0.0;
+  double      medianMs      = 0.0;
+  double      minMs         = 0.0;
+  int64_t     peakTempBytes = 0;
+  bool        ok            = true;
+};
+
+// Reads `file`; returns the size of the image's subresources in `imageBytes`,
+// and the number of pixels in them in `megapixels`.
+bool readKTX2(const std::vector<char>& file, const nv_ktx::ReadSettings& readSettings, size_t& imageBytes, double& megapixels)
+{
+  nv_ktx::KTXImage image;
+  if(image.readFromMemoryView({reinterpret_cast<const std::byte*>(file.data()), file.size()}, readSettings).has_value())
+  {
+    return false;
+  }
+  imageBytes = 0;
+  megapixels = 0.0;
+  for(uint32_t mip = 0; mip < image.num_mips; mip++)
+  {
+    for(uint32_t layer = 0; layer < std::max(1u, image.num_layers_possibly_0); layer++)
+    {
+      imageBytes += image.subresource(mip, layer, 0).size();
+      megapixels += double(std::max(1u, image.mip_0_width >> mip)) * double(std::max(1u, image.mip_0_height >> mip)) * 1e-6;
+    }
+  }
+  return true;
+}
+
+Result runCase(const Case& c, uint32_t numThreads, uint32_t iterations, uint64_t budgetBytes)
+{
+  nv_ktx::ReadSettings readSettings;
+  readSettings.num_threads                   = numThreads;
+  readSettings.parallel_read_budget_in_bytes = budgetBytes;
+
+  Result result;
+  result.format    = c.format;
+  result.threads   = numThreads;
+  result.fileBytes = c.file.size();
+
+  // The warm-up run measures peak memory.
+  size_t imageBytes = 0;
+  alloc_stats::reset();
+  const int64_t baseline = alloc_stats::g_current.load();
+  result.ok              = readKTX2(c.file, readSettings, imageBytes, result.megapixels);
+  result.peakTempBytes   = alloc_stats::g_peak.load() - baseline - int64_t(imageBytes);
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    nvutils::PerformanceTimer timer;
+    double                    megapixels = 0.0;
+    result.ok = readKTX2(c.file, readSettings, imageBytes, megapixels) && result.ok;
+    times.push_back(timer.getMilliseconds());
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              size           = 2048;
+  uint32_t              layers         = 8;
+  uint32_t              basisMaxSize   = 1024;
+  std::string           threadsList    = "1,2,4,8,0";
+  uint32_t              iterations     = 5;
+  uint32_t              budgetMB       = uint32_t(nv_ktx::ReadSettings{}.parallel_read_budget_in_bytes >> 20);
+  std::filesystem::path outputFilename = "ktx_parallel_read_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures nv_ktx KTX2 read throughput against the thread count; writes JSON.");
+  parameterRegistry.add({"size", "width and height of the texture arrays' base mip"}, &size, 4u);
+  parameterRegistry.add({"layers", "number of array layers"}, &layers, 1u);
+  parameterRegistry.add({"basismaxsize", "largest size to encode with UASTC, which is slow; larger sizes use this"}, &basisMaxSize, 4u);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed reads per case"}, &iterations, 1u);
+  parameterRegistry.add({"budget", "ReadSettings::parallel_read_budget_in_bytes, in MiB"}, &budgetMB, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  LOGI("Synthesizing %u x %u x %u layer test textures\n", size, size, layers);
+  std::vector<Case> cases;
+  {
+    nv_ktx::KTXImage       rgba8 = fixtures::makeTextureArray(size, layers, VK_FORMAT_R8G8B8A8_UNORM);
+    nv_ktx::WriteSettings  writeSettings;
+    cases.push_back({"RGBA8 zlib", recompressWithZlib(writeKTX2(rgba8, writeSettings))});
+    writeSettings.supercompression      = nv_ktx::WriteSupercompressionType::ZSTD;
+    writeSettings.supercompression_level = 10;
+    cases.push_back({"RGBA8 Zstd", writeKTX2(rgba8, writeSettings)});
+  }
+  {
+    const uint32_t         basisSize = std::min(size, basisMaxSize);
+    nv_ktx::KTXImage       bgra8     = fixtures::makeTextureArray(basisSize, layers, VK_FORMAT_B8G8R8A8_UNORM);
+    nv_ktx::WriteSettings  writeSettings;
+    writeSettings.encode_rgba8_to_format = nv_ktx::EncodeRGBA8ToFormat::UASTC;
+    writeSettings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+    cases.push_back({"UASTC to BC7", writeKTX2(bgra8, writeSettings)});
+  }
+
+  const std::vector<uint32_t> threads     = parseList(threadsList);
+  const uint64_t              budgetBytes = uint64_t(budgetMB) << 20;
+  std::vector<Result>         results;
+  bool                        allOk = true;
+  for(const Case& c : cases)
+  {
+    if(c.file.empty())
+    {
+      LOGW("Could not create the %s test texture.\n", c.format.c_str());
+      allOk = false;
+      continue;
+    }
+    for(uint32_t numThreads : threads)
+    {
+      Result result = runCase(c, numThreads, iterations, budgetBytes);
+      LOGI("%-14s threads %-3u %10.3f ms %9.1f MPixels/s  peak temporary memory %8.1f MiB%s\n", result.format.c_str(),
+           result.threads, result.medianMs, result.megapixels / (result.medianMs * 1e-3),
+           double(result.peakTempBytes) / double(1 << 20), result.ok ? "" : " (FAILED)");
+      allOk = allOk && result.ok;
+      results.push_back(std::move(result));
+    }
+  }
+
+  std::string json = "{\n  \"benchmark\": \"ktx_parallel_read\",\n  \"size\": " + std::to_string(size) + ",\n  \"layers\": "
+                     + std::to_string(layers) + ",\n  \"budget_bytes\": " + std::to_string(budgetBytes)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"format\": \"%s\", \"threads\": %u, \"file_bytes\": %zu, \"median_ms\": %.4f, \"min_ms\": %.4f, "
+             "\"mpixels_per_s\": %.3f, \"peak_temp_bytes\": %lld, \"ok\": %s}%s\n",
+             r.format.c_str(), r.threads, r.fileBytes, r.medianMs, r.minMs, r.megapixels / (r.medianMs * 1e-3),
+             static_cast<long long>(r.peakTempBytes), r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
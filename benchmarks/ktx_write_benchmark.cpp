@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures KTX2 write throughput against the number of threads:
+* RGBA8 texture arrays with Zstandard supercompression, for each requested
+  compression level
+* ETC1S and UASTC encoding through Basis Universal
+* nv_ktx::writeKTX2Files() converting a batch of images to files
+
+Test textures are synthesized at startup. Every single-image write is
+compared against the num_threads = 1 output, which must be byte-identical.
+For each case and thread count, this reports the median and minimum write
+time and throughput in MPixels/s over all subresources as JSON.
+
+Example:
+  nvpro2_ktx_write_benchmark --size 2048 --layers 8 --levels 3,10,19 --threads 1,2,4,8,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+double imageMegapixels(const nv_ktx::KTXImage& image)
+{
+  double megapixels = 0.0;
+  for(uint32_t mip = 0; mip < image.num_mips; mip++)
+  {
+    megapixels += double(std::max(1u, image.mip_0_width >> mip)) * double(std::max(1u, image.mip_0_height >> mip))
+                  * double(std::max(1u, image.num_layers_possibly_0)) * double(image.num_faces) * 1e-6;
+  }
+  return megapixels;
+}
+
+bool writeKTX2(nv_ktx::KTXImage& image, const nv_ktx::WriteSettings& writeSettings, std::string& out)
+{
+  std::ostringstream          stream;
+  const nv_ktx::ErrorWithText error = image.writeKTX2Stream(stream, writeSettings);
+  if(error.has_value())
+  {
+    LOGW("Writing a KTX2 file failed: %s\n", error->c_str());
+    return false;
+  }
+  out = stream.str();
+  return true;
+}
+
+struct Result
+{
+  std::string name;
+  int         level      = 0;
+  uint32_t    threads    = 0;
+  size_t      fileBytes  = 0;
+  double      megapixels = 0.0;
+  double      medianMs   = 0.0;
+  double      minMs      = 0.0;
+  bool        identical  = true;  // Same bytes as with num_threads = 1
+  bool        ok         = true;
+};
+
+void finishTimes(std::vector<double>& times, Result& result)
+{
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+}
+
+// Writes `image` `iterations` times with `writeSettings` and compares the
+// output against `reference`, which is filled on the first call.
+Result runStreamCase(const std::string&           name,
+                     int                          level,
+                     nv_ktx::KTXImage&            image,
+                     const nv_ktx::WriteSettings& writeSettings,
+                     uint32_t                     iterations,
+                     std::string&                 reference)
+{
+  Result result;
+  result.name       = name;
+  result.level      = level;
+  result.threads    = writeSettings.num_threads;
+  result.megapixels = imageMegapixels(image);
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    std::string               out;
+    nvutils::PerformanceTimer timer;
+    result.ok = writeKTX2(image, writeSettings, out) && result.ok;
+    times.push_back(timer.getMilliseconds());
+    if(reference.empty())
+    {
+      reference = out;
+    }
+    result.identical = result.identical && (out == reference);
+    result.fileBytes = out.size();
+  }
+  finishTimes(times, result);
+  return result;
+}
+
+Result runBatchCase(std::vector<nv_ktx::KTXImage>& images,
+                    const std::filesystem::path&   directory,
+                    const nv_ktx::WriteSettings&   writeSettings,
+                    uint32_t                       iterations)
+{
+  std::vector<std::string> filenames;
+  for(size_t i = 0; i < images.size(); i++)
+  {
+    filenames.push_back((directory / ("image_" + std::to_string(i) + ".ktx2")).string());
+  }
+
+  Result result;
+  result.name    = "writeKTX2Files x" + std::to_string(images.size());
+  result.level   = writeSettings.supercompression_level;
+  result.threads = writeSettings.num_threads;
+  for(const nv_ktx::KTXImage& image : images)
+  {
+    result.megapixels += imageMegapixels(image);
+  }
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    nvutils::PerformanceTimer                timer;
+    const std::vector<nv_ktx::ErrorWithText> errors = nv_ktx::writeKTX2Files(images, filenames, writeSettings);
+    times.push_back(timer.getMilliseconds());
+    for(const nv_ktx::ErrorWithText& error : errors)
+    {
+      if(error.has_value())
+      {
+        LOGW("writeKTX2Files failed: %s\n", error->c_str());
+        result.ok = false;
+      }
+    }
+  }
+  finishTimes(times, result);
+
+  result.fileBytes = 0;
+  for(const std::string& filename : filenames)
+  {
+    std::error_code ec;
+    result.fileBytes += size_t(std::filesystem::file_size(filename, ec));
+    std::filesystem::remove(filename, ec);
+  }
+  return result;
+}
+
+std::vector<int> parseList(const std::string& list)
+{
+  std::vector<int>  result;
+  std::stringstream stream(list);
+  std::string       item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(std::stoi(item));
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              size           = 2048;
+  uint32_t              layers         = 4;
+  uint32_t              basisMaxSize   = 512;
+  uint32_t              batchCount     = 16;
+  uint32_t              batchSize      = 512;
+  std::string           levelsList     = "3,10,19";
+  std::string           threadsList    = "1,2,4,8,0";
+  uint32_t              iterations     = 3;
+  std::filesystem::path directory      = std::filesystem::temp_directory_path() / "nvpro2_ktx_write_benchmark";
+  std::filesystem::path outputFilename = "ktx_write_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures nv_ktx KTX2 write throughput against the thread count; writes JSON.");
+  parameterRegistry.add({"size", "width and height of the Zstandard texture arrays' base mip"}, &size, 4u);
+  parameterRegistry.add({"layers", "number of array layers"}, &layers, 1u);
+  parameterRegistry.add({"basismaxsize", "size of the ETC1S and UASTC textures, which are slow to encode"}, &basisMaxSize, 4u);
+  parameterRegistry.add({"batchcount", "number of images written by writeKTX2Files"}, &batchCount, 1u);
+  parameterRegistry.add({"batchsize", "width and height of the writeKTX2Files images"}, &batchSize, 4u);
+  parameterRegistry.add({"levels", "comma-separated Zstandard compression levels"}, &levelsList);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed writes per case"}, &iterations, 1u);
+  parameterRegistry.add({"directory", "temporary directory for the writeKTX2Files output"}, &directory);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const std::vector<int> levels  = parseList(levelsList);
+  const std::vector<int> threads = parseList(threadsList);
+  std::vector<Result>    results;
+  bool                   allOk  = true;
+  auto                   report = [&](Result&& result) {
+    LOGI("%-22s level %-3d threads %-3u %10.3f ms %9.2f MPixels/s %10zu bytes%s%s\n", result.name.c_str(), result.level,
+         result.threads, result.medianMs, result.megapixels / (result.medianMs * 1e-3), result.fileBytes,
+         result.identical ? "" : " (DIFFERENT FROM SERIAL)", result.ok ? "" : " (FAILED)");
+    allOk = allOk && result.ok && result.identical;
+    results.push_back(std::move(result));
+  };
+
+  LOGI("Synthesizing %u x %u x %u layer test textures\n", size, size, layers);
+  {
+    nv_ktx::KTXImage image = fixtures::makeTextureArray(size, layers, VK_FORMAT_R8G8B8A8_UNORM);
+    for(int level : levels)
+    {
+      nv_ktx::WriteSettings writeSettings;
+      writeSettings.supercompression       = nv_ktx::WriteSupercompressionType::ZSTD;
+      writeSettings.supercompression_level = level;
+      std::string reference;
+      // Always run the serial writer first, so that it's the reference.
+      writeSettings.num_threads = 1;
+      runStreamCase("RGBA8 Zstd", level, image, writeSettings, 1, reference);
+      for(int numThreads : threads)
+      {
+        writeSettings.num_threads = uint32_t(numThreads);
+        report(runStreamCase("RGBA8 Zstd", level, image, writeSettings, iterations, reference));
+      }
+    }
+  }
+
+  {
+    const uint32_t   basisSize = std::min(size, basisMaxSize);
+    nv_ktx::KTXImage image     = fixtures::makeTextureArray(basisSize, layers, VK_FORMAT_B8G8R8A8_UNORM);
+    struct BasisCase
+    {
+      const char*                 name;
+      nv_ktx::EncodeRGBA8ToFormat format;
+    };
+    for(const BasisCase& basisCase : {BasisCase{"ETC1S", nv_ktx::EncodeRGBA8ToFormat::ETC1S_RGBA},
+                                      BasisCase{"UASTC", nv_ktx::EncodeRGBA8ToFormat::UASTC}})
+    {
+      nv_ktx::WriteSettings writeSettings;
+      writeSettings.encode_rgba8_to_format = basisCase.format;
+      writeSettings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+      writeSettings.etc1s_encoding_level   = 1;
+      std::string reference;
+      writeSettings.num_threads = 1;
+      runStreamCase(basisCase.name, 0, image, writeSettings, 1, reference);
+      for(int numThreads : threads)
+      {
+        writeSettings.num_threads = uint32_t(numThreads);
+        report(runStreamCase(basisCase.name, 0, image, writeSettings, iterations, reference));
+      }
+    }
+  }
+
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    std::vector<nv_ktx::KTXImage> images;
+    for(uint32_t i = 0; i < batchCount; i++)
+    {
+      images.push_back(fixtures::makeTextureArray(batchSize, 1, VK_FORMAT_R8G8B8A8_UNORM, i));
+    }
+    nv_ktx::WriteSettings writeSettings;
+    writeSettings.supercompression       = nv_ktx::WriteSupercompressionType::ZSTD;
+    writeSettings.supercompression_level = levels.empty() ? 3 : levels.front();
+    for(int numThreads : threads)
+    {
+      writeSettings.num_threads = uint32_t(numThreads);
+      report(runBatchCase(images, directory, writeSettings, iterations));
+    }
+    std::filesystem::remove(directory, ec);
+  }
+
+  std::string json = "{\n  \"benchmark\": \"ktx_write\",\n  \"size\": " + std::to_string(size) + ",\n  \"layers\": "
+                     + std::to_string(layers) + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"case\": \"%s\", \"level\": %d, \"threads\": %u, \"file_bytes\": %zu, \"median_ms\": %.4f, "
+             "\"min_ms\": %.4f, \"mpixels_per_s\": %.3f, \"identical_to_serial\": %s, \"ok\": %s}%s\n",
+             r.name.c_str(), r.level, r.threads, r.fileBytes, r.medianMs, r.minMs, r.megapixels / (r.medianMs * 1e-3),
+             r.identical ? "true" : "false", r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
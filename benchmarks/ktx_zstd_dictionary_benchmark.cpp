@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures Zstandard dictionary supercompression for large sets of small KTX2
+textures.
+
+Synthesizes a corpus of small RGBA8 textures with mips (icon- and
+decal-like shapes on flat backgrounds, plus gradient LUTs), and a separate
+training set in the same style. For no dictionary and each dictionary size,
+this writes the whole corpus with Zstandard supercompression and reports the
+compression ratio, then reads it back and reports decode throughput for
+each thread count, as JSON.
+
+Example:
+  nvpro2_ktx_zstd_dictionary_benchmark --count 5000 --dictsizes 16384,112640 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+struct Random
+{
+  uint32_t state;
+  uint32_t next()
+  {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+  uint32_t range(uint32_t n) { return next() % n; }
+};
+
+// Returns a small texture: either an icon-like shape on a flat background, or
+// a color LUT-like gradient strip.
+nv_ktx::KTXImage makeSmallTexture(Random& rng)
+{
+  static const uint32_t kSizes[] = {16, 32, 32, 64, 64, 128};
+  const uint32_t        size     = kSizes[rng.range(6)];
+  const bool            isLUT    = (rng.range(8) == 0);
+  const uint32_t        width    = isLUT ? 256 : size;
+  const uint32_t        height   = isLUT ? 1 : size;
+
+  std::vector<uint8_t> pixels(size_t(width) * height * 4);
+  if(isLUT)
+  {
+    const uint32_t gamma = 1 + rng.range(3);
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const uint32_t v = (gamma == 1) ? x : (gamma == 2 ? x * x / 255 : x * x * x / 65025);
+      pixels[x * 4 + 0] = uint8_t(v);
+      pixels[x * 4 + 1] = uint8_t((v * 3) / 4);
+      pixels[x * 4 + 2] = uint8_t(255 - v / 2);
+      pixels[x * 4 + 3] = 255;
+    }
+  }
+  else
+  {
+    // A palette shared by all icons, as in a real icon set.
+    static const uint8_t kPalette[][4] = {{0, 0, 0, 0},       {255, 255, 255, 255}, {32, 32, 32, 255},
+                                          {118, 185, 0, 255}, {200, 40, 40, 255},   {40, 90, 200, 255}};
+    const uint8_t*       background    = kPalette[rng.range(2)];
+    const uint8_t*       foreground    = kPalette[2 + rng.range(4)];
+    const float          radius        = float(size) * (0.25f + 0.2f * float(rng.range(100)) / 100.0f);
+    const bool           square        = rng.range(2) == 0;
+    for(uint32_t y = 0; y < height; y++)
+    {
+      for(uint32_t x = 0; x < width; x++)
+      {
+        const float   dx     = float(x) + 0.5f - float(size) * 0.5f;
+        const float   dy     = float(y) + 0.5f - float(size) * 0.5f;
+        const bool    inside = square ? (std::max(std::abs(dx), std::abs(dy)) < radius) : (dx * dx + dy * dy < radius * radius);
+        const uint8_t* color = inside ? foreground : background;
+        memcpy(&pixels[(size_t(y) * width + x) * 4], color, 4);
+      }
+    }
+  }
+
+  nv_ktx::KTXImage image;
+  image.format       = VK_FORMAT_R8G8B8A8_SRGB;
+  image.mip_0_width  = width;
+  image.mip_0_height = height;
+  image.allocate(1, 0, 1);
+  image.subresource(0).assign(pixels.begin(), pixels.end());
+  mip_generation::Settings mipSettings;
+  mipSettings.filter = mip_generation::Filter::eBox;
+  mip_generation::generateMips(image, mipSettings);
+  return image;
+}
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+struct Result
+{
+  uint32_t dictionarySize = 0;  // 0 means no dictionary
+  uint32_t threads        = 0;
+  size_t   rawBytes       = 0;
+  size_t   fileBytes      = 0;
+  double   writeMs        = 0.0;
+  double   readMs         = 0.0;
+  bool     ok             = true;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              count          = 2000;
+  uint32_t              trainingCount  = 500;
+  int                   level          = 10;
+  std::string           dictSizesList  = "16384,65536,112640";
+  std::string           threadsList    = "1,0";
+  uint32_t              iterations     = 3;
+  std::filesystem::path outputFilename = "ktx_zstd_dictionary_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures KTX2 Zstandard dictionary compression ratios and decode speed; writes JSON.");
+  parameterRegistry.add({"count", "number of textures in the corpus"}, &count, 1u);
+  parameterRegistry.add({"trainingcount", "number of separate textures to train dictionaries on"}, &trainingCount, 1u);
+  parameterRegistry.add({"level", "Zstandard supercompression level"}, &level);
+  parameterRegistry.add({"dictsizes", "comma-separated maximum dictionary sizes in bytes"}, &dictSizesList);
+  parameterRegistry.add({"threads", "comma-separated thread counts for reading; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed reads of the whole corpus per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  LOGI("Synthesizing %u textures and %u training textures\n", count, trainingCount);
+  Random                        rng{1};
+  std::vector<nv_ktx::KTXImage> corpus(count);
+  size_t                        rawBytes = 0;
+  for(nv_ktx::KTXImage& image : corpus)
+  {
+    image = makeSmallTexture(rng);
+    for(uint32_t mip = 0; mip < image.num_mips; mip++)
+    {
+      rawBytes += image.subresourceBytes(mip).size();
+    }
+  }
+  Random                        trainingRng{2};
+  std::vector<nv_ktx::KTXImage> trainingSet(trainingCount);
+  for(nv_ktx::KTXImage& image : trainingSet)
+  {
+    image = makeSmallTexture(trainingRng);
+  }
+
+  std::vector<uint32_t> dictionarySizes = parseList(dictSizesList);
+  dictionarySizes.insert(dictionarySizes.begin(), 0);
+  const std::vector<uint32_t> threads = parseList(threadsList);
+
+  std::vector<Result> results;
+  for(uint32_t dictionarySize : dictionarySizes)
+  {
+    // Train and load the dictionary.
+    nv_ktx::ZstdDictionaryCache           dictionaries;
+    std::shared_ptr<nv_ktx::ZstdDictionary> dictionary;
+    if(dictionarySize > 0)
+    {
+      std::vector<char>           dictionaryData;
+      const nv_ktx::ErrorWithText error = nv_ktx::trainZstdDictionary(trainingSet, dictionarySize, dictionaryData);
+      dictionary                        = std::make_shared<nv_ktx::ZstdDictionary>();
+      if(error.has_value() || dictionary->load(dictionaryData).has_value())
+      {
+        LOGE("Training a %u-byte dictionary failed: %s\n", dictionarySize, error.value_or("loading failed").c_str());
+        continue;
+      }
+      dictionaries.add(dictionary);
+    }
+
+    // Write the corpus.
+    nv_ktx::WriteSettings writeSettings;
+    writeSettings.supercompression      = nv_ktx::WriteSupercompressionType::ZSTD;
+    writeSettings.supercompression_level = level;
+    writeSettings.zstd_dictionary       = dictionary.get();
+    writeSettings.num_threads           = 1;
+    std::vector<std::string>  files(count);
+    std::vector<char>         writeOk(count, 1);
+    nvutils::PerformanceTimer writeTimer;
+    nvutils::parallel_batches_pooled<16>(count, [&](uint64_t i, uint32_t) {
+      std::ostringstream stream;
+      writeOk[i] = !corpus[i].writeKTX2Stream(stream, writeSettings).has_value();
+      files[i]   = stream.str();
+    });
+    const double writeMs   = writeTimer.getMilliseconds();
+    size_t       fileBytes = 0;
+    for(const std::string& file : files)
+    {
+      fileBytes += file.size();
+    }
+    if(dictionary)
+    {
+      // Count the dictionary, since it's shipped with the files.
+      fileBytes += dictionary->getData().size();
+    }
+
+    // Read the corpus.
+    for(uint32_t numThreads : threads)
+    {
+      nv_ktx::ReadSettings readSettings;
+      readSettings.zstd_dictionaries = &dictionaries;
+      readSettings.num_threads       = 1;
+      std::vector<char>   readOk(count, 1);
+      std::vector<double> times;
+      for(uint32_t iteration = 0; iteration < iterations; iteration++)
+      {
+        nvutils::PerformanceTimer readTimer;
+        nvutils::parallel_batches_pooled<16>(
+            count,
+            [&](uint64_t i, uint32_t) {
+              nv_ktx::KTXImage image;
+              readOk[i] = !image.readFromMemoryView({reinterpret_cast<const std::byte*>(files[i].data()), files[i].size()}, readSettings)
+                               .has_value();
+            },
+            numThreads);
+        times.push_back(readTimer.getMilliseconds());
+      }
+      std::sort(times.begin(), times.end());
+
+      Result result;
+      result.dictionarySize = dictionarySize;
+      result.threads        = numThreads;
+      result.rawBytes       = rawBytes;
+      result.fileBytes      = fileBytes;
+      result.writeMs        = writeMs;
+      result.readMs         = times[times.size() / 2];
+      result.ok = std::all_of(writeOk.begin(), writeOk.end(), [](char c) { return c != 0; })
+                  && std::all_of(readOk.begin(), readOk.end(), [](char c) { return c != 0; });
+      LOGI("dictionary %6u bytes: ratio %6.3f, read with %u threads in %9.3f ms%s\n", dictionarySize,
+           double(rawBytes) / double(fileBytes), numThreads, result.readMs, result.ok ? "" : " (FAILED)");
+      results.push_back(result);
+    }
+  }
+
+  std::string json = "{\n  \"benchmark\": \"ktx_zstd_dictionary\",\n  \"textures\": " + std::to_string(count)
+                     + ",\n  \"training_textures\": " + std::to_string(trainingCount) + ",\n  \"zstd_level\": "
+                     + std::to_string(level) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"dictionary_bytes\": %u, \"threads\": %u, \"raw_bytes\": %zu, \"file_bytes\": %zu, "
+             "\"compression_ratio\": %.4f, \"write_ms\": %.3f, \"read_ms\": %.3f, \"read_mb_per_s\": %.3f, "
+             "\"files_per_s\": %.1f, \"ok\": %s}%s\n",
+             r.dictionarySize, r.threads, r.rawBytes, r.fileBytes, double(r.rawBytes) / double(r.fileBytes), r.writeMs,
+             r.readMs, double(r.rawBytes) * 1e-6 / (r.readMs * 1e-3), double(count) / (r.readMs * 1e-3),
+             r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
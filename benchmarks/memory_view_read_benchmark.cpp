@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures loading large uncompressed and block-compressed KTX2 and DDS files
+up to the point where their mips are in staging memory, as SceneVk does:
+* readFromFile(), which reads the file through a stream into the image's
+  subresources, followed by a copy of each subresource into staging memory
+* nvutils::FileReadMapping and readFromMemoryView(), whose subresources are
+  views of the mapping, followed by the same copy into staging memory
+
+Test files are synthesized into a temporary directory at startup, and read
+once before timing so that both paths read from the OS file cache. For each
+file, this reports the median and minimum time, the texel throughput, and
+the number and peak size of allocations made through operator new, as JSON.
+"Staging memory" is a preallocated host buffer here.
+
+Example:
+  nvpro2_memory_view_read_benchmark --sizes 4096,8192 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <directx/dxgiformat.h>
+
+#include "nvimageformats/nv_dds.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/file_mapping.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "alloc_stats.hpp"
+#include "fixtures.hpp"
+
+namespace {
+
+// Returns the bytes of a mip of the given size, in RGBA8 (4 bytes per texel)
+// or BC7 (16 bytes per 4x4 block). The readers don't look at the texels, so
+// they're just a pattern.
+std::vector<char> makeMipData(uint32_t width, uint32_t height, bool bc7)
+{
+  const size_t size = bc7 ? size_t((width + 3) / 4) * ((height + 3) / 4) * 16 : size_t(width) * height * 4;
+  std::vector<char> data(size);
+  for(size_t i = 0; i < size; i++)
+  {
+    data[i] = char(i * 2654435761u >> 13);
+  }
+  return data;
+}
+
+bool writeKTX2(const std::filesystem::path& path, uint32_t size, bool bc7)
+{
+  nv_ktx::KTXImage image;
+  image.format       = bc7 ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_R8G8B8A8_UNORM;
+  image.mip_0_width  = size;
+  image.mip_0_height = size;
+  image.allocate(fixtures::getMipCount(size), 0, 1);
+  for(uint32_t mip = 0; mip < image.num_mips; mip++)
+  {
+    image.subresource(mip) = makeMipData(std::max(1u, size >> mip), std::max(1u, size >> mip), bc7);
+  }
+  std::ofstream stream(path, std::ios::binary);
+  return !image.writeKTX2Stream(stream, {}).has_value() && stream.good();
+}
+
+// Copies each span into `staging`, as SceneVk's image upload does; returns
+// false if they don't fit.
+bool copyToStaging(const std::vector<std::span<const char>>& mips, std::vector<char>& staging)
+{
+  size_t offset = 0;
+  for(const std::span<const char>& mip : mips)
+  {
+    if(offset + mip.size() > staging.size())
+    {
+      return false;
+    }
+    memcpy(staging.data() + offset, mip.data(), mip.size());
+    offset += mip.size();
+  }
+  return true;
+}
+
+bool loadKTX2(const std::filesystem::path& path, bool view, std::vector<char>& staging)
+{
+  nv_ktx::KTXImage     image;
+  nvutils::FileReadMapping mapping;
+  if(view)
+  {
+    if(!mapping.open(path)
+       || image.readFromMemoryView({static_cast<const std::byte*>(mapping.data()), mapping.size()}, {}).has_value())
+    {
+      return false;
+    }
+  }
+  else if(image.readFromFile(path.string().c_str(), {}).has_value())
+  {
+    return false;
+  }
+  std::vector<std::span<const char>> mips;
+  for(uint32_t mip = 0; mip < image.num_mips; mip++)
+  {
+    mips.push_back(image.subresourceBytes(mip));
+  }
+  return copyToStaging(mips, staging);
+}
+
+bool loadDDS(const std::filesystem::path& path, bool view, std::vector<char>& staging)
+{
+  nv_dds::Image            image;
+  nvutils::FileReadMapping mapping;
+  if(view)
+  {
+    if(!mapping.open(path)
+       || image.readFromMemoryView({static_cast<const std::byte*>(mapping.data()), mapping.size()}, {}).has_value())
+    {
+      return false;
+    }
+  }
+  else if(image.readFromFile(path.string().c_str(), {}).has_value())
+  {
+    return false;
+  }
+  std::vector<std::span<const char>> mips;
+  for(uint32_t mip = 0; mip < image.getNumMips(); mip++)
+  {
+    mips.push_back(image.subresource(mip).bytes());
+  }
+  return copyToStaging(mips, staging);
+}
+
+struct Result
+{
+  std::string path;    // e.g. "readFromMemoryView"
+  std::string format;  // e.g. "KTX2 BC7"
+  uint32_t    size        = 0;
+  size_t      texelBytes  = 0;
+  double      medianMs    = 0.0;
+  double      minMs       = 0.0;
+  uint64_t    allocations = 0;
+  int64_t     peakBytes   = 0;
+  bool        ok          = true;
+};
+
+Result runCase(const std::string& path, const std::string& format, uint32_t size, size_t texelBytes,
+               const std::function<bool()>& load, uint32_t iterations)
+{
+  Result result;
+  result.path       = path;
+  result.format     = format;
+  result.size       = size;
+  result.texelBytes = texelBytes;
+
+  // The warm-up run reads the file into the OS cache, and measures
+  // allocations.
+  alloc_stats::reset();
+  const int64_t baseline = alloc_stats::g_current.load();
+  result.ok              = load();
+  result.allocations     = alloc_stats::g_count.load();
+  result.peakBytes       = alloc_stats::g_peak.load() - baseline;
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    nvutils::PerformanceTimer timer;
+    result.ok = load() && result.ok;
+    times.push_back(timer.getMilliseconds());
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  std::string           sizesList      = "1024,4096";
+  uint32_t              iterations     = 5;
+  std::filesystem::path directory      = std::filesystem::temp_directory_path() / "nvpro2_memory_view_read_benchmark";
+  std::filesystem::path outputFilename = "memory_view_read_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures KTX2 and DDS stream reads vs. memory view reads into staging memory; writes JSON.");
+  parameterRegistry.add({"sizes", "comma-separated widths (and heights) of square test images"}, &sizesList);
+  parameterRegistry.add({"iterations", "timed loads per case"}, &iterations, 1u);
+  parameterRegistry.add({"directory", "where to write the test files; it's deleted at the end"}, &directory);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  std::vector<Result> results;
+  bool                allOk = true;
+  for(uint32_t size : parseList(sizesList))
+  {
+    for(const bool bc7 : {false, true})
+    {
+      // All mips, as the staging buffer holds them.
+      size_t texelBytes = 0;
+      for(uint32_t mip = 0; mip < fixtures::getMipCount(size); mip++)
+      {
+        texelBytes += makeMipData(std::max(1u, size >> mip), std::max(1u, size >> mip), bc7).size();
+      }
+      std::vector<char> staging(texelBytes);
+
+      const char*                 formatName = bc7 ? "BC7" : "RGBA8";
+      const std::filesystem::path ktx2Path   = directory / ("test_" + std::to_string(size) + formatName + ".ktx2");
+      const std::filesystem::path ddsPath    = directory / ("test_" + std::to_string(size) + formatName + ".dds");
+      const DXGI_FORMAT           ddsFormat  = bc7 ? DXGI_FORMAT_BC7_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+      if(!writeKTX2(ktx2Path, size, bc7)
+         || !fixtures::writeDDS(ddsPath, size, ddsFormat, [&](uint32_t mipSize) { return makeMipData(mipSize, mipSize, bc7); }))
+      {
+        LOGW("Could not write the %u x %u %s test files to %s.\n", size, size, formatName, directory.string().c_str());
+        allOk = false;
+        continue;
+      }
+
+      for(const bool view : {false, true})
+      {
+        const std::string path = view ? "FileReadMapping + readFromMemoryView" : "readFromFile";
+        results.push_back(runCase(path, std::string("KTX2 ") + formatName, size, texelBytes,
+                                  [&]() { return loadKTX2(ktx2Path, view, staging); }, iterations));
+        results.push_back(runCase(path, std::string("DDS ") + formatName, size, texelBytes,
+                                  [&]() { return loadDDS(ddsPath, view, staging); }, iterations));
+      }
+      std::filesystem::remove(ktx2Path, error);
+      std::filesystem::remove(ddsPath, error);
+    }
+  }
+  std::filesystem::remove(directory, error);
+
+  for(const Result& r : results)
+  {
+    LOGI("%-38s %-10s %5u %10.3f ms %8.2f GB/s %6llu allocations, peak %8.1f MiB%s\n", r.path.c_str(), r.format.c_str(),
+         r.size, r.medianMs, double(r.texelBytes) * 1e-9 / (r.medianMs * 1e-3),
+         static_cast<unsigned long long>(r.allocations), double(r.peakBytes) / double(1 << 20), r.ok ? "" : " (FAILED)");
+    allOk = allOk && r.ok;
+  }
+
+  std::string json = "{\n  \"benchmark\": \"memory_view_read\",\n  \"iterations\": " + std::to_string(iterations)
+                     + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"path\": \"%s\", \"format\": \"%s\", \"width\": %u, \"height\": %u, \"texel_bytes\": %zu, "
+             "\"median_ms\": %.4f, \"min_ms\": %.4f, \"gb_per_s\": %.3f, \"allocations\": %llu, \"peak_alloc_bytes\": %lld, "
+             "\"ok\": %s}%s\n",
+             r.path.c_str(), r.format.c_str(), r.size, r.size, r.texelBytes, r.medianMs, r.minMs,
+             double(r.texelBytes) * 1e-9 / (r.medianMs * 1e-3), static_cast<unsigned long long>(r.allocations),
+             static_cast<long long>(r.peakBytes), r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
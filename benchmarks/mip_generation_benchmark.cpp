@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures mip_generation::generateMips() throughput for each format and
+filter, against the number of threads. Each case generates the full mip
+chain of a random `size` x `size` KTXImage; throughput is in MPixels/s of
+mip 0.
+
+For each format, filter, and thread count, this reports the median and
+minimum time and throughput as JSON.
+
+Example:
+  nvpro2_mip_generation_benchmark --size 4096 --threads 1,2,4,8,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+struct Result
+{
+  std::string format;
+  std::string filter;
+  uint32_t    threads  = 0;
+  double      medianMs = 0.0;
+  double      minMs    = 0.0;
+  bool        ok       = true;
+};
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+// Random bytes are valid texels in every tested format except half and float
+// ones, where they'd include NaNs and infinities; those get values in [0, 1).
+std::vector<char> randomTexels(VkFormat format, size_t bytes)
+{
+  std::vector<char> result(bytes);
+  uint32_t          rng = 12345;
+  if(format == VK_FORMAT_R32G32B32A32_SFLOAT)
+  {
+    for(size_t i = 0; i + sizeof(float) <= bytes; i += sizeof(float))
+    {
+      rng               = rng * 1664525u + 1013904223u;
+      const float value = float(rng >> 8) / float(1 << 24);
+      memcpy(result.data() + i, &value, sizeof(float));
+    }
+  }
+  else if(format == VK_FORMAT_R16G16B16A16_SFLOAT)
+  {
+    for(size_t i = 0; i + sizeof(uint16_t) <= bytes; i += sizeof(uint16_t))
+    {
+      rng                  = rng * 1664525u + 1013904223u;
+      const uint16_t value = uint16_t(0x3800 + ((rng >> 16) & 0x7ff));  // [0.5, 1)
+      memcpy(result.data() + i, &value, sizeof(value));
+    }
+  }
+  else
+  {
+    for(char& c : result)
+    {
+      rng = rng * 1664525u + 1013904223u;
+      c   = char(rng >> 24);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              size           = 2048;
+  std::string           threadsList    = "1,2,4,8,0";
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "mip_generation_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser parameterParser("Measures mip_generation throughput per format, filter and thread count; writes JSON.");
+  parameterRegistry.add({"size", "width and height of mip 0"}, &size, 1u);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed mip chains per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+  size = std::max(1u, size);
+
+  const std::vector<uint32_t> threads    = parseList(threadsList);
+  const double                megapixels = double(size) * double(size) * 1e-6;
+  std::vector<Result>         results;
+  bool                        allOk = true;
+  for(const auto& [formatName, format, texelBytes] :
+      {std::tuple{"RGBA8 UNORM", VK_FORMAT_R8G8B8A8_UNORM, 4u}, std::tuple{"RGBA8 SRGB", VK_FORMAT_R8G8B8A8_SRGB, 4u},
+       std::tuple{"R8 UNORM", VK_FORMAT_R8_UNORM, 1u}, std::tuple{"RGBA16 UNORM", VK_FORMAT_R16G16B16A16_UNORM, 8u},
+       std::tuple{"RGBA16 SFLOAT", VK_FORMAT_R16G16B16A16_SFLOAT, 8u},
+       std::tuple{"RGBA32 SFLOAT", VK_FORMAT_R32G32B32A32_SFLOAT, 16u}})
+  {
+    nv_ktx::KTXImage original;
+    original.format       = format;
+    original.mip_0_width  = size;
+    original.mip_0_height = size;
+    if(original.allocate(1, 0, 1).has_value())
+    {
+      LOGW("Allocating a %u x %u %s image failed; skipping it.\n", size, size, formatName);
+      allOk = false;
+      continue;
+    }
+    original.subresource(0, 0, 0) = randomTexels(format, size_t(size) * size * texelBytes);
+
+    for(const auto& [filterName, filter] : {std::tuple{"box", mip_generation::Filter::eBox},
+                                            std::tuple{"kaiser", mip_generation::Filter::eKaiser},
+                                            std::tuple{"lanczos", mip_generation::Filter::eLanczos}})
+    {
+      for(uint32_t numThreads : threads)
+      {
+        Result result;
+        result.format  = formatName;
+        result.filter  = filterName;
+        result.threads = numThreads;
+        mip_generation::Settings settings;
+        settings.filter     = filter;
+        settings.numThreads = numThreads;
+        std::vector<double> times;
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+          nv_ktx::KTXImage image = original;  // Not timed
+          nvutils::PerformanceTimer timer;
+          result.ok = !mip_generation::generateMips(image, settings).has_value() && result.ok;
+          times.push_back(timer.getMilliseconds());
+        }
+        std::sort(times.begin(), times.end());
+        result.minMs    = times.front();
+        result.medianMs = times[times.size() / 2];
+        LOGI("%-13s %-7s threads %-3u %10.3f ms %10.1f MPixels/s%s\n", result.format.c_str(), result.filter.c_str(),
+             result.threads, result.medianMs, megapixels / (result.medianMs * 1e-3), result.ok ? "" : " (FAILED)");
+        allOk = allOk && result.ok;
+        results.push_back(std::move(result));
+      }
+    }
+  }
+
+  std::string json = "{\n  \"benchmark\": \"mip_generation\",\n  \"size\": " + std::to_string(size)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"format\": \"%s\", \"filter\": \"%s\", \"threads\": %u, \"median_ms\": %.4f, \"min_ms\": %.4f, "
+             "\"mpixels_per_s\": %.3f, \"ok\": %s}%s\n",
+             r.format.c_str(), r.filter.c_str(), r.threads, r.medianMs, r.minMs, megapixels / (r.medianMs * 1e-3),
+             r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the time until every texture of a large texture set is usable, for
+the ways nv_ktx and nv_dds can load mips:
+* "all mips": readFromFile() reads every mip of each file
+* "mip tail first": nv_ktx::KTXLevelReader and nv_dds::LevelReader read the
+  mips up to --previewsize of every file first, which makes each texture
+  usable at low resolution; then they read the remaining mips
+* "skip top mips": ReadSettings::first_mip / firstMip skip the --skipmips
+  largest mips without reading them, as on low-memory machines
+
+The set is --totalmb of KTX2 files with Zstandard supercompression and of
+BC7 DDS files, synthesized into a temporary directory; files are loaded in
+parallel on nvutils' thread pool. The files were just written, so reads
+come from the OS file cache, and this measures the CPU side of loading.
+For each strategy, this reports the median time until the first usable
+version of every texture is loaded, the time until all its mips are
+loaded, and the bytes held by the textures at each of those points, as
+JSON.
+
+Example:
+  nvpro2_mip_streaming_benchmark --totalmb 4096 --size 4096 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <directx/dxgiformat.h>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_dds.h"
+#include "nvimageformats/nv_ktx.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+// Returns an RGBA8 texture with mips; `seed` makes each one a little
+// different, so that files don't compress identically.
+nv_ktx::KTXImage makeKTXImage(uint32_t size, uint32_t seed)
+{
+  nv_ktx::KTXImage image;
+  image.format       = VK_FORMAT_R8G8B8A8_UNORM;
+  image.mip_0_width  = size;
+  image.mip_0_height = size;
+  image.allocate(1, 0, 1);
+  std::vector<char>& pixels = image.subresource(0);
+  pixels.resize(size_t(size) * size * 4);
+  uint32_t rng = 12345 + seed;
+  for(uint32_t y = 0; y < size; y++)
+  {
+    for(uint32_t x = 0; x < size; x++)
+    {
+      rng             = rng * 1664525u + 1013904223u;
+      const int noise = int(rng >> 28) - 8;
+      char*     texel = &pixels[(size_t(y) * size + x) * 4];
+      texel[0]        = char(std::clamp(int((x + seed) * 255 / size) % 256 + noise, 0, 255));
+      texel[1]        = char(std::clamp(int(y * 255 / size) + noise, 0, 255));
+      texel[2]        = char(std::clamp(int(((x / 32 + y / 32) % 2) * 64 + 96) + noise, 0, 255));
+      texel[3]        = char(255);
+    }
+  }
+  mip_generation::Settings mipSettings;
+  mipSettings.filter = mip_generation::Filter::eBox;
+  mip_generation::generateMips(image, mipSettings);
+  return image;
+}
+
+// The bytes of a BC7 mip of `size` x `size`. The reader doesn't look at the
+// blocks, so they're just a pattern.
+std::vector<char> makeBC7Mip(uint32_t size, uint32_t seed)
+{
+  std::vector<char> blocks(size_t((size + 3) / 4) * ((size + 3) / 4) * 16);
+  for(size_t i = 0; i < blocks.size(); i++)
+  {
+    blocks[i] = char((i + seed) * 2654435761u >> 13);
+  }
+  return blocks;
+}
+
+// The number of mips of a texture of size `size` whose width is at most
+// `previewSize`: the mip tail a streamer would load first.
+uint32_t getTailMipCount(uint32_t size, uint32_t previewSize)
+{
+  uint32_t firstTailMip = 0;
+  while((size >> firstTailMip) > previewSize)
+  {
+    firstTailMip++;
+  }
+  return fixtures::getMipCount(size) - firstTailMip;
+}
+
+struct Timings
+{
+  double firstUsableMs  = 0.0;  // Until every texture has a usable version
+  double allMipsMs      = 0.0;  // Until every texture has all its mips
+  size_t firstUsableBytes = 0;  // Texel bytes loaded at firstUsableMs
+  size_t allMipsBytes     = 0;  // Texel bytes loaded at allMipsMs
+  bool   ok               = true;
+};
+
+size_t getKTXBytes(const nv_ktx::KTXImage& image)
+{
+  size_t bytes = 0;
+  for(uint32_t mip = 0; mip < image.num_mips; mip++)
+  {
+    bytes += image.subresourceBytes(mip).size();
+  }
+  return bytes;
+}
+
+size_t getDDSBytes(const nv_dds::Image& image)
+{
+  size_t bytes = 0;
+  for(uint32_t mip = 0; mip < image.getNumMips(); mip++)
+  {
+    bytes += image.subresource(mip).bytes().size();
+  }
+  return bytes;
+}
+
+// Loads every file with readFromFile(); `firstMip` skips mips.
+Timings loadAll(const std::vector<std::string>& files, bool ktx, uint32_t firstMip)
+{
+  std::vector<size_t> bytes(files.size(), 0);
+  std::vector<char>   ok(files.size(), 0);
+
+  nvutils::PerformanceTimer timer;
+  nvutils::parallel_batches_pooled<1>(files.size(), [&](uint64_t i, uint32_t) {
+    if(ktx)
+    {
+      nv_ktx::KTXImage     image;
+      nv_ktx::ReadSettings readSettings;
+      readSettings.num_threads = 1;
+      readSettings.first_mip   = firstMip;
+      ok[i]    = !image.readFromFile(files[i].c_str(), readSettings).has_value();
+      bytes[i] = getKTXBytes(image);
+    }
+    else
+    {
+      nv_dds::Image        image;
+      nv_dds::ReadSettings readSettings;
+      readSettings.firstMip = firstMip;
+      ok[i]    = !image.readFromFile(files[i].c_str(), readSettings).has_value();
+      bytes[i] = getDDSBytes(image);
+    }
+  });
+
+  Timings timings;
+  timings.firstUsableMs = timings.allMipsMs = timer.getMilliseconds();
+  for(size_t i = 0; i < files.size(); i++)
+  {
+    timings.firstUsableBytes += bytes[i];
+    timings.ok = timings.ok && ok[i];
+  }
+  timings.allMipsBytes = timings.firstUsableBytes;
+  return timings;
+}
+
+// Opens every file with a level reader and reads its mip tail, then reads
+// the rest of its mips.
+Timings loadTailFirst(const std::vector<std::string>& files, bool ktx, uint32_t previewSize)
+{
+  std::vector<nv_ktx::KTXLevelReader> ktxReaders(ktx ? files.size() : 0);
+  std::vector<nv_dds::LevelReader>    ddsReaders(ktx ? 0 : files.size());
+  std::vector<char>                   ok(files.size(), 0);
+  const auto                          getMips = [&](size_t i) {
+    return ktx ? ktxReaders[i].image.num_mips : ddsReaders[i].image.getNumMips();
+  };
+  const auto getBytes = [&]() {
+    size_t bytes = 0;
+    for(size_t i = 0; i < files.size(); i++)
+    {
+      bytes += ktx ? getKTXBytes(ktxReaders[i].image) : getDDSBytes(ddsReaders[i].image);
+    }
+    return bytes;
+  };
+
+  Timings                   timings;
+  nvutils::PerformanceTimer timer;
+  nvutils::parallel_batches_pooled<1>(files.size(), [&](uint64_t i, uint32_t) {
+    if(ktx)
+    {
+      nv_ktx::ReadSettings readSettings;
+      readSettings.num_threads = 1;
+      ok[i]                    = !ktxReaders[i].openFile(files[i].c_str(), readSettings).has_value();
+    }
+    else
+    {
+      ok[i] = !ddsReaders[i].openFile(files[i].c_str(), {}).has_value();
+    }
+    if(ok[i])
+    {
+      const uint32_t mips      = getMips(i);
+      const uint32_t tailMips  = getTailMipCount(ktx ? ktxReaders[i].image.mip_0_width : ddsReaders[i].image.mip0Width, previewSize);
+      const uint32_t firstTail = mips - std::min(mips, tailMips);
+      ok[i] = !(ktx ? ktxReaders[i].readMips(firstTail, mips - firstTail) : ddsReaders[i].readMips(firstTail, mips - firstTail))
+                   .has_value();
+    }
+  });
+  timings.firstUsableMs    = timer.getMilliseconds();
+  timings.firstUsableBytes = getBytes();
+
+  timer.reset();
+  nvutils::parallel_batches_pooled<1>(files.size(), [&](uint64_t i, uint32_t) {
+    if(!ok[i])
+    {
+      return;
+    }
+    // Larger mips follow, smallest first, as a streamer would request them.
+    for(uint32_t mip = getMips(i); mip-- > 0;)
+    {
+      const bool isRead = ktx ? ktxReaders[i].isMipRead(mip) : ddsReaders[i].isMipRead(mip);
+      if(!isRead)
+      {
+        ok[i] = !(ktx ? ktxReaders[i].readMips(mip) : ddsReaders[i].readMips(mip)).has_value();
+      }
+    }
+  });
+  timings.allMipsMs    = timings.firstUsableMs + timer.getMilliseconds();
+  timings.allMipsBytes = getBytes();
+  timings.ok           = std::all_of(ok.begin(), ok.end(), [](char c) { return c != 0; });
+  return timings;
+}
+
+struct Result
+{
+  std::string format;    // "KTX2 RGBA8 Zstd" or "DDS BC7"
+  std::string strategy;  // e.g. "mip tail first"
+  size_t      fileBytes = 0;
+  Timings     median;
+};
+
+// Runs `load` `iterations` times; returns the median of each time.
+Timings runCase(const std::function<Timings()>& load, uint32_t iterations)
+{
+  std::vector<Timings> runs;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    runs.push_back(load());
+  }
+  Timings result = runs.front();
+  std::sort(runs.begin(), runs.end(), [](const Timings& a, const Timings& b) { return a.firstUsableMs < b.firstUsableMs; });
+  result.firstUsableMs = runs[runs.size() / 2].firstUsableMs;
+  std::sort(runs.begin(), runs.end(), [](const Timings& a, const Timings& b) { return a.allMipsMs < b.allMipsMs; });
+  result.allMipsMs = runs[runs.size() / 2].allMipsMs;
+  for(const Timings& run : runs)
+  {
+    result.ok = result.ok && run.ok;
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              totalMB        = 1024;
+  uint32_t              size           = 2048;
+  uint32_t              previewSize    = 128;
+  uint32_t              skipMips       = 2;
+  uint32_t              iterations     = 3;
+  std::filesystem::path directory      = std::filesystem::temp_directory_path() / "nvpro2_mip_streaming_benchmark";
+  std::filesystem::path outputFilename = "mip_streaming_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures time to first usable texture for KTX2 and DDS texture sets; writes JSON.");
+  parameterRegistry.add({"totalmb", "size of each texture set on disk in MiB"}, &totalMB, 1u);
+  parameterRegistry.add({"size", "width and height of each texture"}, &size, 4u);
+  parameterRegistry.add({"previewsize", "largest mip of the tail that's loaded first"}, &previewSize, 1u);
+  parameterRegistry.add({"skipmips", "mips to skip in the \"skip top mips\" strategy"}, &skipMips);
+  parameterRegistry.add({"iterations", "timed loads per strategy"}, &iterations, 1u);
+  parameterRegistry.add({"directory", "where to write the test files; it's deleted at the end"}, &directory);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  std::vector<Result> results;
+  bool                allOk = true;
+  for(const bool ktx : {true, false})
+  {
+    const std::string format = ktx ? "KTX2 RGBA8 Zstd" : "DDS BC7";
+
+    // Write files until the set reaches totalMB.
+    LOGI("Writing %u MiB of %u x %u %s files to %s\n", totalMB, size, size, format.c_str(), directory.string().c_str());
+    std::vector<std::string> files;
+    size_t                   fileBytes = 0;
+    nv_ktx::KTXImage         ktxImage  = ktx ? makeKTXImage(size, 0) : nv_ktx::KTXImage{};
+    while(fileBytes < (size_t(totalMB) << 20))
+    {
+      const std::filesystem::path path = directory / (std::to_string(files.size()) + (ktx ? ".ktx2" : ".dds"));
+      bool                        written = false;
+      if(ktx)
+      {
+        // Use a few different images, which compress differently.
+        if(files.size() % 16 == 15)
+        {
+          ktxImage = makeKTXImage(size, uint32_t(files.size()));
+        }
+        nv_ktx::WriteSettings writeSettings;
+        writeSettings.supercompression      = nv_ktx::WriteSupercompressionType::ZSTD;
+        writeSettings.supercompression_level = 3;
+        written = !ktxImage.writeKTX2File(path.string().c_str(), writeSettings).has_value();
+      }
+      else
+      {
+        const uint32_t seed = uint32_t(files.size());
+        written             = fixtures::writeDDS(path, size, DXGI_FORMAT_BC7_UNORM,
+                                                 [&](uint32_t mipSize) { return makeBC7Mip(mipSize, seed); });
+      }
+      if(!written)
+      {
+        LOGW("Could not write %s.\n", path.string().c_str());
+        allOk = false;
+        break;
+      }
+      files.push_back(path.string());
+      fileBytes += std::filesystem::file_size(path, error);
+    }
+    if(files.empty())
+    {
+      continue;
+    }
+
+    const std::pair<std::string, std::function<Timings()>> strategies[] = {
+        {"all mips", [&]() { return loadAll(files, ktx, 0); }},
+        {"mip tail first", [&]() { return loadTailFirst(files, ktx, previewSize); }},
+        {"skip top mips", [&]() { return loadAll(files, ktx, skipMips); }},
+    };
+    for(const auto& [strategy, load] : strategies)
+    {
+      Result result;
+      result.format    = format;
+      result.strategy  = strategy;
+      result.fileBytes = fileBytes;
+      result.median    = runCase(load, iterations);
+      LOGI("%-16s %-15s %5zu files: first usable %10.3f ms (%8.1f MiB), all mips %10.3f ms (%8.1f MiB)%s\n",
+           format.c_str(), strategy.c_str(), files.size(), result.median.firstUsableMs,
+           double(result.median.firstUsableBytes) / double(1 << 20), result.median.allMipsMs,
+           double(result.median.allMipsBytes) / double(1 << 20), result.median.ok ? "" : " (FAILED)");
+      allOk = allOk && result.median.ok;
+      results.push_back(result);
+    }
+
+    for(const std::string& file : files)
+    {
+      std::filesystem::remove(file, error);
+    }
+  }
+  std::filesystem::remove(directory, error);
+
+  std::string json = "{\n  \"benchmark\": \"mip_streaming\",\n  \"size\": " + std::to_string(size) + ",\n  \"preview_size\": "
+                     + std::to_string(previewSize) + ",\n  \"skip_mips\": " + std::to_string(skipMips)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"format\": \"%s\", \"strategy\": \"%s\", \"file_bytes\": %zu, \"first_usable_ms\": %.3f, "
+             "\"first_usable_bytes\": %zu, \"all_mips_ms\": %.3f, \"all_mips_bytes\": %zu, \"ok\": %s}%s\n",
+             r.format.c_str(), r.strategy.c_str(), r.fileBytes, r.median.firstUsableMs, r.median.firstUsableBytes,
+             r.median.allMipsMs, r.median.allMipsBytes, r.median.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU side of nvvk::StagingUploader's parallel appends
+(beginParallelAppend / appendBufferParallel / endParallelAppend) without a
+device: host memory stands in for the mapped staging buffer.
+
+`--total` MiB are uploaded in chunks of `--chunk` bytes to `--buffers`
+destination buffers, on 1, 2, 4, ... up to `--threads` threads. Each thread
+takes chunks from a shared counter, reserves staging space with
+nvutils::AtomicLinearAllocator, copies the chunk, and records the copy in
+its own list; the lists are then merged, sorted by destination and
+coalesced, as in endParallelAppend.
+
+For each thread count, this reports the median and minimum time of the
+copies and of the merge, and the copy throughput in GiB/s, as JSON. After
+each run, the staging memory is checked against the source data.
+
+Example:
+  nvpro2_parallel_staging_benchmark --total 1024 --chunk 65536 --threads 32 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nvutils/atomic_linear_allocator.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+// Mirrors StagingUploader::ParallelCopy
+struct Copy
+{
+  uint32_t dstBuffer = 0;
+  uint64_t srcOffset = 0;
+  uint64_t dstOffset = 0;
+  uint64_t size      = 0;
+};
+
+struct alignas(64) ThreadCopies
+{
+  std::vector<Copy> copies;
+};
+
+struct Result
+{
+  uint32_t threads       = 0;
+  double   copyMedianMs  = 0.0;
+  double   copyMinMs     = 0.0;
+  double   mergeMedianMs = 0.0;
+  double   gibPerSecond  = 0.0;  // Of the median copy time
+  uint64_t regions       = 0;    // After coalescing
+  bool     ok            = true;
+};
+
+// Sorts the copies by destination and coalesces contiguous ones; returns
+// the number of regions left.
+uint64_t mergeCopies(std::vector<ThreadCopies>& threads, std::vector<Copy>& merged)
+{
+  merged.clear();
+  for(ThreadCopies& thread : threads)
+  {
+    merged.insert(merged.end(), thread.copies.begin(), thread.copies.end());
+    thread.copies.clear();
+  }
+  std::sort(merged.begin(), merged.end(), [](const Copy& a, const Copy& b) {
+    return a.dstBuffer != b.dstBuffer ? a.dstBuffer < b.dstBuffer : a.dstOffset < b.dstOffset;
+  });
+
+  uint64_t regions = 0;
+  Copy     previous{~0u};
+  for(const Copy& copy : merged)
+  {
+    if(copy.dstBuffer == previous.dstBuffer && previous.srcOffset + previous.size == copy.srcOffset
+       && previous.dstOffset + previous.size == copy.dstOffset)
+    {
+      previous.size += copy.size;
+    }
+    else
+    {
+      regions++;
+      previous = copy;
+    }
+  }
+  return regions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              totalMiB       = 512;
+  uint32_t              chunk          = 65536;
+  uint32_t              buffers        = 64;
+  uint32_t              maxThreads     = 32;
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "parallel_staging_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures parallel copies into staging memory; writes JSON.");
+  parameterRegistry.add({"total", "MiB uploaded per run"}, &totalMiB, 1u);
+  parameterRegistry.add({"chunk", "bytes per appendBufferParallel call"}, &chunk, 16u);
+  parameterRegistry.add({"buffers", "number of destination buffers"}, &buffers, 1u);
+  parameterRegistry.add({"threads", "highest thread count; powers of two up to it are measured"}, &maxThreads, 1u);
+  parameterRegistry.add({"iterations", "timed runs per thread count"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const uint64_t totalSize  = uint64_t(totalMiB) << 20;
+  const uint64_t chunkCount = totalSize / chunk;
+
+  std::vector<char> source(totalSize);
+  for(uint64_t i = 0; i < totalSize; i++)
+  {
+    source[i] = char(i * 2654435761u >> 24);
+  }
+  // Stands in for the mapped staging buffer; touched once so that page
+  // faults aren't measured
+  std::vector<char> staging(totalSize, 0);
+
+  std::vector<Result> results;
+  for(uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+  {
+    Result result;
+    result.threads = numThreads;
+
+    nvutils::AtomicLinearAllocator allocator(totalSize, 16);
+    std::vector<ThreadCopies>      threadCopies(numThreads);
+    std::vector<Copy>              merged;
+    std::vector<double>            copyTimes;
+    std::vector<double>            mergeTimes;
+    for(uint32_t iteration = 0; iteration < iterations; iteration++)
+    {
+      allocator.reset();
+      std::atomic<uint64_t> nextChunk{0};
+      std::atomic<bool>     ok{true};
+
+      auto worker = [&](uint32_t threadIndex) {
+        for(uint64_t i = nextChunk++; i < chunkCount; i = nextChunk++)
+        {
+          const uint64_t offset = allocator.reserve(chunk);
+          if(offset == nvutils::AtomicLinearAllocator::INVALID_OFFSET)
+          {
+            ok = false;
+            return;
+          }
+          memcpy(staging.data() + offset, source.data() + i * chunk, chunk);
+          // Chunks are spread over the buffers in order, as when uploading
+          // consecutive ranges of a few large arrays
+          const uint64_t chunksPerBuffer = (chunkCount + buffers - 1) / buffers;
+          threadCopies[threadIndex].copies.push_back(
+              {uint32_t(i / chunksPerBuffer), offset, (i % chunksPerBuffer) * chunk, chunk});
+        }
+      };
+
+      nvutils::PerformanceTimer copyTimer;
+      if(numThreads == 1)
+      {
+        worker(0);
+      }
+      else
+      {
+        std::vector<std::thread> threads;
+        for(uint32_t t = 0; t < numThreads; t++)
+        {
+          threads.emplace_back(worker, t);
+        }
+        for(std::thread& thread : threads)
+        {
+          thread.join();
+        }
+      }
+      copyTimes.push_back(copyTimer.getMilliseconds());
+
+      nvutils::PerformanceTimer mergeTimer;
+      result.regions = mergeCopies(threadCopies, merged);
+      mergeTimes.push_back(mergeTimer.getMilliseconds());
+
+      // Every chunk must be in staging memory where its copy says it is
+      const uint64_t chunksPerBuffer = (chunkCount + buffers - 1) / buffers;
+      for(const Copy& copy : merged)
+      {
+        const uint64_t i = uint64_t(copy.dstBuffer) * chunksPerBuffer + copy.dstOffset / chunk;
+        if(memcmp(staging.data() + copy.srcOffset, source.data() + i * chunk, chunk) != 0)
+        {
+          ok = false;
+          break;
+        }
+      }
+      result.ok = ok && merged.size() == chunkCount && result.ok;
+    }
+
+    std::sort(copyTimes.begin(), copyTimes.end());
+    std::sort(mergeTimes.begin(), mergeTimes.end());
+    result.copyMinMs     = copyTimes.front();
+    result.copyMedianMs  = copyTimes[copyTimes.size() / 2];
+    result.mergeMedianMs = mergeTimes[mergeTimes.size() / 2];
+    result.gibPerSecond  = double(chunkCount * chunk) / (1024.0 * 1024.0 * 1024.0) / (result.copyMedianMs / 1000.0);
+    results.push_back(result);
+  }
+
+  LOGI("%u hardware threads\n", std::thread::hardware_concurrency());
+  std::string json = "{\n  \"benchmark\": \"parallel_staging\",\n  \"total_mib\": " + std::to_string(totalMiB)
+                     + ",\n  \"chunk\": " + std::to_string(chunk) + ",\n  \"buffers\": " + std::to_string(buffers)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"hardware_threads\": "
+                     + std::to_string(std::thread::hardware_concurrency()) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%3u threads  copy %10.3f ms  %7.2f GiB/s  merge %8.3f ms  %8llu regions%s\n", r.threads, r.copyMedianMs,
+         r.gibPerSecond, r.mergeMedianMs, static_cast<unsigned long long>(r.regions), r.ok ? "" : " (FAILED)");
+
+    char numbers[256];
+    snprintf(numbers, sizeof(numbers),
+             "\"threads\": %u, \"copy_median_ms\": %.4f, \"copy_min_ms\": %.4f, \"merge_median_ms\": %.4f, "
+             "\"gib_per_second\": %.3f, \"regions\": %llu, \"ok\": %s",
+             r.threads, r.copyMedianMs, r.copyMinMs, r.mergeMedianMs, r.gibPerSecond,
+             static_cast<unsigned long long>(r.regions), r.ok ? "true" : "false");
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
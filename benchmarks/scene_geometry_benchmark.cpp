@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures how long nvvkgltf::SceneVk::create() takes to create and upload the
+vertex and index data of a scene with many small primitives, with a buffer
+per attribute per primitive and with geometry arenas
+(SceneVk::setGeometryArenaSize()). Unlike the other benchmarks, this one
+needs a Vulkan device.
+
+The scene is synthesized: one mesh with `--primitives` primitives, each a
+grid of `--vertices` vertices with positions, normals, texture coordinates,
+and indices. Each primitive has its own accessors, so that SceneVk doesn't
+merge them.
+
+For each mode, this reports the median and minimum time of create() plus
+the upload, and the number and size of the geometry allocations, as JSON.
+
+Example:
+  nvpro2_scene_geometry_benchmark --primitives 100000 --arena 256 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#define VMA_IMPLEMENTATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/check_error.hpp"
+#include "nvvk/commands.hpp"
+#include "nvvk/context.hpp"
+#include "nvvk/resource_allocator.hpp"
+#include "nvvk/sampler_pool.hpp"
+#include "nvvk/staging.hpp"
+#include "nvvkgltf/scene.hpp"
+#include "nvvkgltf/scene_vk.hpp"
+
+namespace {
+
+// Appends `data` to the model's only buffer and returns a buffer view of it.
+template <class T>
+int addBufferView(tinygltf::Model& model, const std::vector<T>& data, int target)
+{
+  tinygltf::Buffer& buffer = model.buffers[0];
+  const size_t      offset = buffer.data.size();
+  buffer.data.resize(offset + data.size() * sizeof(T));
+  memcpy(buffer.data.data() + offset, data.data(), data.size() * sizeof(T));
+
+  tinygltf::BufferView view;
+  view.buffer     = 0;
+  view.byteOffset = offset;
+  view.byteLength = data.size() * sizeof(T);
+  view.target     = target;
+  model.bufferViews.push_back(view);
+  return static_cast<int>(model.bufferViews.size()) - 1;
+}
+
+int addAccessor(tinygltf::Model& model, int bufferView, int componentType, int type, size_t count)
+{
+  tinygltf::Accessor accessor;
+  accessor.bufferView    = bufferView;
+  accessor.componentType = componentType;
+  accessor.type          = type;
+  accessor.count         = count;
+  model.accessors.push_back(accessor);
+  return static_cast<int>(model.accessors.size()) - 1;
+}
+
+// Returns a model with `numPrimitives` grids of about `numVertices` vertices.
+// All primitives share the same buffer views, but have their own accessors.
+tinygltf::Model makeModel(uint32_t numPrimitives, uint32_t numVertices)
+{
+  const uint32_t side = std::max(2u, uint32_t(std::sqrt(double(numVertices))));
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec2> texCoords;
+  std::vector<uint32_t>  indices;
+  for(uint32_t y = 0; y < side; y++)
+  {
+    for(uint32_t x = 0; x < side; x++)
+    {
+      const glm::vec2 uv = glm::vec2(x, y) / float(side - 1);
+      positions.emplace_back(uv.x, 0.0f, uv.y);
+      normals.emplace_back(0.0f, 1.0f, 0.0f);
+      texCoords.push_back(uv);
+    }
+  }
+  for(uint32_t y = 0; y + 1 < side; y++)
+  {
+    for(uint32_t x = 0; x + 1 < side; x++)
+    {
+      const uint32_t i = y * side + x;
+      indices.insert(indices.end(), {i, i + side, i + 1, i + 1, i + side, i + side + 1});
+    }
+  }
+
+  tinygltf::Model model;
+  model.buffers.resize(1);
+  const int positionView = addBufferView(model, positions, TINYGLTF_TARGET_ARRAY_BUFFER);
+  const int normalView   = addBufferView(model, normals, TINYGLTF_TARGET_ARRAY_BUFFER);
+  const int texCoordView = addBufferView(model, texCoords, TINYGLTF_TARGET_ARRAY_BUFFER);
+  const int indexView    = addBufferView(model, indices, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+
+  tinygltf::Mesh mesh;
+  for(uint32_t i = 0; i < numPrimitives; i++)
+  {
+    tinygltf::Primitive primitive;
+    primitive.mode = TINYGLTF_MODE_TRIANGLES;
+    primitive.attributes["POSITION"] =
+        addAccessor(model, positionView, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, positions.size());
+    model.accessors.back().minValues = {0.0, 0.0, 0.0};
+    model.accessors.back().maxValues = {1.0, 0.0, 1.0};
+    primitive.attributes["NORMAL"] = addAccessor(model, normalView, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, normals.size());
+    primitive.attributes["TEXCOORD_0"] =
+        addAccessor(model, texCoordView, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2, texCoords.size());
+    primitive.indices = addAccessor(model, indexView, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, indices.size());
+    mesh.primitives.push_back(primitive);
+  }
+  model.meshes.push_back(mesh);
+
+  tinygltf::Node node;
+  node.mesh = 0;
+  model.nodes.push_back(node);
+  tinygltf::Scene scene;
+  scene.nodes = {0};
+  model.scenes.push_back(scene);
+  model.defaultScene = 0;
+  return model;
+}
+
+struct Result
+{
+  std::string mode;
+  uint64_t    arenaSize     = 0;
+  double      medianMs      = 0.0;
+  double      minMs         = 0.0;
+  uint32_t    geometryCount = 0;
+  uint64_t    geometryBytes = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              numPrimitives  = 100000;
+  uint32_t              numVertices    = 64;
+  uint32_t              arenaMiB       = 256;
+  uint32_t              iterations     = 3;
+  std::filesystem::path outputFilename = "scene_geometry_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser parameterParser("Measures SceneVk geometry creation with and without geometry arenas; writes JSON.");
+  parameterRegistry.add({"primitives", "number of primitives in the scene"}, &numPrimitives, 1u);
+  parameterRegistry.add({"vertices", "approximate number of vertices per primitive"}, &numVertices, 4u);
+  parameterRegistry.add({"arena", "geometry arena size in MiB"}, &arenaMiB, 1u);
+  parameterRegistry.add({"iterations", "timed runs per mode"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  nvvk::ContextInitInfo contextInfo;
+  contextInfo.enableValidationLayers = false;
+  nvvk::Context context;
+  if(context.init(contextInfo) != VK_SUCCESS)
+  {
+    LOGE("Could not create a Vulkan device.\n");
+    return EXIT_FAILURE;
+  }
+  const VkDevice         device = context.getDevice();
+  const nvvk::QueueInfo& queue  = context.getQueueInfo(0);
+
+  nvvk::ResourceAllocator alloc;
+  NVVK_CHECK(alloc.init({
+      .flags            = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .physicalDevice   = context.getPhysicalDevice(),
+      .device           = device,
+      .instance         = context.getInstance(),
+      .vulkanApiVersion = VK_API_VERSION_1_4,
+  }));
+  nvvk::SamplerPool samplerPool;
+  samplerPool.init(device);
+  nvvk::StagingUploader staging;
+  staging.init(&alloc);
+  const VkCommandPool cmdPool = nvvk::createTransientCommandPool(device, queue.familyIndex);
+
+  LOGI("Synthesizing %u primitives of about %u vertices\n", numPrimitives, numVertices);
+  nvvkgltf::Scene scene;
+  scene.takeModel(makeModel(numPrimitives, numVertices));
+
+  std::vector<Result> results;
+  for(const uint64_t arenaSize : {uint64_t(0), uint64_t(arenaMiB) << 20})
+  {
+    Result result;
+    result.mode      = arenaSize ? "geometry arenas" : "buffer per attribute";
+    result.arenaSize = arenaSize;
+
+    std::vector<double> times;
+    for(uint32_t i = 0; i < iterations; i++)
+    {
+      nvvkgltf::SceneVk sceneVk;
+      sceneVk.init(&alloc, &samplerPool);
+      sceneVk.setGeometryArenaSize(arenaSize);
+
+      nvutils::PerformanceTimer timer;
+      VkCommandBuffer           cmd = nvvk::createSingleTimeCommands(device, cmdPool);
+      sceneVk.create(cmd, staging, scene, false, false);
+      staging.cmdUploadAppended(cmd);
+      NVVK_CHECK(nvvk::endSingleTimeCommands(cmd, device, cmdPool, queue.queue));
+      times.push_back(timer.getMilliseconds());
+
+      const nvvkgltf::GpuMemoryStats stats = sceneVk.getMemoryTracker().getStats("Geometry");
+      result.geometryCount                 = stats.currentCount;
+      result.geometryBytes                 = stats.currentBytes;
+
+      staging.releaseStaging();
+      sceneVk.deinit();
+    }
+    std::sort(times.begin(), times.end());
+    result.minMs    = times.front();
+    result.medianMs = times[times.size() / 2];
+    results.push_back(result);
+  }
+
+  vkDestroyCommandPool(device, cmdPool, nullptr);
+  staging.deinit();
+  samplerPool.deinit();
+  alloc.deinit();
+  context.deinit();
+
+  std::string json = "{\n  \"benchmark\": \"scene_geometry\",\n  \"primitives\": " + std::to_string(numPrimitives)
+                     + ",\n  \"vertices\": " + std::to_string(numVertices) + ",\n  \"iterations\": " + std::to_string(iterations)
+                     + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%-20s %10.3f ms  %8u geometry allocations  %8.1f MiB\n", r.mode.c_str(), r.medianMs, r.geometryCount,
+         double(r.geometryBytes) / (1024.0 * 1024.0));
+
+    char numbers[256];
+    snprintf(numbers, sizeof(numbers),
+             "\"arena_bytes\": %llu, \"median_ms\": %.4f, \"min_ms\": %.4f, \"geometry_allocations\": %u, "
+             "\"geometry_bytes\": %llu",
+             static_cast<unsigned long long>(r.arenaSize), r.medianMs, r.minMs, r.geometryCount,
+             static_cast<unsigned long long>(r.geometryBytes));
+    json += "    {\"mode\": \"" + r.mode + "\", " + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU cost of upload-heavy frames with nvvk::StagingUploader,
+which creates a staging buffer per upload, and nvvk::RingStagingUploader,
+which sub-allocates a persistently mapped ring. Needs a Vulkan device.
+
+Each frame uploads `--uploads` chunks of `--size` bytes into device-local
+buffers, records the copies, and submits them signaling a timeline
+semaphore; up to `--inflight` frames are in flight, and staging space is
+released through their SemaphoreStates, as in a renderer's frame loop.
+
+For each uploader, this reports the median and minimum CPU time per frame
+(releaseStaging(), the appendBuffer() calls and cmdUploadAppended()), the
+number of staging buffers created, the peak number of VMA allocations, and
+how many uploads fell back to temporary buffers because the ring was full,
+as JSON.
+
+Example:
+  nvpro2_staging_ring_benchmark --uploads 1000 --size 16384 --ring 64 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#define VMA_IMPLEMENTATION
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/check_error.hpp"
+#include "nvvk/context.hpp"
+#include "nvvk/resource_allocator.hpp"
+#include "nvvk/semaphore.hpp"
+#include "nvvk/staging.hpp"
+
+namespace {
+
+// Counts the staging buffers StagingUploader creates.
+class CountingStagingUploader : public nvvk::StagingUploader
+{
+public:
+  VkResult acquireStagingSpace(nvvk::BufferRange&          stagingSpace,
+                               size_t                      dataSize,
+                               const void*                 data,
+                               const nvvk::SemaphoreState& semaphoreState = {}) override
+  {
+    stagingBuffers++;
+    return StagingUploader::acquireStagingSpace(stagingSpace, dataSize, data, semaphoreState);
+  }
+
+  uint64_t stagingBuffers = 0;
+};
+
+struct Result
+{
+  std::string uploader;
+  double      medianMs         = 0.0;
+  double      minMs            = 0.0;
+  uint64_t    stagingBuffers   = 0;  // Created over all frames
+  uint32_t    peakAllocations  = 0;  // VMA allocations of all heaps
+  uint64_t    ringFullFallback = 0;
+};
+
+uint32_t countAllocations(VmaAllocator allocator)
+{
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+  vmaGetHeapBudgets(allocator, budgets);
+  uint32_t count = 0;
+  for(const VmaBudget& budget : budgets)
+  {
+    count += budget.statistics.allocationCount;
+  }
+  return count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              uploads        = 1000;
+  uint32_t              size           = 16384;
+  uint32_t              frames         = 200;
+  uint32_t              inflight       = 2;
+  uint32_t              ringMiB        = 64;
+  std::filesystem::path outputFilename = "staging_ring_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures StagingUploader vs. RingStagingUploader per frame; writes JSON.");
+  parameterRegistry.add({"uploads", "uploads per frame"}, &uploads, 1u);
+  parameterRegistry.add({"size", "bytes per upload"}, &size, 4u);
+  parameterRegistry.add({"frames", "timed frames per uploader"}, &frames, 1u);
+  parameterRegistry.add({"inflight", "frames in flight"}, &inflight, 1u);
+  parameterRegistry.add({"ring", "ring size in MiB"}, &ringMiB, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  nvvk::ContextInitInfo contextInfo;
+  contextInfo.enableValidationLayers = false;
+  nvvk::Context context;
+  if(context.init(contextInfo) != VK_SUCCESS)
+  {
+    LOGE("Could not create a Vulkan device.\n");
+    return EXIT_FAILURE;
+  }
+  const VkDevice         device = context.getDevice();
+  const nvvk::QueueInfo& queue  = context.getQueueInfo(0);
+
+  nvvk::ResourceAllocator alloc;
+  NVVK_CHECK(alloc.init({
+      .flags            = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .physicalDevice   = context.getPhysicalDevice(),
+      .device           = device,
+      .instance         = context.getInstance(),
+      .vulkanApiVersion = VK_API_VERSION_1_4,
+  }));
+
+  // Destination buffers; each frame writes every chunk once
+  const uint32_t            chunksPerBuffer = std::max(1u, (64u << 20) / size);
+  std::vector<nvvk::Buffer> buffers((uploads + chunksPerBuffer - 1) / chunksPerBuffer);
+  for(nvvk::Buffer& buffer : buffers)
+  {
+    NVVK_CHECK(alloc.createBuffer(buffer, VkDeviceSize(chunksPerBuffer) * size,
+                                  VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT,
+                                  VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE));
+  }
+  const std::vector<char> data(size, 1);
+
+  const VkCommandPoolCreateInfo poolInfo{
+      .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = queue.familyIndex,
+  };
+  VkCommandPool cmdPool{};
+  NVVK_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &cmdPool));
+  std::vector<VkCommandBuffer>      cmds(inflight);
+  const VkCommandBufferAllocateInfo cmdInfo{
+      .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool        = cmdPool,
+      .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = inflight,
+  };
+  NVVK_CHECK(vkAllocateCommandBuffers(device, &cmdInfo, cmds.data()));
+
+  // Runs the frame loop with `staging` and fills in the timings of `result`.
+  auto runFrames = [&](nvvk::StagingUploader& staging, Result& result) {
+    VkSemaphore timeline{};
+    NVVK_CHECK(nvvk::createTimelineSemaphore(device, 0, timeline));
+
+    std::vector<double> times;
+    for(uint64_t frame = 1; frame <= frames; frame++)
+    {
+      // Wait until the command buffer of this frame slot is available again
+      if(frame > inflight)
+      {
+        const uint64_t            waitValue = frame - inflight;
+        const VkSemaphoreWaitInfo waitInfo{
+            .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores    = &timeline,
+            .pValues        = &waitValue,
+        };
+        NVVK_CHECK(vkWaitSemaphores(device, &waitInfo, ~0ULL));
+      }
+      VkCommandBuffer cmd = cmds[frame % inflight];
+      NVVK_CHECK(vkResetCommandBuffer(cmd, 0));
+      const VkCommandBufferBeginInfo beginInfo{
+          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+          .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      };
+      NVVK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+
+      nvutils::PerformanceTimer  timer;
+      const nvvk::SemaphoreState semaphoreState = nvvk::SemaphoreState::makeFixed(timeline, frame);
+      staging.releaseStaging();
+      for(uint32_t i = 0; i < uploads; i++)
+      {
+        NVVK_CHECK(staging.appendBuffer(buffers[i / chunksPerBuffer], VkDeviceSize(i % chunksPerBuffer) * size, size,
+                                        data.data(), semaphoreState));
+      }
+      staging.cmdUploadAppended(cmd);
+      times.push_back(timer.getMilliseconds());
+      result.peakAllocations = std::max(result.peakAllocations, countAllocations(alloc));
+
+      NVVK_CHECK(vkEndCommandBuffer(cmd));
+      const VkCommandBufferSubmitInfo cmdSubmitInfo{
+          .sType         = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+          .commandBuffer = cmd,
+      };
+      const VkSemaphoreSubmitInfo signalInfo = nvvk::makeSemaphoreSubmitInfo(semaphoreState, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT);
+      const VkSubmitInfo2 submitInfo{
+          .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+          .commandBufferInfoCount   = 1,
+          .pCommandBufferInfos      = &cmdSubmitInfo,
+          .signalSemaphoreInfoCount = 1,
+          .pSignalSemaphoreInfos    = &signalInfo,
+      };
+      NVVK_CHECK(vkQueueSubmit2(queue.queue, 1, &submitInfo, VK_NULL_HANDLE));
+    }
+    NVVK_CHECK(vkDeviceWaitIdle(device));
+    staging.releaseStaging(true);
+    vkDestroySemaphore(device, timeline, nullptr);
+
+    std::sort(times.begin(), times.end());
+    result.minMs    = times.front();
+    result.medianMs = times[times.size() / 2];
+  };
+
+  std::vector<Result> results;
+  {
+    Result result;
+    result.uploader = "StagingUploader";
+    CountingStagingUploader staging;
+    staging.init(&alloc);
+    runFrames(staging, result);
+    result.stagingBuffers = staging.stagingBuffers;
+    staging.deinit();
+    results.push_back(result);
+  }
+  {
+    Result result;
+    result.uploader = "RingStagingUploader";
+    nvvk::RingStagingUploader staging;
+    NVVK_CHECK(staging.init({.resourceAllocator = &alloc, .ringSize = VkDeviceSize(ringMiB) << 20}));
+    runFrames(staging, result);
+    const nvvk::RingStagingUploader::RingStats& stats = staging.getRingStats();
+    result.stagingBuffers                               = 1 + stats.dedicatedAllocations;
+    result.ringFullFallback                             = stats.ringFullCount;
+    staging.deinit();
+    results.push_back(result);
+  }
+
+  vkDestroyCommandPool(device, cmdPool, nullptr);
+  for(nvvk::Buffer& buffer : buffers)
+  {
+    alloc.destroyBuffer(buffer);
+  }
+  alloc.deinit();
+  context.deinit();
+
+  std::string json = "{\n  \"benchmark\": \"staging_ring\",\n  \"uploads\": " + std::to_string(uploads)
+                     + ",\n  \"size\": " + std::to_string(size) + ",\n  \"frames\": " + std::to_string(frames)
+                     + ",\n  \"inflight\": " + std::to_string(inflight) + ",\n  \"ring_mib\": " + std::to_string(ringMiB)
+                     + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%-20s %10.3f ms/frame  %10llu staging buffers  %6u peak allocations  %8llu ring full\n", r.uploader.c_str(),
+         r.medianMs, static_cast<unsigned long long>(r.stagingBuffers), r.peakAllocations,
+         static_cast<unsigned long long>(r.ringFullFallback));
+
+    char numbers[256];
+    snprintf(numbers, sizeof(numbers),
+             "\"median_ms\": %.4f, \"min_ms\": %.4f, \"staging_buffers\": %llu, \"peak_allocations\": %u, "
+             "\"ring_full_fallbacks\": %llu",
+             r.medianMs, r.minMs, static_cast<unsigned long long>(r.stagingBuffers), r.peakAllocations,
+             static_cast<unsigned long long>(r.ringFullFallback));
+    json += "    {\"uploader\": \"" + r.uploader + "\", " + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the allocation throughput of nvvk::BufferSubAllocator when several
+threads sub-allocate small chunks at once, as streaming workers do. Needs a
+Vulkan device for the blocks, but no commands are recorded.
+
+Each thread makes `--ops` sub-allocations with log-uniform sizes between
+`--min-size` and `--max-size` bytes, keeping the last `--window` alive and
+freeing the oldest. Every 8th one is freed by the next thread instead, to
+include frees on other threads than the allocating one.
+
+Two modes are compared on 1, 2, 4, ... up to `--threads` threads:
+* "locked": subAllocate / subFree, which take the allocator's mutex each
+  time, the same as an external mutex around them
+* "concurrent": subAllocateConcurrent / subFreeConcurrent with per-thread
+  size-class caches
+
+For each, this reports the median and minimum time, and the millions of
+sub-allocations (plus their frees) per second, as JSON.
+
+Example:
+  nvpro2_suballocator_concurrency_benchmark --threads 16 --ops 200000 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#define VMA_IMPLEMENTATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/buffer_suballocator.hpp"
+#include "nvvk/check_error.hpp"
+#include "nvvk/context.hpp"
+#include "nvvk/resource_allocator.hpp"
+
+namespace {
+
+struct Result
+{
+  std::string mode;
+  uint32_t    threads          = 0;
+  double      medianMs         = 0.0;
+  double      minMs            = 0.0;
+  double      mAllocsPerSecond = 0.0;  // Of the median time
+};
+
+// Sub-allocations handed to another thread to free
+struct alignas(64) Mailbox
+{
+  std::mutex                             mutex;
+  std::vector<nvvk::BufferSubAllocation> subAllocations;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              maxThreads     = 16;
+  uint32_t              ops            = 100000;
+  uint32_t              window         = 1024;
+  uint32_t              minSize        = 256;
+  uint32_t              maxSize        = 16384;
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "suballocator_concurrency_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures BufferSubAllocator throughput from several threads; writes JSON.");
+  parameterRegistry.add({"threads", "highest thread count; powers of two up to it are measured"}, &maxThreads, 1u);
+  parameterRegistry.add({"ops", "sub-allocations per thread"}, &ops, 1u);
+  parameterRegistry.add({"window", "live sub-allocations per thread"}, &window, 1u);
+  parameterRegistry.add({"min-size", "smallest sub-allocation in bytes"}, &minSize, 4u);
+  parameterRegistry.add({"max-size", "largest sub-allocation in bytes"}, &maxSize, 4u);
+  parameterRegistry.add({"iterations", "timed runs per mode and thread count"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  nvvk::ContextInitInfo contextInfo;
+  contextInfo.enableValidationLayers = false;
+  nvvk::Context context;
+  if(context.init(contextInfo) != VK_SUCCESS)
+  {
+    LOGE("Could not create a Vulkan device.\n");
+    return EXIT_FAILURE;
+  }
+
+  nvvk::ResourceAllocator alloc;
+  NVVK_CHECK(alloc.init({
+      .flags            = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .physicalDevice   = context.getPhysicalDevice(),
+      .device           = context.getDevice(),
+      .instance         = context.getInstance(),
+      .vulkanApiVersion = VK_API_VERSION_1_4,
+  }));
+
+  // Runs all threads once on a fresh allocator; returns the time in ms.
+  auto run = [&](uint32_t numThreads, bool concurrent) {
+    nvvk::BufferSubAllocator subAllocator;
+    NVVK_CHECK(subAllocator.init({
+        .resourceAllocator = &alloc,
+        .debugName         = "benchmark",
+        .memoryUsage       = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .blockSize         = VkDeviceSize(64) << 20,
+        .concurrentThreads = numThreads,
+    }));
+
+    std::vector<Mailbox> mailboxes(numThreads);
+
+    auto worker = [&](uint32_t t) {
+      std::mt19937                           rng(t + 1);
+      std::uniform_real_distribution<double> logSize(std::log(double(minSize)), std::log(double(maxSize)));
+      std::deque<nvvk::BufferSubAllocation>  live;
+      std::vector<nvvk::BufferSubAllocation> received;
+
+      auto freeOne = [&](nvvk::BufferSubAllocation& subAllocation) {
+        if(concurrent)
+        {
+          subAllocator.subFreeConcurrent(t, subAllocation);
+        }
+        else
+        {
+          subAllocator.subFree(subAllocation);
+        }
+      };
+      auto freeReceived = [&]() {
+        {
+          std::lock_guard<std::mutex> lock(mailboxes[t].mutex);
+          std::swap(received, mailboxes[t].subAllocations);
+        }
+        for(nvvk::BufferSubAllocation& subAllocation : received)
+        {
+          freeOne(subAllocation);
+        }
+        received.clear();
+      };
+
+      for(uint32_t i = 0; i < ops; i++)
+      {
+        const VkDeviceSize        size = VkDeviceSize(std::exp(logSize(rng))) & ~VkDeviceSize(3);
+        nvvk::BufferSubAllocation subAllocation;
+        NVVK_CHECK(concurrent ? subAllocator.subAllocateConcurrent(t, subAllocation, size) :
+                                subAllocator.subAllocate(subAllocation, size));
+        live.push_back(subAllocation);
+
+        if(live.size() > window)
+        {
+          if(i % 8 == 0 && numThreads > 1)
+          {
+            Mailbox&                    next = mailboxes[(t + 1) % numThreads];
+            std::lock_guard<std::mutex> lock(next.mutex);
+            next.subAllocations.push_back(live.front());
+          }
+          else
+          {
+            freeOne(live.front());
+          }
+          live.pop_front();
+        }
+        if(i % 64 == 0)
+        {
+          freeReceived();
+        }
+      }
+      for(nvvk::BufferSubAllocation& subAllocation : live)
+      {
+        freeOne(subAllocation);
+      }
+    };
+
+    nvutils::PerformanceTimer timer;
+    std::vector<std::thread>  threads;
+    for(uint32_t t = 0; t < numThreads; t++)
+    {
+      threads.emplace_back(worker, t);
+    }
+    for(std::thread& thread : threads)
+    {
+      thread.join();
+    }
+    const double ms = timer.getMilliseconds();
+
+    // What's left in the mailboxes after all threads finished
+    for(uint32_t t = 0; t < numThreads; t++)
+    {
+      for(nvvk::BufferSubAllocation& subAllocation : mailboxes[t].subAllocations)
+      {
+        concurrent ? subAllocator.subFreeConcurrent(t, subAllocation) : subAllocator.subFree(subAllocation);
+      }
+    }
+    subAllocator.flushConcurrentCaches();
+    subAllocator.deinit();
+    return ms;
+  };
+
+  std::vector<Result> results;
+  for(uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+  {
+    for(bool concurrent : {false, true})
+    {
+      Result result{.mode = concurrent ? "concurrent" : "locked", .threads = numThreads};
+
+      std::vector<double> times;
+      for(uint32_t iteration = 0; iteration < iterations; iteration++)
+      {
+        times.push_back(run(numThreads, concurrent));
+      }
+      std::sort(times.begin(), times.end());
+      result.minMs            = times.front();
+      result.medianMs         = times[times.size() / 2];
+      result.mAllocsPerSecond = double(ops) * numThreads / (result.medianMs * 1000.0);
+      results.push_back(result);
+    }
+  }
+
+  alloc.deinit();
+  context.deinit();
+
+  std::string json = "{\n  \"benchmark\": \"suballocator_concurrency\",\n  \"ops\": " + std::to_string(ops)
+                     + ",\n  \"window\": " + std::to_string(window) + ",\n  \"min_size\": " + std::to_string(minSize)
+                     + ",\n  \"max_size\": " + std::to_string(maxSize) + ",\n  \"hardware_threads\": "
+                     + std::to_string(std::thread::hardware_concurrency()) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%-10s %3u threads %10.3f ms  %8.2f M sub-allocations/s\n", r.mode.c_str(), r.threads, r.medianMs, r.mAllocsPerSecond);
+
+    char numbers[256];
+    snprintf(numbers, sizeof(numbers),
+             "\"threads\": %u, \"median_ms\": %.4f, \"min_ms\": %.4f, \"m_allocs_per_second\": %.3f", r.threads,
+             r.medianMs, r.minMs, r.mAllocsPerSecond);
+    json += "    {\"mode\": \"" + r.mode + "\", " + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures texture_conversion::convert() throughput for common pairs of
+formats, against the number of threads: byte shuffles between 8-bit formats,
+sRGB <-> linear, float <-> half, 16-bit -> 8-bit, and premultiplied alpha.
+One case writes rows with a padded pitch, as when converting into staging
+memory.
+
+For each conversion and thread count, this reports the median and minimum
+time, MPixels/s, and destination GB/s as JSON.
+
+Example:
+  nvpro2_texture_conversion_benchmark --size 4096 --threads 1,2,4,8,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include "nvimageformats/texture_conversion.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+struct Case
+{
+  const char* name;
+  VkFormat    srcFormat;
+  VkFormat    dstFormat;
+  bool        premultiplyAlpha = false;
+  size_t      dstRowAlignment  = 1;  // Rows of the destination start at multiples of this
+};
+
+const Case kCases[] = {
+    {"RGB8 -> RGBA8", VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM},
+    {"RGB8 -> RGBA8 (pitch 256)", VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM, false, 256},
+    {"R8 -> RGBA8", VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8B8A8_UNORM},
+    {"RGBA8 -> BGRA8", VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM},
+    {"RGBA8 SRGB -> RGBA8 UNORM", VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM},
+    {"RGBA8 SRGB premultiply", VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB, true},
+    {"RGBA16 UNORM -> RGBA8", VK_FORMAT_R16G16B16A16_UNORM, VK_FORMAT_R8G8B8A8_UNORM},
+    {"RGBA32F -> RGBA16F", VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT},
+    {"RGBA16F -> RGBA32F", VK_FORMAT_R16G16B16A16_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT},
+    {"RGB32F -> RGBA16F", VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT},
+    {"RGBA32F -> RGBA8 SRGB", VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R8G8B8A8_SRGB},
+};
+
+struct Result
+{
+  std::string name;
+  uint32_t    threads  = 0;
+  double      medianMs = 0.0;
+  double      minMs    = 0.0;
+  size_t      dstBytes = 0;
+  bool        ok       = true;
+};
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+// Fills `bytes` with texels of `format`. Float and half texels are in [0, 1),
+// so that conversions don't take shortcuts for NaNs and infinities.
+void fillTexels(VkFormat format, std::vector<char>& bytes)
+{
+  uint32_t rng  = 12345;
+  auto     next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng;
+  };
+  switch(format)
+  {
+    case VK_FORMAT_R32G32B32_SFLOAT:
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+      for(size_t i = 0; i + sizeof(float) <= bytes.size(); i += sizeof(float))
+      {
+        const float value = float(next() >> 8) / float(1 << 24);
+        memcpy(bytes.data() + i, &value, sizeof(value));
+      }
+      break;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+      for(size_t i = 0; i + sizeof(uint16_t) <= bytes.size(); i += sizeof(uint16_t))
+      {
+        const uint16_t value = uint16_t(glm::packHalf1x16(float(next() >> 8) / float(1 << 24)));
+        memcpy(bytes.data() + i, &value, sizeof(value));
+      }
+      break;
+    default:
+      for(char& c : bytes)
+      {
+        c = char(next() >> 24);
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              size           = 2048;
+  std::string           threadsList    = "1,2,4,8,0";
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "texture_conversion_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser parameterParser("Measures texture_conversion throughput per format pair and thread count; writes JSON.");
+  parameterRegistry.add({"size", "width and height of the converted images"}, &size, 1u);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed conversions per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+  size = std::max(1u, size);
+
+  const std::vector<uint32_t> threads    = parseList(threadsList);
+  const double                megapixels = double(size) * double(size) * 1e-6;
+  std::vector<Result>         results;
+  bool                        allOk = true;
+  for(const Case& c : kCases)
+  {
+    const size_t srcTexelBytes = texture_conversion::getTexelSizeBytes(c.srcFormat);
+    const size_t dstTexelBytes = texture_conversion::getTexelSizeBytes(c.dstFormat);
+    const size_t dstRowBytes   = size_t(size) * dstTexelBytes;
+
+    texture_conversion::ConversionSettings settings;
+    settings.premultiplyAlpha = c.premultiplyAlpha;
+    settings.dstRowPitch      = (dstRowBytes + c.dstRowAlignment - 1) / c.dstRowAlignment * c.dstRowAlignment;
+
+    std::vector<char> src(size_t(size) * size * srcTexelBytes);
+    std::vector<char> dst(settings.dstRowPitch * size);
+    fillTexels(c.srcFormat, src);
+
+    for(uint32_t numThreads : threads)
+    {
+      settings.numThreads = numThreads;
+      Result result;
+      result.name     = c.name;
+      result.threads  = numThreads;
+      result.dstBytes = dst.size();
+      std::vector<double> times;
+      for(uint32_t i = 0; i < iterations; i++)
+      {
+        nvutils::PerformanceTimer timer;
+        result.ok = !texture_conversion::convert(c.srcFormat, src, c.dstFormat, dst, size, size, settings).has_value() && result.ok;
+        times.push_back(timer.getMilliseconds());
+      }
+      std::sort(times.begin(), times.end());
+      result.minMs    = times.front();
+      result.medianMs = times[times.size() / 2];
+      LOGI("%-26s threads %-3u %10.3f ms %10.1f MPixels/s %8.2f GB/s%s\n", result.name.c_str(), result.threads,
+           result.medianMs, megapixels / (result.medianMs * 1e-3), double(result.dstBytes) / (result.medianMs * 1e6),
+           result.ok ? "" : " (FAILED)");
+      allOk = allOk && result.ok;
+      results.push_back(std::move(result));
+    }
+  }
+
+  std::string json = "{\n  \"benchmark\": \"texture_conversion\",\n  \"size\": " + std::to_string(size)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"conversion\": \"%s\", \"threads\": %u, \"median_ms\": %.4f, \"min_ms\": %.4f, "
+             "\"mpixels_per_s\": %.3f, \"dst_gb_per_s\": %.3f, \"ok\": %s}%s\n",
+             r.name.c_str(), r.threads, r.medianMs, r.minMs, megapixels / (r.medianMs * 1e-3),
+             double(r.dstBytes) / (r.medianMs * 1e6), r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
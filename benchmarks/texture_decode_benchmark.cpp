@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures texture_decode::decodeImage() throughput in MPixels/s for each
+block-compressed format and decode target, against the number of threads.
+
+BC7 and ASTC 4x4 blocks come from transcoding a UASTC image, so that they use
+the modes an encoder picks. BC1-BC6H blocks are random; about half of random
+BC6H blocks use reserved modes, which decode quickly to 0. Blocks are tiled
+to fill the requested size.
+
+For each format, target, and thread count, this reports the median and
+minimum decode time and throughput as JSON.
+
+Example:
+  nvpro2_texture_decode_benchmark --size 4096 --threads 1,2,4,8,0 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "nvimageformats/nv_ktx.h"
+#include "nvimageformats/texture_decode.h"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+struct Case
+{
+  std::string       name;
+  VkFormat          format = VK_FORMAT_UNDEFINED;
+  std::vector<char> blocks;  // size x size texels
+};
+
+// Repeats `tile`, which holds tileBlocks x tileBlocks blocks, to fill an image
+// of `blocks` x `blocks` blocks.
+std::vector<char> tileBlocks(std::span<const char> tile, size_t tileBlocks, size_t blocks, size_t blockBytes)
+{
+  std::vector<char> result(blocks * blocks * blockBytes);
+  for(size_t y = 0; y < blocks; y++)
+  {
+    for(size_t x = 0; x < blocks; x++)
+    {
+      const size_t src = ((y % tileBlocks) * tileBlocks + (x % tileBlocks)) * blockBytes;
+      memcpy(result.data() + (y * blocks + x) * blockBytes, tile.data() + src, blockBytes);
+    }
+  }
+  return result;
+}
+
+std::vector<char> randomBlocks(size_t bytes)
+{
+  std::vector<char> result(bytes);
+  uint32_t          rng = 12345;
+  for(char& c : result)
+  {
+    rng = rng * 1664525u + 1013904223u;
+    c   = char(rng >> 24);
+  }
+  return result;
+}
+
+// Returns BC7 and ASTC 4x4 blocks transcoded from a `tileSize` x `tileSize`
+// UASTC image, or false on failure.
+bool transcodeFromUASTC(uint32_t tileSize, std::vector<char>& bc7, std::vector<char>& astc)
+{
+  nv_ktx::KTXImage image;
+  image.format       = VK_FORMAT_B8G8R8A8_UNORM;
+  image.mip_0_width  = tileSize;
+  image.mip_0_height = tileSize;
+  image.allocate(1, 0, 1);
+  std::vector<char>& pixels = image.subresource(0, 0, 0);
+  pixels.resize(size_t(tileSize) * tileSize * 4);
+  uint32_t rng = 12345;
+  for(uint32_t y = 0; y < tileSize; y++)
+  {
+    for(uint32_t x = 0; x < tileSize; x++)
+    {
+      rng             = rng * 1664525u + 1013904223u;
+      const int noise = int(rng >> 28) - 8;
+      char*     texel = &pixels[(size_t(y) * tileSize + x) * 4];
+      texel[0]        = char(std::clamp(int(x * 255 / tileSize) + noise, 0, 255));
+      texel[1]        = char(std::clamp(int(y * 255 / tileSize) + noise, 0, 255));
+      texel[2]        = char(std::clamp(128 + int((x / 16 + y / 16) % 2) * 64 + noise, 0, 255));
+      texel[3]        = char(std::clamp(255 - int(x * 64 / tileSize), 0, 255));
+    }
+  }
+  nv_ktx::WriteSettings writeSettings;
+  writeSettings.encode_rgba8_to_format = nv_ktx::EncodeRGBA8ToFormat::UASTC;
+  writeSettings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+  std::ostringstream output;
+  if(image.writeKTX2Stream(output, writeSettings).has_value())
+  {
+    return false;
+  }
+  const std::string file = output.str();
+
+  for(bool toASTC : {false, true})
+  {
+    nv_ktx::ReadSettings readSettings;
+    readSettings.device_supports_astc = toASTC;
+    nv_ktx::KTXImage   transcoded;
+    std::istringstream input(file);
+    if(transcoded.readFromStream(input, readSettings).has_value())
+    {
+      return false;
+    }
+    const std::span<const char> bytes = transcoded.subresourceBytes(0, 0, 0);
+    (toASTC ? astc : bc7).assign(bytes.begin(), bytes.end());
+  }
+  return true;
+}
+
+struct Result
+{
+  std::string name;
+  std::string target;
+  uint32_t    threads  = 0;
+  double      medianMs = 0.0;
+  double      minMs    = 0.0;
+  bool        ok       = true;
+};
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              size           = 2048;
+  uint32_t              tileSize       = 256;
+  std::string           threadsList    = "1,2,4,8,0";
+  uint32_t              iterations     = 5;
+  std::filesystem::path outputFilename = "texture_decode_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser parameterParser("Measures texture_decode throughput per format and thread count; writes JSON.");
+  parameterRegistry.add({"size", "width and height of the decoded images; a multiple of 4"}, &size, 4u);
+  parameterRegistry.add({"tilesize", "size of the UASTC image BC7 and ASTC blocks are transcoded from"}, &tileSize, 4u);
+  parameterRegistry.add({"threads", "comma-separated thread counts; 0 means the whole thread pool"}, &threadsList);
+  parameterRegistry.add({"iterations", "timed decodes per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+  size     = std::max(4u, size & ~3u);
+  tileSize = std::min(std::max(4u, tileSize & ~3u), size);
+
+  const size_t      blocks = size / 4;
+  std::vector<Case> cases;
+  for(const auto& [name, format, blockBytes] : {std::tuple{"BC1", VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 8u},
+                                                std::tuple{"BC3", VK_FORMAT_BC3_UNORM_BLOCK, 16u},
+                                                std::tuple{"BC4 UNORM", VK_FORMAT_BC4_UNORM_BLOCK, 8u},
+                                                std::tuple{"BC4 SNORM", VK_FORMAT_BC4_SNORM_BLOCK, 8u},
+                                                std::tuple{"BC5 UNORM", VK_FORMAT_BC5_UNORM_BLOCK, 16u},
+                                                std::tuple{"BC6H UFLOAT", VK_FORMAT_BC6H_UFLOAT_BLOCK, 16u}})
+  {
+    cases.push_back({name, format, randomBlocks(blocks * blocks * blockBytes)});
+  }
+  std::vector<char> bc7;
+  std::vector<char> astc;
+  bool              allOk = transcodeFromUASTC(tileSize, bc7, astc);
+  if(allOk)
+  {
+    cases.push_back({"BC7", VK_FORMAT_BC7_UNORM_BLOCK, tileBlocks(bc7, tileSize / 4, blocks, 16)});
+    cases.push_back({"ASTC 4x4", VK_FORMAT_ASTC_4x4_UNORM_BLOCK, tileBlocks(astc, tileSize / 4, blocks, 16)});
+  }
+  else
+  {
+    LOGW("Transcoding the UASTC test image failed; skipping BC7 and ASTC.\n");
+  }
+
+  const std::vector<uint32_t> threads    = parseList(threadsList);
+  const double                megapixels = double(size) * double(size) * 1e-6;
+  std::vector<Result>         results;
+  for(const Case& c : cases)
+  {
+    for(texture_decode::DecodeTarget target : {texture_decode::DecodeTarget::eRGBA8, texture_decode::DecodeTarget::eRGBA16F})
+    {
+      std::vector<char> decoded(texture_decode::decodedSizeBytes(target, size, size));
+      for(uint32_t numThreads : threads)
+      {
+        Result result;
+        result.name    = c.name;
+        result.target  = (target == texture_decode::DecodeTarget::eRGBA8) ? "RGBA8" : "RGBA16F";
+        result.threads = numThreads;
+        std::vector<double> times;
+        for(uint32_t i = 0; i < iterations; i++)
+        {
+          nvutils::PerformanceTimer timer;
+          result.ok = !texture_decode::decodeImage(c.format, size, size, c.blocks, target, decoded, numThreads).has_value()
+                      && result.ok;
+          times.push_back(timer.getMilliseconds());
+        }
+        std::sort(times.begin(), times.end());
+        result.minMs    = times.front();
+        result.medianMs = times[times.size() / 2];
+        LOGI("%-12s to %-7s threads %-3u %10.3f ms %10.1f MPixels/s%s\n", result.name.c_str(), result.target.c_str(),
+             result.threads, result.medianMs, megapixels / (result.medianMs * 1e-3), result.ok ? "" : " (FAILED)");
+        allOk = allOk && result.ok;
+        results.push_back(std::move(result));
+      }
+    }
+  }
+
+  std::string json = "{\n  \"benchmark\": \"texture_decode\",\n  \"size\": " + std::to_string(size)
+                     + ",\n  \"iterations\": " + std::to_string(iterations) + ",\n  \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    char          line[512];
+    snprintf(line, sizeof(line),
+             "    {\"format\": \"%s\", \"target\": \"%s\", \"threads\": %u, \"median_ms\": %.4f, \"min_ms\": %.4f, "
+             "\"mpixels_per_s\": %.3f, \"ok\": %s}%s\n",
+             r.name.c_str(), r.target.c_str(), r.threads, r.medianMs, r.minMs, megapixels / (r.medianMs * 1e-3),
+             r.ok ? "true" : "false", (i + 1 < results.size()) ? "," : "");
+    json += line;
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU side of SceneVk::createTextureImages without a device:
+decoding a set of PNG textures with stb_image, the way SceneVk::loadImage
+does, and copying each one into a fixed-size staging ring, the way
+createImage() copies mips into staging memory.
+
+Two strategies are compared:
+* "decode all, then upload": every image is decoded in parallel before any
+  is copied, which is how createTextureImages used to work
+* "bounded pipeline": nvutils::parallel_produce_consume with each of the
+  given memory budgets
+
+For each, this reports the median and minimum wall-clock time, the peak
+bytes allocated through operator new and stb_image, and the peak decoded
+bytes reported by the pipeline, as JSON.
+
+Example:
+  nvpro2_texture_streaming_benchmark --count 64 --size 1024 --budgets 0,256,64 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nvutils/bounded_pipeline.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+#include "alloc_stats.hpp"
+
+#define STBI_MALLOC(size) alloc_stats::allocate(size)
+#define STBI_REALLOC(p, newSize) alloc_stats::reallocate(p, newSize)
+#define STBI_FREE(p) alloc_stats::release(p)
+// Use static definitions to avoid conflicts with other libraries' copies of
+// stb_image.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "fixtures.hpp"
+
+namespace {
+
+// Decodes a texture the way SceneVk::loadImage does for PNGs: stb_image
+// decodes into its own buffer, which is copied into the image's mipData.
+bool decodeTexture(const std::vector<char>& file, std::vector<char>& mipData)
+{
+  int      w = 0, h = 0, comp = 0;
+  stbi_uc* data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), int(file.size()), &w, &h, &comp, 4);
+  if(data == nullptr)
+  {
+    return false;
+  }
+  mipData.assign(data, data + size_t(w) * h * 4);
+  stbi_image_free(data);
+  return true;
+}
+
+// Stands in for the staging buffer: copies wrap around a fixed-size ring,
+// as if each full ring were submitted and reused.
+struct StagingRing
+{
+  std::vector<char> memory;
+  size_t            offset = 0;
+
+  void upload(const std::vector<char>& data)
+  {
+    size_t copied = 0;
+    while(copied < data.size())
+    {
+      const size_t chunk = std::min(data.size() - copied, memory.size() - offset);
+      memcpy(memory.data() + offset, data.data() + copied, chunk);
+      copied += chunk;
+      offset = (offset + chunk) % memory.size();
+    }
+  }
+};
+
+struct Result
+{
+  std::string strategy;
+  uint64_t    budgetBytes     = 0;
+  uint32_t    threads         = 0;
+  double      medianMs        = 0.0;
+  double      minMs           = 0.0;
+  int64_t     peakAllocBytes  = 0;
+  uint64_t    peakQueuedBytes = 0;
+  bool        ok              = true;
+};
+
+// Runs one strategy once; returns whether all textures decoded.
+// `budget` is only used by the pipeline; UINT64_MAX selects "decode all".
+bool runOnce(const std::vector<std::vector<char>>& files, uint64_t budget, uint32_t numThreads, StagingRing& staging, uint64_t& peakQueuedBytes)
+{
+  std::vector<std::vector<char>> mipData(files.size());
+  std::vector<char>              decoded(files.size(), 0);
+
+  if(budget == UINT64_MAX)
+  {
+    nvutils::parallel_batches<1>(
+        files.size(), [&](uint64_t i) { decoded[i] = decodeTexture(files[i], mipData[i]); }, numThreads);
+    peakQueuedBytes = 0;
+    for(const std::vector<char>& mip : mipData)
+    {
+      peakQueuedBytes += mip.size();
+    }
+    for(std::vector<char>& mip : mipData)
+    {
+      staging.upload(mip);
+      mip = std::vector<char>();
+    }
+  }
+  else
+  {
+    nvutils::BoundedPipelineSettings settings;
+    settings.memoryBudget = budget;
+    settings.numWorkers   = numThreads;
+    const nvutils::BoundedPipelineStats stats = nvutils::parallel_produce_consume(
+        files.size(),
+        [&](uint64_t i) -> uint64_t {
+          decoded[i] = decodeTexture(files[i], mipData[i]);
+          return mipData[i].size();
+        },
+        [&](uint64_t i) {
+          staging.upload(mipData[i]);
+          mipData[i] = std::vector<char>();
+        },
+        settings);
+    peakQueuedBytes = stats.peakBytes;
+  }
+
+  return std::all_of(decoded.begin(), decoded.end(), [](char ok) { return ok != 0; });
+}
+
+Result runCase(const std::string&                    strategy,
+               const std::vector<std::vector<char>>& files,
+               uint64_t                              budget,
+               uint32_t                              numThreads,
+               uint32_t                              iterations,
+               StagingRing&                          staging)
+{
+  Result result;
+  result.strategy    = strategy;
+  result.budgetBytes = (budget == UINT64_MAX) ? 0 : budget;
+  result.threads     = numThreads;
+
+  alloc_stats::reset();
+  const int64_t baseline = alloc_stats::g_current.load();
+  result.ok              = runOnce(files, budget, numThreads, staging, result.peakQueuedBytes);
+  result.peakAllocBytes  = alloc_stats::g_peak.load() - baseline;
+
+  std::vector<double> times;
+  for(uint32_t i = 0; i < iterations; i++)
+  {
+    uint64_t                  peakQueuedBytes = 0;
+    nvutils::PerformanceTimer timer;
+    result.ok = runOnce(files, budget, numThreads, staging, peakQueuedBytes) && result.ok;
+    times.push_back(timer.getMilliseconds());
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::vector<uint32_t> parseList(const std::string& list)
+{
+  std::vector<uint32_t> result;
+  std::stringstream     stream(list);
+  std::string           item;
+  while(std::getline(stream, item, ','))
+  {
+    if(!item.empty())
+    {
+      result.push_back(uint32_t(std::stoul(item)));
+    }
+  }
+  return result;
+}
+
+std::string toJSON(const std::vector<Result>& results, uint32_t count, uint32_t size, uint32_t iterations)
+{
+  fixtures::JSONObject settings;
+  settings.add("count", count).add("size", size).add("iterations", iterations);
+  std::vector<fixtures::JSONObject> jsonResults;
+  for(const Result& r : results)
+  {
+    jsonResults.emplace_back()
+        .add("strategy", r.strategy)
+        .add("budget_bytes", r.budgetBytes)
+        .add("threads", r.threads)
+        .add("median_ms", r.medianMs)
+        .add("min_ms", r.minMs)
+        .add("peak_alloc_bytes", r.peakAllocBytes)
+        .add("peak_queued_bytes", r.peakQueuedBytes)
+        .add("ok", r.ok);
+  }
+  return fixtures::toJSON("texture_streaming", settings, jsonResults);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              count          = 32;
+  uint32_t              size           = 1024;
+  std::string           budgetsList    = "0,256,64";
+  std::string           threadsList    = "0";
+  uint32_t              stagingMiB     = 64;
+  uint32_t              iterations     = 3;
+  std::filesystem::path outputFilename = "texture_streaming_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures peak memory and time of streaming texture decode and upload; writes JSON.");
+  parameterRegistry.add({"count", "number of textures in the set"}, &count, 1u);
+  parameterRegistry.add({"size", "width (and height) of each texture"}, &size, 1u);
+  parameterRegistry.add({"budgets", "comma-separated pipeline memory budgets in MiB; 0 means unlimited"}, &budgetsList);
+  parameterRegistry.add({"threads", "comma-separated decode thread counts; 0 means all hardware threads"}, &threadsList);
+  parameterRegistry.add({"staging", "size of the simulated staging ring in MiB"}, &stagingMiB, 1u);
+  parameterRegistry.add({"iterations", "timed runs per case"}, &iterations, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const std::vector<uint32_t> budgets = parseList(budgetsList);
+  const std::vector<uint32_t> threads = parseList(threadsList);
+
+  LOGI("Synthesizing %u %u x %u PNG textures\n", count, size, size);
+  std::vector<std::vector<char>> files(count);
+  nvutils::parallel_batches<1>(count, [&](uint64_t i) { files[i] = fixtures::makePNG(size, uint32_t(i)); });
+
+  StagingRing staging;
+  staging.memory.resize(size_t(stagingMiB) << 20);
+
+  std::vector<Result> results;
+  for(uint32_t numThreads : threads)
+  {
+    results.push_back(runCase("decode all, then upload", files, UINT64_MAX, numThreads, iterations, staging));
+    for(uint32_t budgetMiB : budgets)
+    {
+      results.push_back(runCase("bounded pipeline", files, uint64_t(budgetMiB) << 20, numThreads, iterations, staging));
+    }
+  }
+
+  for(const Result& r : results)
+  {
+    LOGI("%-24s budget %5llu MiB threads %-3u %10.3f ms  peak alloc %8.1f MiB  peak queued %8.1f MiB%s\n",
+         r.strategy.c_str(), static_cast<unsigned long long>(r.budgetBytes >> 20), r.threads, r.medianMs,
+         double(r.peakAllocBytes) / (1024.0 * 1024.0), double(r.peakQueuedBytes) / (1024.0 * 1024.0), r.ok ? "" : " (FAILED)");
+  }
+
+  if(!fixtures::writeJSON(outputFilename, toJSON(results, count, size, iterations)))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU side of SceneRtx::updateTopLevelAS for large instance
+counts, without a device. Uploads are simulated by copying into a host array
+that stands in for the instance buffer.
+
+Two strategies are compared:
+* "serial": every VkAccelerationStructureInstanceKHR is regenerated in one
+  loop, with the transpose-and-memcpy transform conversion, and the whole
+  array is uploaded; this is how updateTopLevelAS used to work (except that
+  it also parsed each instance's material for its flags)
+* "parallel": instances are regenerated with nvvk::updateTlasInstances and
+  the SIMD nvvk::toTransformMatrixKHR, only the changed ones are uploaded in
+  the ranges nvutils::coalesceDirtyRanges returns, and their motion is fed
+  to nvvk::TlasRefitTracker
+
+Each frame, `--changed` percent of the instances take a random step of
+`--step` times their size, either spread over the scene or in runs of 64.
+Instances are unit cubes on a grid with a spacing of 4, so the TLAS starts
+out well-separated and degrades as instances wander.
+
+For each, this reports the median and minimum CPU time per frame, the bytes
+and ranges uploaded per frame, and for "parallel" the estimated degradation
+at the end and the frames at which it crossed `--threshold` (where
+updateTopLevelAS would rebuild, after which tracking restarts), as JSON.
+After each frame, the simulated instance buffer is checked against a
+serial rebuild.
+
+Example:
+  nvpro2_tlas_instances_benchmark --instances 1000000 --changed 1 --step 0.25 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "nvutils/bit_array.hpp"
+#include "nvutils/dirty_ranges.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+#include "nvvk/acceleration_structures.hpp"
+#include "nvvk/tlas_instances.hpp"
+
+#include "fixtures.hpp"
+
+namespace {
+
+// Same as in SceneRtx
+constexpr uint64_t kInstanceUploadMaxGap = 8;
+
+// The parts of nvvkgltf::RenderNode that updateTopLevelAS reads
+struct RenderNode
+{
+  glm::mat4 worldMatrix{1};
+  int       materialID   = 0;
+  int       renderPrimID = 0;
+  bool      visible      = true;
+};
+
+// The conversion updateTopLevelAS used before
+VkTransformMatrixKHR toTransformMatrixTransposed(glm::mat4 matrix)
+{
+  glm::mat4            temp = glm::transpose(matrix);
+  VkTransformMatrixKHR out_matrix;
+  memcpy(&out_matrix, &temp, sizeof(VkTransformMatrixKHR));
+  return out_matrix;
+}
+
+struct Scene
+{
+  std::vector<RenderNode>                 renderNodes;
+  std::vector<VkDeviceAddress>            blasAddresses;
+  std::vector<VkGeometryInstanceFlagsKHR> materialFlags;
+};
+
+Scene makeScene(uint64_t instanceCount)
+{
+  Scene          scene;
+  const uint64_t side = uint64_t(std::ceil(std::cbrt(double(instanceCount))));
+  scene.renderNodes.resize(instanceCount);
+  for(uint64_t i = 0; i < instanceCount; i++)
+  {
+    const glm::vec3 position(float(i % side), float(i / side % side), float(i / (side * side)));
+    const float     angle = float(i % 360) * 0.0174533f;
+    glm::mat4       m     = glm::translate(glm::mat4(1), position * 4.0f);
+    scene.renderNodes[i].worldMatrix  = glm::rotate(m, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+    scene.renderNodes[i].materialID   = int(i % 100);
+    scene.renderNodes[i].renderPrimID = int(i % 1000);
+  }
+  for(int i = 0; i < 1000; i++)
+  {
+    scene.blasAddresses.push_back(0x10000000ull + uint64_t(i) * 0x10000);
+  }
+  for(int i = 0; i < 100; i++)
+  {
+    scene.materialFlags.push_back(i % 3 == 0 ? VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR : 0);
+  }
+  return scene;
+}
+
+void makeInstance(const Scene& scene, const RenderNode& node, VkAccelerationStructureInstanceKHR& instance)
+{
+  instance.transform                              = nvvk::toTransformMatrixKHR(node.worldMatrix);
+  instance.instanceCustomIndex                    = node.renderPrimID;
+  instance.accelerationStructureReference         = node.visible ? scene.blasAddresses[node.renderPrimID] : 0;
+  instance.instanceShaderBindingTableRecordOffset = 0;
+  instance.mask                                   = 0x01;
+  instance.flags                                  = scene.materialFlags[node.materialID];
+}
+
+struct Upload
+{
+  uint64_t bytes  = 0;
+  uint32_t ranges = 0;
+};
+
+// The old updateTopLevelAS
+Upload serialUpdate(const Scene& scene, std::vector<VkAccelerationStructureInstanceKHR>& instances, std::vector<VkAccelerationStructureInstanceKHR>& gpuBuffer)
+{
+  for(size_t i = 0; i < scene.renderNodes.size(); i++)
+  {
+    const RenderNode& object                   = scene.renderNodes[i];
+    instances[i].transform                     = toTransformMatrixTransposed(object.worldMatrix);
+    instances[i].flags                         = scene.materialFlags[object.materialID];
+    instances[i].accelerationStructureReference = object.visible ? scene.blasAddresses[object.renderPrimID] : 0;
+  }
+  memcpy(gpuBuffer.data(), instances.data(), instances.size() * sizeof(VkAccelerationStructureInstanceKHR));
+  return {instances.size() * sizeof(VkAccelerationStructureInstanceKHR), 1};
+}
+
+// The new updateTopLevelAS; `instances` persists between frames
+Upload parallelUpdate(const Scene&                                     scene,
+                      std::vector<VkAccelerationStructureInstanceKHR>& instances,
+                      std::vector<VkAccelerationStructureInstanceKHR>& gpuBuffer,
+                      nvvk::TlasRefitTracker&                          tracker)
+{
+  const glm::vec3   localCenter(0.0f), localHalfExtent(0.5f);
+  nvutils::BitArray dirty(instances.size());
+  nvvk::updateTlasInstances(
+      instances, dirty,
+      [&](uint64_t i, VkAccelerationStructureInstanceKHR& instance) { makeInstance(scene, scene.renderNodes[i], instance); },
+      [&](uint64_t i) { tracker.setRefit(i, scene.renderNodes[i].worldMatrix, localCenter, localHalfExtent); });
+
+  Upload upload;
+  for(const nvutils::DirtyRange& range : nvutils::coalesceDirtyRanges(dirty, kInstanceUploadMaxGap))
+  {
+    memcpy(&gpuBuffer[range.first], &instances[range.first], range.count * sizeof(VkAccelerationStructureInstanceKHR));
+    upload.bytes += range.count * sizeof(VkAccelerationStructureInstanceKHR);
+    upload.ranges++;
+  }
+  return upload;
+}
+
+void setBuilt(const Scene& scene, nvvk::TlasRefitTracker& tracker)
+{
+  nvutils::parallel_batches(scene.renderNodes.size(), [&](uint64_t i) {
+    tracker.setBuilt(i, scene.renderNodes[i].worldMatrix, glm::vec3(0.0f), glm::vec3(0.5f));
+  });
+  tracker.commitBuild();
+}
+
+// Indices of the instances that move in frame `frame`
+std::vector<uint64_t> pickChanged(uint64_t instanceCount, uint64_t changedCount, bool clustered, uint32_t frame)
+{
+  std::vector<uint64_t> changed;
+  uint32_t              rng = 777 + frame * 2654435761u;
+  const uint64_t        run = clustered ? 64 : 1;
+  while(changed.size() < changedCount)
+  {
+    rng                  = rng * 1664525u + 1013904223u;
+    const uint64_t first = (uint64_t(rng) * instanceCount >> 32) / run * run;
+    for(uint64_t i = first; i < std::min(first + run, instanceCount) && changed.size() < changedCount; i++)
+    {
+      changed.push_back(i);
+    }
+  }
+  return changed;
+}
+
+struct Result
+{
+  std::string           pattern;
+  std::string           strategy;
+  double                medianMs      = 0.0;
+  double                minMs         = 0.0;
+  uint64_t              uploadedBytes = 0;  // Per frame
+  uint32_t              rangeCount    = 0;  // Per frame
+  float                 degradation   = 0.0f;
+  std::vector<uint32_t> rebuildFrames;
+  bool                  ok = true;
+};
+
+Result runCase(uint64_t instanceCount, uint64_t changedCount, float step, float threshold, bool clustered, bool parallel, uint32_t frames)
+{
+  Result result;
+  result.pattern  = clustered ? "clustered" : "random";
+  result.strategy = parallel ? "parallel" : "serial";
+
+  Scene                                           scene = makeScene(instanceCount);
+  std::vector<VkAccelerationStructureInstanceKHR> instances(instanceCount);
+  std::vector<VkAccelerationStructureInstanceKHR> gpuBuffer(instanceCount);
+  std::vector<VkAccelerationStructureInstanceKHR> reference(instanceCount);
+  std::vector<VkAccelerationStructureInstanceKHR> referenceInstances(instanceCount);
+  nvvk::TlasRefitTracker                          tracker;
+
+  // First upload and build, not timed
+  for(uint64_t i = 0; i < instanceCount; i++)
+  {
+    makeInstance(scene, scene.renderNodes[i], instances[i]);
+  }
+  referenceInstances = instances;
+  gpuBuffer          = instances;
+  tracker.init(instanceCount);
+  setBuilt(scene, tracker);
+
+  std::vector<double> times;
+  for(uint32_t frame = 0; frame < frames; frame++)
+  {
+    uint32_t rng = 12345 + frame * 2246822519u;
+    for(uint64_t i : pickChanged(instanceCount, changedCount, clustered, frame))
+    {
+      rng = rng * 1664525u + 1013904223u;
+      const float     angle = float(rng >> 8) * (6.2831853f / 16777216.0f);
+      const glm::vec3 delta(std::cos(angle) * step, 0.0f, std::sin(angle) * step);
+      scene.renderNodes[i].worldMatrix[3] += glm::vec4(delta, 0.0f);
+    }
+
+    nvutils::PerformanceTimer timer;
+    const Upload              upload =
+        parallel ? parallelUpdate(scene, instances, gpuBuffer, tracker) : serialUpdate(scene, instances, gpuBuffer);
+    times.push_back(timer.getMilliseconds());
+    result.uploadedBytes = upload.bytes;
+    result.rangeCount    = upload.ranges;
+
+    if(parallel)
+    {
+      result.degradation = tracker.getDegradation();
+      if(result.degradation > threshold)
+      {
+        result.rebuildFrames.push_back(frame);
+        setBuilt(scene, tracker);
+      }
+
+      serialUpdate(scene, referenceInstances, reference);
+      result.ok = memcmp(gpuBuffer.data(), reference.data(), reference.size() * sizeof(reference[0])) == 0 && result.ok;
+    }
+  }
+  std::sort(times.begin(), times.end());
+  result.minMs    = times.front();
+  result.medianMs = times[times.size() / 2];
+  return result;
+}
+
+std::string toJSON(const std::vector<Result>& results, uint64_t instanceCount, uint64_t changedCount, float step, float threshold, uint32_t frames)
+{
+  fixtures::JSONObject settings;
+  settings.add("instances", instanceCount)
+      .add("changed", changedCount)
+      .add("step", step)
+      .add("threshold", threshold)
+      .add("frames", frames)
+      .add("hardware_threads", std::thread::hardware_concurrency());
+  std::vector<fixtures::JSONObject> jsonResults;
+  for(const Result& r : results)
+  {
+    std::string rebuildFrames;
+    for(uint32_t frame : r.rebuildFrames)
+    {
+      rebuildFrames += (rebuildFrames.empty() ? "" : ", ") + std::to_string(frame);
+    }
+    jsonResults.emplace_back()
+        .add("pattern", r.pattern)
+        .add("strategy", r.strategy)
+        .add("median_ms", r.medianMs)
+        .add("min_ms", r.minMs)
+        .add("uploaded_bytes", r.uploadedBytes)
+        .add("ranges", r.rangeCount)
+        .add("degradation", r.degradation)
+        .addJSON("rebuild_frames", "[" + rebuildFrames + "]")
+        .add("ok", r.ok);
+  }
+  return fixtures::toJSON("tlas_instances", settings, jsonResults);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              instances      = 1000000;
+  float                 changedPercent = 1.0f;
+  float                 step           = 0.25f;
+  float                 threshold      = 0.5f;
+  uint32_t              frames         = 20;
+  std::filesystem::path outputFilename = "tlas_instances_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures TLAS instance updates and the refit heuristic; writes JSON.");
+  parameterRegistry.add({"instances", "number of TLAS instances"}, &instances, 1u);
+  parameterRegistry.add({"changed", "percentage of instances that move each frame"}, &changedPercent, 0.0f, 100.0f);
+  parameterRegistry.add({"step", "distance an instance moves per frame, relative to its size"}, &step, 0.0f);
+  parameterRegistry.add({"threshold", "degradation at which the TLAS is rebuilt"}, &threshold, 0.0f);
+  parameterRegistry.add({"frames", "timed frames per case"}, &frames, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const uint64_t changedCount = std::max<uint64_t>(1, uint64_t(double(instances) * changedPercent / 100.0));
+
+  std::vector<Result> results;
+  for(const bool clustered : {false, true})
+  {
+    for(const bool parallel : {false, true})
+    {
+      results.push_back(runCase(instances, changedCount, step, threshold, clustered, parallel, frames));
+    }
+  }
+
+  LOGI("%u hardware threads\n", std::thread::hardware_concurrency());
+  for(const Result& r : results)
+  {
+    LOGI("%-9s %-8s %10.3f ms  uploaded %10.3f MiB in %7u ranges", r.pattern.c_str(), r.strategy.c_str(), r.medianMs,
+         double(r.uploadedBytes) / (1024.0 * 1024.0), r.rangeCount);
+    if(r.strategy == "parallel")
+    {
+      LOGI("  degradation %.3f, %zu rebuilds", r.degradation, r.rebuildFrames.size());
+    }
+    LOGI("%s\n", r.ok ? "" : " (MISMATCH)");
+  }
+
+  if(!fixtures::writeJSON(outputFilename, toJSON(results, instances, changedCount, step, threshold, frames)))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+/*-----------------------------------------------------------------------------
+
+Measures the CPU tonemapper of nvshaders_host (tonemapper_cpu.hpp) on a
+synthetic `--width` x `--height` HDR image (hues across, -10 to +10 EV
+down, with noise and a few black pixels), for each tonemapping method:
+* shaderio::applyTonemap() per pixel, as a reference, on one thread
+* nvshaders::tonemapImage() to RGBA8 while building the auto-exposure
+  histogram, on one thread and on all of nvutils' thread pool
+in millions of pixels per second.
+
+tests/tonemapper_cpu_test.cpp checks the results against the scalar
+functions.
+
+Example:
+  nvpro2_tonemap_cpu_benchmark --width 3840 --height 2160 --output results.json
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvshaders/slang_types.h"
+#include "nvshaders/tonemap_functions.h.slang"
+#include "nvshaders_host/tonemapper_cpu.hpp"
+#include "nvutils/logger.hpp"
+#include "nvutils/parameter_parser.hpp"
+#include "nvutils/parameter_registry.hpp"
+#include "nvutils/timers.hpp"
+
+namespace {
+
+const char* kMethodNames[] = {"filmic", "uncharted2", "clip", "aces", "agx", "khronos_pbr"};
+
+struct Result
+{
+  const char* method     = nullptr;
+  double      scalarMs   = 0.0;
+  double      serialMs   = 0.0;
+  double      parallelMs = 0.0;
+};
+
+std::vector<float> makeImage(uint32_t width, uint32_t height)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  uint32_t           rng = 1234;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      rng               = rng * 1664525u + 1013904223u;
+      const float noise = float(rng >> 8) / 16777216.0f;
+      const float ev    = -10.0f + 20.0f * (float(y) + noise) / float(height);
+      const float hue   = 6.2831853f * float(x) / float(width);
+      const float scale = std::exp2(ev);
+      float*      texel = &rgba[(size_t(y) * width + x) * 4];
+      const bool  black = (rng >> 4) % 97 == 0;
+      texel[0]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue));
+      texel[1]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue - 2.0943951f));
+      texel[2]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue + 2.0943951f));
+      texel[3]          = float(x % 256) / 255.0f;
+    }
+  }
+  return rgba;
+}
+
+// The Tonemap shader on the CPU with the scalar functions
+void tonemapScalar(const float* rgba, uint32_t width, uint32_t height, shaderio::TonemapperData tm, float exposureLuminance, float* outRgba)
+{
+  tm.inputMatrix = shaderio::getColorCorrectionMatrix(tm.exposure, tm.temperature, tm.tint);
+  const float exposureMultiplier = 0.18f / std::max(0.001f, exposureLuminance);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const float* texel = rgba + (size_t(y) * width + x) * 4;
+      glm::vec3    color(texel[0], texel[1], texel[2]);
+      if(tm.autoExposure == 1)
+      {
+        color *= exposureMultiplier;
+      }
+      color        = shaderio::applyTonemap(tm, color, glm::vec2(float(x), float(y)), glm::vec2(float(width), float(height)));
+      float* out   = outRgba + (size_t(y) * width + x) * 4;
+      out[0]       = color.x;
+      out[1]       = color.y;
+      out[2]       = color.z;
+      out[3]       = texel[3];
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  uint32_t              width          = 3840;
+  uint32_t              height         = 2160;
+  uint32_t              repetitions    = 3;
+  std::filesystem::path outputFilename = "tonemap_cpu_benchmark.json";
+
+  nvutils::ParameterRegistry parameterRegistry;
+  nvutils::ParameterParser   parameterParser("Measures the CPU tonemapper; writes JSON.");
+  parameterRegistry.add({"width", "width of the image"}, &width, 1u);
+  parameterRegistry.add({"height", "height of the image"}, &height, 1u);
+  parameterRegistry.add({"repetitions", "runs of the vector paths; the fastest counts"}, &repetitions, 1u);
+  parameterRegistry.add({"output", "JSON file to write"}, &outputFilename);
+  parameterParser.add(parameterRegistry);
+  parameterParser.parse(argc, argv);
+
+  const std::vector<float> image = makeImage(width, height);
+
+  std::vector<Result>  results;
+  std::vector<float>   reference(image.size());
+  std::vector<uint8_t> unorm(image.size());
+  for(int method = 0; method < shaderio::ToneMapMethod::eCount; method++)
+  {
+    Result result;
+    result.method = kMethodNames[method];
+
+    shaderio::TonemapperData settings;
+    settings.method = method;
+
+    nvutils::PerformanceTimer scalarTimer;
+    tonemapScalar(image.data(), width, height, settings, 1.0f, reference.data());
+    result.scalarMs = scalarTimer.getMilliseconds();
+
+    for(uint32_t threads : {1u, 0u})
+    {
+      double best = 1e30;
+      for(uint32_t r = 0; r < repetitions; r++)
+      {
+        nvshaders::ExposureHistogram histogram{};
+        nvutils::PerformanceTimer    timer;
+        nvshaders::tonemapImage(image.data(), width, height, settings, 1.0f, unorm.data(), &histogram, threads);
+        best = std::min(best, timer.getMilliseconds());
+      }
+      (threads == 1 ? result.serialMs : result.parallelMs) = best;
+    }
+    results.push_back(result);
+  }
+
+  LOGI("%u hardware threads, %u x %u pixels\n", std::thread::hardware_concurrency(), width, height);
+  std::string json = "{\n  \"benchmark\": \"tonemap_cpu\",\n  \"width\": " + std::to_string(width)
+                     + ",\n  \"height\": " + std::to_string(height)
+                     + ",\n  \"hardware_threads\": " + std::to_string(std::thread::hardware_concurrency())
+                     + ",\n  \"results\": [\n";
+  const double megapixels = double(width) * height / 1e6;
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    const Result& r = results[i];
+    LOGI("%-11s  scalar %8.1f MPixels/s  1 thread %8.1f MPixels/s  all threads %8.1f MPixels/s\n", r.method,
+         megapixels / (r.scalarMs / 1000.0), megapixels / (r.serialMs / 1000.0), megapixels / (r.parallelMs / 1000.0));
+
+    char numbers[512];
+    snprintf(numbers, sizeof(numbers),
+             "\"method\": \"%s\", \"scalar_ms\": %.4f, \"serial_ms\": %.4f, \"parallel_ms\": %.4f, \"scalar_mpixels_per_second\": %.2f, "
+             "\"serial_mpixels_per_second\": %.2f, \"parallel_mpixels_per_second\": %.2f",
+             r.method, r.scalarMs, r.serialMs, r.parallelMs, megapixels / (r.scalarMs / 1000.0),
+             megapixels / (r.serialMs / 1000.0), megapixels / (r.parallelMs / 1000.0));
+    json += std::string("    {") + numbers + "}";
+    json += (i + 1 < results.size()) ? ",\n" : "\n";
+  }
+  json += "  ]\n}\n";
+
+  FILE* file = nullptr;
+#ifdef _WIN32
+  _wfopen_s(&file, outputFilename.c_str(), L"wb");
+#else
+  file = fopen(outputFilename.c_str(), "wb");
+#endif
+  if(file == nullptr)
+  {
+    LOGE("Could not open %s for writing.\n", outputFilename.string().c_str());
+    return EXIT_FAILURE;
+  }
+  fwrite(json.data(), 1, json.size(), file);
+  fclose(file);
+  LOGI("Wrote %s\n", outputFilename.string().c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,732 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "mip_generation.h"
+#include "nv_dds.h"
+#include "nv_ktx.h"
+#include "texture_formats.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <string.h>  // memcpy
+#include <vector>
+
+#include <glm/gtc/packing.hpp>  // packHalf1x16, unpackHalf1x16
+
+#include "nvutils/parallel_work.hpp"
+
+namespace mip_generation {
+
+// Macro for "If this returned an error, propagate that error"
+#define UNWRAP_ERROR(expr_returning_error_with_text)                                                                   \
+  if(ErrorWithText unwrap_error_tmp = (expr_returning_error_with_text))                                                \
+  {                                                                                                                    \
+    return unwrap_error_tmp;                                                                                           \
+  }
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Formats
+//-----------------------------------------------------------------------------
+
+enum class ChannelType
+{
+  eUnorm8,
+  eUnorm16,
+  eFloat16,
+  eFloat32,
+};
+
+struct Layout
+{
+  uint32_t    channels = 0;  // 0 if the format is unsupported.
+  ChannelType type     = ChannelType::eUnorm8;
+  // The number of leading channels that are color (and so are affected by
+  // sRGB encoding); the rest, if any, are alpha.
+  uint32_t colorChannels = 0;
+
+  size_t channelBytes() const
+  {
+    switch(type)
+    {
+      case ChannelType::eUnorm8:
+        return 1;
+      case ChannelType::eUnorm16:
+      case ChannelType::eFloat16:
+        return 2;
+      default:
+        return 4;
+    }
+  }
+  size_t texelBytes() const { return channels * channelBytes(); }
+};
+
+Layout getLayout(VkFormat format)
+{
+  switch(format)
+  {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8_SRGB:
+      return {1, ChannelType::eUnorm8, 1};
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R8G8_SRGB:
+      return {2, ChannelType::eUnorm8, 2};
+    case VK_FORMAT_R8G8B8_UNORM:
+    case VK_FORMAT_R8G8B8_SRGB:
+    case VK_FORMAT_B8G8R8_UNORM:
+    case VK_FORMAT_B8G8R8_SRGB:
+      return {3, ChannelType::eUnorm8, 3};
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+      return {4, ChannelType::eUnorm8, 3};
+    case VK_FORMAT_R16_UNORM:
+      return {1, ChannelType::eUnorm16, 1};
+    case VK_FORMAT_R16G16_UNORM:
+      return {2, ChannelType::eUnorm16, 2};
+    case VK_FORMAT_R16G16B16_UNORM:
+      return {3, ChannelType::eUnorm16, 3};
+    case VK_FORMAT_R16G16B16A16_UNORM:
+      return {4, ChannelType::eUnorm16, 3};
+    case VK_FORMAT_R16_SFLOAT:
+      return {1, ChannelType::eFloat16, 1};
+    case VK_FORMAT_R16G16_SFLOAT:
+      return {2, ChannelType::eFloat16, 2};
+    case VK_FORMAT_R16G16B16_SFLOAT:
+      return {3, ChannelType::eFloat16, 3};
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+      return {4, ChannelType::eFloat16, 3};
+    case VK_FORMAT_R32_SFLOAT:
+      return {1, ChannelType::eFloat32, 1};
+    case VK_FORMAT_R32G32_SFLOAT:
+      return {2, ChannelType::eFloat32, 2};
+    case VK_FORMAT_R32G32B32_SFLOAT:
+      return {3, ChannelType::eFloat32, 3};
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+      return {4, ChannelType::eFloat32, 3};
+    default:
+      return {};
+  }
+}
+
+bool useSRGB(VkFormat format, ColorSpace colorSpace)
+{
+  switch(colorSpace)
+  {
+    case ColorSpace::eFromFormat:
+      return texture_formats::isVkFormatSRGB(format);
+    case ColorSpace::eSRGB:
+      return true;
+    default:
+      return false;
+  }
+}
+
+float srgbToLinear(float c)
+{
+  return (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSRGB(float c)
+{
+  return (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+}
+
+const std::array<float, 256>& srgb8ToLinearTable()
+{
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> result{};
+    for(uint32_t i = 0; i < 256; i++)
+    {
+      result[i] = srgbToLinear(float(i) / 255.0f);
+    }
+    return result;
+  }();
+  return table;
+}
+
+// Loads without assuming alignment, since the source may be a view into a
+// file.
+template <class T>
+T load(const char* p, size_t i)
+{
+  T value;
+  memcpy(&value, p + i * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <class T>
+void store(char* p, size_t i, T value)
+{
+  memcpy(p + i * sizeof(T), &value, sizeof(T));
+}
+
+// Converts a row of `numValues` channel values to float, then applies the
+// sRGB-to-linear transfer function to color channels if `srgb` is set.
+void decodeRow(const Layout& layout, bool srgb, const char* src, float* dst, size_t numValues)
+{
+  switch(layout.type)
+  {
+    case ChannelType::eUnorm8:
+      if(srgb)
+      {
+        const std::array<float, 256>& table = srgb8ToLinearTable();
+        for(size_t i = 0; i < numValues; i++)
+        {
+          const uint8_t value = static_cast<uint8_t>(src[i]);
+          dst[i]              = ((i % layout.channels) < layout.colorChannels) ? table[value] : float(value) / 255.0f;
+        }
+        return;  // Already converted
+      }
+      for(size_t i = 0; i < numValues; i++)
+      {
+        dst[i] = float(static_cast<uint8_t>(src[i])) * (1.0f / 255.0f);
+      }
+      break;
+    case ChannelType::eUnorm16:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        dst[i] = float(load<uint16_t>(src, i)) * (1.0f / 65535.0f);
+      }
+      break;
+    case ChannelType::eFloat16:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        dst[i] = glm::unpackHalf1x16(load<uint16_t>(src, i));
+      }
+      break;
+    case ChannelType::eFloat32:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        dst[i] = load<float>(src, i);
+      }
+      break;
+  }
+
+  if(srgb)
+  {
+    for(size_t i = 0; i < numValues; i++)
+    {
+      if((i % layout.channels) < layout.colorChannels)
+      {
+        dst[i] = srgbToLinear(dst[i]);
+      }
+    }
+  }
+}
+
+// The inverse of decodeRow(). Clobbers `src`.
+void encodeRow(const Layout& layout, bool srgb, float* src, char* dst, size_t numValues)
+{
+  if(srgb)
+  {
+    for(size_t i = 0; i < numValues; i++)
+    {
+      if((i % layout.channels) < layout.colorChannels)
+      {
+        src[i] = linearToSRGB(std::clamp(src[i], 0.0f, 1.0f));
+      }
+    }
+  }
+
+  switch(layout.type)
+  {
+    case ChannelType::eUnorm8:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        dst[i] = static_cast<char>(static_cast<uint8_t>(std::clamp(src[i], 0.0f, 1.0f) * 255.0f + 0.5f));
+      }
+      break;
+    case ChannelType::eUnorm16:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        store(dst, i, static_cast<uint16_t>(std::clamp(src[i], 0.0f, 1.0f) * 65535.0f + 0.5f));
+      }
+      break;
+    case ChannelType::eFloat16:
+      for(size_t i = 0; i < numValues; i++)
+      {
+        store(dst, i, static_cast<uint16_t>(glm::packHalf1x16(src[i])));
+      }
+      break;
+    case ChannelType::eFloat32:
+      memcpy(dst, src, numValues * sizeof(float));
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Filtering
+//-----------------------------------------------------------------------------
+
+// An image with `channels` floats per texel.
+struct FloatImage
+{
+  uint32_t           width    = 0;
+  uint32_t           height   = 0;
+  uint32_t           channels = 0;
+  std::vector<float> texels;
+
+  void resize(uint32_t w, uint32_t h, uint32_t c)
+  {
+    width    = w;
+    height   = h;
+    channels = c;
+    texels.resize(size_t(w) * size_t(h) * size_t(c));
+  }
+  float*       row(uint32_t y) { return texels.data() + size_t(y) * width * channels; }
+  const float* row(uint32_t y) const { return texels.data() + size_t(y) * width * channels; }
+};
+
+float sinc(float x)
+{
+  if(std::abs(x) < 1e-6f)
+  {
+    return 1.0f;
+  }
+  const float px = std::numbers::pi_v<float> * x;
+  return std::sin(px) / px;
+}
+
+// The zeroth-order modified Bessel function of the first kind.
+float besselI0(float x)
+{
+  float       sum  = 1.0f;
+  float       term = 1.0f;
+  const float x2   = x * x * 0.25f;
+  for(int k = 1; k < 32; k++)
+  {
+    term *= x2 / float(k * k);
+    sum += term;
+    if(term < sum * 1e-8f)
+    {
+      break;
+    }
+  }
+  return sum;
+}
+
+// The radius of each filter in destination texels.
+float filterRadius(Filter filter)
+{
+  return (filter == Filter::eBox) ? 0.5f : 3.0f;
+}
+
+// Evaluates a filter at `x` destination texels from its center.
+float evaluateFilter(Filter filter, float x)
+{
+  const float radius = filterRadius(filter);
+  if(std::abs(x) >= radius)
+  {
+    return 0.0f;
+  }
+  if(filter == Filter::eLanczos)
+  {
+    return sinc(x) * sinc(x / radius);
+  }
+  // Kaiser window with alpha = 4, as in NVTT.
+  constexpr float alpha = 4.0f;
+  const float     t     = x / radius;
+  return sinc(x) * besselI0(alpha * std::sqrt(1.0f - t * t)) / besselI0(alpha);
+}
+
+// For each destination texel along one axis, the contiguous range of source
+// texels it reads and their normalized weights. Taps outside the source are
+// clamped to its edges, so every range is within [0, srcSize).
+struct AxisWeights
+{
+  uint32_t              maxTaps = 0;
+  std::vector<uint32_t> first;    // The first source texel for each destination texel
+  std::vector<uint32_t> count;    // The number of source texels for each destination texel
+  std::vector<float>    weights;  // maxTaps weights per destination texel
+};
+
+AxisWeights computeAxisWeights(Filter filter, uint32_t srcSize, uint32_t dstSize)
+{
+  const float scale   = float(srcSize) / float(dstSize);
+  const float support = filterRadius(filter) * std::max(scale, 1.0f);
+
+  AxisWeights result;
+  result.maxTaps = std::min(srcSize, uint32_t(std::ceil(2.0f * support)) + 2);
+  result.first.resize(dstSize);
+  result.count.resize(dstSize);
+  result.weights.assign(size_t(dstSize) * result.maxTaps, 0.0f);
+
+  for(uint32_t d = 0; d < dstSize; d++)
+  {
+    // Texel i covers [i, i + 1), so its center is at i + 0.5.
+    const float   center = (float(d) + 0.5f) * scale;
+    const int64_t lo     = int64_t(std::floor(center - support));
+    const int64_t hi     = int64_t(std::ceil(center + support));
+    const int64_t first  = std::max<int64_t>(lo, 0);
+    const int64_t last   = std::min<int64_t>(hi, int64_t(srcSize) - 1);
+    float*        w      = &result.weights[size_t(d) * result.maxTaps];
+
+    float sum = 0.0f;
+    for(int64_t s = lo; s <= hi; s++)
+    {
+      float weight = 0.0f;
+      if(filter == Filter::eBox)
+      {
+        // Exact coverage, so that e.g. 5 -> 2 weights the middle texel by half.
+        const float halfWidth = 0.5f * std::max(scale, 1.0f);
+        const float overlap = std::min(float(s) + 1.0f, center + halfWidth) - std::max(float(s), center - halfWidth);
+        weight              = std::max(overlap, 0.0f);
+      }
+      else
+      {
+        weight = evaluateFilter(filter, (float(s) + 0.5f - center) / std::max(scale, 1.0f));
+      }
+      const int64_t clamped = std::clamp(s, first, last);
+      w[clamped - first] += weight;
+      sum += weight;
+    }
+
+    // Normalize. Trim zero-weight taps at the ends, which are common for
+    // the box filter.
+    int64_t tapFirst = 0;
+    int64_t tapLast  = last - first;
+    while(tapFirst < tapLast && w[tapFirst] == 0.0f)
+    {
+      tapFirst++;
+    }
+    while(tapLast > tapFirst && w[tapLast] == 0.0f)
+    {
+      tapLast--;
+    }
+    const float invSum = (sum != 0.0f) ? (1.0f / sum) : 0.0f;
+    for(int64_t t = tapFirst; t <= tapLast; t++)
+    {
+      w[t - tapFirst] = w[t] * invSum;
+    }
+    for(int64_t t = tapLast - tapFirst + 1; t < int64_t(result.maxTaps); t++)
+    {
+      w[t] = 0.0f;
+    }
+    result.first[d] = uint32_t(first + tapFirst);
+    result.count[d] = uint32_t(tapLast - tapFirst + 1);
+  }
+  return result;
+}
+
+// Resamples `src` to `dst`'s size with a separable filter: first along x for
+// every source row, then along y. The y pass accumulates whole rows in a
+// flat loop that compilers can auto-vectorize; the x pass is scalar.
+void resample(const FloatImage& src, FloatImage& dst, Filter filter, uint32_t numThreads)
+{
+  const uint32_t    channels = src.channels;
+  const AxisWeights weightsX = computeAxisWeights(filter, src.width, dst.width);
+  const AxisWeights weightsY = computeAxisWeights(filter, src.height, dst.height);
+
+  FloatImage horizontal;
+  horizontal.resize(dst.width, src.height, channels);
+  nvutils::parallel_batches_pooled<8>(
+      src.height,
+      [&](uint64_t y, uint32_t) {
+        const float* in  = src.row(uint32_t(y));
+        float*       out = horizontal.row(uint32_t(y));
+        for(uint32_t x = 0; x < dst.width; x++)
+        {
+          const float* w     = &weightsX.weights[size_t(x) * weightsX.maxTaps];
+          const float* taps  = in + size_t(weightsX.first[x]) * channels;
+          float        acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+          for(uint32_t t = 0; t < weightsX.count[x]; t++)
+          {
+            for(uint32_t c = 0; c < channels; c++)
+            {
+              acc[c] += w[t] * taps[size_t(t) * channels + c];
+            }
+          }
+          for(uint32_t c = 0; c < channels; c++)
+          {
+            out[size_t(x) * channels + c] = acc[c];
+          }
+        }
+      },
+      numThreads);
+
+  const size_t rowValues = size_t(dst.width) * channels;
+  nvutils::parallel_batches_pooled<8>(
+      dst.height,
+      [&](uint64_t y, uint32_t) {
+        float*       out = dst.row(uint32_t(y));
+        const float* w   = &weightsY.weights[size_t(y) * weightsY.maxTaps];
+        std::fill(out, out + rowValues, 0.0f);
+        for(uint32_t t = 0; t < weightsY.count[y]; t++)
+        {
+          const float* in     = horizontal.row(weightsY.first[y] + t);
+          const float  weight = w[t];
+          for(size_t i = 0; i < rowValues; i++)
+          {
+            out[i] += weight * in[i];
+          }
+        }
+      },
+      numThreads);
+}
+
+void decodeImage(const Layout& layout, bool srgb, std::span<const char> src, FloatImage& dst, uint32_t numThreads)
+{
+  const size_t rowValues = size_t(dst.width) * layout.channels;
+  const size_t rowBytes  = size_t(dst.width) * layout.texelBytes();
+  nvutils::parallel_batches_pooled<8>(
+      dst.height, [&](uint64_t y, uint32_t) { decodeRow(layout, srgb, src.data() + y * rowBytes, dst.row(uint32_t(y)), rowValues); },
+      numThreads);
+}
+
+// Encodes `src` into `dst`. Clobbers `src`; callers that need it afterwards
+// should encode a copy.
+void encodeImage(const Layout& layout, bool srgb, FloatImage& src, std::span<char> dst, uint32_t numThreads)
+{
+  const size_t rowValues = size_t(src.width) * layout.channels;
+  const size_t rowBytes  = size_t(src.width) * layout.texelBytes();
+  nvutils::parallel_batches_pooled<8>(
+      src.height, [&](uint64_t y, uint32_t) { encodeRow(layout, srgb, src.row(uint32_t(y)), dst.data() + y * rowBytes, rowValues); },
+      numThreads);
+}
+
+ErrorWithText checkSizes(const Layout& layout, uint32_t width, uint32_t height, size_t sizeBytes, const char* what)
+{
+  size_t expected = 0;
+  if(!checked_math::mul3(width, height, layout.texelBytes(), expected))
+  {
+    return std::string("The size of the ") + what + " would overflow.";
+  }
+  if(sizeBytes < expected)
+  {
+    return std::string("The ") + what + " was too small: a " + std::to_string(width) + " x " + std::to_string(height)
+           + " image needs " + std::to_string(expected) + " bytes, but it had " + std::to_string(sizeBytes) + ".";
+  }
+  return {};
+}
+
+// Generates mips 1 to numMips - 1 from `mip0`, calling storeMip(mip, bytes)
+// for each one. Each mip is filtered from the previous mip before
+// quantization, so rounding errors don't accumulate down the chain.
+template <class StoreMip>
+ErrorWithText generateChain(const Layout&         layout,
+                            bool                  srgb,
+                            uint32_t              width,
+                            uint32_t              height,
+                            std::span<const char> mip0,
+                            uint32_t              numMips,
+                            const Settings&       settings,
+                            StoreMip&&            storeMip)
+{
+  if(numMips <= 1)
+  {
+    return {};
+  }
+
+  FloatImage previous, current, scratch;
+  try
+  {
+    previous.resize(width, height, layout.channels);
+  }
+  catch(...)
+  {
+    return "Allocating memory for mip generation failed!";
+  }
+  decodeImage(layout, srgb, mip0, previous, settings.numThreads);
+
+  for(uint32_t mip = 1; mip < numMips; mip++)
+  {
+    std::vector<char> bytes;
+    try
+    {
+      current.resize(std::max(1u, width >> mip), std::max(1u, height >> mip), layout.channels);
+      bytes.resize(current.texels.size() * layout.channelBytes());
+    }
+    catch(...)
+    {
+      return "Allocating memory for mip " + std::to_string(mip) + " failed!";
+    }
+    resample(previous, current, settings.filter, settings.numThreads);
+
+    scratch = current;
+    encodeImage(layout, srgb, scratch, bytes, settings.numThreads);
+    storeMip(mip, std::move(bytes));
+    std::swap(previous, current);
+  }
+  return {};
+}
+
+}  // namespace
+
+bool isFormatSupported(VkFormat format)
+{
+  return getLayout(format).channels != 0;
+}
+
+uint32_t getFullMipCount(uint32_t width, uint32_t height)
+{
+  uint32_t       mips    = 1;
+  const uint32_t maxSize = std::max(width, height);
+  while((maxSize >> mips) != 0)
+  {
+    mips++;
+  }
+  return mips;
+}
+
+ErrorWithText downsample(VkFormat              format,
+                         uint32_t              srcWidth,
+                         uint32_t              srcHeight,
+                         std::span<const char> src,
+                         uint32_t              dstWidth,
+                         uint32_t              dstHeight,
+                         std::span<char>       dst,
+                         const Settings&       settings)
+{
+  const Layout layout = getLayout(format);
+  if(layout.channels == 0)
+  {
+    return "Generating mips for VkFormat " + std::to_string(format) + " is not supported.";
+  }
+  if(srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0)
+  {
+    return "Image dimensions must be nonzero.";
+  }
+  UNWRAP_ERROR(checkSizes(layout, srcWidth, srcHeight, src.size(), "source"));
+  UNWRAP_ERROR(checkSizes(layout, dstWidth, dstHeight, dst.size(), "destination"));
+
+  const bool srgb = useSRGB(format, settings.colorSpace);
+  FloatImage srcImage, dstImage;
+  try
+  {
+    srcImage.resize(srcWidth, srcHeight, layout.channels);
+    dstImage.resize(dstWidth, dstHeight, layout.channels);
+  }
+  catch(...)
+  {
+    return "Allocating memory for downsampling failed!";
+  }
+  decodeImage(layout, srgb, src, srcImage, settings.numThreads);
+  resample(srcImage, dstImage, settings.filter, settings.numThreads);
+  encodeImage(layout, srgb, dstImage, dst, settings.numThreads);
+  return {};
+}
+
+ErrorWithText generateMips(nv_ktx::KTXImage& image, const Settings& settings)
+{
+  const Layout layout = getLayout(image.format);
+  if(layout.channels == 0)
+  {
+    return "Generating mips for VkFormat " + std::to_string(image.format) + " is not supported.";
+  }
+  if(image.mip_0_depth > 1)
+  {
+    return "Generating mips for 3D textures is not supported.";
+  }
+
+  const uint32_t width      = image.mip_0_width;
+  const uint32_t height     = std::max(1u, image.mip_0_height);
+  const uint32_t numLayers  = std::max(1u, image.num_layers_possibly_0);
+  const uint32_t numFaces   = image.num_faces;
+  const uint32_t fullMips   = getFullMipCount(width, height);
+  const uint32_t numNewMips = (settings.maxMips == 0) ? fullMips : std::min(settings.maxMips, fullMips);
+
+  // Copy out mip 0 before reallocating, since it may view the caller's memory.
+  std::vector<std::vector<char>> mip0s(size_t(numLayers) * size_t(numFaces));
+  for(uint32_t layer = 0; layer < numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < numFaces; face++)
+    {
+      const std::span<const char> bytes = image.subresourceBytes(0, layer, face);
+      UNWRAP_ERROR(checkSizes(layout, width, height, bytes.size(), "mip 0 subresource"));
+      mip0s[size_t(layer) * numFaces + face].assign(bytes.begin(), bytes.end());
+    }
+  }
+
+  UNWRAP_ERROR(image.allocate(numNewMips, image.num_layers_possibly_0, numFaces));
+  image.app_should_generate_mips = false;
+
+  const bool srgb = useSRGB(image.format, settings.colorSpace);
+  for(uint32_t layer = 0; layer < numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < numFaces; face++)
+    {
+      std::vector<char>& mip0 = image.subresource(0, layer, face);
+      mip0                    = std::move(mip0s[size_t(layer) * numFaces + face]);
+      UNWRAP_ERROR(generateChain(layout, srgb, width, height, mip0, numNewMips, settings,
+                                 [&](uint32_t mip, std::vector<char>&& bytes) {
+                                   image.subresource(mip, layer, face) = std::move(bytes);
+                                 }));
+    }
+  }
+  return {};
+}
+
+ErrorWithText generateMips(nv_dds::Image& image, const Settings& settings)
+{
+  const VkFormat format = texture_formats::dxgiToVulkan(image.dxgiFormat);
+  const Layout   layout = getLayout(format);
+  if(layout.channels == 0)
+  {
+    return "Generating mips for DXGI format " + std::to_string(image.dxgiFormat) + " is not supported.";
+  }
+  if(image.mip0Depth > 1)
+  {
+    return "Generating mips for 3D textures is not supported.";
+  }
+
+  const uint32_t width      = image.mip0Width;
+  const uint32_t height     = image.mip0Height;
+  const uint32_t numLayers  = image.getNumLayers();
+  const uint32_t numFaces   = image.getNumFaces();
+  const uint32_t fullMips   = getFullMipCount(width, height);
+  const uint32_t numNewMips = (settings.maxMips == 0) ? fullMips : std::min(settings.maxMips, fullMips);
+
+  // Copy out mip 0 before reallocating, since it may view the caller's memory.
+  std::vector<std::vector<char>> mip0s(size_t(numLayers) * size_t(numFaces));
+  for(uint32_t layer = 0; layer < numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < numFaces; face++)
+    {
+      const std::span<const char> bytes = image.subresource(0, layer, face).bytes();
+      UNWRAP_ERROR(checkSizes(layout, width, height, bytes.size(), "mip 0 subresource"));
+      mip0s[size_t(layer) * numFaces + face].assign(bytes.begin(), bytes.end());
+    }
+  }
+
+  UNWRAP_ERROR(image.allocate(numNewMips, numLayers, numFaces));
+
+  // Treat DDS UNORM formats the same way as KTX: only _SRGB formats are
+  // filtered in linear space unless the caller asks for sRGB.
+  const bool srgb = useSRGB(format, settings.colorSpace);
+  for(uint32_t layer = 0; layer < numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < numFaces; face++)
+    {
+      nv_dds::Subresource& mip0 = image.subresource(0, layer, face);
+      mip0.data                 = std::move(mip0s[size_t(layer) * numFaces + face]);
+      UNWRAP_ERROR(generateChain(layout, srgb, width, height, mip0.data, numNewMips, settings,
+                                 [&](uint32_t mip, std::vector<char>&& bytes) {
+                                   image.subresource(mip, layer, face).data = std::move(bytes);
+                                 }));
+    }
+  }
+  return {};
+}
+
+}  // namespace mip_generation
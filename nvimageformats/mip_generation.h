@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Provides CPU mip chain generation for uncompressed 2D images, for tools that
+can't use the GPU blit path in nvvk/mipmaps.cpp:
+* 8-bit and 16-bit UNORM (including _SRGB), 16-bit half float, and 32-bit
+  float formats with 1 to 4 channels.
+* Box, Kaiser, and Lanczos filters. Each mip is resampled from the
+  full-precision result of the previous mip, so odd dimensions (e.g. 5 -> 2)
+  are filtered with the correct footprint instead of dropping texels.
+* Gamma-correct filtering: sRGB color channels are converted to linear before
+  filtering and back afterwards; alpha is always filtered linearly.
+
+Use generateMips() to fill in the mips of an nv_ktx::KTXImage or
+nv_dds::Image from its mip 0, or downsample() for raw data. Rows are filtered
+in parallel on nvutils' thread pool; mips are generated one after another,
+since each is filtered from the previous one. There are no SIMD intrinsics:
+the vertical pass is written as flat loops over whole rows so that the
+compiler can auto-vectorize it, and the horizontal pass and format
+conversions are scalar.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+namespace nv_ktx {
+struct KTXImage;
+}
+namespace nv_dds {
+struct Image;
+}
+
+namespace mip_generation {
+
+// These functions return an empty std::optional if they succeeded, and a
+// value with text describing the error if they failed.
+using ErrorWithText = std::optional<std::string>;
+
+enum class Filter
+{
+  // Averages the source texels covered by each destination texel. Fastest.
+  eBox,
+  // A Kaiser-windowed sinc with a radius of 3 destination texels. Sharper
+  // than box filtering with little ringing; a good default for color data.
+  eKaiser,
+  // A 3-lobe Lanczos filter. The sharpest, with the most ringing.
+  eLanczos,
+};
+
+enum class ColorSpace
+{
+  // Filters the color channels in linear space if the format is _SRGB,
+  // and as-is otherwise.
+  eFromFormat,
+  // Filters all channels as-is.
+  eLinear,
+  // Treats color channels as sRGB-encoded, even if the format is UNORM.
+  // This is useful for DDS files, which by convention often store sRGB data
+  // in UNORM formats.
+  eSRGB,
+};
+
+struct Settings
+{
+  Filter     filter     = Filter::eKaiser;
+  ColorSpace colorSpace = ColorSpace::eFromFormat;
+  // The maximum number of mips to generate, including mip 0. 0 means a full
+  // mip chain, down to 1 x 1.
+  uint32_t maxMips = 0;
+  // The maximum number of threads to use; 0 means all of nvutils' thread
+  // pool, and 1 runs on the calling thread.
+  uint32_t numThreads = 0;
+};
+
+// Returns whether mips can be generated for images in the given VkFormat.
+bool isFormatSupported(VkFormat format);
+
+// Returns the number of mips in a full mip chain for an image of the given
+// size, including mip 0.
+uint32_t getFullMipCount(uint32_t width, uint32_t height);
+
+// Resamples a `srcWidth` x `srcHeight` image in the given format from `src`
+// to a `dstWidth` x `dstHeight` image in `dst`. Both are tightly packed.
+// Usually, dstWidth and dstHeight are max(1, srcWidth / 2) and
+// max(1, srcHeight / 2).
+ErrorWithText downsample(VkFormat              format,
+                         uint32_t              srcWidth,
+                         uint32_t              srcHeight,
+                         std::span<const char> src,
+                         uint32_t              dstWidth,
+                         uint32_t              dstHeight,
+                         std::span<char>       dst,
+                         const Settings&       settings = {});
+
+// Replaces all mips of `image` after mip 0 with mips generated from mip 0,
+// for each layer and face, and sets num_mips to the length of the new mip
+// chain. Clears app_should_generate_mips. 3D textures are not supported.
+// If this fails, `image` is unmodified unless reallocating it failed.
+ErrorWithText generateMips(nv_ktx::KTXImage& image, const Settings& settings = {});
+
+// Like the KTXImage version, but for a DDS image; the format is looked up
+// from its dxgiFormat.
+ErrorWithText generateMips(nv_dds::Image& image, const Settings& settings = {});
+
+}  // namespace mip_generation
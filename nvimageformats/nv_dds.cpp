@@ -850,6 +850,7 @@ ErrorWithText Subresource::create(size_t imageSizeBytes, const void* pixels)
     {
       data.resize(imageSizeBytes, 0);
     }
+    view = {};
   }
   catch(...)
   {
@@ -863,6 +864,15 @@ void Subresource::clear()
   *this = Subresource();
 }
 
+std::span<const char> Subresource::bytes() const
+{
+  if(view.data() != nullptr)
+  {
+    return view;
+  }
+  return data;
+}
+
 // Double-check some properties of Subresource.
 static_assert(std::is_move_assignable_v<Subresource>);
 static_assert(std::is_move_constructible_v<Subresource>);
@@ -1449,29 +1459,11 @@ ErrorWithText Image::readHeaderFromMemory(const char* buffer, size_t bufferSize,
   return readHeaderFromStream(stream, readSettings);
 }
 
-ErrorWithText Image::readFromStream(std::istream& input, const ReadSettings& readSettings)
+ErrorWithText Image::allocateForRead(const ReadSettings& readSettings, size_t validationInputSize, uint32_t& firstFileMip)
 {
-  UNWRAP_ERROR(readHeaderFromStream(input, readSettings));
-
-  size_t validationInputSize = 0;
-  if(readSettings.validateInputSize)
-  {
-    const std::streampos initialPos = input.tellg();
-    input.seekg(0, std::ios_base::end);
-    const std::streampos endPos = input.tellg();
-    validationInputSize         = endPos - initialPos;
-    input.seekg(initialPos, std::ios_base::beg);
-  }
-
-  // Create a short alias for m_fileInfo
-  const FileInfo& i = m_fileInfo;
-
-  // Crop the output to fewer mips if readSettings.mips was specified
   const uint32_t mipsInFile = m_numMips;
-  if(!readSettings.mips)
-  {
-    m_numMips = 1;
-  }
+  firstFileMip              = std::min(readSettings.firstMip, mipsInFile - 1);
+  m_numMips                 = std::min(mipsInFile - firstFileMip, readSettings.mips ? std::max(1U, readSettings.maxMips) : 1U);
 
   // Allocate space
   {
@@ -1493,6 +1485,129 @@ ErrorWithText Image::readFromStream(std::istream& input, const ReadSettings& rea
   }
   UNWRAP_ERROR(allocate(m_numMips, m_numLayers, m_numFaces));
 
+  // The first mip we read becomes mip 0.
+  getFileMipSize(firstFileMip, mip0Width, mip0Height, mip0Depth);
+  return {};
+}
+
+void Image::getFileMipSize(uint32_t fileMip, uint32_t& width, uint32_t& height, uint32_t& depth) const
+{
+  assert(fileMip < 32);
+  width  = std::max(1U, std::max(1U, m_fileInfo.ddsh.dwWidth) >> fileMip);
+  height = std::max(1U, std::max(1U, m_fileInfo.ddsh.dwHeight) >> fileMip);
+  depth  = std::max(1U, std::max(1U, m_fileInfo.ddsh.dwDepth) >> fileMip);
+}
+
+ErrorWithText Image::getFileSubresourceSize(uint32_t            fileMip,
+                                            const ReadSettings& readSettings,
+                                            size_t              validationInputSize,
+                                            size_t&             fileTexSize,
+                                            uint32_t&           bitmaskedBitsPerPixel) const
+{
+  // Create a short alias for m_fileInfo
+  const FileInfo& i = m_fileInfo;
+
+  // Compute the size of this image
+  uint32_t mipWidth = 0, mipHeight = 0, mipDepth = 0;
+  getFileMipSize(fileMip, mipWidth, mipHeight, mipDepth);
+  const uint32_t fileMip0Width = std::max(1U, i.ddsh.dwWidth);
+  // Compute size from DDS header.
+  // The DDS situation here is a bit of a mess. We prefer inferring this
+  // directly from the format and size; it's hard for writers to get
+  // that wrong. If there is no format, we use dwRGBBitCount here if it
+  // is nonzero. If it's not there, use dwPitchOrLinearSize.
+  fileTexSize           = 0;
+  bitmaskedBitsPerPixel = 0;
+  if(!i.wasBitmasked && dxgiFormat != 0)
+  {
+    if(!dxgiExportSize(mipWidth, mipHeight, mipDepth, dxgiFormat, fileTexSize))
+    {
+      return "Could not determine the number of bytes used by a subresource with size " + std::to_string(mipWidth)
+             + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth) + " and DXGI format "
+             + std::to_string(dxgiFormat) + ".";
+    }
+  }
+  else if(i.ddsh.ddspf.dwRGBBitCount != 0)
+  {
+    bitmaskedBitsPerPixel  = i.ddsh.ddspf.dwRGBBitCount;
+    size_t fileTexSizeBits = 0;
+    if(!checked_math::mul4(i.ddsh.ddspf.dwRGBBitCount, mipWidth, mipHeight, mipDepth, fileTexSizeBits)
+       || fileTexSizeBits > std::numeric_limits<size_t>::max() - 7)
+    {
+      return "This file is probably not valid: mip " + std::to_string(fileMip) + " (" + std::to_string(mipWidth)
+             + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth) + ", dwRGBBitCount == "
+             + std::to_string(i.ddsh.ddspf.dwRGBBitCount) + ") had more bits than would fit in a size_t.";
+    }
+    fileTexSize = (fileTexSizeBits + 7) / 8;
+  }
+  else
+  {
+    // Since this branch is uncompressed, dwPitchOrLinearSize is
+    // the number of bytes per scanline in the base mip.
+    // Try to get the number of bits per pixel, assuming images are
+    // densely packed.
+    if((i.ddsh.dwPitchOrLinearSize % fileMip0Width) != 0)
+    {
+      return "This file is probably not valid: it didn't seem to contain DXGI format information, and its dwRGBBitCount was 0. In this situation, dwPitchOrLinearSize should be the number of bits in each scanline of mip 0 - but it wasn't evenly divisible by mip 0's width.";
+    }
+    bitmaskedBitsPerPixel = i.ddsh.dwPitchOrLinearSize / fileMip0Width;
+    const uint32_t pitch  = bitmaskedBitsPerPixel * mipWidth;
+    if(!checked_math::mul3(pitch, mipHeight, mipDepth, fileTexSize))
+    {
+      return "This file is probably not valid: mip " + std::to_string(fileMip) + " (" + std::to_string(mipWidth)
+             + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
+             + ", pitch == " + std::to_string(pitch) + " had more bytes than would fit in a size_t.";
+    }
+  }
+
+  // Regardless of what we wind up with, a texture size of 0 is bad.
+  // See https://github.com/nvpro-samples/nvtt_samples/issues/2
+  // for how this can crash.
+  if(fileTexSize == 0)
+  {
+    return "This file is probably not valid: mip " + std::to_string(fileMip) + " (" + std::to_string(mipWidth)
+           + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
+           + ") contained 0 bytes of data. Is a DDS format missing from the header of this file?";
+  }
+  // Also, make sure this isn't impossibly large.
+  if(((fileTexSize / mipWidth) / mipHeight) / mipDepth > 16)
+  {
+    return "This file is probably not valid: mip " + std::to_string(fileMip) + " declared it contained "
+           + std::to_string(fileTexSize) + " bytes of data. However, that's larger than the number of bytes that a mip of size "
+           + std::to_string(mipWidth) + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
+           + " would contain using the largest DDS format, RGBA32F (which uses 16 bytes per pixel). Is a DDS format missing from the header of this file?";
+  }
+  // Or impermissibly large.
+  if(fileTexSize > readSettings.maxSubresourceSizeBytes)
+  {
+    return "Mip " + std::to_string(fileMip) + " (" + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
+           + " x " + std::to_string(mipDepth) + ") had more bytes (" + std::to_string(fileTexSize)
+           + ") than the maximum allowed in the DDS reader's parameters ("
+           + std::to_string(readSettings.maxSubresourceSizeBytes) + ").";
+  }
+  // Additionally, if we're reading mip 0, double-check that the file can
+  // reasonably contain at least mip 0's data.
+  if(readSettings.validateInputSize && fileTexSize > validationInputSize / (static_cast<size_t>(m_numLayers) * m_numFaces))
+  {
+    return "This file is probably not valid: each mip 0 subresource should contain " + std::to_string(fileTexSize)
+           + " bytes of data, and there are " + std::to_string(m_numLayers) + " layers and " + std::to_string(m_numFaces)
+           + " faces, but the input is only " + std::to_string(validationInputSize) + " bytes long.";
+  }
+  return {};
+}
+
+ErrorWithText Image::readFileSubresource(std::istream&       input,
+                                         const ReadSettings& readSettings,
+                                         uint32_t            fileMip,
+                                         size_t              fileTexSize,
+                                         uint32_t            bitmaskedBitsPerPixel,
+                                         Subresource&        resource)
+{
+  // Create a short alias for m_fileInfo
+  const FileInfo& i = m_fileInfo;
+  uint32_t        mipWidth = 0, mipHeight = 0, mipDepth = 0;
+  getFileMipSize(fileMip, mipWidth, mipHeight, mipDepth);
+
   // Precompute bitmasking weights, in case we use bitmasking.
   std::array<BitmaskMultiplier, 4> bitmaskMults;
   bitmaskMults[0] = getMultiplierFromChannelMask(i.ddsh.ddspf.dwRBitMask, i.bitmaskWasBumpDuDv);
@@ -1500,232 +1615,187 @@ ErrorWithText Image::readFromStream(std::istream& input, const ReadSettings& rea
   bitmaskMults[2] = getMultiplierFromChannelMask(i.ddsh.ddspf.dwBBitMask, i.bitmaskWasBumpDuDv);
   bitmaskMults[3] = getMultiplierFromChannelMask(i.ddsh.ddspf.dwABitMask, i.bitmaskWasBumpDuDv);
 
-  // Iterate over images in the DDS file. Read those images we want to
-  // read and skip over the rest.
-  for(uint32_t layer = 0; layer < m_numLayers; layer++)
+  if(i.wasBitmasked)
   {
-    for(uint32_t face = 0; face < m_numFaces; face++)
+    // Read old-style DDS format from bitmasks.
+    // Note that we support bitcounts (i.e. differences in bits between
+    // addresses of consecutive pixels) that are not divisible by 8!
+
+    // Start by reading the raw data into a buffer. We always add 7 bytes
+    // of padding so we don't need to perform bounds checks when reading
+    // across boundaries. (This is because if we read at a bit offset of
+    // 1, we'll read 31 bits from bytes 0-3, and load in 1 bit from bytes
+    // 4-7.)
+    if(fileTexSize > std::numeric_limits<size_t>::max() - 7)
     {
-      for(uint32_t inputMip = 0; inputMip < mipsInFile; inputMip++)
+      return "This file is probably not valid: mip " + std::to_string(fileMip)
+             + " declared it contained so much data that if 7 more bytes were added, its size would overflow a size_t.";
+    }
+    std::vector<uint8_t> fileData;
+    UNWRAP_ERROR(resizeVectorOrError(fileData, fileTexSize + 7));
+    if(!input.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileTexSize)))
+    {
+      return "Reading bitmasked data for an image in a DDS input failed. Is the input truncated?";
+    }
+
+    // Before we allocate data for the output, make sure it's also not
+    // too large.
+    assert(dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM || dxgiFormat == DXGI_FORMAT_R32G32B32A32_FLOAT);
+    size_t outputTexSize = 0;
+    if(!dxgiExportSize(mipWidth, mipHeight, mipDepth, dxgiFormat, outputTexSize) || outputTexSize > readSettings.maxSubresourceSizeBytes)
+    {
+      return "Mip " + std::to_string(fileMip) + " (" + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
+             + " x " + std::to_string(mipDepth) + ") was bitmasked and would have been decompressed to DXGI format "
+             + std::to_string(dxgiFormat) + "; that would have used more bytes than the maximum allowed in the DDS reader's parameters ("
+             + std::to_string(readSettings.maxSubresourceSizeBytes) + ").";
+    }
+
+    // Allocate the output:
+    UNWRAP_ERROR(resource.create(outputTexSize, nullptr));
+    char* outputData = resource.data.data();
+
+    // Now iterate over pixels:
+    size_t          bitPosition   = 0;
+    size_t          pixelIdx      = 0;
+    const uint32_t* fileDataBuf32 = reinterpret_cast<uint32_t*>(fileData.data());
+
+    std::array<float, 4> pixel = {0.0F, 0.0F, 0.0F, 1.0F};
+
+    for(size_t z = 0; z < mipDepth; ++z)
+    {
+      for(size_t y = 0; y < mipHeight; ++y)
       {
-        // Compute the size of this image
-        const uint32_t mipWidth  = getWidth(inputMip);
-        const uint32_t mipHeight = getHeight(inputMip);
-        const uint32_t mipDepth  = getDepth(inputMip);
-        // Compute size from DDS header.
-        // The DDS situation here is a bit of a mess. We prefer inferring this
-        // directly from the format and size; it's hard for writers to get
-        // that wrong. If there is no format, we use dwRGBBitCount here if it
-        // is nonzero. If it's not there, use dwPitchOrLinearSize.
-        size_t   fileTexSize           = 0;
-        uint32_t bitmaskedBitsPerPixel = 0;
-        if(!i.wasBitmasked && dxgiFormat != 0)
+        for(size_t x = 0; x < mipWidth; ++x)
         {
-          if(!dxgiExportSize(mipWidth, mipHeight, mipDepth, dxgiFormat, fileTexSize))
+          // Set dataBuf to 32 bits starting at bitPosition:
+          const size_t wordIndex = bitPosition % 32;
+          uint32_t     dataBuf   = fileDataBuf32[bitPosition / 32] >> wordIndex;
+          if(wordIndex != 0)
           {
-            return "Could not determine the number of bytes used by a subresource with size " + std::to_string(mipWidth)
-                   + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth) + " and DXGI format "
-                   + std::to_string(dxgiFormat) + ".";
+            dataBuf |= ((fileDataBuf32[bitPosition / 32 + 1]) << (32 - wordIndex));
           }
-        }
-        else if(i.ddsh.ddspf.dwRGBBitCount != 0)
-        {
-          bitmaskedBitsPerPixel  = i.ddsh.ddspf.dwRGBBitCount;
-          size_t fileTexSizeBits = 0;
-          if(!checked_math::mul4(i.ddsh.ddspf.dwRGBBitCount, mipWidth, mipHeight, mipDepth, fileTexSizeBits)
-             || fileTexSizeBits > std::numeric_limits<size_t>::max() - 7)
-          {
-            return "This file is probably not valid: mip " + std::to_string(inputMip) + " (" + std::to_string(mipWidth)
-                   + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth) + ", dwRGBBitCount == "
-                   + std::to_string(i.ddsh.ddspf.dwRGBBitCount) + ") had more bits than would fit in a size_t.";
-          }
-          fileTexSize = (fileTexSizeBits + 7) / 8;
-        }
-        else
-        {
-          // Since this branch is uncompressed, dwPitchOrLinearSize is
-          // the number of bytes per scanline in the base mip.
-          // Try to get the number of bits per pixel, assuming images are
-          // densely packed.
-          if((i.ddsh.dwPitchOrLinearSize % mip0Width) != 0)
+
+          // Decompress the pixel:
+          if(colorTransform == ColorTransform::eLuminance)
           {
-            return "This file is probably not valid: it didn't seem to contain DXGI format information, and its dwRGBBitCount was 0. In this situation, dwPitchOrLinearSize should be the number of bits in each scanline of mip 0 - but it wasn't evenly divisible by mip 0's width.";
+            const float v =
+                (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[0]) : bitsToUnorm(dataBuf, bitmaskMults[0]));
+            pixel[0] = pixel[1] = pixel[2] = v;
           }
-          bitmaskedBitsPerPixel = i.ddsh.dwPitchOrLinearSize / mip0Width;
-          const uint32_t pitch  = bitmaskedBitsPerPixel * mipWidth;
-          if(!checked_math::mul3(pitch, mipHeight, mipDepth, fileTexSize))
+          else if(i.bitmaskHasRgb)
           {
-            return "This file is probably not valid: mip " + std::to_string(inputMip) + " (" + std::to_string(mipWidth)
-                   + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
-                   + ", pitch == " + std::to_string(pitch) + " had more bytes than would fit in a size_t.";
+            for(int c = 0; c < 3; c++)
+            {
+              pixel[c] = (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[c]) :
+                                                 bitsToUnorm(dataBuf, bitmaskMults[c]));
+            }
           }
-        }
 
-        // Regardless of what we wind up with, a texture size of 0 is bad.
-        // See https://github.com/nvpro-samples/nvtt_samples/issues/2
-        // for how this can crash.
-        if(fileTexSize == 0)
-        {
-          return "This file is probably not valid: mip " + std::to_string(inputMip) + " (" + std::to_string(mipWidth)
-                 + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
-                 + ") contained 0 bytes of data. Is a DDS format missing from the header of this file?";
-        }
-        // Also, make sure this isn't impossibly large.
-        if(((fileTexSize / mipWidth) / mipHeight) / mipDepth > 16)
-        {
-          return "This file is probably not valid: mip " + std::to_string(inputMip) + " declared it contained "
-                 + std::to_string(fileTexSize) + " bytes of data. However, that's larger than the number of bytes that a mip of size "
-                 + std::to_string(mipWidth) + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
-                 + " would contain using the largest DDS format, RGBA32F (which uses 16 bytes per pixel). Is a DDS format missing from the header of this file?";
-        }
-        // Or impermissibly large.
-        if(fileTexSize > readSettings.maxSubresourceSizeBytes)
-        {
-          return "Mip " + std::to_string(inputMip) + " (" + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
-                 + " x " + std::to_string(mipDepth) + ") had more bytes (" + std::to_string(fileTexSize)
-                 + ") than the maximum allowed in the DDS reader's parameters ("
-                 + std::to_string(readSettings.maxSubresourceSizeBytes) + ").";
-        }
-        // Additionally, if we're reading mip 0, double-check that the file can
-        // reasonably contain at least mip 0's data.
-        if(readSettings.validateInputSize && fileTexSize > validationInputSize / (static_cast<size_t>(m_numLayers) * m_numFaces))
-        {
-          return "This file is probably not valid: each mip 0 subresource should contain " + std::to_string(fileTexSize)
-                 + " bytes of data, and there are " + std::to_string(m_numLayers) + " layers and " + std::to_string(m_numFaces)
-                 + " faces, but the input is only " + std::to_string(validationInputSize) + " bytes long.";
-        }
-
-        const bool readData = (inputMip < m_numMips);
-        if(!readData)
-        {
-          // Just go to the next image.
-          if(!input.seekg(static_cast<std::streamoff>(fileTexSize), std::ios::cur))
+          if(i.bitmaskHasAlpha)
           {
-            return "Seeking to an image in a DDS input failed. Is the input truncated?";
+            pixel[3] =
+                (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[3]) : bitsToUnorm(dataBuf, bitmaskMults[3]));
           }
-          continue;
-        }
 
-        Subresource& resource = subresource(inputMip, layer, face);
-        if(i.wasBitmasked)
-        {
-          // Read old-style DDS format from bitmasks.
-          // Note that we support bitcounts (i.e. differences in bits between
-          // addresses of consecutive pixels) that are not divisible by 8!
-
-          // Start by reading the raw data into a buffer. We always add 7 bytes
-          // of padding so we don't need to perform bounds checks when reading
-          // across boundaries. (This is because if we read at a bit offset of
-          // 1, we'll read 31 bits from bytes 0-3, and load in 1 bit from bytes
-          // 4-7.)
-          if(fileTexSize > std::numeric_limits<size_t>::max() - 7)
+          // Transform it to our output format:
+          if(dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM)
           {
-            return "This file is probably not valid: mip " + std::to_string(inputMip)
-                   + " declared it contained so much data that if 7 more bytes were added, its size would overflow a size_t.";
+            // RGBA8
+            uint8_t* outputPixelData = reinterpret_cast<uint8_t*>(outputData) + 4 * pixelIdx;
+            for(int c = 0; c < 4; c++)
+            {
+              // We use centered quantization here:
+              outputPixelData[c] = static_cast<uint8_t>(std::roundf(pixel[c] * 255.0F));
+            }
           }
-          std::vector<uint8_t> fileData;
-          UNWRAP_ERROR(resizeVectorOrError(fileData, fileTexSize + 7));
-          if(!input.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileTexSize)))
+          else
           {
-            return "Reading bitmasked data for an image in a DDS input failed. Is the input truncated?";
+            // RGBAF32
+            float* outputPixelData = reinterpret_cast<float*>(outputData) + 4 * pixelIdx;
+            for(int c = 0; c < 4; c++)
+            {
+              outputPixelData[c] = pixel[c];
+            }
           }
 
-          // Before we allocate data for the output, make sure it's also not
-          // too large.
-          assert(dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM || dxgiFormat == DXGI_FORMAT_R32G32B32A32_FLOAT);
-          size_t outputTexSize = 0;
-          if(!dxgiExportSize(mipWidth, mipHeight, mipDepth, dxgiFormat, outputTexSize) || outputTexSize > readSettings.maxSubresourceSizeBytes)
-          {
-            return "Mip " + std::to_string(inputMip) + " (" + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
-                   + " x " + std::to_string(mipDepth) + ") was bitmasked and would have been decompressed to DXGI format "
-                   + std::to_string(dxgiFormat) + "; that would have used more bytes than the maximum allowed in the DDS reader's parameters ("
-                   + std::to_string(readSettings.maxSubresourceSizeBytes) + ").";
-          }
+          bitPosition += bitmaskedBitsPerPixel;
+          pixelIdx++;
+        }
+      }
+    }
+  }
+  else
+  {
+    // Fast path: not bitmasked; read it directly from the input into
+    // the subresource, or view it if reading from memory.
+    if(!m_viewSource.empty())
+    {
+      const std::streamoff pos = input.tellg();
+      if(pos < 0 || static_cast<size_t>(pos) > m_viewSource.size()
+         || fileTexSize > m_viewSource.size() - static_cast<size_t>(pos))
+      {
+        return "Copying data for an image in a DDS input failed. Is the input truncated?";
+      }
+      resource.clear();
+      resource.view = m_viewSource.subspan(static_cast<size_t>(pos), fileTexSize);
+      input.seekg(static_cast<std::streamoff>(fileTexSize), std::ios_base::cur);
+    }
+    else
+    {
+      UNWRAP_ERROR(resource.create(fileTexSize, nullptr));
+      if(!input.read(resource.data.data(), static_cast<std::streamsize>(fileTexSize)))
+      {
+        return "Copying data for an image in a DDS input failed. Is the input truncated?";
+      }
+    }
+  }
+  return {};
+}
 
-          // Allocate the output:
-          UNWRAP_ERROR(resource.create(outputTexSize, nullptr));
-          char* outputData = resource.data.data();
+ErrorWithText Image::readFromStream(std::istream& input, const ReadSettings& readSettings)
+{
+  UNWRAP_ERROR(readHeaderFromStream(input, readSettings));
 
-          // Now iterate over pixels:
-          size_t          bitPosition   = 0;
-          size_t          pixelIdx      = 0;
-          const uint32_t* fileDataBuf32 = reinterpret_cast<uint32_t*>(fileData.data());
+  size_t validationInputSize = 0;
+  if(readSettings.validateInputSize)
+  {
+    const std::streampos initialPos = input.tellg();
+    input.seekg(0, std::ios_base::end);
+    const std::streampos endPos = input.tellg();
+    validationInputSize         = endPos - initialPos;
+    input.seekg(initialPos, std::ios_base::beg);
+  }
 
-          std::array<float, 4> pixel = {0.0F, 0.0F, 0.0F, 1.0F};
+  // Crop the output to the range of mips from readSettings
+  const uint32_t mipsInFile   = m_numMips;
+  uint32_t       firstFileMip = 0;
+  UNWRAP_ERROR(allocateForRead(readSettings, validationInputSize, firstFileMip));
 
-          for(size_t z = 0; z < mipDepth; ++z)
-          {
-            for(size_t y = 0; y < mipHeight; ++y)
-            {
-              for(size_t x = 0; x < mipWidth; ++x)
-              {
-                // Set dataBuf to 32 bits starting at bitPosition:
-                const size_t wordIndex = bitPosition % 32;
-                uint32_t     dataBuf   = fileDataBuf32[bitPosition / 32] >> wordIndex;
-                if(wordIndex != 0)
-                {
-                  dataBuf |= ((fileDataBuf32[bitPosition / 32 + 1]) << (32 - wordIndex));
-                }
-
-                // Decompress the pixel:
-                if(colorTransform == ColorTransform::eLuminance)
-                {
-                  const float v =
-                      (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[0]) : bitsToUnorm(dataBuf, bitmaskMults[0]));
-                  pixel[0] = pixel[1] = pixel[2] = v;
-                }
-                else if(i.bitmaskHasRgb)
-                {
-                  for(int c = 0; c < 3; c++)
-                  {
-                    pixel[c] = (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[c]) :
-                                                       bitsToUnorm(dataBuf, bitmaskMults[c]));
-                  }
-                }
-
-                if(i.bitmaskHasAlpha)
-                {
-                  pixel[3] =
-                      (i.bitmaskWasBumpDuDv ? bitsToSnorm(dataBuf, bitmaskMults[3]) : bitsToUnorm(dataBuf, bitmaskMults[3]));
-                }
-
-                // Transform it to our output format:
-                if(dxgiFormat == DXGI_FORMAT_R8G8B8A8_UNORM)
-                {
-                  // RGBA8
-                  uint8_t* outputPixelData = reinterpret_cast<uint8_t*>(outputData) + 4 * pixelIdx;
-                  for(int c = 0; c < 4; c++)
-                  {
-                    // We use centered quantization here:
-                    outputPixelData[c] = static_cast<uint8_t>(std::roundf(pixel[c] * 255.0F));
-                  }
-                }
-                else
-                {
-                  // RGBAF32
-                  float* outputPixelData = reinterpret_cast<float*>(outputData) + 4 * pixelIdx;
-                  for(int c = 0; c < 4; c++)
-                  {
-                    outputPixelData[c] = pixel[c];
-                  }
-                }
-
-                bitPosition += bitmaskedBitsPerPixel;
-                pixelIdx++;
-              }
-            }
-          }
-        }
-        else
+  // Iterate over images in the DDS file. Read those images we want to
+  // read and skip over the rest.
+  for(uint32_t layer = 0; layer < m_numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < m_numFaces; face++)
+    {
+      for(uint32_t inputMip = 0; inputMip < mipsInFile; inputMip++)
+      {
+        size_t   fileTexSize           = 0;
+        uint32_t bitmaskedBitsPerPixel = 0;
+        UNWRAP_ERROR(getFileSubresourceSize(inputMip, readSettings, validationInputSize, fileTexSize, bitmaskedBitsPerPixel));
+
+        const bool readData = (inputMip >= firstFileMip && inputMip - firstFileMip < m_numMips);
+        if(!readData)
         {
-          // Fast path: not bitmasked; read it directly from the input into
-          // the subresource.
-          UNWRAP_ERROR(resource.create(fileTexSize, nullptr));
-          if(!input.read(resource.data.data(), static_cast<std::streamsize>(fileTexSize)))
+          // Just go to the next image.
+          if(!input.seekg(static_cast<std::streamoff>(fileTexSize), std::ios::cur))
           {
-            return "Copying data for an image in a DDS input failed. Is the input truncated?";
+            return "Seeking to an image in a DDS input failed. Is the input truncated?";
           }
+          continue;
         }
+
+        UNWRAP_ERROR(readFileSubresource(input, readSettings, inputMip, fileTexSize, bitmaskedBitsPerPixel,
+                                         subresource(inputMip - firstFileMip, layer, face)));
       }
     }
   }
@@ -1755,6 +1825,20 @@ ErrorWithText Image::readFromMemory(const char* buffer, size_t bufferSize, const
   return readFromStream(stream, readSettings);
 }
 
+ErrorWithText Image::readFromMemoryView(std::span<const std::byte> input, const ReadSettings& readSettings)
+{
+  if(input.size() > static_cast<size_t>(std::numeric_limits<std::streamsize>::max()))
+  {
+    return "The `input` parameter was too large to be stored in an std::streamsize.";
+  }
+  const char*  buffer = reinterpret_cast<const char*>(input.data());
+  MemoryStream stream(buffer, static_cast<std::streamsize>(input.size()));
+  m_viewSource                   = std::span<const char>(buffer, input.size());
+  const ErrorWithText maybeError = readFromStream(stream, readSettings);
+  m_viewSource                   = {};
+  return maybeError;
+}
+
 ErrorWithText Image::writeToStream(std::ostream& output, const WriteSettings& writeSettings)
 {
   //---------------------------------------------------------------------------
@@ -2003,7 +2087,7 @@ ErrorWithText Image::writeToStream(std::ostream& output, const WriteSettings& wr
     {
       for(uint32_t mip = 0; mip < m_numMips; mip++)
       {
-        const std::vector<char>& data = subresource(mip, layer, face).data;
+        const std::span<const char> data = subresource(mip, layer, face).bytes();
         if(!output.write(data.data(), static_cast<std::streamoff>(data.size())))
         {
           return "Could not write data for mip " + std::to_string(mip) + ", face " + std::to_string(face) + ", layer "
@@ -2306,6 +2390,131 @@ std::string Image::formatInfo() const
   return s.str();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// LevelReader implementation
+///////////////////////////////////////////////////////////////////////////////
+
+ErrorWithText LevelReader::open(std::istream& input, const ReadSettings& readSettings)
+{
+  m_input        = &input;
+  m_readSettings = readSettings;
+  m_fileTexSizes.clear();
+  m_bitmaskedBitsPerPixel.clear();
+  m_offsets.clear();
+  m_mipsRead.clear();
+  image.clear();
+
+  UNWRAP_ERROR(image.readHeaderFromStream(input, readSettings));
+
+  size_t validationInputSize = 0;
+  if(readSettings.validateInputSize)
+  {
+    const std::streampos initialPos = input.tellg();
+    input.seekg(0, std::ios_base::end);
+    const std::streampos endPos = input.tellg();
+    validationInputSize         = endPos - initialPos;
+    input.seekg(initialPos, std::ios_base::beg);
+  }
+
+  const uint32_t mipsInFile = image.m_numMips;
+  UNWRAP_ERROR(image.allocateForRead(readSettings, validationInputSize, m_firstFileMip));
+  const uint32_t numMips   = image.m_numMips;
+  const uint32_t numLayers = image.m_numLayers;
+  const uint32_t numFaces  = image.m_numFaces;
+
+  // Walk the file's layout (layers, then faces, then mips) without reading
+  // any data, recording where each subresource we'll read starts.
+  size_t numSubresources = 0;
+  if(!checked_math::mul3(numLayers, numFaces, numMips, numSubresources))
+  {
+    return "The total number of subresources was too large to fit in a size_t.";
+  }
+  UNWRAP_ERROR(resizeVectorOrError(m_offsets, numSubresources));
+  UNWRAP_ERROR(resizeVectorOrError(m_fileTexSizes, numMips));
+  UNWRAP_ERROR(resizeVectorOrError(m_bitmaskedBitsPerPixel, numMips));
+  std::streamoff position = static_cast<std::streamoff>(input.tellg());
+  for(uint32_t layer = 0; layer < numLayers; layer++)
+  {
+    for(uint32_t face = 0; face < numFaces; face++)
+    {
+      for(uint32_t fileMip = 0; fileMip < mipsInFile; fileMip++)
+      {
+        size_t   fileTexSize           = 0;
+        uint32_t bitmaskedBitsPerPixel = 0;
+        UNWRAP_ERROR(image.getFileSubresourceSize(fileMip, readSettings, validationInputSize, fileTexSize, bitmaskedBitsPerPixel));
+        if(fileMip >= m_firstFileMip && fileMip - m_firstFileMip < numMips)
+        {
+          const uint32_t mip = fileMip - m_firstFileMip;
+          m_offsets[(static_cast<size_t>(layer) * numFaces + face) * numMips + mip] = position;
+          m_fileTexSizes[mip]                                                       = fileTexSize;
+          m_bitmaskedBitsPerPixel[mip]                                              = bitmaskedBitsPerPixel;
+        }
+        if(fileTexSize > static_cast<size_t>(std::numeric_limits<std::streamoff>::max() - position))
+        {
+          return "This file is probably not valid: its subresources would end past the largest possible stream position.";
+        }
+        position += static_cast<std::streamoff>(fileTexSize);
+      }
+    }
+  }
+
+  m_mipsRead.resize(numMips, false);
+  return {};
+}
+
+ErrorWithText LevelReader::openFile(const char* filename, const ReadSettings& readSettings)
+{
+  try
+  {
+    m_file = std::make_unique<std::ifstream>(filename, std::ios::binary | std::ios::in);
+    return open(*m_file, readSettings);
+  }
+  catch(const std::exception& e)
+  {
+    return "I/O error opening " + std::string(filename) + ": " + std::string(e.what());
+  }
+}
+
+ErrorWithText LevelReader::readMips(uint32_t firstMip, uint32_t mipCount)
+{
+  if(m_input == nullptr || m_mipsRead.empty())
+  {
+    return "LevelReader::readMips() was called without successfully opening a DDS file first.";
+  }
+  const uint32_t numMips = image.getNumMips();
+  if(firstMip >= numMips || mipCount > numMips - firstMip)
+  {
+    return "Tried to read mips " + std::to_string(firstMip) + " up to " + std::to_string(uint64_t(firstMip) + mipCount)
+           + " of a DDS image with " + std::to_string(numMips) + " mips.";
+  }
+
+  // Clear errors from previous reads, such as reaching the end of the stream.
+  m_input->clear();
+  for(uint32_t mip = firstMip; mip < firstMip + mipCount; mip++)
+  {
+    for(uint32_t layer = 0; layer < image.getNumLayers(); layer++)
+    {
+      for(uint32_t face = 0; face < image.getNumFaces(); face++)
+      {
+        const std::streamoff offset = m_offsets[(static_cast<size_t>(layer) * image.getNumFaces() + face) * numMips + mip];
+        if(!m_input->seekg(offset, std::ios::beg))
+        {
+          return "Seeking to an image in a DDS input failed. Is the input truncated?";
+        }
+        UNWRAP_ERROR(image.readFileSubresource(*m_input, m_readSettings, mip + m_firstFileMip, m_fileTexSizes[mip],
+                                               m_bitmaskedBitsPerPixel[mip], image.subresource(mip, layer, face)));
+      }
+    }
+    m_mipsRead[mip] = true;
+  }
+  return {};
+}
+
+bool LevelReader::isMipRead(uint32_t mip) const
+{
+  return mip < m_mipsRead.size() && m_mipsRead[mip];
+}
+
 }  // namespace nv_dds
 
 //-----------------------------------------------------------------------------
@@ -29,7 +29,11 @@ dxgiformat.h, nv_dds.h, nv_dds.cpp, texture_formats.h, and texture_formats.cpp.
 For example code, please see `usage_nv_dds()` at the end of nv_dds.h.
 
 To load a DDS file, use `Image::readFromFile()`, then use `Image::subresource()`
-to access subresources (for instance, to upload them to the GPU).
+to access subresources (for instance, to upload them to the GPU). To load DDS
+data that's already in memory without copying it, use
+`Image::readFromMemoryView()` and `Subresource::bytes()`. To load a range of
+mips, see `ReadSettings::firstMip` and `maxMips`; to load mips on demand (for
+instance, smallest first for texture streaming), use `LevelReader`.
 
 `Image`'s format field is a DXGI format. If you need to use this data with
 another API, you can use the functions in texture_formats.h to look up
@@ -75,7 +79,9 @@ absolutely necessary, consider using a library such as NVTT.)
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -222,8 +228,13 @@ struct Subresource
   ErrorWithText create(size_t imageSizeBytes, const void* pixels);
   // Frees image data and resets the size.
   void clear();
+  // Returns the image's raw data: `view` if it's set, `data` otherwise.
+  std::span<const char> bytes() const;
 
   std::vector<char> data;  // The image's raw data.
+  // After Image::readFromMemoryView(), the image's raw data in the caller's
+  // memory, when it could be used without conversion; `data` is then empty.
+  std::span<const char> view;
 };
 
 // Contains all the settings for reading DDS files.
@@ -239,6 +250,13 @@ struct ReadSettings
   bool validateInputSize = true;
   // Whether mips should be read beyond the base mip.
   bool mips = true;
+  // The first mip in the file to read. Mips before it are skipped without
+  // being read, and it becomes the image's mip 0 (so mip0Width, mip0Height,
+  // and mip0Depth are its size). This is clamped to the file's last mip.
+  uint32_t firstMip = 0;
+  // The maximum number of mips to read, starting at firstMip. 0 is treated
+  // as 1, and `mips == false` limits this to 1.
+  uint32_t maxMips = UINT32_MAX;
   // Makes the DDS reader always decompress bitmasked DDS files to
   // DXGI_FORMAT_R32G32B32A32_SFLOAT.
   //
@@ -356,6 +374,13 @@ public:
                                size_t              bufferSize,     // Its length in bytes.
                                const ReadSettings& readSettings);  // Settings for the reader.
 
+  // Like readFromMemory, but subresources that need no bitmask decompression
+  // view `input` through Subresource::view instead of being copied into
+  // Subresource::data. `input` must outlive these views; use
+  // Subresource::bytes() to access data either way.
+  ErrorWithText readFromMemoryView(std::span<const std::byte> input,          // The DDS data.
+                                   const ReadSettings&        readSettings);  // Settings for the reader.
+
 
   // Writes this structure in DDS format to a stream.
   ErrorWithText writeToStream(std::ostream&        output,          // The output stream, at the point to start writing
@@ -400,7 +425,7 @@ public:
   inline size_t getSize() const
   {
     assert(!m_data.empty());
-    return m_data[0].data.size();
+    return m_data[0].bytes().size();
   }
 
   // Returns the number of mips (levels) in the image, including the base mip.
@@ -487,17 +512,85 @@ public:
   uint32_t userVersion    = 0;
 
 private:
+  friend class LevelReader;
+
+  // Helpers for reading. allocateForRead applies the mip range in
+  // `readSettings` to the mips in the header and allocates the image;
+  // getFileMipSize returns the size of a mip in the file, before that range
+  // was applied. getFileSubresourceSize computes and validates the number of
+  // bytes that each subresource of a mip uses in the file, and
+  // readFileSubresource reads one from the current position of `input`.
+  ErrorWithText allocateForRead(const ReadSettings& readSettings, size_t validationInputSize, uint32_t& firstFileMip);
+  void          getFileMipSize(uint32_t fileMip, uint32_t& width, uint32_t& height, uint32_t& depth) const;
+  ErrorWithText getFileSubresourceSize(uint32_t            fileMip,
+                                       const ReadSettings& readSettings,
+                                       size_t              validationInputSize,
+                                       size_t&             fileTexSize,
+                                       uint32_t&           bitmaskedBitsPerPixel) const;
+  ErrorWithText readFileSubresource(std::istream&       input,
+                                    const ReadSettings& readSettings,
+                                    uint32_t            fileMip,
+                                    size_t              fileTexSize,
+                                    uint32_t            bitmaskedBitsPerPixel,
+                                    Subresource&        resource);
+
   uint32_t m_numMips   = 1;
   uint32_t m_numLayers = 1;
   uint32_t m_numFaces  = 1;
 
   FileInfo m_fileInfo = {};
 
+  // While readFromMemoryView() is running, the memory it reads from.
+  std::span<const char> m_viewSource;
+
   // A structure containing all the image's encoded data. We store this in a
   // buffer with an entry per subresource, and provide accessors to it.
   std::vector<Subresource> m_data;
 };
 
+// Reads the mips of a DDS file on demand. open() reads the header once,
+// computes where each subresource is in the file, and allocates `image`
+// without data; readMips() then seeks to and reads only the requested mips.
+// For instance, a texture streamer could read the smallest mips first for a
+// low-resolution preview, then read larger mips as needed.
+class LevelReader
+{
+public:
+  // Reads the header of a DDS stream into `image`. `input` must stay valid
+  // until this reader is destroyed or opened again. readSettings.firstMip and
+  // maxMips select which mips of the file `image` will contain.
+  ErrorWithText open(std::istream&       input,          // The input stream, at the start of the DDS data.
+                     const ReadSettings& readSettings);  // Settings for the reader.
+  // Wrapper for open() for a file; the reader keeps the file open.
+  ErrorWithText openFile(const char*         filename,       // The .dds file to read from.
+                         const ReadSettings& readSettings);  // Settings for the reader.
+
+  // Reads mips [firstMip, firstMip + mipCount) of `image` (in image mip
+  // numbering) into its subresources. Mips can be read in any order, and
+  // reading a mip again replaces its data.
+  ErrorWithText readMips(uint32_t firstMip, uint32_t mipCount = 1);
+
+  // Returns whether readMips() has successfully read the given mip.
+  bool isMipRead(uint32_t mip) const;
+
+  // The image's metadata after open(), and its subresources after readMips().
+  Image image;
+
+private:
+  std::unique_ptr<std::istream> m_file;  // Set by openFile()
+  std::istream*                 m_input = nullptr;
+  ReadSettings                  m_readSettings;
+  uint32_t                      m_firstFileMip = 0;
+  // For each mip of `image`, the size and bits per pixel of its subresources
+  // in the file.
+  std::vector<size_t>   m_fileTexSizes;
+  std::vector<uint32_t> m_bitmaskedBitsPerPixel;
+  // For each subresource of `image`, indexed by (layer, face, mip), its
+  // position in the stream.
+  std::vector<std::streamoff> m_offsets;
+  std::vector<bool>           m_mipsRead;
+};
+
 //-----------------------------------------------------------------------------
 // These values are included for convenience, if you need to visualize the
 // contents of the DDS header.
@@ -24,9 +24,12 @@
 #include <atomic>
 #include <cassert>  // Some functions produce assertion errors to assist with debugging when NDEBUG is false.
 #include <fstream>
+#include <list>
 #include <mutex>
 #include <sstream>
 #include <string.h>  // memcpy
+#include <string_view>
+#include <unordered_map>
 #include <vulkan/vulkan_core.h>
 #ifdef NVP_SUPPORTS_ZSTD
 #include <zstd.h>
@@ -42,7 +45,11 @@
 #endif
 #endif
 
+#include "nvutils/hash_operations.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/sha256.hpp"
 #include "third_party/khr_df/khr_df.h"
+#include "texture_decode.h"
 #include "texture_formats.h"
 
 namespace nv_ktx {
@@ -85,6 +92,29 @@ bool GetNumSubresources(size_t a, size_t b, size_t c, size_t& out)
 {
   return checked_math::mul3(std::max(a, size_t(1)), std::max(b, size_t(1)), std::max(c, size_t(1)), out);
 }
+
+// Returns the format ASTC data in `format` should be decoded to according to
+// ReadSettings::decode_astc_without_device_support, or VK_FORMAT_UNDEFINED if
+// it should be kept as-is.
+VkFormat GetASTCFallbackFormat(VkFormat format, const ReadSettings& readSettings)
+{
+  if(!readSettings.decode_astc_without_device_support || readSettings.device_supports_astc
+     || !texture_decode::isDecodeSupported(format))
+  {
+    return VK_FORMAT_UNDEFINED;
+  }
+  if(format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+  {
+    // UNORM and SRGB formats alternate, starting with 4x4 UNORM.
+    const bool srgb = (uint32_t(format) - uint32_t(VK_FORMAT_ASTC_4x4_UNORM_BLOCK)) % 2 == 1;
+    return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+  }
+  if(format >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK && format <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK)
+  {
+    return VK_FORMAT_R16G16B16A16_SFLOAT;
+  }
+  return VK_FORMAT_UNDEFINED;
+}
 }  // namespace
 
 ErrorWithText KTXImage::allocate(uint32_t _num_mips, uint32_t _num_layers, uint32_t _num_faces)
@@ -100,15 +130,23 @@ ErrorWithText KTXImage::allocate(uint32_t _num_mips, uint32_t _num_layers, uint3
   {
     return "Computing the required number of subresources overflowed a size_t!";
   }
+  // Previously read views don't apply to the new layout.
+  views.clear();
+  ErrorWithText maybeError = ResizeVectorOrError(views, num_subresources);
+  if(maybeError.has_value())
+  {
+    return maybeError;
+  }
   return ResizeVectorOrError(data, num_subresources);
 }
 
 void KTXImage::clear()
 {
   data.clear();
+  views.clear();
 }
 
-std::vector<char>& KTXImage::subresource(uint32_t mip, uint32_t layer, uint32_t face)
+size_t KTXImage::subresourceIndex(uint32_t mip, uint32_t layer, uint32_t face) const
 {
   const uint32_t num_mips_clamped   = std::max(num_mips, 1U);
   const uint32_t num_layers_clamped = std::max(num_layers_possibly_0, 1U);
@@ -119,7 +157,29 @@ std::vector<char>& KTXImage::subresource(uint32_t mip, uint32_t layer, uint32_t
 
   // Here's the layout for data that we use. Note that we store the lowest mips
   // (mip 0) first, while the KTX format stores the highest mips first.
-  return data[(size_t(mip) * size_t(num_layers_clamped) + size_t(layer)) * size_t(num_faces) + size_t(face)];
+  return (size_t(mip) * size_t(num_layers_clamped) + size_t(layer)) * size_t(num_faces) + size_t(face);
+}
+
+std::vector<char>& KTXImage::subresource(uint32_t mip, uint32_t layer, uint32_t face)
+{
+  const size_t index = subresourceIndex(mip, layer, face);
+  // Views can't be modified, so copy them into their subresource first.
+  if(index < views.size() && views[index].data() != nullptr)
+  {
+    data[index].assign(views[index].begin(), views[index].end());
+    views[index] = {};
+  }
+  return data[index];
+}
+
+std::span<const char> KTXImage::subresourceBytes(uint32_t mip, uint32_t layer, uint32_t face) const
+{
+  const size_t index = subresourceIndex(mip, layer, face);
+  if(index < views.size() && views[index].data() != nullptr)
+  {
+    return views[index];
+  }
+  return data[index];
 }
 
 VkImageType KTXImage::getImageType() const
@@ -166,6 +226,74 @@ size_t RoundUp(size_t value, size_t multiplier)
   return value + (multiplier - mod);
 }
 
+// Supports an std::istream interface over read-only memory, without copying it.
+// Used by readFromMemoryView().
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+  MemoryStreamBuffer(std::span<const char> memory)
+  {
+    char* begin = const_cast<char*>(memory.data());  // The get area is never written to
+    setg(begin, begin, begin + memory.size());
+  }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override
+  {
+    const off_type size = egptr() - eback();
+    off_type       pos  = off;
+    if(dir == std::ios_base::cur)
+      pos += gptr() - eback();
+    else if(dir == std::ios_base::end)
+      pos += size;
+    if(pos < 0 || pos > size)
+      return pos_type(off_type(-1));
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+  }
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+
+// When reading from a MemoryStreamBuffer over `source`, sets `outView` to the
+// next `numBytes` bytes of `source` and advances `input` past them, as if
+// they had been read. Returns false and sets the stream's failbit if the input
+// was too short.
+bool ViewFromStream(std::istream& input, std::span<const char> source, uint64_t numBytes, std::span<const char>& outView)
+{
+  const std::streamoff pos = input.tellg();
+  if(pos < 0 || uint64_t(pos) > source.size() || numBytes > source.size() - uint64_t(pos))
+  {
+    input.setstate(std::ios_base::failbit);
+    return false;
+  }
+  outView = source.subspan(size_t(pos), size_t(numBytes));
+  input.seekg(std::streamoff(numBytes), std::ios_base::cur);
+  return true;
+}
+
+// Applies ReadSettings::mips, first_mip, and max_mips to a file with
+// `file_num_mips` >= 1 mips. Returns the first mip in the file to read, and
+// sets `num_mips_to_read` to the number of mips to read.
+uint32_t GetMipRangeToRead(uint32_t file_num_mips, const ReadSettings& readSettings, uint32_t& num_mips_to_read)
+{
+  const uint32_t first_mip     = std::min(readSettings.first_mip, file_num_mips - 1);
+  const uint32_t max_mip_count = (readSettings.mips ? std::max(1u, readSettings.max_mips) : 1u);
+  num_mips_to_read             = std::min(file_num_mips - first_mip, max_mip_count);
+  return first_mip;
+}
+
+// Returns the size of a texture dimension at the given mip; a size of 0
+// (indicating the texture doesn't have that dimension) stays 0.
+uint32_t MipDimensionPossibly0(uint32_t mip_0_dimension, uint32_t mip)
+{
+  if(mip_0_dimension == 0)
+    return 0;
+  return std::max(1u, mip_0_dimension >> mip);
+}
+
 // Basic Data Format Descriptor from the Khronos Data Format,
 // without sample information.
 struct BasicDataFormatDescriptor
@@ -747,12 +875,13 @@ ErrorWithText KTXImage::readFromKTX1Stream(std::istream& input, const ReadSettin
     header.numberOfMipmapLevels = 1;
   }
   // Because KTX1 files store mips from largest to smallest (as opposed to KTX2),
-  // we can handle readSettings.mips by truncating num_mips.
-  if(!readSettings.mips)
-  {
-    header.numberOfMipmapLevels = 1;
-  }
-  num_mips = (readSettings.mips ? header.numberOfMipmapLevels : 1);
+  // we can handle the mip range by skipping the first mips and truncating
+  // numberOfMipmapLevels.
+  const uint32_t first_file_mip = GetMipRangeToRead(header.numberOfMipmapLevels, readSettings, num_mips);
+  header.numberOfMipmapLevels   = first_file_mip + num_mips;
+  mip_0_width                   = MipDimensionPossibly0(header.pixelWidth, first_file_mip);
+  mip_0_height                  = MipDimensionPossibly0(header.pixelHeight, first_file_mip);
+  mip_0_depth                   = MipDimensionPossibly0(header.pixelDepth, first_file_mip);
   // Keep track of the special case where we have padding with non-array cubemap textures:
   const bool isArray = (header.numberOfArrayElements != 0);
   if(!isArray)
@@ -863,25 +992,43 @@ ErrorWithText KTXImage::readFromKTX1Stream(std::istream& input, const ReadSettin
     {
       for(uint32_t face = 0; face < header.numberOfFaces; face++)
       {
-        // Allocate storage for the encoded face
-        std::vector<char>& faceBuffer = subresource(mip, array_element, face);
-        ErrorWithText      maybeError = ResizeVectorOrError(faceBuffer, faceSizeBytes);
-        if(maybeError.has_value())
+        // Skip faces of mips before the range to read.
+        if(mip < first_file_mip)
         {
-          return "Allocating encoded data for mip " + std::to_string(mip) + " layer " + std::to_string(array_element)
-                 + " face " + std::to_string(face) + " failed (probably out of memory).";
+          input.seekg(std::streamoff(faceSizeBytes), std::ios_base::cur);
         }
-
-        if(!input.read(faceBuffer.data(), faceSizeBytes))
+        // When reading from memory, we can view the face if it needs no
+        // endianness swapping.
+        else if(!view_source.empty() && !needsSwapEndian)
         {
-          return "Reading mip " + std::to_string(mip) + " layer " + std::to_string(array_element) + " face "
-                 + std::to_string(face) + " failed (is the file truncated)?";
+          if(!ViewFromStream(input, view_source, faceSizeBytes, views[subresourceIndex(mip - first_file_mip, array_element, face)]))
+          {
+            return "Reading mip " + std::to_string(mip) + " layer " + std::to_string(array_element) + " face "
+                   + std::to_string(face) + " failed (is the file truncated)?";
+          }
         }
-
-        // Apply endianness swapping
-        if(needsSwapEndian)
+        else
         {
-          SwapEndianGeneral(faceBuffer.size(), faceBuffer.data(), header.glTypeSize);
+          // Allocate storage for the encoded face
+          std::vector<char>& faceBuffer = subresource(mip - first_file_mip, array_element, face);
+          ErrorWithText      maybeError = ResizeVectorOrError(faceBuffer, faceSizeBytes);
+          if(maybeError.has_value())
+          {
+            return "Allocating encoded data for mip " + std::to_string(mip) + " layer " + std::to_string(array_element)
+                   + " face " + std::to_string(face) + " failed (probably out of memory).";
+          }
+
+          if(!input.read(faceBuffer.data(), faceSizeBytes))
+          {
+            return "Reading mip " + std::to_string(mip) + " layer " + std::to_string(array_element) + " face "
+                   + std::to_string(face) + " failed (is the file truncated)?";
+          }
+
+          // Apply endianness swapping
+          if(needsSwapEndian)
+          {
+            SwapEndianGeneral(faceBuffer.size(), faceBuffer.data(), header.glTypeSize);
+          }
         }
 
         // Handle cubePadding
@@ -902,6 +1049,14 @@ ErrorWithText KTXImage::readFromKTX1Stream(std::istream& input, const ReadSettin
     }
   }
 
+  const VkFormat astcFormat    = format;
+  const VkFormat decodedFormat = GetASTCFallbackFormat(astcFormat, readSettings);
+  if(decodedFormat != VK_FORMAT_UNDEFINED)
+  {
+    format = decodedFormat;
+    UNWRAP_ERROR(decodeASTCMips(astcFormat, 0, num_mips, readSettings.num_threads));
+  }
+
   return {};
 }
 
@@ -986,8 +1141,25 @@ struct ScopedZstdCContext
   }
   ZSTD_CCtx* pCtx = nullptr;
 };
+
+// Returns this thread's Zstandard decompression context, creating it on first
+// use, or nullptr if that failed. Reusing contexts avoids allocating and
+// initializing one per read, which adds up when reading many small files.
+ZSTD_DCtx* GetThreadZstdDContext()
+{
+  thread_local ScopedZstdDContext threadContext;
+  if(threadContext.pCtx == nullptr)
+  {
+    threadContext.Init();
+  }
+  return threadContext.pCtx;
+}
 #endif
 
+// The key that stores the ID of the Zstandard dictionary a KTX2 file was
+// supercompressed with, as a decimal string.
+constexpr const char* kZstdDictionaryIDKey = "NVzstdDictionaryID";
+
 #ifdef NVP_SUPPORTS_GZLIB
 // A Zlib inflation stream that is automatically deinitialized when it goes out of scope.
 struct ScopedZlibDStream
@@ -1045,43 +1217,28 @@ struct BasisUSingleton
   BasisUSingleton(const BasisUSingleton&)            = delete;
   BasisUSingleton& operator=(const BasisUSingleton&) = delete;
 
-  void TranscodeUASTCToBC7OrASTC44(char* output, const char* inData, size_t width, size_t height, size_t depth, bool to_astc)
+  // Transcodes `numBlocks` consecutive UASTC blocks to BC7 or ASTC 4x4. All
+  // three formats use 16 bytes per block. Thread-safe; callers split large
+  // images into ranges of blocks to transcode them in parallel.
+  void TranscodeUASTCToBC7OrASTC44(char* output, const char* inData, size_t numBlocks, bool to_astc)
   {
     if(!Initialize())
       return;
 
-    const basist::uastc_block* buf        = reinterpret_cast<const basist::uastc_block*>(inData);
-    const size_t               numBlocksX = (width + 3) / 4;
-    const size_t               numBlocksY = (height + 3) / 4;
-    const size_t               numBlocksZ = (depth + 3) / 4;
-    const size_t               numBlocks  = numBlocksX * numBlocksY * numBlocksZ;
-    if(numBlocks > INT64_MAX)
-      return;  // Won't fit in an OpenMP range
-
-    const int64_t numBlocksI = static_cast<int64_t>(numBlocks);
+    const basist::uastc_block* buf = reinterpret_cast<const basist::uastc_block*>(inData);
     if(to_astc)
     {
-#if defined(_OPENMP)
-#pragma omp parallel for
-#endif
-      for(int64_t blockIdx = 0; blockIdx < numBlocksI; blockIdx++)
+      for(size_t blockIdx = 0; blockIdx < numBlocks; blockIdx++)
       {
-        const basist::uastc_block& block = buf[blockIdx];
-        char*                      dst   = output + size_t(blockIdx) * 16;  // 16 bytes per ASTC block
-        basist::transcode_uastc_to_astc(block, dst);
+        basist::transcode_uastc_to_astc(buf[blockIdx], output + blockIdx * 16);
       }
     }
     else
     {
       // To BC7
-#if defined(_OPENMP)
-#pragma omp parallel for
-#endif
-      for(int64_t blockIdx = 0; blockIdx < numBlocksI; blockIdx++)
+      for(size_t blockIdx = 0; blockIdx < numBlocks; blockIdx++)
       {
-        const basist::uastc_block& block = buf[blockIdx];
-        char*                      dst   = output + size_t(blockIdx) * 16;  // 16 bytes per BC7 block
-        basist::transcode_uastc_to_bc7(block, dst);
+        basist::transcode_uastc_to_bc7(buf[blockIdx], output + blockIdx * 16);
       }
     }
   }
@@ -1241,13 +1398,523 @@ struct KTX2TopLevelHeader
 static_assert(sizeof(VkFormat) == sizeof(uint32_t), "VkFormat size must match KTX2 spec!");
 static_assert(sizeof(KTX2TopLevelHeader) == 68, "KTX2 top-level header size must match spec! Padding issue?");
 
+namespace {
+// Per-mip state for KTXImage::readFromKTX2Stream, which first reads every
+// level and then inflates and transcodes them in parallel.
+struct KTX2LevelReadState
+{
+  size_t mipWidth  = 1;
+  size_t mipHeight = 1;
+  size_t mipDepth  = 1;
+  // The size of each face in the inflated vkFormat, after inflation.
+  size_t inflatedFaceSize = 0;
+  // The size of each face in the final vkFormat, after inflation and transcoding.
+  size_t finalFaceSize = 0;
+  // Whether the data was read directly into the subresources (no
+  // supercompression and no UASTC), so there's nothing left to do.
+  bool readIntoSubresources = false;
+  // When reading from memory, the subresources (ordered by layer, then face)
+  // are views of the input instead.
+  std::vector<std::span<const char>> subresourceViews;
+  //               decompression     transcoding
+  // supercompressedData -> inflatedData -> subresource
+  //                             ^
+  //                             |
+  //                             in the ETC1S + UASTC case, we load file data into here directly
+  //                             (it turns out ETC1S doesn't do anything per-level)
+  std::vector<char> supercompressedData;
+  std::vector<char> inflatedData;
+  // The data to inflate: either supercompressedData, or a view of the input.
+  std::span<const char> supercompressedBytes;
+  // Errors found after reading: one for the level as a whole, and one per
+  // subresource (ordered by layer, then face).
+  ErrorWithText              error;
+  std::vector<ErrorWithText> subresourceErrors;
+};
+
+// Validates the sizes of a KTX2 mip and reads its data from the stream: either
+// directly into the image's subresources, or into the level's temporary buffers.
+// If `view_source` is non-empty, `input` reads from it, and the level's
+// subresources or supercompressed data are views of it instead of copies.
+// `mip` is the mip in the file, and `imageMip` is the image's mip it becomes.
+ErrorWithText ReadKTX2Level(std::istream&                    input,
+                            std::span<const char>            view_source,
+                            std::streampos                   start_pos,
+                            const KTX2TopLevelHeader&        header,
+                            const LevelIndex&                levelIndex,
+                            uint32_t                         mip,
+                            uint32_t                         imageMip,
+                            VkFormat                         format,
+                            KTXImage::InputSupercompression  input_supercompression,
+                            size_t                           basisETC1SNumSlices,
+                            size_t                           validation_input_size,
+                            const ReadSettings&              readSettings,
+                            KTXImage&                        image,
+                            KTX2LevelReadState&              level)
+{
+  // Seek to the start of that mip's data and read it. Note that this skips
+  // over mipPadding.
+  if(!input.seekg(levelIndex.byteOffset + start_pos, std::ios::beg))
+  {
+    return "Failed to seek to KTX2 mip " + std::to_string(mip) + " data!";
+  }
+
+  const size_t mipWidth  = std::max(1u, header.pixelWidth >> mip);
+  const size_t mipHeight = std::max(1u, header.pixelHeight >> mip);
+  const size_t mipDepth  = std::max(1u, header.pixelDepth >> mip);
+  level.mipWidth         = mipWidth;
+  level.mipHeight        = mipHeight;
+  level.mipDepth         = mipDepth;
+
+  // The size of each face in the inflated vkFormat, after inflation.
+  size_t& inflatedFaceSize = level.inflatedFaceSize;
+  if(header.vkFormat == VK_FORMAT_UNDEFINED)
+  {
+    // Check for the Basis UASTC and Universal cases. I don't know if ETC1S
+    // or UASTC supports depth.
+    if(input_supercompression == KTXImage::InputSupercompression::eBasisUASTC)
+    {
+      if(!checked_math::mul4((mipWidth + 3) / 4, (mipHeight + 3) / 4, mipDepth, 16, inflatedFaceSize))  // 16 bytes per 4x4 block
+        return "Invalid KTX2 file: A subresource had size " + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
+               + " x " + std::to_string(mipDepth) + ", which would require more than 2^64 - 1 bytes to store decompressed.";
+    }
+    else if(input_supercompression == KTXImage::InputSupercompression::eBasisETC1S)
+    {
+      if(!checked_math::mul5((mipWidth + 3) / 4, (mipHeight + 3) / 4, mipDepth, basisETC1SNumSlices, 8, inflatedFaceSize))  // 8 bytes per 4x4 block per slice
+        return "Invalid KTX2 file: A subresource had size " + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
+               + " x " + std::to_string(mipDepth) + " with " + std::to_string(basisETC1SNumSlices)
+               + " slices, which would require more than 2^64 - 1 bytes to store decompressed.";
+    }
+    else
+    {
+      return "Tried to find the size of an undefined VkFormat, with an unknown Khronos Data Format color model. Is "
+             "this a new texture format?";
+    }
+  }
+  else
+  {
+    UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, header.vkFormat, inflatedFaceSize, readSettings.custom_size_callback));
+  }
+
+  // The size of each face in the final vkFormat, after inflation and transcoding.
+  size_t& finalFaceSize = level.finalFaceSize;
+  UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, format, finalFaceSize, readSettings.custom_size_callback));
+
+  if(finalFaceSize > readSettings.max_resource_size_in_bytes)
+  {
+    return "Subresource was too large! The KTX2 file said that each mip 0 face had dimensions " + std::to_string(mipWidth)
+           + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth) + " with format " + std::to_string(format)
+           + ". This has a computed size of " + std::to_string(finalFaceSize)
+           + " bytes, which is larger than the limit of max_resource_size_in_bytes = "
+           + std::to_string(readSettings.max_resource_size_in_bytes) + " bytes.";
+  }
+
+  // Validate sizes
+  if(readSettings.validate_input_size)
+  {
+    // Level-wide constraint on read data
+    if(levelIndex.byteLength > validation_input_size)
+    {
+      return "The KTX2 file said that level " + std::to_string(mip) + " contained " + std::to_string(levelIndex.byteLength)
+             + " bytes of supercompressed data, but the file was only " + std::to_string(validation_input_size) + " bytes long!";
+    }
+
+    if(header.supercompressionScheme == 0)
+    {
+      // Level-wide constraint on read data
+      if(levelIndex.uncompressedByteLength > validation_input_size)
+      {
+        return "The KTX2 file said no supercompression was used and that level " + std::to_string(mip) + " contained "
+               + std::to_string(levelIndex.uncompressedByteLength) + " bytes of data, but the file was only "
+               + std::to_string(validation_input_size) + " bytes long!";
+      }
+
+      // Per-face more specific constraint, making use of how non-supercompressed
+      // UASTC and ASTC (the transcoded-to format) are both 128 bits/block.
+      if((validation_input_size / size_t(header.layerCount)) / size_t(header.faceCount) < finalFaceSize)
+      {
+        return "The KTX2 file said it contained " + std::to_string(header.layerCount) + " array elements and "
+               + std::to_string(header.faceCount) + " faces in mip " + std::to_string(mip)
+               + ", but the input was too short (" + std::to_string(validation_input_size) + " bytes) to contain that!";
+      }
+    }
+  }
+
+  // FAST PATH - if no supercompression and no UASTC, we can read directly:
+  if((header.supercompressionScheme == 0) && (input_supercompression != KTXImage::InputSupercompression::eBasisUASTC))
+  {
+    level.readIntoSubresources = true;
+    if(!view_source.empty())
+    {
+      level.subresourceViews.resize(size_t(header.layerCount) * size_t(header.faceCount));
+    }
+    for(uint32_t layer = 0; layer < header.layerCount; layer++)
+    {
+      for(uint32_t face = 0; face < header.faceCount; face++)
+      {
+        bool readSucceeded = false;
+        if(!view_source.empty())
+        {
+          std::span<const char>& view = level.subresourceViews[size_t(layer) * size_t(header.faceCount) + size_t(face)];
+          readSucceeded               = ViewFromStream(input, view_source, finalFaceSize, view);
+        }
+        else
+        {
+          std::vector<char>& subresource_data = image.subresource(imageMip, layer, face);
+          UNWRAP_ERROR(ResizeVectorOrError(subresource_data, finalFaceSize));
+          readSucceeded = bool(input.read(subresource_data.data(), finalFaceSize));
+        }
+        if(!readSucceeded)
+        {
+          return "Reading data for mip " + std::to_string(mip) + " layer " + std::to_string(layer) + " face "
+                 + std::to_string(face) + " from the stream failed. Is the stream truncated?";
+        }
+      }
+    }
+    return {};
+  }
+
+  level.subresourceErrors.resize(size_t(header.layerCount) * size_t(header.faceCount));
+  if(header.supercompressionScheme == 0)
+  {
+    // UASTC, ETC1S: Load file data into inflatedData directly
+    UNWRAP_ERROR(ResizeVectorOrError(level.inflatedData, levelIndex.uncompressedByteLength));
+    if(!input.read(level.inflatedData.data(), levelIndex.uncompressedByteLength))
+    {
+      return "Reading mip " + std::to_string(mip) + "'s data failed.";
+    }
+  }
+  else if(header.supercompressionScheme == 1)
+  {
+    // ETC1S files often have uncompressedByteLength set to 0 for some reason.
+    // In any case, we want to read the compressed byte length.
+    UNWRAP_ERROR(ResizeVectorOrError(level.inflatedData, levelIndex.byteLength));
+    if(!input.read(level.inflatedData.data(), levelIndex.byteLength))
+    {
+      return "Reading mip " + std::to_string(mip) + "'s data failed.";
+    }
+  }
+  else
+  {
+    // Read into supercompressedData, or view it in memory
+    if(!view_source.empty())
+    {
+      if(!ViewFromStream(input, view_source, levelIndex.byteLength, level.supercompressedBytes))
+      {
+        return "Reading mip " + std::to_string(mip) + "'s supercompressed data failed.";
+      }
+    }
+    else
+    {
+      UNWRAP_ERROR(ResizeVectorOrError(level.supercompressedData, levelIndex.byteLength));
+      if(!input.read(level.supercompressedData.data(), levelIndex.byteLength))
+      {
+        return "Reading mip " + std::to_string(mip) + "'s supercompressed data failed.";
+      }
+      level.supercompressedBytes = level.supercompressedData;
+    }
+
+    // Allocate the buffer to inflate the supercompressed data into. Doing
+    // this here keeps allocation failures in the same order as reading.
+    UNWRAP_ERROR(ResizeVectorOrError(level.inflatedData, levelIndex.uncompressedByteLength));
+  }
+
+  return {};
+}
+
+// Inflates a level's supercompressed data into its inflatedData buffer, then
+// frees the supercompressed data. Does nothing for supercompression schemes 0
+// and 1. Thread-safe as long as each thread uses its own Zstandard context.
+// If `zstdDDict` is not null, Zstandard data is inflated with that dictionary.
+#ifdef NVP_SUPPORTS_ZSTD
+ErrorWithText InflateKTX2Level(uint32_t supercompressionScheme, uint32_t mip, ZSTD_DCtx* zstdDCtx, const ZSTD_DDict* zstdDDict, KTX2LevelReadState& level)
+#else
+ErrorWithText InflateKTX2Level(uint32_t supercompressionScheme, uint32_t mip, void* zstdDCtx, const void* zstdDDict, KTX2LevelReadState& level)
+#endif
+{
+  std::vector<char>&           inflatedData        = level.inflatedData;
+  const std::span<const char>& supercompressedData = level.supercompressedBytes;
+  if(supercompressionScheme == 2)
+  {
+    // Zstandard
+#ifdef NVP_SUPPORTS_ZSTD
+    size_t zstdError = 0;
+    if(zstdDDict != nullptr)
+    {
+      zstdError = ZSTD_decompress_usingDDict(zstdDCtx, inflatedData.data(), inflatedData.size(),  //
+                                             supercompressedData.data(), supercompressedData.size(), zstdDDict);
+    }
+    else
+    {
+      zstdError = ZSTD_decompressDCtx(zstdDCtx, inflatedData.data(), inflatedData.size(),  //
+                                      supercompressedData.data(), supercompressedData.size());
+    }
+    if(ZSTD_isError(zstdError))
+    {
+      const char* zstdErrorName = ZSTD_getErrorName(zstdError);
+      return "Mip " + std::to_string(mip) + " Zstandard inflation failed with the message '" + std::string(zstdErrorName)
+             + "' (code " + std::to_string(zstdError) + ").";
+    }
+#else
+    assert(!"nv_ktx was compiled without Zstandard support, but the KTX stream was not rejected! This should never happen.");
+#endif
+  }
+  else if(supercompressionScheme == 3)
+  {
+    // Zlib
+#ifdef NVP_SUPPORTS_GZLIB
+    ScopedZlibDStream zlibStream;
+    int               zlibError = zlibStream.Init();
+    if(zlibError != Z_OK)
+    {
+      return "Zlib initialization failed (error code " + std::to_string(zlibError) + ").";
+    }
+    if(supercompressedData.size() > UINT_MAX || inflatedData.size() > UINT_MAX)
+    {
+      return "Zlib compressed or decompressed data for mip " + std::to_string(mip) + " was larger than 4 GB.";
+    }
+    zlibStream.stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(supercompressedData.data()));
+    zlibStream.stream.avail_in  = static_cast<uInt>(supercompressedData.size());
+    zlibStream.stream.next_out  = reinterpret_cast<Bytef*>(inflatedData.data());
+    zlibStream.stream.avail_out = static_cast<uInt>(inflatedData.size());
+    zlibError                   = inflate(&zlibStream.stream, Z_NO_FLUSH);
+    // inflate() returns Z_STREAM_END when it reaches the end of the data.
+    if(zlibError != Z_OK && zlibError != Z_STREAM_END)
+    {
+      return "Zlib inflation failed (error code " + std::to_string(zlibError) + ").";
+    }
+    zlibStream.Free();
+#else
+    assert(!"nv_ktx was compiled without Zlib support, but the KTX stream was not rejected! This should never happen.");
+#endif
+  }
+  else
+  {
+    return {};
+  }
+
+  level.supercompressedData  = {};
+  level.supercompressedBytes = {};
+  return {};
+}
+
+// Writes subresource number `subresourceInMip` (ordered by layer, then face)
+// of an inflated non-Basis level into `subresource_data`. Different
+// subresources can be written in parallel.
+ErrorWithText WriteKTX2Subresource(KTX2LevelReadState&             level,
+                                   std::vector<char>&              subresource_data,
+                                   size_t                          subresourceInMip,
+                                   KTXImage::InputSupercompression input_supercompression,
+                                   uint32_t                        supercompressionScheme)
+{
+  const size_t inflatedDataPos = subresourceInMip * level.inflatedFaceSize;  // Read position in inflatedData
+  // As a fast-path, if we have only one layer and face and no transcoding, the output is the same as the input.
+  if(level.subresourceErrors.size() == 1 && input_supercompression == KTXImage::InputSupercompression::eNone)
+  {
+    subresource_data = std::move(level.inflatedData);
+    return {};
+  }
+  // Otherwise, prepare the output buffer.
+  UNWRAP_ERROR(ResizeVectorOrError(subresource_data, level.finalFaceSize));
+
+  // Not UASTC or ETC1S, no transcoding needed
+  // We've checked to make sure this is okay above, but double-check
+  // here in case the behavior above changes in future versions of
+  // the code.
+  if(supercompressionScheme == 1)
+  {
+    return "Failed to read KTX2 file: BasisLZ supercompression was enabled, but control reached the non-BasisLZ copy. This should never happen.";
+  }
+  if(inflatedDataPos + level.inflatedFaceSize > level.inflatedData.size())
+  {
+    return "Failed to read KTX2 file: the size of the inflated data didn't match the expected size.";
+  }
+  memcpy(subresource_data.data(), &level.inflatedData[inflatedDataPos], level.inflatedFaceSize);
+  return {};
+}
+
+#ifdef NVP_SUPPORTS_BASISU
+// Returns the TranscodeCache key for a subresource of the given size
+// transcoded from `source` (and `source2`, for ETC1S alpha slices) to
+// `target`. `globalDataDigest` identifies anything else the transcode depends
+// on, such as ETC1S codebooks.
+TranscodeCache::Key TranscodeCacheKey(std::span<const char>       source,
+                                      std::span<const char>       source2,
+                                      size_t                      width,
+                                      size_t                      height,
+                                      size_t                      depth,
+                                      uint32_t                    target,
+                                      const nvutils::Sha256Digest& globalDataDigest)
+{
+  nvutils::Sha256 sha;
+  // Hash the sizes first, so that data can't move between the two sources.
+  sha.updateValue(uint64_t(source.size()));
+  sha.updateValue(uint64_t(source2.size()));
+  sha.update(std::as_bytes(source));
+  sha.update(std::as_bytes(source2));
+  const uint64_t dimensions[3] = {width, height, depth};
+  sha.updateValue(dimensions);
+  sha.updateValue(target);
+  sha.updateValue(globalDataDigest);
+  return {uint64_t(source.size() + source2.size()), sha.finish()};
+}
+
+// The number of UASTC blocks per transcoding task (16 KiB of output): small
+// enough to balance a single large subresource over many threads, and large
+// enough that scheduling costs little.
+constexpr size_t kUASTCBlocksPerTile = 1024;
+
+// Transcodes the inflated UASTC data of levels[firstMip...endMip - 1] to
+// `image`'s format in its subresources. Subresources in readSettings.transcode_cache
+// are copied from it. The rest are split into tiles of blocks, which are
+// transcoded in parallel across all subresources at once, and then added to
+// the cache. Errors are written to each level's subresourceErrors.
+void TranscodeKTX2UASTCLevels(std::vector<KTX2LevelReadState>& levels,
+                              int                              firstMip,
+                              int                              endMip,
+                              size_t                           subresourcesPerMip,
+                              uint32_t                         faceCount,
+                              KTXImage&                        image,
+                              const ReadSettings&              readSettings)
+{
+  struct PendingSubresource
+  {
+    char*       output     = nullptr;
+    size_t      outputSize = 0;
+    const char* input      = nullptr;
+    size_t      numBlocks = 0;  // 0 if there's nothing to transcode.
+    TranscodeCache::Key cacheKey;
+  };
+  TranscodeCache*                 cache           = readSettings.transcode_cache;
+  const uint64_t                  numSubresources = uint64_t(endMip - firstMip) * subresourcesPerMip;
+  std::vector<PendingSubresource> pending(numSubresources);
+
+  // Allocate each subresource and look it up in the cache.
+  nvutils::parallel_batches_pooled<1>(
+      numSubresources,
+      [&](uint64_t i, uint32_t /* threadIndex */) {
+        const uint32_t      mip   = uint32_t(firstMip + int(i / subresourcesPerMip));
+        KTX2LevelReadState& level = levels[mip];
+        if(level.error.has_value())
+        {
+          return;
+        }
+        const size_t       subresourceInMip = size_t(i % subresourcesPerMip);
+        std::vector<char>& subresource_data =
+            image.subresource(mip, uint32_t(subresourceInMip / faceCount), uint32_t(subresourceInMip % faceCount));
+        ErrorWithText& error = level.subresourceErrors[subresourceInMip];
+        error                = ResizeVectorOrError(subresource_data, level.finalFaceSize);
+        if(error.has_value())
+        {
+          return;
+        }
+        const size_t numBlocks = ((level.mipWidth + 3) / 4) * ((level.mipHeight + 3) / 4) * ((level.mipDepth + 3) / 4);
+        const size_t inflatedDataPos = subresourceInMip * level.inflatedFaceSize;
+        if(numBlocks * 16 > level.inflatedFaceSize || numBlocks * 16 > subresource_data.size()
+           || inflatedDataPos + level.inflatedFaceSize > level.inflatedData.size())
+        {
+          error = "Failed to read KTX2 file: the size of the inflated UASTC data didn't match the expected size.";
+          return;
+        }
+        const std::span<const char> source(&level.inflatedData[inflatedDataPos], level.inflatedFaceSize);
+        TranscodeCache::Key         cacheKey;
+        if(cache)
+        {
+          cacheKey = TranscodeCacheKey(source, {}, level.mipWidth, level.mipHeight, level.mipDepth, uint32_t(image.format), {});
+          if(cache->find(cacheKey, subresource_data))
+          {
+            return;
+          }
+        }
+        pending[i] = {subresource_data.data(), subresource_data.size(), source.data(), numBlocks, cacheKey};
+      },
+      readSettings.num_threads);
+
+  // Transcode all tiles of all remaining subresources. tileStarts[i] is the
+  // index of subresource i's first tile.
+  std::vector<uint64_t> tileStarts(numSubresources + 1, 0);
+  for(uint64_t i = 0; i < numSubresources; i++)
+  {
+    tileStarts[i + 1] = tileStarts[i] + (pending[i].numBlocks + kUASTCBlocksPerTile - 1) / kUASTCBlocksPerTile;
+  }
+  const bool toASTC = readSettings.device_supports_astc;
+  nvutils::parallel_batches_pooled<1>(
+      tileStarts.back(),
+      [&](uint64_t tile, uint32_t /* threadIndex */) {
+        const uint64_t            i = uint64_t(std::upper_bound(tileStarts.begin(), tileStarts.end(), tile) - tileStarts.begin()) - 1;
+        const PendingSubresource& p          = pending[i];
+        const size_t              firstBlock = size_t(tile - tileStarts[i]) * kUASTCBlocksPerTile;
+        const size_t              numBlocks  = std::min(kUASTCBlocksPerTile, p.numBlocks - firstBlock);
+        BasisUSingleton::GetInstance().TranscodeUASTCToBC7OrASTC44(p.output + firstBlock * 16, p.input + firstBlock * 16,
+                                                                   numBlocks, toASTC);
+      },
+      readSettings.num_threads);
+
+  if(cache)
+  {
+    for(const PendingSubresource& p : pending)
+    {
+      if(p.numBlocks > 0)
+      {
+        cache->insert(p.cacheKey, std::span<const char>(p.output, p.outputSize));
+      }
+    }
+  }
+}
+#endif
+}  // namespace
+
+// Everything KTXImage::readKTX2Mips() needs from the rest of a KTX2 file to
+// read its mips.
+struct KTX2ReadContext
+{
+  std::streampos          start_pos;
+  size_t                  validation_input_size = 0;
+  KTX2TopLevelHeader      header{};
+  std::vector<LevelIndex> levelIndices;
+  // The file's mip that is the image's mip 0.
+  uint32_t first_file_mip      = 0;
+  size_t   basisETC1SNumSlices = 1;  // Basis ETC1S can have 1 or two slices (which occurs in RGBA and R+G)
+  // The dictionary the file's levels were supercompressed with, if any.
+  std::shared_ptr<const ZstdDictionary> zstdDictionary;
+  // If not VK_FORMAT_UNDEFINED, the file's levels are in this ASTC format,
+  // and are decoded to the image's format after they're read.
+  VkFormat astcFormat = VK_FORMAT_UNDEFINED;
+#ifdef NVP_SUPPORTS_BASISU
+  BasisLZDecompressionObjects       basisLZDCtx;
+  basist::transcoder_texture_format basisDstFmt = basist::transcoder_texture_format::cTFBC7_RGBA;  // Same as the inflated VkFormat but in an enum Basis uses
+  // Basis ETC1S supports a sort of video format, where there are I-frames
+  // and P-frames and frames correspond to array elements. The Basis code
+  // currently allows this if there's a KTXanimData key, or if there are
+  // P-frames indicated in the supercompression image descriptions.
+  // We diverge slightly from Basis here and require videos to be 2D; Basis
+  // technically allows cubemap arrays with KTXanimData set to be interpreted
+  // as videos, I think.
+  bool isVideo = false;
+  // A digest of the supercompression global data, which holds the ETC1S
+  // codebooks; part of each ETC1S subresource's TranscodeCache key.
+  nvutils::Sha256Digest basisSGDDigest{};
+#endif
+};
+
 // Reads a KTX 2.0 file, *starting after the 12-byte identifier*.
 ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettings& readSettings)
+{
+  KTX2ReadContext context;
+  UNWRAP_ERROR(readKTX2Header(input, readSettings, context));
+  UNWRAP_ERROR(allocate(num_mips, num_layers_possibly_0, num_faces));
+  return readKTX2Mips(input, readSettings, context, 0, num_mips);
+}
+
+// Reads a KTX 2.0 file up to its Mip Level Array, *starting after the 12-byte
+// identifier*.
+ErrorWithText KTXImage::readKTX2Header(std::istream& input, const ReadSettings& readSettings, KTX2ReadContext& context)
 {
   // Get the position of the start of the file in the stream so that we can add
   // padding correctly later.
   const std::streampos start_pos = input.tellg() - std::streampos(12);  // Since we start after the identifier
-  size_t               validation_input_size = 0;
+  context.start_pos              = start_pos;
+  size_t& validation_input_size  = context.validation_input_size;
   if(readSettings.validate_input_size)
   {
     const std::streampos initial_pos = input.tellg();
@@ -1259,7 +1926,7 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
 
   //---------------------------------------------------------------------------
   // Read sections 0 and 1 of the file structure.
-  KTX2TopLevelHeader header{};
+  KTX2TopLevelHeader& header = context.header;
   READ_OR_ERROR(input, header, "Failed to read KTX2 header and section 1.");
 
   // Copy the dimensions into the structure so that we can determine the
@@ -1300,7 +1967,10 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
   {
     header.levelCount = 1;
   }
-  num_mips = (readSettings.mips ? static_cast<int>(header.levelCount) : 1);
+  context.first_file_mip = GetMipRangeToRead(header.levelCount, readSettings, num_mips);
+  mip_0_width            = MipDimensionPossibly0(mip_0_width, context.first_file_mip);
+  mip_0_height           = MipDimensionPossibly0(mip_0_height, context.first_file_mip);
+  mip_0_depth            = MipDimensionPossibly0(mip_0_depth, context.first_file_mip);
 
   num_faces = header.faceCount;
 
@@ -1350,7 +2020,8 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
 
   //---------------------------------------------------------------------------
   // Load the level indices (section 2)
-  std::vector<LevelIndex> levelIndices(original_num_mips_max_1);
+  std::vector<LevelIndex>& levelIndices = context.levelIndices;
+  levelIndices.resize(original_num_mips_max_1);
   if(!input.read(reinterpret_cast<char*>(levelIndices.data()), sizeof(LevelIndex) * original_num_mips_max_1))
   {
     return "Unable to read Level Index from KTX2 file.";
@@ -1429,10 +2100,10 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
   uint32_t khrDfPrimaries              = KHR_DF_PRIMARIES_SRGB;
   is_premultiplied                     = false;
   is_srgb                              = true;
-  size_t           basisETC1SNumSlices = 1;  // Basis ETC1S can have 1 or two slices (which occurs in RGBA and R+G)
+  size_t&          basisETC1SNumSlices = context.basisETC1SNumSlices;
   ETC1SCombination basisETC1SCombo{};
 #ifdef NVP_SUPPORTS_BASISU
-  basist::transcoder_texture_format basisDstFmt = basist::transcoder_texture_format::cTFBC7_RGBA;  // Same as the inflated VkFormat but in an enum Basis uses
+  basist::transcoder_texture_format& basisDstFmt = context.basisDstFmt;
 #endif
   if(basicDFDExists)
   {
@@ -1626,19 +2297,9 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
   }
 
 // Initialize supercompression
-#ifdef NVP_SUPPORTS_ZSTD
-  ScopedZstdDContext zstdDCtx;
-#endif
 #ifdef NVP_SUPPORTS_BASISU
-  BasisLZDecompressionObjects basisLZDCtx;
-  // Basis ETC1S supports a sort of video format, where there are I-frames
-  // and P-frames and frames correspond to array elements. The Basis code
-  // currently allows this if there's a KTXanimData key, or if there are
-  // P-frames indicated in the supercompression image descriptions.
-  // We diverge slightly from Basis here and require videos to be 2D; Basis
-  // technically allows cubemap arrays with KTXanimData set to be interpreted
-  // as videos, I think.
-  bool isVideo = false;
+  BasisLZDecompressionObjects& basisLZDCtx = context.basisLZDCtx;
+  bool&                        isVideo     = context.isVideo;
 #endif
   if(header.supercompressionScheme == 1)
   {
@@ -1646,6 +2307,7 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
     // Initialize supercompression global data
     UNWRAP_ERROR(BasisUSingleton::GetInstance().PrepareBasisLZObjects(basisLZDCtx, supercompressionGlobalData, original_num_mips_max_1,
                                                                       std::max(1u, num_layers_possibly_0), num_faces));
+    context.basisSGDDigest = nvutils::sha256(std::as_bytes(std::span(supercompressionGlobalData)));
     // Video criterion; don't permit 1-frame videos following Basis here
     if(num_faces == 1 && num_layers_possibly_0 > 1)
     {
@@ -1681,12 +2343,23 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
   }
   else if(header.supercompressionScheme == 2)
   {
-    // Set up Zstandard
+    // Set up Zstandard. Each thread reuses its own decompression context;
+    // we only need to find the dictionary, if the file uses one.
 #ifdef NVP_SUPPORTS_ZSTD
-    zstdDCtx.Init();
-    if(zstdDCtx.pCtx == nullptr)
+    const auto dictionaryIt = key_value_data.find(kZstdDictionaryIDKey);
+    if(dictionaryIt != key_value_data.end())
     {
-      return "Initializing Zstandard context failed.";
+      const std::string idString(dictionaryIt->second.data(), strnlen(dictionaryIt->second.data(), dictionaryIt->second.size()));
+      const uint32_t    id = uint32_t(strtoul(idString.c_str(), nullptr, 10));
+      if(readSettings.zstd_dictionaries != nullptr)
+      {
+        context.zstdDictionary = readSettings.zstd_dictionaries->find(id);
+      }
+      if(context.zstdDictionary == nullptr)
+      {
+        return "KTX2 stream was supercompressed with Zstandard dictionary " + idString
+               + ", but ReadSettings::zstd_dictionaries didn't contain it.";
+      }
     }
 #else
     return "KTX2 stream uses Zstandard supercompression, but nv_ktx was built without Zstd.";
@@ -1704,326 +2377,401 @@ ErrorWithText KTXImage::readFromKTX2Stream(std::istream& input, const ReadSettin
     return "Does not know about supercompression scheme " + std::to_string(header.supercompressionScheme) + ".";
   }
 
-  //---------------------------------------------------------------------------
-  // Section 7, Mip Level Array.
-  // Read, inflate, and decompress each image in turn.
-  //
-  // For each mip:
-  //   If uncompressed:
-  //     Copy each subresource
-  //   Else if Zstd:
-  //     Zstd decompress the mip data
-  //     Copy each subresource
-  //   Else if Zlib:
-  //     Zlib decompress the mip data
-  //     Copy each subresource
-  //   Else if Basis ETC1S+BasisLZ:
-  //     BasisLZ decompress the mip data to 1 or 2 ETC1S slices.
-  //     For each subresource
-  //       Transcode it from ETC1S to the inflated VkFormat
-  //
-  //   Then: if UASTC:
-  //     For each subresource
-  //       Transcode it from UASTC to the inflated VkFormat
-
-  // First initialize the output:
-  UNWRAP_ERROR(allocate(num_mips, num_layers_possibly_0, num_faces));
-  // Temporary buffers used for supercompressed data.
-  std::vector<char> supercompressedData;
-  std::vector<char> inflatedData;
-  // Traverse mips in reverse order following the spec
-  for(int mip = num_mips - 1; mip >= 0; mip--)
+  // Levels are read in the file's format; the image gets the decoded format
+  // now so that KTXLevelReader users see it before reading any mips.
+  const VkFormat decodedFormat = GetASTCFallbackFormat(format, readSettings);
+  if(decodedFormat != VK_FORMAT_UNDEFINED)
   {
-    // Seek to the start of that mip's data and read it. Note that this skips
-    // over mipPadding.
-    const LevelIndex& levelIndex = levelIndices[mip];
-    if(!input.seekg(levelIndex.byteOffset + start_pos, std::ios::beg))
-    {
-      return "Failed to seek to KTX2 mip " + std::to_string(mip) + " data!";
-    }
-
-    const size_t mipWidth  = std::max(1u, header.pixelWidth >> mip);
-    const size_t mipHeight = std::max(1u, header.pixelHeight >> mip);
-    const size_t mipDepth  = std::max(1u, header.pixelDepth >> mip);
-
-    // The size of each face in the inflated vkFormat, after inflation.
-    size_t inflatedFaceSize = 0;
-    if(header.vkFormat == VK_FORMAT_UNDEFINED)
-    {
-      // Check for the Basis UASTC and Universal cases. I don't know if ETC1S
-      // or UASTC supports depth.
-      if(input_supercompression == InputSupercompression::eBasisUASTC)
-      {
-        if(!checked_math::mul4((mipWidth + 3) / 4, (mipHeight + 3) / 4, mipDepth, 16, inflatedFaceSize))  // 16 bytes per 4x4 block
-          return "Invalid KTX2 file: A subresource had size " + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
-                 + " x " + std::to_string(mipDepth) + ", which would require more than 2^64 - 1 bytes to store decompressed.";
-      }
-      else if(input_supercompression == InputSupercompression::eBasisETC1S)
-      {
-        if(!checked_math::mul5((mipWidth + 3) / 4, (mipHeight + 3) / 4, mipDepth, basisETC1SNumSlices, 8, inflatedFaceSize))  // 8 bytes per 4x4 block per slice
-          return "Invalid KTX2 file: A subresource had size " + std::to_string(mipWidth) + " x " + std::to_string(mipHeight)
-                 + " x " + std::to_string(mipDepth) + " with " + std::to_string(basisETC1SNumSlices)
-                 + " slices, which would require more than 2^64 - 1 bytes to store decompressed.";
-      }
-      else
-      {
-        return "Tried to find the size of an undefined VkFormat, with an unknown Khronos Data Format color model. Is "
-               "this a new texture format?";
-      }
-    }
-    else
-    {
-      UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, header.vkFormat, inflatedFaceSize, readSettings.custom_size_callback));
-    }
+    context.astcFormat = format;
+    format             = decodedFormat;
+  }
 
-    // The size of each face in the final vkFormat, after inflation and transcoding.
-    size_t finalFaceSize = 0;
-    UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, format, finalFaceSize, readSettings.custom_size_callback));
+  return {};
+}
 
-    if(finalFaceSize > readSettings.max_resource_size_in_bytes)
+ErrorWithText KTXImage::decodeASTCMips(VkFormat astc_format, uint32_t first_mip, uint32_t mip_count, uint32_t num_threads)
+{
+  const texture_decode::DecodeTarget target =
+      (format == VK_FORMAT_R16G16B16A16_SFLOAT) ? texture_decode::DecodeTarget::eRGBA16F : texture_decode::DecodeTarget::eRGBA8;
+  // ReadSettings::num_threads only distinguishes 1 from everything else.
+  const uint32_t decodeThreads = (num_threads == 1) ? 1 : 0;
+  for(uint32_t mip = first_mip; mip < first_mip + mip_count; mip++)
+  {
+    const uint32_t mipWidth          = std::max(1u, mip_0_width >> mip);
+    const uint32_t mipHeight         = std::max(1u, mip_0_height >> mip);
+    const uint32_t mipDepth          = std::max(1u, mip_0_depth >> mip);
+    const size_t   encodedSliceBytes = texture_decode::encodedSizeBytes(astc_format, mipWidth, mipHeight);
+    const size_t   decodedSliceBytes = texture_decode::decodedSizeBytes(target, mipWidth, mipHeight);
+    size_t         decodedBytes      = 0;
+    if(!checked_math::mul2(decodedSliceBytes, mipDepth, decodedBytes))
     {
-      return "Subresource was too large! The KTX2 file said that each mip 0 face had dimensions "
-             + std::to_string(mipWidth) + " x " + std::to_string(mipHeight) + " x " + std::to_string(mipDepth)
-             + " with format " + std::to_string(format) + ". This has a computed size of "
-             + std::to_string(finalFaceSize) + " bytes, which is larger than the limit of max_resource_size_in_bytes = "
-             + std::to_string(readSettings.max_resource_size_in_bytes) + " bytes.";
+      return "The size of decoded ASTC mip " + std::to_string(mip) + " would overflow.";
     }
-
-    // Validate sizes
-    if(readSettings.validate_input_size)
+    for(uint32_t layer = 0; layer < std::max(1u, num_layers_possibly_0); layer++)
     {
-      // Level-wide constraint on read data
-      if(levelIndex.byteLength > validation_input_size)
-      {
-        return "The KTX2 file said that level " + std::to_string(mip) + " contained " + std::to_string(levelIndex.byteLength)
-               + " bytes of supercompressed data, but the file was only " + std::to_string(validation_input_size) + " bytes long!";
-      }
-
-      if(header.supercompressionScheme == 0)
+      for(uint32_t face = 0; face < num_faces; face++)
       {
-        // Level-wide constraint on read data
-        if(levelIndex.uncompressedByteLength > validation_input_size)
+        const std::span<const char> encoded = subresourceBytes(mip, layer, face);
+        if(encoded.size() / mipDepth < encodedSliceBytes)
         {
-          return "The KTX2 file said no supercompression was used and that level " + std::to_string(mip) + " contained "
-                 + std::to_string(levelIndex.uncompressedByteLength) + " bytes of data, but the file was only "
-                 + std::to_string(validation_input_size) + " bytes long!";
+          return "ASTC mip " + std::to_string(mip) + " layer " + std::to_string(layer) + " face " + std::to_string(face)
+                 + " was too small to decode.";
         }
-
-        // Per-face more specific constraint, making use of how non-supercompressed
-        // UASTC and ASTC (the transcoded-to format) are both 128 bits/block.
-        if((validation_input_size / size_t(header.layerCount)) / size_t(header.faceCount) < finalFaceSize)
+        std::vector<char> decoded;
+        UNWRAP_ERROR(ResizeVectorOrError(decoded, decodedBytes));
+        // 3D images with 2D ASTC blocks are stored as consecutive slices.
+        for(uint32_t z = 0; z < mipDepth; z++)
         {
-          return "The KTX2 file said it contained " + std::to_string(header.layerCount) + " array elements and "
-                 + std::to_string(header.faceCount) + " faces in mip " + std::to_string(mip)
-                 + ", but the input was too short (" + std::to_string(validation_input_size) + " bytes) to contain that!";
+          UNWRAP_ERROR(texture_decode::decodeImage(astc_format, mipWidth, mipHeight,
+                                                   encoded.subspan(z * encodedSliceBytes, encodedSliceBytes), target,
+                                                   {decoded.data() + z * decodedSliceBytes, decodedSliceBytes}, decodeThreads));
         }
+        const size_t index = subresourceIndex(mip, layer, face);
+        data[index]        = std::move(decoded);
+        views[index]       = {};
       }
     }
+  }
+  return {};
+}
+
+// Reads mips [first_mip, first_mip + mip_count) of the image from a KTX 2.0
+// file's Mip Level Array, given the context from readKTX2Header. The
+// subresources must have been allocated already.
+ErrorWithText KTXImage::readKTX2Mips(std::istream&       input,
+                                     const ReadSettings& readSettings,
+                                     KTX2ReadContext&    context,
+                                     uint32_t            first_mip,
+                                     uint32_t            mip_count)
+{
+  if(first_mip >= num_mips || mip_count > num_mips - first_mip)
+  {
+    return "Tried to read mips " + std::to_string(first_mip) + " up to " + std::to_string(uint64_t(first_mip) + mip_count)
+           + " of a KTX2 image with " + std::to_string(num_mips) + " mips.";
+  }
+  const std::streampos           start_pos             = context.start_pos;
+  const size_t                   validation_input_size = context.validation_input_size;
+  const KTX2TopLevelHeader&      header                = context.header;
+  const std::vector<LevelIndex>& levelIndices          = context.levelIndices;
+  const size_t                   basisETC1SNumSlices   = context.basisETC1SNumSlices;
+  const VkFormat                 levelFormat           = (context.astcFormat != VK_FORMAT_UNDEFINED) ? context.astcFormat : format;
+#ifdef NVP_SUPPORTS_ZSTD
+  const ZSTD_DDict* zstdDDict = context.zstdDictionary ? context.zstdDictionary->getDDict() : nullptr;
+#else
+  const void* zstdDDict = nullptr;
+#endif
+#ifdef NVP_SUPPORTS_BASISU
+  BasisLZDecompressionObjects&            basisLZDCtx = context.basisLZDCtx;
+  const basist::transcoder_texture_format basisDstFmt = context.basisDstFmt;
+  const bool                              isVideo     = context.isVideo;
+#endif
+  // Image mip `mip` is file mip `mip + first_file_mip`. Below, `mip` is
+  // always an image mip.
+  const uint32_t first_file_mip = context.first_file_mip;
 
-    // FAST PATH - if no supercompression and no UASTC, we can read directly:
-    if((header.supercompressionScheme == 0) && (input_supercompression != InputSupercompression::eBasisUASTC))
+  //---------------------------------------------------------------------------
+  // Section 7, Mip Level Array.
+  // This is done in two passes, so that inflation and transcoding of
+  // different mips, layers, and faces can run in parallel:
+  //
+  // Pass 1 (serial, traversing mips in reverse order following the spec):
+  //   For each mip:
+  //     Validate its sizes.
+  //     If uncompressed and not UASTC:
+  //       Read each subresource directly
+  //     Else:
+  //       Read the level's (possibly supercompressed) data
+  //
+  // Pass 2 (parallel over mips, then over subresources):
+  //   For each mip:
+  //     If Zstd: Zstd decompress the mip data
+  //     Else if Zlib: Zlib decompress the mip data
+  //   For each subresource:
+  //     If UASTC: Transcode it from UASTC to the inflated VkFormat, in tiles
+  //       of blocks spread over the thread pool
+  //     Else if Basis ETC1S+BasisLZ: Transcode it from ETC1S to the inflated
+  //       VkFormat. This stays serial for ETC1S video, whose frames depend on
+  //       each other through the transcoder state.
+  //     Else: Copy it
+  //   Transcoded subresources are looked up in and added to
+  //   readSettings.transcode_cache, if set.
+  //
+  // Errors are recorded per mip and per subresource; at the end, we return
+  // the error that a serial traversal would have reached first.
+
+  const int                       end_mip = int(first_mip + mip_count);
+  std::vector<KTX2LevelReadState> levels(end_mip);
+  const size_t                    subresourcesPerMip = size_t(header.layerCount) * size_t(header.faceCount);
+  // Both passes run on windows of consecutive mips, whose temporary buffers
+  // together take at most readSettings.parallel_read_budget_in_bytes (or one
+  // mip, if it's larger), so that large files don't hold all their levels in
+  // memory at once. Single-threaded reads use one mip per window.
+  for(int window_end = end_mip; window_end > int(first_mip);)
+  {
+    // The smallest mip that was fully read in pass 1, and the error that stopped
+    // pass 1 (at mip lowestReadMip - 1), if any.
+    int           lowestReadMip = window_end;
+    ErrorWithText readError;
+    uint64_t      windowBytes = 0;
+    for(int mip = window_end - 1; mip >= int(first_mip); mip--)
     {
-      for(uint32_t layer = 0; layer < header.layerCount; layer++)
+      const uint32_t    fileMip    = uint32_t(mip) + first_file_mip;
+      const LevelIndex& levelIndex = levelIndices[fileMip];
+      // An upper bound for the level's supercompressed and inflated buffers
+      const uint64_t levelBytes = (levelIndex.byteLength > UINT64_MAX - levelIndex.uncompressedByteLength) ?
+                                      UINT64_MAX :
+                                      levelIndex.byteLength + levelIndex.uncompressedByteLength;
+      if(mip < window_end - 1
+         && (readSettings.num_threads == 1 || levelBytes > readSettings.parallel_read_budget_in_bytes - windowBytes))
       {
-        for(uint32_t face = 0; face < header.faceCount; face++)
-        {
-          std::vector<char>& subresource_data = subresource(mip, layer, face);
-          UNWRAP_ERROR(ResizeVectorOrError(subresource_data, finalFaceSize));
-          if(!input.read(subresource_data.data(), finalFaceSize))
-          {
-            return "Reading data for mip " + std::to_string(mip) + " layer " + std::to_string(layer) + " face "
-                   + std::to_string(face) + " from the stream failed. Is the stream truncated?";
-          }
-        }
+        break;
       }
-    }
-    else
-    {
-      //               decompression     transcoding
-      // supercompressedData -> inflatedData -> subresource
-      //                             ^
-      //                             |
-      //                             in the ETC1S + UASTC case, we load file data into here directly
-      //                             (it turns out ETC1S doesn't do anything per-level)
-      if(header.supercompressionScheme == 0)
+      windowBytes += std::min(levelBytes, readSettings.parallel_read_budget_in_bytes - windowBytes);
+
+      readError = ReadKTX2Level(input, view_source, start_pos, header, levelIndex, fileMip, uint32_t(mip), levelFormat,
+                                input_supercompression, basisETC1SNumSlices, validation_input_size, readSettings, *this, levels[mip]);
+      for(size_t i = 0; i < levels[mip].subresourceViews.size(); i++)
       {
-        // UASTC, ETC1S: Load file data into inflatedData directly
-        UNWRAP_ERROR(ResizeVectorOrError(inflatedData, levelIndex.uncompressedByteLength));
-        if(!input.read(inflatedData.data(), levelIndex.uncompressedByteLength))
-        {
-          return "Reading mip " + std::to_string(mip) + "'s data failed.";
-        }
+        views[subresourceIndex(uint32_t(mip), uint32_t(i / header.faceCount), uint32_t(i % header.faceCount))] =
+            levels[mip].subresourceViews[i];
       }
-      else if(header.supercompressionScheme == 1)
+      if(readError.has_value())
       {
-        // ETC1S files often have uncompressedByteLength set to 0 for some reason.
-        // In any case, we want to read the compressed byte length.
-        UNWRAP_ERROR(ResizeVectorOrError(inflatedData, levelIndex.byteLength));
-        if(!input.read(inflatedData.data(), levelIndex.byteLength))
-        {
-          return "Reading mip " + std::to_string(mip) + "'s data failed.";
-        }
+        break;
       }
-      else
-      {
-        // Read into supercompressedData
-        UNWRAP_ERROR(ResizeVectorOrError(supercompressedData, levelIndex.byteLength));
-        if(!input.read(supercompressedData.data(), levelIndex.byteLength))
-        {
-          return "Reading mip " + std::to_string(mip) + "'s supercompressed data failed.";
-        }
-
-        // Inflate the supercompressed data. We must use another buffer for this.
-        UNWRAP_ERROR(ResizeVectorOrError(inflatedData, levelIndex.uncompressedByteLength));
+      lowestReadMip = mip;
+    }
 
-        if(header.supercompressionScheme == 2)
-        {
-          // Zstandard
-#ifdef NVP_SUPPORTS_ZSTD
-          size_t zstdError = ZSTD_decompress(inflatedData.data(), inflatedData.size(),  //
-                                             supercompressedData.data(), supercompressedData.size());
-          if(ZSTD_isError(zstdError))
+    // Inflate each mip in parallel, and check sizes ahead of time to ensure we
+    // don't read out of bounds. This would otherwise result in an access
+    // violation on invalid_face_count_and_padding.ktx2, or on an otherwise
+    // truncated file. This doesn't apply to ETC1S, because it does inflation
+    // and transcoding all at once.
+    const uint64_t numReadMips = uint64_t(window_end - lowestReadMip);
+    nvutils::parallel_batches_pooled<1>(
+        numReadMips,
+        [&](uint64_t i, uint32_t /* threadIndex */) {
+          const uint32_t      mip   = uint32_t(lowestReadMip + i);
+          KTX2LevelReadState& level = levels[mip];
+          if(level.readIntoSubresources)
           {
-            const char* zstdErrorName = ZSTD_getErrorName(zstdError);
-            return "Mip " + std::to_string(mip) + " Zstandard inflation failed with the message '"
-                   + std::string(zstdErrorName) + "' (code " + std::to_string(zstdError) + ").";
+            return;
           }
-#else
-          assert(!"nv_ktx was compiled without Zstandard support, but the KTX stream was not rejected! This should never happen.");
-#endif
-        }
-        else if(header.supercompressionScheme == 3)
-        {
-          // Zlib
-#ifdef NVP_SUPPORTS_GZLIB
-          ScopedZlibDStream zlibStream;
-          int               zlibError = zlibStream.Init();
-          if(zlibError != Z_OK)
+  #ifdef NVP_SUPPORTS_ZSTD
+          ZSTD_DCtx* zstdDCtx = nullptr;
+          if(header.supercompressionScheme == 2)
           {
-            return "Zlib initialization failed (error code " + std::to_string(zlibError) + ").";
+            zstdDCtx = GetThreadZstdDContext();
+            if(zstdDCtx == nullptr)
+            {
+              level.error = "Initializing Zstandard context failed.";
+              return;
+            }
           }
-          if(supercompressedData.size() > UINT_MAX || inflatedData.size() > UINT_MAX)
+  #else
+          void* zstdDCtx = nullptr;
+  #endif
+          const uint32_t fileMip = mip + first_file_mip;
+          level.error            = InflateKTX2Level(header.supercompressionScheme, fileMip, zstdDCtx, zstdDDict, level);
+          if(!level.error.has_value() && header.supercompressionScheme != 1)
           {
-            return "Zlib compressed or decompressed data for mip " + std::to_string(mip) + " was larger than 4 GB.";
+            const size_t inflatedDataSize           = level.inflatedData.size();
+            const size_t expected_bytes_in_this_mip = level.inflatedFaceSize * subresourcesPerMip;
+            if(expected_bytes_in_this_mip > inflatedDataSize)
+            {
+              level.error = "Expected " + std::to_string(expected_bytes_in_this_mip) + " bytes in mip " + std::to_string(fileMip)
+                            + ", but the inflated data was only " + std::to_string(inflatedDataSize) + " bytes long.";
+            }
           }
-          zlibStream.stream.next_in   = reinterpret_cast<Bytef*>(supercompressedData.data());
-          zlibStream.stream.avail_in  = static_cast<uInt>(supercompressedData.size());
-          zlibStream.stream.next_out  = reinterpret_cast<Bytef*>(inflatedData.data());
-          zlibStream.stream.avail_out = static_cast<uInt>(inflatedData.size());
-          zlibError                   = inflate(&zlibStream.stream, Z_NO_FLUSH);
-          if(zlibError != Z_OK)
+        },
+        readSettings.num_threads);
+
+    // Write into each subresource, possibly transcoding from the source
+    // format to this->format (for UASTC and ETC1S).
+    if(input_supercompression == InputSupercompression::eBasisETC1S)
+    {
+  #ifdef NVP_SUPPORTS_BASISU
+      // Transcodes one ETC1S subresource of an inflated level, using `state`
+      // for the transcoder's temporary data.
+      TranscodeCache* cache           = readSettings.transcode_cache;
+      const auto      transcodeETC1S  = [&](uint32_t mip, uint32_t layer, uint32_t face,
+                                      basist::basisu_transcoder_state* state) -> ErrorWithText {
+        KTX2LevelReadState& level            = levels[mip];
+        std::vector<char>&  subresource_data = subresource(mip, layer, face);
+        UNWRAP_ERROR(ResizeVectorOrError(subresource_data, level.finalFaceSize));
+        const uint32_t fileMip    = mip + first_file_mip;
+        const size_t   numBlocksX = (level.mipWidth + 3) / 4;
+        const size_t   numBlocksY = (level.mipHeight + 3) / 4;
+        // Get the ETC1S image description
+        const size_t etc1sImageIdx =
+            (std::max(1u, num_layers_possibly_0) * size_t(fileMip) + size_t(layer)) * size_t(num_faces) + size_t(face);
+        const basist::ktx2_etc1s_image_desc imageDesc = basisLZDCtx.etc1sImageDescs[etc1sImageIdx];
+
+        // Video P-frames depend on earlier frames, so they can't be cached.
+        TranscodeCache::Key cacheKey;
+        if(cache && !isVideo)
+        {
+          const auto sliceSpan = [&](uint32_t offset, uint32_t length) -> std::span<const char> {
+            if(uint64_t(offset) + length > level.inflatedData.size())
+            {
+              return {};
+            }
+            return {level.inflatedData.data() + offset, length};
+          };
+          cacheKey = TranscodeCacheKey(sliceSpan(imageDesc.m_rgb_slice_byte_offset, imageDesc.m_rgb_slice_byte_length),
+                                       sliceSpan(imageDesc.m_alpha_slice_byte_offset, imageDesc.m_alpha_slice_byte_length),
+                                       level.mipWidth, level.mipHeight, level.mipDepth, uint32_t(basisDstFmt),
+                                       context.basisSGDDigest);
+          if(cache->find(cacheKey, subresource_data))
           {
-            return "Zlib inflation failed (error code " + std::to_string(zlibError) + ").";
+            return {};
           }
-          zlibStream.Free();
-#else
-          assert(!"nv_ktx was compiled without Zlib support, but the KTX stream was not rejected! This should never happen.");
-#endif
         }
-      }
 
-      // Check size ahead of time to ensure we don't read out of bounds.
-      // This would otherwise result in an access violation on
-      // invalid_face_count_and_padding.ktx2, or on an otherwise truncated file.
-      // This doesn't apply to ETC1S, because it does inflation and transcoding
-      // all at once.
-      if(header.supercompressionScheme != 1)
-      {
-        const size_t inflatedDataSize = inflatedData.size();
-        const size_t expected_bytes_in_this_mip = inflatedFaceSize * size_t(header.layerCount) * size_t(header.faceCount);
-        if(expected_bytes_in_this_mip > inflatedDataSize)
+        if(!basisLZDCtx.etc1sTranscoder->transcode_image(
+               basisDstFmt,                                            // Basis destination format
+               subresource_data.data(),                                // Output data
+               uint32_t(numBlocksX * numBlocksY),                      // Number of blocks in the output
+               reinterpret_cast<uint8_t*>(level.inflatedData.data()),  // Compressed data for this level
+               uint32_t(level.inflatedData.size()),                    // Compressed data length
+               uint32_t(numBlocksX), uint32_t(numBlocksY),             // Block dimensions
+               uint32_t(level.mipWidth), uint32_t(level.mipHeight),    // Pixel dimensions
+               fileMip,                                                // Mip number
+               imageDesc.m_rgb_slice_byte_offset, imageDesc.m_rgb_slice_byte_length,  // Range of first slice from the start of the compressed data
+               imageDesc.m_alpha_slice_byte_offset, imageDesc.m_alpha_slice_byte_length,  // Range of second slice from the start of the compressed data
+               0,                           // No need for nonstandard decoder flags here
+               (basisETC1SNumSlices == 2),  // Whether it has 2 slices or only 1
+               isVideo,                     // Whether this is ETC1S video
+               0,                           // Output row pitch in blocks, or 0
+               state,                       // Transcoder state
+               false))                      // Output in blocks, not pixels
         {
-          return "Expected " + std::to_string(expected_bytes_in_this_mip) + " bytes in mip " + std::to_string(mip)
-                 + ", but the inflated data was only " + std::to_string(inflatedDataSize) + " bytes long.";
+          return "Failed to decompress BasisLZ+ETC1S mip " + std::to_string(fileMip) + ", layer " + std::to_string(layer)
+                 + ", face " + std::to_string(face) + "!";
         }
-      }
+        if(cache && !isVideo)
+        {
+          cache->insert(cacheKey, subresource_data);
+        }
+        return {};
+      };
 
-      // Write into each subresource, possibly transcoding from the source
-      // format to this->format (for UASTC and ETC1S).
-      size_t inflatedDataPos = 0;  // Read position in inflatedData
-      for(uint32_t layer = 0; layer < header.layerCount; layer++)
+      if(isVideo)
       {
-        for(uint32_t face = 0; face < header.faceCount; face++)
+        // Each frame of an ETC1S video can depend on the previous one through
+        // the persistent transcoder state, so these are transcoded in order.
+        for(int mip = window_end - 1; mip >= lowestReadMip; mip--)
         {
-          std::vector<char>& subresource_data = subresource(mip, layer, face);
-          // As a fast-path, if we have only one layer and face and no transcoding, the output is the same as the input.
-          if(header.layerCount == 1 && header.faceCount == 1 && input_supercompression == InputSupercompression::eNone)
+          KTX2LevelReadState& level = levels[mip];
+          if(level.error.has_value())
           {
-            subresource_data = std::move(inflatedData);
-            break;  // since layerCount == 1 this breaks out of both loops.
-          }
-          // Otherwise, prepare the output buffer.
-          UNWRAP_ERROR(ResizeVectorOrError(subresource_data, finalFaceSize));
-
-          if(input_supercompression == InputSupercompression::eBasisUASTC)
-          {
-#ifdef NVP_SUPPORTS_BASISU
-            BasisUSingleton::GetInstance().TranscodeUASTCToBC7OrASTC44(subresource_data.data(),
-                                                                       &inflatedData[inflatedDataPos], mipWidth, mipHeight,
-                                                                       mipDepth, readSettings.device_supports_astc);
-#else
-            assert(!"nv_ktx was compiled without Basis support, but the KTX stream was not rejected! This should never happen.");
-#endif
+            break;
           }
-          else if(input_supercompression == InputSupercompression::eBasisETC1S)
+          for(uint32_t layer = 0; layer < header.layerCount && !level.error.has_value(); layer++)
           {
-#ifdef NVP_SUPPORTS_BASISU
-            // Get the ETC1S image description
-            const size_t etc1sImageIdx =
-                (std::max(1u, num_layers_possibly_0) * size_t(mip) + size_t(layer)) * size_t(num_faces) + size_t(face);
-            const basist::ktx2_etc1s_image_desc imageDesc  = basisLZDCtx.etc1sImageDescs[etc1sImageIdx];
-            const size_t                        numBlocksX = (mipWidth + 3) / 4;
-            const size_t                        numBlocksY = (mipHeight + 3) / 4;
-
-            if(!basisLZDCtx.etc1sTranscoder->transcode_image(
-                   basisDstFmt,                                      // Basis destination format
-                   subresource_data.data(),                          // Output data
-                   uint32_t(numBlocksX * numBlocksY),                // Number of blocks in the output
-                   reinterpret_cast<uint8_t*>(inflatedData.data()),  // Compressed data for this level
-                   uint32_t(inflatedData.size()),                    // Compressed data length
-                   uint32_t(numBlocksX), uint32_t(numBlocksY),       // Block dimensions
-                   uint32_t(mipWidth), uint32_t(mipHeight),          // Pixel dimensions
-                   uint32_t(mip),                                    // Mip number
-                   imageDesc.m_rgb_slice_byte_offset, imageDesc.m_rgb_slice_byte_length,  // Range of first slice from the start of the compressed data
-                   imageDesc.m_alpha_slice_byte_offset, imageDesc.m_alpha_slice_byte_length,  // Range of second slice from the start of the compressed data
-                   0,                                                    // No need for nonstandard decoder flags here
-                   (basisETC1SNumSlices == 2),                           // Whether it has 2 slices or only 1
-                   isVideo,                                              // Whether this is ETC1S video
-                   0,                                                    // Output row pitch in blocks, or 0
-                   &basisLZDCtx.ktx2TranscoderState.m_transcoder_state,  // Persistent transcoder state
-                   false))                                               // Output in blocks, not pixels
+            for(uint32_t face = 0; face < header.faceCount; face++)
             {
-              return "Failed to decompress BasisLZ+ETC1S mip " + std::to_string(mip) + ", layer "
-                     + std::to_string(layer) + ", face " + std::to_string(face) + "!";
+              level.error = transcodeETC1S(uint32_t(mip), layer, face, &basisLZDCtx.ktx2TranscoderState.m_transcoder_state);
+              if(level.error.has_value())
+              {
+                break;
+              }
             }
-#else
-            assert(!"nv_ktx was compiled without Basis support, but the KTX stream was not rejected! This should never happen.");
-#endif
           }
-          else
-          {
-            // Not UASTC or ETC1S, no transcoding needed
-            // We've checked to make sure this is okay above, but double-check
-            // here in case the behavior above changes in future versions of
-            // the code.
-            if(header.supercompressionScheme == 1)
-            {
-              return "Failed to read KTX2 file: BasisLZ supercompression was enabled, but control reached the non-BasisLZ copy. This should never happen.";
-            }
-            if(inflatedDataPos + inflatedFaceSize > inflatedData.size())
+          level.inflatedData = {};
+        }
+      }
+      else
+      {
+        // Other ETC1S images are independent, so we transcode all subresources
+        // in parallel. The ETC1S transcoder's codebooks are read-only while
+        // transcoding, and each thread gets its own transcoder state.
+        const uint32_t numStates =
+            (readSettings.num_threads == 1) ? 1 : std::max(1u, uint32_t(nvutils::get_thread_pool().get_thread_count()));
+        std::vector<basist::basisu_transcoder_state> threadStates(numStates);
+        nvutils::parallel_batches_pooled<1>(
+            numReadMips * subresourcesPerMip,
+            [&](uint64_t i, uint32_t threadIndex) {
+              const uint32_t      mip   = uint32_t(lowestReadMip + i / subresourcesPerMip);
+              KTX2LevelReadState& level = levels[mip];
+              if(level.error.has_value())
+              {
+                return;
+              }
+              const size_t subresourceInMip = size_t(i % subresourcesPerMip);
+              level.subresourceErrors[subresourceInMip] =
+                  transcodeETC1S(mip, uint32_t(subresourceInMip / header.faceCount),
+                                 uint32_t(subresourceInMip % header.faceCount), &threadStates[threadIndex]);
+            },
+            readSettings.num_threads);
+      }
+  #else
+      assert(!"nv_ktx was compiled without Basis support, but the KTX stream was not rejected! This should never happen.");
+  #endif
+    }
+    else if(input_supercompression == InputSupercompression::eBasisUASTC)
+    {
+  #ifdef NVP_SUPPORTS_BASISU
+      TranscodeKTX2UASTCLevels(levels, lowestReadMip, window_end, subresourcesPerMip, header.faceCount, *this, readSettings);
+  #else
+      assert(!"nv_ktx was compiled without Basis support, but the KTX stream was not rejected! This should never happen.");
+  #endif
+    }
+    else
+    {
+      // Flatten (mip, layer, face) so that many small subresources and a few
+      // large ones can both be spread over the thread pool.
+      nvutils::parallel_batches_pooled<1>(
+          numReadMips * subresourcesPerMip,
+          [&](uint64_t i, uint32_t /* threadIndex */) {
+            const uint32_t      mip   = uint32_t(lowestReadMip + i / subresourcesPerMip);
+            KTX2LevelReadState& level = levels[mip];
+            if(level.readIntoSubresources || level.error.has_value())
             {
-              return "Failed to read KTX2 file: the size of the inflated data didn't match the expected size.";
+              return;
             }
-            memcpy(subresource_data.data(), &inflatedData[inflatedDataPos], inflatedFaceSize);
-          }
+            const size_t   subresourceInMip = size_t(i % subresourcesPerMip);
+            const uint32_t layer            = uint32_t(subresourceInMip / header.faceCount);
+            const uint32_t face             = uint32_t(subresourceInMip % header.faceCount);
+            level.subresourceErrors[subresourceInMip] =
+                WriteKTX2Subresource(level, subresource(mip, layer, face), subresourceInMip, input_supercompression,
+                                     header.supercompressionScheme);
+          },
+          readSettings.num_threads);
+    }
 
-          // Advance to next image
-          inflatedDataPos += inflatedFaceSize;
+    // Return the first error in serial traversal order.
+    for(int mip = window_end - 1; mip >= lowestReadMip; mip--)
+    {
+      if(levels[mip].error.has_value())
+      {
+        return levels[mip].error;
+      }
+      for(const ErrorWithText& subresourceError : levels[mip].subresourceErrors)
+      {
+        if(subresourceError.has_value())
+        {
+          return subresourceError;
         }
       }
     }
-  }
+    if(readError.has_value())
+    {
+      return readError;
+    }
+    if(context.astcFormat != VK_FORMAT_UNDEFINED)
+    {
+      UNWRAP_ERROR(decodeASTCMips(context.astcFormat, uint32_t(lowestReadMip), uint32_t(window_end - lowestReadMip),
+                                  readSettings.num_threads));
+    }
 
+    // Release this window's temporary buffers before reading the next one.
+    for(int mip = lowestReadMip; mip < window_end; mip++)
+    {
+      levels[mip] = {};
+    }
+    window_end = lowestReadMip;
+  }
   return {};
 }
 
@@ -2079,6 +2827,106 @@ size_t LCM4(size_t n)
     return n * 4;
   }
 }
+
+#ifdef NVP_SUPPORTS_ZSTD
+// Concatenates all subresources of a mip in KTX2 order. If there's only one
+// subresource, returns a view of it instead, and `storage` is unused.
+ErrorWithText GetKTX2LevelBytes(const KTXImage&        image,
+                                uint32_t               mip,
+                                uint32_t               num_layers_or_1,
+                                size_t                 subresource_size_bytes,
+                                std::vector<char>&     storage,
+                                std::span<const char>& out)
+{
+  const size_t subresourcesPerMip = size_t(num_layers_or_1) * size_t(image.num_faces);
+  if(subresourcesPerMip == 1)
+  {
+    out = image.subresourceBytes(mip, 0, 0);
+    assert(out.size() == subresource_size_bytes);
+    return {};
+  }
+  UNWRAP_ERROR(ResizeVectorOrError(storage, subresourcesPerMip * subresource_size_bytes));
+  size_t pos_in_raw_data = 0;
+  for(uint32_t layer = 0; layer < num_layers_or_1; layer++)
+  {
+    for(uint32_t face = 0; face < image.num_faces; face++)
+    {
+      const std::span<const char> this_subresource = image.subresourceBytes(mip, layer, face);
+      assert(this_subresource.size() == subresource_size_bytes);
+      memcpy(&storage[pos_in_raw_data], this_subresource.data(), this_subresource.size());
+      pos_in_raw_data += this_subresource.size();
+    }
+  }
+  out = storage;
+  return {};
+}
+
+// Supercompresses all subresources of a mip, concatenated in KTX2 order, into
+// `out` using Zstandard, and with `zstdCDict` if it's not null.
+ErrorWithText ZstdCompressKTX2Level(const KTXImage&    image,
+                                    uint32_t           mip,
+                                    uint32_t           num_layers_or_1,
+                                    size_t             subresource_size_bytes,
+                                    ZSTD_CCtx*         zstdCCtx,
+                                    const ZSTD_CDict*  zstdCDict,
+                                    int                zstdLevel,
+                                    std::vector<char>& out)
+{
+  // Concatenate all face data into a single buffer, unless there's only one
+  // subresource, in which case we can compress it directly.
+  // (Note: could potentially have lower peak memory usage but be more
+  // complex using the Zstandard streaming API.)
+  std::vector<char>     rawData;
+  std::span<const char> rawSpan;
+  UNWRAP_ERROR(GetKTX2LevelBytes(image, mip, num_layers_or_1, subresource_size_bytes, rawData, rawSpan));
+
+  // Also allocate a buffer with the maximum possible compressed size needed.
+  // (Note that this is always larger than the source!)
+  // Also note that we'll always write the supercompressed data even when
+  // it's larger, as the client controls whether supercompression is used.
+  const size_t      supercompressedMaxSize = ZSTD_COMPRESSBOUND(rawSpan.size());
+  std::vector<char> supercompressedData;
+  try
+  {
+    supercompressedData.resize(supercompressedMaxSize);
+  }
+  catch(...)
+  {
+    return "Allocating memory for Zstandard supercompressed output failed!";
+  }
+
+  // Compress!
+  size_t errOrSize = 0;
+  if(zstdCDict != nullptr)
+  {
+    errOrSize = ZSTD_compress_usingCDict(zstdCCtx, supercompressedData.data(), supercompressedData.size(),
+                                         rawSpan.data(), rawSpan.size(), zstdCDict);
+  }
+  else
+  {
+    errOrSize = ZSTD_compressCCtx(zstdCCtx, supercompressedData.data(), supercompressedData.size(), rawSpan.data(),
+                                  rawSpan.size(), zstdLevel);
+  }
+  if(ZSTD_isError(errOrSize))
+  {
+    return "Zstandard supercompression returned error " + std::to_string(errOrSize) + ".";
+  }
+
+  if(errOrSize > supercompressedData.size())
+  {
+    assert(false);  // This should never happen
+    return "Zstandard supercompression returned a number that was larger than the size of the supercompressed data "
+           "buffer.";
+  }
+
+  // Since all mips are held until they're written, release the unused part
+  // of the buffer.
+  supercompressedData.resize(errOrSize);
+  supercompressedData.shrink_to_fit();
+  out = std::move(supercompressedData);
+  return {};
+}
+#endif
 }  // namespace
 
 
@@ -2177,7 +3025,7 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     params.m_validate_etc1s                   = false;
     params.m_compression_level                = writeSettings.etc1s_encoding_level;
     params.m_check_for_alpha                  = false;
-    params.m_multithreading                   = true;
+    params.m_multithreading                   = (writeSettings.num_threads != 1);
     params.m_create_ktx2_file                 = true;
     params.m_etc1s_quality_level              = 128;
 
@@ -2227,7 +3075,7 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
       {
         params.m_rdo_uastc_ldr_4x4                = true;
         params.m_rdo_uastc_ldr_4x4_quality_scalar = writeSettings.rdo_lambda;
-        params.m_rdo_uastc_ldr_4x4_multithreading = true;
+        params.m_rdo_uastc_ldr_4x4_multithreading = (writeSettings.num_threads != 1);
         params.m_ktx2_uastc_supercompression      = basist::ktx2_supercompression::KTX2_SS_ZSTANDARD;
         params.m_ktx2_zstd_supercompression_level = writeSettings.supercompression_level;
       }
@@ -2248,7 +3096,9 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     }
 
     // Create a job pool for multithreading
-    basisu::job_pool job_pool(std::thread::hardware_concurrency());
+    const uint32_t   basis_num_threads =
+        (writeSettings.num_threads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : writeSettings.num_threads;
+    basisu::job_pool job_pool(basis_num_threads);
     params.m_pJob_pool = &job_pool;
 
     // Copy key/value data, except for KTXwriter, since basisu will make its
@@ -2269,6 +3119,16 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     }
 
     // Copy image data. I believe these are in KTX2 order.
+    // We first create all the images, then fill them in parallel.
+    struct SourceImage
+    {
+      uint32_t       mip;
+      uint32_t       layer;
+      uint32_t       face;
+      basisu::image* image;
+    };
+    std::vector<SourceImage> source_images;
+    source_images.reserve(size_t(num_layers_or_1) * size_t(num_faces) * size_t(num_mips));
     params.m_source_images.reserve(size_t(num_layers_or_1) * size_t(num_faces));
     params.m_source_mipmap_images.reserve(size_t(num_layers_or_1) * size_t(num_faces));
     for(uint32_t layer = 0; layer < num_layers_or_1; layer++)
@@ -2282,11 +3142,8 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
         }
         for(uint32_t mip = 0; mip < num_mips; mip++)
         {
-          std::vector<char>& this_subresource = subresource(mip, layer, face);
-          const uint32_t     width            = std::max(1u, mip_0_width >> mip);
-          const uint32_t     height           = std::max(1u, mip_0_height >> mip);
-          const size_t       widthS           = static_cast<size_t>(width);
-          const size_t       heightS          = static_cast<size_t>(height);
+          const uint32_t width  = std::max(1u, mip_0_width >> mip);
+          const uint32_t height = std::max(1u, mip_0_height >> mip);
           // Mip 0 images go in m_source_images, while higher mips go in m_source_mipmap_images.
           if(mip == 0)
           {
@@ -2296,8 +3153,31 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
           {
             params.m_source_mipmap_images.back().push_back(basisu::image(width, height));
           }
-          basisu::image& out_image = (mip == 0 ? params.m_source_images.back() : params.m_source_mipmap_images.back().back());
+        }
+      }
+    }
+    for(uint32_t layer = 0; layer < num_layers_or_1; layer++)
+    {
+      for(uint32_t face = 0; face < num_faces; face++)
+      {
+        const size_t image_index = size_t(layer) * size_t(num_faces) + size_t(face);
+        for(uint32_t mip = 0; mip < num_mips; mip++)
+        {
+          basisu::image& out_image =
+              (mip == 0 ? params.m_source_images[image_index] : params.m_source_mipmap_images[image_index][mip - 1]);
+          source_images.push_back({mip, layer, face, &out_image});
+        }
+      }
+    }
 
+    nvutils::parallel_batches_pooled<1>(
+        source_images.size(),
+        [&](uint64_t i, uint32_t) {
+          const SourceImage&          source           = source_images[i];
+          const std::span<const char> this_subresource = subresourceBytes(source.mip, source.layer, source.face);
+          basisu::image&              out_image        = *source.image;
+          const size_t                widthS           = static_cast<size_t>(out_image.get_width());
+          const size_t                heightS          = static_cast<size_t>(out_image.get_height());
           for(size_t y = 0; y < heightS; y++)
           {
             for(size_t x = 0; x < widthS; x++)
@@ -2311,9 +3191,8 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
                        a);                                                                // A from A
             }
           }
-        }
-      }
-    }
+        },
+        writeSettings.num_threads);
 
     // Create the KTX2 data!
     basisu::basis_compressor basis_compressor;
@@ -2914,6 +3793,21 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     key_value_data["KTXwriter"] = StringToCharVector("nvpro-samples' nv_ktx version 1.0.1");
   }
 
+  // Record the Zstandard dictionary, or remove a stale ID from a file that
+  // was read in.
+  if(writeSettings.supercompression == WriteSupercompressionType::ZSTD && writeSettings.zstd_dictionary != nullptr)
+  {
+    if(writeSettings.zstd_dictionary->getID() == 0)
+    {
+      return "WriteSettings::zstd_dictionary was set, but the dictionary wasn't loaded.";
+    }
+    key_value_data[kZstdDictionaryIDKey] = StringToCharVector(std::to_string(writeSettings.zstd_dictionary->getID()));
+  }
+  else
+  {
+    key_value_data.erase(kZstdDictionaryIDKey);
+  }
+
   // We now know the offset of the key/value data.
   header.kvdByteOffset = static_cast<uint32_t>(output.tellp() - start_pos);
   header.kvdByteLength = 0;
@@ -2969,16 +3863,21 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     return "Error getting the texel block size for VkFormat " + std::to_string(format) + "!";
   }
 
-// Zstandard supercompression context
+// Zstandard supercompression contexts. We use one context per thread;
+// contexts other than the first are created as needed.
 #ifdef NVP_SUPPORTS_ZSTD
-  ScopedZstdCContext zstdContext;
-  int                zstd_clamped_supercompression_level = writeSettings.supercompression_level;
+  std::vector<ScopedZstdCContext> zstdContexts;
+  int                             zstd_clamped_supercompression_level = writeSettings.supercompression_level;
+  const ZSTD_CDict*               zstdCDict                           = nullptr;
 #endif
   if(writeSettings.supercompression == WriteSupercompressionType::ZSTD)
   {
 #ifdef NVP_SUPPORTS_ZSTD
-    zstdContext.Init();
-    if(zstdContext.pCtx == nullptr)
+    const uint32_t numZstdCCtxs =
+        (writeSettings.num_threads == 1) ? 1 : std::max(1u, uint32_t(nvutils::get_thread_pool().get_thread_count()));
+    zstdContexts = std::vector<ScopedZstdCContext>(numZstdCCtxs);
+    zstdContexts[0].Init();
+    if(zstdContexts[0].pCtx == nullptr)
     {
       return "Initializing the Zstandard context for supercompression failed!";
     }
@@ -2991,10 +3890,68 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
       zstd_clamped_supercompression_level = zstdMinLevel;
     if(zstd_clamped_supercompression_level > zstdMaxLevel)
       zstd_clamped_supercompression_level = zstdMaxLevel;
+
+    if(writeSettings.zstd_dictionary != nullptr)
+    {
+      zstdCDict = writeSettings.zstd_dictionary->getCDict(zstd_clamped_supercompression_level);
+      if(zstdCDict == nullptr)
+      {
+        return "Digesting the Zstandard dictionary for supercompression failed!";
+      }
+    }
 #else
     return "Zstandard supercompression was selected for KTX2 writing, but nv_ktx was built without Zstd!";
 #endif
   }
+  else if(writeSettings.supercompression != WriteSupercompressionType::NONE)
+  {
+    return "Only Zstandard supercompression is currently supported.";
+  }
+
+  // Compute the size of each subresource and mip in bytes.
+  std::vector<size_t> subresourceSizes(num_mips);
+  for(int64_t mip = static_cast<int64_t>(num_mips) - 1; mip >= 0; mip--)
+  {
+    const size_t mipWidth  = std::max(1u, mip_0_width >> mip);
+    const size_t mipHeight = std::max(1u, mip_0_height >> mip);
+    const size_t mipDepth  = std::max(1u, mip_0_depth >> mip);
+    UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, format, subresourceSizes[mip], writeSettings.custom_size_callback));
+    levelIndex[mip].uncompressedByteLength = size_t(num_layers_or_1) * size_t(num_faces) * subresourceSizes[mip];
+  }
+
+  // Supercompress all mips in parallel before writing them. Each mip is
+  // compressed independently with the same parameters, so the output is the
+  // same no matter how many threads we use.
+  std::vector<std::vector<char>> supercompressedLevels;
+#ifdef NVP_SUPPORTS_ZSTD
+  if(writeSettings.supercompression == WriteSupercompressionType::ZSTD)
+  {
+    supercompressedLevels.resize(num_mips);
+    std::vector<ErrorWithText> levelErrors(num_mips);
+    nvutils::parallel_batches_pooled<1>(
+        num_mips,
+        [&](uint64_t mip, uint32_t threadIndex) {
+          ScopedZstdCContext& threadZstdCCtx = zstdContexts[threadIndex];
+          if(threadZstdCCtx.pCtx == nullptr)
+          {
+            threadZstdCCtx.Init();
+            if(threadZstdCCtx.pCtx == nullptr)
+            {
+              levelErrors[mip] = "Initializing the Zstandard context for supercompression failed!";
+              return;
+            }
+          }
+          levelErrors[mip] = ZstdCompressKTX2Level(*this, uint32_t(mip), num_layers_or_1, subresourceSizes[mip], threadZstdCCtx.pCtx,
+                                                   zstdCDict, zstd_clamped_supercompression_level, supercompressedLevels[mip]);
+        },
+        writeSettings.num_threads);
+    // Report errors in the order the serial writer would have found them.
+    for(int64_t mip = static_cast<int64_t>(num_mips) - 1; mip >= 0; mip--)
+    {
+      UNWRAP_ERROR(levelErrors[mip]);
+    }
+  }
+#endif
 
   // Write mips from smallest to largest.
   for(int64_t mip = static_cast<int64_t>(num_mips) - 1; mip >= 0; mip--)
@@ -3017,17 +3974,6 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     // We now know levels[mip].byteOffset, which comes after mip padding.
     levelIndex[mip].byteOffset = output.tellp() - start_pos;
 
-    const size_t mipWidth  = std::max(1u, mip_0_width >> mip);
-    const size_t mipHeight = std::max(1u, mip_0_height >> mip);
-    const size_t mipDepth  = std::max(1u, mip_0_depth >> mip);
-
-    // The size of each subresource of this mip in bytes.
-    size_t subresource_size_bytes = 0;
-    UNWRAP_ERROR(ExportSizeExtended(mipWidth, mipHeight, mipDepth, format, subresource_size_bytes, writeSettings.custom_size_callback));
-
-    // Compute the size of this mip in bytes.
-    levelIndex[mip].uncompressedByteLength = size_t(num_layers_or_1) * size_t(num_faces) * subresource_size_bytes;
-
     // If not supercompressing, write each face to the file.
     if(writeSettings.supercompression == WriteSupercompressionType::NONE)
     {
@@ -3035,8 +3981,8 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
       {
         for(uint32_t face = 0; face < num_faces; face++)
         {
-          const std::vector<char>& this_subresource = subresource(static_cast<uint32_t>(mip), layer, face);
-          assert(this_subresource.size() == subresource_size_bytes);
+          const std::span<const char> this_subresource = subresourceBytes(static_cast<uint32_t>(mip), layer, face);
+          assert(this_subresource.size() == subresourceSizes[mip]);
           if(!output.write(this_subresource.data(), this_subresource.size()))
           {
             return "Writing mip " + std::to_string(mip) + " layer " + std::to_string(layer) + " face "
@@ -3048,72 +3994,13 @@ ErrorWithText KTXImage::writeKTX2Stream(std::ostream& output, const WriteSetting
     }
     else
     {
-// We currently only support Zstd for writing.
-#ifndef NVP_SUPPORTS_ZSTD
-      return "Zstandard supercompression was selected, but nv_ktx was built without Zstd and execution reached the "
-             "levelImages loop. This should never happen.";
-#else
-      if(writeSettings.supercompression != WriteSupercompressionType::ZSTD)
-      {
-        return "Only Zstandard supercompression is currently supported.";
-      }
-      // Concatenate all face data into a single buffer.
-      // (Note: could potentially have lower peak memory usage but be more
-      // complex using the Zstandard streaming API.)
-      std::vector<char> rawData;
-      {
-        UNWRAP_ERROR(ResizeVectorOrError(rawData, levelIndex[mip].uncompressedByteLength));
-        size_t pos_in_raw_data = 0;
-        for(uint32_t layer = 0; layer < num_layers_or_1; layer++)
-        {
-          for(uint32_t face = 0; face < num_faces; face++)
-          {
-            const std::vector<char>& this_subresource = subresource(uint32_t(mip), layer, face);
-            assert(this_subresource.size() == subresource_size_bytes);
-            memcpy(&rawData[pos_in_raw_data], this_subresource.data(), this_subresource.size());
-            pos_in_raw_data += this_subresource.size();
-          }
-        }
-      }
-
-      // Also allocate a buffer with the maximum possible compressed size needed.
-      // (Note that this is always larger than the source!)
-      // Also note that we'll always write the supercompressed data even when
-      // it's larger, as the client controls whether supercompression is used.
-      const size_t      fullMipUncompressedLength = levelIndex[mip].uncompressedByteLength;
-      const size_t      supercompressedMaxSize    = ZSTD_COMPRESSBOUND(fullMipUncompressedLength);
-      std::vector<char> supercompressedData;
-      try
-      {
-        supercompressedData.resize(supercompressedMaxSize);
-      }
-      catch(...)
-      {
-        return "Allocating memory for Zstandard supercompressed output failed!";
-      }
-
-      // Compress!
-      size_t errOrSize = ZSTD_compressCCtx(zstdContext.pCtx, supercompressedData.data(), supercompressedData.size(),
-                                           rawData.data(), rawData.size(), zstd_clamped_supercompression_level);
-      if(ZSTD_isError(errOrSize))
-      {
-        return "Zstandard supercompression returned error " + std::to_string(errOrSize) + ".";
-      }
-
-      if(errOrSize > supercompressedData.size())
-      {
-        assert(false);  // This should never happen
-        return "ZSTD_compressCCtx returned a number that was larger than the size of the supercompressed data "
-               "buffer.";
-      }
-
-      // Write the supercompressed data to the file.
-      if(!output.write(supercompressedData.data(), errOrSize))
+      // Write the supercompressed data to the file, then free it.
+      std::vector<char> supercompressedData = std::move(supercompressedLevels[mip]);
+      if(!output.write(supercompressedData.data(), supercompressedData.size()))
       {
         return "Writing mip " + std::to_string(mip) + "'s supercompressed data to the file failed!";
       }
-      levelIndex[mip].byteLength = errOrSize;
-#endif
+      levelIndex[mip].byteLength = supercompressedData.size();
     }
   }
 
@@ -3168,6 +4055,36 @@ ErrorWithText KTXImage::writeKTX2File(const char* filename, const WriteSettings&
   return writeKTX2Stream(output, writeSettings);
 }
 
+std::vector<ErrorWithText> writeKTX2Files(std::span<KTXImage>          images,
+                                          std::span<const std::string> filenames,
+                                          const WriteSettings&         writeSettings)
+{
+  std::vector<ErrorWithText> errors(images.size());
+  if(filenames.size() != images.size())
+  {
+    const std::string error = "writeKTX2Files was called with " + std::to_string(images.size()) + " images, but "
+                              + std::to_string(filenames.size()) + " filenames.";
+    std::fill(errors.begin(), errors.end(), error);
+    return errors;
+  }
+
+  if(images.size() == 1)
+  {
+    errors[0] = images[0].writeKTX2File(filenames[0].c_str(), writeSettings);
+    return errors;
+  }
+
+  // Parallelize over images instead of within each image; this avoids
+  // oversubscribing threads with Basis Universal's job pool.
+  WriteSettings imageWriteSettings = writeSettings;
+  imageWriteSettings.num_threads   = 1;
+  nvutils::parallel_batches_pooled<1>(
+      images.size(),
+      [&](uint64_t i, uint32_t) { errors[i] = images[i].writeKTX2File(filenames[i].c_str(), imageWriteSettings); },
+      writeSettings.num_threads);
+  return errors;
+}
+
 //-----------------------------------------------------------------------------
 // KTX1/KTX2 READING BRANCH
 //-----------------------------------------------------------------------------
@@ -3203,6 +4120,499 @@ ErrorWithText KTXImage::readFromFile(const char* filename, const ReadSettings& r
   return readFromStream(input_stream, readSettings);
 }
 
+ErrorWithText KTXImage::readFromMemoryView(std::span<const std::byte> input, const ReadSettings& readSettings)
+{
+  const std::span<const char> memory(reinterpret_cast<const char*>(input.data()), input.size());
+  MemoryStreamBuffer          streamBuffer(memory);
+  std::istream                inputStream(&streamBuffer);
+  // The readers view `memory` while this is set.
+  view_source                   = memory;
+  const ErrorWithText maybeError = readFromStream(inputStream, readSettings);
+  view_source                   = {};
+  return maybeError;
+}
+
+std::vector<ErrorWithText> readKTXFiles(std::span<KTXImage>          images,
+                                        std::span<const std::string> filenames,
+                                        const ReadSettings&          readSettings)
+{
+  std::vector<ErrorWithText> errors(images.size());
+  if(filenames.size() != images.size())
+  {
+    const std::string error = "readKTXFiles was called with " + std::to_string(images.size()) + " images, but "
+                              + std::to_string(filenames.size()) + " filenames.";
+    std::fill(errors.begin(), errors.end(), error);
+    return errors;
+  }
+
+  // With fewer files than threads, one task per file would leave threads
+  // idle, so we instead spread each file's work over the whole pool.
+  const size_t numThreads =
+      (readSettings.num_threads == 1) ? 1 : std::max(size_t(1), size_t(nvutils::get_thread_pool().get_thread_count()));
+  if(numThreads == 1 || images.size() < numThreads)
+  {
+    for(size_t i = 0; i < images.size(); i++)
+    {
+      errors[i] = images[i].readFromFile(filenames[i].c_str(), readSettings);
+    }
+    return errors;
+  }
+
+  ReadSettings imageReadSettings = readSettings;
+  imageReadSettings.num_threads  = 1;
+  nvutils::parallel_batches_pooled<1>(
+      images.size(), [&](uint64_t i, uint32_t) { errors[i] = images[i].readFromFile(filenames[i].c_str(), imageReadSettings); },
+      readSettings.num_threads);
+  return errors;
+}
+
+//-----------------------------------------------------------------------------
+// TranscodeCache
+//-----------------------------------------------------------------------------
+
+struct TranscodeCache::Impl
+{
+  struct Entry
+  {
+    Key               key;
+    std::vector<char> data;
+  };
+  // The digest is already uniformly distributed.
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const { return nvutils::Sha256DigestHash{}(key.digest); }
+  };
+  mutable std::mutex mutex;
+  size_t             maxBytes     = 0;
+  size_t             currentBytes = 0;
+  uint64_t           hits         = 0;
+  uint64_t           misses       = 0;
+  // Most recently used entries are at the front.
+  std::list<Entry>                                                entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup;
+
+  void erase(std::list<Entry>::iterator it)
+  {
+    currentBytes -= it->data.size();
+    lookup.erase(it->key);
+    entries.erase(it);
+  }
+};
+
+TranscodeCache::TranscodeCache(size_t max_bytes)
+    : m_impl(std::make_unique<Impl>())
+{
+  m_impl->maxBytes = max_bytes;
+}
+
+TranscodeCache::~TranscodeCache() = default;
+
+bool TranscodeCache::find(const Key& key, std::span<char> output)
+{
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  const auto                  it = m_impl->lookup.find(key);
+  if(it == m_impl->lookup.end() || it->second->data.size() != output.size())
+  {
+    m_impl->misses++;
+    return false;
+  }
+  m_impl->entries.splice(m_impl->entries.begin(), m_impl->entries, it->second);
+  memcpy(output.data(), it->second->data.data(), output.size());
+  m_impl->hits++;
+  return true;
+}
+
+void TranscodeCache::insert(const Key& key, std::span<const char> data)
+{
+  if(data.size() > m_impl->maxBytes)
+  {
+    return;
+  }
+  // Copy outside the lock, since entries can be large.
+  Impl::Entry entry{key, std::vector<char>(data.begin(), data.end())};
+
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  const auto                  existing = m_impl->lookup.find(key);
+  if(existing != m_impl->lookup.end())
+  {
+    m_impl->erase(existing->second);
+  }
+  while(m_impl->currentBytes + data.size() > m_impl->maxBytes)
+  {
+    m_impl->erase(std::prev(m_impl->entries.end()));
+  }
+  m_impl->currentBytes += data.size();
+  m_impl->entries.push_front(std::move(entry));
+  m_impl->lookup[key] = m_impl->entries.begin();
+}
+
+void TranscodeCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  m_impl->entries.clear();
+  m_impl->lookup.clear();
+  m_impl->currentBytes = 0;
+}
+
+size_t TranscodeCache::getSizeBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  return m_impl->currentBytes;
+}
+
+uint64_t TranscodeCache::getHitCount() const
+{
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  return m_impl->hits;
+}
+
+uint64_t TranscodeCache::getMissCount() const
+{
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  return m_impl->misses;
+}
+
+//-----------------------------------------------------------------------------
+// Zstandard dictionaries
+//-----------------------------------------------------------------------------
+
+#ifdef NVP_SUPPORTS_ZSTD
+namespace {
+// Returns the ID of a raw-content Zstandard dictionary: the first 4 bytes of
+// the SHA-256 digest of its contents (big-endian), mapped into the range
+// Zstandard leaves for user dictionaries, [32768, 2^32). Files store this ID,
+// so it must be the same on every platform and build.
+uint32_t RawZstdDictionaryID(std::span<const char> data)
+{
+  const nvutils::Sha256Digest digest = nvutils::sha256(std::as_bytes(data));
+  const uint64_t hash = (uint64_t(digest[0]) << 24) | (uint64_t(digest[1]) << 16) | (uint64_t(digest[2]) << 8) | digest[3];
+  return uint32_t(32768 + hash % ((uint64_t(1) << 32) - 32768));
+}
+
+// Parameters for TrainRawZstdDictionary: dictionaries are built from segments
+// of kZstdTrainingSegmentSize bytes, scored by how common their 8-byte
+// substrings are, with hash tables of 2^kZstdTrainingHashBits entries.
+constexpr size_t   kZstdTrainingSegmentSize = 128;
+constexpr size_t   kZstdTrainingDmerSize    = 8;
+constexpr uint32_t kZstdTrainingHashBits    = 20;
+
+uint32_t HashDmer(const char* p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return uint32_t((v * 0xCF1BBCDCB7A56463ull) >> (64 - kZstdTrainingHashBits));
+}
+
+// Builds a raw-content dictionary from the most useful segments of `samples`,
+// following the COVER algorithm from Zstandard's dictionary builder (which
+// isn't part of our Zstandard build): the samples are split into epochs, and
+// each round picks the segment of each epoch whose distinct 8-byte substrings
+// are most frequent across all samples, then zeroes those substrings'
+// frequencies so later segments cover new content. Segments picked first are
+// placed at the end of the dictionary, where matches are cheapest.
+ErrorWithText TrainRawZstdDictionary(std::span<const char> samples, size_t maxDictionarySize, std::vector<char>& dictionary)
+{
+  const size_t numDmers = samples.size() - kZstdTrainingDmerSize + 1;
+  std::vector<uint32_t> frequencies;
+  std::vector<uint16_t> segmentCounts;
+  UNWRAP_ERROR(ResizeVectorOrError(frequencies, size_t(1) << kZstdTrainingHashBits));
+  UNWRAP_ERROR(ResizeVectorOrError(segmentCounts, size_t(1) << kZstdTrainingHashBits));
+  for(size_t i = 0; i < numDmers; i++)
+  {
+    frequencies[HashDmer(samples.data() + i)]++;
+  }
+
+  // Use about 4 segments per epoch per pass, like COVER.
+  const size_t numEpochs  = std::max(size_t(1), std::min(maxDictionarySize / kZstdTrainingSegmentSize / 4, numDmers / kZstdTrainingSegmentSize));
+  const size_t epochSize  = numDmers / numEpochs;
+  UNWRAP_ERROR(ResizeVectorOrError(dictionary, maxDictionarySize));
+  size_t tail          = maxDictionarySize;
+  size_t zeroScoreRuns = 0;
+  for(size_t epoch = 0; tail > 0 && zeroScoreRuns < numEpochs; epoch = (epoch + 1) % numEpochs)
+  {
+    const size_t begin = epoch * epochSize;
+    const size_t end   = std::min(numDmers, begin + epochSize);
+
+    // Slide a window of dmers over the epoch; `score` is the total frequency
+    // of the distinct dmers in the window.
+    uint64_t score = 0, bestScore = 0;
+    size_t   windowBegin = begin, bestBegin = begin, bestEnd = begin;
+    for(size_t i = begin; i < end; i++)
+    {
+      const uint32_t hash = HashDmer(samples.data() + i);
+      if(segmentCounts[hash]++ == 0)
+      {
+        score += frequencies[hash];
+      }
+      if(i + kZstdTrainingDmerSize - windowBegin > kZstdTrainingSegmentSize)
+      {
+        const uint32_t oldHash = HashDmer(samples.data() + windowBegin);
+        if(--segmentCounts[oldHash] == 0)
+        {
+          score -= frequencies[oldHash];
+        }
+        windowBegin++;
+      }
+      if(score > bestScore)
+      {
+        bestScore = score;
+        bestBegin = windowBegin;
+        bestEnd   = i + kZstdTrainingDmerSize;
+      }
+    }
+    for(size_t i = windowBegin; i < end; i++)
+    {
+      segmentCounts[HashDmer(samples.data() + i)] = 0;
+    }
+
+    if(bestScore == 0)
+    {
+      zeroScoreRuns++;
+      continue;
+    }
+    zeroScoreRuns = 0;
+    for(size_t i = bestBegin; i + kZstdTrainingDmerSize <= bestEnd; i++)
+    {
+      frequencies[HashDmer(samples.data() + i)] = 0;
+    }
+    const size_t segmentSize = std::min(bestEnd - bestBegin, tail);
+    tail -= segmentSize;
+    memcpy(dictionary.data() + tail, samples.data() + bestBegin, segmentSize);
+  }
+
+  // If we ran out of useful segments, the dictionary is smaller.
+  dictionary.erase(dictionary.begin(), dictionary.begin() + tail);
+  return {};
+}
+}  // namespace
+#endif
+
+struct ZstdDictionary::Impl
+{
+  std::vector<char> data;
+  uint32_t          id = 0;
+#ifdef NVP_SUPPORTS_ZSTD
+  ZSTD_DDict* dDict = nullptr;
+  // Digested dictionaries for compression, by compression level.
+  mutable std::mutex                  cDictMutex;
+  mutable std::map<int, ZSTD_CDict*> cDicts;
+
+  void free()
+  {
+    ZSTD_freeDDict(dDict);
+    dDict = nullptr;
+    for(auto& [level, cDict] : cDicts)
+    {
+      ZSTD_freeCDict(cDict);
+    }
+    cDicts.clear();
+  }
+  ~Impl() { free(); }
+#endif
+};
+
+ZstdDictionary::ZstdDictionary()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+ZstdDictionary::~ZstdDictionary() = default;
+
+ErrorWithText ZstdDictionary::load(std::span<const char> data)
+{
+#ifdef NVP_SUPPORTS_ZSTD
+  m_impl->free();
+  m_impl->id = 0;
+  m_impl->data.assign(data.begin(), data.end());
+  if(data.empty())
+  {
+    return "The Zstandard dictionary was empty.";
+  }
+  // Dictionaries in Zstandard's format (e.g. from `zstd --train`) store
+  // their ID. Other data is used as a raw-content dictionary, which has no ID,
+  // so we derive one from its contents.
+  uint32_t       id    = 0;
+  const uint32_t magic = ZSTD_MAGIC_DICTIONARY;
+  if(data.size() >= sizeof(magic) && memcmp(data.data(), &magic, sizeof(magic)) == 0)
+  {
+    id = ZSTD_getDictID_fromDict(data.data(), data.size());
+    if(id == 0)
+    {
+      return "The Zstandard dictionary was invalid.";
+    }
+  }
+  else
+  {
+    id = RawZstdDictionaryID(data);
+  }
+  m_impl->dDict = ZSTD_createDDict(m_impl->data.data(), m_impl->data.size());
+  if(m_impl->dDict == nullptr)
+  {
+    return "Digesting the Zstandard dictionary failed.";
+  }
+  m_impl->id = id;
+  return {};
+#else
+  return "nv_ktx was built without Zstd.";
+#endif
+}
+
+uint32_t ZstdDictionary::getID() const
+{
+  return m_impl->id;
+}
+
+std::span<const char> ZstdDictionary::getData() const
+{
+  return m_impl->data;
+}
+
+const ZSTD_DDict_s* ZstdDictionary::getDDict() const
+{
+#ifdef NVP_SUPPORTS_ZSTD
+  return m_impl->dDict;
+#else
+  return nullptr;
+#endif
+}
+
+const ZSTD_CDict_s* ZstdDictionary::getCDict(int compression_level) const
+{
+#ifdef NVP_SUPPORTS_ZSTD
+  if(m_impl->id == 0)
+  {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(m_impl->cDictMutex);
+  ZSTD_CDict*&                cDict = m_impl->cDicts[compression_level];
+  if(cDict == nullptr)
+  {
+    cDict = ZSTD_createCDict(m_impl->data.data(), m_impl->data.size(), compression_level);
+  }
+  return cDict;
+#else
+  return nullptr;
+#endif
+}
+
+ErrorWithText ZstdDictionaryCache::add(std::span<const char> data)
+{
+  std::shared_ptr<ZstdDictionary> dictionary = std::make_shared<ZstdDictionary>();
+  UNWRAP_ERROR(dictionary->load(data));
+  add(std::move(dictionary));
+  return {};
+}
+
+void ZstdDictionaryCache::add(std::shared_ptr<const ZstdDictionary> dictionary)
+{
+  if(dictionary == nullptr || dictionary->getID() == 0)
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dictionaries[dictionary->getID()] = std::move(dictionary);
+}
+
+std::shared_ptr<const ZstdDictionary> ZstdDictionaryCache::find(uint32_t id) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto                  it = m_dictionaries.find(id);
+  return (it == m_dictionaries.end()) ? nullptr : it->second;
+}
+
+ErrorWithText trainZstdDictionary(std::span<const KTXImage> samples, size_t max_dictionary_size, std::vector<char>& dictionary)
+{
+#ifdef NVP_SUPPORTS_ZSTD
+  // Concatenate all samples.
+  std::vector<char> sampleData;
+  for(const KTXImage& image : samples)
+  {
+    const uint32_t num_layers_or_1 = std::max(1u, image.num_layers_possibly_0);
+    for(uint32_t mip = 0; mip < image.num_mips; mip++)
+    {
+      size_t subresourceSize = 0;
+      UNWRAP_ERROR(ExportSizeExtended(std::max(1u, image.mip_0_width >> mip), std::max(1u, image.mip_0_height >> mip),
+                                      std::max(1u, image.mip_0_depth >> mip), image.format, subresourceSize, nullptr));
+      std::vector<char>     storage;
+      std::span<const char> levelBytes;
+      UNWRAP_ERROR(GetKTX2LevelBytes(image, mip, num_layers_or_1, subresourceSize, storage, levelBytes));
+      sampleData.insert(sampleData.end(), levelBytes.begin(), levelBytes.end());
+    }
+  }
+  if(sampleData.size() < max_dictionary_size || sampleData.size() < kZstdTrainingSegmentSize)
+  {
+    return "trainZstdDictionary was given " + std::to_string(sampleData.size()) + " bytes of samples for a "
+           + std::to_string(max_dictionary_size) + "-byte dictionary; it needs many times more.";
+  }
+  UNWRAP_ERROR(TrainRawZstdDictionary(sampleData, max_dictionary_size, dictionary));
+  if(dictionary.empty())
+  {
+    return "Training the Zstandard dictionary failed: the samples had no repeated content.";
+  }
+  return {};
+#else
+  return "nv_ktx was built without Zstd.";
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// KTXLevelReader
+//-----------------------------------------------------------------------------
+
+KTXLevelReader::KTXLevelReader()  = default;
+KTXLevelReader::~KTXLevelReader() = default;
+
+ErrorWithText KTXLevelReader::open(std::istream& input, const ReadSettings& readSettings)
+{
+  m_input        = &input;
+  m_readSettings = readSettings;
+  m_context      = std::make_unique<KTX2ReadContext>();
+  m_mipsRead.clear();
+  image.clear();
+
+  uint8_t identifier[IDENTIFIER_LEN]{};
+  if(!input.read(reinterpret_cast<char*>(identifier), IDENTIFIER_LEN))
+  {
+    return "Reading the identifier failed!";
+  }
+  if(memcmp(identifier, ktx2Identifier, IDENTIFIER_LEN) != 0)
+  {
+    return "Not a KTX2 file (first 12 bytes weren't the KTX2 identifier). KTXLevelReader doesn't support KTX1 files.";
+  }
+  image.read_ktx_version = 2;
+  UNWRAP_ERROR(image.readKTX2Header(input, m_readSettings, *m_context));
+  UNWRAP_ERROR(image.allocate(image.num_mips, image.num_layers_possibly_0, image.num_faces));
+  m_mipsRead.resize(image.num_mips, false);
+  return {};
+}
+
+ErrorWithText KTXLevelReader::openFile(const char* filename, const ReadSettings& readSettings)
+{
+  m_file = std::make_unique<std::ifstream>(filename, std::ifstream::in | std::ifstream::binary);
+  return open(*m_file, readSettings);
+}
+
+ErrorWithText KTXLevelReader::readMips(uint32_t first_mip, uint32_t mip_count)
+{
+  if(m_input == nullptr || m_mipsRead.empty())
+  {
+    return "KTXLevelReader::readMips() was called without successfully opening a KTX2 file first.";
+  }
+  // Clear errors from previous reads, such as reaching the end of the stream.
+  m_input->clear();
+  UNWRAP_ERROR(image.readKTX2Mips(*m_input, m_readSettings, *m_context, first_mip, mip_count));
+  for(uint32_t mip = first_mip; mip < first_mip + mip_count; mip++)
+  {
+    m_mipsRead[mip] = true;
+  }
+  return {};
+}
+
+bool KTXLevelReader::isMipRead(uint32_t mip) const
+{
+  return mip < m_mipsRead.size() && m_mipsRead[mip];
+}
+
 }  // namespace nv_ktx
 
 //-----------------------------------------------------------------------------
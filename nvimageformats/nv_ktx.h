@@ -22,11 +22,16 @@
 nv_ktx 1.0.1
 
 This is a mostly self-contained reader and writer for KTX2 files and reader
-for KTX1 files. It only relies on Vulkan (for KTX2), GL (for KTX1), and the
-Khronos Data Format.
+for KTX1 files. It only relies on Vulkan (for KTX2), GL (for KTX1), the
+Khronos Data Format, and nvutils' thread pool (for inflating and transcoding
+KTX2 levels in parallel).
 
 For example usage, please see usage_nv_ktx() at the end of nv_ktx.cpp.
 
+To read a subset of mips, see ReadSettings::first_mip and max_mips. To read
+mips of a KTX2 file one at a time (for instance, for texture streaming,
+starting from the smallest mips), use KTXLevelReader.
+
 Define `NVP_SUPPORTS_ZSTD`, `NVP_SUPPORTS_GZLIB`, and `NVP_SUPPORTS_BASISU` to
 include the Zstd, Zlib, and Basis Universal headers respectively, and to
 enable reading these formats. This will also enable writing Zstd and
@@ -38,14 +43,23 @@ Basis Universal-compressed formats.
 #define __NV_KTX_H__
 
 #include <array>
+#include <cstddef>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace nv_ktx {
+struct KTX2ReadContext;
+
 // These functions return an empty std::optional if they succeeded, and a
 // value with text describing the error if they failed.
 using ErrorWithText = std::optional<std::string>;
@@ -64,12 +78,116 @@ using KeyValueData = std::map<std::string, std::vector<char>>;
 // return a string; if it succeeds, it should return {}.
 using CustomExportSizeFuncPtr = ErrorWithText (*)(size_t, size_t, size_t, VkFormat, size_t&);
 
+// Caches the results of transcoding UASTC and BasisLZ+ETC1S subresources, so
+// that loading the same texture again -- for instance, when a scene is
+// reloaded -- skips transcoding. Share one cache between reads by setting
+// ReadSettings::transcode_cache. Entries are keyed by the size of each
+// subresource's source data and a SHA-256 digest of it and everything else
+// the transcode depends on (its size, transcode target, and ETC1S codebooks),
+// and a lookup only succeeds if all of these match. Once the cache holds more
+// than `max_bytes`, the least recently used entries are evicted.
+// Thread-safe.
+class TranscodeCache
+{
+public:
+  struct Key
+  {
+    uint64_t                source_size = 0;
+    std::array<uint8_t, 32> digest{};  // SHA-256
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  explicit TranscodeCache(size_t max_bytes = size_t(256) << 20);
+  ~TranscodeCache();
+  TranscodeCache(const TranscodeCache&)            = delete;
+  TranscodeCache& operator=(const TranscodeCache&) = delete;
+
+  // If there's an entry for `key` of size output.size(), copies it into
+  // `output` and returns true.
+  bool find(const Key& key, std::span<char> output);
+  // Adds or replaces the entry for `key`. Data larger than max_bytes is not
+  // cached.
+  void insert(const Key& key, std::span<const char> data);
+  // Removes all entries.
+  void clear();
+
+  // The total size of the cached data in bytes.
+  size_t getSizeBytes() const;
+  // The number of times find() returned true and false.
+  uint64_t getHitCount() const;
+  uint64_t getMissCount() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m_impl;
+};
+
+// A Zstandard dictionary, digested for supercompressing and inflating KTX2
+// levels. Large sets of small KTX2 files (icons, decals, LUTs) compress much
+// better when they share a dictionary: train one with trainZstdDictionary(),
+// write files with WriteSettings::zstd_dictionary, and read them with a
+// ZstdDictionaryCache that contains it. Files written this way store the
+// dictionary's ID in their "NVzstdDictionaryID" key; readers without the
+// dictionary can't inflate them. Thread-safe after load().
+class ZstdDictionary
+{
+public:
+  ZstdDictionary();
+  ~ZstdDictionary();
+  ZstdDictionary(const ZstdDictionary&)            = delete;
+  ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+
+  // Loads a dictionary from trainZstdDictionary() or `zstd --train`, and
+  // digests it for inflation.
+  ErrorWithText load(std::span<const char> data);
+
+  // The dictionary's ID, or 0 if it isn't loaded.
+  uint32_t getID() const;
+  // The dictionary's data, as passed to load().
+  std::span<const char> getData() const;
+
+  // For nv_ktx's reader and writer: the digested dictionary for inflation,
+  // and for supercompression at the given Zstandard level (digested on first
+  // use). Return nullptr if the dictionary isn't loaded.
+  const ZSTD_DDict_s* getDDict() const;
+  const ZSTD_CDict_s* getCDict(int compression_level) const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m_impl;
+};
+
+// Digested Zstandard dictionaries by ID, so that many reads can share them
+// through ReadSettings::zstd_dictionaries. Thread-safe.
+class ZstdDictionaryCache
+{
+public:
+  // Loads a dictionary and adds it, replacing any dictionary with the same ID.
+  ErrorWithText add(std::span<const char> data);
+  // Adds a loaded dictionary, replacing any dictionary with the same ID.
+  void add(std::shared_ptr<const ZstdDictionary> dictionary);
+  // Returns the dictionary with the given ID, or nullptr if there is none.
+  std::shared_ptr<const ZstdDictionary> find(uint32_t id) const;
+
+private:
+  mutable std::mutex                                        m_mutex;
+  std::map<uint32_t, std::shared_ptr<const ZstdDictionary>> m_dictionaries;
+};
+
 // Configurable settings for reading files. This is a struct so that it can
 // be extended in the future.
 struct ReadSettings
 {
   // Whether to read all mips (true), or only the base mip (false).
   bool mips = true;
+  // The first mip in the file to read. Mips before it are skipped without
+  // being read, and it becomes the image's mip 0: mip_0_width, mip_0_height,
+  // and mip_0_depth are its size. This is clamped to the file's last mip.
+  uint32_t first_mip = 0;
+  // The maximum number of mips to read, starting at first_mip. 0 is treated
+  // as 1, and `mips == false` limits this to 1.
+  uint32_t max_mips = UINT32_MAX;
   // See docs for CustomExportSizeFuncPtr
   CustomExportSizeFuncPtr custom_size_callback = nullptr;
   // If true, the reader will validate that the KTX file contains at least 1
@@ -86,6 +204,30 @@ struct ReadSettings
   // By default, UASTC is transcoded to BC7 instead of ASTC. Setting this to
   // true will transcode UASTC to ASTC.
   bool device_supports_astc = false;
+  // If true and device_supports_astc is false, files in ASTC formats are
+  // decoded on the CPU with texture_decode: LDR formats to
+  // VK_FORMAT_R8G8B8A8_UNORM or _SRGB, and HDR formats to
+  // VK_FORMAT_R16G16B16A16_SFLOAT. The decoded image takes 4 to 72 times as
+  // much memory as the ASTC data. Requires Basis Universal.
+  bool decode_astc_without_device_support = false;
+  // KTX2 levels are inflated and transcoded in parallel on nvutils' thread
+  // pool: UASTC in tiles of blocks across all subresources, and ETC1S per
+  // subresource (except for ETC1S video, whose frames depend on each other).
+  // If this is 1, the reader runs single-threaded instead; other values are
+  // currently ignored.
+  uint32_t num_threads = 0;
+  // KTX2 levels are read and processed in parallel in windows of consecutive
+  // levels whose supercompressed and inflated data fit in this many bytes (or
+  // one level, if it's larger); this bounds the reader's temporary memory.
+  // Larger windows give the thread pool more work at once. Single-threaded
+  // reads use one level at a time.
+  uint64_t parallel_read_budget_in_bytes = 256ULL << 20;
+  // If not null, transcoded UASTC and ETC1S subresources are looked up in and
+  // added to this cache. It must outlive the read.
+  TranscodeCache* transcode_cache = nullptr;
+  // Dictionaries for KTX2 files that were supercompressed with a Zstandard
+  // dictionary; reading such a file fails if its dictionary isn't here.
+  const ZstdDictionaryCache* zstd_dictionaries = nullptr;
 };
 
 enum class WriteSupercompressionType
@@ -140,6 +282,15 @@ struct WriteSettings
   float rdo_lambda = 10.0f;
   // Enables Rate-Distortion Optimization for ETC1S.
   bool rdo_etc1s = true;
+  // KTX2 levels are Zstandard-supercompressed in parallel on nvutils' thread
+  // pool, and Basis Universal encodes using this many threads (0 means
+  // std::thread::hardware_concurrency()). If this is 1, the writer runs
+  // single-threaded. The output is the same for any number of threads.
+  uint32_t num_threads = 0;
+  // If supercompression is ZSTD and this is set, levels are supercompressed
+  // with this dictionary, and its ID is written to the "NVzstdDictionaryID"
+  // key. It must outlive the write.
+  const ZstdDictionary* zstd_dictionary = nullptr;
 };
 
 // An enum for each of the possible elements in a ktxSwizzle value.
@@ -198,8 +349,16 @@ public:
 
   // Mutably accesses the subresource at the given mip, layer, and face. If the
   // given indices are out of range, throws an std::out_of_range exception.
+  // If the subresource is a view from readFromMemoryView(), this first copies
+  // the viewed bytes into the subresource so they can be modified.
   std::vector<char>& subresource(uint32_t mip = 0, uint32_t layer = 0, uint32_t face = 0);
 
+  // Read-only access to the bytes of the subresource at the given mip, layer,
+  // and face, without copying. This views either the subresource's own data or,
+  // after readFromMemoryView(), the caller's memory. If the given indices are
+  // out of range, throws an std::out_of_range exception.
+  std::span<const char> subresourceBytes(uint32_t mip = 0, uint32_t layer = 0, uint32_t face = 0) const;
+
   // Reads this structure from a KTX stream, advancing the stream as well.
   // Returns an optional error message if the read failed.
   ErrorWithText readFromStream(std::istream&       input,          // The input stream, at the start of the KTX data
@@ -209,6 +368,15 @@ public:
   ErrorWithText readFromFile(const char*         filename,       // The .ktx or .ktx2 file to read from.
                              const ReadSettings& readSettings);  // Settings for the reader
 
+  // Reads this structure from KTX data in memory (for instance, from
+  // nvutils::FileReadMapping) without copying subresources that need no
+  // inflation, transcoding, or endianness swapping: subresourceBytes() then
+  // returns views into `input`, which must outlive them (or until
+  // subresource() is called for that subresource, which makes a copy).
+  // Supercompressed level data is also inflated directly from `input`.
+  ErrorWithText readFromMemoryView(std::span<const std::byte> input,          // The KTX data
+                                   const ReadSettings&        readSettings);  // Settings for the reader
+
   // Writes this structure in KTX2 format to a stream.
   ErrorWithText writeKTX2Stream(std::ostream&        output,  // The output stream, at the point to start writing
                                 const WriteSettings& writeSettings);  // Settings for the writer
@@ -289,15 +457,110 @@ private:
   // stream is a KTX1 or KTX2 stream.
   ErrorWithText readFromKTX1Stream(std::istream& input, const ReadSettings& readSettings);
   ErrorWithText readFromKTX2Stream(std::istream& input, const ReadSettings& readSettings);
+  // readFromKTX2Stream reads everything up to the Mip Level Array using
+  // readKTX2Header, then reads mips [first_mip, first_mip + mip_count) of the
+  // image using readKTX2Mips. KTXLevelReader calls these separately.
+  ErrorWithText readKTX2Header(std::istream& input, const ReadSettings& readSettings, KTX2ReadContext& context);
+  ErrorWithText readKTX2Mips(std::istream&       input,
+                             const ReadSettings& readSettings,
+                             KTX2ReadContext&    context,
+                             uint32_t            first_mip,
+                             uint32_t            mip_count);
+  // Decodes mips [first_mip, first_mip + mip_count) from `astc_format` to
+  // this->format; see ReadSettings::decode_astc_without_device_support.
+  ErrorWithText decodeASTCMips(VkFormat astc_format, uint32_t first_mip, uint32_t mip_count, uint32_t num_threads);
+  friend class KTXLevelReader;
 
   // Whether the loaded file was a KTX1 (1) or KTX2 (2) file.
   uint32_t read_ktx_version = 1;
 
+  // Returns the index of a subresource in `data`, or throws an
+  // std::out_of_range exception.
+  size_t subresourceIndex(uint32_t mip, uint32_t layer, uint32_t face) const;
+
+  // While readFromMemoryView() is running, the memory it reads from.
+  std::span<const char> view_source;
+
 private:
   // A structure containing all the image's encoded, non-supercompressed
   // image data. We store this in a buffer with an entry per subresource, and
   // provide accessors to it.
   std::vector<std::vector<char>> data;
+  // For each subresource, a view into the memory given to
+  // readFromMemoryView() if it wasn't copied into `data`; otherwise empty.
+  std::vector<std::span<const char>> views;
+};
+
+// Writes many images to KTX2 files in parallel on nvutils' thread pool, with
+// one task per image -- for instance, to convert a large set of textures.
+// `filenames` must have the same size as `images`. Unless there's only one
+// image, each image is written single-threaded; if writeSettings.num_threads
+// is 1, images are written one after another. Returns an ErrorWithText per
+// image.
+std::vector<ErrorWithText> writeKTX2Files(std::span<KTXImage>          images,
+                                          std::span<const std::string> filenames,
+                                          const WriteSettings&         writeSettings);
+
+// Trains a Zstandard dictionary of at most `max_dictionary_size` bytes
+// (16 to 112 KB is typical) for supercompressing files like `samples`. The
+// result is a raw-content dictionary of the samples' most common segments,
+// selected from the levels of each sample as the writer supercompresses them
+// (all layers and faces). This works best with about 100 times as much sample
+// data as the dictionary size. Load the result into a ZstdDictionary, and
+// store it next to the files that use it.
+ErrorWithText trainZstdDictionary(std::span<const KTXImage> samples, size_t max_dictionary_size, std::vector<char>& dictionary);
+
+// Reads many KTX1 or KTX2 files using nvutils' thread pool -- for instance,
+// all of a scene's textures. If there are at least as many files as threads,
+// each file is read single-threaded in its own task; otherwise, files are
+// read one after another, each spreading its levels and transcoding tiles over
+// the pool. `images` must have the same size as `filenames`. If
+// readSettings.num_threads is 1, everything runs on the calling thread.
+// Returns an ErrorWithText per image.
+std::vector<ErrorWithText> readKTXFiles(std::span<KTXImage>          images,
+                                        std::span<const std::string> filenames,
+                                        const ReadSettings&          readSettings);
+
+// Reads the mips of a KTX2 file on demand. open() parses the header, level
+// index, and supercompression global data once, and allocates `image` without
+// data; readMips() then seeks to and reads only the requested mips. For
+// instance, a texture streamer could read the smallest mips first for a
+// low-resolution preview, then read larger mips as needed.
+// KTX1 files are not supported, since they have no level index.
+class KTXLevelReader
+{
+public:
+  KTXLevelReader();
+  ~KTXLevelReader();
+  KTXLevelReader(const KTXLevelReader&)            = delete;
+  KTXLevelReader& operator=(const KTXLevelReader&) = delete;
+
+  // Reads the metadata of a KTX2 stream into `image`. `input` must stay valid
+  // until this reader is destroyed or opened again. readSettings.first_mip and
+  // max_mips select which mips of the file `image` will contain.
+  ErrorWithText open(std::istream&       input,          // The input stream, at the start of the KTX2 data
+                     const ReadSettings& readSettings);  // Settings for the reader
+  // Wrapper for open() for a filename; the reader keeps the file open.
+  ErrorWithText openFile(const char*         filename,       // The .ktx2 file to read from
+                         const ReadSettings& readSettings);  // Settings for the reader
+
+  // Reads mips [first_mip, first_mip + mip_count) of `image` (in image mip
+  // numbering) into its subresources. Mips can be read in any order, and
+  // reading a mip again replaces its data.
+  ErrorWithText readMips(uint32_t first_mip, uint32_t mip_count = 1);
+
+  // Returns whether readMips() has successfully read the given mip.
+  bool isMipRead(uint32_t mip) const;
+
+  // The image's metadata after open(), and its subresources after readMips().
+  KTXImage image;
+
+private:
+  std::unique_ptr<std::istream>    m_file;  // Set by openFile()
+  std::istream*                    m_input = nullptr;
+  ReadSettings                     m_readSettings;
+  std::unique_ptr<KTX2ReadContext> m_context;
+  std::vector<bool>                m_mipsRead;
 };
 
 }  // namespace nv_ktx
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "texture_conversion.h"
+#include "texture_formats.h"  // checked_math
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string.h>  // memcpy
+#include <vector>
+
+#include <glm/gtc/packing.hpp>  // packHalf1x16, unpackHalf1x16
+
+#include "nvutils/parallel_work.hpp"
+
+namespace texture_conversion {
+
+namespace {
+
+enum class ChannelType
+{
+  eUnorm8,
+  eUnorm16,
+  eFloat16,
+  eFloat32,
+};
+
+struct Layout
+{
+  uint32_t    channels = 0;  // The number of stored channels; 0 if the format is unsupported.
+  ChannelType type     = ChannelType::eUnorm8;
+  bool        srgb     = false;
+  // For each of R, G, B, and A, the index of the stored channel, or -1 if
+  // the format doesn't store it.
+  std::array<int, 4> order = {-1, -1, -1, -1};
+
+  size_t channelBytes() const
+  {
+    switch(type)
+    {
+      case ChannelType::eUnorm8:
+        return 1;
+      case ChannelType::eUnorm16:
+      case ChannelType::eFloat16:
+        return 2;
+      default:
+        return 4;
+    }
+  }
+  size_t texelBytes() const { return channels * channelBytes(); }
+};
+
+constexpr std::array<int, 4> kR    = {0, -1, -1, -1};
+constexpr std::array<int, 4> kRG   = {0, 1, -1, -1};
+constexpr std::array<int, 4> kRGB  = {0, 1, 2, -1};
+constexpr std::array<int, 4> kRGBA = {0, 1, 2, 3};
+constexpr std::array<int, 4> kBGR  = {2, 1, 0, -1};
+constexpr std::array<int, 4> kBGRA = {2, 1, 0, 3};
+
+Layout getLayout(VkFormat format)
+{
+  switch(format)
+  {
+    // clang-format off
+    case VK_FORMAT_R8_UNORM:            return {1, ChannelType::eUnorm8, false, kR};
+    case VK_FORMAT_R8_SRGB:             return {1, ChannelType::eUnorm8, true, kR};
+    case VK_FORMAT_R8G8_UNORM:          return {2, ChannelType::eUnorm8, false, kRG};
+    case VK_FORMAT_R8G8_SRGB:           return {2, ChannelType::eUnorm8, true, kRG};
+    case VK_FORMAT_R8G8B8_UNORM:        return {3, ChannelType::eUnorm8, false, kRGB};
+    case VK_FORMAT_R8G8B8_SRGB:         return {3, ChannelType::eUnorm8, true, kRGB};
+    case VK_FORMAT_B8G8R8_UNORM:        return {3, ChannelType::eUnorm8, false, kBGR};
+    case VK_FORMAT_B8G8R8_SRGB:         return {3, ChannelType::eUnorm8, true, kBGR};
+    case VK_FORMAT_R8G8B8A8_UNORM:      return {4, ChannelType::eUnorm8, false, kRGBA};
+    case VK_FORMAT_R8G8B8A8_SRGB:       return {4, ChannelType::eUnorm8, true, kRGBA};
+    case VK_FORMAT_B8G8R8A8_UNORM:      return {4, ChannelType::eUnorm8, false, kBGRA};
+    case VK_FORMAT_B8G8R8A8_SRGB:       return {4, ChannelType::eUnorm8, true, kBGRA};
+    case VK_FORMAT_R16_UNORM:           return {1, ChannelType::eUnorm16, false, kR};
+    case VK_FORMAT_R16G16_UNORM:        return {2, ChannelType::eUnorm16, false, kRG};
+    case VK_FORMAT_R16G16B16_UNORM:     return {3, ChannelType::eUnorm16, false, kRGB};
+    case VK_FORMAT_R16G16B16A16_UNORM:  return {4, ChannelType::eUnorm16, false, kRGBA};
+    case VK_FORMAT_R16_SFLOAT:          return {1, ChannelType::eFloat16, false, kR};
+    case VK_FORMAT_R16G16_SFLOAT:       return {2, ChannelType::eFloat16, false, kRG};
+    case VK_FORMAT_R16G16B16_SFLOAT:    return {3, ChannelType::eFloat16, false, kRGB};
+    case VK_FORMAT_R16G16B16A16_SFLOAT: return {4, ChannelType::eFloat16, false, kRGBA};
+    case VK_FORMAT_R32_SFLOAT:          return {1, ChannelType::eFloat32, false, kR};
+    case VK_FORMAT_R32G32_SFLOAT:       return {2, ChannelType::eFloat32, false, kRG};
+    case VK_FORMAT_R32G32B32_SFLOAT:    return {3, ChannelType::eFloat32, false, kRGB};
+    case VK_FORMAT_R32G32B32A32_SFLOAT: return {4, ChannelType::eFloat32, false, kRGBA};
+    default:                            return {};
+      // clang-format on
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Byte shuffles between 8-bit formats
+//-----------------------------------------------------------------------------
+
+// For each destination channel, the index of the source channel to copy, or
+// SrcC for 0 and SrcC + 1 for 255.
+using ShuffleMap = std::array<uint8_t, 4>;
+
+template <uint32_t SrcC, uint32_t DstC>
+void shuffleRow(const char* src, char* dst, uint32_t width, const ShuffleMap& map)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    char extended[SrcC + 2];
+    memcpy(extended, src + size_t(x) * SrcC, SrcC);
+    extended[SrcC]     = 0;
+    extended[SrcC + 1] = static_cast<char>(255);
+    for(uint32_t k = 0; k < DstC; k++)
+    {
+      dst[size_t(x) * DstC + k] = extended[map[k]];
+    }
+  }
+}
+
+using ShuffleRowFunc = void (*)(const char*, char*, uint32_t, const ShuffleMap&);
+
+template <uint32_t SrcC>
+constexpr std::array<ShuffleRowFunc, 4> kShuffleRowsFrom = {shuffleRow<SrcC, 1>, shuffleRow<SrcC, 2>,
+                                                            shuffleRow<SrcC, 3>, shuffleRow<SrcC, 4>};
+
+ShuffleRowFunc getShuffleRow(uint32_t srcChannels, uint32_t dstChannels)
+{
+  static constexpr std::array<std::array<ShuffleRowFunc, 4>, 4> table = {
+      kShuffleRowsFrom<1>, kShuffleRowsFrom<2>, kShuffleRowsFrom<3>, kShuffleRowsFrom<4>};
+  return table[srcChannels - 1][dstChannels - 1];
+}
+
+ShuffleMap getShuffleMap(const Layout& src, const Layout& dst)
+{
+  ShuffleMap map{};
+  for(uint32_t rgba = 0; rgba < 4; rgba++)
+  {
+    const int dstIndex = dst.order[rgba];
+    if(dstIndex < 0)
+    {
+      continue;
+    }
+    const int srcIndex = src.order[rgba];
+    if(srcIndex >= 0)
+    {
+      map[dstIndex] = static_cast<uint8_t>(srcIndex);
+    }
+    else
+    {
+      // Missing color channels become 0, and missing alpha becomes 1.
+      map[dstIndex] = static_cast<uint8_t>(src.channels + ((rgba == 3) ? 1 : 0));
+    }
+  }
+  return map;
+}
+
+//-----------------------------------------------------------------------------
+// Conversions through linear float
+//-----------------------------------------------------------------------------
+
+float srgbToLinear(float c)
+{
+  return (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSRGB(float c)
+{
+  return (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+}
+
+const std::array<float, 256>& unorm8ToFloatTable(bool srgb)
+{
+  static const std::array<std::array<float, 256>, 2> tables = [] {
+    std::array<std::array<float, 256>, 2> result{};
+    for(uint32_t i = 0; i < 256; i++)
+    {
+      result[0][i] = float(i) / 255.0f;
+      result[1][i] = srgbToLinear(float(i) / 255.0f);
+    }
+    return result;
+  }();
+  return tables[srgb ? 1 : 0];
+}
+
+// Loads and stores without assuming alignment, since the source or staging
+// memory might not be aligned.
+template <class T>
+T load(const char* p, size_t i)
+{
+  T value;
+  memcpy(&value, p + i * sizeof(T), sizeof(T));
+  return value;
+}
+
+template <class T>
+void store(char* p, size_t i, T value)
+{
+  memcpy(p + i * sizeof(T), &value, sizeof(T));
+}
+
+// Reads one stored channel of a row as a float, for each texel.
+void loadChannel(const Layout& layout, const char* src, uint32_t index, float* rgba, uint32_t width, bool linearize)
+{
+  const uint32_t c = layout.channels;
+  switch(layout.type)
+  {
+    case ChannelType::eUnorm8: {
+      const std::array<float, 256>& table = unorm8ToFloatTable(linearize);
+      for(uint32_t x = 0; x < width; x++)
+      {
+        rgba[4 * x] = table[static_cast<uint8_t>(src[size_t(x) * c + index])];
+      }
+      break;
+    }
+    case ChannelType::eUnorm16:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        rgba[4 * x] = float(load<uint16_t>(src, size_t(x) * c + index)) * (1.0f / 65535.0f);
+      }
+      break;
+    case ChannelType::eFloat16:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        rgba[4 * x] = glm::unpackHalf1x16(load<uint16_t>(src, size_t(x) * c + index));
+      }
+      break;
+    case ChannelType::eFloat32:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        rgba[4 * x] = load<float>(src, size_t(x) * c + index);
+      }
+      break;
+  }
+}
+
+// Writes one stored channel of a row from a float, for each texel.
+void storeChannel(const Layout& layout, char* dst, uint32_t index, const float* rgba, uint32_t width)
+{
+  const uint32_t c = layout.channels;
+  switch(layout.type)
+  {
+    case ChannelType::eUnorm8:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        dst[size_t(x) * c + index] = static_cast<char>(static_cast<uint8_t>(std::clamp(rgba[4 * x], 0.0f, 1.0f) * 255.0f + 0.5f));
+      }
+      break;
+    case ChannelType::eUnorm16:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        store(dst, size_t(x) * c + index, static_cast<uint16_t>(std::clamp(rgba[4 * x], 0.0f, 1.0f) * 65535.0f + 0.5f));
+      }
+      break;
+    case ChannelType::eFloat16:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        store(dst, size_t(x) * c + index, static_cast<uint16_t>(glm::packHalf1x16(rgba[4 * x])));
+      }
+      break;
+    case ChannelType::eFloat32:
+      for(uint32_t x = 0; x < width; x++)
+      {
+        store(dst, size_t(x) * c + index, rgba[4 * x]);
+      }
+      break;
+  }
+}
+
+// Converts a row through `rgba`, which has 4 floats per texel.
+void convertRow(const Layout& srcLayout, const char* src, const Layout& dstLayout, char* dst, uint32_t width, bool premultiply, float* rgba)
+{
+  // Load each channel, applying the sRGB transfer function to R, G, and B.
+  for(uint32_t channel = 0; channel < 4; channel++)
+  {
+    const int index = srcLayout.order[channel];
+    if(index >= 0)
+    {
+      const bool linearize = srcLayout.srgb && (channel < 3);
+      loadChannel(srcLayout, src, uint32_t(index), rgba + channel, width, linearize);
+      if(linearize && srcLayout.type != ChannelType::eUnorm8)
+      {
+        for(uint32_t x = 0; x < width; x++)
+        {
+          rgba[4 * x + channel] = srgbToLinear(rgba[4 * x + channel]);
+        }
+      }
+    }
+    else
+    {
+      const float fill = (channel == 3) ? 1.0f : 0.0f;
+      for(uint32_t x = 0; x < width; x++)
+      {
+        rgba[4 * x + channel] = fill;
+      }
+    }
+  }
+
+  if(premultiply)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const float alpha = rgba[4 * x + 3];
+      rgba[4 * x + 0] *= alpha;
+      rgba[4 * x + 1] *= alpha;
+      rgba[4 * x + 2] *= alpha;
+    }
+  }
+
+  if(dstLayout.srgb)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      for(uint32_t channel = 0; channel < 3; channel++)
+      {
+        rgba[4 * x + channel] = linearToSRGB(std::clamp(rgba[4 * x + channel], 0.0f, 1.0f));
+      }
+    }
+  }
+
+  for(uint32_t channel = 0; channel < 4; channel++)
+  {
+    const int index = dstLayout.order[channel];
+    if(index >= 0)
+    {
+      storeChannel(dstLayout, dst, uint32_t(index), rgba + channel, width);
+    }
+  }
+}
+
+}  // namespace
+
+bool isConversionSupported(VkFormat format)
+{
+  return getLayout(format).channels != 0;
+}
+
+size_t getTexelSizeBytes(VkFormat format)
+{
+  return getLayout(format).texelBytes();
+}
+
+ErrorWithText convert(VkFormat                  srcFormat,
+                      std::span<const char>     src,
+                      VkFormat                  dstFormat,
+                      std::span<char>           dst,
+                      uint32_t                  width,
+                      uint32_t                  height,
+                      const ConversionSettings& settings)
+{
+  const Layout srcLayout = getLayout(srcFormat);
+  if(srcLayout.channels == 0)
+  {
+    return "Converting from VkFormat " + std::to_string(srcFormat) + " is not supported.";
+  }
+  const Layout dstLayout = getLayout(dstFormat);
+  if(dstLayout.channels == 0)
+  {
+    return "Converting to VkFormat " + std::to_string(dstFormat) + " is not supported.";
+  }
+  if(width == 0 || height == 0)
+  {
+    return {};
+  }
+
+  // Validate pitches and sizes. The last row only needs to hold the texels.
+  const size_t srcRowBytes = size_t(width) * srcLayout.texelBytes();
+  const size_t dstRowBytes = size_t(width) * dstLayout.texelBytes();
+  const size_t srcPitch    = (settings.srcRowPitch == 0) ? srcRowBytes : settings.srcRowPitch;
+  const size_t dstPitch    = (settings.dstRowPitch == 0) ? dstRowBytes : settings.dstRowPitch;
+  if(srcPitch < srcRowBytes || dstPitch < dstRowBytes)
+  {
+    return "The row pitch was smaller than the size of a row.";
+  }
+  size_t srcSize = 0, dstSize = 0;
+  if(!checked_math::mul2(srcPitch, height - 1, srcSize) || !checked_math::mul2(dstPitch, height - 1, dstSize))
+  {
+    return "The size of the image would overflow.";
+  }
+  srcSize += srcRowBytes;
+  dstSize += dstRowBytes;
+  if(src.size() < srcSize)
+  {
+    return "The source was too small: it had " + std::to_string(src.size()) + " bytes, but " + std::to_string(srcSize)
+           + " were needed.";
+  }
+  if(dst.size() < dstSize)
+  {
+    return "The destination was too small: it had " + std::to_string(dst.size()) + " bytes, but "
+           + std::to_string(dstSize) + " were needed.";
+  }
+
+  // Same format: copy rows.
+  if(srcFormat == dstFormat && !settings.premultiplyAlpha)
+  {
+    nvutils::parallel_batches_pooled<64>(
+        height, [&](uint64_t y, uint32_t) { memcpy(dst.data() + y * dstPitch, src.data() + y * srcPitch, dstRowBytes); },
+        settings.numThreads);
+    return {};
+  }
+
+  // 8-bit formats with the same transfer function: shuffle bytes.
+  if(srcLayout.type == ChannelType::eUnorm8 && dstLayout.type == ChannelType::eUnorm8
+     && srcLayout.srgb == dstLayout.srgb && !settings.premultiplyAlpha)
+  {
+    const ShuffleRowFunc shuffle = getShuffleRow(srcLayout.channels, dstLayout.channels);
+    const ShuffleMap     map     = getShuffleMap(srcLayout, dstLayout);
+    nvutils::parallel_batches_pooled<16>(
+        height, [&](uint64_t y, uint32_t) { shuffle(src.data() + y * srcPitch, dst.data() + y * dstPitch, width, map); },
+        settings.numThreads);
+    return {};
+  }
+
+  // Everything else: convert through linear float, with a scratch row per
+  // thread.
+  const size_t numScratch =
+      (settings.numThreads == 1) ? 1 : std::max<size_t>(1, nvutils::get_thread_pool().get_thread_count());
+  std::vector<std::vector<float>> scratch(numScratch);
+  try
+  {
+    for(std::vector<float>& rgba : scratch)
+    {
+      rgba.resize(size_t(width) * 4);
+    }
+  }
+  catch(...)
+  {
+    return "Allocating memory for conversion failed!";
+  }
+  nvutils::parallel_batches_pooled<16>(
+      height,
+      [&](uint64_t y, uint32_t threadIndex) {
+        convertRow(srcLayout, src.data() + y * srcPitch, dstLayout, dst.data() + y * dstPitch, width,
+                   settings.premultiplyAlpha, scratch[threadIndex].data());
+      },
+      settings.numThreads);
+  return {};
+}
+
+}  // namespace texture_conversion
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Provides CPU conversion of uncompressed images between common formats:
+* R, RG, RGB, RGBA, BGR, and BGRA 8-bit UNORM and _SRGB
+* R, RG, RGB, and RGBA 16-bit UNORM, 16-bit half float, and 32-bit float
+
+Conversions follow Vulkan's rules: channels missing from the source become
+0 (or 1 for alpha), _SRGB formats are converted to and from linear, and
+values are clamped to the destination's range.
+
+Conversions between 8-bit formats with the same transfer function (for
+instance, RGB8 -> RGBA8, or RGBA8 <-> BGRA8) only rearrange bytes; other
+conversions go through linear float. Rows are converted in parallel on
+nvutils' thread pool, and the destination can have a row pitch, so that
+images can be converted directly into staging memory.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+namespace texture_conversion {
+
+// convert() returns an empty std::optional if it succeeded, and a value with
+// text describing the error if it failed.
+using ErrorWithText = std::optional<std::string>;
+
+struct ConversionSettings
+{
+  // Multiplies color channels by alpha (in linear space) while converting.
+  bool premultiplyAlpha = false;
+  // The number of bytes between the starts of rows in the source and
+  // destination; 0 means rows are tightly packed.
+  size_t srcRowPitch = 0;
+  size_t dstRowPitch = 0;
+  // The maximum number of threads to use; 0 means all of nvutils' thread
+  // pool, and 1 runs on the calling thread.
+  uint32_t numThreads = 0;
+};
+
+// Returns whether convert() supports the given VkFormat, as either a source
+// or destination.
+bool isConversionSupported(VkFormat format);
+
+// Returns the size of a texel of the given format in bytes, or 0 if the
+// format is not supported.
+size_t getTexelSizeBytes(VkFormat format);
+
+// Converts a `width` x `height` image from `srcFormat` in `src` to
+// `dstFormat` in `dst`. `src` and `dst` must not overlap.
+ErrorWithText convert(VkFormat                  srcFormat,
+                      std::span<const char>     src,
+                      VkFormat                  dstFormat,
+                      std::span<char>           dst,
+                      uint32_t                  width,
+                      uint32_t                  height,
+                      const ConversionSettings& settings = {});
+
+}  // namespace texture_conversion
@@ -0,0 +1,611 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "texture_decode.h"
+#include "texture_formats.h"  // checked_math
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string.h>  // memcpy
+
+#include <glm/gtc/packing.hpp>  // packHalf1x16, unpackHalf1x16
+
+#ifdef NVP_SUPPORTS_BASISU
+#include <basisu_gpu_texture.h>
+#include <basisu_astc_helpers.h>  // Must come after basisu_gpu_texture.h
+#include <basisu_transcoder.h>    // basisu_transcoder_init
+#endif
+
+#include "nvutils/parallel_work.hpp"
+
+namespace texture_decode {
+
+namespace {
+
+// The largest block is ASTC 12x12.
+constexpr uint32_t kMaxBlockTexels = 12 * 12;
+
+// Block decoders write either 4 uint8_ts or 4 half floats per texel, in
+// row-major order.
+enum class BlockTexels
+{
+  eUnorm8,
+  eHalf,
+};
+
+using DecodeBlockFunc = void (*)(const uint8_t* block, void* texels, uint32_t blockWidth, uint32_t blockHeight);
+
+struct FormatInfo
+{
+  uint32_t        blockWidth  = 0;
+  uint32_t        blockHeight = 0;
+  uint32_t        blockBytes  = 0;
+  BlockTexels     texels      = BlockTexels::eUnorm8;
+  DecodeBlockFunc decode      = nullptr;
+};
+
+//-----------------------------------------------------------------------------
+// BC1-BC5
+// These follow the Direct3D 10 functional specification. Each decoder first
+// builds a small palette, then looks up every texel's index in it. Where the
+// specification allows a range of interpolated values, we round down like
+// Basis Universal's unpack_bc1() and unpack_bc4(), so that the results match
+// them exactly.
+//-----------------------------------------------------------------------------
+
+uint16_t readU16(const uint8_t* p)
+{
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p)
+{
+  return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// Reads the 48 bits of 3-bit indices of a BC3 alpha or BC4 block.
+uint64_t readU48(const uint8_t* p)
+{
+  uint64_t result = 0;
+  for(int i = 5; i >= 0; i--)
+  {
+    result = (result << 8) | p[i];
+  }
+  return result;
+}
+
+void expand565(uint16_t c, uint32_t rgb[3])
+{
+  const uint32_t r5 = (c >> 11) & 31;
+  const uint32_t g6 = (c >> 5) & 63;
+  const uint32_t b5 = c & 31;
+  rgb[0]            = (r5 << 3) | (r5 >> 2);
+  rgb[1]            = (g6 << 2) | (g6 >> 4);
+  rgb[2]            = (b5 << 3) | (b5 >> 2);
+}
+
+uint32_t packRGBA8(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+  return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+// Decodes the 8-byte color part of a BC1, BC2, or BC3 block. BC2 and BC3
+// color blocks always use 4-color mode; BC1 blocks use 3-color mode when
+// color0 <= color1, in which case index 3 is black with alpha `alpha3`.
+void decodeColorBlock(const uint8_t* block, uint8_t* texels, bool allow3ColorMode, uint32_t alpha3)
+{
+  const uint16_t c0 = readU16(block);
+  const uint16_t c1 = readU16(block + 2);
+  uint32_t       e0[3], e1[3];
+  expand565(c0, e0);
+  expand565(c1, e1);
+
+  std::array<uint32_t, 4> palette{};
+  palette[0] = packRGBA8(e0[0], e0[1], e0[2], 255);
+  palette[1] = packRGBA8(e1[0], e1[1], e1[2], 255);
+  if(!allow3ColorMode || c0 > c1)
+  {
+    palette[2] = packRGBA8((2 * e0[0] + e1[0]) / 3, (2 * e0[1] + e1[1]) / 3, (2 * e0[2] + e1[2]) / 3, 255);
+    palette[3] = packRGBA8((e0[0] + 2 * e1[0]) / 3, (e0[1] + 2 * e1[1]) / 3, (e0[2] + 2 * e1[2]) / 3, 255);
+  }
+  else
+  {
+    palette[2] = packRGBA8((e0[0] + e1[0]) / 2, (e0[1] + e1[1]) / 2, (e0[2] + e1[2]) / 2, 255);
+    palette[3] = packRGBA8(0, 0, 0, alpha3);
+  }
+
+  const uint32_t indices = readU32(block + 4);
+  uint32_t       result[16];
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    result[i] = palette[(indices >> (2 * i)) & 3];
+  }
+  memcpy(texels, result, sizeof(result));
+}
+
+// Decodes an unsigned BC3 alpha or BC4 channel block, writing 16 values
+// `stride` bytes apart.
+void decodeUnormChannelBlock(const uint8_t* block, uint8_t* out, size_t stride)
+{
+  const uint32_t          a0 = block[0];
+  const uint32_t          a1 = block[1];
+  std::array<uint8_t, 8> palette{};
+  palette[0] = static_cast<uint8_t>(a0);
+  palette[1] = static_cast<uint8_t>(a1);
+  if(a0 > a1)
+  {
+    for(uint32_t i = 1; i < 7; i++)
+    {
+      palette[i + 1] = static_cast<uint8_t>(((7 - i) * a0 + i * a1) / 7);
+    }
+  }
+  else
+  {
+    for(uint32_t i = 1; i < 5; i++)
+    {
+      palette[i + 1] = static_cast<uint8_t>(((5 - i) * a0 + i * a1) / 5);
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+
+  const uint64_t indices = readU48(block + 2);
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    out[i * stride] = palette[(indices >> (3 * i)) & 7];
+  }
+}
+
+// Decodes a signed BC4 or BC5 channel block to half floats, writing 16 values
+// `stride` elements apart.
+void decodeSnormChannelBlock(const uint8_t* block, uint16_t* out, size_t stride)
+{
+  // -128 and -127 both map to -1.0.
+  const float a0 = float(std::max(int(int8_t(block[0])), -127)) / 127.0f;
+  const float a1 = float(std::max(int(int8_t(block[1])), -127)) / 127.0f;
+  std::array<uint16_t, 8> palette{};
+  palette[0] = glm::packHalf1x16(a0);
+  palette[1] = glm::packHalf1x16(a1);
+  // The mode depends on the endpoints before -128 is mapped to -127.
+  if(int8_t(block[0]) > int8_t(block[1]))
+  {
+    for(uint32_t i = 1; i < 7; i++)
+    {
+      palette[i + 1] = glm::packHalf1x16((float(7 - i) * a0 + float(i) * a1) / 7.0f);
+    }
+  }
+  else
+  {
+    for(uint32_t i = 1; i < 5; i++)
+    {
+      palette[i + 1] = glm::packHalf1x16((float(5 - i) * a0 + float(i) * a1) / 5.0f);
+    }
+    palette[6] = glm::packHalf1x16(-1.0f);
+    palette[7] = glm::packHalf1x16(1.0f);
+  }
+
+  const uint64_t indices = readU48(block + 2);
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    out[i * stride] = palette[(indices >> (3 * i)) & 7];
+  }
+}
+
+void decodeBC1RGB(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  decodeColorBlock(block, static_cast<uint8_t*>(texels), true, 255);
+}
+
+void decodeBC1RGBA(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  decodeColorBlock(block, static_cast<uint8_t*>(texels), true, 0);
+}
+
+void decodeBC2(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint8_t* out = static_cast<uint8_t*>(texels);
+  decodeColorBlock(block + 8, out, false, 255);
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    const uint32_t a4 = (block[i / 2] >> (4 * (i % 2))) & 15;
+    out[4 * i + 3]    = static_cast<uint8_t>(a4 * 17);
+  }
+}
+
+void decodeBC3(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint8_t* out = static_cast<uint8_t*>(texels);
+  decodeColorBlock(block + 8, out, false, 255);
+  decodeUnormChannelBlock(block, out + 3, 4);
+}
+
+void decodeBC4Unorm(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint32_t result[16];
+  std::fill(std::begin(result), std::end(result), packRGBA8(0, 0, 0, 255));
+  uint8_t* out = reinterpret_cast<uint8_t*>(result);
+  decodeUnormChannelBlock(block, out, 4);
+  memcpy(texels, result, sizeof(result));
+}
+
+void decodeBC5Unorm(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint32_t result[16];
+  std::fill(std::begin(result), std::end(result), packRGBA8(0, 0, 0, 255));
+  uint8_t* out = reinterpret_cast<uint8_t*>(result);
+  decodeUnormChannelBlock(block, out, 4);
+  decodeUnormChannelBlock(block + 8, out + 1, 4);
+  memcpy(texels, result, sizeof(result));
+}
+
+void fillHalfRGBA(uint16_t* out, uint32_t numTexels, float r, float g, float b, float a)
+{
+  const uint16_t rgba[4] = {glm::packHalf1x16(r), glm::packHalf1x16(g), glm::packHalf1x16(b), glm::packHalf1x16(a)};
+  for(uint32_t i = 0; i < numTexels; i++)
+  {
+    memcpy(out + 4 * i, rgba, sizeof(rgba));
+  }
+}
+
+void decodeBC4Snorm(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint16_t* out = static_cast<uint16_t*>(texels);
+  fillHalfRGBA(out, 16, 0.0f, 0.0f, 0.0f, 1.0f);
+  decodeSnormChannelBlock(block, out, 4);
+}
+
+void decodeBC5Snorm(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  uint16_t* out = static_cast<uint16_t*>(texels);
+  fillHalfRGBA(out, 16, 0.0f, 0.0f, 0.0f, 1.0f);
+  decodeSnormChannelBlock(block, out, 4);
+  decodeSnormChannelBlock(block + 8, out + 1, 4);
+}
+
+//-----------------------------------------------------------------------------
+// BC6H, BC7, ASTC
+//-----------------------------------------------------------------------------
+#ifdef NVP_SUPPORTS_BASISU
+
+void decodeBC6H(const uint8_t* block, void* texels, bool isSigned)
+{
+  // unpack_bc6h() writes tightly packed RGB texels.
+  uint16_t  rgb[16 * 3];
+  uint16_t* out = static_cast<uint16_t*>(texels);
+  if(!basisu::unpack_bc6h(block, rgb, isSigned))
+  {
+    // Reserved modes decode to 0.
+    fillHalfRGBA(out, 16, 0.0f, 0.0f, 0.0f, 1.0f);
+    return;
+  }
+  const uint16_t one = glm::packHalf1x16(1.0f);
+  for(uint32_t i = 0; i < 16; i++)
+  {
+    out[4 * i + 0] = rgb[3 * i + 0];
+    out[4 * i + 1] = rgb[3 * i + 1];
+    out[4 * i + 2] = rgb[3 * i + 2];
+    out[4 * i + 3] = one;
+  }
+}
+
+void decodeBC6HUfloat(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  decodeBC6H(block, texels, false);
+}
+
+void decodeBC6HSfloat(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  decodeBC6H(block, texels, true);
+}
+
+void decodeBC7(const uint8_t* block, void* texels, uint32_t, uint32_t)
+{
+  static_assert(sizeof(basisu::color_rgba) == 4);
+  basisu::color_rgba result[16];
+  if(!basisu::unpack_bc7(block, result))
+  {
+    // Reserved modes decode to transparent black.
+    memset(texels, 0, sizeof(result));
+    return;
+  }
+  memcpy(texels, result, sizeof(result));
+}
+
+void decodeASTC(const uint8_t* block, void* texels, uint32_t blockWidth, uint32_t blockHeight, astc_helpers::decode_mode mode)
+{
+  astc_helpers::log_astc_block logicalBlock;
+  if(astc_helpers::unpack_block(block, logicalBlock, blockWidth, blockHeight)
+     && astc_helpers::decode_block(logicalBlock, texels, blockWidth, blockHeight, mode))
+  {
+    return;
+  }
+
+  // Invalid blocks decode to the error color, magenta.
+  const uint32_t numTexels = blockWidth * blockHeight;
+  if(mode == astc_helpers::cDecodeModeHDR16)
+  {
+    fillHalfRGBA(static_cast<uint16_t*>(texels), numTexels, 1.0f, 0.0f, 1.0f, 1.0f);
+  }
+  else
+  {
+    const uint32_t magenta = packRGBA8(255, 0, 255, 255);
+    for(uint32_t i = 0; i < numTexels; i++)
+    {
+      memcpy(static_cast<uint8_t*>(texels) + 4 * i, &magenta, sizeof(magenta));
+    }
+  }
+}
+
+void decodeASTCUnorm(const uint8_t* block, void* texels, uint32_t blockWidth, uint32_t blockHeight)
+{
+  decodeASTC(block, texels, blockWidth, blockHeight, astc_helpers::cDecodeModeLDR8);
+}
+
+void decodeASTCSrgb(const uint8_t* block, void* texels, uint32_t blockWidth, uint32_t blockHeight)
+{
+  decodeASTC(block, texels, blockWidth, blockHeight, astc_helpers::cDecodeModeSRGB8);
+}
+
+void decodeASTCSfloat(const uint8_t* block, void* texels, uint32_t blockWidth, uint32_t blockHeight)
+{
+  decodeASTC(block, texels, blockWidth, blockHeight, astc_helpers::cDecodeModeHDR16);
+}
+
+// ASTC block sizes, in the order they appear in VkFormat.
+constexpr std::array<std::array<uint32_t, 2>, 14> kASTCBlockSizes = {{{4, 4},
+                                                                      {5, 4},
+                                                                      {5, 5},
+                                                                      {6, 5},
+                                                                      {6, 6},
+                                                                      {8, 5},
+                                                                      {8, 6},
+                                                                      {8, 8},
+                                                                      {10, 5},
+                                                                      {10, 6},
+                                                                      {10, 8},
+                                                                      {10, 10},
+                                                                      {12, 10},
+                                                                      {12, 12}}};
+#endif
+
+FormatInfo getFormatInfo(VkFormat format)
+{
+  switch(format)
+  {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+      return {4, 4, 8, BlockTexels::eUnorm8, decodeBC1RGB};
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+      return {4, 4, 8, BlockTexels::eUnorm8, decodeBC1RGBA};
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+      return {4, 4, 16, BlockTexels::eUnorm8, decodeBC2};
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+      return {4, 4, 16, BlockTexels::eUnorm8, decodeBC3};
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+      return {4, 4, 8, BlockTexels::eUnorm8, decodeBC4Unorm};
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+      return {4, 4, 8, BlockTexels::eHalf, decodeBC4Snorm};
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+      return {4, 4, 16, BlockTexels::eUnorm8, decodeBC5Unorm};
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+      return {4, 4, 16, BlockTexels::eHalf, decodeBC5Snorm};
+#ifdef NVP_SUPPORTS_BASISU
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+      return {4, 4, 16, BlockTexels::eHalf, decodeBC6HUfloat};
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+      return {4, 4, 16, BlockTexels::eHalf, decodeBC6HSfloat};
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+      return {4, 4, 16, BlockTexels::eUnorm8, decodeBC7};
+#endif
+    default:
+      break;
+  }
+
+#ifdef NVP_SUPPORTS_BASISU
+  // ASTC UNORM and SRGB formats alternate, starting at 4x4 UNORM.
+  if(format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+  {
+    const uint32_t offset    = uint32_t(format) - uint32_t(VK_FORMAT_ASTC_4x4_UNORM_BLOCK);
+    const auto&    blockSize = kASTCBlockSizes[offset / 2];
+    return {blockSize[0], blockSize[1], 16, BlockTexels::eUnorm8, (offset % 2 == 0) ? decodeASTCUnorm : decodeASTCSrgb};
+  }
+  if(format >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK && format <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK)
+  {
+    const auto& blockSize = kASTCBlockSizes[uint32_t(format) - uint32_t(VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK)];
+    return {blockSize[0], blockSize[1], 16, BlockTexels::eHalf, decodeASTCSfloat};
+  }
+#endif
+  return {};
+}
+
+// Maps each UNORM8 value to its half float representation.
+const std::array<uint16_t, 256>& unorm8ToHalfTable()
+{
+  static const std::array<uint16_t, 256> table = [] {
+    std::array<uint16_t, 256> result{};
+    for(uint32_t i = 0; i < 256; i++)
+    {
+      result[i] = glm::packHalf1x16(float(i) / 255.0f);
+    }
+    return result;
+  }();
+  return table;
+}
+
+uint8_t halfToUnorm8(uint16_t h)
+{
+  const float f = glm::unpackHalf1x16(h);
+  // This comparison also maps NaN to 0.
+  if(!(f > 0.0f))
+  {
+    return 0;
+  }
+  return static_cast<uint8_t>(std::min(f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Copies `numTexels` decoded texels to the output, converting them to the
+// target format.
+void writeTexels(const void* blockTexels, BlockTexels texels, DecodeTarget target, char* dst, uint32_t numTexels)
+{
+  const uint32_t numValues = 4 * numTexels;
+  if(texels == BlockTexels::eUnorm8)
+  {
+    const uint8_t* src = static_cast<const uint8_t*>(blockTexels);
+    if(target == DecodeTarget::eRGBA8)
+    {
+      memcpy(dst, src, numValues);
+    }
+    else
+    {
+      const std::array<uint16_t, 256>& table = unorm8ToHalfTable();
+      uint16_t                         out[4 * kMaxBlockTexels];
+      for(uint32_t i = 0; i < numValues; i++)
+      {
+        out[i] = table[src[i]];
+      }
+      memcpy(dst, out, numValues * sizeof(uint16_t));
+    }
+  }
+  else
+  {
+    const uint16_t* src = static_cast<const uint16_t*>(blockTexels);
+    if(target == DecodeTarget::eRGBA16F)
+    {
+      memcpy(dst, src, numValues * sizeof(uint16_t));
+    }
+    else
+    {
+      for(uint32_t i = 0; i < numValues; i++)
+      {
+        dst[i] = static_cast<char>(halfToUnorm8(src[i]));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool isDecodeSupported(VkFormat format)
+{
+  return getFormatInfo(format).decode != nullptr;
+}
+
+size_t encodedSizeBytes(VkFormat format, uint32_t width, uint32_t height)
+{
+  const FormatInfo info = getFormatInfo(format);
+  if(info.decode == nullptr)
+  {
+    return 0;
+  }
+  const size_t blocksX = (size_t(width) + info.blockWidth - 1) / info.blockWidth;
+  const size_t blocksY = (size_t(height) + info.blockHeight - 1) / info.blockHeight;
+  return blocksX * blocksY * info.blockBytes;
+}
+
+size_t decodedSizeBytes(DecodeTarget target, uint32_t width, uint32_t height)
+{
+  const size_t texelBytes = (target == DecodeTarget::eRGBA8) ? 4 : 8;
+  return size_t(width) * size_t(height) * texelBytes;
+}
+
+ErrorWithText decodeImage(VkFormat              format,
+                          uint32_t              width,
+                          uint32_t              height,
+                          std::span<const char> src,
+                          DecodeTarget          target,
+                          std::span<char>       dst,
+                          uint32_t              numThreads)
+{
+  const FormatInfo info = getFormatInfo(format);
+  if(info.decode == nullptr)
+  {
+    return "Decoding VkFormat " + std::to_string(format) + " is not supported.";
+  }
+
+#ifdef NVP_SUPPORTS_BASISU
+  // The ASTC block decoder uses tables that Basis Universal's transcoder
+  // initializes; this does nothing if it's been initialized already.
+  static const bool basisInitialized = [] {
+    basist::basisu_transcoder_init();
+    return true;
+  }();
+  (void)basisInitialized;
+#endif
+
+  const size_t blocksX = (size_t(width) + info.blockWidth - 1) / info.blockWidth;
+  const size_t blocksY = (size_t(height) + info.blockHeight - 1) / info.blockHeight;
+  size_t       srcSize = 0;
+  if(!checked_math::mul3(blocksX, blocksY, info.blockBytes, srcSize))
+  {
+    return "The size of the encoded image would overflow.";
+  }
+  if(src.size() < srcSize)
+  {
+    return "The source data was too small: a " + std::to_string(width) + " x " + std::to_string(height)
+           + " image needs " + std::to_string(srcSize) + " bytes, but the source had " + std::to_string(src.size()) + ".";
+  }
+
+  const size_t texelBytes = (target == DecodeTarget::eRGBA8) ? 4 : 8;
+  size_t       dstSize    = 0;
+  if(!checked_math::mul3(width, height, texelBytes, dstSize))
+  {
+    return "The size of the decoded image would overflow.";
+  }
+  if(dst.size() < dstSize)
+  {
+    return "The destination was too small: it had " + std::to_string(dst.size()) + " bytes, but "
+           + std::to_string(dstSize) + " were needed.";
+  }
+
+  const size_t dstRowPitch = size_t(width) * texelBytes;
+  nvutils::parallel_batches_pooled<64>(
+      blocksX * blocksY,
+      [&](uint64_t blockIndex, uint32_t) {
+        const size_t blockX = blockIndex % blocksX;
+        const size_t blockY = blockIndex / blocksX;
+
+        // Large enough for the largest block in either texel format.
+        alignas(8) uint16_t blockTexels[4 * kMaxBlockTexels];
+        info.decode(reinterpret_cast<const uint8_t*>(src.data()) + blockIndex * info.blockBytes, blockTexels,
+                    info.blockWidth, info.blockHeight);
+
+        // Copy the rows of the block that are inside the image.
+        const size_t   x0              = blockX * info.blockWidth;
+        const size_t   y0              = blockY * info.blockHeight;
+        const uint32_t rowTexels       = uint32_t(std::min<size_t>(info.blockWidth, width - x0));
+        const uint32_t rows            = uint32_t(std::min<size_t>(info.blockHeight, height - y0));
+        const size_t   blockTexelBytes = (info.texels == BlockTexels::eUnorm8) ? 4 : 8;
+        for(uint32_t y = 0; y < rows; y++)
+        {
+          const char* rowSrc = reinterpret_cast<const char*>(blockTexels) + size_t(y) * info.blockWidth * blockTexelBytes;
+          char*       rowDst = dst.data() + (y0 + y) * dstRowPitch + x0 * texelBytes;
+          writeTexels(rowSrc, info.texels, target, rowDst, rowTexels);
+        }
+      },
+      numThreads);
+
+  return {};
+}
+
+}  // namespace texture_decode
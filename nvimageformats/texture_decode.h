@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Provides CPU decoders for block-compressed texture formats, so that tools can
+compare, thumbnail, or convert compressed textures without a GPU:
+* BC1, BC2, BC3, BC4, and BC5 (UNORM, SRGB, and SNORM variants)
+* BC6H (UFLOAT and SFLOAT)
+* BC7 (UNORM and SRGB)
+* 2D ASTC in all block sizes (UNORM, SRGB, and SFLOAT variants)
+
+Images are decoded to tightly packed RGBA8 or RGBA16F texels. Blocks are
+decoded in parallel on nvutils' thread pool, but each block is decoded with
+scalar code: there are no hand-written SIMD paths.
+
+BC1-BC5 are decoded by this file, and match Basis Universal's decoders
+exactly; BC6H, BC7, and ASTC use Basis Universal's reference block decoders.
+
+nv_ktx uses this to decode ASTC files for devices without ASTC support; see
+nv_ktx::ReadSettings::decode_astc_without_device_support.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+namespace texture_decode {
+
+// decodeImage() returns an empty std::optional if it succeeded, and a value
+// with text describing the error if it failed.
+using ErrorWithText = std::optional<std::string>;
+
+// The format of decoded texels.
+enum class DecodeTarget
+{
+  // 4 uint8_ts per texel. Float and SNORM formats are clamped to [0, 1].
+  eRGBA8,
+  // 4 IEEE 754 half-precision floats per texel.
+  eRGBA16F,
+};
+
+// Returns whether decodeImage() can decode images in the given VkFormat.
+bool isDecodeSupported(VkFormat format);
+
+// Returns the size in bytes of a `width` x `height` image in the given
+// format, or 0 if the format is not supported.
+size_t encodedSizeBytes(VkFormat format, uint32_t width, uint32_t height);
+
+// Returns the size in bytes of a `width` x `height` image after decoding.
+size_t decodedSizeBytes(DecodeTarget target, uint32_t width, uint32_t height);
+
+// Decodes a `width` x `height` image in the given format from `src`, which
+// contains encodedSizeBytes(format, width, height) bytes of blocks in
+// row-major order, into `dst`, which must have at least
+// decodedSizeBytes(target, width, height) bytes.
+//
+// Texels are decoded as-is: no transfer function is applied to _SRGB formats.
+// As on GPUs, BC4 decodes to (r, 0, 0, 1), and BC5 to (r, g, 0, 1).
+// Invalid blocks decode to the values given by each format's specification
+// (transparent black for BC7, magenta for ASTC, and so on).
+//
+// Blocks are decoded on nvutils' thread pool using up to `numThreads`
+// threads (0 means all of the pool's threads); if this is 1, decodes on the
+// calling thread.
+ErrorWithText decodeImage(VkFormat              format,
+                          uint32_t              width,
+                          uint32_t              height,
+                          std::span<const char> src,
+                          DecodeTarget          target,
+                          std::span<char>       dst,
+                          uint32_t              numThreads = 0);
+
+}  // namespace texture_decode
@@ -72,6 +72,15 @@ T lerp(T a, T b, T t)
   return glm::mix(a, b, t);
 }
 
+// Componentwise a * b + c; glm only defines fma() for scalars
+template <glm::length_t N, typename ScalarType, glm::qualifier Precision>
+glm::vec<N, ScalarType, Precision> fma(glm::vec<N, ScalarType, Precision> a,
+                                       glm::vec<N, ScalarType, Precision> b,
+                                       glm::vec<N, ScalarType, Precision> c)
+{
+  return a * b + c;
+}
+
 template <glm::length_t N, typename ScalarType, glm::qualifier Precision>
 glm::vec<N, ScalarType, Precision> mul(glm::vec<N, ScalarType, Precision> v, glm::mat<N, N, ScalarType, Precision> M)
 {
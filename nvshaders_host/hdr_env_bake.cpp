@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "nvshaders/slang_types.h"
+#include "nvshaders/functions.h.slang"
+#include "nvshaders/hdr_prefilter_functions.h.slang"
+
+#include "hdr_env_bake.hpp"
+#include "nvutils/parallel_work.hpp"
+#include "nvutils/rgbe_decode.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HDR_BAKE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace nvshaders {
+
+namespace {
+
+// An RGBA texel, in a SIMD register where available; everything here adds
+// up texels with scalar weights.
+struct Rgba
+{
+#if HDR_BAKE_SSE
+  __m128 v;
+  static Rgba zero() { return {_mm_setzero_ps()}; }
+  static Rgba load(const float* p) { return {_mm_loadu_ps(p)}; }
+  void        store(float* p) const { _mm_storeu_ps(p, v); }
+  // Returns *this + a * s.
+  Rgba madd(Rgba a, float s) const { return {_mm_add_ps(v, _mm_mul_ps(a.v, _mm_set1_ps(s)))}; }
+#else
+  std::array<float, 4> v;
+  static Rgba zero() { return {}; }
+  static Rgba load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+  void        store(float* p) const { memcpy(p, v.data(), sizeof(v)); }
+  Rgba        madd(Rgba a, float s) const
+  {
+    return {{v[0] + a.v[0] * s, v[1] + a.v[1] * s, v[2] + a.v[2] * s, v[3] + a.v[3] * s}};
+  }
+#endif
+};
+
+// Normalization constants of the real spherical harmonics
+const double kShY00 = 0.5 * std::sqrt(1.0 / M_PI);
+const double kShY1  = std::sqrt(3.0 / (4.0 * M_PI));
+const double kShY2  = 0.5 * std::sqrt(15.0 / M_PI);
+const double kShY20 = 0.25 * std::sqrt(5.0 / M_PI);
+const double kShY22 = 0.25 * std::sqrt(15.0 / M_PI);
+
+std::array<float, 9> shBasis(const glm::vec3& d)
+{
+  return {float(kShY00),
+          float(kShY1) * d.x,
+          float(kShY1) * d.y,
+          float(kShY1) * d.z,
+          float(kShY2) * d.x * d.z,
+          float(kShY2) * d.x * d.y,
+          float(kShY20) * (3.0F * d.y * d.y - 1.0F),
+          float(kShY2) * d.y * d.z,
+          float(kShY22) * (d.z * d.z - d.x * d.x)};
+}
+
+// The equirectangular environment, and a box-filtered mip chain of it, to
+// read samples that cover a larger solid angle from.
+class EnvironmentPyramid
+{
+public:
+  EnvironmentPyramid(const float* rgba, uint32_t width, uint32_t height, uint32_t numThreads)
+  {
+    m_levels.push_back({width, height, rgba});
+    while(width > 1 || height > 1)
+    {
+      const uint32_t srcWidth = width, srcHeight = height;
+      const float*   src      = m_levels.back().rgba;
+      width                   = std::max(1u, width / 2);
+      height                  = std::max(1u, height / 2);
+
+      std::vector<float>& storage = m_storage.emplace_back(size_t(width) * height * 4);
+      float*              dst     = storage.data();
+      nvutils::parallel_batches<8>(
+          height,
+          [&](uint64_t y) {
+            const uint32_t y0 = std::min(uint32_t(y) * 2, srcHeight - 1), y1 = std::min(y0 + 1, srcHeight - 1);
+            for(uint32_t x = 0; x < width; x++)
+            {
+              const uint32_t x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x0 + 1, srcWidth - 1);
+              Rgba           sum = Rgba::zero();
+              sum                = sum.madd(Rgba::load(src + (size_t(y0) * srcWidth + x0) * 4), 0.25F);
+              sum                = sum.madd(Rgba::load(src + (size_t(y0) * srcWidth + x1) * 4), 0.25F);
+              sum                = sum.madd(Rgba::load(src + (size_t(y1) * srcWidth + x0) * 4), 0.25F);
+              sum                = sum.madd(Rgba::load(src + (size_t(y1) * srcWidth + x1) * 4), 0.25F);
+              sum.store(dst + (y * width + x) * 4);
+            }
+          },
+          numThreads);
+      m_levels.push_back({width, height, dst});
+    }
+  }
+
+  // Average solid angle of a texel of level 0
+  float texelSolidAngle() const { return float(4.0 * M_PI / (double(m_levels[0].width) * double(m_levels[0].height))); }
+
+  // Adds weight * the trilinearly filtered environment at `uv` to `sum`;
+  // u wraps around, v is clamped.
+  void addSample(Rgba& sum, const glm::vec2& uv, float lod, float weight) const
+  {
+    lod               = std::clamp(lod, 0.0F, float(m_levels.size() - 1));
+    const uint32_t l0 = uint32_t(lod);
+    const float    fl = lod - float(l0);
+    addBilinear(sum, m_levels[l0], uv, weight * (1.0F - fl));
+    if(fl > 0.0F)
+    {
+      addBilinear(sum, m_levels[l0 + 1], uv, weight * fl);
+    }
+  }
+
+private:
+  struct Level
+  {
+    uint32_t     width  = 0;
+    uint32_t     height = 0;
+    const float* rgba   = nullptr;
+  };
+
+  static void addBilinear(Rgba& sum, const Level& level, const glm::vec2& uv, float weight)
+  {
+    const float    x  = uv.x * float(level.width) - 0.5F;
+    const float    y  = std::clamp(uv.y * float(level.height) - 0.5F, 0.0F, float(level.height - 1));
+    const float    fx = x - std::floor(x);
+    const float    fy = y - std::floor(y);
+    const int64_t  ix = int64_t(std::floor(x)) % int64_t(level.width);
+    const uint32_t x0 = uint32_t(ix < 0 ? ix + level.width : ix);
+    const uint32_t x1 = x0 + 1 == level.width ? 0 : x0 + 1;
+    const uint32_t y0 = uint32_t(y);
+    const uint32_t y1 = std::min(y0 + 1, level.height - 1);
+
+    const float* row0 = level.rgba + size_t(y0) * level.width * 4;
+    const float* row1 = level.rgba + size_t(y1) * level.width * 4;
+    sum               = sum.madd(Rgba::load(row0 + x0 * 4), weight * (1.0F - fx) * (1.0F - fy));
+    sum               = sum.madd(Rgba::load(row0 + x1 * 4), weight * fx * (1.0F - fy));
+    sum               = sum.madd(Rgba::load(row1 + x0 * 4), weight * (1.0F - fx) * fy);
+    sum               = sum.madd(Rgba::load(row1 + x1 * 4), weight * fx * fy);
+  }
+
+  std::vector<Level>              m_levels;
+  std::vector<std::vector<float>> m_storage;
+};
+
+// Calls fn(direction, texel) for each texel of one mip of `cube`,
+// in parallel over rows.
+template <typename F>
+void forEachCubeTexel(CubeMap& cube, uint32_t mip, uint32_t numThreads, F&& fn)
+{
+  const uint32_t size = std::max(1u, cube.size >> mip);
+  float*         data = cube.mips[mip].data();
+  nvutils::parallel_batches<1>(
+      uint64_t(6) * size,
+      [&](uint64_t row) {
+        const uint32_t face = uint32_t(row / size);
+        const uint32_t y    = uint32_t(row % size);
+        for(uint32_t x = 0; x < size; x++)
+        {
+          const glm::vec2 uv((float(x) + 0.5F) / float(size), (float(y) + 0.5F) / float(size));
+          fn(cubeMapDirection(face, uv), data + ((size_t(face) * size + y) * size + x) * 4);
+        }
+      },
+      numThreads);
+}
+
+CubeMap allocateCube(uint32_t size, uint32_t numMips)
+{
+  CubeMap cube{.size = size};
+  for(uint32_t mip = 0; mip < numMips; mip++)
+  {
+    const size_t mipSize = std::max(1u, size >> mip);
+    cube.mips.emplace_back(6 * mipSize * mipSize * 4);
+  }
+  return cube;
+}
+
+}  // namespace
+
+SphericalHarmonicsL2 projectEnvironmentSH(const float* rgba, uint32_t width, uint32_t height, uint32_t numThreads)
+{
+  // Separating the basis functions into a part that depends on theta and one
+  // that depends on phi, each row only needs the sums of its texels times
+  // 1, cos(phi), sin(phi), cos(2 phi), and sin(2 phi).
+  enum
+  {
+    eSum,
+    eCos1,
+    eSin1,
+    eCos2,
+    eSin2,
+    eFourierCount
+  };
+  std::array<std::vector<float>, eFourierCount> columnWeights;
+  for(std::vector<float>& weights : columnWeights)
+  {
+    weights.resize(width);
+  }
+  for(uint32_t x = 0; x < width; x++)
+  {
+    // As getSphericalUv(): phi = atan2(z, x)
+    const double phi      = (double(x) + 0.5) / double(width) * 2.0 * M_PI - M_PI;
+    columnWeights[eSum][x]  = 1.0F;
+    columnWeights[eCos1][x] = float(std::cos(phi));
+    columnWeights[eSin1][x] = float(std::sin(phi));
+    columnWeights[eCos2][x] = float(std::cos(2.0 * phi));
+    columnWeights[eSin2][x] = float(std::sin(2.0 * phi));
+  }
+
+  std::vector<std::array<glm::dvec3, eFourierCount>> rowSums(height);
+  nvutils::parallel_batches<8>(
+      height,
+      [&](uint64_t y) {
+        const float*                     row = rgba + y * width * 4;
+        std::array<Rgba, eFourierCount> sums;
+        sums.fill(Rgba::zero());
+        for(uint32_t x = 0; x < width; x++)
+        {
+          const Rgba texel = Rgba::load(row + size_t(x) * 4);
+          sums[eSum]       = sums[eSum].madd(texel, 1.0F);
+          sums[eCos1]      = sums[eCos1].madd(texel, columnWeights[eCos1][x]);
+          sums[eSin1]      = sums[eSin1].madd(texel, columnWeights[eSin1][x]);
+          sums[eCos2]      = sums[eCos2].madd(texel, columnWeights[eCos2][x]);
+          sums[eSin2]      = sums[eSin2].madd(texel, columnWeights[eSin2][x]);
+        }
+        for(int i = 0; i < eFourierCount; i++)
+        {
+          float rgbaSum[4];
+          sums[i].store(rgbaSum);
+          rowSums[y][i] = glm::dvec3(rgbaSum[0], rgbaSum[1], rgbaSum[2]);
+        }
+      },
+      numThreads);
+
+  // Rows are combined in order, in double precision, so that the result
+  // doesn't depend on the number of threads.
+  std::array<glm::dvec3, 9> coefficients{};
+  const double              stepPhi   = 2.0 * M_PI / double(width);
+  const double              stepTheta = M_PI / double(height);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    // x = sin(theta) cos(phi), y = cos(theta), z = sin(theta) sin(phi)
+    const double theta = (double(y) + 0.5) * stepTheta;
+    const double c     = std::cos(theta);
+    const double s     = std::sin(theta);
+    // Solid angle of the row's texels, as in HdrIbl
+    const double area = (std::cos(double(y) * stepTheta) - std::cos(double(y + 1) * stepTheta)) * stepPhi;
+
+    const std::array<glm::dvec3, eFourierCount>& sums = rowSums[y];
+    coefficients[0] += area * kShY00 * sums[eSum];
+    coefficients[1] += area * kShY1 * s * sums[eCos1];
+    coefficients[2] += area * kShY1 * c * sums[eSum];
+    coefficients[3] += area * kShY1 * s * sums[eSin1];
+    coefficients[4] += area * kShY2 * s * s * 0.5 * sums[eSin2];
+    coefficients[5] += area * kShY2 * s * c * sums[eCos1];
+    coefficients[6] += area * kShY20 * (3.0 * c * c - 1.0) * sums[eSum];
+    coefficients[7] += area * kShY2 * c * s * sums[eSin1];
+    coefficients[8] += area * kShY22 * -s * s * sums[eCos2];
+  }
+
+  SphericalHarmonicsL2 sh;
+  for(size_t i = 0; i < coefficients.size(); i++)
+  {
+    sh.coefficients[i] = glm::vec3(coefficients[i]);
+  }
+  return sh;
+}
+
+glm::vec3 evaluateSH(const SphericalHarmonicsL2& sh, const glm::vec3& direction)
+{
+  const std::array<float, 9> basis = shBasis(direction);
+  glm::vec3                  result(0.0F);
+  for(size_t i = 0; i < basis.size(); i++)
+  {
+    result += basis[i] * sh.coefficients[i];
+  }
+  return result;
+}
+
+glm::vec3 evaluateIrradianceSH(const SphericalHarmonicsL2& sh, const glm::vec3& normal)
+{
+  // Convolving with the clamped cosine scales each band; see Ramamoorthi and
+  // Hanrahan, "An Efficient Representation for Irradiance Environment Maps".
+  const std::array<float, 3> band  = {float(M_PI), float(2.0 * M_PI / 3.0), float(M_PI / 4.0)};
+  const std::array<float, 9> basis = shBasis(normal);
+  glm::vec3                  result(0.0F);
+  for(size_t i = 0; i < basis.size(); i++)
+  {
+    result += band[i == 0 ? 0 : (i < 4 ? 1 : 2)] * basis[i] * sh.coefficients[i];
+  }
+  return result;
+}
+
+glm::vec3 cubeMapDirection(uint32_t face, const glm::vec2& uv)
+{
+  // What the prefilter shaders compute from HdrEnvDome::renderToCube's
+  // matrices
+  static const std::array<glm::mat4, 6> faceMatrices = [] {
+    glm::mat4 matPers = glm::perspectiveRH_ZO(glm::radians(90.0F), 1.0F, 0.1F, 10.0F);
+    matPers[1][1] *= -1.0F;
+    matPers = glm::inverse(matPers);
+
+    const glm::vec3          pos(0.0F, 0.0F, 0.0F);
+    std::array<glm::mat4, 6> mv;
+    mv[0] = glm::lookAt(pos, glm::vec3(1.0F, 0.0F, 0.0F), glm::vec3(0.0F, -1.0F, 0.0F));   // Positive X
+    mv[1] = glm::lookAt(pos, glm::vec3(-1.0F, 0.0F, 0.0F), glm::vec3(0.0F, -1.0F, 0.0F));  // Negative X
+    mv[2] = glm::lookAt(pos, glm::vec3(0.0F, -1.0F, 0.0F), glm::vec3(0.0F, 0.0F, -1.0F));  // Positive Y
+    mv[3] = glm::lookAt(pos, glm::vec3(0.0F, 1.0F, 0.0F), glm::vec3(0.0F, 0.0F, 1.0F));    // Negative Y
+    mv[4] = glm::lookAt(pos, glm::vec3(0.0F, 0.0F, 1.0F), glm::vec3(0.0F, -1.0F, 0.0F));   // Positive Z
+    mv[5] = glm::lookAt(pos, glm::vec3(0.0F, 0.0F, -1.0F), glm::vec3(0.0F, -1.0F, 0.0F));  // Negative Z
+    for(glm::mat4& m : mv)
+    {
+      m = glm::inverse(m) * matPers;
+    }
+    return mv;
+  }();
+
+  const glm::vec2 d         = uv * 2.0F - 1.0F;
+  const glm::vec3 direction = glm::vec3(shaderio::mul(glm::vec4(d.x, d.y, 1.0F, 1.0F), faceMatrices[face]));
+  return glm::normalize(glm::vec3(direction.x, -direction.y, direction.z));  // Flipping Y
+}
+
+CubeMap bakeDiffuseCube(const SphericalHarmonicsL2& sh, uint32_t size, uint32_t numThreads)
+{
+  CubeMap cube = allocateCube(size, 1);
+  forEachCubeTexel(cube, 0, numThreads, [&](const glm::vec3& normal, float* texel) {
+    const glm::vec3 diffuse = glm::max(evaluateIrradianceSH(sh, normal), glm::vec3(0.0F)) * float(M_1_PI);
+    texel[0]                = diffuse.x;
+    texel[1]                = diffuse.y;
+    texel[2]                = diffuse.z;
+    texel[3]                = 1.0F;
+  });
+  return cube;
+}
+
+CubeMap prefilterGlossyCube(const float* rgba, uint32_t width, uint32_t height, uint32_t size, uint32_t numSamples, uint32_t numThreads)
+{
+  const uint32_t     numMips = static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
+  CubeMap            cube    = allocateCube(size, numMips);
+  EnvironmentPyramid environment(rgba, width, height, numThreads);
+
+  // The sample directions around the normal are the same for all texels of
+  // a mip: GGX half vectors at Hammersley points, reflecting the view (which
+  // is assumed to be the normal, as in the shader).
+  struct Sample
+  {
+    glm::vec3 direction;  // In tangent space
+    float     weight;     // cos(theta)
+    float     lod;
+  };
+  std::vector<Sample> samples;
+
+  for(uint32_t mip = 0; mip < numMips; mip++)
+  {
+    const float alpha = numMips > 1 ? float(mip) / float(numMips - 1) : 0.0F;
+
+    samples.clear();
+    if(alpha == 0.0F)
+    {
+      samples.push_back({glm::vec3(0.0F, 0.0F, 1.0F), 1.0F, 0.0F});
+    }
+    else
+    {
+      for(uint32_t i = 0; i < numSamples; i++)
+      {
+        const glm::vec3 h         = shaderio::ggxSample(shaderio::hammersley2D(i, numSamples), alpha);
+        const glm::vec3 direction = 2.0F * h.z * h - glm::vec3(0.0F, 0.0F, 1.0F);
+        if(direction.z <= 0.0F)
+        {
+          continue;
+        }
+        // Read the environment at the level whose texels cover about the
+        // sample's share of the solid angle; see Krivanek and Colbert,
+        // "Real-time Shading with Filtered Importance Sampling".
+        const float pdf        = shaderio::ggxEval(alpha, h.z) * 0.25F / h.z;
+        const float solidAngle = 1.0F / (float(numSamples) * pdf);
+        const float lod        = 0.5F * std::log2(solidAngle / environment.texelSolidAngle()) + 1.0F;
+        samples.push_back({direction, direction.z, lod});
+      }
+    }
+
+    forEachCubeTexel(cube, mip, numThreads, [&](const glm::vec3& normal, float* texel) {
+      glm::vec3 tangent, bitangent;
+      shaderio::orthonormalBasis(normal, tangent, bitangent);
+
+      Rgba  sum       = Rgba::zero();
+      float weightSum = 0.0F;
+      for(const Sample& sample : samples)
+      {
+        const glm::vec3 direction = tangent * sample.direction.x + bitangent * sample.direction.y + normal * sample.direction.z;
+        environment.addSample(sum, shaderio::getSphericalUv(direction), sample.lod, sample.weight);
+        weightSum += sample.weight;
+      }
+      sum = Rgba::zero().madd(sum, 1.0F / weightSum);
+      sum.store(texel);
+      texel[3] = 1.0F;
+    });
+  }
+  return cube;
+}
+
+std::vector<float> integrateBrdfLut(uint32_t size, uint32_t numSamples, uint32_t numThreads)
+{
+  std::vector<float> lut(size_t(size) * size * 2);
+  nvutils::parallel_batches<1>(
+      size,
+      [&](uint64_t y) {
+        // As hdr_integrate_brdf.slang
+        const float roughness = 1.0F - (float(y) + 0.5F) / float(size);
+        float*      row       = lut.data() + y * size * 2;
+#if HDR_BAKE_SSE
+        // The half vectors only depend on the row. Keep their x and z (the
+        // view has y = 0), 4 at a time; padding is backfacing, so it's skipped.
+        const uint32_t     numGroups = (numSamples + 3) / 4;
+        std::vector<float> hx(numGroups * 4, 0.0F), hz(numGroups * 4, 0.0F);
+        for(uint32_t i = 0; i < numSamples; i++)
+        {
+          const glm::vec3 h0 = shaderio::ggxSample(shaderio::hammersley2D(i, numSamples), roughness * roughness);
+          hx[i]              = h0.y;  // h = (h0.y, -h0.x, h0.z)
+          hz[i]              = h0.z;
+        }
+        const float  k         = roughness * roughness / 2.0F;
+        const __m128 zero      = _mm_setzero_ps();
+        const __m128 one       = _mm_set1_ps(1.0F);
+        const __m128 oneMinusK = _mm_set1_ps(1.0F - k);
+        const __m128 kv        = _mm_set1_ps(k);
+
+        for(uint32_t x = 0; x < size; x++)
+        {
+          const float ndotv = (float(x) + 0.5F) / float(size);
+          const float sinv  = std::sqrt(1.0F - ndotv * ndotv);
+          // geometrySchlickGgx(ndotv) / ndotv, as G_Vis divides by ndotv
+          const __m128 gv   = _mm_set1_ps(shaderio::geometrySchlickGgx(ndotv, roughness) / ndotv);
+          const __m128 nv   = _mm_set1_ps(ndotv);
+          const __m128 sv   = _mm_set1_ps(sinv);
+          __m128       sumA = zero;
+          __m128       sumB = zero;
+          for(uint32_t g = 0; g < numGroups; g++)
+          {
+            const __m128 hxg   = _mm_loadu_ps(&hx[g * 4]);
+            const __m128 hzg   = _mm_loadu_ps(&hz[g * 4]);
+            const __m128 vdoth = _mm_max_ps(_mm_add_ps(_mm_mul_ps(sv, hxg), _mm_mul_ps(nv, hzg)), zero);
+            // light.z of 2 dot(view, h) h - view
+            const __m128 ndotl = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(vdoth, vdoth), hzg), nv);
+            const __m128 mask  = _mm_cmpgt_ps(ndotl, zero);
+            const __m128 gl    = _mm_div_ps(ndotl, _mm_add_ps(_mm_mul_ps(ndotl, oneMinusK), kv));
+            // G * vdoth / (ndoth * ndotv)
+            const __m128 gVis =
+                _mm_and_ps(mask, _mm_div_ps(_mm_mul_ps(_mm_mul_ps(gv, gl), vdoth), _mm_max_ps(hzg, _mm_set1_ps(1e-30F))));
+            const __m128 m    = _mm_sub_ps(one, vdoth);
+            const __m128 m2   = _mm_mul_ps(m, m);
+            const __m128 fc   = _mm_mul_ps(_mm_mul_ps(m2, m2), m);  // pow(1 - vdoth, 5)
+            sumA              = _mm_add_ps(sumA, _mm_mul_ps(_mm_sub_ps(one, fc), gVis));
+            sumB              = _mm_add_ps(sumB, _mm_mul_ps(fc, gVis));
+          }
+          float a[4], b[4];
+          _mm_storeu_ps(a, sumA);
+          _mm_storeu_ps(b, sumB);
+          row[x * 2 + 0] = (a[0] + a[1] + a[2] + a[3]) / float(numSamples);
+          row[x * 2 + 1] = (b[0] + b[1] + b[2] + b[3]) / float(numSamples);
+        }
+#else
+        for(uint32_t x = 0; x < size; x++)
+        {
+          const glm::vec2 brdf = shaderio::integrateBrdf((float(x) + 0.5F) / float(size), roughness, numSamples);
+          row[x * 2 + 0]       = brdf.x;
+          row[x * 2 + 1]       = brdf.y;
+        }
+#endif
+      },
+      numThreads);
+  return lut;
+}
+
+nv_ktx::ErrorWithText cubeMapToKTX(const CubeMap& cube, nv_ktx::KTXImage& image)
+{
+  const uint32_t numMips = uint32_t(cube.mips.size());
+  if(nv_ktx::ErrorWithText error = image.allocate(numMips, 0, 6))
+  {
+    return error;
+  }
+  image.format       = VK_FORMAT_R16G16B16A16_SFLOAT;
+  image.mip_0_width  = cube.size;
+  image.mip_0_height = cube.size;
+  image.is_srgb      = false;
+  for(uint32_t mip = 0; mip < numMips; mip++)
+  {
+    const size_t faceValues = cube.mips[mip].size() / 6;
+    for(uint32_t face = 0; face < 6; face++)
+    {
+      std::vector<char>& subresource = image.subresource(mip, 0, face);
+      subresource.resize(faceValues * sizeof(uint16_t));
+      nvutils::floatToHalf(cube.mips[mip].data() + face * faceValues, faceValues, reinterpret_cast<uint16_t*>(subresource.data()));
+    }
+  }
+  return {};
+}
+
+nv_ktx::ErrorWithText brdfLutToKTX(std::span<const float> lut, uint32_t size, nv_ktx::KTXImage& image)
+{
+  if(lut.size() != size_t(size) * size * 2)
+  {
+    return "The BRDF table must have size * size * 2 values.";
+  }
+  if(nv_ktx::ErrorWithText error = image.allocate(1, 0, 1))
+  {
+    return error;
+  }
+  image.format       = VK_FORMAT_R16G16_SFLOAT;
+  image.mip_0_width  = size;
+  image.mip_0_height = size;
+  image.is_srgb      = false;
+
+  std::vector<char>& subresource = image.subresource(0, 0, 0);
+  subresource.resize(lut.size() * sizeof(uint16_t));
+  nvutils::floatToHalf(lut.data(), lut.size(), reinterpret_cast<uint16_t*>(subresource.data()));
+  return {};
+}
+
+}  // namespace nvshaders
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvimageformats/nv_ktx.h"
+
+namespace nvshaders {
+
+/*-------------------------------------------------------------------------------------------------
+# CPU environment baking
+
+Computes the image-based lighting data of HdrEnvDome on the CPU, so that it
+can be precomputed and cached without a device, e.g. in asset pipelines:
+- projectEnvironmentSH() projects an environment onto L2 spherical harmonics;
+  evaluateIrradianceSH() evaluates the irradiance they represent, and
+  bakeDiffuseCube() bakes it into a cube map like hdr_prefilter_diffuse.slang
+- prefilterGlossyCube() prefilters an environment for GGX reflections, one
+  roughness per mip as hdr_prefilter_glossy.slang
+- integrateBrdfLut() computes the split-sum BRDF table of hdr_integrate_brdf.slang
+
+The mapping and basis functions come from nvshaders/functions.h.slang, and
+the GGX sampling and BRDF integration from hdr_prefilter_functions.h.slang,
+which the shaders use too. Environments are equirectangular RGBA32F images
+laid out as for HdrIbl (see getSphericalUv); their alpha channel is ignored.
+Cube maps have the faces, orientation and mip roughness of HdrEnvDome's. Work
+runs on nvutils' thread pool, on `numThreads` threads (0 for all).
+
+Instead of integrating the GPU shaders' random samples, the glossy cube is
+prefiltered with a fixed set of GGX samples, each reading the environment at
+the mip level that matches its solid angle ("filtered importance sampling"),
+which needs far fewer samples for the same noise.
+
+```cpp
+nvshaders::SphericalHarmonicsL2 sh      = nvshaders::projectEnvironmentSH(rgba, width, height);
+nvshaders::CubeMap              diffuse = nvshaders::bakeDiffuseCube(sh, 128);
+nvshaders::CubeMap              glossy  = nvshaders::prefilterGlossyCube(rgba, width, height, 512);
+
+nv_ktx::KTXImage image;
+if(!nvshaders::cubeMapToKTX(glossy, image))
+{
+  image.writeKTX2File("glossy.ktx2", {});
+}
+```
+-------------------------------------------------------------------------------------------------*/
+
+// RGB coefficients of the real spherical harmonics up to band 2, with +Y up:
+// in order, proportional to 1; x, y, z; xz, xy, 3y^2 - 1, yz, z^2 - x^2.
+struct SphericalHarmonicsL2
+{
+  std::array<glm::vec3, 9> coefficients{};
+};
+
+// Cube map of RGBA32F texels; each mip holds the 6 faces in Vulkan order,
+// each (size >> mip)^2 texels in rows from the top.
+struct CubeMap
+{
+  uint32_t                        size = 0;
+  std::vector<std::vector<float>> mips;
+};
+
+// Integrates the radiance times each basis function over the sphere.
+SphericalHarmonicsL2 projectEnvironmentSH(const float* rgba, uint32_t width, uint32_t height, uint32_t numThreads = 0);
+
+// The radiance, and the irradiance (cosine-weighted integral of the
+// radiance over the hemisphere) around `direction`, which must be unit length.
+glm::vec3 evaluateSH(const SphericalHarmonicsL2& sh, const glm::vec3& direction);
+glm::vec3 evaluateIrradianceSH(const SphericalHarmonicsL2& sh, const glm::vec3& normal);
+
+// Direction that the texel center at `uv` (0 to 1) of a cube face points to.
+glm::vec3 cubeMapDirection(uint32_t face, const glm::vec2& uv);
+
+// One mip of irradiance / pi, the diffuse reflection of a white surface.
+CubeMap bakeDiffuseCube(const SphericalHarmonicsL2& sh, uint32_t size, uint32_t numThreads = 0);
+
+// A full mip chain; mip m is filtered with GGX alpha m / (mips - 1), and all
+// but mip 0 with `numSamples` samples per texel.
+CubeMap prefilterGlossyCube(const float* rgba, uint32_t width, uint32_t height, uint32_t size, uint32_t numSamples = 64, uint32_t numThreads = 0);
+
+// RG32F table: x is dot(N, V), y is 1 - roughness.
+std::vector<float> integrateBrdfLut(uint32_t size, uint32_t numSamples = 1024, uint32_t numThreads = 0);
+
+// Sets up `image` as an R16G16B16A16_SFLOAT cube map or R16G16_SFLOAT 2D
+// image, as HdrEnvDome creates them.
+nv_ktx::ErrorWithText cubeMapToKTX(const CubeMap& cube, nv_ktx::KTXImage& image);
+nv_ktx::ErrorWithText brdfLutToKTX(std::span<const float> lut, uint32_t size, nv_ktx::KTXImage& image);
+
+}  // namespace nvshaders
@@ -0,0 +1,736 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "nvshaders/slang_types.h"
+#include "nvshaders/tonemap_functions.h.slang"
+
+#include "tonemapper_cpu.hpp"
+#include "nvutils/parallel_work.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TONEMAP_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace nvshaders {
+
+namespace {
+
+// Rows per tile; each tile is a work item of the thread pool.
+constexpr uint32_t kTileRows = 8;
+
+// 4 floats, one per pixel, in a SIMD register where available. Every
+// operation rounds as its scalar counterpart does, so that sequences of them
+// give the same results as the scalar code in tonemap_functions.h.slang.
+struct Float4
+{
+#if TONEMAP_SSE
+  __m128 v;
+  Float4() = default;
+  Float4(__m128 x)
+      : v(x)
+  {
+  }
+  Float4(float x)
+      : v(_mm_set1_ps(x))
+  {
+  }
+  static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+  void          store(float* p) const { _mm_storeu_ps(p, v); }
+  friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+  friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+  friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+  friend Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+  // Masks have all bits of a lane set where the comparison holds.
+  friend Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+  friend Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+  friend Float4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+  friend Float4 operator==(Float4 a, Float4 b) { return _mm_cmpeq_ps(a.v, b.v); }
+  friend Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a.v, b.v); }
+  friend Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+  // Returns `mask ? a : b` per lane.
+  friend Float4 select(Float4 mask, Float4 a, Float4 b)
+  {
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+  }
+  // As glm's min(a, b) and max(a, b) when neither is NaN
+  friend Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+  friend Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+  friend Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+  friend Float4 abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0F), a.v); }
+  // For |a| < 2^31
+  friend Float4 floor(Float4 a)
+  {
+    const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0F)));
+  }
+  // Splits a positive normal float into its mantissa in [1, 2) and exponent.
+  friend Float4 frexp1(Float4 a, Float4& exponent)
+  {
+    const __m128i bits = _mm_castps_si128(a.v);
+    exponent           = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    return _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+  }
+  // 2^n for integers n in [-126, 127]
+  friend Float4 exp2Integer(Float4 n)
+  {
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127)), 23));
+  }
+#else
+  std::array<float, 4> v;
+  Float4() = default;
+  Float4(float x)
+      : v{x, x, x, x}
+  {
+  }
+  static Float4 load(const float* p) { return map([&](int i) { return p[i]; }); }
+  void          store(float* p) const { memcpy(p, v.data(), sizeof(v)); }
+  template <typename F>
+  static Float4 map(F&& f)
+  {
+    Float4 r;
+    for(int i = 0; i < 4; i++)
+    {
+      r.v[i] = f(i);
+    }
+    return r;
+  }
+  static float mask(bool b)
+  {
+    const uint32_t bits = b ? ~0u : 0u;
+    float          f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+  static uint32_t bits(float f)
+  {
+    uint32_t b;
+    memcpy(&b, &f, sizeof(b));
+    return b;
+  }
+  static float fromBits(uint32_t b)
+  {
+    float f;
+    memcpy(&f, &b, sizeof(f));
+    return f;
+  }
+  friend Float4 operator+(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] + b.v[i]; }); }
+  friend Float4 operator-(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] - b.v[i]; }); }
+  friend Float4 operator*(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] * b.v[i]; }); }
+  friend Float4 operator/(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] / b.v[i]; }); }
+  friend Float4 operator<(Float4 a, Float4 b) { return map([&](int i) { return mask(a.v[i] < b.v[i]); }); }
+  friend Float4 operator>(Float4 a, Float4 b) { return map([&](int i) { return mask(a.v[i] > b.v[i]); }); }
+  friend Float4 operator>=(Float4 a, Float4 b) { return map([&](int i) { return mask(a.v[i] >= b.v[i]); }); }
+  friend Float4 operator==(Float4 a, Float4 b) { return map([&](int i) { return mask(a.v[i] == b.v[i]); }); }
+  friend Float4 operator|(Float4 a, Float4 b) { return map([&](int i) { return fromBits(bits(a.v[i]) | bits(b.v[i])); }); }
+  friend Float4 operator&(Float4 a, Float4 b) { return map([&](int i) { return fromBits(bits(a.v[i]) & bits(b.v[i])); }); }
+  friend Float4 select(Float4 mask, Float4 a, Float4 b)
+  {
+    return map([&](int i) { return bits(mask.v[i]) ? a.v[i] : b.v[i]; });
+  }
+  friend Float4 min(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] < b.v[i] ? a.v[i] : b.v[i]; }); }
+  friend Float4 max(Float4 a, Float4 b) { return map([&](int i) { return a.v[i] > b.v[i] ? a.v[i] : b.v[i]; }); }
+  friend Float4 sqrt(Float4 a) { return map([&](int i) { return std::sqrt(a.v[i]); }); }
+  friend Float4 abs(Float4 a) { return map([&](int i) { return std::abs(a.v[i]); }); }
+  friend Float4 floor(Float4 a) { return map([&](int i) { return std::floor(a.v[i]); }); }
+  friend Float4 frexp1(Float4 a, Float4& exponent)
+  {
+    exponent = map([&](int i) { return float(int32_t(bits(a.v[i]) >> 23) - 127); });
+    return map([&](int i) { return fromBits((bits(a.v[i]) & 0x007FFFFFu) | 0x3F800000u); });
+  }
+  friend Float4 exp2Integer(Float4 n) { return map([&](int i) { return fromBits(uint32_t(int32_t(n.v[i]) + 127) << 23); }); }
+#endif
+  Float4& operator+=(Float4 b) { return *this = *this + b; }
+  Float4& operator-=(Float4 b) { return *this = *this - b; }
+  Float4& operator*=(Float4 b) { return *this = *this * b; }
+};
+
+// log2(x) for x > 0; x below the smallest normal float counts as it. Within
+// 2 ulps of the result or 1e-7 of 0.
+Float4 log2(Float4 x)
+{
+  Float4 exponent;
+  Float4 m = frexp1(max(x, Float4(1.17549435e-38F)), exponent);
+  // Moves m to [sqrt(1/2), sqrt(2)), around 0 after subtracting 1
+  const Float4 high = m > Float4(1.41421356F);
+  m                 = select(high, m * Float4(0.5F), m);
+  exponent          = select(high, exponent + Float4(1.0F), exponent);
+  // ln(1 + f), as Cephes' logf()
+  const Float4 f = m - Float4(1.0F);
+  const Float4 z = f * f;
+  Float4       p = Float4(7.0376836292E-2F);
+  p              = p * f + Float4(-1.1514610310E-1F);
+  p              = p * f + Float4(1.1676998740E-1F);
+  p              = p * f + Float4(-1.2420140846E-1F);
+  p              = p * f + Float4(1.4249322787E-1F);
+  p              = p * f + Float4(-1.6668057665E-1F);
+  p              = p * f + Float4(2.0000714765E-1F);
+  p              = p * f + Float4(-2.4999993993E-1F);
+  p              = p * f + Float4(3.3333331174E-1F);
+  const Float4 ln = f + (f * z * p - Float4(0.5F) * z);
+  return exponent + ln * Float4(1.44269504088896341F);
+}
+
+// 2^x; 0 for x < -126. Within 2 ulps.
+Float4 exp2(Float4 x)
+{
+  const Float4 clamped = min(max(x, Float4(-126.0F)), Float4(127.0F));
+  // Splits x into an integer and a fraction in [-0.5, 0.5], as Cephes' exp2f()
+  const Float4 n = floor(clamped + Float4(0.5F));
+  const Float4 f = clamped - n;
+  Float4       p = Float4(1.535336188319500E-4F);
+  p              = p * f + Float4(1.339887440266574E-3F);
+  p              = p * f + Float4(9.618437357674640E-3F);
+  p              = p * f + Float4(5.550332471162809E-2F);
+  p              = p * f + Float4(2.402264791363012E-1F);
+  p              = p * f + Float4(6.931472028550421E-1F);
+  p              = p * f + Float4(1.0F);
+  return select(x < Float4(-126.0F), Float4(0.0F), p * exp2Integer(n));
+}
+
+// pow(x, y) for y > 0; 0 for x <= 0
+Float4 pow(Float4 x, float y)
+{
+  if(y == 1.0F)
+  {
+    return x;
+  }
+  const Float4 r = exp2(log2(x) * Float4(y));
+  return select(x > Float4(0.0F), select(x == Float4(1.0F), Float4(1.0F), r), Float4(0.0F));
+}
+
+// The R, G and B channels of 4 pixels
+struct Color4
+{
+  Float4 r, g, b;
+
+  friend Color4 operator+(const Color4& a, Float4 s) { return {a.r + s, a.g + s, a.b + s}; }
+  friend Color4 operator-(const Color4& a, Float4 s) { return {a.r - s, a.g - s, a.b - s}; }
+  friend Color4 operator*(const Color4& a, Float4 s) { return {a.r * s, a.g * s, a.b * s}; }
+  friend Color4 operator/(const Color4& a, Float4 s) { return {a.r / s, a.g / s, a.b / s}; }
+  friend Color4 operator+(const Color4& a, const Color4& b) { return {a.r + b.r, a.g + b.g, a.b + b.b}; }
+  friend Color4 operator*(const Color4& a, const Color4& b) { return {a.r * b.r, a.g * b.g, a.b * b.b}; }
+  friend Color4 operator/(const Color4& a, const Color4& b) { return {a.r / b.r, a.g / b.g, a.b / b.b}; }
+};
+
+Color4 max(const Color4& a, Float4 s)
+{
+  return {max(a.r, s), max(a.g, s), max(a.b, s)};
+}
+Color4 clamp(const Color4& a, Float4 lo, Float4 hi)
+{
+  return {min(max(a.r, lo), hi), min(max(a.g, lo), hi), min(max(a.b, lo), hi)};
+}
+Color4 pow(const Color4& a, float y)
+{
+  return {pow(a.r, y), pow(a.g, y), pow(a.b, y)};
+}
+// glm's mix(a, b, t)
+Float4 lerp(Float4 a, Float4 b, Float4 t)
+{
+  return a * (Float4(1.0F) - t) + b * t;
+}
+Color4 lerp(const Color4& a, const Color4& b, Float4 t)
+{
+  return {lerp(a.r, b.r, t), lerp(a.g, b.g, t), lerp(a.b, b.b, t)};
+}
+
+// A 3x3 matrix as the coefficients of x, y and z in each component of the
+// product, so that it sums the terms in glm's order.
+struct Matrix3
+{
+  std::array<std::array<float, 3>, 3> rows;
+
+  // mul(m, color) of slang_types.h, color * m in glm
+  static Matrix3 rowVector(const glm::mat3& m)
+  {
+    return {{{{m[0][0], m[0][1], m[0][2]}, {m[1][0], m[1][1], m[1][2]}, {m[2][0], m[2][1], m[2][2]}}}};
+  }
+  // mul(color, m) of slang_types.h, m * color in glm
+  static Matrix3 columnVector(const glm::mat3& m)
+  {
+    return {{{{m[0][0], m[1][0], m[2][0]}, {m[0][1], m[1][1], m[2][1]}, {m[0][2], m[1][2], m[2][2]}}}};
+  }
+
+  Color4 operator*(const Color4& c) const
+  {
+    return {Float4(rows[0][0]) * c.r + Float4(rows[0][1]) * c.g + Float4(rows[0][2]) * c.b,
+            Float4(rows[1][0]) * c.r + Float4(rows[1][1]) * c.g + Float4(rows[1][2]) * c.b,
+            Float4(rows[2][0]) * c.r + Float4(rows[2][1]) * c.g + Float4(rows[2][2]) * c.b};
+  }
+};
+
+// The input and output transforms of tonemapACES() and tonemapAgX() in
+// tonemap_functions.h.slang
+const Matrix3 kACESInput  = Matrix3::columnVector(shaderio::kACESInputMat);
+const Matrix3 kACESOutput = Matrix3::columnVector(shaderio::kACESOutputMat);
+const Matrix3 kAgXInput   = Matrix3::columnVector(shaderio::kAgXMat);
+const Matrix3 kAgXOutput  = Matrix3::columnVector(shaderio::kAgXMatInv);
+
+//-------------------------------------------------------------------------------------------------
+// The tonemapping curves of tonemap_functions.h.slang, with the same
+// operations in the same order. Where the shaders take pow() of a negative
+// value, which is undefined, pow() here gives 0, and toSrgb() selects the
+// linear part rather than blending in a NaN.
+
+Color4 toSrgb(const Color4& rgb)
+{
+  const Color4 low  = rgb * Float4(12.92f);
+  const Color4 high = pow(rgb, 1.0F / 2.4F) * Float4(1.055F) + Float4(-0.055F);
+  const Float4 threshold(0.0031308F);
+  return {select(rgb.r > threshold, high.r, low.r), select(rgb.g > threshold, high.g, low.g),
+          select(rgb.b > threshold, high.b, low.b)};
+}
+
+Color4 tonemapFilmic(const Color4& color)
+{
+  const Color4 temp = max(color - Float4(0.004F), Float4(0.0F));
+  return (temp * (temp * Float4(6.2F) + Float4(0.5F))) / (temp * (temp * Float4(6.2F) + Float4(1.7F)) + Float4(0.06F));
+}
+
+Color4 tonemapUncharted2Impl(const Color4& color)
+{
+  const float a = 0.15F;
+  const float b = 0.50F;
+  const float c = 0.10F;
+  const float d = 0.20F;
+  const float e = 0.02F;
+  const float f = 0.30F;
+  return ((color * (color * Float4(a) + Float4(c * b)) + Float4(d * e)) / (color * (color * Float4(a) + Float4(b)) + Float4(d * f)))
+         - Float4(e / f);
+}
+
+Color4 tonemapUncharted2(const Color4& color)
+{
+  const float     W             = 11.2F;
+  const float     exposure_bias = 2.0F;
+  const glm::vec3 white_scale   = glm::vec3(1.0F) / shaderio::tonemapUncharted2Impl(glm::vec3(W));
+  const Color4    mapped        = tonemapUncharted2Impl(color * Float4(exposure_bias));
+  return pow(mapped * Color4{Float4(white_scale.x), Float4(white_scale.y), Float4(white_scale.z)}, 1.0F / 2.2F);
+}
+
+Color4 tonemapACES(Color4 color)
+{
+  color          = kACESInput * color;
+  const Color4 a = color * (color + Float4(0.0245786F)) - Float4(0.000090537F);
+  const Color4 b = color * (color * Float4(0.983729F) + Float4(0.4329510F)) + Float4(0.238081F);
+  return toSrgb(kACESOutput * (a / b));
+}
+
+Color4 tonemapAgX(Color4 color)
+{
+  color = kAgXInput * color;
+
+  const float min_ev = -12.47393f;
+  const float max_ev = 4.026069f;
+  color              = clamp({log2(color.r), log2(color.g), log2(color.b)}, Float4(min_ev), Float4(max_ev));
+  color              = (color - Float4(min_ev)) / Float4(max_ev - min_ev);
+
+  Color4 v = color * Float4(15.5F) + Float4(-40.14F);
+  v        = color * v + Float4(31.96F);
+  v        = color * v + Float4(-6.868F);
+  v        = color * v + Float4(0.4298F);
+  v        = color * v + Float4(0.1191F);
+  v        = color * v + Float4(-0.0023F);
+  return kAgXOutput * v;
+}
+
+Color4 tonemapKhronosPBR(Color4 color)
+{
+  const float startCompression = 0.8F - 0.04F;
+  const float desaturation     = 0.15F;
+
+  const Float4 x    = min(color.r, min(color.g, color.b));
+  const Float4 peak = max(color.r, max(color.g, color.b));
+
+  const Float4 offset = select(x < Float4(0.08F), x * (x * Float4(-6.25F) + Float4(1.F)), Float4(0.04F));
+  color               = color - offset;
+
+  const float  d          = 1.F - startCompression;
+  const Float4 newPeak    = Float4(1.F) - Float4(d * d) / (peak + Float4(d) - Float4(startCompression));
+  const Color4 compressed = color * (newPeak / peak);
+  const Float4 g          = Float4(1.F) - Float4(1.F) / (Float4(desaturation) * (peak - newPeak) + Float4(1.F));
+  const Color4 desaturated = lerp(compressed, Color4{newPeak, newPeak, newPeak}, g);
+
+  const Float4 compress = peak >= Float4(startCompression);
+  color = {select(compress, desaturated.r, color.r), select(compress, desaturated.g, color.g), select(compress, desaturated.b, color.b)};
+  return toSrgb(color);
+}
+
+
+// Loads 4 RGBA pixels into a channel each.
+void loadPixels(const float* rgba, std::array<Float4, 4>& channels)
+{
+#if TONEMAP_SSE
+  __m128 p0 = _mm_loadu_ps(rgba), p1 = _mm_loadu_ps(rgba + 4), p2 = _mm_loadu_ps(rgba + 8), p3 = _mm_loadu_ps(rgba + 12);
+  _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+  channels = {p0, p1, p2, p3};
+#else
+  for(int c = 0; c < 4; c++)
+  {
+    channels[c] = Float4::map([&](int i) { return rgba[i * 4 + c]; });
+  }
+#endif
+}
+
+void storePixels(const std::array<Float4, 4>& channels, float* rgba)
+{
+#if TONEMAP_SSE
+  __m128 p0 = channels[0].v, p1 = channels[1].v, p2 = channels[2].v, p3 = channels[3].v;
+  _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+  _mm_storeu_ps(rgba, p0);
+  _mm_storeu_ps(rgba + 4, p1);
+  _mm_storeu_ps(rgba + 8, p2);
+  _mm_storeu_ps(rgba + 12, p3);
+#else
+  for(int c = 0; c < 4; c++)
+  {
+    for(int i = 0; i < 4; i++)
+    {
+      rgba[i * 4 + c] = channels[c].v[i];
+    }
+  }
+#endif
+}
+
+// Converts 16 floats to UNORM8 like the GPU does: clamped, and rounded to
+// the nearest integer, ties to even.
+void toUnorm8(const float* values, uint8_t* unorm)
+{
+#if TONEMAP_SSE
+  __m128i q[4];
+  for(int i = 0; i < 4; i++)
+  {
+    const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + i * 4), _mm_setzero_ps()), _mm_set1_ps(1.0F));
+    q[i]           = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(255.0F)));
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(unorm), _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3])));
+#else
+  for(int i = 0; i < 16; i++)
+  {
+    unorm[i] = uint8_t(std::nearbyint(std::min(std::max(values[i], 0.0F), 1.0F) * 255.0F));
+  }
+#endif
+}
+
+// The settings applyTonemap() reads, precomputed per image
+struct TonemapParameters
+{
+  shaderio::TonemapperData tm;
+  Matrix3                  input;
+  float                    exposureMultiplier = 1.0F;
+  float                    rcpBrightness      = 1.0F;
+  float                    width              = 1.0F;
+  float                    height             = 1.0F;
+  float                    aspect             = 1.0F;
+};
+
+// The Tonemap shader for the pixels at (x + 0..3, y)
+Color4 applyTonemap(const TonemapParameters& params, Color4 color, Float4 x, float y)
+{
+  const shaderio::TonemapperData& tm = params.tm;
+  if(tm.autoExposure == 1)
+  {
+    color = color * Float4(params.exposureMultiplier);
+  }
+
+  // Exposure and white balance
+  color = params.input * color;
+
+  Color4 c;
+  switch(tm.method)
+  {
+    case shaderio::ToneMapMethod::eFilmic:
+      c = tonemapFilmic(color);
+      break;
+    case shaderio::ToneMapMethod::eUncharted2:
+      c = tonemapUncharted2(color);
+      break;
+    case shaderio::ToneMapMethod::eClip:
+      c = toSrgb(color);
+      break;
+    case shaderio::ToneMapMethod::eACES:
+      c = tonemapACES(color);
+      break;
+    case shaderio::ToneMapMethod::eAgX:
+      c = tonemapAgX(color);
+      break;
+    case shaderio::ToneMapMethod::eKhronosPBR:
+      c = tonemapKhronosPBR(color);
+      break;
+    default:
+      c = color;
+      break;
+  }
+
+  // SDR color grading: contrast and clamp, brightness, saturation
+  const Float4 half(0.5F);
+  c              = clamp(lerp(Color4{half, half, half}, c, Float4(tm.contrast)), Float4(0.F), Float4(1.F));
+  c              = pow(c, params.rcpBrightness);
+  const Float4 i = Float4(0.299F) * c.r + Float4(0.587F) * c.g + Float4(0.114F) * c.b;
+  c              = lerp(Color4{i, i, i}, c, Float4(tm.saturation));
+  // Vignette
+  const Float4 center_u = x / Float4(params.width) * Float4(2.0F) - Float4(1.0F);
+  const float  center_v = y / params.height * 2.0F - 1.0F;
+  c                     = c * (Float4(1.0F) - (center_u * center_u + Float4(center_v * center_v)) * Float4(tm.vignette));
+
+  // Dither assuming 8-bit output, with the R2 and triangular noise of applyTonemap()
+  if(tm.dither == 1)
+  {
+    const float  levelsMinus1 = 255.F;
+    const Float4 offset       = x * Float4(0.245122331F) + Float4(y * 0.430159704F);
+    Float4       noise        = offset - floor(offset);
+    noise                     = Float4(.5F) - Float4(2.F) * abs(noise - Float4(.5F));
+    const Float4 sign = select(noise > Float4(0.F), Float4(1.F), select(noise < Float4(0.F), Float4(-1.F), Float4(0.F)));
+    const Float4 trinoise = sign * (Float4(1.F) - sqrt(Float4(1.F) - Float4(2.F) * abs(noise)));
+    const Float4 low(.5F / levelsMinus1), high(1.F - .5F / levelsMinus1);
+    c.r += select((low > c.r) | (c.r > high), noise, trinoise) / Float4(levelsMinus1);
+    c.g += select((low > c.g) | (c.g > high), noise, trinoise) / Float4(levelsMinus1);
+    c.b += select((low > c.b) | (c.b > high), noise, trinoise) / Float4(levelsMinus1);
+  }
+  return c;
+}
+
+// The Histogram shader for the pixels at (x + 0..count-1, y)
+void addToHistogram(const TonemapParameters& params, const Color4& color, uint32_t x, uint32_t y, uint32_t count, ExposureHistogram& histogram)
+{
+  const shaderio::TonemapperData& tm = params.tm;
+
+  // inputToHistogramBucket()
+  const Float4 luminance = Float4(0.2126F) * color.r + Float4(0.7152F) * color.g + Float4(0.0722F) * color.b;
+  const Float4 ev100     = log2(luminance * Float4(float(100.0f / 12.5f)));
+  const float  evRange   = tm.evMaxValue - tm.evMinValue;
+  const Float4 normalizedEV = min(max((ev100 - Float4(tm.evMinValue)) / Float4(evRange), Float4(0.0F)), Float4(1.0F));
+  const Float4 offset       = normalizedEV * Float4(float(EXPOSURE_HISTOGRAM_SIZE - 2)) + Float4(1.0F);
+  // Near-black pixels go to bucket 0
+  const Float4 bucket = select(luminance < Float4(0.00001f), Float4(0.0F), offset);
+
+  alignas(16) std::array<float, 4> buckets;
+  bucket.store(buckets.data());
+  if(tm.enableCenterMetering == 0)
+  {
+    for(uint32_t i = 0; i < count; i++)
+    {
+      histogram[uint32_t(buckets[i])] += 255;
+    }
+    return;
+  }
+  for(uint32_t i = 0; i < count; i++)
+  {
+    const float weight = shaderio::centerMeteringWeight(tm, glm::vec2(float(x + i), float(y)) / glm::vec2(params.width, params.height), params.aspect);
+    histogram[uint32_t(buckets[i])] += uint32_t(weight * 255.0f);
+  }
+}
+
+TonemapParameters makeParameters(const shaderio::TonemapperData& tonemapper, uint32_t width, uint32_t height, float exposureLuminance)
+{
+  TonemapParameters params;
+  params.tm = tonemapper;
+  // As Tonemapper::runCompute() and the Tonemap shader
+  params.tm.inputMatrix = shaderio::getColorCorrectionMatrix(tonemapper.exposure, tonemapper.temperature, tonemapper.tint);
+  params.input          = Matrix3::rowVector(params.tm.inputMatrix);
+  const float middleGrey    = 0.18f;
+  params.exposureMultiplier = middleGrey / std::max(0.001f, exposureLuminance);
+  params.rcpBrightness      = 1.0F / tonemapper.brightness;
+  params.width              = float(width);
+  params.height             = float(height);
+  params.aspect             = float(width) / float(height);
+  return params;
+}
+
+// Tonemaps into `outRgba` if it isn't null, and adds to `histogram` if it
+// isn't null, tile by tile.
+template <typename T>
+void processImage(const float*                    rgba,
+                  uint32_t                        width,
+                  uint32_t                        height,
+                  const shaderio::TonemapperData& tonemapper,
+                  float                           exposureLuminance,
+                  T*                              outRgba,
+                  ExposureHistogram*              histogram,
+                  uint32_t                        numThreads)
+{
+  if(width == 0 || height == 0)
+  {
+    return;
+  }
+  const TonemapParameters params = makeParameters(tonemapper, width, height, exposureLuminance);
+
+  // One histogram per thread of the pool, summed at the end
+  const uint32_t numHistograms =
+      (histogram == nullptr) ? 0 : ((numThreads == 1) ? 1 : std::max(1u, uint32_t(nvutils::get_thread_pool().get_thread_count())));
+  std::vector<ExposureHistogram> threadHistograms(numHistograms);
+
+  const uint32_t numTiles = (height + kTileRows - 1) / kTileRows;
+  nvutils::parallel_batches_pooled<1>(
+      numTiles,
+      [&](uint64_t tile, uint32_t threadIndex) {
+        ExposureHistogram* tileHistogram = (histogram != nullptr) ? &threadHistograms[threadIndex] : nullptr;
+        const Float4       lanes         = Float4::load(std::array<float, 4>{0.0F, 1.0F, 2.0F, 3.0F}.data());
+        const uint32_t     yEnd          = std::min(height, uint32_t(tile + 1) * kTileRows);
+        for(uint32_t y = uint32_t(tile) * kTileRows; y < yEnd; y++)
+        {
+          for(uint32_t x = 0; x < width; x += 4)
+          {
+            // Copies the last pixels of a row, so that all loads and stores
+            // are of 4 pixels. Full groups are copied too, as `outRgba` may
+            // be `rgba`.
+            const uint32_t count = std::min(4u, width - x);
+            const size_t   index = (size_t(y) * width + x) * 4;
+            alignas(16) std::array<float, 16> pixels;
+            if(count == 4)
+            {
+              memcpy(pixels.data(), rgba + index, sizeof(pixels));
+            }
+            else
+            {
+              pixels.fill(0.0F);
+              memcpy(pixels.data(), rgba + index, count * 4 * sizeof(float));
+            }
+
+            std::array<Float4, 4> channels;
+            loadPixels(pixels.data(), channels);
+            Color4 color{channels[0], channels[1], channels[2]};
+            if(tileHistogram != nullptr)
+            {
+              addToHistogram(params, color, x, y, count, *tileHistogram);
+            }
+            if(outRgba == nullptr)
+            {
+              continue;
+            }
+
+            if(params.tm.isActive == 1)
+            {
+              color = applyTonemap(params, color, Float4(float(x)) + lanes, float(y));
+              channels = {color.r, color.g, color.b, channels[3]};
+              storePixels(channels, pixels.data());
+            }
+            if constexpr(std::is_same_v<T, uint8_t>)
+            {
+              std::array<uint8_t, 16> unorm;
+              toUnorm8(pixels.data(), unorm.data());
+              memcpy(outRgba + index, unorm.data(), (count == 4) ? sizeof(unorm) : count * 4);
+            }
+            else
+            {
+              memcpy(outRgba + index, pixels.data(), (count == 4) ? sizeof(pixels) : count * 4 * sizeof(float));
+            }
+          }
+        }
+      },
+      numThreads);
+
+  for(const ExposureHistogram& threadHistogram : threadHistograms)
+  {
+    for(size_t i = 0; i < threadHistogram.size(); i++)
+    {
+      (*histogram)[i] += threadHistogram[i];
+    }
+  }
+}
+
+}  // namespace
+
+void tonemapImage(const float*                    rgba,
+                  uint32_t                        width,
+                  uint32_t                        height,
+                  const shaderio::TonemapperData& tonemapper,
+                  float                           exposureLuminance,
+                  float*                          outRgba,
+                  ExposureHistogram*              histogram,
+                  uint32_t                        numThreads)
+{
+  processImage(rgba, width, height, tonemapper, exposureLuminance, outRgba, histogram, numThreads);
+}
+
+void tonemapImage(const float*                    rgba,
+                  uint32_t                        width,
+                  uint32_t                        height,
+                  const shaderio::TonemapperData& tonemapper,
+                  float                           exposureLuminance,
+                  uint8_t*                        outRgba,
+                  ExposureHistogram*              histogram,
+                  uint32_t                        numThreads)
+{
+  processImage(rgba, width, height, tonemapper, exposureLuminance, outRgba, histogram, numThreads);
+}
+
+void computeExposureHistogram(const float*                    rgba,
+                              uint32_t                        width,
+                              uint32_t                        height,
+                              const shaderio::TonemapperData& tonemapper,
+                              ExposureHistogram&              histogram,
+                              uint32_t                        numThreads)
+{
+  processImage(rgba, width, height, tonemapper, 0.0F, static_cast<float*>(nullptr), &histogram, numThreads);
+}
+
+float computeExposureLuminance(const ExposureHistogram& histogram, const shaderio::TonemapperData& tonemapper)
+{
+  // As the AutoExposure shader, with its prefix sums in order
+  std::array<float, EXPOSURE_HISTOGRAM_SIZE> prefixSum;
+  float                                      totalWeight = 0.0F;
+  float                                      weightedSum = 0.0F;
+  for(uint32_t i = 0; i < EXPOSURE_HISTOGRAM_SIZE; i++)
+  {
+    const float countThisBucket = float(histogram[i]);
+    totalWeight += countThisBucket;
+    prefixSum[i] = totalWeight;
+    weightedSum += countThisBucket * float(i);
+  }
+
+  float weightedAverage;
+  if(tonemapper.averageMode == 1)  // median mode
+  {
+    // 50th percentile of non-black pixels
+    const float median = (totalWeight - float(histogram[0])) / 2.f;
+    weightedAverage    = 0.5f;
+    for(uint32_t i = 1; i < EXPOSURE_HISTOGRAM_SIZE; i++)
+    {
+      if(prefixSum[i] > median)
+      {
+        break;
+      }
+      weightedAverage = float(i) + 0.5f;
+    }
+  }
+  else  // mean mode
+  {
+    weightedAverage = weightedSum / totalWeight;
+  }
+
+  const float normalizedEV = shaderio::histogramOffsetToNormalizedEV(weightedAverage);
+  const float evRange      = tonemapper.evMaxValue - tonemapper.evMinValue;
+  return shaderio::ev100Luminance(normalizedEV * evRange + tonemapper.evMinValue);
+}
+
+float adaptExposureLuminance(float previousLuminance, float targetLuminance, float speed)
+{
+  return previousLuminance + (targetLuminance - previousLuminance) * (1.f - std::exp2(-speed));
+}
+
+}  // namespace nvshaders
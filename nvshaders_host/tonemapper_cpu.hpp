@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <nvshaders/tonemap_io.h.slang>
+
+namespace nvshaders {
+
+/*-------------------------------------------------------------------------------------------------
+# CPU tonemapping
+
+Runs the passes of tonemapper.slang on the CPU, so that HDR captures (for
+instance from headless runs) can be tonemapped without a device:
+- tonemapImage() applies shaderio::applyTonemap() to each pixel like the
+  Tonemap shader, and can add the pixels to an auto-exposure histogram like
+  the Histogram shader in the same pass
+- computeExposureHistogram() only builds the histogram
+- computeExposureLuminance() and adaptExposureLuminance() reduce it to the
+  luminance that auto-exposure maps to middle grey, like the AutoExposure
+  shader
+
+Images are RGBA32F, in rows from the top; alpha passes through. Each call
+works on tiles of rows in parallel on nvutils' thread pool (`numThreads` 1
+runs on the calling thread), and on 4 pixels at a time with SSE2 where
+available. The vector code evaluates pow(), log2() and exp2() with
+polynomials, so results differ from the scalar functions in
+tonemap_functions.h.slang by a few float ulps; tests/tonemapper_cpu_test.cpp
+checks this.
+
+As in nvshaders::Tonemapper, `tonemapper.inputMatrix` is computed from the
+exposure, temperature and tint, and auto-exposure uses the luminance from the
+previous frame: in a sequence, each frame's histogram adapts the luminance
+for the next one. For a single image, build its histogram first:
+
+```cpp
+nvshaders::ExposureHistogram histogram{};
+nvshaders::computeExposureHistogram(hdr, width, height, settings, histogram);
+const float luminance = nvshaders::computeExposureLuminance(histogram, settings);
+nvshaders::tonemapImage(hdr, width, height, settings, luminance, ldr.data());
+```
+-------------------------------------------------------------------------------------------------*/
+
+// Bins of the auto-exposure histogram; each pixel adds 255 times its center
+// metering weight to a bin.
+using ExposureHistogram = std::array<uint32_t, EXPOSURE_HISTOGRAM_SIZE>;
+
+// Tonemaps `rgba` into `outRgba`, which may be the same. `exposureLuminance`
+// is only used if tonemapper.autoExposure is set. If `histogram` isn't null,
+// adds the pixels of `rgba` to it.
+void tonemapImage(const float*                    rgba,
+                  uint32_t                        width,
+                  uint32_t                        height,
+                  const shaderio::TonemapperData& tonemapper,
+                  float                           exposureLuminance,
+                  float*                          outRgba,
+                  ExposureHistogram*              histogram  = nullptr,
+                  uint32_t                        numThreads = 0);
+// Same, writing RGBA8 UNORM texels, e.g. for stb_image_write.
+void tonemapImage(const float*                    rgba,
+                  uint32_t                        width,
+                  uint32_t                        height,
+                  const shaderio::TonemapperData& tonemapper,
+                  float                           exposureLuminance,
+                  uint8_t*                        outRgba,
+                  ExposureHistogram*              histogram  = nullptr,
+                  uint32_t                        numThreads = 0);
+
+// Adds the pixels of `rgba` to `histogram`.
+void computeExposureHistogram(const float*                    rgba,
+                              uint32_t                        width,
+                              uint32_t                        height,
+                              const shaderio::TonemapperData& tonemapper,
+                              ExposureHistogram&              histogram,
+                              uint32_t                        numThreads = 0);
+
+// The luminance that auto-exposure targets for `histogram`, using its mean
+// or median as tonemapper.averageMode says.
+float computeExposureLuminance(const ExposureHistogram& histogram, const shaderio::TonemapperData& tonemapper);
+
+// Moves `previousLuminance` towards `targetLuminance`; `speed` is
+// autoExposureSpeed times the seconds since the previous frame.
+float adaptExposureLuminance(float previousLuminance, float targetLuminance, float speed);
+
+}  // namespace nvshaders
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+#include "alignment.hpp"
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+# class nvutils::AtomicLinearAllocator
+
+>  Lets many threads reserve ranges of a fixed-size region without locks.
+
+Each reservation is a single atomic add, so threads never wait for each
+other; ranges are handed out in no particular order and can't be freed
+individually, only all at once with reset(). Sizes are rounded up to the
+alignment, so that every range starts at a multiple of it.
+
+nvvk::StagingUploader uses this to let worker threads reserve staging
+memory for beginParallelAppend(); it has no Vulkan dependency, so it can be
+used (and tested) on its own:
+
+```cpp
+nvutils::AtomicLinearAllocator allocator(capacity, 16);
+nvutils::parallel_batches<1>(count, [&](uint64_t i) {
+  const uint64_t offset = allocator.reserve(sizes[i]);
+  if(offset != nvutils::AtomicLinearAllocator::INVALID_OFFSET)
+  {
+    memcpy(memory + offset, data[i], sizes[i]);
+  }
+});
+```
+
+Once a reservation fails, all later ones fail too until reset().
+-------------------------------------------------------------------------------------------------*/
+
+class AtomicLinearAllocator
+{
+public:
+  static constexpr uint64_t INVALID_OFFSET = ~uint64_t(0);
+
+  AtomicLinearAllocator() = default;
+  AtomicLinearAllocator(uint64_t capacity, uint64_t alignment) { init(capacity, alignment); }
+
+  // `alignment` must be a power of two. Not thread-safe.
+  void init(uint64_t capacity, uint64_t alignment)
+  {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+    m_capacity  = capacity;
+    m_alignment = alignment;
+    m_next.store(0, std::memory_order_relaxed);
+  }
+
+  // Returns the offset of `size` bytes, or INVALID_OFFSET if they don't fit.
+  // Thread-safe.
+  uint64_t reserve(uint64_t size)
+  {
+    const uint64_t offset = m_next.fetch_add(align_up(size, m_alignment), std::memory_order_relaxed);
+    return (offset <= m_capacity && size <= m_capacity - offset) ? offset : INVALID_OFFSET;
+  }
+
+  // Makes the whole capacity available again. Not thread-safe.
+  void reset() { m_next.store(0, std::memory_order_relaxed); }
+
+  uint64_t getCapacity() const { return m_capacity; }
+  uint64_t getAlignment() const { return m_alignment; }
+  // Bytes reserved so far, including alignment padding.
+  uint64_t getReservedSize() const { return std::min(m_next.load(std::memory_order_relaxed), m_capacity); }
+
+private:
+  uint64_t              m_capacity  = 0;
+  uint64_t              m_alignment = 1;
+  std::atomic<uint64_t> m_next{0};
+};
+
+}  // namespace nvutils
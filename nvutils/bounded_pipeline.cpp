@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bounded_pipeline.hpp"
+#include "timers.hpp"
+
+namespace nvutils {
+
+BoundedPipelineStats parallel_produce_consume(uint64_t                                 numItems,
+                                              const std::function<uint64_t(uint64_t)>& produce,
+                                              const std::function<void(uint64_t)>&     consume,
+                                              const BoundedPipelineSettings&           settings)
+{
+  BoundedPipelineStats stats;
+
+  uint32_t numWorkers = settings.numWorkers;
+  if(numWorkers == 0)
+  {
+    numWorkers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  numWorkers = static_cast<uint32_t>(std::min<uint64_t>(numWorkers, numItems));
+
+  // Single-threaded fallback: at most one item is ever in flight.
+  if(numWorkers <= 1)
+  {
+    for(uint64_t i = 0; i < numItems; i++)
+    {
+      stats.peakBytes = std::max(stats.peakBytes, produce(i));
+      consume(i);
+    }
+    return stats;
+  }
+
+  std::mutex                                mutex;
+  std::condition_variable                   budgetAvailable;
+  std::condition_variable                   itemReady;
+  std::deque<std::pair<uint64_t, uint64_t>> readyItems;  // (itemIndex, bytes)
+  uint64_t                                  nextItem      = 0;
+  uint64_t                                  bytesInFlight = 0;
+  const uint64_t                            budget        = settings.memoryBudget;
+
+  auto worker = [&]() {
+    while(true)
+    {
+      uint64_t item = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        const PerformanceTimer       waitTimer;
+        budgetAvailable.wait(lock, [&] { return nextItem >= numItems || budget == 0 || bytesInFlight < budget; });
+        stats.producerWaitMs += waitTimer.getMilliseconds();
+        if(nextItem >= numItems)
+        {
+          return;
+        }
+        item = nextItem++;
+      }
+
+      const uint64_t bytes = produce(item);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyItems.emplace_back(item, bytes);
+        bytesInFlight += bytes;
+        stats.peakBytes = std::max(stats.peakBytes, bytesInFlight);
+      }
+      itemReady.notify_one();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(numWorkers);
+  for(uint32_t i = 0; i < numWorkers; i++)
+  {
+    workers.emplace_back(worker);
+  }
+
+  for(uint64_t consumed = 0; consumed < numItems; consumed++)
+  {
+    std::pair<uint64_t, uint64_t> ready;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      const PerformanceTimer       waitTimer;
+      itemReady.wait(lock, [&] { return !readyItems.empty(); });
+      stats.consumerWaitMs += waitTimer.getMilliseconds();
+      ready = readyItems.front();
+      readyItems.pop_front();
+    }
+
+    consume(ready.first);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      bytesInFlight -= ready.second;
+    }
+    budgetAvailable.notify_all();
+  }
+
+  for(std::thread& thread : workers)
+  {
+    thread.join();
+  }
+  return stats;
+}
+
+}  // namespace nvutils
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Runs a two-stage producer/consumer pipeline over `numItems` items, keeping
+the memory held by produced-but-not-yet-consumed items within a budget.
+
+```cpp
+produce:  fn (uint64_t itemIndex) -> uint64_t bytes
+          runs on worker threads; items are started in increasing order.
+          Returns how many bytes the produced item holds (e.g. a decoded image).
+
+consume:  fn (uint64_t itemIndex)
+          runs on the calling thread, once per item, in the order items
+          finished producing. The item's bytes are assumed freed on return.
+```
+
+This is the streaming replacement for "parallel_batches<1> over all items,
+then a serial loop over the results", where the intermediate results would
+otherwise all be resident at once. Because the consumer runs on the calling
+thread, it can record Vulkan commands.
+
+Workers don't start a new item while the produced bytes waiting for the
+consumer are at or above `memoryBudget`. Sizes are only known once an item
+is produced, so the budget is soft: the peak is at most
+`memoryBudget + numWorkers * (largest item)`. An item larger than the whole
+budget still goes through once the consumer has caught up.
+
+Workers are dedicated threads rather than get_thread_pool() threads, since
+they block on the budget, and so that `produce` can itself use
+parallel_batches_pooled.
+
+-------------------------------------------------------------------------------------------------*/
+
+struct BoundedPipelineSettings
+{
+  // Maximum bytes of produced items waiting to be consumed; 0 means unlimited.
+  uint64_t memoryBudget = 0;
+  // Number of producer threads; 0 means std::thread::hardware_concurrency().
+  // 1 runs produce and consume alternately on the calling thread.
+  uint32_t numWorkers = 0;
+};
+
+struct BoundedPipelineStats
+{
+  // Largest number of produced bytes that were waiting for the consumer at once.
+  uint64_t peakBytes = 0;
+  // Total time workers spent waiting for the budget.
+  double producerWaitMs = 0.0;
+  // Time the calling thread spent waiting for produced items.
+  double consumerWaitMs = 0.0;
+};
+
+BoundedPipelineStats parallel_produce_consume(uint64_t                                 numItems,
+                                              const std::function<uint64_t(uint64_t)>& produce,
+                                              const std::function<void(uint64_t)>&     consume,
+                                              const BoundedPipelineSettings&           settings = {});
+
+}  // namespace nvutils
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "build_batch_planner.hpp"
+
+namespace nvutils {
+
+BuildBatchPlan planBuildBatches(std::span<const BuildBatchItem> items, const BuildBatchSettings& settings)
+{
+  assert(settings.scratchAlignment > 0);
+
+  auto alignUp = [&](uint64_t offset) {
+    return (offset + settings.scratchAlignment - 1) / settings.scratchAlignment * settings.scratchAlignment;
+  };
+
+  // Passes first, as each is a submit: first fit decreasing by result size
+  std::vector<uint32_t> order(items.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b) { return items[a].resultSize > items[b].resultSize; });
+
+  std::vector<std::vector<uint32_t>> passItems;
+  std::vector<uint64_t>              passResultSizes;
+  for(uint32_t item : order)
+  {
+    const uint64_t resultSize = items[item].resultSize;
+
+    size_t p = 0;
+    for(; p < passItems.size(); p++)
+    {
+      if(resultSize <= settings.resultBudget - std::min(passResultSizes[p], settings.resultBudget))
+      {
+        break;
+      }
+    }
+    if(p == passItems.size())
+    {
+      passItems.emplace_back();
+      passResultSizes.push_back(0);
+    }
+    passItems[p].push_back(item);
+    passResultSizes[p] += resultSize;
+  }
+
+  // Then the batches of each pass: first fit decreasing by scratch size
+  struct Batch
+  {
+    std::vector<PlannedBuild> builds;
+    uint64_t                  scratchSize = 0;  // End of the last build's scratch range
+    uint64_t                  resultSize  = 0;
+  };
+
+  BuildBatchPlan plan;
+  plan.builds.reserve(items.size());
+  std::vector<Batch> batches;
+  for(size_t p = 0; p < passItems.size(); p++)
+  {
+    std::vector<uint32_t>& passOrder = passItems[p];
+    std::stable_sort(passOrder.begin(), passOrder.end(),
+                     [&](uint32_t a, uint32_t b) { return items[a].scratchSize > items[b].scratchSize; });
+
+    batches.clear();
+    // Batches before this one have no scratch space left for any build; as
+    // builds only get smaller, they never will.
+    size_t firstOpen = 0;
+    for(uint32_t item : passOrder)
+    {
+      const uint64_t scratchSize = items[item].scratchSize;
+
+      size_t b = firstOpen;
+      for(; b < batches.size(); b++)
+      {
+        const uint64_t offset = alignUp(batches[b].scratchSize);
+        if(offset <= settings.scratchCapacity && scratchSize <= settings.scratchCapacity - offset)
+        {
+          break;
+        }
+      }
+      if(b == batches.size())
+      {
+        batches.push_back({});
+      }
+      const uint64_t offset = alignUp(batches[b].scratchSize);
+      batches[b].builds.push_back({item, offset});
+      batches[b].scratchSize = offset + scratchSize;
+      batches[b].resultSize += items[item].resultSize;
+
+      while(firstOpen < batches.size() && alignUp(batches[firstOpen].scratchSize) >= settings.scratchCapacity)
+      {
+        firstOpen++;
+      }
+    }
+
+    BuildPass pass{.firstBatch = uint32_t(plan.batches.size()),
+                   .batchCount = uint32_t(batches.size()),
+                   .firstBuild = uint32_t(plan.builds.size()),
+                   .buildCount = uint32_t(passOrder.size()),
+                   .resultSize = passResultSizes[p]};
+    for(const Batch& batch : batches)
+    {
+      plan.batches.push_back({.firstBuild  = uint32_t(plan.builds.size()),
+                              .buildCount  = uint32_t(batch.builds.size()),
+                              .scratchSize = batch.scratchSize,
+                              .resultSize  = batch.resultSize});
+      plan.builds.insert(plan.builds.end(), batch.builds.begin(), batch.builds.end());
+      plan.maxScratchSize = std::max(plan.maxScratchSize, batch.scratchSize);
+    }
+    plan.passes.push_back(pass);
+  }
+  return plan;
+}
+
+}  // namespace nvutils
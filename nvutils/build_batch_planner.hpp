@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Plans how to group builds that each need temporary ("scratch") memory and
+produce a result of some size, such as acceleration structure builds, so that
+they need few batches.
+
+Builds in one batch run at once (e.g. one vkCmdBuildAccelerationStructuresKHR
+call), each in its own range of a scratch buffer of `scratchCapacity` bytes;
+batches are separated by barriers. Batches are grouped into passes whose
+results add up to at most `resultBudget` (e.g. one submit, after which the
+results are compacted).
+
+Building in input order closes a batch as soon as the next build doesn't fit,
+so a large build next to small ones leaves scratch space unused, and a pass
+can only end once it's over budget. planBuildBatches() first packs the builds
+into passes by result size, placing each in the first pass it fits in, largest
+first (first fit decreasing); it then packs the builds of each pass into
+batches the same way by scratch size.
+
+```cpp
+std::vector<nvutils::BuildBatchItem> items;  // {scratchSize, resultSize} per build
+nvutils::BuildBatchPlan plan = nvutils::planBuildBatches(items, {.scratchCapacity = scratchSize, .scratchAlignment = 128, .resultBudget = budget});
+for(const nvutils::BuildPass& pass : plan.passes)
+{
+  for(uint32_t b = pass.firstBatch; b < pass.firstBatch + pass.batchCount; b++)
+  {
+    const nvutils::BuildBatch& batch = plan.batches[b];
+    for(uint32_t i = batch.firstBuild; i < batch.firstBuild + batch.buildCount; i++)
+    {
+      // build items[plan.builds[i].item] with scratch at plan.builds[i].scratchOffset
+    }
+    // barrier
+  }
+  // submit, compact
+}
+```
+
+A build that is larger than `scratchCapacity` or `resultBudget` on its own
+gets a batch or pass of its own; `maxScratchSize` then exceeds the capacity.
+-------------------------------------------------------------------------------------------------*/
+
+struct BuildBatchItem
+{
+  uint64_t scratchSize = 0;
+  uint64_t resultSize  = 0;
+};
+
+struct BuildBatchSettings
+{
+  uint64_t scratchCapacity = 0;
+  // Scratch offsets are multiples of this; need not be a power of two
+  uint64_t scratchAlignment = 1;
+  uint64_t resultBudget     = ~uint64_t(0);
+};
+
+struct PlannedBuild
+{
+  uint32_t item          = 0;  // Index into the items passed to planBuildBatches()
+  uint64_t scratchOffset = 0;
+};
+
+struct BuildBatch
+{
+  uint32_t firstBuild  = 0;  // Range in BuildBatchPlan::builds
+  uint32_t buildCount  = 0;
+  uint64_t scratchSize = 0;  // End of the last build's scratch range
+  uint64_t resultSize  = 0;
+};
+
+struct BuildPass
+{
+  uint32_t firstBatch = 0;  // Range in BuildBatchPlan::batches
+  uint32_t batchCount = 0;
+  uint32_t firstBuild = 0;  // Range in BuildBatchPlan::builds
+  uint32_t buildCount = 0;
+  uint64_t resultSize = 0;
+};
+
+struct BuildBatchPlan
+{
+  // In the order to build them: by pass, then batch
+  std::vector<PlannedBuild> builds;
+  std::vector<BuildBatch>   batches;
+  std::vector<BuildPass>    passes;
+  // Largest scratch size of a batch; what the scratch buffer needs
+  uint64_t maxScratchSize = 0;
+};
+
+BuildBatchPlan planBuildBatches(std::span<const BuildBatchItem> items, const BuildBatchSettings& settings);
+
+}  // namespace nvutils
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "compaction_planner.hpp"
+
+namespace nvutils {
+
+namespace {
+
+struct SourceBlock
+{
+  uint32_t block     = 0;
+  uint32_t itemBegin = 0;  // Range in the sorted item order
+  uint32_t itemEnd   = 0;
+  uint64_t usedSize  = 0;
+};
+
+struct NewBlock
+{
+  uint64_t usedSize  = 0;
+  uint64_t itemCount = 0;
+};
+
+// First fit of the items of `sources` into new blocks; returns the number of
+// new blocks, which fills `moves` if it's not null.
+uint32_t packItems(std::span<const CompactionItem> items,
+                   std::span<const uint32_t>       order,
+                   std::span<const SourceBlock>    sources,
+                   const CompactionSettings&       settings,
+                   std::vector<CompactionMove>*    moves)
+{
+  std::vector<NewBlock> newBlocks;
+  // New blocks before this one are too full for any item; saves scanning
+  // them over and over when there are many.
+  size_t firstOpen = 0;
+  for(const SourceBlock& source : sources)
+  {
+    for(uint32_t i = source.itemBegin; i < source.itemEnd; i++)
+    {
+      const CompactionItem& item = items[order[i]];
+      size_t                b    = firstOpen;
+      for(; b < newBlocks.size(); b++)
+      {
+        if(newBlocks[b].itemCount < settings.maxItemsPerBlock && item.size <= settings.blockCapacity - newBlocks[b].usedSize)
+        {
+          break;
+        }
+      }
+      if(b == newBlocks.size())
+      {
+        newBlocks.push_back({});
+      }
+      if(moves)
+      {
+        moves->push_back({order[i], uint32_t(b), newBlocks[b].usedSize});
+      }
+      newBlocks[b].usedSize += item.size;
+      newBlocks[b].itemCount++;
+      while(firstOpen < newBlocks.size()
+            && (newBlocks[firstOpen].usedSize == settings.blockCapacity
+                || newBlocks[firstOpen].itemCount == settings.maxItemsPerBlock))
+      {
+        firstOpen++;
+      }
+    }
+  }
+  return uint32_t(newBlocks.size());
+}
+
+}  // namespace
+
+CompactionPlan planCompaction(std::span<const CompactionItem> items, const CompactionSettings& settings)
+{
+  assert(settings.blockCapacity > 0 && settings.maxItemsPerBlock > 0);
+
+  // Group the items by block, in the order of their offsets
+  std::vector<uint32_t> order(items.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return items[a].block != items[b].block ? items[a].block < items[b].block : items[a].offset < items[b].offset;
+  });
+
+  // Blocks that are empty enough to be compacted
+  const double             maxUsedSize = settings.maxOccupancy * double(settings.blockCapacity);
+  std::vector<SourceBlock> sources;
+  for(uint32_t i = 0; i < uint32_t(order.size());)
+  {
+    SourceBlock source{.block = items[order[i]].block, .itemBegin = i};
+    bool        fits = true;
+    for(; i < uint32_t(order.size()) && items[order[i]].block == source.block; i++)
+    {
+      assert(items[order[i]].size <= settings.blockCapacity);
+      fits = fits && items[order[i]].size <= settings.blockCapacity;
+      source.usedSize += items[order[i]].size;
+    }
+    source.itemEnd = i;
+    if(fits && double(source.usedSize) <= maxUsedSize)
+    {
+      sources.push_back(source);
+    }
+  }
+
+  // Compacting pays off if it needs fewer new blocks than it empties. If it
+  // doesn't, leave out the fullest source block and try again: it takes up
+  // the most space while freeing only one block.
+  std::sort(sources.begin(), sources.end(),
+            [](const SourceBlock& a, const SourceBlock& b) { return a.usedSize < b.usedSize; });
+  uint32_t newBlockCount = 0;
+  while(sources.size() > 1)
+  {
+    // Pack in block order, so that the moves follow the old layout
+    std::vector<SourceBlock> packOrder = sources;
+    std::sort(packOrder.begin(), packOrder.end(), [](const SourceBlock& a, const SourceBlock& b) { return a.block < b.block; });
+    newBlockCount = packItems(items, order, packOrder, settings, nullptr);
+    if(newBlockCount < sources.size())
+    {
+      sources = std::move(packOrder);
+      break;
+    }
+    sources.pop_back();
+  }
+
+  CompactionPlan plan;
+  if(sources.size() <= 1)
+  {
+    return plan;
+  }
+
+  plan.newBlockCount = packItems(items, order, sources, settings, &plan.moves);
+  assert(plan.newBlockCount == newBlockCount);
+  std::sort(plan.moves.begin(), plan.moves.end(), [](const CompactionMove& a, const CompactionMove& b) {
+    return a.dstBlock != b.dstBlock ? a.dstBlock < b.dstBlock : a.dstOffset < b.dstOffset;
+  });
+  for(const SourceBlock& source : sources)
+  {
+    plan.sourceBlocks.push_back(source.block);
+    plan.movedSize += source.usedSize;
+  }
+  return plan;
+}
+
+}  // namespace nvutils
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Plans how to compact the live allocations of fragmented memory blocks into
+fewer, new blocks.
+
+Allocators that sub-allocate fixed-size blocks (like nvvk::BufferSubAllocator)
+can end up with many blocks that are mostly free, but can't be released
+because a few allocations are left in each. planCompaction() picks the blocks
+whose occupancy is at most `maxOccupancy`, and packs their allocations into
+as few new blocks as it can (first fit, in the order of their old offsets,
+so that neighbors tend to stay neighbors and their copies can be merged).
+The blocks it picks can then be released once the allocations were copied.
+
+```cpp
+std::vector<nvutils::CompactionItem> items;  // {block, offset, size} of each live allocation
+nvutils::CompactionPlan plan = nvutils::planCompaction(items, {.blockCapacity = blockSize});
+for(const nvutils::CompactionMove& move : plan.moves)
+{
+  // copy items[move.item] to new block `move.dstBlock` (0 .. plan.newBlockCount - 1) at `move.dstOffset`
+}
+// then release plan.sourceBlocks
+```
+
+All items of a block must be passed for that block to be picked, as the
+planner derives its occupancy from them. The plan is empty if compacting
+wouldn't reduce the number of blocks. Sizes and offsets are in whatever unit
+the caller uses; items must not be larger than `blockCapacity`.
+-------------------------------------------------------------------------------------------------*/
+
+struct CompactionItem
+{
+  uint32_t block  = 0;  // Any identifier of the block the item is in
+  uint64_t offset = 0;  // Within the block; only used to keep the order
+  uint64_t size   = 0;
+};
+
+struct CompactionSettings
+{
+  uint64_t blockCapacity = 0;
+  // Limit on the number of items in a new block, e.g. for allocators with a
+  // fixed number of nodes per block
+  uint64_t maxItemsPerBlock = ~uint64_t(0);
+  // Blocks that are fuller than this fraction of `blockCapacity` are left in
+  // place.
+  double maxOccupancy = 0.5;
+};
+
+struct CompactionMove
+{
+  uint32_t item      = 0;  // Index into the items passed to planCompaction()
+  uint32_t dstBlock  = 0;  // Index of the new block
+  uint64_t dstOffset = 0;
+};
+
+struct CompactionPlan
+{
+  // Blocks whose items all move, in increasing order
+  std::vector<uint32_t> sourceBlocks;
+  uint32_t              newBlockCount = 0;
+  // Sorted by destination block, then offset
+  std::vector<CompactionMove> moves;
+  uint64_t                    movedSize = 0;
+
+  bool empty() const { return moves.empty(); }
+};
+
+CompactionPlan planCompaction(std::span<const CompactionItem> items, const CompactionSettings& settings);
+
+}  // namespace nvutils
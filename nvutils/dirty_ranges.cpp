@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dirty_ranges.hpp"
+
+namespace nvutils {
+
+std::vector<DirtyRange> coalesceDirtyRanges(const BitArray& dirty, uint64_t maxGap)
+{
+  std::vector<DirtyRange> ranges;
+  // traverseBits() visits the set bits in increasing order, skipping clean
+  // 64-bit words at once.
+  dirty.traverseBits([&](size_t index) {
+    if(!ranges.empty())
+    {
+      DirtyRange&    last = ranges.back();
+      const uint64_t end  = last.first + last.count;
+      if(index - end <= maxGap)
+      {
+        last.count = index + 1 - last.first;
+        return;
+      }
+    }
+    ranges.push_back({index, 1});
+  });
+  return ranges;
+}
+
+}  // namespace nvutils
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bit_array.hpp"
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Turns a set of changed ("dirty") array elements into a few ranges to copy.
+
+```cpp
+nvutils::BitArray dirty(elements.size());
+// ... dirty.enableBit(i) for each element that changed ...
+for(const nvutils::DirtyRange& range : nvutils::coalesceDirtyRanges(dirty, 4))
+{
+  staging.appendBuffer(buffer, range.first * sizeof(Element), range.count * sizeof(Element), &elements[range.first]);
+}
+```
+
+Consecutive dirty elements form one range. Ranges separated by at most
+`maxGap` clean elements are merged too, copying the clean elements in between
+again: past some point, one larger copy is cheaper than two copies (each of
+which has a fixed cost in command recording and staging allocation).
+`maxGap == 0` copies only dirty elements.
+
+Ranges are returned in increasing order and don't overlap.
+-------------------------------------------------------------------------------------------------*/
+
+struct DirtyRange
+{
+  uint64_t first = 0;  // Index of the first element
+  uint64_t count = 0;  // Number of elements
+
+  bool operator==(const DirtyRange& other) const { return first == other.first && count == other.count; }
+};
+
+std::vector<DirtyRange> coalesceDirtyRanges(const BitArray& dirty, uint64_t maxGap = 0);
+
+}  // namespace nvutils
@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include <glm/gtc/packing.hpp>  // unpackHalf1x16
+
+#include "parallel_work.hpp"
+#include "rgbe_decode.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RGBE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define RGBE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace nvutils {
+
+namespace {
+
+// Texels are converted in groups of 4; rows are padded to a multiple of it.
+constexpr uint32_t kGroup = 4;
+
+// Returns the line starting at `pos` without its newline, and moves `pos`
+// past it; returns false if there is no newline.
+bool readLine(std::span<const char> file, size_t& pos, std::string_view& line)
+{
+  const char* begin = file.data() + pos;
+  const char* end   = static_cast<const char*>(memchr(begin, '\n', file.size() - pos));
+  if(end == nullptr)
+  {
+    return false;
+  }
+  line = std::string_view(begin, end - begin);
+  pos += line.size() + 1;
+  return true;
+}
+
+// Scalar conversion of one texel; e == 0 is black
+inline void rgbeToFloat(uint8_t r, uint8_t g, uint8_t b, uint8_t e, float* rgba)
+{
+  float scale = 0.0f;
+  if(e >= 10)
+  {
+    const uint32_t bits = uint32_t(e - 9) << 23;  // 2^(e - 136)
+    memcpy(&scale, &bits, sizeof(scale));
+  }
+  else if(e != 0)
+  {
+    scale = std::ldexp(1.0f, int(e) - 136);  // Denormal
+  }
+  rgba[0] = float(r) * scale;
+  rgba[1] = float(g) * scale;
+  rgba[2] = float(b) * scale;
+  rgba[3] = 1.0f;
+}
+
+// Converts planar R, G, B, E bytes to float RGBA; `count` is a multiple of kGroup.
+void planesToFloat(const uint8_t* const planes[4], uint32_t count, float* rgba)
+{
+  uint32_t x = 0;
+#if RGBE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128  one  = _mm_set1_ps(1.0f);
+  auto          load = [&](const uint8_t* plane) {
+    int32_t bytes;
+    memcpy(&bytes, plane + x, sizeof(bytes));
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+  };
+  for(; x < count; x += kGroup)
+  {
+    const __m128i e = load(planes[3]);
+    // Exponents 1 to 9 give denormal scales; these are rare enough for the scalar path
+    if(_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi32(e, zero), _mm_cmplt_epi32(e, _mm_set1_epi32(10)))) != 0)
+    {
+      for(uint32_t i = x; i < x + kGroup; i++)
+      {
+        rgbeToFloat(planes[0][i], planes[1][i], planes[2][i], planes[3][i], rgba + i * 4);
+      }
+      continue;
+    }
+    const __m128i bits  = _mm_slli_epi32(_mm_sub_epi32(e, _mm_set1_epi32(9)), 23);
+    const __m128  scale = _mm_and_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(_mm_cmpgt_epi32(e, zero)));
+    __m128        r     = _mm_mul_ps(_mm_cvtepi32_ps(load(planes[0])), scale);
+    __m128        g     = _mm_mul_ps(_mm_cvtepi32_ps(load(planes[1])), scale);
+    __m128        b     = _mm_mul_ps(_mm_cvtepi32_ps(load(planes[2])), scale);
+    __m128        a     = one;
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    _mm_storeu_ps(rgba + x * 4 + 0, r);
+    _mm_storeu_ps(rgba + x * 4 + 4, g);
+    _mm_storeu_ps(rgba + x * 4 + 8, b);
+    _mm_storeu_ps(rgba + x * 4 + 12, a);
+  }
+#endif
+  for(; x < count; x++)
+  {
+    rgbeToFloat(planes[0][x], planes[1][x], planes[2][x], planes[3][x], rgba + x * 4);
+  }
+}
+
+// Decodes the run-length encoded channels of a scanline into 4 planes of `width` bytes.
+bool decodeRunLengths(const uint8_t* src, const uint8_t* srcEnd, uint32_t width, uint8_t* const planes[4])
+{
+  src += 4;  // 2, 2, width
+  for(uint32_t c = 0; c < 4; c++)
+  {
+    uint8_t* plane = planes[c];
+    uint32_t x     = 0;
+    while(x < width)
+    {
+      if(src >= srcEnd)
+      {
+        return false;
+      }
+      uint32_t count = *src++;
+      if(count > 128)
+      {
+        count -= 128;
+        if(src >= srcEnd || count > width - x)
+        {
+          return false;
+        }
+        memset(plane + x, *src++, count);
+      }
+      else
+      {
+        if(count == 0 || count > width - x || count > size_t(srcEnd - src))
+        {
+          return false;
+        }
+        memcpy(plane + x, src, count);
+        src += count;
+      }
+      x += count;
+    }
+  }
+  return true;
+}
+
+// Per-thread buffers for one scanline
+struct RowScratch
+{
+  std::vector<uint8_t>  planes;  // R, G, B, E; each `paddedWidth` bytes
+  std::vector<float>    rgba;
+  std::vector<uint16_t> halves;
+};
+
+// Scalar float_to_half_fast3_rtne, for the values that don't fill a group.
+// glm::packHalf1x16() rounds halfway cases up instead of to even.
+uint16_t floatToHalfScalar(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  uint16_t half;
+  if(bits >= (127u + 16u) << 23)  // Overflows, infinity or NaN
+  {
+    half = bits > 255u << 23 ? 0x7e00 : 0x7c00;
+  }
+  else if(bits < (127u - 14u) << 23)  // Subnormal half or zero
+  {
+    const uint32_t magicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+    float          magic;
+    memcpy(&magic, &magicBits, sizeof(magic));
+    float absolute;
+    memcpy(&absolute, &bits, sizeof(absolute));
+    absolute += magic;
+    memcpy(&bits, &absolute, sizeof(bits));
+    half = uint16_t(bits - magicBits);
+  }
+  else
+  {
+    const uint32_t mantissaOdd = (bits >> 13) & 1;
+    bits += (uint32_t(15 - 127) << 23) + 0xfff + mantissaOdd;
+    half = uint16_t(bits >> 13);
+  }
+  return uint16_t(half | (sign >> 16));
+}
+
+}  // namespace
+
+void floatToHalf(const float* src, size_t count, uint16_t* dst)
+{
+  size_t i = 0;
+#if RGBE_SSE2
+  // After "float_to_half_fast3_rtne" by Fabian Giesen, which is in the public domain
+  const __m128i signMask     = _mm_set1_epi32(int32_t(0x80000000u));
+  const __m128i f32Infinity  = _mm_set1_epi32(255 << 23);
+  const __m128i f16Max       = _mm_set1_epi32((127 + 16) << 23);
+  const __m128i minNormal    = _mm_set1_epi32((127 - 14) << 23);
+  const __m128i subnormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+  const __m128i normalBias   = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+  for(; i + 4 <= count; i += 4)
+  {
+    const __m128i f        = _mm_castps_si128(_mm_loadu_ps(src + i));
+    const __m128i sign     = _mm_and_si128(f, signMask);
+    const __m128i absolute = _mm_xor_si128(f, sign);
+
+    const __m128i isNan     = _mm_cmpgt_epi32(absolute, f32Infinity);
+    const __m128i isRegular = _mm_cmpgt_epi32(f16Max, absolute);
+    const __m128i infOrNan  = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+    const __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absolute);
+    const __m128i subnormal   = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absolute), _mm_castsi128_ps(subnormMagic))), subnormMagic);
+
+    const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absolute, 31 - 13), 31);
+    const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absolute, normalBias), mantissaOdd), 13);
+
+    const __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+    __m128i half = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infOrNan));
+    half         = _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+    // Sign-extend, so that the saturating pack keeps the 16 bits as they are
+    half = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(half, 16), 16), _mm_setzero_si128());
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), half);
+  }
+#elif RGBE_NEON
+  for(; i + 4 <= count; i += 4)
+  {
+    vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+  }
+#endif
+  for(; i < count; i++)
+  {
+    dst[i] = floatToHalfScalar(src[i]);
+  }
+}
+
+void halfToFloat(const uint16_t* src, size_t count, float* dst)
+{
+  size_t i = 0;
+#if RGBE_SSE2
+  // After "half_to_float_fast5" by Fabian Giesen, which is in the public domain
+  const __m128i noSign         = _mm_set1_epi32(0x7fff);
+  const __m128  magic          = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+  const __m128i wasInfOrNan    = _mm_set1_epi32(0x7bff);
+  const __m128i infOrNanExpont = _mm_set1_epi32(255 << 23);
+  for(; i + 4 <= count; i += 4)
+  {
+    const __m128i h        = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), _mm_setzero_si128());
+    const __m128i absolute = _mm_and_si128(h, noSign);
+    const __m128i sign     = _mm_slli_epi32(_mm_xor_si128(h, absolute), 16);
+    const __m128  scaled   = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(absolute, 13)), magic);
+    const __m128i infOrNan = _mm_and_si128(_mm_cmpgt_epi32(absolute, wasInfOrNan), infOrNanExpont);
+    _mm_storeu_ps(dst + i, _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infOrNan))));
+  }
+#elif RGBE_NEON
+  for(; i + 4 <= count; i += 4)
+  {
+    vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+  }
+#endif
+  for(; i < count; i++)
+  {
+    dst[i] = glm::unpackHalf1x16(src[i]);
+  }
+}
+
+bool isRgbe(std::span<const char> file)
+{
+  const std::string_view start(file.data(), std::min<size_t>(file.size(), 11));
+  return start.starts_with("#?RADIANCE\n") || start.starts_with("#?RGBE\n");
+}
+
+RgbeError parseRgbe(std::span<const char> file, RgbeImage& image)
+{
+  image = {};
+  if(!isRgbe(file))
+  {
+    return "The file does not start with a Radiance header.";
+  }
+
+  size_t           pos = 0;
+  std::string_view line;
+  bool             formatFound = false;
+  while(true)
+  {
+    if(!readLine(file, pos, line))
+    {
+      return "The header was not terminated.";
+    }
+    if(line.empty())
+    {
+      break;
+    }
+    formatFound = formatFound || line == "FORMAT=32-bit_rle_rgbe";
+  }
+  if(!formatFound)
+  {
+    return "The file has no FORMAT=32-bit_rle_rgbe line; other formats are not supported.";
+  }
+
+  // "-Y height +X width"
+  if(!readLine(file, pos, line))
+  {
+    return "The resolution line is missing.";
+  }
+  const std::string resolution(line);
+  unsigned long     height = 0, width = 0;
+  int               consumed = 0;
+  if(sscanf(resolution.c_str(), "-Y %lu +X %lu%n", &height, &width, &consumed) != 2 || size_t(consumed) != resolution.size())
+  {
+    return "Unsupported resolution line \"" + resolution + "\"; only \"-Y height +X width\" is supported.";
+  }
+  if(width == 0 || height == 0 || width > (1u << 24) || height > (1u << 24))
+  {
+    return "Unsupported size " + std::to_string(width) + " x " + std::to_string(height) + ".";
+  }
+  image.width  = uint32_t(width);
+  image.height = uint32_t(height);
+  image.scanlineOffsets.resize(size_t(height) + 1);
+
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+  image.runLengthEncoded =
+      width >= 8 && width < 32768 && pos + 4 <= file.size() && data[pos] == 2 && data[pos + 1] == 2 && (data[pos + 2] & 0x80) == 0;
+  if(!image.runLengthEncoded)
+  {
+    const uint64_t rowBytes = uint64_t(width) * 4;
+    if(file.size() - pos < rowBytes * height)
+    {
+      return "The file is too small for its " + std::to_string(width) + " x " + std::to_string(height) + " texels.";
+    }
+    for(uint64_t y = 0; y <= height; y++)
+    {
+      image.scanlineOffsets[y] = pos + y * rowBytes;
+    }
+    return {};
+  }
+
+  // Find where each scanline starts by skipping over its runs
+  for(uint32_t y = 0; y < height; y++)
+  {
+    image.scanlineOffsets[y] = pos;
+    if(file.size() - pos < 4 || data[pos] != 2 || data[pos + 1] != 2 || (uint32_t(data[pos + 2]) << 8 | data[pos + 3]) != width)
+    {
+      return "Scanline " + std::to_string(y) + " is not run-length encoded, or has the wrong length.";
+    }
+    pos += 4;
+    for(uint32_t c = 0; c < 4; c++)
+    {
+      for(uint32_t x = 0; x < width;)
+      {
+        if(pos >= file.size())
+        {
+          return "The file ends in scanline " + std::to_string(y) + ".";
+        }
+        const uint32_t count = data[pos];
+        const uint32_t texels = count > 128 ? count - 128 : count;
+        if(texels == 0 || texels > width - x)
+        {
+          return "Scanline " + std::to_string(y) + " has an invalid run.";
+        }
+        pos += count > 128 ? 2 : 1 + count;
+        x += texels;
+      }
+    }
+    if(pos > file.size())
+    {
+      return "The file ends in scanline " + std::to_string(y) + ".";
+    }
+  }
+  image.scanlineOffsets[height] = pos;
+  return {};
+}
+
+size_t rgbeDecodedSizeBytes(RgbeTarget target, uint32_t width, uint32_t height)
+{
+  return size_t(width) * height * (target == RgbeTarget::eRGBA16F ? 8 : 16);
+}
+
+RgbeError decodeRgbe(std::span<const char>                               file,
+                     const RgbeImage&                                    image,
+                     RgbeTarget                                          target,
+                     std::span<char>                                     dst,
+                     const std::function<void(uint32_t y, float* rgba)>& rowFn,
+                     uint32_t                                            numThreads)
+{
+  if(image.scanlineOffsets.size() != size_t(image.height) + 1 || image.scanlineOffsets.back() > file.size())
+  {
+    return "The image was not parsed from this file.";
+  }
+  if(dst.size() < rgbeDecodedSizeBytes(target, image.width, image.height))
+  {
+    return "The destination was too small: it had " + std::to_string(dst.size()) + " bytes, but "
+           + std::to_string(rgbeDecodedSizeBytes(target, image.width, image.height)) + " were needed.";
+  }
+
+  const uint32_t width       = image.width;
+  const uint32_t paddedWidth = (width + kGroup - 1) / kGroup * kGroup;
+  const bool     half        = target == RgbeTarget::eRGBA16F;
+  const size_t   rowBytes    = rgbeDecodedSizeBytes(target, width, 1);
+
+  const uint32_t          threadCount = numThreads == 1 ? 1 : get_thread_pool().get_thread_count();
+  std::vector<RowScratch> scratch(threadCount);
+  std::atomic<uint32_t>   failedRow{~0u};
+
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+  parallel_batches_pooled<1>(
+      image.height,
+      [&](uint64_t y, uint32_t threadIndex) {
+        RowScratch& row = scratch[threadIndex];
+        if(row.rgba.empty())
+        {
+          // Padding texels decode as black and aren't written
+          row.planes.resize(size_t(paddedWidth) * 4, 0);
+          row.rgba.resize(size_t(paddedWidth) * 4);
+          row.halves.resize(half ? size_t(paddedWidth) * 4 : 0);
+        }
+        uint8_t* const planes[4] = {row.planes.data(), row.planes.data() + paddedWidth,
+                                    row.planes.data() + 2 * paddedWidth, row.planes.data() + 3 * paddedWidth};
+
+        const uint8_t* src    = data + image.scanlineOffsets[y];
+        const uint8_t* srcEnd = data + image.scanlineOffsets[y + 1];
+        if(image.runLengthEncoded)
+        {
+          if(!decodeRunLengths(src, srcEnd, width, planes))
+          {
+            failedRow = uint32_t(y);
+            return;
+          }
+        }
+        else
+        {
+          for(uint32_t x = 0; x < width; x++)
+          {
+            for(uint32_t c = 0; c < 4; c++)
+            {
+              planes[c][x] = src[x * 4 + c];
+            }
+          }
+        }
+
+        float*         rgba       = row.rgba.data();
+        char*          rowDst     = dst.data() + y * rowBytes;
+        const uint32_t floatCount = paddedWidth * 4;
+        planesToFloat(planes, paddedWidth, rgba);
+        if(half)
+        {
+          uint16_t* halves = row.halves.data();
+          floatToHalf(rgba, floatCount, halves);
+          if(rowFn)
+          {
+            halfToFloat(halves, floatCount, rgba);
+            rowFn(uint32_t(y), rgba);
+            floatToHalf(rgba, floatCount, halves);
+          }
+          memcpy(rowDst, halves, rowBytes);
+        }
+        else
+        {
+          if(rowFn)
+          {
+            rowFn(uint32_t(y), rgba);
+          }
+          memcpy(rowDst, rgba, rowBytes);
+        }
+      },
+      numThreads);
+
+  if(failedRow != ~0u)
+  {
+    return "Scanline " + std::to_string(failedRow.load()) + " has invalid run lengths.";
+  }
+  return {};
+}
+
+}  // namespace nvutils
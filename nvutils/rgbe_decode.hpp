@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Decodes Radiance RGBE (.hdr) images, the format most HDR environments come in,
+to RGBA16F or RGBA32F texels, without reading the file into memory first:
+`file` can be a nvutils::FileReadMapping.
+
+parseRgbe() reads the header and finds where each scanline starts, which only
+reads the run-length headers; decodeRgbe() then decodes the scanlines in
+parallel on nvutils' thread pool. `rowFn`, if set, is called with each
+scanline as float RGBA (with alpha 1), already rounded to the precision of
+`target`, before it is written to `dst`; changes it makes are written too.
+This lets callers process the texels while they're in cache, e.g. to build
+an importance map.
+
+```cpp
+nvutils::FileReadMapping mapping;
+mapping.open(path);
+std::span<const char> file(static_cast<const char*>(mapping.data()), mapping.size());
+nvutils::RgbeImage image;
+if(nvutils::RgbeError error = nvutils::parseRgbe(file, image))
+{
+  LOGW("%s\n", error->c_str());
+}
+std::vector<char> texels(nvutils::rgbeDecodedSizeBytes(nvutils::RgbeTarget::eRGBA16F, image.width, image.height));
+nvutils::decodeRgbe(file, image, nvutils::RgbeTarget::eRGBA16F, texels);
+```
+
+Like stb_image, this supports the "-Y height +X width" orientation, and
+scanlines that are either uncompressed or use the run-length encoding of
+newer Radiance versions (not the older one). Values are decoded as stb_image
+does: mantissa * 2^(exponent - 136).
+-------------------------------------------------------------------------------------------------*/
+
+// Returns an empty std::optional if it succeeded, and a value with text
+// describing the error if it failed.
+using RgbeError = std::optional<std::string>;
+
+enum class RgbeTarget
+{
+  eRGBA16F,  // 4 IEEE 754 half-precision floats per texel
+  eRGBA32F,  // 4 floats per texel
+};
+
+struct RgbeImage
+{
+  uint32_t width  = 0;
+  uint32_t height = 0;
+  // Offset of each scanline in the file, then the end of the last one
+  std::vector<uint64_t> scanlineOffsets;
+  // Whether scanlines are run-length encoded; if not, they are 4 * width bytes
+  bool runLengthEncoded = false;
+};
+
+// Returns whether `file` starts with a Radiance header
+bool isRgbe(std::span<const char> file);
+
+RgbeError parseRgbe(std::span<const char> file, RgbeImage& image);
+
+size_t rgbeDecodedSizeBytes(RgbeTarget target, uint32_t width, uint32_t height);
+
+// Decodes the scanlines of `image`, which parseRgbe() filled from `file`, into
+// `dst`, which must have at least rgbeDecodedSizeBytes() bytes. Uses up to
+// `numThreads` threads of nvutils' thread pool (0 means all of them); if this
+// is 1, decodes on the calling thread. `rowFn` may be called from several
+// threads at once, for different rows.
+RgbeError decodeRgbe(std::span<const char>                               file,
+                     const RgbeImage&                                    image,
+                     RgbeTarget                                          target,
+                     std::span<char>                                     dst,
+                     const std::function<void(uint32_t y, float* rgba)>& rowFn      = {},
+                     uint32_t                                            numThreads = 0);
+
+// Convert between floats and IEEE 754 halves, with SSE2 or NEON where
+// available; floatToHalf() rounds to nearest even.
+void floatToHalf(const float* src, size_t count, uint16_t* dst);
+void halfToFloat(const uint16_t* src, size_t count, float* dst);
+
+}  // namespace nvutils
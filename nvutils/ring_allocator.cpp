@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cassert>
+
+#include "ring_allocator.hpp"
+
+namespace nvutils {
+
+void RingAllocator::init(uint64_t capacity)
+{
+  assert(m_fences.empty() && "Missing deinit()");
+  m_capacity = capacity;
+  m_head     = 0;
+}
+
+void RingAllocator::deinit()
+{
+  releaseAll();
+  m_capacity = 0;
+}
+
+uint64_t RingAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t fence)
+{
+  assert(alignment != 0);
+  assert(m_fences.empty() || fence >= m_fences.back().fence);
+  if(size == 0 || size > m_capacity)
+  {
+    return INVALID_OFFSET;
+  }
+
+  uint64_t offset = 0;
+  if(!m_fences.empty())
+  {
+    // The used space goes from the oldest allocation (`tail`) to m_head,
+    // possibly wrapping around the end of the ring.
+    const uint64_t tail    = m_fences.front().begin;
+    const uint64_t aligned = (m_head + alignment - 1) / alignment * alignment;
+    if(tail < m_head)
+    {
+      if(aligned + size <= m_capacity)
+      {
+        offset = aligned;
+      }
+      else if(size <= tail)
+      {
+        offset = 0;  // Wrap around; the space after m_head is skipped
+      }
+      else
+      {
+        return INVALID_OFFSET;
+      }
+    }
+    else if(aligned + size <= tail)
+    {
+      offset = aligned;
+    }
+    else
+    {
+      return INVALID_OFFSET;
+    }
+  }
+
+  m_head = offset + size;
+  m_allocatedSize += size;
+  if(!m_fences.empty() && m_fences.back().fence == fence)
+  {
+    m_fences.back().allocatedSize += size;
+  }
+  else
+  {
+    m_fences.push_back({fence, offset, size});
+  }
+  return offset;
+}
+
+void RingAllocator::release(uint64_t fence)
+{
+  while(!m_fences.empty() && m_fences.front().fence <= fence)
+  {
+    m_allocatedSize -= m_fences.front().allocatedSize;
+    m_fences.pop_front();
+  }
+  if(m_fences.empty())
+  {
+    // Start over at the beginning, so that the next allocations don't wrap
+    m_head = 0;
+  }
+}
+
+void RingAllocator::releaseAll()
+{
+  m_fences.clear();
+  m_allocatedSize = 0;
+  m_head          = 0;
+}
+
+uint64_t RingAllocator::getUsedSize() const
+{
+  if(m_fences.empty())
+  {
+    return 0;
+  }
+  const uint64_t tail = m_fences.front().begin;
+  return tail < m_head ? m_head - tail : m_capacity - tail + m_head;
+}
+
+}  // namespace nvutils
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+# class nvutils::RingAllocator
+
+>  Bookkeeping for sub-allocating a fixed-size buffer as a ring.
+
+Allocations are placed one after the other; when one doesn't fit before the
+end of the ring, it wraps around to offset 0, and the space left at the end
+is wasted until the allocations before it are released. Each allocation is
+tagged with a fence: an increasing number that identifies when the memory is
+no longer in use (typically a frame or a GPU submission). Space is released
+in allocation order, by fence.
+
+This class only does arithmetic; nvvk::RingStagingUploader uses it to
+sub-allocate a persistently mapped staging buffer, but it can be used (and
+tested) without a device:
+
+```cpp
+nvutils::RingAllocator ring(64 << 20);
+uint64_t               frame = 1;
+// per frame:
+ring.release(lastCompletedFrame);
+uint64_t offset = ring.allocate(size, 16, frame);
+if(offset == nvutils::RingAllocator::INVALID_OFFSET)
+{
+  // The ring is full (or `size` exceeds its capacity)
+}
+frame++;
+```
+
+-------------------------------------------------------------------------------------------------*/
+
+class RingAllocator
+{
+public:
+  static constexpr uint64_t INVALID_OFFSET = ~uint64_t(0);
+
+  RingAllocator() = default;
+  explicit RingAllocator(uint64_t capacity) { init(capacity); }
+
+  void init(uint64_t capacity);
+  void deinit();
+
+  // Returns the offset of `size` bytes of free space, a multiple of
+  // `alignment` (which doesn't need to be a power of two), or
+  // INVALID_OFFSET if there's not enough space or `size` is 0.
+  // `fence` must be greater than or equal to the fence of the previous
+  // allocation.
+  uint64_t allocate(uint64_t size, uint64_t alignment, uint64_t fence);
+
+  // Releases all allocations whose fence is <= `fence`.
+  void release(uint64_t fence);
+  // Releases all allocations.
+  void releaseAll();
+
+  uint64_t getCapacity() const { return m_capacity; }
+  bool     isEmpty() const { return m_fences.empty(); }
+
+  // Bytes requested by the allocations that weren't released yet.
+  uint64_t getAllocatedSize() const { return m_allocatedSize; }
+  // Bytes that are unavailable until allocations are released: the allocated
+  // bytes, plus alignment padding and the space skipped when wrapping.
+  uint64_t getUsedSize() const;
+
+private:
+  // Consecutive allocations with the same fence are tracked together.
+  struct Fence
+  {
+    uint64_t fence         = 0;
+    uint64_t begin         = 0;  // Offset of the first allocation
+    uint64_t allocatedSize = 0;
+  };
+
+  uint64_t          m_capacity      = 0;
+  uint64_t          m_head          = 0;  // End of the newest allocation
+  uint64_t          m_allocatedSize = 0;
+  std::deque<Fence> m_fences;             // Oldest first
+};
+
+}  // namespace nvutils
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sha256.hpp"
+
+#include <algorithm>
+
+namespace nvutils {
+
+namespace {
+
+constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t rotateRight(uint32_t x, uint32_t n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+}  // namespace
+
+void Sha256::processBlock(const uint8_t* block)
+{
+  uint32_t w[64];
+  for(int i = 0; i < 16; i++)
+  {
+    w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) | (uint32_t(block[4 * i + 2]) << 8)
+           | uint32_t(block[4 * i + 3]);
+  }
+  for(int i = 16; i < 64; i++)
+  {
+    const uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i]              = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+  uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+  for(int i = 0; i < 64; i++)
+  {
+    const uint32_t s1    = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+    const uint32_t ch    = (e & f) ^ (~e & g);
+    const uint32_t temp1 = h + s1 + ch + kRoundConstants[i] + w[i];
+    const uint32_t s0    = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+    const uint32_t maj   = (a & b) ^ (a & c) ^ (b & c);
+    const uint32_t temp2 = s0 + maj;
+    h                    = g;
+    g                    = f;
+    f                    = e;
+    e                    = d + temp1;
+    d                    = c;
+    c                    = b;
+    b                    = a;
+    a                    = temp1 + temp2;
+  }
+  m_state[0] += a;
+  m_state[1] += b;
+  m_state[2] += c;
+  m_state[3] += d;
+  m_state[4] += e;
+  m_state[5] += f;
+  m_state[6] += g;
+  m_state[7] += h;
+}
+
+void Sha256::update(std::span<const std::byte> data)
+{
+  const uint8_t* bytes     = reinterpret_cast<const uint8_t*>(data.data());
+  size_t         remaining = data.size();
+  m_totalBytes += remaining;
+
+  // Fill up a partial block first.
+  if(m_bufferSize > 0)
+  {
+    const size_t count = std::min(remaining, m_buffer.size() - m_bufferSize);
+    memcpy(m_buffer.data() + m_bufferSize, bytes, count);
+    m_bufferSize += count;
+    bytes += count;
+    remaining -= count;
+    if(m_bufferSize < m_buffer.size())
+    {
+      return;
+    }
+    processBlock(m_buffer.data());
+    m_bufferSize = 0;
+  }
+  // Then process whole blocks without copying them.
+  while(remaining >= 64)
+  {
+    processBlock(bytes);
+    bytes += 64;
+    remaining -= 64;
+  }
+  memcpy(m_buffer.data(), bytes, remaining);
+  m_bufferSize = remaining;
+}
+
+Sha256Digest Sha256::finish()
+{
+  // Append a 1 bit, zeros up to 56 bytes mod 64, and the length in bits.
+  const uint64_t totalBits = m_totalBytes * 8;
+  m_buffer[m_bufferSize++] = 0x80;
+  if(m_bufferSize > 56)
+  {
+    memset(m_buffer.data() + m_bufferSize, 0, m_buffer.size() - m_bufferSize);
+    processBlock(m_buffer.data());
+    m_bufferSize = 0;
+  }
+  memset(m_buffer.data() + m_bufferSize, 0, 56 - m_bufferSize);
+  for(int i = 0; i < 8; i++)
+  {
+    m_buffer[56 + i] = uint8_t(totalBits >> (56 - 8 * i));
+  }
+  processBlock(m_buffer.data());
+
+  Sha256Digest digest;
+  for(int i = 0; i < 8; i++)
+  {
+    digest[4 * i]     = uint8_t(m_state[i] >> 24);
+    digest[4 * i + 1] = uint8_t(m_state[i] >> 16);
+    digest[4 * i + 2] = uint8_t(m_state[i] >> 8);
+    digest[4 * i + 3] = uint8_t(m_state[i]);
+  }
+  return digest;
+}
+
+}  // namespace nvutils
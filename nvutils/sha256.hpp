@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace nvutils {
+/*-------------------------------------------------------------------------------------------------
+Computes SHA-256 digests (FIPS 180-4), for identifying data by its contents
+where a collision must not silently return the wrong data, such as caches
+keyed by file contents. std::hash and hashCombine() are fine for hash tables
+that compare keys, but their 64 bits are too few to stand in for the data.
+
+```cpp
+nvutils::Sha256 sha;
+sha.update(std::as_bytes(std::span(texels)));
+sha.updateValue(width);
+const nvutils::Sha256Digest digest = sha.finish();
+// or, for a single span:
+const nvutils::Sha256Digest digest = nvutils::sha256(std::as_bytes(std::span(texels)));
+```
+
+This is a portable scalar implementation; it hashes a few hundred MB/s per
+thread.
+-------------------------------------------------------------------------------------------------*/
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+class Sha256
+{
+public:
+  void update(std::span<const std::byte> data);
+  // Hashes the bytes of a trivially copyable value, such as an image size.
+  template <typename T>
+  void updateValue(const T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    update(std::as_bytes(std::span<const T, 1>(&value, 1)));
+  }
+  // Returns the digest of everything passed to update(). The object must not
+  // be updated afterwards.
+  Sha256Digest finish();
+
+private:
+  void processBlock(const uint8_t* block);
+
+  uint32_t                m_state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  std::array<uint8_t, 64> m_buffer{};
+  size_t                  m_bufferSize = 0;
+  uint64_t                m_totalBytes = 0;
+};
+
+inline Sha256Digest sha256(std::span<const std::byte> data)
+{
+  Sha256 sha;
+  sha.update(data);
+  return sha.finish();
+}
+
+// For hash tables keyed by a digest: its first 8 bytes are already uniformly
+// distributed.
+struct Sha256DigestHash
+{
+  size_t operator()(const Sha256Digest& digest) const
+  {
+    uint64_t value;
+    memcpy(&value, digest.data(), sizeof(value));
+    return size_t(value);
+  }
+};
+
+}  // namespace nvutils
@@ -167,7 +167,7 @@ void AccelerationStructureBuilder::init(ResourceAllocator* allocator)
   m_alloc           = allocator;
   m_device          = allocator->getDevice();
   m_currentBlasIdx  = 0;
-  m_currentQueryIdx = 0;
+  m_currentPassIdx  = 0;
 
   VkPhysicalDeviceProperties2                        props = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
   VkPhysicalDeviceAccelerationStructurePropertiesKHR rayProps = {
@@ -197,22 +197,42 @@ VkResult AccelerationStructureBuilder::cmdCreateBlas(VkCommandBuffer
                                                      VkDeviceSize    scratchSize,     //  Size of the scratch buffer
                                                      VkDeviceSize    hintMaxBudget)
 {
+  // Plan all builds on the first call
+  if(m_currentBlasIdx == 0)
+  {
+    std::vector<nvutils::BuildBatchItem> items(blasBuildData.size());
+    for(size_t i = 0; i < blasBuildData.size(); i++)
+    {
+      items[i] = {blasBuildData[i].sizeInfo.buildScratchSize, blasBuildData[i].sizeInfo.accelerationStructureSize};
+    }
+    m_plan = nvutils::planBuildBatches(
+        items, {.scratchCapacity = scratchSize, .scratchAlignment = m_scratchAlignment, .resultBudget = hintMaxBudget});
+    m_currentPassIdx = 0;
+  }
+  assert(m_plan.builds.size() == blasBuildData.size() && "blasBuildData changed between calls");
+
+  if(m_plan.maxScratchSize > scratchSize)
+  {
+    // A BLAS needs more scratch space than given; see getScratchSize()
+    assert(0 && "scratch buffer too small");
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+  }
+
   // Create a new query pool for this batch
   NVVK_FAIL_RETURN(initializeQueryPoolIfNeeded(cmd, blasBuildData));
 
   // Track the starting BLAS index for this batch
-  uint32_t batchStartIdx   = m_currentBlasIdx;
-  uint32_t currentQueryIdx = batchStartIdx;  // Local query index for this batch
+  uint32_t batchStartIdx = m_currentBlasIdx;
 
-  VkDeviceSize scratchAddressEnd = scratchAddress + scratchSize;  // The end address of the scratch buffer.
-  VkDeviceSize budgetUsed        = 0;  // Initialize the total budget used in this function call
-
-  // Process each BLAS in the data vector while staying under the memory budget.
-  while(m_currentBlasIdx < blasBuildData.size() && budgetUsed < hintMaxBudget)
+  // Build the next pass of the plan, one vkCmdBuildAccelerationStructuresKHR per batch
+  if(m_currentPassIdx < m_plan.passes.size())
   {
-    // Build acceleration structures and accumulate the total memory used.
-    NVVK_FAIL_RETURN(cmdBuildAccelerationStructures(cmd, budgetUsed, blasBuildData, blasAccel, scratchAddress,
-                                                    scratchAddressEnd, hintMaxBudget, currentQueryIdx, m_queryPool));
+    const nvutils::BuildPass& pass = m_plan.passes[m_currentPassIdx++];
+    for(uint32_t b = pass.firstBatch; b < pass.firstBatch + pass.batchCount; b++)
+    {
+      NVVK_FAIL_RETURN(
+          cmdBuildAccelerationStructures(cmd, m_plan.batches[b], blasBuildData, blasAccel, scratchAddress, m_queryPool));
+    }
   }
 
   // Store batch information for compaction
@@ -237,11 +257,11 @@ VkResult AccelerationStructureBuilder::cmdCreateBlas(VkCommandBuffer
 VkResult AccelerationStructureBuilder::initializeQueryPoolIfNeeded(VkCommandBuffer cmd,
                                                                    const std::span<AccelerationStructureBuildData>& blasBuildData)
 {
-  // Check if any BLAS in this potential batch needs compaction
+  // Check if any BLAS that is left to build needs compaction
   bool needsCompaction = false;
   for(size_t i = m_currentBlasIdx; i < blasBuildData.size(); i++)
   {
-    if(blasBuildData[i].hasCompactFlag())
+    if(blasBuildData[m_plan.builds[i].item].hasCompactFlag())
     {
       needsCompaction = true;
       break;
@@ -272,71 +292,55 @@ VkResult AccelerationStructureBuilder::initializeQueryPoolIfNeeded(VkCommandBuff
 }
 
 
-// Builds multiple Bottom-Level Acceleration Structures (BLAS) for a Vulkan ray tracing pipeline.
-// This function manages memory budgets and submits the necessary commands to the specified command buffer.
+// Builds one batch of the plan: the BLAS share the scratch buffer at the offsets the plan
+// assigned them and are built with a single vkCmdBuildAccelerationStructuresKHR, followed by a barrier.
 //
 // Parameters:
 //   cmd               - Command buffer where acceleration structure commands are recorded.
-//   budgetUsed        - Running value of the budget used.
+//   batch             - The batch of m_plan to build; starts at m_currentBlasIdx.
 //   blasBuildData     - Vector of data structures containing the geometry and other build-related information for each BLAS.
 //   blasAccel         - Vector where the function will store the created acceleration structures.
 //   scratchAddress    - The starting scratchAddress
-//   scratchAddressEnd - The end address for the available scratch space
-//   hintMaxBudget     - A hint for the maximum budget allowed for building acceleration structures.
-//   currentQueryIdx   - Reference to the current index for queries, updated during execution.
-//
-// Returns:
-//   The total device size used for building the acceleration structures during this function call.
-VkResult AccelerationStructureBuilder::cmdBuildAccelerationStructures(VkCommandBuffer cmd,
-                                                                      VkDeviceSize&   budgetUsed,
+//   queryPool         - If not null, the compacted sizes are written to it; the query index is the position in m_plan.builds.
+VkResult AccelerationStructureBuilder::cmdBuildAccelerationStructures(VkCommandBuffer                            cmd,
+                                                                      const nvutils::BuildBatch&                 batch,
                                                                       std::span<AccelerationStructureBuildData>& blasBuildData,
                                                                       std::span<AccelerationStructure>& blasAccel,
                                                                       VkDeviceAddress                   scratchAddress,
-                                                                      VkDeviceAddress scratchAddressEnd,
-                                                                      VkDeviceSize    hintMaxBudget,
-                                                                      uint32_t&       currentQueryIdx,
-                                                                      VkQueryPool     queryPool)
+                                                                      VkQueryPool                       queryPool)
 {
+  assert(batch.firstBuild == m_currentBlasIdx);
+
   // Temporary vectors for storing build-related data
   std::vector<VkAccelerationStructureBuildGeometryInfoKHR> collectedBuildInfo;
   std::vector<VkAccelerationStructureKHR>                  collectedAccel;
   std::vector<VkAccelerationStructureBuildRangeInfoKHR*>   collectedRangeInfo;
 
   // Pre-allocate memory based on the number of BLAS to be built
-  collectedBuildInfo.reserve(blasBuildData.size());
-  collectedAccel.reserve(blasBuildData.size());
-  collectedRangeInfo.reserve(blasBuildData.size());
+  collectedBuildInfo.reserve(batch.buildCount);
+  collectedAccel.reserve(batch.buildCount);
+  collectedRangeInfo.reserve(batch.buildCount);
 
-  // Loop through BLAS data while there is scratch address space and budget available
-  while(scratchAddress < scratchAddressEnd && budgetUsed < hintMaxBudget && m_currentBlasIdx < blasBuildData.size())
+  for(uint32_t i = batch.firstBuild; i < batch.firstBuild + batch.buildCount; i++)
   {
-    auto&                                data       = blasBuildData[m_currentBlasIdx];
+    const nvutils::PlannedBuild&         build      = m_plan.builds[i];
+    auto&                                data       = blasBuildData[build.item];
     VkAccelerationStructureCreateInfoKHR createInfo = data.makeCreateInfo();
 
-    if(scratchAddress + data.sizeInfo.buildScratchSize > scratchAddressEnd)
-      break;
-
     // Create and store acceleration structure
-    NVVK_FAIL_RETURN(m_alloc->createAcceleration(blasAccel[m_currentBlasIdx], createInfo));
-    NVVK_DBG_NAME(blasAccel[m_currentBlasIdx].accel);
-    collectedAccel.push_back(blasAccel[m_currentBlasIdx].accel);
+    NVVK_FAIL_RETURN(m_alloc->createAcceleration(blasAccel[build.item], createInfo));
+    NVVK_DBG_NAME(blasAccel[build.item].accel);
+    collectedAccel.push_back(blasAccel[build.item].accel);
 
     // Setup build information for the current BLAS
     data.buildInfo.mode                      = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     data.buildInfo.srcAccelerationStructure  = VK_NULL_HANDLE;
-    data.buildInfo.dstAccelerationStructure  = blasAccel[m_currentBlasIdx].accel;
-    data.buildInfo.scratchData.deviceAddress = scratchAddress;
+    data.buildInfo.dstAccelerationStructure  = blasAccel[build.item].accel;
+    data.buildInfo.scratchData.deviceAddress = scratchAddress + build.scratchOffset;
     data.buildInfo.pGeometries               = data.asGeometry.data();
     collectedBuildInfo.push_back(data.buildInfo);
     collectedRangeInfo.push_back(data.asBuildRangeInfo.data());
 
-    // Update the used budget with the size of the current structure
-    budgetUsed += data.sizeInfo.accelerationStructureSize;
-
-    // Update scratch address, keep it aligned
-    VkDeviceSize scratchSize = nvutils::align_up(data.sizeInfo.buildScratchSize, m_scratchAlignment);
-    scratchAddress += scratchSize;
-
     m_currentBlasIdx++;
   }
 
@@ -354,11 +358,9 @@ VkResult AccelerationStructureBuilder::cmdBuildAccelerationStructures(VkCommandB
     uint32_t numQueries = static_cast<uint32_t>(collectedAccel.size());
     vkCmdWriteAccelerationStructuresPropertiesKHR(cmd, numQueries, collectedAccel.data(),
                                                   VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, queryPool,
-                                                  currentQueryIdx);
-    currentQueryIdx += numQueries;
+                                                  batch.firstBuild);
   }
 
-  // Return the total budget used in this operation
   return VK_SUCCESS;
 }
 
@@ -406,12 +408,7 @@ VkResult AccelerationStructureBuilder::cmdCompactBlas(VkCommandBuffer
     // Process compaction for this batch
     for(uint32_t i = 0; i < batchSize; i++)
     {
-      uint32_t blasIdx = batch.startIdx + i;
-      if(blasIdx >= blasBuildData.size())
-      {
-        // We've processed all available BLAS
-        break;
-      }
+      uint32_t blasIdx = m_plan.builds[batch.startIdx + i].item;
 
       VkDeviceSize compactSize = compactSizes[i];
 
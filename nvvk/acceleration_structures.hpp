@@ -26,6 +26,12 @@
 
 #include <glm/glm.hpp>
 #include <volk.h>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include <nvutils/build_batch_planner.hpp>
 
 #include "resource_allocator.hpp"
 #include "staging.hpp"
@@ -81,14 +87,37 @@ inline void accelerationStructureBarrier(VkCommandBuffer cmd, VkAccessFlags src,
 }
 
 // Convert a Mat4x4 to the matrix required by acceleration structures
-inline VkTransformMatrixKHR toTransformMatrixKHR(glm::mat4 matrix)
+inline VkTransformMatrixKHR toTransformMatrixKHR(const glm::mat4& matrix)
 {
   // VkTransformMatrixKHR uses a row-major memory layout, while glm::mat4
-  // uses a column-major memory layout. We transpose the matrix so we can
-  // memcpy the matrix's data directly.
-  glm::mat4            temp = glm::transpose(matrix);
+  // uses a column-major memory layout: its rows are the first three rows of
+  // the transposed matrix. This is called for every instance of a TLAS, so
+  // the transpose uses SIMD where available.
   VkTransformMatrixKHR out_matrix;
-  memcpy(&out_matrix, &temp, sizeof(VkTransformMatrixKHR));
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  __m128 c0 = _mm_loadu_ps(&matrix[0][0]);
+  __m128 c1 = _mm_loadu_ps(&matrix[1][0]);
+  __m128 c2 = _mm_loadu_ps(&matrix[2][0]);
+  __m128 c3 = _mm_loadu_ps(&matrix[3][0]);
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+  _mm_storeu_ps(out_matrix.matrix[0], c0);
+  _mm_storeu_ps(out_matrix.matrix[1], c1);
+  _mm_storeu_ps(out_matrix.matrix[2], c2);
+#elif defined(__ARM_NEON)
+  // De-interleaving the 16 floats by 4 yields the rows
+  const float32x4x4_t rows = vld4q_f32(&matrix[0][0]);
+  vst1q_f32(out_matrix.matrix[0], rows.val[0]);
+  vst1q_f32(out_matrix.matrix[1], rows.val[1]);
+  vst1q_f32(out_matrix.matrix[2], rows.val[2]);
+#else
+  for(int row = 0; row < 3; row++)
+  {
+    for(int column = 0; column < 4; column++)
+    {
+      out_matrix.matrix[row][column] = matrix[column][row];
+    }
+  }
+#endif
   return out_matrix;
 }
 
@@ -154,7 +183,8 @@ VkDeviceSize getMaxScratchSize(const std::vector<AccelerationStructureBuildData>
  - Create scratch buffer
 
  Within a loop
-   - Call `cmdCreateBlas` to create all or a range of BLAS that are provided BlasBuildData
+   - Call `cmdCreateBlas` to create all or a subset of BLAS that are provided BlasBuildData
+     (the BLAS are built in the order of `getBuildPlan`, not in input order)
    - Submit command buffer and wait
    - Call `cmdCompactBlas` to compact the BLAS that have been built thus far.
    - Call `destroyNonCompactedBlas` to destroy the original BLAS that were compacted.
@@ -192,6 +222,12 @@ public:
   // as the `scratchSize` and `hintMaxBudget` allows. Higher `scratchSize` allows less barriers, and
   // higher `hintMaxBudget` means less need to call this function multiple times.
   //
+  // The first call plans all builds with nvutils::planBuildBatches(): the BLAS are grouped by
+  // scratch size rather than built in input order, so that large and small BLAS share the scratch
+  // buffer and fewer barriers are needed. Each call then builds one pass of the plan, whose
+  // acceleration structure sizes add up to at most `hintMaxBudget` (unless a single BLAS is larger).
+  // All calls must pass the same `blasBuildData` and at least the same `scratchSize`.
+  //
   // Returns VK_SUCCESS if the entire input vector was processed,
   // returns VK_INCOMPLETE if this function needs to be called again until it returns VK_SUCCESS
   // Other result codes are to be treated as error.
@@ -231,22 +267,23 @@ public:
   // Get the minimum offset alignment of the scratch buffer
   VkDeviceSize getScratchAlignment() const { return m_scratchAlignment; }
 
+  // The plan that cmdCreateBlas() follows; empty before its first call
+  const nvutils::BuildBatchPlan& getBuildPlan() const { return m_plan; }
+
 private:
   AccelerationStructureBuilder& operator=(const AccelerationStructureBuilder&) = default;
 
   void destroy();
   void destroyQueryPool();
   VkResult initializeQueryPoolIfNeeded(VkCommandBuffer cmd, const std::span<AccelerationStructureBuildData>& blasBuildData);
-  VkResult cmdBuildAccelerationStructures(VkCommandBuffer cmd,
-                                          VkDeviceSize&   budgetUsed,  // in/out: budget used so far
+  VkResult cmdBuildAccelerationStructures(VkCommandBuffer                            cmd,
+                                          const nvutils::BuildBatch&                 batch,
                                           std::span<AccelerationStructureBuildData>& blasBuildData,
                                           std::span<nvvk::AccelerationStructure>&    blasAccel,
                                           VkDeviceAddress                            scratchAddress,
-                                          VkDeviceAddress                            scratchAddressEnd,
-                                          VkDeviceSize                               hintMaxBudget,
-                                          uint32_t&                                  currentQueryIdx,
                                           VkQueryPool                                queryPool);
 
+  // startIdx and endIdx are positions in m_plan.builds, which are also the query indices
   struct CompactBatchInfo
   {
     uint32_t    startIdx{};
@@ -257,10 +294,11 @@ private:
   nvvk::ResourceAllocator*     m_alloc{};             // Allocator for the creation of acceleration structures
   VkDevice                     m_device{};            // Vulkan device
   VkQueryPool                  m_queryPool{};         // Query pool for BLAS compaction
-  uint32_t                     m_currentBlasIdx{};    // Index to the current BLAS being processed
-  uint32_t                     m_currentQueryIdx{};   // Index to the current query being processed
+  uint32_t                     m_currentBlasIdx{};    // Number of BLAS built so far; position in m_plan.builds
+  uint32_t                     m_currentPassIdx{};    // Next pass of m_plan to build
   uint32_t                     m_scratchAlignment{};  // Alignment of the scratch buffer
   std::queue<CompactBatchInfo> m_batches;             // Queue of compact batches to be processed
+  nvutils::BuildBatchPlan      m_plan;                // Order and scratch offsets of the BLAS builds
 
   std::vector<nvvk::AccelerationStructure> m_cleanupBlasAccel;  // List of BLAS to be cleaned up
 
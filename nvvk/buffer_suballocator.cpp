@@ -17,8 +17,12 @@
 * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <algorithm>
 #include <cassert>
 
+#include <nvutils/compaction_planner.hpp>
+
+#include "barriers.hpp"
 #include "check_error.hpp"
 #include "debug_util.hpp"
 #include "buffer_suballocator.hpp"
@@ -32,11 +36,11 @@ BufferSubAllocator::~BufferSubAllocator()
 
 BufferSubAllocator::BufferSubAllocator(BufferSubAllocator&& other) noexcept
 {
-  std::swap(m_state.allocatedSize, other.m_state.allocatedSize);
+  std::swap(m_state, other.m_state);
   std::swap(m_blocks, other.m_blocks);
   std::swap(m_info, other.m_info);
-  std::swap(m_state.internalBlockUnits, other.m_state.internalBlockUnits);
-  std::swap(m_state.maxBlocks, other.m_state.maxBlocks);
+  std::swap(m_retiredBlocks, other.m_retiredBlocks);
+  std::swap(m_threadCaches, other.m_threadCaches);
 }
 
 BufferSubAllocator& BufferSubAllocator::operator=(BufferSubAllocator&& other) noexcept
@@ -45,11 +49,11 @@ BufferSubAllocator& BufferSubAllocator::operator=(BufferSubAllocator&& other) no
   {
     assert(m_info.resourceAllocator == nullptr && "Missing deinit()");
 
-    std::swap(m_state.allocatedSize, other.m_state.allocatedSize);
+    std::swap(m_state, other.m_state);
     std::swap(m_blocks, other.m_blocks);
     std::swap(m_info, other.m_info);
-    std::swap(m_state.internalBlockUnits, other.m_state.internalBlockUnits);
-    std::swap(m_state.maxBlocks, other.m_state.maxBlocks);
+    std::swap(m_retiredBlocks, other.m_retiredBlocks);
+    std::swap(m_threadCaches, other.m_threadCaches);
   }
 
   return *this;
@@ -63,12 +67,13 @@ VkResult BufferSubAllocator::init(const InitInfo& info)
   assert(info.minAlignment <= MAX_ALIGNMENT);
   assert(info.minAlignment >= MIN_ALIGNMENT);
 
-  m_state.maxAllocationSize = std::min((VkDeviceSize(1) << (sizeof(BufferSubAllocation::size)) * 8) - 1,
-                                       info.resourceAllocator->getMaxMemoryAllocationSize());
+  m_info = info;
+
+  m_state.maxAllocationSize =
+      std::min((VkDeviceSize(1) << (sizeof(BufferSubAllocation::size)) * 8) - 1, getMaxBufferSize());
 
   assert(info.blockSize <= m_state.maxAllocationSize);
 
-  m_info = info;
   if(!m_info.maxAllocatedSize)
   {
     m_info.maxAllocatedSize = info.blockSize * MAX_TOTAL_BLOCKS;
@@ -80,6 +85,25 @@ VkResult BufferSubAllocator::init(const InitInfo& info)
   m_state.maxBlocks = static_cast<uint32_t>(maxBlocks);
   m_state.internalBlockUnits = static_cast<uint32_t>((m_info.blockSize + m_info.minAlignment - 1) / m_info.minAlignment);
 
+  if(m_info.concurrentThreads)
+  {
+    assert(m_info.concurrentBatchSize > 0);
+
+    // largest power of two that fits both the requested size and half a block
+    uint32_t maxUnits = std::min(getAllocatorUnits(m_info.concurrentMaxCachedSize, m_info.minAlignment),
+                                 m_state.internalBlockUnits / 2);
+    m_state.maxCachedUnits = maxUnits ? 1u << (getSizeClass(maxUnits + 1) - 1) : 0;
+
+    m_threadCaches.resize(m_info.concurrentThreads);
+    for(ThreadCache& cache : m_threadCaches)
+    {
+      cache.sizeClasses.resize(getSizeClass(m_state.maxCachedUnits) + 1);
+    }
+
+    // blocks must not move while `subRange` reads them without the lock
+    m_blocks.reserve(m_state.maxBlocks);
+  }
+
   if(m_info.keepLastBlock)
   {
     Block block;
@@ -101,9 +125,12 @@ void BufferSubAllocator::deinit()
   if(!m_info.resourceAllocator)
     return;
 
+  releaseDefragmented(true);
+  m_threadCaches.clear();
+
   for(Block& it : m_blocks)
   {
-    m_info.resourceAllocator->destroyBuffer(it.buffer);
+    destroyBlockBuffer(it.buffer);
   }
 
   m_info  = {};
@@ -114,6 +141,12 @@ void BufferSubAllocator::deinit()
 
 BufferSubAllocator::Report BufferSubAllocator::getReport() const
 {
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if(!m_threadCaches.empty())
+  {
+    lock.lock();
+  }
+
   BufferSubAllocator::Report report;
 
   for(size_t i = 0; i < m_blocks.size(); i++)
@@ -126,7 +159,7 @@ BufferSubAllocator::Report BufferSubAllocator::getReport() const
     {
       OffsetAllocator::StorageReport storageReport = offsetAllocator->storageReport();
       report.reservedSize += VkDeviceSize(m_state.internalBlockUnits - storageReport.totalFreeSpace) * m_info.minAlignment;
-      report.freeSize = VkDeviceSize(storageReport.totalFreeSpace) * m_info.minAlignment;
+      report.freeSize += VkDeviceSize(storageReport.totalFreeSpace) * m_info.minAlignment;
     }
     else
     {
@@ -157,6 +190,36 @@ uint32_t BufferSubAllocator::acquireBlockIndex()
 }
 
 VkResult BufferSubAllocator::subAllocate(BufferSubAllocation& subAllocation, VkDeviceSize size, uint32_t alignment)
+{
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if(!m_threadCaches.empty())
+  {
+    lock.lock();
+  }
+  return subAllocateInternal(subAllocation, size, alignment);
+}
+
+uint32_t BufferSubAllocator::getAllocatorUnits(VkDeviceSize size, uint32_t alignment) const
+{
+  // adjust the size to account for local alignment
+  VkDeviceSize sizeAllocate = size;
+
+  // for non power of two, always add extra space to return a proper offset
+  bool alignmentIsPowerOfTwo = (alignment & (alignment - 1)) == 0;
+  if(!alignmentIsPowerOfTwo || alignment > m_info.minAlignment)
+  {
+    // adjust for requested alignment and add safety margin to size.
+    // The offset returned from OffsetAllocator will only be aligned to m_info.minAlignment.
+    // With the extra safety margin space, we can later adjust the returned offset to alignment,
+    // see logic in `subRange`.
+    sizeAllocate = (sizeAllocate + alignment - 1);
+  }
+
+  // offset allocator works in units of `m_info.minAlignment`
+  return static_cast<uint32_t>((sizeAllocate + m_info.minAlignment - 1) / m_info.minAlignment);
+}
+
+VkResult BufferSubAllocator::subAllocateInternal(BufferSubAllocation& subAllocation, VkDeviceSize size, uint32_t alignment)
 {
   subAllocation = {};
 
@@ -222,23 +285,23 @@ VkResult BufferSubAllocator::subAllocate(BufferSubAllocation& subAllocation, VkD
 
   // else try to find a sub allocation
 
-  // adjust the size to account for local alignment
-  VkDeviceSize sizeAllocate = size;
+  OffsetAllocator::Allocation allocation;
+  uint32_t                    blockIndex;
+  NVVK_FAIL_RETURN(allocateFromBlocks(getAllocatorUnits(size, alignment), allocation, blockIndex));
 
-  // for non power of two, always add extra space to return a proper offset
-  if(!alignmentIsPowerOfTwo || alignment > m_info.minAlignment)
-  {
-    // adjust for requested alignment and add safety margin to size.
-    // The offset returned from OffsetAllocator will only be aligned to m_info.minAlignment.
-    // With the extra safety margin space, we can later adjust the returned offset to alignment,
-    // see logic in `subRange`.
-    sizeAllocate = (sizeAllocate + alignment - 1);
-  }
-
-  // offset allocator works in units of `m_info.minAlignment`
-  uint32_t allocatorUnits = static_cast<uint32_t>((sizeAllocate + m_info.minAlignment - 1) / m_info.minAlignment);
+  subAllocation.allocation        = allocation;
+  subAllocation.size              = static_cast<uint32_t>(size);
+  subAllocation.alignmentMinusOne = alignment - 1;
+  subAllocation.block             = uint16_t(blockIndex);
+#ifndef NDEBUG
+  subAllocation.allocator = this;
+#endif
 
+  return VK_SUCCESS;
+}
 
+VkResult BufferSubAllocator::allocateFromBlocks(uint32_t allocatorUnits, OffsetAllocator::Allocation& allocation, uint32_t& blockIndex)
+{
   // iterate over active blocks to find allocation
 
   uint32_t activeBlockIndex = m_state.activeBlockIndex;
@@ -249,18 +312,11 @@ VkResult BufferSubAllocator::subAllocate(BufferSubAllocation& subAllocation, VkD
 
     // attempt to sub allocate from active blocks
 
-    OffsetAllocator::Allocation allocation = block.offsetAllocator->allocate(allocatorUnits);
+    allocation = block.offsetAllocator->allocate(allocatorUnits);
 
     if(allocation.offset != OffsetAllocator::Allocation::NO_SPACE)
     {
-      subAllocation.allocation        = allocation;
-      subAllocation.size              = static_cast<uint32_t>(size);
-      subAllocation.alignmentMinusOne = alignment - 1;
-      subAllocation.block             = uint16_t(activeBlockIndex);
-#ifndef NDEBUG
-      subAllocation.allocator = this;
-#endif
-
+      blockIndex = activeBlockIndex;
       return VK_SUCCESS;
     }
 
@@ -300,18 +356,11 @@ VkResult BufferSubAllocator::subAllocate(BufferSubAllocation& subAllocation, VkD
 
     // sub allocate from new block
 
-    OffsetAllocator::Allocation allocation = block.offsetAllocator->allocate(allocatorUnits);
+    allocation = block.offsetAllocator->allocate(allocatorUnits);
 
     if(allocation.offset != OffsetAllocator::Allocation::NO_SPACE)
     {
-      subAllocation.allocation        = allocation;
-      subAllocation.size              = static_cast<uint32_t>(size);
-      subAllocation.alignmentMinusOne = alignment - 1;
-      subAllocation.block             = uint16_t(freeBlockIndex);
-#ifndef NDEBUG
-      subAllocation.allocator = this;
-#endif
-
+      blockIndex = freeBlockIndex;
       return VK_SUCCESS;
     }
     else
@@ -322,6 +371,16 @@ VkResult BufferSubAllocator::subAllocate(BufferSubAllocation& subAllocation, VkD
 }
 
 void BufferSubAllocator::subFree(BufferSubAllocation& subAllocation)
+{
+  std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+  if(!m_threadCaches.empty())
+  {
+    lock.lock();
+  }
+  subFreeInternal(subAllocation);
+}
+
+void BufferSubAllocator::subFreeInternal(BufferSubAllocation& subAllocation)
 {
   // make it legal to pass unset ranges
   if(!subAllocation)
@@ -331,18 +390,26 @@ void BufferSubAllocator::subFree(BufferSubAllocation& subAllocation)
 
 #ifndef NDEBUG
   assert(subAllocation.allocator == this);
+  assert(!subAllocation.cached && "must be freed with subFreeConcurrent");
 #endif
 
-  OffsetAllocator::Allocator* offsetAllocator = m_blocks[subAllocation.block].offsetAllocator.get();
+  freeFromBlock(subAllocation.allocation, subAllocation.block);
+
+  m_state.allocatedSize -= subAllocation.size;
+
+  subAllocation = {};
+}
+
+void BufferSubAllocator::freeFromBlock(const OffsetAllocator::Allocation& allocation, uint32_t blockIndex)
+{
+  OffsetAllocator::Allocator* offsetAllocator = m_blocks[blockIndex].offsetAllocator.get();
 
   // dedicated blocks might not have an offset allocator
   if(offsetAllocator)
   {
-    offsetAllocator->free(subAllocation.allocation);
+    offsetAllocator->free(allocation);
   }
 
-  m_state.allocatedSize -= subAllocation.size;
-
   // check if dedicated block or empty
   if(!offsetAllocator || offsetAllocator->storageReport().totalFreeSpace == m_state.internalBlockUnits)
   {
@@ -350,46 +417,467 @@ void BufferSubAllocator::subFree(BufferSubAllocation& subAllocation)
     // and maybe depending if we are the last one
     if(!offsetAllocator || (m_state.activeBlockCount > 1 || !m_info.keepLastBlock))
     {
-      m_info.resourceAllocator->destroyBuffer(m_blocks[subAllocation.block].buffer);
+      destroyBlockBuffer(m_blocks[blockIndex].buffer);
 
       // blocks with OffsetAllocators are counted to active blocks
       if(offsetAllocator)
       {
-        m_state.activeBlockCount--;
-
         // need to remove from linked list of active blocks
-
-        uint32_t selfActiveIndex = subAllocation.block;
-        uint32_t prevActiveIndex = m_blocks[selfActiveIndex].prevActiveIndex;
-        uint32_t nextActiveIndex = m_blocks[selfActiveIndex].nextActiveIndex;
-        if(prevActiveIndex != INVALID_BLOCK_INDEX)
-        {
-          // set previous's next to self next
-          m_blocks[prevActiveIndex].nextActiveIndex = nextActiveIndex;
-        }
-        if(nextActiveIndex != INVALID_BLOCK_INDEX)
-        {
-          // set next's previous to self previous
-          m_blocks[nextActiveIndex].prevActiveIndex = prevActiveIndex;
-        }
-        if(m_state.activeBlockIndex == selfActiveIndex)
-        {
-          m_state.activeBlockIndex = nextActiveIndex;
-        }
+        unlinkActiveBlock(blockIndex);
       }
 
       // nuke it completely
-      m_blocks[subAllocation.block] = {};
+      m_blocks[blockIndex] = {};
 
       // chain into linked list of empty blocks
-      m_blocks[subAllocation.block].nextFreeIndex = m_state.freeBlockIndex;
-      m_state.freeBlockIndex                      = subAllocation.block;
+      m_blocks[blockIndex].nextFreeIndex = m_state.freeBlockIndex;
+      m_state.freeBlockIndex             = blockIndex;
+    }
+  }
+}
+
+VkResult BufferSubAllocator::subAllocateConcurrent(uint32_t threadIndex, BufferSubAllocation& subAllocation, VkDeviceSize size, uint32_t alignment)
+{
+  assert(threadIndex < m_threadCaches.size() && "concurrentThreads too small");
+
+  const uint32_t units = getAllocatorUnits(size, alignment);
+  if(size >= m_info.blockSize || units > m_state.maxCachedUnits)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    processDeferredFrees(m_threadCaches[threadIndex]);
+    return subAllocateInternal(subAllocation, size, alignment);
+  }
+
+  subAllocation = {};
+
+  assert(alignment % MIN_ALIGNMENT == 0);
+  assert(alignment >= MIN_ALIGNMENT && alignment <= MAX_ALIGNMENT);
+
+  // round up to the size class, which includes the safety margin for the alignment
+  const uint32_t                 sizeClass = getSizeClass(units);
+  ThreadCache&                   cache     = m_threadCaches[threadIndex];
+  std::vector<CachedAllocation>& cached    = cache.sizeClasses[sizeClass];
+  if(cached.empty())
+  {
+    const uint32_t     classUnits = 1u << sizeClass;
+    const VkDeviceSize classSize  = VkDeviceSize(classUnits) * m_info.minAlignment;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    processDeferredFrees(cache);
+
+    // refill in a batch, so that the lock is taken once per batch
+    for(uint32_t i = 0; i < m_info.concurrentBatchSize; i++)
+    {
+      CachedAllocation entry;
+      if(classSize + m_state.allocatedSize > m_info.maxAllocatedSize
+         || allocateFromBlocks(classUnits, entry.allocation, entry.block) != VK_SUCCESS)
+      {
+        break;
+      }
+      m_state.allocatedSize += classSize;
+      cached.push_back(entry);
+    }
+    if(cached.empty())
+    {
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+  }
+
+  const CachedAllocation& entry   = cached.back();
+  subAllocation.allocation        = entry.allocation;
+  subAllocation.size              = static_cast<uint32_t>(size);
+  subAllocation.alignmentMinusOne = alignment - 1;
+  subAllocation.block             = uint16_t(entry.block);
+#ifndef NDEBUG
+  subAllocation.allocator = this;
+  subAllocation.cached    = true;
+#endif
+  cached.pop_back();
+
+  return VK_SUCCESS;
+}
+
+void BufferSubAllocator::subFreeConcurrent(uint32_t threadIndex, BufferSubAllocation& subAllocation)
+{
+  assert(threadIndex < m_threadCaches.size() && "concurrentThreads too small");
+
+  // make it legal to pass unset ranges
+  if(!subAllocation)
+  {
+    return;
+  }
+
+#ifndef NDEBUG
+  assert(subAllocation.allocator == this);
+#endif
+
+  ThreadCache&   cache = m_threadCaches[threadIndex];
+  const uint32_t units = getAllocatorUnits(subAllocation.size, uint32_t(subAllocation.alignmentMinusOne) + 1);
+
+  // dedicated blocks have no OffsetAllocator metadata
+  if(subAllocation.allocation.metadata != OffsetAllocator::Allocation::NO_SPACE && units <= m_state.maxCachedUnits)
+  {
+#ifndef NDEBUG
+    assert(subAllocation.cached && "must be freed with subFree");
+#endif
+    // whichever thread frees it keeps it for reuse
+    std::vector<CachedAllocation>& cached = cache.sizeClasses[getSizeClass(units)];
+    cached.push_back({subAllocation.allocation, subAllocation.block});
+
+    // give a batch back if the cache grows too large
+    if(cached.size() >= size_t(m_info.concurrentBatchSize) * 2)
+    {
+      const VkDeviceSize classSize = (VkDeviceSize(1) << getSizeClass(units)) * m_info.minAlignment;
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(uint32_t i = 0; i < m_info.concurrentBatchSize; i++)
+      {
+        freeFromBlock(cached.back().allocation, cached.back().block);
+        m_state.allocatedSize -= classSize;
+        cached.pop_back();
+      }
+      processDeferredFrees(cache);
+    }
+  }
+  else
+  {
+#ifndef NDEBUG
+    assert(!subAllocation.cached);
+#endif
+    // freed with the next batch, to not take the lock for each
+    cache.deferredFrees.push_back({subAllocation.allocation, subAllocation.block, subAllocation.size});
+    if(cache.deferredFrees.size() >= m_info.concurrentBatchSize)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      processDeferredFrees(cache);
     }
   }
 
   subAllocation = {};
 }
 
+void BufferSubAllocator::flushConcurrentCaches()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(ThreadCache& cache : m_threadCaches)
+  {
+    for(size_t sizeClass = 0; sizeClass < cache.sizeClasses.size(); sizeClass++)
+    {
+      const VkDeviceSize classSize = (VkDeviceSize(1) << sizeClass) * m_info.minAlignment;
+      for(const CachedAllocation& entry : cache.sizeClasses[sizeClass])
+      {
+        freeFromBlock(entry.allocation, entry.block);
+        m_state.allocatedSize -= classSize;
+      }
+      cache.sizeClasses[sizeClass].clear();
+    }
+    processDeferredFrees(cache);
+  }
+}
+
+uint32_t BufferSubAllocator::getSizeClass(uint32_t allocatorUnits)
+{
+  // smallest power of two >= allocatorUnits
+  uint32_t sizeClass = 0;
+  while((1u << sizeClass) < allocatorUnits)
+  {
+    sizeClass++;
+  }
+  return sizeClass;
+}
+
+void BufferSubAllocator::processDeferredFrees(ThreadCache& cache)
+{
+  for(const CachedAllocation& entry : cache.deferredFrees)
+  {
+    freeFromBlock(entry.allocation, entry.block);
+    m_state.allocatedSize -= entry.size;
+  }
+  cache.deferredFrees.clear();
+}
+
+void BufferSubAllocator::unlinkActiveBlock(uint32_t blockIndex)
+{
+  m_state.activeBlockCount--;
+
+  uint32_t prevActiveIndex = m_blocks[blockIndex].prevActiveIndex;
+  uint32_t nextActiveIndex = m_blocks[blockIndex].nextActiveIndex;
+  if(prevActiveIndex != INVALID_BLOCK_INDEX)
+  {
+    // set previous's next to self next
+    m_blocks[prevActiveIndex].nextActiveIndex = nextActiveIndex;
+  }
+  if(nextActiveIndex != INVALID_BLOCK_INDEX)
+  {
+    // set next's previous to self previous
+    m_blocks[nextActiveIndex].prevActiveIndex = prevActiveIndex;
+  }
+  if(m_state.activeBlockIndex == blockIndex)
+  {
+    m_state.activeBlockIndex = nextActiveIndex;
+  }
+}
+
+VkResult BufferSubAllocator::cmdDefragment(VkCommandBuffer cmd, const DefragmentInfo& info, DefragmentStats* stats)
+{
+  if(stats)
+  {
+    *stats = {};
+  }
+
+  // A block can only be emptied if we know all of its sub-allocations,
+  // i.e. if those passed add up to what its OffsetAllocator has in use.
+  std::vector<VkDeviceSize> passedUnits(m_blocks.size(), 0);
+  for(const BufferSubAllocation* subAllocation : info.subAllocations)
+  {
+    if(subAllocation && *subAllocation && m_blocks[subAllocation->block].offsetAllocator)
+    {
+#ifndef NDEBUG
+      assert(subAllocation->allocator == this);
+#endif
+      passedUnits[subAllocation->block] +=
+          m_blocks[subAllocation->block].offsetAllocator->allocationSize(subAllocation->allocation);
+    }
+  }
+
+  std::vector<nvutils::CompactionItem> items;
+  std::vector<size_t>                  itemSubAllocations;  // index into info.subAllocations
+  for(size_t i = 0; i < info.subAllocations.size(); i++)
+  {
+    const BufferSubAllocation* subAllocation = info.subAllocations[i];
+    if(!subAllocation || !*subAllocation || !m_blocks[subAllocation->block].offsetAllocator)
+    {
+      continue;
+    }
+
+    const OffsetAllocator::Allocator& offsetAllocator = *m_blocks[subAllocation->block].offsetAllocator;
+    if(passedUnits[subAllocation->block] != m_state.internalBlockUnits - offsetAllocator.storageReport().totalFreeSpace)
+    {
+      continue;
+    }
+
+    // in OffsetAllocator units, so that the safety margin for the alignment moves along
+    items.push_back({subAllocation->block, subAllocation->allocation.offset, offsetAllocator.allocationSize(subAllocation->allocation)});
+    itemSubAllocations.push_back(i);
+  }
+
+  const nvutils::CompactionPlan plan =
+      nvutils::planCompaction(items, {.blockCapacity    = m_state.internalBlockUnits,
+                                      .maxItemsPerBlock = std::max(m_info.perBlockAllocations, 2u) - 1,
+                                      .maxOccupancy     = info.maxBlockOccupancy});
+  if(plan.empty())
+  {
+    return VK_SUCCESS;
+  }
+
+  // Create the new blocks and sub-allocate from them first, so that nothing
+  // changes if we run out of memory or blocks.
+  struct Move
+  {
+    size_t              item;
+    BufferSubAllocation newSubAllocation;
+  };
+  std::vector<Move>     moves;
+  std::vector<uint32_t> newBlocks;
+  std::vector<uint32_t> plannedBlocks(plan.newBlockCount, INVALID_BLOCK_INDEX);
+  uint32_t              overflowBlock = INVALID_BLOCK_INDEX;
+
+  auto addNewBlock = [&](uint32_t& blockIndex) -> VkResult {
+    if(m_state.freeBlockIndex == INVALID_BLOCK_INDEX && m_blocks.size() == size_t(m_state.maxBlocks))
+    {
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    blockIndex = acquireBlockIndex();
+    newBlocks.push_back(blockIndex);
+
+    Block& block = m_blocks[blockIndex];
+    block.offsetAllocator = std::make_unique<OffsetAllocator::Allocator>(m_state.internalBlockUnits, m_info.perBlockAllocations);
+    return createNewBuffer(block.buffer, VkDeviceSize(m_state.internalBlockUnits) * m_info.minAlignment,
+                           m_info.minAlignment, blockIndex);
+  };
+
+  auto discardNewBlocks = [&]() {
+    for(uint32_t blockIndex : newBlocks)
+    {
+      destroyBlockBuffer(m_blocks[blockIndex].buffer);
+      m_blocks[blockIndex]               = {};
+      m_blocks[blockIndex].nextFreeIndex = m_state.freeBlockIndex;
+      m_state.freeBlockIndex             = blockIndex;
+    }
+  };
+
+  VkResult result = VK_SUCCESS;
+  for(const nvutils::CompactionMove& planned : plan.moves)
+  {
+    uint32_t& blockIndex = plannedBlocks[planned.dstBlock];
+    if(blockIndex == INVALID_BLOCK_INDEX && (result = addNewBlock(blockIndex)) != VK_SUCCESS)
+    {
+      break;
+    }
+
+    const uint32_t              units      = uint32_t(items[planned.item].size);
+    uint32_t                    dstBlock   = blockIndex;
+    OffsetAllocator::Allocation allocation = m_blocks[dstBlock].offsetAllocator->allocate(units);
+    if(allocation.offset == OffsetAllocator::Allocation::NO_SPACE)
+    {
+      // The planner packs blocks tightly, but OffsetAllocator rounds sizes to
+      // its bins and can fail to use the last bits of a block.
+      if(overflowBlock != INVALID_BLOCK_INDEX)
+      {
+        allocation = m_blocks[overflowBlock].offsetAllocator->allocate(units);
+      }
+      if(allocation.offset == OffsetAllocator::Allocation::NO_SPACE)
+      {
+        if((result = addNewBlock(overflowBlock)) != VK_SUCCESS)
+        {
+          break;
+        }
+        allocation = m_blocks[overflowBlock].offsetAllocator->allocate(units);
+        assert(allocation.offset != OffsetAllocator::Allocation::NO_SPACE);
+      }
+      dstBlock = overflowBlock;
+    }
+
+    BufferSubAllocation newSubAllocation = *info.subAllocations[itemSubAllocations[planned.item]];
+    newSubAllocation.allocation          = allocation;
+    newSubAllocation.block               = uint16_t(dstBlock);
+    moves.push_back({planned.item, newSubAllocation});
+  }
+
+  // Overflow blocks can eat up what compaction saves
+  if(result != VK_SUCCESS || newBlocks.size() >= plan.sourceBlocks.size())
+  {
+    discardNewBlocks();
+    return result;
+  }
+
+  // Record the copies, merging those that are contiguous in both blocks
+  struct Copy
+  {
+    uint32_t     srcBlock;
+    uint32_t     dstBlock;
+    VkBufferCopy region;
+  };
+  std::vector<Copy> copies;
+  copies.reserve(moves.size());
+  for(const Move& move : moves)
+  {
+    const BufferSubAllocation& oldSubAllocation = *info.subAllocations[itemSubAllocations[move.item]];
+    copies.push_back({oldSubAllocation.block, move.newSubAllocation.block,
+                      {subRange(oldSubAllocation).offset, subRange(move.newSubAllocation).offset, oldSubAllocation.size}});
+  }
+  std::sort(copies.begin(), copies.end(), [](const Copy& a, const Copy& b) {
+    if(a.srcBlock != b.srcBlock)
+      return a.srcBlock < b.srcBlock;
+    if(a.dstBlock != b.dstBlock)
+      return a.dstBlock < b.dstBlock;
+    return a.region.srcOffset < b.region.srcOffset;
+  });
+
+  cmdMemoryBarrier(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                   VK_ACCESS_2_MEMORY_WRITE_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+  std::vector<VkBufferCopy> regions;
+  for(size_t begin = 0; begin < copies.size();)
+  {
+    regions.clear();
+    size_t end = begin;
+    for(; end < copies.size() && copies[end].srcBlock == copies[begin].srcBlock && copies[end].dstBlock == copies[begin].dstBlock; end++)
+    {
+      const VkBufferCopy& region = copies[end].region;
+      if(!regions.empty() && regions.back().srcOffset + regions.back().size == region.srcOffset
+         && regions.back().dstOffset + regions.back().size == region.dstOffset)
+      {
+        regions.back().size += region.size;
+      }
+      else
+      {
+        regions.push_back(region);
+      }
+    }
+    vkCmdCopyBuffer(cmd, m_blocks[copies[begin].srcBlock].buffer.buffer, m_blocks[copies[begin].dstBlock].buffer.buffer,
+                    uint32_t(regions.size()), regions.data());
+    begin = end;
+  }
+
+  cmdMemoryBarrier(cmd, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                   VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+
+  // Update the handles while the old blocks still exist, so that onMoved
+  // gets valid old ranges
+  for(const Move& move : moves)
+  {
+    const size_t         index         = itemSubAllocations[move.item];
+    BufferSubAllocation& subAllocation = *info.subAllocations[index];
+    const BufferRange    oldRange      = subRange(subAllocation);
+
+    subAllocation = move.newSubAllocation;
+    if(info.onMoved)
+    {
+      info.onMoved(index, oldRange, subRange(subAllocation));
+    }
+    if(stats)
+    {
+      stats->movedSubAllocations++;
+      stats->movedSize += subAllocation.size;
+    }
+  }
+
+  // The new blocks become active, the old ones are retired
+  for(uint32_t blockIndex : newBlocks)
+  {
+    if(m_state.activeBlockIndex != INVALID_BLOCK_INDEX)
+    {
+      m_blocks[m_state.activeBlockIndex].prevActiveIndex = blockIndex;
+    }
+    m_blocks[blockIndex].nextActiveIndex = m_state.activeBlockIndex;
+    m_state.activeBlockIndex             = blockIndex;
+    m_state.activeBlockCount++;
+  }
+  for(uint32_t blockIndex : plan.sourceBlocks)
+  {
+    unlinkActiveBlock(blockIndex);
+    m_retiredBlocks.push_back({m_blocks[blockIndex].buffer, info.semaphoreState});
+
+    m_blocks[blockIndex]               = {};
+    m_blocks[blockIndex].nextFreeIndex = m_state.freeBlockIndex;
+    m_state.freeBlockIndex             = blockIndex;
+  }
+
+  if(stats)
+  {
+    stats->releasedBlocks = uint32_t(plan.sourceBlocks.size());
+    stats->createdBlocks  = uint32_t(newBlocks.size());
+  }
+
+  return VK_SUCCESS;
+}
+
+void BufferSubAllocator::releaseDefragmented(bool forceAll)
+{
+  VkDevice device = m_info.resourceAllocator->getDevice();
+
+  // compact as we iterate
+  size_t writeIdx = 0;
+  for(size_t readIdx = 0; readIdx < m_retiredBlocks.size(); readIdx++)
+  {
+    RetiredBlock& retired = m_retiredBlocks[readIdx];
+    if(forceAll || !retired.semaphoreState.isValid() || retired.semaphoreState.testSignaled(device))
+    {
+      destroyBlockBuffer(retired.buffer);
+    }
+    else
+    {
+      if(readIdx != writeIdx)
+      {
+        m_retiredBlocks[writeIdx] = std::move(retired);
+      }
+      writeIdx++;
+    }
+  }
+  m_retiredBlocks.resize(writeIdx);
+}
+
 BufferRange BufferSubAllocator::subRange(const BufferSubAllocation& subAllocation) const
 {
   // make it legal to pass unset ranges
@@ -446,6 +934,16 @@ VkResult BufferSubAllocator::createNewBuffer(nvvk::Buffer& buffer, VkDeviceSize
   return VK_SUCCESS;
 }
 
+void BufferSubAllocator::destroyBlockBuffer(nvvk::Buffer& buffer)
+{
+  m_info.resourceAllocator->destroyBuffer(buffer);
+}
+
+VkDeviceSize BufferSubAllocator::getMaxBufferSize() const
+{
+  return m_info.resourceAllocator->getMaxMemoryAllocationSize();
+}
+
 }  // namespace nvvk
 
 
@@ -524,3 +1022,30 @@ VkResult BufferSubAllocator::createNewBuffer(nvvk::Buffer& buffer, VkDeviceSize
     }
   }
 }
+
+[[maybe_unused]] static void usage_BufferSubAllocatorDefragment()
+{
+  nvvk::BufferSubAllocator bufferSubAllocator;  // EX. initialized as above
+
+  // all live sub-allocations, e.g. of streamed geometry
+  std::vector<nvvk::BufferSubAllocation*> subAllocations;
+
+  // when getReport() shows reservedSize far above requestedSize
+  VkCommandBuffer      cmd{};
+  nvvk::SemaphoreState semaphoreState{};  // signaled by the submit of `cmd`
+
+  nvvk::BufferSubAllocator::DefragmentStats stats;
+  bufferSubAllocator.cmdDefragment(cmd,
+                                   {.subAllocations = subAllocations,
+                                    .onMoved =
+                                        [&](size_t index, const nvvk::BufferRange& oldRange, const nvvk::BufferRange& newRange) {
+                                          // update descriptors or device addresses that refer to subAllocations[index]
+                                        },
+                                    .semaphoreState = semaphoreState},
+                                   &stats);
+
+  // submit cmd
+
+  // later, e.g. once per frame: destroys the old blocks once `cmd` has completed
+  bufferSubAllocator.releaseDefragmented();
+}
@@ -19,14 +19,17 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include <offsetallocator/offsetAllocator.hpp>
 #include <vulkan/vulkan_core.h>
 
 #include "resource_allocator.hpp"
+#include "semaphore.hpp"
 
 namespace nvvk {
 
@@ -55,6 +58,8 @@ private:
   uint16_t block{};
 #ifndef NDEBUG
   class BufferSubAllocator* allocator{};
+  // from BufferSubAllocator::subAllocateConcurrent's per-thread caches
+  bool cached{};
 #endif
 };
 
@@ -72,7 +77,7 @@ public:
   static constexpr uint32_t     DEFAULT_ALIGNMENT  = 16;
 
   BufferSubAllocator() = default;
-  ~BufferSubAllocator();
+  virtual ~BufferSubAllocator();
 
   // Delete copy constructor and copy assignment operator
   BufferSubAllocator(const BufferSubAllocator&)            = delete;
@@ -108,6 +113,15 @@ public:
 
     // to avoid freeing and allocating blocks in succession
     bool keepLastBlock = true;
+
+    // > 0 enables the concurrent mode, see `subAllocateConcurrent`,
+    // with a cache for each thread index < concurrentThreads
+    uint32_t concurrentThreads = 0;
+    // sizes (plus alignment margin) up to this are served from the per-thread caches,
+    // rounded up to power-of-two size classes
+    uint32_t concurrentMaxCachedSize = 64 * 1024;
+    // sub-allocations a cache fetches or returns at once
+    uint32_t concurrentBatchSize = 32;
   };
 
   VkResult     init(const InitInfo& createInfo);
@@ -125,6 +139,7 @@ public:
   };
 
   // current report on memory consumption
+  // in concurrent mode requestedSize counts cached sub-allocations at their size class
   Report getReport() const;
 
   // sub allocate
@@ -142,10 +157,89 @@ public:
   // and will just return a zeroed output
   BufferRange subRange(const BufferSubAllocation& subAllocation) const;
 
+  // Concurrent mode (InitInfo::concurrentThreads > 0):
+  //
+  // `subAllocateConcurrent` and `subFreeConcurrent` can be called from any
+  // thread with a `threadIndex` < concurrentThreads that no other thread uses
+  // concurrently (e.g. the one nvutils::parallel_batches_pooled provides).
+  // Small sub-allocations come from a per-thread cache of size classes,
+  // which refills from the blocks a batch at a time, so the internal mutex
+  // is taken once per batch rather than per call. Freed small sub-allocations
+  // go into the cache of the freeing thread, which needn't be the one that
+  // allocated them; larger ones are deferred and freed a batch at a time.
+  //
+  // In this mode `subAllocate`, `subFree` and `getReport` take the mutex as
+  // well and can be called from any thread. Sub-allocations must be freed
+  // with the function matching the one that allocated them.
+  // `subRange` needs no lock, as m_blocks is reserved up front.
+  //
+  // `flushConcurrentCaches` returns all cached sub-allocations and deferred
+  // frees to the blocks; it must not run concurrently with the other
+  // concurrent calls. Call it before `cmdDefragment`, or blocks that hold
+  // cached sub-allocations aren't compacted.
+  VkResult subAllocateConcurrent(uint32_t             threadIndex,
+                                 BufferSubAllocation& subAllocation,
+                                 VkDeviceSize         size,
+                                 uint32_t             alignment = DEFAULT_ALIGNMENT);
+  void     subFreeConcurrent(uint32_t threadIndex, BufferSubAllocation& subAllocation);
+  void     flushConcurrentCaches();
+
+  struct DefragmentInfo
+  {
+    // The sub-allocations that may be moved. A block is only compacted if all
+    // of its live sub-allocations are passed here, as the allocator doesn't
+    // keep track of them itself.
+    std::span<BufferSubAllocation* const> subAllocations;
+
+    // Blocks whose live sub-allocations take up more than this fraction
+    // of blockSize are left in place.
+    float maxBlockOccupancy = 0.5f;
+
+    // Called for each moved sub-allocation after its handle was updated,
+    // with its index in `subAllocations` and its old and new range; e.g. to
+    // update descriptors or device addresses that refer to it.
+    // The old range stays valid until the old block is released.
+    std::function<void(size_t index, const BufferRange& oldRange, const BufferRange& newRange)> onMoved;
+
+    // Signaled once the command buffer has completed. The old blocks are
+    // destroyed by `releaseDefragmented` after that.
+    SemaphoreState semaphoreState;
+  };
+
+  struct DefragmentStats
+  {
+    uint32_t     movedSubAllocations{};
+    VkDeviceSize movedSize{};
+    uint32_t     releasedBlocks{};
+    uint32_t     createdBlocks{};
+  };
+
+  // Compacts the sub-allocations of fragmented blocks into fewer new blocks:
+  // plans the moves with nvutils::planCompaction, creates the new blocks,
+  // records the copies into `cmd` and updates the handles. The emptied
+  // blocks are retired, and destroyed by `releaseDefragmented`.
+  //
+  // Blocks with sub-allocations that aren't part of `info.subAllocations`
+  // and dedicated blocks are never moved. Does nothing if compaction
+  // wouldn't free any block.
+  //
+  // `cmd` starts with a barrier that waits for all prior memory writes
+  // and ends with one that makes the copies visible to all later commands.
+  VkResult cmdDefragment(VkCommandBuffer cmd, const DefragmentInfo& info, DefragmentStats* stats = nullptr);
+
+  // Destroys the blocks retired by `cmdDefragment` whose semaphore state
+  // signaled, or that had none. `forceAll` destroys all of them.
+  void releaseDefragmented(bool forceAll = false);
+
 protected:
   static constexpr uint32_t INVALID_BLOCK_INDEX = ~0u;
 
-  VkResult createNewBuffer(nvvk::Buffer& buffer, VkDeviceSize size, uint32_t alignment, uint32_t blockIndex);
+  // The block buffers. virtual so that derived classes can back blocks by
+  // different means, e.g. host memory in tests.
+  virtual VkResult createNewBuffer(nvvk::Buffer& buffer, VkDeviceSize size, uint32_t alignment, uint32_t blockIndex);
+  virtual void     destroyBlockBuffer(nvvk::Buffer& buffer);
+  // largest buffer createNewBuffer supports
+  virtual VkDeviceSize getMaxBufferSize() const;
 
   uint32_t acquireBlockIndex();
 
@@ -184,11 +278,59 @@ protected:
     // double linked list of blocks that are active
     // list head
     uint32_t activeBlockIndex = INVALID_BLOCK_INDEX;
+
+    // concurrent mode: largest size in OffsetAllocator units served by the caches
+    uint32_t maxCachedUnits = 0;
   };
 
-  InitInfo           m_info;
-  State              m_state;
-  std::vector<Block> m_blocks;
+  // removes a block that has an OffsetAllocator from the active list
+  void unlinkActiveBlock(uint32_t blockIndex);
+
+  // unlocked versions of subAllocate / subFree
+  VkResult subAllocateInternal(BufferSubAllocation& subAllocation, VkDeviceSize size, uint32_t alignment);
+  void     subFreeInternal(BufferSubAllocation& subAllocation);
+
+  // size in OffsetAllocator units, including the safety margin for the alignment
+  uint32_t getAllocatorUnits(VkDeviceSize size, uint32_t alignment) const;
+  // sub allocates from the active blocks, or a new one
+  VkResult allocateFromBlocks(uint32_t allocatorUnits, OffsetAllocator::Allocation& allocation, uint32_t& blockIndex);
+  // frees and releases the block if it became empty
+  void freeFromBlock(const OffsetAllocator::Allocation& allocation, uint32_t blockIndex);
+
+  struct CachedAllocation
+  {
+    OffsetAllocator::Allocation allocation;
+    uint32_t                    block{};
+    // subtracted from State::allocatedSize when returned to the block
+    uint32_t size{};
+  };
+
+  // padded to avoid false sharing between threads
+  struct alignas(64) ThreadCache
+  {
+    // index is log2 of the size in OffsetAllocator units
+    std::vector<std::vector<CachedAllocation>> sizeClasses;
+    std::vector<CachedAllocation>              deferredFrees;
+  };
+
+  static uint32_t getSizeClass(uint32_t allocatorUnits);
+  // must hold m_mutex
+  void processDeferredFrees(ThreadCache& cache);
+
+  struct RetiredBlock
+  {
+    nvvk::Buffer   buffer;
+    SemaphoreState semaphoreState;
+  };
+
+  InitInfo                  m_info;
+  State                     m_state;
+  std::vector<Block>        m_blocks;
+  std::vector<RetiredBlock> m_retiredBlocks;
+
+  // concurrent mode
+  mutable std::mutex       m_mutex;
+  std::vector<ThreadCache> m_threadCaches;
 };
 
 }  // namespace nvvk
@@ -23,9 +23,11 @@
  *  sampling the environment. 
  */
 
+#include <algorithm>
 #include <array>
 #include <numeric>
 #include <limits>
+#include <span>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
@@ -33,10 +35,12 @@
 #include "nvshaders/slang_types.h"
 #include "nvshaders/hdr_io.h.slang"
 
+#include <nvutils/file_mapping.hpp>
 #include <nvutils/file_operations.hpp>
 #include <nvutils/logger.hpp>
+#include <nvutils/parallel_work.hpp>
+#include <nvutils/rgbe_decode.hpp>
 #include <nvutils/timers.hpp>
-#include <stb/stb_image.h>
 
 #include "check_error.hpp"
 #include "debug_util.hpp"
@@ -46,11 +50,13 @@
 #include "mipmaps.hpp"
 #include "staging.hpp"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace nvvk {
-// Forward declaration
-std::vector<shaderio::EnvAccel> createEnvironmentAccel(float*& pixels, const uint32_t& width, const uint32_t& height, float& average, float& integral);
-
 
 //--------------------------------------------------------------------------------------------------
 //
@@ -84,83 +90,57 @@ void HdrIbl::loadEnvironment(VkCommandBuffer cmd, nvvk::StagingUploader& staging
 
   m_valid = !hdrImage.empty();
 
-  int32_t     width{0};
-  int32_t     height{0};
-  int32_t     component{0};
-  std::string fileContents;
-  float*      pixels = nullptr;
-  if(m_valid)
+  // Map the file instead of reading it into memory; this also avoids text encoding issues with file names
+  nvutils::FileReadMapping fileMapping;
+  EnvironmentImage         envImage;
+  if(m_valid && !fileMapping.open(hdrImage))
   {
-    // Read the contents into memory so that we don't have to worry about text
-    // encoding in the stbi filename API
-    fileContents = nvutils::loadFile(hdrImage);
-    if(fileContents.empty())
-    {
-      LOGW("File does not exist or is empty: %s\n", nvutils::utf8FromPath(hdrImage).c_str());
-      m_valid = false;
-    }
-    else if(fileContents.size() > std::numeric_limits<int>::max())
-    {
-      LOGW("File is too large for stb_image to load: %s\n", nvutils::utf8FromPath(hdrImage).c_str());
-      m_valid = false;
-    }
+    LOGW("File does not exist or could not be opened: %s\n", nvutils::utf8FromPath(hdrImage).c_str());
+    m_valid = false;
   }
 
   if(m_valid)
   {
-    const stbi_uc* fileData = reinterpret_cast<const stbi_uc*>(fileContents.data());
-    const int      fileSize = static_cast<int>(fileContents.size());
-
-    if(!stbi_is_hdr_from_memory(fileData, fileSize))
+    const std::span<const char> fileData(static_cast<const char*>(fileMapping.data()), fileMapping.size());
+    if(!nvutils::isRgbe(fileData))
     {
       LOGW("File is not HDR: %s\n", nvutils::utf8FromPath(hdrImage).c_str());
       m_valid = false;
     }
     else
     {
-      nvutils::ScopedTimer st("Load image");
-      pixels = stbi_loadf_from_memory(fileData, fileSize, &width, &height, &component, STBI_rgb_alpha);
-      if(!pixels)
+      // Decoding and creating the importance sampling for the HDR, in one pass
+      nvutils::ScopedTimer st("Load image and generate acceleration structure");
+      if(nvutils::RgbeError error = decodeEnvironment(fileData, envImage))
       {
-        LOGW("stbi_loadf_from_memory failed: %s\n", nvutils::utf8FromPath(hdrImage).c_str());
+        LOGW("Could not decode %s: %s\n", nvutils::utf8FromPath(hdrImage).c_str(), error->c_str());
         m_valid = false;
       }
     }
+    fileMapping.close();
   }
 
   if(m_valid)
   {
-    assert(pixels);
-    VkDeviceSize buffer_size = width * height * 4 * sizeof(float);
-    VkExtent2D   imgSize{static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
-
+    VkExtent2D imgSize{envImage.width, envImage.height};
     m_hdrImageSize = imgSize;
+    m_average      = envImage.average;
+    m_integral     = envImage.integral;
 
-    VkFormat          format    = VK_FORMAT_R32G32B32A32_SFLOAT;
     VkImageCreateInfo imageInfo = DEFAULT_VkImageCreateInfo;
     imageInfo.extent            = {imgSize.width, imgSize.height, 1};
-    imageInfo.format            = format;
+    imageInfo.format            = envImage.format;
     imageInfo.usage     = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
     imageInfo.mipLevels = enableMipmaps ? nvvk::mipLevels(imgSize) : 1;
 
-    {
-      nvutils::ScopedTimer st("Generating Acceleration structure");
-      {
-        // Creating the importance sampling for the HDR and storing the info in the m_accelImpSmpl buffer
-        std::vector<shaderio::EnvAccel> envAccel =
-            createEnvironmentAccel(pixels, imgSize.width, imgSize.height, m_average, m_integral);
-
-        NVVK_CHECK(m_alloc->createBuffer(m_accelImpSmpl, std::span(envAccel).size_bytes(), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT));
-        NVVK_CHECK(staging.appendBuffer(m_accelImpSmpl, 0, std::span(envAccel)));
-        NVVK_DBG_NAME(m_accelImpSmpl.buffer);
-
-        NVVK_CHECK(m_alloc->createImage(m_texHdr, imageInfo, DEFAULT_VkImageViewCreateInfo));
-        NVVK_CHECK(staging.appendImage(m_texHdr, std::span(pixels, buffer_size / sizeof(float)), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
-        NVVK_DBG_NAME(m_texHdr.image);
-      }
-    }
+    // Storing the importance sampling info in the m_accelImpSmpl buffer
+    NVVK_CHECK(m_alloc->createBuffer(m_accelImpSmpl, std::span(envImage.accel).size_bytes(), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT));
+    NVVK_CHECK(staging.appendBuffer(m_accelImpSmpl, 0, std::span(envImage.accel)));
+    NVVK_DBG_NAME(m_accelImpSmpl.buffer);
 
-    stbi_image_free(pixels);
+    NVVK_CHECK(m_alloc->createImage(m_texHdr, imageInfo, DEFAULT_VkImageViewCreateInfo));
+    NVVK_CHECK(staging.appendImage(m_texHdr, std::span(envImage.texels), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    NVVK_DBG_NAME(m_texHdr.image);
   }
   else
   {  // Create a Dummy image and buffer, such that the code can still run
@@ -241,79 +221,178 @@ void HdrIbl::createDescriptorSetLayout()
 // This will later allow the sampling shader to uniformly select a texel in the environment, and
 // select either that texel or its alias depending on their relative intensities
 //
-inline static float buildAliasmap(const std::vector<float>& data, std::vector<shaderio::EnvAccel>& accel)
+// `data` is the emitted radiance of each texel, already weighted by its solid angle, and `sum` its
+// integral. Any table in which each texel keeps its ratio q to the average, and gives 1 - q to its
+// alias, samples texels proportionally to `data`; the table built here differs from a sequential
+// sweep only in which higher-energy texel each lower-energy texel is associated to.
+//
+static void buildAliasmap(std::span<const float> data, double sum, std::vector<shaderio::EnvAccel>& accel)
 {
-  auto size = static_cast<uint32_t>(data.size());
+  // Texels are processed in blocks; the lower-energy texels of each block are associated in parallel
+  constexpr uint64_t kBlockSize = 65536;
 
-  // Compute the integral of the emitted radiance of the environment map
-  // Since each element in data is already weighted by its solid angle
-  // the integral is a simple sum
-  float sum = std::accumulate(data.begin(), data.end(), 0.F);
-  if(sum == 0.0f)
-  {
-    sum = 1.0f;
-  }
+  const uint64_t size       = data.size();
+  const uint64_t blockCount = (size + kBlockSize - 1) / kBlockSize;
 
   // For each texel, compute the ratio q between the emitted radiance of the texel and the average
   // emitted radiance over the entire sphere
   // We also initialize the aliases to identity, ie. each texel is its own alias
-  auto  f_size          = static_cast<float>(size);
-  float inverse_average = f_size / sum;
-  for(uint32_t i = 0; i < size; ++i)
+  // Per block, count the texels with a value q < 1 (ie. below average) and sum by how much they are
+  // below average (their deficit); and sum by how much the others are above average (their excess).
+  const float           inverse_average = static_cast<float>(static_cast<double>(size) / sum);
+  std::vector<uint64_t> block_small_count(blockCount + 1, 0);
+  std::vector<double>   block_deficit(blockCount + 1, 0.0);
+  std::vector<double>   block_excess(blockCount + 1, 0.0);
+  nvutils::parallel_batches<1>(blockCount, [&](uint64_t block) {
+    uint64_t small_count = 0;
+    double   deficit     = 0.0;
+    double   excess      = 0.0;
+    for(uint64_t i = block * kBlockSize; i < std::min(size, (block + 1) * kBlockSize); ++i)
+    {
+      const float q  = data[i] * inverse_average;
+      accel[i].q     = q;
+      accel[i].alias = static_cast<uint32_t>(i);
+      if(q < 1.F)
+      {
+        small_count++;
+        deficit += 1.0 - q;
+      }
+      else
+      {
+        excess += q - 1.0;
+      }
+    }
+    block_small_count[block] = small_count;
+    block_deficit[block]     = deficit;
+    block_excess[block]      = excess;
+  });
+
+  // Turn the block values into exclusive prefix sums
+  uint64_t small_total = 0;
+  double   deficit_sum = 0.0;
+  double   excess_sum  = 0.0;
+  for(uint64_t block = 0; block <= blockCount; ++block)
   {
-    accel[i].q     = data[i] * inverse_average;
-    accel[i].alias = i;
+    const uint64_t count   = block_small_count[block];
+    const double   deficit = block_deficit[block];
+    const double   excess  = block_excess[block];
+    block_small_count[block] = small_total;
+    block_deficit[block]     = deficit_sum;
+    block_excess[block]      = excess_sum;
+    small_total += count;
+    deficit_sum += deficit;
+    excess_sum += excess;
   }
-
-  // Partition the texels according to their emitted radiance ratio wrt. average.
-  // Texels with a value q < 1 (ie. below average) are stored incrementally from the beginning of the
-  // array, while texels emitting higher-than-average radiance are stored from the end of the array
-  std::vector<uint32_t> partition_table(size);
-  uint32_t              s     = 0U;
-  uint32_t              large = size;
-  for(uint32_t i = 0; i < size; ++i)
+  const uint64_t large_total = size - small_total;
+  if(small_total == 0 || large_total == 0)
   {
-    if(accel[i].q < 1.F)
-      partition_table[s++] = i;
-    else
-      partition_table[--large] = i;
+    return;
   }
 
+  // Partition the texels according to their emitted radiance ratio wrt. average, keeping their order:
+  // lower-energy texels are stored at the beginning of the table, higher-energy ones after them
+  std::vector<uint32_t> partition_table(size);
+  const auto            small_texels = std::span(partition_table).first(small_total);
+  const auto            large_texels = std::span(partition_table).subspan(small_total);
+  nvutils::parallel_batches<1>(blockCount, [&](uint64_t block) {
+    uint64_t small = block_small_count[block];
+    uint64_t large = block * kBlockSize - small;
+    for(uint64_t i = block * kBlockSize; i < std::min(size, (block + 1) * kBlockSize); ++i)
+    {
+      if(accel[i].q < 1.F)
+        small_texels[small++] = static_cast<uint32_t>(i);
+      else
+        large_texels[large++] = static_cast<uint32_t>(i);
+    }
+  });
+
   // Associate the lower-energy texels to higher-energy ones. Since the emission of a high-energy texel may
-  // be vastly superior to the average,
-  for(s = 0; s < large && large < size; ++s)
-  {
-    // Index of the smaller energy texel
-    const uint32_t small_energy_index = partition_table[s];
-
-    // Index of the higher energy texel
-    const uint32_t high_energy_index = partition_table[large];
-
-    // Associate the texel to its higher-energy alias
-    accel[small_energy_index].alias = high_energy_index;
-
-    // Compute the difference between the lower-energy texel and the average
-    const float difference_with_average = 1.F - accel[small_energy_index].q;
-
-    // The goal is to obtain texel couples whose combined intensity is close to the average.
-    // However, some texels may have low energies, while others may have very high intensity
-    // (for example a sunset: the sky is quite dark, but the sun is still visible). In this case
-    // it may not be possible to obtain a value close to average by combining only two texels.
-    // Instead, we potentially associate a single high-energy texel to many smaller-energy ones until
-    // the combined average is similar to the average of the environment map.
-    // We keep track of the combined average by subtracting the difference between the lower-energy texel and the average
-    // from the ratio stored in the high-energy texel.
-    accel[high_energy_index].q -= difference_with_average;
-
-    // If the combined ratio to average of the higher-energy texel reaches 1, a balance has been found
-    // between a set of low-energy texels and the higher-energy one. In this case, we will use the next
-    // higher-energy texel in the partition when processing the next texel.
-    if(accel[high_energy_index].q < 1.0F)
+  // be vastly superior to the average, a single high-energy texel may be associated to many smaller-energy
+  // ones until the combined average is similar to the average of the environment map.
+  // Laying out the deficits of the lower-energy texels and the excesses of the higher-energy ones one after
+  // another, each lower-energy texel is associated to the higher-energy texel whose excess contains the
+  // start of its deficit. The blocks can then start independently, from prefix sums: block b starts with
+  // the higher-energy texel `block_first_large[b]`, of which `block_first_excess[b]` is left.
+  auto excessOf = [&](uint32_t texel) { return static_cast<double>(data[texel] * inverse_average) - 1.0; };
+
+  std::vector<uint64_t> block_first_large(blockCount);
+  std::vector<double>   block_first_excess(blockCount);
+  nvutils::parallel_batches<1>(blockCount, [&](uint64_t block) {
+    const double start = block_deficit[block];
+    // Block of the texels whose excesses contain `start`
+    uint64_t large_block = std::upper_bound(block_excess.begin(), block_excess.end(), start) - block_excess.begin();
+    large_block          = std::min(large_block, blockCount) - 1;
+
+    uint64_t large     = large_block * kBlockSize - block_small_count[large_block];
+    double   end_value = block_excess[large_block];
+    for(; large < large_total; ++large)
+    {
+      end_value += excessOf(large_texels[large]);
+      if(end_value > start)
+        break;
+    }
+    large                     = std::min(large, large_total - 1);
+    block_first_large[block]  = large;
+    block_first_excess[block] = end_value - start;
+  });
+
+  nvutils::parallel_batches<1>(blockCount, [&](uint64_t block) {
+    uint64_t small     = block_small_count[block];
+    uint64_t small_end = block_small_count[block + 1];
+    if(small == small_end)
+      return;
+
+    // The higher-energy texels before the one the next block starts with are this block's to complete; the
+    // last block leaves the remaining ones as they are.
+    uint64_t next_block = block + 1;
+    while(next_block < blockCount && block_small_count[next_block] == block_small_count[next_block + 1])
+    {
+      next_block++;
+    }
+    const bool     last_block = next_block == blockCount;
+    const uint64_t large_end  = last_block ? large_total - 1 : block_first_large[next_block];
+
+    uint64_t large      = block_first_large[block];
+    uint32_t high_index = large_texels[large];
+    double   excess     = block_first_excess[block];
+
+    // When the excess of a higher-energy texel is used up, it becomes a lower-energy texel itself: it keeps
+    // what is left of its ratio to average, and is associated to the next higher-energy texel.
+    auto nextLarge = [&]() {
+      accel[high_index].q     = static_cast<float>(std::clamp(1.0 + excess, 0.0, 1.0));
+      accel[high_index].alias = large_texels[large + 1];
       large++;
-  }
-  // Return the integral of the emitted radiance. This integral will be used to normalize the probability
-  // distribution function (PDF) of each pixel
-  return sum;
+      high_index = large_texels[large];
+      excess += excessOf(high_index);
+    };
+
+    for(; small < small_end; ++small)
+    {
+      // Index of the smaller energy texel
+      const uint32_t small_energy_index = small_texels[small];
+
+      // Associate the texel to its higher-energy alias
+      accel[small_energy_index].alias = high_index;
+
+      // Keep track of the combined average by subtracting the difference between the lower-energy texel and
+      // the average from the excess of the higher-energy texel
+      excess -= 1.0 - accel[small_energy_index].q;
+
+      // If the combined ratio to average of the higher-energy texel reaches 1, a balance has been found
+      // between a set of low-energy texels and the higher-energy one. In this case, we will use the next
+      // higher-energy texel in the partition when processing the next texel.
+      while(excess < 0.0 && large < large_end)
+      {
+        nextLarge();
+      }
+    }
+
+    // Only rounding leaves higher-energy texels before the next block's first one
+    while(!last_block && large < large_end)
+    {
+      nextLarge();
+    }
+  });
 }
 
 // CIE luminance
@@ -323,69 +402,257 @@ inline static float luminance(const float* color)
 }
 
 //--------------------------------------------------------------------------------------------------
-// Create acceleration data for importance sampling
-// See:  https://arxiv.org/pdf/1901.05423.pdf
-// And store the PDF into the ALPHA channel of pixels
+// For each texel of a row, stores max(r, g, b) into its alpha channel and `area` times that into
+// `importance`; returns the sum of the CIE luminances of the texels.
 //
-inline std::vector<shaderio::EnvAccel> createEnvironmentAccel(float*&         pixels,
-                                                              const uint32_t& width,
-                                                              const uint32_t& height,
-                                                              float&          average,
-                                                              float&          integral)
+static double processEnvironmentRow(float* rgba, float* importance, uint32_t width, float area)
 {
-  const uint32_t rx = width;
-  const uint32_t ry = height;
-
-  // Create importance sampling data
-  std::vector<shaderio::EnvAccel> env_accel(rx * ry);
-  std::vector<float>              importance_data(rx * ry);
-  float                           cos_theta0 = 1.0F;
-  const float                     step_phi   = glm::two_pi<float>() / static_cast<float>(rx);
-  const float                     step_theta = glm::pi<float>() / static_cast<float>(ry);
-  double                          total      = 0.0;
-
-  // For each texel of the environment map, we compute the related solid angle
-  // subtended by the texel, and store the weighted luminance in importance_data,
-  // representing the amount of energy emitted through each texel.
-  // Also compute the average CIE luminance to drive the tonemapping of the final image
-  for(uint32_t y = 0; y < ry; ++y)
+  uint32_t x   = 0;
+  double   sum = 0.0;
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  const __m128 area4 = _mm_set1_ps(area);
+  __m128       sum4  = _mm_setzero_ps();
+  for(; x + 4 <= width; x += 4)
+  {
+    __m128 r = _mm_loadu_ps(rgba + x * 4 + 0);
+    __m128 g = _mm_loadu_ps(rgba + x * 4 + 4);
+    __m128 b = _mm_loadu_ps(rgba + x * 4 + 8);
+    __m128 a = _mm_loadu_ps(rgba + x * 4 + 12);
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    a = _mm_max_ps(r, _mm_max_ps(g, b));
+    _mm_storeu_ps(importance + x, _mm_mul_ps(a, area4));
+    sum4 = _mm_add_ps(sum4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(0.2126F)), _mm_mul_ps(g, _mm_set1_ps(0.7152F))),
+                                       _mm_mul_ps(b, _mm_set1_ps(0.0722F))));
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    _mm_storeu_ps(rgba + x * 4 + 0, r);
+    _mm_storeu_ps(rgba + x * 4 + 4, g);
+    _mm_storeu_ps(rgba + x * 4 + 8, b);
+    _mm_storeu_ps(rgba + x * 4 + 12, a);
+  }
+  alignas(16) float sums[4];
+  _mm_store_ps(sums, sum4);
+  sum = double(sums[0]) + double(sums[1]) + double(sums[2]) + double(sums[3]);
+#elif defined(__ARM_NEON)
+  float32x4_t sum4 = vdupq_n_f32(0.0F);
+  for(; x + 4 <= width; x += 4)
+  {
+    float32x4x4_t texels = vld4q_f32(rgba + x * 4);
+    texels.val[3]        = vmaxq_f32(texels.val[0], vmaxq_f32(texels.val[1], texels.val[2]));
+    vst1q_f32(importance + x, vmulq_n_f32(texels.val[3], area));
+    sum4 = vmlaq_n_f32(sum4, texels.val[0], 0.2126F);
+    sum4 = vmlaq_n_f32(sum4, texels.val[1], 0.7152F);
+    sum4 = vmlaq_n_f32(sum4, texels.val[2], 0.0722F);
+    vst4q_f32(rgba + x * 4, texels);
+  }
+  sum = double(vgetq_lane_f32(sum4, 0)) + double(vgetq_lane_f32(sum4, 1)) + double(vgetq_lane_f32(sum4, 2))
+        + double(vgetq_lane_f32(sum4, 3));
+#endif
+  for(; x < width; ++x)
   {
-    const float theta1     = static_cast<float>(y + 1) * step_theta;
-    const float cos_theta1 = std::cos(theta1);
+    float* texel  = rgba + x * 4;
+    texel[3]      = std::max(texel[0], std::max(texel[1], texel[2]));
+    importance[x] = area * texel[3];
+    sum += luminance(texel);
+  }
+  return sum;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Importance of the texels of an environment, gathered row by row, so that rows can be processed in
+// any order and in parallel, e.g. while they are being decoded
+//
+class EnvironmentImportance
+{
+public:
+  EnvironmentImportance(uint32_t width, uint32_t height)
+      : m_width(width)
+      , m_height(height)
+      , m_importance(size_t(width) * height)
+      , m_rowLuminance(height)
+      , m_rowImportance(height)
+  {
+  }
+
+  // For each texel of the row, we compute the related solid angle subtended by the texel, and store
+  // the weighted luminance in m_importance, representing the amount of energy emitted through each
+  // texel; max(r, g, b) goes into the alpha channel.
+  // Also sum the CIE luminance to drive the tonemapping of the final image
+  void addRow(uint32_t y, float* rgba)
+  {
+    const float step_phi   = glm::two_pi<float>() / static_cast<float>(m_width);
+    const float step_theta = glm::pi<float>() / static_cast<float>(m_height);
+    const float cos_theta0 = y == 0 ? 1.0F : std::cos(static_cast<float>(y) * step_theta);
+    const float cos_theta1 = std::cos(static_cast<float>(y + 1) * step_theta);
     const float area       = (cos_theta0 - cos_theta1) * step_phi;  // solid angle
-    cos_theta0             = cos_theta1;
 
-    for(uint32_t x = 0; x < rx; ++x)
-    {
-      const uint32_t idx           = y * rx + x;
-      const uint32_t idx4          = idx * 4;
-      float          cie_luminance = luminance(&pixels[idx4]);
-      importance_data[idx]         = area * std::max(pixels[idx4], std::max(pixels[idx4 + 1], pixels[idx4 + 2]));
-      total += cie_luminance;
-    }
+    float* row_importance = m_importance.data() + size_t(y) * m_width;
+    m_rowLuminance[y]     = processEnvironmentRow(rgba, row_importance, m_width, area);
+    m_rowImportance[y]    = std::accumulate(row_importance, row_importance + m_width, 0.0,
+                                            [](double sum, float v) { return sum + v; });
+  }
+
+  double getAverage() const
+  {
+    return std::accumulate(m_rowLuminance.begin(), m_rowLuminance.end(), 0.0) / (double(m_width) * double(m_height));
   }
 
-  average = static_cast<float>(total) / static_cast<float>(rx * ry);
+  // Compute the integral of the emitted radiance of the environment map
+  // Since each element in data is already weighted by its solid angle
+  // the integral is a simple sum
+  double getIntegral() const
+  {
+    const double sum = std::accumulate(m_rowImportance.begin(), m_rowImportance.end(), 0.0);
+    return sum == 0.0 ? 1.0 : sum;
+  }
 
   // Build the alias map, which aims at creating a set of texel couples
   // so that all couples emit roughly the same amount of energy. To this aim,
   // each smaller radiance texel will be assigned an "alias" with higher emitted radiance
-  // As a byproduct this function also returns the integral of the radiance emitted by the environment
-  integral = buildAliasmap(importance_data, env_accel);
-  if(integral == 0.0f)
+  std::vector<shaderio::EnvAccel> buildAccel() const
   {
-    integral = 1.0f;
+    std::vector<shaderio::EnvAccel> env_accel(m_importance.size());
+    buildAliasmap(m_importance, getIntegral(), env_accel);
+    return env_accel;
   }
 
-  // We deduce the PDF of each texel by normalizing its emitted radiance by the radiance integral
+private:
+  uint32_t            m_width  = 0;
+  uint32_t            m_height = 0;
+  std::vector<float>  m_importance;
+  std::vector<double> m_rowLuminance;
+  std::vector<double> m_rowImportance;
+};
+
+//--------------------------------------------------------------------------------------------------
+// Create acceleration data for importance sampling
+// See:  https://arxiv.org/pdf/1901.05423.pdf
+// And store the PDF into the ALPHA channel of pixels
+//
+std::vector<shaderio::EnvAccel> createEnvironmentAccel(float* pixels, uint32_t width, uint32_t height, float& average, float& integral)
+{
+  EnvironmentImportance importance(width, height);
+  nvutils::parallel_batches<8>(height, [&](uint64_t y) { importance.addRow(uint32_t(y), pixels + y * width * 4); });
+
+  std::vector<shaderio::EnvAccel> env_accel = importance.buildAccel();
+
+  // Return the integral of the emitted radiance. This integral will be used to normalize the probability
+  // distribution function (PDF) of each pixel
+  average  = static_cast<float>(importance.getAverage());
+  integral = static_cast<float>(importance.getIntegral());
+
+  // We deduce the PDF of each texel by normalizing its emitted radiance, which addRow() stored in the
+  // alpha channel, by the radiance integral
   const float inv_env_integral = 1.0F / integral;
-  for(uint32_t i = 0; i < rx * ry; ++i)
+  nvutils::parallel_batches<8>(height, [&](uint64_t y) {
+    float* row = pixels + y * width * 4;
+    for(uint32_t x = 0; x < width; ++x)
+    {
+      row[x * 4 + 3] *= inv_env_integral;
+    }
+  });
+
+  return env_accel;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Decode a Radiance RGBE file and create its acceleration data in the same pass
+//
+nvutils::RgbeError decodeEnvironment(std::span<const char> file, EnvironmentImage& image)
+{
+  nvutils::RgbeImage rgbe;
+  if(nvutils::RgbeError error = nvutils::parseRgbe(file, rgbe))
   {
-    const uint32_t idx4 = i * 4;
-    pixels[idx4 + 3]    = std::max(pixels[idx4], std::max(pixels[idx4 + 1], pixels[idx4 + 2])) * inv_env_integral;
+    return error;
   }
 
-  return env_accel;
+  const uint32_t width  = rgbe.width;
+  const uint32_t height = rgbe.height;
+  image                 = {.width = width, .height = height};
+
+  // Decodes into image.texels while building the importance, and returns whether the values and PDFs fit
+  // into half floats: not if one is too large for them, or a PDF too small to keep 8 bits of precision
+  // as a half subnormal
+  auto decode = [&](nvutils::RgbeTarget target, bool& fitsHalf) -> nvutils::RgbeError {
+    EnvironmentImportance importance(width, height);
+    std::vector<float>    row_max(height, 0.0F);
+    std::vector<float>    row_min(height, std::numeric_limits<float>::infinity());  // Of the non-zero values
+    image.texels = {};
+    image.texels.resize(nvutils::rgbeDecodedSizeBytes(target, width, height));
+    image.format = target == nvutils::RgbeTarget::eRGBA16F ? VK_FORMAT_R16G16B16A16_SFLOAT : VK_FORMAT_R32G32B32A32_SFLOAT;
+
+    nvutils::RgbeError error = nvutils::decodeRgbe(file, rgbe, target, image.texels, [&](uint32_t y, float* rgba) {
+      importance.addRow(y, rgba);
+      for(uint32_t x = 0; x < width; ++x)
+      {
+        const float value = rgba[x * 4 + 3];
+        row_max[y]        = std::max(row_max[y], value);
+        row_min[y]        = value > 0.0F ? std::min(row_min[y], value) : row_min[y];
+      }
+    });
+    if(error)
+    {
+      return error;
+    }
+
+    image.average  = static_cast<float>(importance.getAverage());
+    image.integral = static_cast<float>(importance.getIntegral());
+
+    constexpr float kHalfMax    = 65504.0F;
+    constexpr float kHalfMinPdf = 1.0F / 131072.0F;  // 2^-17
+    const float     max         = *std::max_element(row_max.begin(), row_max.end());
+    const float     min         = *std::min_element(row_min.begin(), row_min.end());
+    fitsHalf = max <= kHalfMax && max / image.integral <= kHalfMax && !(min / image.integral < kHalfMinPdf);
+    if(target == nvutils::RgbeTarget::eRGBA32F || fitsHalf)
+    {
+      image.accel = importance.buildAccel();
+    }
+    return {};
+  };
+
+  bool fitsHalf = false;
+  if(nvutils::RgbeError error = decode(nvutils::RgbeTarget::eRGBA16F, fitsHalf))
+  {
+    return error;
+  }
+  if(!fitsHalf)
+  {
+    if(nvutils::RgbeError error = decode(nvutils::RgbeTarget::eRGBA32F, fitsHalf))
+    {
+      return error;
+    }
+  }
+
+  // We deduce the PDF of each texel by normalizing its emitted radiance, which addRow() stored in the
+  // alpha channel, by the radiance integral
+  const float inv_env_integral = 1.0F / image.integral;
+  if(image.format == VK_FORMAT_R32G32B32A32_SFLOAT)
+  {
+    float* pixels = reinterpret_cast<float*>(image.texels.data());
+    nvutils::parallel_batches<8>(height, [&](uint64_t y) {
+      float* row = pixels + y * width * 4;
+      for(uint32_t x = 0; x < width; ++x)
+      {
+        row[x * 4 + 3] *= inv_env_integral;
+      }
+    });
+  }
+  else
+  {
+    uint16_t*                       halves = reinterpret_cast<uint16_t*>(image.texels.data());
+    std::vector<std::vector<float>> rows(nvutils::get_thread_pool().get_thread_count());
+    nvutils::parallel_batches_pooled<8>(height, [&](uint64_t y, uint32_t threadIndex) {
+      std::vector<float>& row = rows[threadIndex];
+      row.resize(size_t(width) * 4);
+      nvutils::halfToFloat(halves + y * width * 4, row.size(), row.data());
+      for(uint32_t x = 0; x < width; ++x)
+      {
+        row[x * 4 + 3] *= inv_env_integral;
+      }
+      nvutils::floatToHalf(row.data(), row.size(), halves + y * width * 4);
+    });
+  }
+
+  return {};
 }
 
 }  // namespace nvvk
@@ -29,6 +29,9 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "nvshaders/hdr_io.h.slang"
+#include "nvutils/rgbe_decode.hpp"
+
 #include "descriptors.hpp"
 #include "resource_allocator.hpp"
 #include "sampler_pool.hpp"
@@ -89,4 +92,49 @@ private:
   void createDescriptorSetLayout();
 };
 
+/*-------------------------------------------------------------------------------------------------
+# Function nvvk::createEnvironmentAccel
+
+Builds the importance sampling data of an equirectangular RGBA32F environment
+on the CPU; HdrIbl::loadEnvironment uploads it as the `eImpSamples` buffer.
+
+Returns an alias table with one entry per texel, with which the shaders pick
+texels proportionally to their maximum component times their solid angle, and
+stores the PDF of each texel in its alpha channel. `average` receives the
+average CIE luminance and `integral` the integral of the importance.
+
+Rows are processed in parallel and with SSE or NEON where available, and the
+alias table is built in blocks of texels that are independent of each other.
+
+```cpp
+float average, integral;
+std::vector<shaderio::EnvAccel> accel = nvvk::createEnvironmentAccel(rgba, width, height, average, integral);
+```
+-------------------------------------------------------------------------------------------------*/
+std::vector<shaderio::EnvAccel> createEnvironmentAccel(float* pixels, uint32_t width, uint32_t height, float& average, float& integral);
+
+/*-------------------------------------------------------------------------------------------------
+# Function nvvk::decodeEnvironment
+
+Decodes a Radiance RGBE (.hdr) file with nvutils::decodeRgbe and builds its
+importance sampling data in the same pass, while each scanline is in cache;
+this is what HdrIbl::loadEnvironment uses.
+
+Texels are RGBA16F, with the PDF in alpha, unless a value or PDF doesn't fit
+into half floats; the file is then decoded again into RGBA32F. `file` can be
+a nvutils::FileReadMapping, so that the file isn't read into memory first.
+-------------------------------------------------------------------------------------------------*/
+struct EnvironmentImage
+{
+  uint32_t                        width  = 0;
+  uint32_t                        height = 0;
+  VkFormat                        format = VK_FORMAT_UNDEFINED;  // R16G16B16A16_SFLOAT or R32G32B32A32_SFLOAT
+  std::vector<char>               texels;
+  std::vector<shaderio::EnvAccel> accel;
+  float                           average  = 1.F;
+  float                           integral = 1.F;
+};
+
+nvutils::RgbeError decodeEnvironment(std::span<const char> file, EnvironmentImage& image);
+
 }  // namespace nvvk
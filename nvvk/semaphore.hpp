@@ -88,6 +88,13 @@ public:
     m_dynamicValue = std::make_shared<std::atomic_uint64_t>(0);
   }
 
+  // true if both refer to the same signal operation; a copy of a dynamic
+  // state that was fixated compares unequal to copies that were not
+  inline bool operator==(const SemaphoreState& other) const
+  {
+    return m_semaphore == other.m_semaphore && m_dynamicValue == other.m_dynamicValue && m_fixedValue == other.m_fixedValue;
+  }
+
   inline bool isValid() const { return m_semaphore && (m_fixedValue != 0 || m_dynamicValue); }
   inline bool isFixed() const { return m_semaphore && (m_fixedValue != 0); }
   inline bool isDynamic() const { return m_semaphore && (m_dynamicValue); }
@@ -17,6 +17,8 @@
 * SPDX-License-Identifier: Apache-2.0
 */
 
+#include <algorithm>
+
 #include "staging.hpp"
 #include "barriers.hpp"
 #include "check_error.hpp"
@@ -76,11 +78,8 @@ nvvk::ResourceAllocator* StagingUploader::getResourceAllocator()
   return m_resourceAllocator;
 }
 
-VkResult StagingUploader::acquireStagingSpace(BufferRange& stagingSpace, size_t dataSize, const void* data, const SemaphoreState& semaphoreState)
+VkResult StagingUploader::createStagingBuffer(nvvk::Buffer& buffer, VkDeviceSize size)
 {
-  StagingResource stagingResource;
-  stagingResource.semaphoreState = semaphoreState;
-
   // VMA_MEMORY_USAGE_AUTO_PREFER_HOST staging memory is meant to not cost additional device memory
   //
   // VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT staging memory is filled sequentially
@@ -107,21 +106,31 @@ VkResult StagingUploader::acquireStagingSpace(BufferRange& stagingSpace, size_t
   VkBufferCreateInfo bufferInfo{
       .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
       .pNext       = m_resourceAllocator->usesMaintenance5() ? &bufferUsageFlags2CreateInfo : nullptr,
-      .size        = dataSize,
+      .size        = size,
       .usage       = m_resourceAllocator->usesMaintenance5() ? 0 : (VkBufferUsageFlags)usageFlags,
       .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
   };
 
   // Create a staging buffer
-  NVVK_FAIL_RETURN(m_resourceAllocator->createBuffer(stagingResource.buffer, bufferInfo, allocInfo));
-  NVVK_DBG_NAME(stagingResource.buffer.buffer);
+  NVVK_FAIL_RETURN(m_resourceAllocator->createBuffer(buffer, bufferInfo, allocInfo));
+  NVVK_DBG_NAME(buffer.buffer);
 
-  if(!stagingResource.buffer.mapping)
+  if(!buffer.mapping)
   {
-    m_resourceAllocator->destroyBuffer(stagingResource.buffer);
+    m_resourceAllocator->destroyBuffer(buffer);
     return VK_ERROR_MEMORY_MAP_FAILED;
   }
 
+  return VK_SUCCESS;
+}
+
+VkResult StagingUploader::acquireStagingSpace(BufferRange& stagingSpace, size_t dataSize, const void* data, const SemaphoreState& semaphoreState)
+{
+  StagingResource stagingResource;
+  stagingResource.semaphoreState = semaphoreState;
+
+  NVVK_FAIL_RETURN(createStagingBuffer(stagingResource.buffer, dataSize));
+
   if(data)
   {
     memcpy(stagingResource.buffer.mapping, data, dataSize);
@@ -439,8 +448,36 @@ VkResult StagingUploader::appendImageSub(nvvk::Image&                    image,
                                          VkImageLayout                   newLayout /*= VK_IMAGE_LAYOUT_UNDEFINED*/,
                                          const SemaphoreState&           semaphoreState /*= {}*/)
 {
+  void* uploadMapping = nullptr;
+  NVVK_FAIL_RETURN(appendImageSubMapping(image, offset, extent, subresource, dataSize, uploadMapping, newLayout, semaphoreState));
+  if(uploadMapping && data)
+  {
+    memcpy(uploadMapping, data, dataSize);
+  }
+  return VK_SUCCESS;
+}
+
+VkResult StagingUploader::appendImageSubMapping(nvvk::Image&                    image,
+                                                const VkOffset3D&               offset,
+                                                const VkExtent3D&               extent,
+                                                const VkImageSubresourceLayers& subresource,
+                                                size_t                          dataSize,
+                                                void*&                          uploadMapping,
+                                                VkImageLayout                   newLayout /*= VK_IMAGE_LAYOUT_UNDEFINED*/,
+                                                const SemaphoreState&           semaphoreState /*= {}*/)
+{
+  uploadMapping = nullptr;
+
+  // allow empty without throwing error
+  if(dataSize == 0)
+  {
+    return VK_SUCCESS;
+  }
+
   BufferRange stagingSpace;
-  NVVK_FAIL_RETURN(acquireStagingSpace(stagingSpace, dataSize, data, semaphoreState));
+  NVVK_FAIL_RETURN(acquireStagingSpace(stagingSpace, dataSize, nullptr, semaphoreState));
+
+  uploadMapping = stagingSpace.mapping;
 
   bool layoutAllowsCopy = image.descriptor.imageLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
                           || image.descriptor.imageLayout == VK_IMAGE_LAYOUT_GENERAL
@@ -501,6 +538,151 @@ VkResult StagingUploader::appendImageSub(nvvk::Image&                    image,
   return VK_SUCCESS;
 }
 
+VkResult StagingUploader::beginParallelAppend(size_t stagingSize, uint32_t numThreads, const SemaphoreState& semaphoreState)
+{
+  assert(!m_parallel.active && "Missing endParallelAppend()");
+  assert(numThreads);
+
+  m_parallel.stagingSpace = {};
+  if(stagingSize)
+  {
+    NVVK_FAIL_RETURN(acquireStagingSpace(m_parallel.stagingSpace, stagingSize, nullptr, semaphoreState));
+  }
+
+  m_parallel.allocator.init(stagingSize, PARALLEL_ALIGNMENT);
+  m_parallel.threads.resize(numThreads);
+  m_parallel.active = true;
+
+  return VK_SUCCESS;
+}
+
+VkResult StagingUploader::appendBufferParallel(uint32_t            threadIndex,
+                                               const nvvk::Buffer& buffer,
+                                               VkDeviceSize        bufferOffset,
+                                               VkDeviceSize        dataSize,
+                                               const void*         data)
+{
+  assert(data || dataSize == 0);
+
+  void* uploadMapping = nullptr;
+  NVVK_FAIL_RETURN(appendBufferParallelMapping(threadIndex, buffer, bufferOffset, dataSize, uploadMapping));
+  if(uploadMapping)
+  {
+    memcpy(uploadMapping, data, dataSize);
+  }
+
+  return VK_SUCCESS;
+}
+
+VkResult StagingUploader::appendBufferParallelMapping(uint32_t            threadIndex,
+                                                      const nvvk::Buffer& buffer,
+                                                      VkDeviceSize        bufferOffset,
+                                                      VkDeviceSize        dataSize,
+                                                      void*&              uploadMapping)
+{
+  assert(m_parallel.active && "Missing beginParallelAppend()");
+  assert(threadIndex < m_parallel.threads.size());
+
+  uploadMapping = nullptr;
+
+  // allow empty without throwing error
+  if(dataSize == 0)
+  {
+    return VK_SUCCESS;
+  }
+
+  if(dataSize == VK_WHOLE_SIZE)
+  {
+    dataSize = buffer.bufferSize;
+  }
+
+  assert(buffer.buffer);
+  assert(bufferOffset + dataSize <= buffer.bufferSize);
+
+  if(buffer.mapping)
+  {
+    uploadMapping = buffer.mapping + bufferOffset;
+
+    return VK_SUCCESS;
+  }
+
+  const uint64_t offset = m_parallel.allocator.reserve(dataSize);
+  if(offset == nvutils::AtomicLinearAllocator::INVALID_OFFSET)
+  {
+    return VK_ERROR_OUT_OF_POOL_MEMORY;
+  }
+
+  uploadMapping = m_parallel.stagingSpace.mapping + offset;
+
+  ParallelCopy copy{
+      .dstBuffer = buffer.buffer,
+      .region =
+          {
+              .sType     = VK_STRUCTURE_TYPE_BUFFER_COPY_2,
+              .srcOffset = m_parallel.stagingSpace.offset + offset,
+              .dstOffset = bufferOffset,
+              .size      = dataSize,
+          },
+  };
+  m_parallel.threads[threadIndex].copies.push_back(copy);
+
+  return VK_SUCCESS;
+}
+
+void StagingUploader::endParallelAppend()
+{
+  assert(m_parallel.active && "Missing beginParallelAppend()");
+  m_parallel.active = false;
+
+  std::vector<ParallelCopy>& merged = m_parallel.merged;
+  merged.clear();
+  for(ParallelThread& thread : m_parallel.threads)
+  {
+    merged.insert(merged.end(), thread.copies.begin(), thread.copies.end());
+    thread.copies.clear();
+  }
+
+  std::sort(merged.begin(), merged.end(), [](const ParallelCopy& a, const ParallelCopy& b) {
+    return a.dstBuffer != b.dstBuffer ? a.dstBuffer < b.dstBuffer : a.region.dstOffset < b.region.dstOffset;
+  });
+
+  // one copy command per destination buffer, with a region per range that
+  // is contiguous in both staging and destination memory
+  const size_t firstInfo = m_batch.copyBufferInfos.size();
+  for(const ParallelCopy& copy : merged)
+  {
+    if(m_batch.copyBufferInfos.size() > firstInfo && m_batch.copyBufferInfos.back().dstBuffer == copy.dstBuffer)
+    {
+      VkBufferCopy2& previous = m_batch.copyBufferRegions.back();
+      assert(previous.dstOffset + previous.size <= copy.region.dstOffset && "destination ranges must not overlap");
+      if(previous.srcOffset + previous.size == copy.region.srcOffset && previous.dstOffset + previous.size == copy.region.dstOffset)
+      {
+        previous.size += copy.region.size;
+      }
+      else
+      {
+        m_batch.copyBufferRegions.emplace_back(copy.region);
+        m_batch.copyBufferInfos.back().regionCount++;
+      }
+    }
+    else
+    {
+      VkCopyBufferInfo2 copyBufferInfo{
+          .sType       = VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2,
+          .srcBuffer   = m_parallel.stagingSpace.buffer,
+          .dstBuffer   = copy.dstBuffer,
+          .regionCount = 1,
+          .pRegions    = nullptr,  // set when calling `cmdUploadAppended`
+      };
+
+      m_batch.copyBufferRegions.emplace_back(copy.region);
+      m_batch.copyBufferInfos.emplace_back(copyBufferInfo);
+    }
+  }
+
+  m_batch.stagingSize += m_parallel.allocator.getReservedSize();
+}
+
 bool StagingUploader::checkAppendedSize(size_t limitInBytes, size_t addedSize) const
 {
   return m_batch.stagingSize && (m_batch.stagingSize + addedSize) > limitInBytes;
@@ -508,14 +690,19 @@ bool StagingUploader::checkAppendedSize(size_t limitInBytes, size_t addedSize) c
 
 void StagingUploader::cmdUploadAppended(VkCommandBuffer cmd)
 {
+  assert(!m_parallel.active && "Missing endParallelAppend()");
+
   if(m_enableLayoutBarriers)
   {
     m_batch.pre.cmdPipelineBarrier(cmd, 0);
   }
 
+  // copies appended by `endParallelAppend` can have multiple regions
+  size_t region = 0;
   for(size_t i = 0; i < m_batch.copyBufferInfos.size(); i++)
   {
-    m_batch.copyBufferInfos[i].pRegions = &m_batch.copyBufferRegions[i];
+    m_batch.copyBufferInfos[i].pRegions = &m_batch.copyBufferRegions[region];
+    region += m_batch.copyBufferInfos[i].regionCount;
     vkCmdCopyBuffer2(cmd, &m_batch.copyBufferInfos[i]);
   }
 
@@ -586,6 +773,126 @@ void StagingUploader::releaseStaging(bool forceAll)
   m_stagingResources.resize(writeIdx);
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+VkResult RingStagingUploader::init(const InitInfo& info)
+{
+  assert(info.ringSize && info.alignment);
+  StagingUploader::init(info.resourceAllocator, info.enableLayoutBarriers);
+
+  VkResult result = createStagingBuffer(m_ringBuffer, info.ringSize);
+  if(result != VK_SUCCESS)
+  {
+    StagingUploader::deinit();
+    return result;
+  }
+
+  m_ring.init(info.ringSize);
+  m_alignment         = info.alignment;
+  m_maxRingAllocation = info.maxRingAllocation ? std::min(info.maxRingAllocation, info.ringSize) : info.ringSize / 4;
+  m_lastFence         = 0;
+  m_ringStats         = {};
+
+  return VK_SUCCESS;
+}
+
+void RingStagingUploader::deinit()
+{
+  if(m_resourceAllocator != nullptr)
+  {
+    releaseStaging(true);
+    assert(m_ring.isEmpty() && m_ringFences.empty());
+    m_ring.deinit();
+    m_resourceAllocator->destroyBuffer(m_ringBuffer);
+  }
+  StagingUploader::deinit();
+}
+
+VkResult RingStagingUploader::acquireStagingSpace(BufferRange& stagingSpace, size_t dataSize, const void* data, const SemaphoreState& semaphoreState)
+{
+  if(dataSize <= m_maxRingAllocation)
+  {
+    uint64_t offset = allocateFromRing(dataSize, semaphoreState);
+    if(offset == nvutils::RingAllocator::INVALID_OFFSET)
+    {
+      // Only release what the device is known to be done with: space acquired
+      // with an invalid SemaphoreState is only released by releaseStaging().
+      releaseRing(false, false);
+      offset = allocateFromRing(dataSize, semaphoreState);
+    }
+
+    if(offset != nvutils::RingAllocator::INVALID_OFFSET)
+    {
+      stagingSpace.buffer  = m_ringBuffer.buffer;
+      stagingSpace.offset  = offset;
+      stagingSpace.range   = dataSize;
+      stagingSpace.address = m_ringBuffer.address + offset;
+      stagingSpace.mapping = m_ringBuffer.mapping + offset;
+
+      if(data)
+      {
+        memcpy(stagingSpace.mapping, data, dataSize);
+      }
+
+      m_ringStats.ringAllocations++;
+      return VK_SUCCESS;
+    }
+
+    m_ringStats.ringFullCount++;
+  }
+
+  m_ringStats.dedicatedAllocations++;
+  m_ringStats.dedicatedBytes += dataSize;
+  return StagingUploader::acquireStagingSpace(stagingSpace, dataSize, data, semaphoreState);
+}
+
+void RingStagingUploader::releaseStaging(bool forceAll)
+{
+  StagingUploader::releaseStaging(forceAll);
+  releaseRing(forceAll, true);
+}
+
+uint64_t RingStagingUploader::allocateFromRing(size_t dataSize, const SemaphoreState& semaphoreState)
+{
+  // consecutive allocations with the same SemaphoreState share a fence
+  const bool     newFence = m_ringFences.empty() || !(m_ringFences.back().semaphoreState == semaphoreState);
+  const uint64_t fence    = newFence ? m_lastFence + 1 : m_ringFences.back().fence;
+
+  const uint64_t offset = m_ring.allocate(dataSize, m_alignment, fence);
+  if(offset != nvutils::RingAllocator::INVALID_OFFSET && newFence)
+  {
+    m_ringFences.push_back({fence, semaphoreState});
+    m_lastFence = fence;
+  }
+  return offset;
+}
+
+void RingStagingUploader::releaseRing(bool forceAll, bool releaseInvalid)
+{
+  VkDevice device = m_resourceAllocator->getDevice();
+
+  // the ring is released in order, so stop at the first fence that
+  // can't be released yet
+  uint64_t releasedFence = 0;
+  while(!m_ringFences.empty())
+  {
+    RingFence& ringFence = m_ringFences.front();
+    bool       canRelease =
+        forceAll || (ringFence.semaphoreState.isValid() ? ringFence.semaphoreState.testSignaled(device) : releaseInvalid);
+    if(!canRelease)
+    {
+      break;
+    }
+    releasedFence = ringFence.fence;
+    m_ringFences.pop_front();
+  }
+
+  if(releasedFence)
+  {
+    m_ring.release(releasedFence);
+  }
+}
+
 }  // namespace nvvk
 
 //--------------------------------------------------------------------------------------------------
@@ -734,3 +1041,88 @@ void StagingUploader::releaseStaging(bool forceAll)
     }
   }
 }
+
+[[maybe_unused]] static void usage_RingStagingUploader()
+{
+  nvvk::ResourceAllocator resourceAllocator{};
+
+  // staging space for per-frame uploads comes from one 64 MiB buffer
+  nvvk::RingStagingUploader stagingUploader;
+  stagingUploader.init({.resourceAllocator = &resourceAllocator, .ringSize = 64 * 1024 * 1024});
+
+  std::vector<float> myData;
+  nvvk::Buffer       myBuffer;
+  resourceAllocator.createBuffer(myBuffer, std::span(myData).size_bytes(), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT);
+
+  VkSemaphore timelineSemaphore{};
+  uint64_t    timelineValue = 1;
+
+  // frame loop, same as with StagingUploader
+  while(true)
+  {
+    // releases the ring space of frames the device has completed
+    stagingUploader.releaseStaging();
+
+    VkCommandBuffer cmd{};
+
+    nvvk::SemaphoreState semaphoreState = nvvk::SemaphoreState::makeFixed(timelineSemaphore, timelineValue);
+    stagingUploader.appendBuffer(myBuffer, 0, std::span(myData), semaphoreState);
+    stagingUploader.cmdUploadAppended(cmd);
+
+    // submit cmd buffer to queue signaling the timelineValue
+    timelineValue++;
+
+    // requests that didn't fit are reported here;
+    // if they are frequent, the ring should be larger
+    const nvvk::RingStagingUploader::RingStats& stats = stagingUploader.getRingStats();
+    (void)stats.ringFullCount;
+  }
+
+  stagingUploader.deinit();
+}
+
+[[maybe_unused]] static void usage_StagingUploaderParallel()
+{
+  nvvk::ResourceAllocator resourceAllocator{};
+  nvvk::StagingUploader   stagingUploader;
+  stagingUploader.init(&resourceAllocator);
+
+  const uint32_t                  numThreads = 8;
+  std::vector<std::vector<float>> myData(1000);
+  std::vector<nvvk::Buffer>       myBuffers(myData.size());
+  size_t                          stagingSize = 0;
+  for(size_t i = 0; i < myData.size(); i++)
+  {
+    resourceAllocator.createBuffer(myBuffers[i], std::span(myData[i]).size_bytes(), VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT);
+    stagingSize += nvutils::align_up(std::span(myData[i]).size_bytes(), nvvk::StagingUploader::PARALLEL_ALIGNMENT);
+  }
+
+  // staging space for all copies is acquired up front
+  stagingUploader.beginParallelAppend(stagingSize, numThreads);
+
+  // run on `numThreads` threads, e.g. with nvutils::parallel_batches_pooled,
+  // each with its own `threadIndex`
+  auto worker = [&](uint64_t i, uint32_t threadIndex) {
+    NVVK_CHECK(stagingUploader.appendBufferParallel(threadIndex, myBuffers[i], 0,
+                                                    std::span(myData[i]).size_bytes(), myData[i].data()));
+  };
+  for(uint64_t i = 0; i < myData.size(); i++)
+  {
+    worker(i, uint32_t(i % numThreads));
+  }
+
+  // back on one thread: the copies are sorted and coalesced
+  stagingUploader.endParallelAppend();
+
+  VkCommandBuffer cmd{};
+  stagingUploader.cmdUploadAppended(cmd);
+
+  // submit cmd buffer and wait for completion
+  stagingUploader.releaseStaging();
+
+  for(nvvk::Buffer& buffer : myBuffers)
+  {
+    resourceAllocator.destroyBuffer(buffer);
+  }
+  stagingUploader.deinit();
+}
@@ -20,6 +20,10 @@
 #pragma once
 
 #include <cassert>
+#include <deque>
+
+#include <nvutils/atomic_linear_allocator.hpp>
+#include <nvutils/ring_allocator.hpp>
 
 #include "semaphore.hpp"
 #include "barriers.hpp"
@@ -42,7 +46,7 @@ public:
   StagingUploader& operator=(const StagingUploader&) = delete;
   StagingUploader(StagingUploader&& other) noexcept;
   StagingUploader& operator=(StagingUploader&& other) noexcept;
-  ~StagingUploader()
+  virtual ~StagingUploader()
   {
     assert(isAppendedEmpty() && "Did you forget cmdUploadAppended() or cancelAppended()");
     assert(m_resourceAllocator == nullptr && "Missing deinit()");
@@ -52,7 +56,8 @@ public:
   void init(ResourceAllocator* resourceAllocator, bool enableLayoutBarriers = false);
 
   // deinit implicitly calls `releaseStaging(true)`
-  void deinit();
+  // virtual so that derived classes can release their own staging resources.
+  virtual void deinit();
 
   void setEnableLayoutBarriers(bool enableLayoutBarriers);
 
@@ -202,6 +207,78 @@ public:
     return appendImageSub(image, offset, extent, subresource, data.size_bytes(), data.data(), newLayout, semaphoreState);
   }
 
+  // same as appendImageSub, but instead of copying from `data`, staging space
+  // of `dataSize` bytes is acquired and its mapping is returned in `uploadMapping`.
+  // The texels for the copy must be written there before the command buffer
+  // from `cmdUploadAppended` executes, which lets decoders and format conversions
+  // write straight into staging memory.
+  // `dataSize` can be `0` does return VK_SUCCESS and sets `uploadMapping` to nullptr
+  VkResult appendImageSubMapping(nvvk::Image&                    image,
+                                 const VkOffset3D&               offset,
+                                 const VkExtent3D&               extent,
+                                 const VkImageSubresourceLayers& subresource,
+                                 size_t                          dataSize,
+                                 void*&                          uploadMapping,
+                                 VkImageLayout                   newLayout      = VK_IMAGE_LAYOUT_UNDEFINED,
+                                 const SemaphoreState&           semaphoreState = {});
+
+  template <typename T>
+  inline VkResult appendImageSubMapping(nvvk::Image&                    image,
+                                        const VkOffset3D&               offset,
+                                        const VkExtent3D&               extent,
+                                        const VkImageSubresourceLayers& subresource,
+                                        size_t                          dataSize,
+                                        T*&                             uploadMapping,
+                                        VkImageLayout                   newLayout      = VK_IMAGE_LAYOUT_UNDEFINED,
+                                        const SemaphoreState&           semaphoreState = {})
+  {
+    return appendImageSubMapping(image, offset, extent, subresource, dataSize, (void*&)uploadMapping, newLayout, semaphoreState);
+  }
+
+  // Thread-safe batched buffer uploads, which spread the copies into
+  // staging memory over several threads:
+  //
+  // `beginParallelAppend` acquires `stagingSize` bytes of staging space
+  // for up to `numThreads` threads.
+  //
+  // Until `endParallelAppend`, `appendBufferParallel` can be called from
+  // any thread with a `threadIndex` < `numThreads` that no other thread uses
+  // concurrently (e.g. the one nvutils::parallel_batches_pooled provides).
+  // Each call reserves a range of the staging space atomically (sizes are
+  // rounded up to PARALLEL_ALIGNMENT), copies `data` into it, and records
+  // the copy command in the thread's own list. If `buffer.mapping` is valid,
+  // `data` is copied there directly instead.
+  // Returns VK_ERROR_OUT_OF_POOL_MEMORY if the staging space is used up.
+  // Destination ranges must not overlap between begin and end.
+  //
+  // `endParallelAppend` merges the threads' copy commands, sorts them by
+  // destination buffer and offset, coalesces those that are contiguous in
+  // both staging and destination memory, and appends one copy command per
+  // destination buffer for `cmdUploadAppended`.
+  //
+  // Other append functions must not be called between begin and end.
+  // Images aren't supported, as their layout transitions are tracked in
+  // nvvk::Image and can't be updated concurrently.
+  static constexpr VkDeviceSize PARALLEL_ALIGNMENT = 16;
+
+  VkResult beginParallelAppend(size_t stagingSize, uint32_t numThreads, const SemaphoreState& semaphoreState = {});
+
+  VkResult appendBufferParallel(uint32_t            threadIndex,
+                                const nvvk::Buffer& buffer,
+                                VkDeviceSize        bufferOffset,
+                                VkDeviceSize        dataSize,
+                                const void*         data);
+
+  // same as above but returns the staging space in `uploadMapping`
+  // to be filled by the calling thread before `endParallelAppend`
+  VkResult appendBufferParallelMapping(uint32_t            threadIndex,
+                                       const nvvk::Buffer& buffer,
+                                       VkDeviceSize        bufferOffset,
+                                       VkDeviceSize        dataSize,
+                                       void*&              uploadMapping);
+
+  void endParallelAppend();
+
   // returns true if the sum of staging resources used in pending operations
   // and the added size is beyond the limit
   bool checkAppendedSize(size_t limitInBytes, size_t addedSize = 0) const;
@@ -213,6 +290,9 @@ public:
 protected:
   void modifyImageBarrier(VkImageMemoryBarrier2& barrier);
 
+  // creates a persistently mapped, host-coherent buffer to stage uploads from
+  VkResult createStagingBuffer(nvvk::Buffer& buffer, VkDeviceSize size);
+
   struct Batch
   {
     bool   transferOnly = false;
@@ -232,12 +312,123 @@ protected:
     SemaphoreState semaphoreState;
   };
 
+  struct ParallelCopy
+  {
+    VkBuffer      dstBuffer{};
+    VkBufferCopy2 region{};
+  };
+
+  // one per thread index, padded to avoid false sharing
+  struct alignas(64) ParallelThread
+  {
+    std::vector<ParallelCopy> copies;
+  };
+
+  struct ParallelAppend
+  {
+    bool                           active = false;
+    BufferRange                    stagingSpace;
+    nvutils::AtomicLinearAllocator allocator;
+    std::vector<ParallelThread>    threads;
+    std::vector<ParallelCopy>      merged;
+  };
+
   ResourceAllocator* m_resourceAllocator    = nullptr;
   size_t             m_stagingResourcesSize = 0;
   bool               m_enableLayoutBarriers = false;
 
   std::vector<StagingResource> m_stagingResources;
   Batch                        m_batch{};
+  ParallelAppend               m_parallel;
+};
+
+//-----------------------------------------------------------------
+// RingStagingUploader is a StagingUploader that sub-allocates staging
+// space from a single persistently mapped buffer used as a ring
+// (see nvutils::RingAllocator), rather than creating a buffer for
+// every upload. This avoids allocation churn when uploading every frame.
+//
+// Ring space is released in the order it was acquired, once the
+// SemaphoreState it was acquired with is signaled; space acquired with an
+// invalid SemaphoreState is released by the next `releaseStaging` call,
+// just like StagingUploader's temporary resources.
+//
+// Requests larger than `InitInfo::maxRingAllocation`, and requests made
+// while the ring is full, fall back to StagingUploader's temporary
+// staging buffers. `getStagingUsage` only accounts for those.
+//
+// Usage:
+//      see usage_RingStagingUploader in staging.cpp
+//-----------------------------------------------------------------
+
+class RingStagingUploader : public StagingUploader
+{
+public:
+  static constexpr VkDeviceSize DEFAULT_RING_SIZE = VkDeviceSize(64) * 1024 * 1024;
+  // a multiple of 4 and of every texel block size (including 3, 6 and 12 bytes),
+  // as buffer to image copies require
+  static constexpr VkDeviceSize DEFAULT_ALIGNMENT = 48;
+
+  RingStagingUploader()                                      = default;
+  RingStagingUploader(RingStagingUploader&& other)            = delete;
+  RingStagingUploader& operator=(RingStagingUploader&& other) = delete;
+
+  struct InitInfo
+  {
+    // explicit lifetime of resourceAllocator must be ensured externally
+    ResourceAllocator* resourceAllocator{};
+    bool               enableLayoutBarriers = false;
+
+    VkDeviceSize ringSize  = DEFAULT_RING_SIZE;
+    VkDeviceSize alignment = DEFAULT_ALIGNMENT;
+    // larger requests use temporary staging buffers
+    // 0 will default to ringSize / 4
+    VkDeviceSize maxRingAllocation = 0;
+  };
+
+  // creates the ring buffer
+  VkResult init(const InitInfo& info);
+
+  // implicitly calls `releaseStaging(true)`, and destroys the ring buffer
+  void deinit() override;
+
+  VkResult acquireStagingSpace(BufferRange& stagingSpace, size_t dataSize, const void* data, const SemaphoreState& semaphoreState = {}) override;
+  void releaseStaging(bool forceAll = false) override;
+
+  struct RingStats
+  {
+    // acquireStagingSpace requests served from the ring
+    uint64_t ringAllocations = 0;
+    // requests that used temporary staging buffers, and their size
+    uint64_t dedicatedAllocations = 0;
+    uint64_t dedicatedBytes       = 0;
+    // of the above, those that were small enough for the ring, but it was full
+    uint64_t ringFullCount = 0;
+  };
+
+  const RingStats&              getRingStats() const { return m_ringStats; }
+  void                          resetRingStats() { m_ringStats = {}; }
+  const nvutils::RingAllocator& getRing() const { return m_ring; }
+
+protected:
+  uint64_t allocateFromRing(size_t dataSize, const SemaphoreState& semaphoreState);
+  // releases ring space in order, up to the first SemaphoreState that isn't
+  // signaled, or invalid if `!releaseInvalid`
+  void releaseRing(bool forceAll, bool releaseInvalid);
+
+  struct RingFence
+  {
+    uint64_t       fence = 0;
+    SemaphoreState semaphoreState;
+  };
+
+  nvvk::Buffer           m_ringBuffer;
+  nvutils::RingAllocator m_ring;
+  std::deque<RingFence>  m_ringFences;  // oldest first, one per fence in m_ring
+  uint64_t               m_lastFence         = 0;
+  VkDeviceSize           m_alignment         = DEFAULT_ALIGNMENT;
+  VkDeviceSize           m_maxRingAllocation = 0;
+  RingStats              m_ringStats;
 };
 
 }  // namespace nvvk
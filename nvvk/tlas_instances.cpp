@@ -0,0 +1,92 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <algorithm>
+#include <numeric>
+
+#include "tlas_instances.hpp"
+
+namespace nvvk {
+
+// World-space center and half extent of a box after an affine transform
+static void transformBounds(const glm::mat4& transform,
+                            const glm::vec3& localCenter,
+                            const glm::vec3& localHalfExtent,
+                            glm::vec3&       center,
+                            glm::vec3&       halfExtent)
+{
+  center     = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+  halfExtent = glm::abs(glm::vec3(transform[0])) * localHalfExtent.x + glm::abs(glm::vec3(transform[1])) * localHalfExtent.y
+               + glm::abs(glm::vec3(transform[2])) * localHalfExtent.z;
+}
+
+static float surfaceArea(const glm::vec3& halfExtent)
+{
+  return 8.0f * (halfExtent.x * halfExtent.y + halfExtent.y * halfExtent.z + halfExtent.z * halfExtent.x);
+}
+
+void TlasRefitTracker::init(size_t instanceCount)
+{
+  m_builtCenters.assign(instanceCount, glm::vec3(0.0f));
+  m_builtHalfExtents.assign(instanceCount, glm::vec3(0.0f));
+  m_growth.assign(instanceCount, 0.0f);
+  m_builtArea = 0.0;
+}
+
+void TlasRefitTracker::deinit()
+{
+  *this = {};
+}
+
+void TlasRefitTracker::setBuilt(size_t i, const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localHalfExtent)
+{
+  transformBounds(transform, localCenter, localHalfExtent, m_builtCenters[i], m_builtHalfExtents[i]);
+  m_growth[i] = 0.0f;
+}
+
+void TlasRefitTracker::commitBuild()
+{
+  m_builtArea = 0.0;
+  for(const glm::vec3& halfExtent : m_builtHalfExtents)
+  {
+    m_builtArea += surfaceArea(halfExtent);
+  }
+}
+
+void TlasRefitTracker::setRefit(size_t i, const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localHalfExtent)
+{
+  glm::vec3 center, halfExtent;
+  transformBounds(transform, localCenter, localHalfExtent, center, halfExtent);
+
+  const glm::vec3 unionMin = glm::min(m_builtCenters[i] - m_builtHalfExtents[i], center - halfExtent);
+  const glm::vec3 unionMax = glm::max(m_builtCenters[i] + m_builtHalfExtents[i], center + halfExtent);
+  m_growth[i] = std::max(0.0f, surfaceArea((unionMax - unionMin) * 0.5f) - surfaceArea(m_builtHalfExtents[i]));
+}
+
+float TlasRefitTracker::getDegradation() const
+{
+  const double growth = std::accumulate(m_growth.begin(), m_growth.end(), 0.0);
+  if(m_builtArea > 0.0)
+  {
+    return float(growth / m_builtArea);
+  }
+  return growth > 0.0 ? 1.0f : 0.0f;
+}
+
+}  // namespace nvvk
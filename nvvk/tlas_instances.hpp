@@ -0,0 +1,149 @@
+/*
+* Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <volk.h>
+
+#include <nvutils/bit_array.hpp>
+#include <nvutils/parallel_work.hpp>
+
+namespace nvvk {
+
+/*-------------------------------------------------------------------------------------------------
+# Function nvvk::updateTlasInstances
+
+>  Regenerates the instances of a TLAS in parallel and marks those that changed.
+
+`makeInstance(i, instance)` fills in instance `i` (starting from a zeroed
+instance; nvvk::toTransformMatrixKHR converts its transform). Instances that
+differ from what `instances` holds are written there, their bit in `dirty`
+is set, and `onChanged(i)` is called; all three happen on worker threads, for
+different `i` at once. `dirty` must have as many bits as there are instances
+and is only ever set, so that it can be passed to
+nvutils::coalesceDirtyRanges() to upload just the instances that changed:
+
+```cpp
+nvutils::BitArray dirty(instances.size());
+nvvk::updateTlasInstances(instances, dirty, [&](uint64_t i, VkAccelerationStructureInstanceKHR& instance) {
+  instance.transform                      = nvvk::toTransformMatrixKHR(nodes[i].worldMatrix);
+  instance.accelerationStructureReference = blasAddresses[nodes[i].blas];
+  instance.mask                           = 0xFF;
+});
+for(const nvutils::DirtyRange& range : nvutils::coalesceDirtyRanges(dirty, 8))
+{
+  staging.appendBuffer(instanceBuffer, range.first * sizeof(VkAccelerationStructureInstanceKHR),
+                       std::span(instances).subspan(range.first, range.count));
+}
+```
+
+# class nvvk::TlasRefitTracker
+
+>  Estimates how much refitting has degraded a TLAS, to decide when to rebuild it.
+
+An update (refit) keeps the tree of the last build and only grows its boxes
+around the instances' new bounds; it is much faster than a build, but as
+instances move away from where they were built, the boxes of their
+ancestors grow and overlap, and rays visit more of them.
+
+The tracker keeps the world-space bounds each instance had at the last
+build. For an instance that moved, the bounds of its leaf after the refit
+cover both where it was built and where it is now (its ancestors cover at
+least that much), so the growth of that union's surface area, relative to
+the summed surface area of all instances at the build, estimates by how
+much the traversal cost went up (by the surface area heuristic).
+Instances that move back to where they were built stop counting.
+
+```cpp
+// After each build
+tracker.init(instanceCount);  // Once, or when the count changed
+for(size_t i = 0; i < instanceCount; i++)  // may be parallel
+  tracker.setBuilt(i, transforms[i], blasCenters[i], blasHalfExtents[i]);
+tracker.commitBuild();
+
+// Per frame, for the instances that moved
+tracker.setRefit(i, transforms[i], blasCenters[i], blasHalfExtents[i]);  // may be parallel
+if(tracker.getDegradation() > 0.5f)  // rebuild, then setBuilt/commitBuild again
+```
+
+This ignores changes of the BLAS themselves (pass their bounds at build
+time), and a scene that moves as a whole also counts as degraded.
+-------------------------------------------------------------------------------------------------*/
+
+template <typename F, typename G>
+void updateTlasInstances(std::span<VkAccelerationStructureInstanceKHR> instances, nvutils::BitArray& dirty, F&& makeInstance, G&& onChanged)
+{
+  assert(dirty.size() == instances.size());
+  // Batches are multiples of 64 instances, so that no two threads write to the same word of `dirty`
+  nvutils::parallel_batches<2048>(instances.size(), [&](uint64_t i) {
+    VkAccelerationStructureInstanceKHR instance{};
+    makeInstance(i, instance);
+    if(memcmp(&instance, &instances[i], sizeof(instance)) != 0)
+    {
+      instances[i] = instance;
+      dirty.enableBit(i);
+      onChanged(i);
+    }
+  });
+}
+
+template <typename F>
+void updateTlasInstances(std::span<VkAccelerationStructureInstanceKHR> instances, nvutils::BitArray& dirty, F&& makeInstance)
+{
+  updateTlasInstances(instances, dirty, std::forward<F>(makeInstance), [](uint64_t) {});
+}
+
+class TlasRefitTracker
+{
+public:
+  void init(size_t instanceCount);
+  void deinit();
+
+  size_t size() const { return m_growth.size(); }
+
+  // Records the world-space bounds of instance `i` in the TLAS that was just built, from its
+  // object-space bounds (e.g. of its BLAS) as center and half extent, and its transform.
+  // Call for every instance after a build, then commitBuild().
+  // Thread-safe for different `i`.
+  void setBuilt(size_t i, const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localHalfExtent);
+  void commitBuild();
+
+  // Records the bounds of instance `i` for a refit; call for the instances that moved.
+  // Thread-safe for different `i`.
+  void setRefit(size_t i, const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localHalfExtent);
+
+  // Estimated relative increase of the traversal cost since the last build:
+  // 0 right after a build, 1 when refitting added as much surface area as
+  // the instances had. Sums over all instances.
+  float getDegradation() const;
+
+private:
+  std::vector<glm::vec3> m_builtCenters;
+  std::vector<glm::vec3> m_builtHalfExtents;
+  std::vector<float>     m_growth;  // Per instance, added surface area since the build
+  double                 m_builtArea = 0.0;
+};
+
+}  // namespace nvvk
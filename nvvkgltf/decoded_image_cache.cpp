@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "decoded_image_cache.hpp"
+
+namespace nvvkgltf {
+
+void DecodedImageCache::setBudget(uint64_t budgetBytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budget = budgetBytes;
+  evict(budgetBytes);
+}
+
+uint64_t DecodedImageCache::getBudget() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_budget;
+}
+
+std::shared_ptr<const DecodedImageCache::Entry> DecodedImageCache::find(const Key& key)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto                        it = m_items.find(key);
+  if(it == m_items.end())
+  {
+    m_misses++;
+    return nullptr;
+  }
+  m_hits++;
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  return it->second->entry;
+}
+
+void DecodedImageCache::insert(const Key& key, Entry entry)
+{
+  uint64_t bytes = 0;
+  for(const std::vector<char>& mip : entry.mipData)
+  {
+    bytes += mip.size();
+  }
+
+  if(bytes > getBudget())
+  {
+    return;
+  }
+  std::shared_ptr<const Entry> shared = std::make_shared<const Entry>(std::move(entry));
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(bytes > m_budget || m_items.find(key) != m_items.end())
+  {
+    return;
+  }
+  m_lru.push_front(Item{key, bytes, std::move(shared)});
+  m_items[key] = m_lru.begin();
+  m_sizeBytes += bytes;
+  evict(m_budget);
+}
+
+void DecodedImageCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  evict(0);
+}
+
+void DecodedImageCache::evict(uint64_t budgetBytes)
+{
+  while(m_sizeBytes > budgetBytes && !m_lru.empty())
+  {
+    m_sizeBytes -= m_lru.back().bytes;
+    m_items.erase(m_lru.back().key);
+    m_lru.pop_back();
+  }
+}
+
+uint64_t DecodedImageCache::getSizeBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_sizeBytes;
+}
+
+uint64_t DecodedImageCache::getHitCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t DecodedImageCache::getMissCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+}  // namespace nvvkgltf
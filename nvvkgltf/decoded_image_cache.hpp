@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "nvutils/sha256.hpp"
+
+/*-------------------------------------------------------------------------------------------------
+# class nvvkgltf::DecodedImageCache
+
+>  Process-wide LRU cache of decoded glTF images.
+
+SceneVk::createTextureImages() looks images up here by the size and SHA-256
+digest of their encoded bytes before decoding them, and adds the images it
+decodes. A lookup only hits if both match. Since the
+cache outlives SceneVk::destroy(), reloading a scene (or loading another one
+that shares textures) in an interactive application skips decoding.
+
+The cache is disabled until it is given a budget:
+
+```cpp
+nvvkgltf::DecodedImageCache::getInstance().setBudget(2ull << 30);  // 2 GiB
+```
+
+All functions are thread-safe.
+
+-------------------------------------------------------------------------------------------------*/
+
+namespace nvvkgltf {
+
+class DecodedImageCache
+{
+public:
+  // Identifies an encoded image, and how it is decoded (e.g. its color space).
+  struct Key
+  {
+    uint64_t              encodedSize = 0;
+    nvutils::Sha256Digest digest{};  // Of the encoded bytes and how they're decoded
+
+    bool operator==(const Key& other) const = default;
+  };
+  struct KeyHash
+  {
+    size_t operator()(const Key& key) const { return nvutils::Sha256DigestHash{}(key.digest); }
+  };
+
+  struct Entry
+  {
+    VkExtent2D                     size{0, 0};
+    VkFormat                       format{VK_FORMAT_UNDEFINED};
+    VkFormat                       decodedFormat{VK_FORMAT_UNDEFINED};  // See SceneVk::SceneImage
+    std::vector<std::vector<char>> mipData{};
+  };
+
+  static DecodedImageCache& getInstance()
+  {
+    static DecodedImageCache instance;
+    return instance;
+  }
+
+  // Sets the maximum total size of cached mip data in bytes, evicting the
+  // least recently used images if needed. 0 disables the cache and clears it.
+  void     setBudget(uint64_t budgetBytes);
+  uint64_t getBudget() const;
+  bool     isEnabled() const { return getBudget() != 0; }
+
+  // Returns the image with the given key, or nullptr if it isn't cached.
+  std::shared_ptr<const Entry> find(const Key& key);
+  // Adds an image, unless it is larger than the whole budget.
+  void insert(const Key& key, Entry entry);
+  void clear();
+
+  uint64_t getSizeBytes() const;
+  uint64_t getHitCount() const;
+  uint64_t getMissCount() const;
+
+private:
+  DecodedImageCache() = default;
+
+  void evict(uint64_t budgetBytes);  // Requires m_mutex
+
+  struct Item
+  {
+    Key                          key;
+    uint64_t                     bytes = 0;
+    std::shared_ptr<const Entry> entry;
+  };
+
+  mutable std::mutex                                          m_mutex;
+  std::list<Item>                                             m_lru;  // Most recently used first
+  std::unordered_map<Key, std::list<Item>::iterator, KeyHash> m_items;
+  uint64_t                                                    m_budget    = 0;
+  uint64_t                                                    m_sizeBytes = 0;
+  uint64_t                                                    m_hits      = 0;
+  uint64_t                                                    m_misses    = 0;
+};
+
+}  // namespace nvvkgltf
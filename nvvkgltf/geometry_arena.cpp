@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <cassert>
+
+#include "nvutils/alignment.hpp"
+
+#include "geometry_arena.hpp"
+
+namespace nvvkgltf {
+
+GeometryArenaLayout::GeometryArenaLayout(uint64_t maxArenaSize, uint64_t alignment)
+    : m_maxArenaSize(maxArenaSize)
+    , m_alignment(alignment)
+{
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+}
+
+GeometryArenaLayout::Range GeometryArenaLayout::add(uint64_t size)
+{
+  if(size == 0)
+  {
+    return {};
+  }
+
+  if(!m_arenaSizes.empty())
+  {
+    const uint64_t arenaSize = m_arenaSizes.back();
+    const uint64_t offset    = nvutils::align_up(arenaSize, m_alignment);
+    if(offset + size <= m_maxArenaSize)
+    {
+      m_arenaSizes.back() = offset + size;
+      m_totalSize += offset + size - arenaSize;
+      m_paddingBytes += offset - arenaSize;
+      return {getArenaCount() - 1, offset, size};
+    }
+  }
+
+  // Start a new arena; arrays larger than the maximum arena size get their own.
+  m_arenaSizes.push_back(size);
+  m_totalSize += size;
+  return {getArenaCount() - 1, 0, size};
+}
+
+}  // namespace nvvkgltf
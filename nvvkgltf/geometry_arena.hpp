@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*-------------------------------------------------------------------------------------------------
+# class nvvkgltf::GeometryArenaLayout
+
+>  Plans how to pack many vertex and index arrays into a few large buffers.
+
+SceneVk uses this when geometry arenas are enabled (see
+SceneVk::setGeometryArenaSize()): instead of creating one buffer per
+attribute per primitive, it adds the size of every array here, creates one
+buffer per arena, and uploads each array at its planned offset.
+
+Arrays are placed in the order they're added, each at the next multiple of
+the alignment. When an array doesn't fit in the current arena, a new arena is
+started; an array larger than the maximum arena size gets an arena of its own.
+
+This only does arithmetic and has no Vulkan dependencies, so it can be used
+and tested on its own:
+
+```cpp
+nvvkgltf::GeometryArenaLayout layout(256 << 20);
+const nvvkgltf::GeometryArenaLayout::Range positions = layout.add(vertexCount * sizeof(glm::vec3));
+const nvvkgltf::GeometryArenaLayout::Range indices   = layout.add(indexCount * sizeof(uint32_t));
+for(uint64_t arenaSize : layout.getArenaSizes())
+{
+  // Create a buffer of arenaSize bytes
+}
+// Upload positions to arena positions.arena at positions.offset, ...
+```
+
+-------------------------------------------------------------------------------------------------*/
+
+namespace nvvkgltf {
+
+class GeometryArenaLayout
+{
+public:
+  static constexpr uint32_t kInvalidArena     = ~0u;
+  static constexpr uint64_t kDefaultAlignment = 16;
+
+  struct Range
+  {
+    uint32_t arena  = kInvalidArena;
+    uint64_t offset = 0;
+    uint64_t size   = 0;
+
+    bool isValid() const { return arena != kInvalidArena; }
+  };
+
+  // `alignment` must be a power of two.
+  explicit GeometryArenaLayout(uint64_t maxArenaSize, uint64_t alignment = kDefaultAlignment);
+
+  // Places an array of `size` bytes. Returns an invalid range if `size` is 0.
+  Range add(uint64_t size);
+
+  // Size of each arena, in bytes; the last range of an arena ends at its size.
+  const std::vector<uint64_t>& getArenaSizes() const { return m_arenaSizes; }
+  uint32_t                     getArenaCount() const { return static_cast<uint32_t>(m_arenaSizes.size()); }
+  // Sum of the arena sizes, and how much of that is alignment padding.
+  uint64_t getTotalSize() const { return m_totalSize; }
+  uint64_t getPaddingBytes() const { return m_paddingBytes; }
+
+private:
+  uint64_t              m_maxArenaSize = 0;
+  uint64_t              m_alignment    = kDefaultAlignment;
+  std::vector<uint64_t> m_arenaSizes;
+  uint64_t              m_totalSize    = 0;
+  uint64_t              m_paddingBytes = 0;
+};
+
+}  // namespace nvvkgltf
@@ -416,6 +416,9 @@ void nvvkgltf::Scene::parseScene()
   parseAnimations();
   createMissingTangents();
 
+  // All render nodes are new
+  m_renderNodeRevisions.assign(m_renderNodes.size(), ++m_revision);
+
   // Update the visibility of the render nodes
   uint32_t renderNodeID = 0;
   for(const int sceneNode : m_model.scenes[m_currentScene].nodes)
@@ -446,8 +449,14 @@ void nvvkgltf::Scene::updateVisibility(int nodeID, bool visible, uint32_t& rende
   {
     // If the node has a mesh, update the visibility of all its primitives
     const tinygltf::Mesh& mesh = m_model.meshes[node.mesh];
-    for(size_t j = 0; j < mesh.primitives.size(); j++)
-      m_renderNodes[renderNodeID++].visible = visible;
+    for(size_t j = 0; j < mesh.primitives.size(); j++, renderNodeID++)
+    {
+      if(m_renderNodes[renderNodeID].visible != visible)
+      {
+        m_renderNodes[renderNodeID].visible = visible;
+        m_renderNodeRevisions[renderNodeID] = m_revision;
+      }
+    }
   }
 
   for(auto& child : node.children)
@@ -540,6 +549,7 @@ void nvvkgltf::Scene::updateRenderNodes()
   assert(m_sceneRootNode > -1 && "No root node in the scene");
 
   m_nodesWorldMatrices.resize(m_model.nodes.size());
+  m_revision++;
 
   uint32_t renderNodeID = 0;  // Index of the render node
   for(auto& sceneNode : scene.nodes)
@@ -561,8 +571,13 @@ void nvvkgltf::Scene::updateRenderNodes()
           {
             const tinygltf::Primitive& primitive  = mesh.primitives[j];
             nvvkgltf::RenderNode&      renderNode = m_renderNodes[renderNodeID];
-            renderNode.worldMatrix                = mat;
-            renderNode.materialID                 = getMaterialVariantIndex(primitive, m_currentVariant);
+            const int                  materialID = getMaterialVariantIndex(primitive, m_currentVariant);
+            if(renderNode.worldMatrix != mat || renderNode.materialID != materialID)
+            {
+              renderNode.worldMatrix              = mat;
+              renderNode.materialID               = materialID;
+              m_renderNodeRevisions[renderNodeID] = m_revision;
+            }
             renderNodeID++;
           }
           return false;  // Continue traversal
@@ -596,6 +611,7 @@ void nvvkgltf::Scene::clearParsedData()
   m_lights.clear();
   m_animations.clear();
   m_renderNodes.clear();
+  m_renderNodeRevisions.clear();
   m_renderPrimitives.clear();
   m_uniquePrimitiveIndex.clear();
   m_variants.clear();
@@ -186,6 +186,15 @@ public:
   // Render Node Management
   const std::vector<nvvkgltf::RenderNode>& getRenderNodes() const { return m_renderNodes; }
 
+  // Change tracking
+  // Each call to updateRenderNodes() increments the revision of the scene, and
+  // sets the revision of the render nodes whose matrix, material or visibility
+  // it changed to the new one. A render node changed since an earlier revision
+  // `r` if getRenderNodeRevisions()[i] > r. Parsing the scene gives every
+  // render node a new revision.
+  uint64_t                     getRevision() const { return m_revision; }
+  const std::vector<uint64_t>& getRenderNodeRevisions() const { return m_renderNodeRevisions; }
+
   // Render Primitive Management
   const std::vector<nvvkgltf::RenderPrimitive>& getRenderPrimitives() const { return m_renderPrimitives; }
   const nvvkgltf::RenderPrimitive&              getRenderPrimitive(size_t ID) const { return m_renderPrimitives[ID]; }
@@ -292,6 +301,8 @@ private:
   std::vector<uint32_t>                  m_morphPrimitives;       // All the primitives that are animated
   std::vector<uint32_t>                  m_skinNodes;             // All the primitives that are animated
   std::vector<glm::mat4>                 m_nodesWorldMatrices;
+  std::vector<uint64_t>                  m_renderNodeRevisions;   // Revision of the last change of each render node
+  uint64_t                               m_revision = 0;          // Never reset, so that revisions only increase
 
   int           m_numTriangles    = 0;   // Stat - Number of triangles
   int           m_currentScene    = 0;   // Scene index
@@ -17,10 +17,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <cinttypes>
 #include <numeric>
 
 #include <nvutils/alignment.hpp>
+#include <nvutils/dirty_ranges.hpp>
 #include <nvutils/logger.hpp>
 #include <nvutils/timers.hpp>
 #include <nvvk/check_error.hpp>
@@ -36,6 +38,10 @@ constexpr std::string_view kMemCategoryBLAS      = "BLAS";
 constexpr std::string_view kMemCategoryTLAS      = "TLAS";
 constexpr std::string_view kMemCategoryScratch   = "Scratch";
 constexpr std::string_view kMemCategoryInstances = "Instances";
+
+// Up to this many unchanged instances between changed ones are uploaded again
+// rather than starting a new copy (512 bytes, as in SceneVk)
+constexpr uint64_t kInstanceUploadMaxGap = 8;
 }  // namespace
 
 // Initialize the scene for ray tracing
@@ -136,6 +142,8 @@ void nvvkgltf::SceneRtx::destroy()
   m_blasBuildData = {};
   m_tlasAccel     = {};
   m_tlasBuildData = {};
+  m_tlasInstances = {};
+  m_tlasRefitTracker.deinit();
   if(m_blasBuilder)
   {
     m_blasBuilder->deinit();
@@ -309,6 +317,58 @@ VkGeometryInstanceFlagsKHR getInstanceFlag(const tinygltf::Material& mat)
   return instanceFlags;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Instance flags of every material; looking them up per instance would parse
+// the material extensions for every instance
+//
+void nvvkgltf::SceneRtx::updateMaterialInstanceFlags(const tinygltf::Model& model)
+{
+  m_materialInstanceFlags.resize(model.materials.size());
+  for(size_t i = 0; i < model.materials.size(); i++)
+  {
+    m_materialInstanceFlags[i] = getInstanceFlag(model.materials[i]);
+  }
+}
+
+void nvvkgltf::SceneRtx::makeTlasInstance(const nvvkgltf::RenderNode& renderNode, VkAccelerationStructureInstanceKHR& instance) const
+{
+  VkDeviceAddress blasAddress = m_blasAccel[renderNode.renderPrimID].address;
+  if(!renderNode.visible)
+    blasAddress = 0;  // The instance is added, but the BLAS is set to null making it invisible
+
+  instance.transform                              = nvvk::toTransformMatrixKHR(renderNode.worldMatrix);  // Position of the instance
+  instance.instanceCustomIndex                    = renderNode.renderPrimID;  // gl_InstanceCustomIndexEXT
+  instance.accelerationStructureReference         = blasAddress;              // The reference to the BLAS
+  instance.instanceShaderBindingTableRecordOffset = 0;     // We will use the same hit group for all objects
+  instance.mask                                   = 0x01;  // Visibility mask
+  instance.flags                                  = m_materialInstanceFlags[renderNode.materialID];
+}
+
+void nvvkgltf::SceneRtx::updateTlasInstances(const nvvkgltf::Scene& scene, nvutils::BitArray& dirty, bool trackRefit)
+{
+  const std::vector<nvvkgltf::RenderNode>& drawObjects = scene.getRenderNodes();
+  nvvk::updateTlasInstances(
+      m_tlasInstances, dirty,
+      [&](uint64_t i, VkAccelerationStructureInstanceKHR& instance) { makeTlasInstance(drawObjects[i], instance); },
+      [&](uint64_t i) {
+        if(trackRefit)
+        {
+          const PrimitiveBounds& bounds = m_primitiveBounds[drawObjects[i].renderPrimID];
+          m_tlasRefitTracker.setRefit(i, drawObjects[i].worldMatrix, bounds.center, bounds.halfExtent);
+        }
+      });
+}
+
+void nvvkgltf::SceneRtx::setTlasInstancesBuilt(const nvvkgltf::Scene& scene)
+{
+  const std::vector<nvvkgltf::RenderNode>& drawObjects = scene.getRenderNodes();
+  nvutils::parallel_batches(drawObjects.size(), [&](uint64_t i) {
+    const PrimitiveBounds& bounds = m_primitiveBounds[drawObjects[i].renderPrimID];
+    m_tlasRefitTracker.setBuilt(i, drawObjects[i].worldMatrix, bounds.center, bounds.halfExtent);
+  });
+  m_tlasRefitTracker.commitBuild();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Create the top-level acceleration structure from all the BLAS
 //
@@ -317,34 +377,34 @@ void nvvkgltf::SceneRtx::cmdCreateBuildTopLevelAccelerationStructure(VkCommandBu
                                                                      const nvvkgltf::Scene& scene)
 {
   nvutils::ScopedTimer st(__FUNCTION__);
-  const auto&          materials   = scene.getModel().materials;
   const auto&          drawObjects = scene.getRenderNodes();
 
   uint32_t instanceCount = static_cast<uint32_t>(drawObjects.size());
 
-  m_tlasInstances.clear();
-  m_tlasInstances.reserve(instanceCount);
-  for(const auto& object : drawObjects)
+  // Object-space bounds of the primitives, for the refit heuristic of updateTopLevelAS()
+  const tinygltf::Model& model = scene.getModel();
+  m_primitiveBounds.resize(scene.getNumRenderPrimitives());
+  for(size_t i = 0; i < m_primitiveBounds.size(); i++)
   {
-    const tinygltf::Material&  mat           = materials[object.materialID];
-    VkGeometryInstanceFlagsKHR instanceFlags = getInstanceFlag(mat);
-
-    VkDeviceAddress blasAddress = m_blasAccel[object.renderPrimID].address;
-    if(!object.visible)
-      blasAddress = 0;  // The instance is added, but the BLAS is set to null making it invisible
-
-    VkAccelerationStructureInstanceKHR asInstance{};
-    asInstance.transform           = nvvk::toTransformMatrixKHR(object.worldMatrix);  // Position of the instance
-    asInstance.instanceCustomIndex = object.renderPrimID;                             // gl_InstanceCustomIndexEXT
-    asInstance.accelerationStructureReference         = blasAddress;                  // The reference to the BLAS
-    asInstance.instanceShaderBindingTableRecordOffset = 0;     // We will use the same hit group for all objects
-    asInstance.mask                                   = 0x01;  // Visibility mask
-    asInstance.flags                                  = instanceFlags;
-
-    // Storing the instance
-    m_tlasInstances.push_back(asInstance);
+    const tinygltf::Accessor& accessor = model.accessors[scene.getRenderPrimitive(i).pPrimitive->attributes.at("POSITION")];
+    if(accessor.minValues.size() >= 3 && accessor.maxValues.size() >= 3)
+    {
+      const glm::vec3 minValues(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]);
+      const glm::vec3 maxValues(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]);
+      m_primitiveBounds[i] = {(minValues + maxValues) * 0.5f, (maxValues - minValues) * 0.5f};
+    }
   }
 
+  updateMaterialInstanceFlags(model);
+  m_tlasInstances.assign(instanceCount, {});
+  nvutils::BitArray dirty(instanceCount);
+  updateTlasInstances(scene, dirty, false);
+
+  m_tlasRefitTracker.init(instanceCount);
+  setTlasInstancesBuilt(scene);
+  m_numVisibleElement = static_cast<uint32_t>(
+      std::count_if(drawObjects.begin(), drawObjects.end(), [](const nvvkgltf::RenderNode& node) { return node.visible; }));
+
   VkBuildAccelerationStructureFlagsKHR buildFlags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
   //if(scene.hasAnimation())
   {
@@ -402,24 +462,26 @@ void nvvkgltf::SceneRtx::updateTopLevelAS(VkCommandBuffer cmd, nvvk::StagingUplo
 {
   //nvh::ScopedTimer st(__FUNCTION__);
   const std::vector<nvvkgltf::RenderNode>& drawObjects = scene.getRenderNodes();
-  const auto&                              materials   = scene.getModel().materials;
+  assert(drawObjects.size() == m_tlasInstances.size() && "The number of render nodes changed; recreate the TLAS");
+
+  // Updating all instances, in parallel; only those that changed are marked and tracked for the refit
+  updateMaterialInstanceFlags(scene.getModel());
+  nvutils::BitArray dirty(m_tlasInstances.size());
+  updateTlasInstances(scene, dirty, true);
 
-  uint32_t numVisibleElement = 0;
-  // Updating all matrices
-  for(size_t i = 0; i < drawObjects.size(); i++)
+  const uint32_t numVisibleElement = static_cast<uint32_t>(
+      std::count_if(drawObjects.begin(), drawObjects.end(), [](const nvvkgltf::RenderNode& node) { return node.visible; }));
+
+  // Update the instance buffer, only where instances changed
+  m_tlasUpdateStats                  = {};
+  m_tlasUpdateStats.changedInstances = static_cast<uint32_t>(dirty.countSetBits());
+  for(const nvutils::DirtyRange& range : nvutils::coalesceDirtyRanges(dirty, kInstanceUploadMaxGap))
   {
-    auto&                     object      = drawObjects[i];
-    const tinygltf::Material& mat         = materials[object.materialID];
-    VkDeviceAddress           blasAddress = m_blasAccel[object.renderPrimID].address;
-
-    m_tlasInstances[i].transform = nvvk::toTransformMatrixKHR(object.worldMatrix);  // Position of the instance
-    m_tlasInstances[i].flags     = getInstanceFlag(mat);
-    m_tlasInstances[i].accelerationStructureReference = (object.visible ? blasAddress : 0);  // The reference to the BLAS
-    numVisibleElement += object.visible;
+    NVVK_CHECK(staging.appendBuffer(m_instancesBuffer, range.first * sizeof(VkAccelerationStructureInstanceKHR),
+                                    std::span(m_tlasInstances).subspan(range.first, range.count)));
+    m_tlasUpdateStats.rangeCount++;
+    m_tlasUpdateStats.uploadedBytes += range.count * sizeof(VkAccelerationStructureInstanceKHR);
   }
-
-  // Update the instance buffer
-  staging.appendBuffer(m_instancesBuffer, 0, std::span(m_tlasInstances));
   staging.cmdUploadAppended(cmd);
 
   // Make sure the copy of the instance buffer are copied before triggering the acceleration structure build
@@ -434,10 +496,16 @@ void nvvkgltf::SceneRtx::updateTopLevelAS(VkCommandBuffer cmd, nvvk::StagingUplo
     m_memoryTracker.track(kMemCategoryScratch, m_tlasScratchBuffer.allocation);
   }
 
+  // Rebuild when instances were shown or hidden, or when refitting degraded the TLAS too much
+  m_tlasUpdateStats.degradation = m_tlasRefitTracker.getDegradation();
+  m_tlasUpdateStats.rebuilt =
+      (m_numVisibleElement != numVisibleElement) || (m_tlasUpdateStats.degradation > m_tlasRebuildThreshold);
+
   // Building or updating the top-level acceleration structure
-  if(m_numVisibleElement != numVisibleElement)
+  if(m_tlasUpdateStats.rebuilt)
   {
     m_tlasBuildData.cmdBuildAccelerationStructure(cmd, m_tlasAccel.accel, m_tlasScratchBuffer.address);
+    setTlasInstancesBuilt(scene);
   }
   else
   {
@@ -21,6 +21,7 @@
 
 
 #include <nvvk/acceleration_structures.hpp>
+#include <nvvk/tlas_instances.hpp>
 
 #include "scene_vk.hpp"
 #include "gpu_memory_tracker.hpp"
@@ -58,6 +59,9 @@ public:
   // Destroy the original acceleration structures that was compacted
   void destroyNonCompactedBlas();
   // Update the instance buffer and build the TLAS (animation)
+  // Only the instances that changed are uploaded. The TLAS is refit, unless instances were shown or
+  // hidden, or the estimated degradation of the refit TLAS (see nvvk::TlasRefitTracker) exceeds
+  // the rebuild threshold.
   void updateTopLevelAS(VkCommandBuffer cmd, nvvk::StagingUploader& staging, const nvvkgltf::Scene& scene);
   // Update the bottom level acceleration structure
   void updateBottomLevelAS(VkCommandBuffer cmd, const nvvkgltf::Scene& scene);
@@ -74,6 +78,22 @@ public:
   GpuMemoryTracker&       getMemoryTracker() { return m_memoryTracker; }
   void                    trackBlasMemory();  // Track all BLAS allocations (call after all BLAS are built)
 
+  // Degradation at which updateTopLevelAS() rebuilds rather than refits the TLAS; 0.5 means the
+  // traversal cost is estimated to have gone up by 50% since the last build
+  void  setTlasRebuildThreshold(float threshold) { m_tlasRebuildThreshold = threshold; }
+  float getTlasRebuildThreshold() const { return m_tlasRebuildThreshold; }
+
+  // Statistics of the last updateTopLevelAS() call
+  struct TlasUpdateStats
+  {
+    uint32_t changedInstances = 0;
+    uint32_t rangeCount       = 0;  // Ranges the changed instances were uploaded in
+    uint64_t uploadedBytes    = 0;
+    float    degradation      = 0.0f;  // Estimated before deciding to rebuild
+    bool     rebuilt          = false;
+  };
+  const TlasUpdateStats& getTlasUpdateStats() const { return m_tlasUpdateStats; }
+
 protected:
   VkPhysicalDeviceRayTracingPipelinePropertiesKHR m_rtProperties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR};
   VkPhysicalDeviceAccelerationStructurePropertiesKHR m_rtASProperties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
@@ -82,6 +102,19 @@ protected:
                                                                       VkDeviceAddress                  vertexAddress,
                                                                       VkDeviceAddress                  indexAddress);
 
+  // Object-space bounds of a render primitive, from its POSITION accessor
+  struct PrimitiveBounds
+  {
+    glm::vec3 center{0.0f};
+    glm::vec3 halfExtent{0.0f};
+  };
+  void updateMaterialInstanceFlags(const tinygltf::Model& model);
+  void makeTlasInstance(const nvvkgltf::RenderNode& renderNode, VkAccelerationStructureInstanceKHR& instance) const;
+  // Updates m_tlasInstances from the render nodes, in parallel; sets the bits of those that changed
+  void updateTlasInstances(const nvvkgltf::Scene& scene, nvutils::BitArray& dirty, bool trackRefit);
+  // Records the current instances as built, for the refit heuristic
+  void setTlasInstancesBuilt(const nvvkgltf::Scene& scene);
+
   VkDevice         m_device         = VK_NULL_HANDLE;
   VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
 
@@ -93,7 +126,12 @@ protected:
 
   nvvk::AccelerationStructureBuildData            m_tlasBuildData;
   nvvk::AccelerationStructure                     m_tlasAccel;
-  std::vector<VkAccelerationStructureInstanceKHR> m_tlasInstances;
+  std::vector<VkAccelerationStructureInstanceKHR> m_tlasInstances;  // As last uploaded
+  std::vector<VkGeometryInstanceFlagsKHR>         m_materialInstanceFlags;
+  std::vector<PrimitiveBounds>                    m_primitiveBounds;
+  nvvk::TlasRefitTracker                          m_tlasRefitTracker;
+  float                                           m_tlasRebuildThreshold = 0.5f;
+  TlasUpdateStats                                 m_tlasUpdateStats;
 
   nvvk::Buffer m_blasScratchBuffer;
   nvvk::Buffer m_tlasScratchBuffer;
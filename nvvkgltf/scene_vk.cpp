@@ -18,10 +18,15 @@
  */
 
 
+#include <atomic>
 #include <cinttypes>
+#include <cstddef>
+#include <cstring>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <span>
+#include <unordered_map>
 
 
 #include <glm/glm.hpp>
@@ -29,11 +34,17 @@
 #include "nvshaders/gltf_scene_io.h.slang"  // Shared between host and device
 
 #include "stb_image.h"
+#include "nvimageformats/mip_generation.h"
 #include "nvimageformats/nv_dds.h"
 #include "nvimageformats/nv_ktx.h"
+#include "nvimageformats/texture_conversion.h"
 #include "nvimageformats/texture_formats.h"
+#include "nvutils/bounded_pipeline.hpp"
+#include "nvutils/dirty_ranges.hpp"
+#include "nvutils/file_mapping.hpp"
 #include "nvutils/file_operations.hpp"
 #include "nvutils/logger.hpp"
+#include "nvutils/sha256.hpp"
 #include "nvutils/timers.hpp"
 #include "nvvk/debug_util.hpp"
 #include "nvvk/mipmaps.hpp"
@@ -41,6 +52,8 @@
 #include "nvvk/default_structs.hpp"
 #include "nvvk/mipmaps.hpp"
 
+#include "decoded_image_cache.hpp"
+#include "geometry_arena.hpp"
 #include "scene_vk.hpp"
 #include "nvutils/parallel_work.hpp"
 #include "nvvk/helpers.hpp"
@@ -50,6 +63,71 @@ namespace {
 constexpr std::string_view kMemCategoryGeometry  = "Geometry";
 constexpr std::string_view kMemCategorySceneData = "SceneData";
 constexpr std::string_view kMemCategoryImages    = "Images";
+
+// Delta uploads copy clean elements between two changed ones again if they
+// span at most this many bytes, rather than recording a second copy.
+constexpr uint64_t kDeltaUploadMaxGapBytes = 512;
+
+// A DDS or KTX image read with readFromMemoryView(), and the file mapping
+// its subresources view; SceneImage::mipViewOwner keeps both alive.
+template <class Image>
+struct MappedImage
+{
+  nvutils::FileReadMapping file;
+  Image                    image;
+};
+
+// Returns the name SceneVk::loadImage() gives an image: its file name.
+std::string getImageName(const tinygltf::Image& gltfImage)
+{
+  std::string uriDecoded;
+  tinygltf::URIDecode(gltfImage.uri, &uriDecoded, nullptr);
+  return nvutils::utf8FromPath(nvutils::pathFromUtf8(uriDecoded).filename());
+}
+
+// Returns a key identifying the encoded bytes of a glTF image and how they
+// are decoded, or nothing if they couldn't be read. This finds the bytes the
+// same way SceneVk::loadImage() does: from the file the URI names, or else
+// from the pixels TinyGLTF decoded for embedded images. `decodeFlags` holds
+// the settings loadImage() depends on, such as the color space.
+std::optional<nvvkgltf::DecodedImageCache::Key> getEncodedImageKey(const std::filesystem::path& basedir,
+                                                                   const tinygltf::Image&       gltfImage,
+                                                                   uint32_t                     decodeFlags)
+{
+  std::string uriDecoded;
+  tinygltf::URIDecode(gltfImage.uri, &uriDecoded, nullptr);
+  const std::filesystem::path uri = basedir / nvutils::pathFromUtf8(uriDecoded);
+
+  nvvkgltf::DecodedImageCache::Key key;
+  nvutils::Sha256                  sha;
+  if(uri.has_extension())
+  {
+    nvutils::FileReadMapping imageFile;
+    if(!imageFile.open(uri))
+    {
+      return {};
+    }
+    key.encodedSize = imageFile.size();
+    sha.updateValue(uint8_t(0));  // A file
+    sha.update({static_cast<const std::byte*>(imageFile.data()), imageFile.size()});
+  }
+  else if(gltfImage.width > 0 && gltfImage.height > 0 && !gltfImage.image.empty())
+  {
+    key.encodedSize = gltfImage.image.size();
+    sha.updateValue(uint8_t(1));  // Pixels
+    sha.update(std::as_bytes(std::span(gltfImage.image)));
+    sha.updateValue(gltfImage.width);
+    sha.updateValue(gltfImage.height);
+  }
+  else
+  {
+    return {};
+  }
+  sha.updateValue(key.encodedSize);
+  sha.updateValue(decodeFlags);
+  key.digest = sha.finish();
+  return key;
+}
 }  // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -173,6 +251,7 @@ static void getShaderMaterial(const tinygltf::Material&                 srcMat,
   int alphaMode = srcMat.alphaMode == "OPAQUE" ? 0 : (srcMat.alphaMode == "MASK" ? 1 : 2 /*BLEND*/);
 
   shaderio::GltfShadeMaterial dstMat = shaderio::defaultGltfMaterial();
+  dstMat._pad1                       = 0;  // Compared by updateMaterialBuffer()
   if(!srcMat.emissiveFactor.empty())
   {
     dstMat.emissiveFactor = glm::make_vec3<double>(srcMat.emissiveFactor.data());
@@ -291,21 +370,22 @@ void nvvkgltf::SceneVk::updateMaterialBuffer(VkCommandBuffer cmd, nvvk::StagingU
   {
     NVVK_CHECK(m_alloc->createBuffer(m_bMaterial, std::span(shadeMaterials).size_bytes(),
                                      VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT));
-    NVVK_CHECK(staging.appendBuffer(m_bMaterial, 0, std::span(shadeMaterials)));
     NVVK_DBG_NAME(m_bMaterial.buffer);
     m_memoryTracker.track(kMemCategorySceneData, m_bMaterial.allocation);
 
     NVVK_CHECK(m_alloc->createBuffer(m_bTextureInfos, std::span(textureInfos).size_bytes(),
                                      VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT));
-    NVVK_CHECK(staging.appendBuffer(m_bTextureInfos, 0, std::span(textureInfos)));
     NVVK_DBG_NAME(m_bTextureInfos.buffer);
     m_memoryTracker.track(kMemCategorySceneData, m_bTextureInfos.allocation);
+
+    m_uploadedMaterials.clear();
+    m_uploadedTextureInfos.clear();
   }
-  else
-  {
-    staging.appendBuffer(m_bMaterial, 0, std::span(shadeMaterials));
-    staging.appendBuffer(m_bTextureInfos, 0, std::span(textureInfos));
-  }
+
+  // Only the materials and texture infos that changed since the last call are uploaded
+  m_materialsUploadStats = {};
+  appendChangedElements(staging, m_bMaterial, std::move(shadeMaterials), m_uploadedMaterials, m_materialsUploadStats);
+  appendChangedElements(staging, m_bTextureInfos, std::move(textureInfos), m_uploadedTextureInfos, m_materialsUploadStats);
 }
 
 // Function to blend positions of a primitive with morph targets
@@ -376,35 +456,73 @@ std::vector<glm::vec3> getSkinnedPositions(const std::span<const glm::vec3>&  ba
   return skinnedPositions;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Inverse of a node's world matrix.
+// glTF node transforms are affine (their last row is 0, 0, 0, 1): inverting
+// the 3x3 part and transforming the translation by it is much cheaper than a
+// general 4x4 inverse. Other matrices fall back to glm::inverse().
+static glm::mat4 inverseWorldMatrix(const glm::mat4& m)
+{
+  if(m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f)
+  {
+    return glm::inverse(m);
+  }
+  const glm::mat3 inv = glm::inverse(glm::mat3(m));
+  glm::mat4       result(inv);
+  result[3] = glm::vec4(-(inv * glm::vec3(m[3])), 1.0f);
+  return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 // Array of instance information
 // - Use by the vertex shader to retrieve the position of the instance
+// - After the first upload, only the nodes that the scene changed since the
+//   last upload (see Scene::getRenderNodeRevisions()) are rebuilt and uploaded
 void nvvkgltf::SceneVk::updateRenderNodesBuffer(VkCommandBuffer cmd, nvvk::StagingUploader& staging, const nvvkgltf::Scene& scn)
 {
   // nvutils::ScopedTimer st(__FUNCTION__);
 
-  std::vector<shaderio::GltfRenderNode> instanceInfo;
-  for(const nvvkgltf::RenderNode& renderNode : scn.getRenderNodes())
-  {
-    shaderio::GltfRenderNode info{};
-    info.objectToWorld = renderNode.worldMatrix;
-    info.worldToObject = glm::inverse(renderNode.worldMatrix);
-    info.materialID    = renderNode.materialID;
-    info.renderPrimID  = renderNode.renderPrimID;
-    instanceInfo.emplace_back(info);
-  }
+  const std::vector<nvvkgltf::RenderNode>& renderNodes = scn.getRenderNodes();
+  const std::vector<uint64_t>&             revisions   = scn.getRenderNodeRevisions();
+
   if(m_bRenderNode.buffer == VK_NULL_HANDLE)
   {
-    NVVK_CHECK(m_alloc->createBuffer(m_bRenderNode, std::span(instanceInfo).size_bytes(),
+    NVVK_CHECK(m_alloc->createBuffer(m_bRenderNode, renderNodes.size() * sizeof(shaderio::GltfRenderNode),
                                      VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT));
-    NVVK_CHECK(staging.appendBuffer(m_bRenderNode, 0, std::span(instanceInfo)));
     NVVK_DBG_NAME(m_bRenderNode.buffer);
     m_memoryTracker.track(kMemCategorySceneData, m_bRenderNode.allocation);
+    m_uploadedRenderNodeCount = 0;
   }
-  else
+
+  // Everything is uploaded the first time, and when the number of render nodes changed.
+  // Batches are multiples of 64 nodes, so that no two threads write to the same word of `dirty`.
+  const bool        deltaUpload = m_uploadedRenderNodeCount == renderNodes.size();
+  nvutils::BitArray dirty(renderNodes.size(), deltaUpload ? 0 : 1);
+  if(deltaUpload)
   {
-    staging.appendBuffer(m_bRenderNode, 0, std::span(instanceInfo));
+    nvutils::parallel_batches<2048>(renderNodes.size(), [&](uint64_t i) {
+      if(revisions[i] > m_uploadedRenderNodesRevision)
+      {
+        dirty.enableBit(i);
+      }
+    });
   }
+
+  m_renderNodesUploadStats = {};
+  appendDirtyRanges<shaderio::GltfRenderNode>(
+      staging, m_bRenderNode, dirty, m_renderNodesUploadStats, [&](uint64_t first, std::span<shaderio::GltfRenderNode> dst) {
+        nvutils::parallel_batches<2048>(dst.size(), [&](uint64_t i) {
+          const nvvkgltf::RenderNode& renderNode = renderNodes[first + i];
+          shaderio::GltfRenderNode    info{};
+          info.objectToWorld = renderNode.worldMatrix;
+          info.worldToObject = inverseWorldMatrix(renderNode.worldMatrix);
+          info.materialID    = renderNode.materialID;
+          info.renderPrimID  = renderNode.renderPrimID;
+          dst[i]             = info;
+        });
+      });
+  m_uploadedRenderNodesRevision = scn.getRevision();
+  m_uploadedRenderNodeCount     = renderNodes.size();
 }
 
 
@@ -423,14 +541,70 @@ void nvvkgltf::SceneVk::updateRenderLightsBuffer(VkCommandBuffer cmd, nvvk::Stag
   {
     NVVK_CHECK(m_alloc->createBuffer(m_bLights, std::span(shaderLights).size_bytes(),
                                      VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT));
-    NVVK_CHECK(staging.appendBuffer(m_bLights, 0, std::span(shaderLights)));
     NVVK_DBG_NAME(m_bLights.buffer);
     m_memoryTracker.track(kMemCategorySceneData, m_bLights.allocation);
+    m_uploadedLights.clear();
   }
-  else
+
+  m_lightsUploadStats = {};
+  appendChangedElements(staging, m_bLights, std::move(shaderLights), m_uploadedLights, m_lightsUploadStats);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Delta uploads
+//
+// appendChangedElements() compares elements with memcmp(), which would also
+// compare padding bytes, whose values are unspecified. These structures have
+// no implicit padding; their explicit padding members are zeroed where they
+// are filled (getShaderMaterial(), getShaderLights()).
+static_assert(sizeof(shaderio::GltfShadeMaterial) == 256 && offsetof(shaderio::GltfShadeMaterial, _pad1) == 254);
+static_assert(sizeof(shaderio::GltfTextureInfo) == sizeof(glm::mat3x2) + 2 * sizeof(int));
+static_assert(sizeof(shaderio::GltfLight) == 3 * sizeof(glm::vec3) + 7 * sizeof(float));
+
+template <typename T, typename WriteElements>
+void nvvkgltf::SceneVk::appendDirtyRanges(nvvk::StagingUploader&   staging,
+                                          const nvvk::Buffer&      buffer,
+                                          const nvutils::BitArray& dirty,
+                                          DeltaUploadStats&        stats,
+                                          WriteElements&&          writeElements)
+{
+  constexpr uint64_t maxGap = kDeltaUploadMaxGapBytes / sizeof(T);
+  for(const nvutils::DirtyRange& range : nvutils::coalesceDirtyRanges(dirty, maxGap))
   {
-    staging.appendBuffer(m_bLights, 0, std::span(shaderLights));
+    T* mapping = nullptr;
+    NVVK_CHECK(staging.appendBufferMapping(buffer, range.first * sizeof(T), range.count * sizeof(T), mapping));
+    writeElements(range.first, std::span<T>(mapping, range.count));
+    stats.rangeCount++;
+    stats.uploadedBytes += range.count * sizeof(T);
   }
+  stats.changedElements += static_cast<uint32_t>(dirty.countSetBits());
+}
+
+template <typename T>
+void nvvkgltf::SceneVk::appendChangedElements(nvvk::StagingUploader& staging,
+                                              const nvvk::Buffer&    buffer,
+                                              std::vector<T>&&       elements,
+                                              std::vector<T>&        uploaded,
+                                              DeltaUploadStats&      stats)
+{
+  // Everything is uploaded the first time, and when the number of elements changed
+  const bool        deltaUpload = uploaded.size() == elements.size();
+  nvutils::BitArray dirty(elements.size(), deltaUpload ? 0 : 1);
+  if(deltaUpload)
+  {
+    for(size_t i = 0; i < elements.size(); i++)
+    {
+      if(memcmp(&elements[i], &uploaded[i], sizeof(T)) != 0)
+      {
+        dirty.enableBit(i);
+      }
+    }
+  }
+
+  uploaded = std::move(elements);
+  appendDirtyRanges<T>(staging, buffer, dirty, stats, [&](uint64_t first, std::span<T> dst) {
+    memcpy(dst.data(), uploaded.data() + first, dst.size_bytes());
+  });
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -460,7 +634,7 @@ void nvvkgltf::SceneVk::updateRenderPrimitivesBuffer(VkCommandBuffer cmd, nvvk::
 
     // Update buffer
     VertexBuffers& vertexBuffers = m_vertexBuffers[renderPrimID];
-    staging.appendBuffer(vertexBuffers.position, 0, std::span(blendedPositions));
+    staging.appendBuffer(vertexBuffers.position, vertexBuffers.offsets.position, std::span(blendedPositions));
   }
 
   // ** Skin **
@@ -517,12 +691,13 @@ void nvvkgltf::SceneVk::updateRenderPrimitivesBuffer(VkCommandBuffer cmd, nvvk::
 
     // Update buffer
     VertexBuffers& vertexBuffers = m_vertexBuffers[skinNode.renderPrimID];
-    staging.appendBuffer(vertexBuffers.position, 0, std::span(skinnedPositions));
+    staging.appendBuffer(vertexBuffers.position, vertexBuffers.offsets.position, std::span(skinnedPositions));
   }
 }
 
 // Function to create attribute buffers in Vulkan only if the attribute is present
 // Return true if a buffer was created, false if the buffer was updated
+// If the buffer is a view of a geometry arena, the data is written at attributeOffset
 template <typename T>
 bool nvvkgltf::SceneVk::updateAttributeBuffer(VkCommandBuffer cmd,               // Command buffer to record the copy
                                               const std::string& attributeName,  // Name of the attribute: POSITION, NORMAL, ...
@@ -530,7 +705,8 @@ bool nvvkgltf::SceneVk::updateAttributeBuffer(VkCommandBuffer cmd,
                                               const tinygltf::Primitive& primitive,  // GLTF primitive
                                               nvvk::ResourceAllocator*   alloc,      // Allocator to create the buffer
                                               nvvk::StagingUploader*     staging,
-                                              nvvk::Buffer&              attributeBuffer)  // Buffer to be created
+                                              nvvk::Buffer&              attributeBuffer,  // Buffer to be created
+                                              VkDeviceSize attributeOffset /*= 0*/)  // Offset of the attribute in the buffer
 {
   const auto& findResult = primitive.attributes.find(attributeName);
   if(findResult != primitive.attributes.end())
@@ -540,6 +716,10 @@ bool nvvkgltf::SceneVk::updateAttributeBuffer(VkCommandBuffer cmd,
     const std::span<const T>  data = tinygltf::utils::getAccessorData(model, accessor, &tempStorage);
     if(data.empty())
     {
+      if(attributeBuffer.allocation == nullptr)
+      {
+        attributeBuffer = {};  // Don't leave a view of an arena range that holds no data
+      }
       return false;  // The data was invalid
     }
 
@@ -555,7 +735,8 @@ bool nvvkgltf::SceneVk::updateAttributeBuffer(VkCommandBuffer cmd,
     }
     else
     {
-      staging->appendBuffer(attributeBuffer, 0, std::span(data));
+      assert(std::span(data).size_bytes() <= attributeBuffer.bufferSize);
+      staging->appendBuffer(attributeBuffer, attributeOffset, std::span(data));
     }
   }
   return false;
@@ -580,9 +761,89 @@ VkBufferUsageFlags2 nvvkgltf::SceneVk::getBufferUsageFlags() const
   return bufferUsageFlag;
 }
 
+//--------------------------------------------------------------------------------------------------
+// Packs the vertex attributes and indices of all primitives into a few large
+// buffers, and makes the primitives' buffers views of their ranges.
+// createVertexBuffers() then only uploads the data at the views' offsets.
+//
+void nvvkgltf::SceneVk::createGeometryArenas(const nvvkgltf::Scene& scn)
+{
+  const tinygltf::Model& model = scn.getModel();
+
+  // Number of elements of an attribute, or 0 if the primitive doesn't have it
+  auto getAttributeCount = [&](const tinygltf::Primitive& primitive, const char* attributeName) -> uint64_t {
+    const auto& findResult = primitive.attributes.find(attributeName);
+    return (findResult != primitive.attributes.end()) ? uint64_t(model.accessors[findResult->second].count) : 0;
+  };
+
+  // Plan the layout, in the order createVertexBuffers() uploads the data
+  struct PrimitiveRanges
+  {
+    GeometryArenaLayout::Range position, normal, tangent, texCoord0, texCoord1, color, indices;
+  };
+  GeometryArenaLayout          layout(m_geometryArenaSize);
+  std::vector<PrimitiveRanges> ranges(scn.getNumRenderPrimitives());
+  for(size_t primID = 0; primID < scn.getNumRenderPrimitives(); primID++)
+  {
+    const tinygltf::Primitive& primitive = *scn.getRenderPrimitive(primID).pPrimitive;
+    PrimitiveRanges&           range     = ranges[primID];
+    range.position  = layout.add(getAttributeCount(primitive, "POSITION") * sizeof(glm::vec3));
+    range.normal    = layout.add(getAttributeCount(primitive, "NORMAL") * sizeof(glm::vec3));
+    range.texCoord0 = layout.add(getAttributeCount(primitive, "TEXCOORD_0") * sizeof(glm::vec2));
+    range.texCoord1 = layout.add(getAttributeCount(primitive, "TEXCOORD_1") * sizeof(glm::vec2));
+    range.tangent   = layout.add(getAttributeCount(primitive, "TANGENT") * sizeof(glm::vec4));
+    range.color     = layout.add(getAttributeCount(primitive, "COLOR_0") * sizeof(uint32_t));  // Packed in a uint
+
+    const uint64_t indexCount =
+        (primitive.indices > -1) ? uint64_t(model.accessors[primitive.indices].count) : getAttributeCount(primitive, "POSITION");
+    range.indices = layout.add(indexCount * sizeof(uint32_t));
+  }
+
+  // Create the arenas
+  m_geometryArenas.resize(layout.getArenaCount());
+  for(uint32_t arenaID = 0; arenaID < layout.getArenaCount(); arenaID++)
+  {
+    nvvk::Buffer& arena = m_geometryArenas[arenaID];
+    NVVK_CHECK(m_alloc->createBuffer(arena, layout.getArenaSizes()[arenaID],
+                                     getBufferUsageFlags() | VK_BUFFER_USAGE_2_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT));
+    NVVK_DBG_NAME(arena.buffer);
+    m_memoryTracker.track(kMemCategoryGeometry, arena.allocation);
+  }
+
+  // Views don't own an allocation, which is how destroy() tells them apart
+  auto makeView = [&](const GeometryArenaLayout::Range& range, nvvk::Buffer& view, VkDeviceSize& offset) {
+    if(!range.isValid())
+    {
+      return;
+    }
+    const nvvk::Buffer& arena = m_geometryArenas[range.arena];
+    view.buffer               = arena.buffer;
+    view.bufferSize           = range.size;
+    view.address              = arena.address + range.offset;
+    view.mapping              = arena.mapping ? arena.mapping + range.offset : nullptr;
+    offset                    = range.offset;
+  };
+  for(size_t primID = 0; primID < scn.getNumRenderPrimitives(); primID++)
+  {
+    const PrimitiveRanges& range         = ranges[primID];
+    VertexBuffers&         vertexBuffers = m_vertexBuffers[primID];
+    makeView(range.position, vertexBuffers.position, vertexBuffers.offsets.position);
+    makeView(range.normal, vertexBuffers.normal, vertexBuffers.offsets.normal);
+    makeView(range.texCoord0, vertexBuffers.texCoord0, vertexBuffers.offsets.texCoord0);
+    makeView(range.texCoord1, vertexBuffers.texCoord1, vertexBuffers.offsets.texCoord1);
+    makeView(range.tangent, vertexBuffers.tangent, vertexBuffers.offsets.tangent);
+    makeView(range.color, vertexBuffers.color, vertexBuffers.offsets.color);
+    makeView(range.indices, m_bIndices[primID], m_indexOffsets[primID]);
+  }
+
+  LOGI("Geometry arenas: %u buffers, %" PRIu64 " bytes (%" PRIu64 " bytes of padding)\n", layout.getArenaCount(),
+       layout.getTotalSize(), layout.getPaddingBytes());
+}
+
 //--------------------------------------------------------------------------------------------------
 // Creating information per primitive
-// - Create a buffer of Vertex and Index for each primitive
+// - Create a buffer of Vertex and Index for each primitive, or views of the
+//   geometry arenas if they are enabled
 // - Each primInfo has a reference to the vertex and index buffer, and which material id it uses
 //
 void nvvkgltf::SceneVk::createVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUploader& staging, const nvvkgltf::Scene& scn)
@@ -595,20 +856,29 @@ void nvvkgltf::SceneVk::createVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUp
 
   size_t numUniquePrimitive = scn.getNumRenderPrimitives();
   m_bIndices.resize(numUniquePrimitive);
+  m_indexOffsets.assign(numUniquePrimitive, 0);
   m_vertexBuffers.resize(numUniquePrimitive);
   renderPrim.resize(numUniquePrimitive);
 
+  if(m_geometryArenaSize > 0)
+  {
+    createGeometryArenas(scn);
+  }
+
   for(size_t primID = 0; primID < scn.getNumRenderPrimitives(); primID++)
   {
     const tinygltf::Primitive& primitive     = *scn.getRenderPrimitive(primID).pPrimitive;
     const tinygltf::Mesh&      mesh          = model.meshes[scn.getRenderPrimitive(primID).meshID];
     VertexBuffers&             vertexBuffers = m_vertexBuffers[primID];
 
-    updateAttributeBuffer<glm::vec3>(cmd, "POSITION", model, primitive, m_alloc, &staging, vertexBuffers.position);
-    updateAttributeBuffer<glm::vec3>(cmd, "NORMAL", model, primitive, m_alloc, &staging, vertexBuffers.normal);
-    updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_0", model, primitive, m_alloc, &staging, vertexBuffers.texCoord0);
-    updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_1", model, primitive, m_alloc, &staging, vertexBuffers.texCoord1);
-    updateAttributeBuffer<glm::vec4>(cmd, "TANGENT", model, primitive, m_alloc, &staging, vertexBuffers.tangent);
+    const VertexBuffers::Offsets& offsets = vertexBuffers.offsets;
+    updateAttributeBuffer<glm::vec3>(cmd, "POSITION", model, primitive, m_alloc, &staging, vertexBuffers.position, offsets.position);
+    updateAttributeBuffer<glm::vec3>(cmd, "NORMAL", model, primitive, m_alloc, &staging, vertexBuffers.normal, offsets.normal);
+    updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_0", model, primitive, m_alloc, &staging, vertexBuffers.texCoord0,
+                                     offsets.texCoord0);
+    updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_1", model, primitive, m_alloc, &staging, vertexBuffers.texCoord1,
+                                     offsets.texCoord1);
+    updateAttributeBuffer<glm::vec4>(cmd, "TANGENT", model, primitive, m_alloc, &staging, vertexBuffers.tangent, offsets.tangent);
 
     if(tinygltf::utils::hasElementName(primitive.attributes, "COLOR_0"))
     {
@@ -638,24 +908,27 @@ void nvvkgltf::SceneVk::createVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUp
         assert(!"Unknown color type");
       }
 
-      NVVK_CHECK(m_alloc->createBuffer(vertexBuffers.color, std::span(tempIntData).size_bytes(),
-                                       getBufferUsageFlags() | VK_BUFFER_USAGE_2_VERTEX_BUFFER_BIT));
-      NVVK_CHECK(staging.appendBuffer(vertexBuffers.color, 0, std::span(tempIntData)));
-      m_memoryTracker.track(kMemCategoryGeometry, vertexBuffers.color.allocation);
+      if(vertexBuffers.color.buffer == VK_NULL_HANDLE)
+      {
+        NVVK_CHECK(m_alloc->createBuffer(vertexBuffers.color, std::span(tempIntData).size_bytes(),
+                                         getBufferUsageFlags() | VK_BUFFER_USAGE_2_VERTEX_BUFFER_BIT));
+        m_memoryTracker.track(kMemCategoryGeometry, vertexBuffers.color.allocation);
+      }
+      NVVK_CHECK(staging.appendBuffer(vertexBuffers.color, offsets.color, std::span(tempIntData)));
     }
 
-    // Debug name
-    if(vertexBuffers.position.buffer != VK_NULL_HANDLE)
+    // Debug name (arenas are named when created)
+    if(vertexBuffers.position.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.position.buffer);
-    if(vertexBuffers.normal.buffer != VK_NULL_HANDLE)
+    if(vertexBuffers.normal.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.normal.buffer);
-    if(vertexBuffers.texCoord0.buffer != VK_NULL_HANDLE)
+    if(vertexBuffers.texCoord0.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.texCoord0.buffer);
-    if(vertexBuffers.texCoord1.buffer != VK_NULL_HANDLE)
+    if(vertexBuffers.texCoord1.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.texCoord1.buffer);
-    if(vertexBuffers.tangent.buffer != VK_NULL_HANDLE)
+    if(vertexBuffers.tangent.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.tangent.buffer);
-    if(vertexBuffers.color.buffer != VK_NULL_HANDLE)
+    if(vertexBuffers.color.allocation != nullptr)
       NVVK_DBG_NAME(vertexBuffers.color.buffer);
 
 
@@ -678,11 +951,14 @@ void nvvkgltf::SceneVk::createVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUp
 
     // Creating the buffer for the indices
     nvvk::Buffer& i_buffer = m_bIndices[primID];
-    NVVK_CHECK(m_alloc->createBuffer(i_buffer, std::span(indexBuffer).size_bytes(),
-                                     getBufferUsageFlags() | VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT));
-    NVVK_CHECK(staging.appendBuffer(i_buffer, 0, std::span(indexBuffer)));
-    NVVK_DBG_NAME(i_buffer.buffer);
-    m_memoryTracker.track(kMemCategoryGeometry, i_buffer.allocation);
+    if(i_buffer.buffer == VK_NULL_HANDLE)
+    {
+      NVVK_CHECK(m_alloc->createBuffer(i_buffer, std::span(indexBuffer).size_bytes(),
+                                       getBufferUsageFlags() | VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT));
+      NVVK_DBG_NAME(i_buffer.buffer);
+      m_memoryTracker.track(kMemCategoryGeometry, i_buffer.allocation);
+    }
+    NVVK_CHECK(staging.appendBuffer(i_buffer, m_indexOffsets[primID], std::span(indexBuffer)));
 
     // Filling the primitive information
     renderPrim[primID].indices = (glm::uvec3*)i_buffer.address;
@@ -725,12 +1001,17 @@ void nvvkgltf::SceneVk::updateVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUp
   {
     const tinygltf::Primitive& primitive     = *scene.getRenderPrimitive(primID).pPrimitive;
     VertexBuffers&             vertexBuffers = m_vertexBuffers[primID];
-    bool                       newBuffer     = false;
-    updateAttributeBuffer<glm::vec3>(cmd, "POSITION", model, primitive, m_alloc, &staging, vertexBuffers.position);
-    newBuffer |= updateAttributeBuffer<glm::vec3>(cmd, "NORMAL", model, primitive, m_alloc, &staging, vertexBuffers.normal);
-    newBuffer |= updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_0", model, primitive, m_alloc, &staging, vertexBuffers.texCoord0);
-    newBuffer |= updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_1", model, primitive, m_alloc, &staging, vertexBuffers.texCoord1);
-    newBuffer |= updateAttributeBuffer<glm::vec4>(cmd, "TANGENT", model, primitive, m_alloc, &staging, vertexBuffers.tangent);
+    const VertexBuffers::Offsets& offsets       = vertexBuffers.offsets;
+    bool                          newBuffer     = false;
+    updateAttributeBuffer<glm::vec3>(cmd, "POSITION", model, primitive, m_alloc, &staging, vertexBuffers.position, offsets.position);
+    newBuffer |= updateAttributeBuffer<glm::vec3>(cmd, "NORMAL", model, primitive, m_alloc, &staging,
+                                                  vertexBuffers.normal, offsets.normal);
+    newBuffer |= updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_0", model, primitive, m_alloc, &staging,
+                                                  vertexBuffers.texCoord0, offsets.texCoord0);
+    newBuffer |= updateAttributeBuffer<glm::vec2>(cmd, "TEXCOORD_1", model, primitive, m_alloc, &staging,
+                                                  vertexBuffers.texCoord1, offsets.texCoord1);
+    newBuffer |= updateAttributeBuffer<glm::vec4>(cmd, "TANGENT", model, primitive, m_alloc, &staging,
+                                                  vertexBuffers.tangent, offsets.tangent);
 
     // A buffer was created (most likely tangent buffer), we need to update the RenderPrimitive buffer
     if(newBuffer)
@@ -844,29 +1125,127 @@ void nvvkgltf::SceneVk::createTextureImages(VkCommandBuffer              cmd,
     usedImages.insert(source_image);
   }
 
-  // Load images in parallel
+  // Find images whose encoded bytes are identical (and that are used with the
+  // same color space); only the first of each is decoded and uploaded, and
+  // the others share its nvvk::Image.
   m_images.resize(model.images.size());
-  uint32_t          num_threads = std::min((uint32_t)model.images.size(), std::thread::hardware_concurrency());
-  const std::string indent      = st.indent();
-  nvutils::parallel_batches<1>(  // Not batching
-      model.images.size(),
-      [&](uint64_t i) {
-        if(usedImages.find(static_cast<int>(i)) == usedImages.end())
-          return;  // Skip unused images
-        const auto& image     = model.images[i];
-        const char* imageName = image.uri.empty() ? "Embedded image" : image.uri.c_str();
-        LOGI("%s(%" PRIu64 ") %s \n", indent.c_str(), i, imageName);
-        loadImage(basedir, image, static_cast<int>(i));
-      },
-      num_threads);
-
-  // Create Vulkan images
-  for(size_t i = 0; i < m_images.size(); i++)
+  // Images are identified by the size and SHA-256 digest of their encoded
+  // bytes, plus the settings loadImage() decodes them with.
+  const uint32_t decodeFlags = (m_generateMipmaps ? 1u : 0u) | (m_cpuMipGeneration ? 2u : 0u);
+  std::vector<std::optional<DecodedImageCache::Key>> contentKeys(model.images.size());
+  nvutils::parallel_batches<1>(model.images.size(), [&](uint64_t i) {
+    if(usedImages.find(static_cast<int>(i)) != usedImages.end())
+    {
+      const bool isSrgb = m_sRgbImages.find(static_cast<int>(i)) != m_sRgbImages.end();
+      contentKeys[i]    = getEncodedImageKey(basedir, model.images[i], decodeFlags | (isSrgb ? 4u : 0u));
+    }
+  });
+  std::vector<int>                                                             firstWithContent(model.images.size(), -1);
+  std::unordered_map<DecodedImageCache::Key, int, DecodedImageCache::KeyHash> contentToImage;
+  for(size_t i = 0; i < model.images.size(); i++)
   {
+    if(contentKeys[i].has_value())
+    {
+      const auto [it, inserted] = contentToImage.try_emplace(*contentKeys[i], static_cast<int>(i));
+      if(!inserted)
+      {
+        firstWithContent[i] = it->second;
+      }
+    }
+  }
+
+  // Decode images on worker threads and create the Vulkan images on this
+  // thread as each one finishes, so that decoded images don't accumulate.
+  // Each image's mip levels are released as soon as they've been copied to
+  // staging.
+  // Decoded images are looked up in and added to the DecodedImageCache.
+  DecodedImageCache&    cache     = DecodedImageCache::getInstance();
+  const bool            useCache  = cache.isEnabled();
+  std::atomic<uint32_t> cacheHits = 0;
+  std::vector<uint64_t> decodedBytes(model.images.size(), 0);
+  const std::string     indent = st.indent();
+
+  auto decode = [&](uint64_t i) -> uint64_t {
+    if(usedImages.find(static_cast<int>(i)) == usedImages.end() || firstWithContent[i] >= 0)
+      return 0;  // Skip unused and duplicate images
+    const auto& image      = model.images[i];
+    const char* imageName  = image.uri.empty() ? "Embedded image" : image.uri.c_str();
+    SceneImage& sceneImage = m_images[i];
+
+    std::shared_ptr<const DecodedImageCache::Entry> cached;
+    if(useCache && contentKeys[i].has_value())
+    {
+      cached = cache.find(*contentKeys[i]);
+    }
+    if(cached)
+    {
+      LOGI("%s(%" PRIu64 ") %s (cached)\n", indent.c_str(), i, imageName);
+      cacheHits++;
+      sceneImage.srgb    = m_sRgbImages.find(static_cast<int>(i)) != m_sRgbImages.end();
+      sceneImage.imgName = getImageName(image);
+      sceneImage.size          = cached->size;
+      sceneImage.format        = cached->format;
+      sceneImage.decodedFormat = cached->decodedFormat;
+      sceneImage.mipViews.assign(cached->mipData.begin(), cached->mipData.end());
+      sceneImage.mipViewOwner = std::move(cached);
+    }
+    else
+    {
+      LOGI("%s(%" PRIu64 ") %s \n", indent.c_str(), i, imageName);
+      loadImage(basedir, image, static_cast<int>(i));
+      if(useCache && contentKeys[i].has_value() && sceneImage.getMipCount() > 0)
+      {
+        DecodedImageCache::Entry entry{sceneImage.size, sceneImage.format, sceneImage.decodedFormat};
+        for(size_t mip = 0; mip < sceneImage.getMipCount(); mip++)
+        {
+          const std::span<const char> texels = sceneImage.getMip(mip);
+          entry.mipData.emplace_back(texels.begin(), texels.end());
+        }
+        cache.insert(*contentKeys[i], std::move(entry));
+      }
+    }
+
+    for(size_t mip = 0; mip < sceneImage.getMipCount(); mip++)
+    {
+      decodedBytes[i] += sceneImage.getMip(mip).size();
+    }
+    return decodedBytes[i];
+  };
+  auto upload = [&](uint64_t i) {
+    if(firstWithContent[i] >= 0)
+      return;  // Shares the image created for firstWithContent[i] below
     if(!createImage(cmd, staging, m_images[i]))
     {
       addDefaultImage((uint32_t)i, {255, 0, 255, 255});  // Image not present or incorrectly loaded (image.empty)
     }
+    m_images[i].releaseMips();
+  };
+
+  nvutils::BoundedPipelineSettings pipelineSettings;
+  pipelineSettings.memoryBudget = m_imageDecodeBudget;
+  const nvutils::BoundedPipelineStats pipelineStats =
+      nvutils::parallel_produce_consume(model.images.size(), decode, upload, pipelineSettings);
+  LOGI("%sPeak decoded image memory: %.1f MiB\n", indent.c_str(), double(pipelineStats.peakBytes) / (1024.0 * 1024.0));
+
+  m_imageDedupStats = {};
+  for(size_t i = 0; i < model.images.size(); i++)
+  {
+    const int first = firstWithContent[i];
+    if(first >= 0)
+    {
+      SceneImage& image = m_images[i];
+      image             = m_images[first];
+      image.shared      = true;
+      m_imageDedupStats.duplicateCount++;
+      m_imageDedupStats.savedBytes += decodedBytes[first];
+    }
+  }
+  m_imageDedupStats.cacheHits = cacheHits.load();
+  if(m_imageDedupStats.duplicateCount > 0 || m_imageDedupStats.cacheHits > 0)
+  {
+    LOGI("%s%u duplicate images share another image (%.1f MiB not decoded or uploaded); %u images came from the cache\n",
+         indent.c_str(), m_imageDedupStats.duplicateCount, double(m_imageDedupStats.savedBytes) / (1024.0 * 1024.0),
+         m_imageDedupStats.cacheHits);
   }
 
   // Add default image if nothing was loaded
@@ -968,8 +1347,9 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
 {
   namespace fs = std::filesystem;
 
-  auto& image  = m_images[imageID];
-  bool  isSrgb = m_sRgbImages.find(imageID) != m_sRgbImages.end();
+  auto& image           = m_images[imageID];
+  bool  isSrgb          = m_sRgbImages.find(imageID) != m_sRgbImages.end();
+  bool  fileAsksForMips = false;  // A KTX file without mips that asks the app to generate them
 
   std::string uriDecoded;  // This is UTF-8, but TinyGlTF uses `char` instead of `char8_t` for it
   tinygltf::URIDecode(gltfImage.uri, &uriDecoded, nullptr);  // ex. whitespace may be represented as %20
@@ -978,10 +1358,19 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
 
   if(nvutils::extensionMatches(uri, ".dds"))
   {
-    nv_dds::Image               ddsImage{};
+    // Map the file and read it without copying; createImage() then copies
+    // mips straight from the mapping (or from the decompressed data) into
+    // staging memory.
+    auto mapped = std::make_shared<MappedImage<nv_dds::Image>>();
+    if(!mapped->file.open(uri))
+    {
+      LOGW("Could not open %s\n", nvutils::utf8FromPath(uri).c_str());
+      return;
+    }
+    nv_dds::Image&              ddsImage = mapped->image;
     nv_dds::ReadSettings        settings{};
-    std::ifstream               imageFile(uri, std::ios::binary);
-    const nv_dds::ErrorWithText readResult = ddsImage.readFromStream(imageFile, settings);
+    const nv_dds::ErrorWithText readResult = ddsImage.readFromMemoryView(
+        std::span<const std::byte>(static_cast<const std::byte*>(mapped->file.data()), mapped->file.size()), settings);
     if(readResult.has_value())
     {
       LOGW("Failed to read %s using nv_dds: %s\n", nvutils::utf8FromPath(uri).c_str(), readResult.value().c_str());
@@ -1015,19 +1404,28 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
       return;
     }
 
-    // Add all mip-levels. We don't need the ddsImage after this so we can move instead of copy.
+    // Add all mip-levels as views of the mapping or of ddsImage's data.
     for(uint32_t i = 0; i < ddsImage.getNumMips(); i++)
     {
-      std::vector<char>& mip = ddsImage.subresource(i, 0, 0).data;
-      image.mipData.push_back(std::move(mip));
+      image.mipViews.push_back(ddsImage.subresource(i, 0, 0).bytes());
     }
+    image.mipViewOwner = std::move(mapped);
   }
   else if(nvutils::extensionMatches(uri, ".ktx") || nvutils::extensionMatches(uri, ".ktx2"))
   {
-    nv_ktx::KTXImage            ktxImage;
+    // Map the file so that uncompressed mips are copied once, straight from
+    // the mapping into staging memory, and supercompressed mips are inflated
+    // straight from the mapping.
+    auto mapped = std::make_shared<MappedImage<nv_ktx::KTXImage>>();
+    if(!mapped->file.open(uri))
+    {
+      LOGW("Could not open %s\n", nvutils::utf8FromPath(uri).c_str());
+      return;
+    }
+    nv_ktx::KTXImage&           ktxImage = mapped->image;
     const nv_ktx::ReadSettings  ktxReadSettings;
-    std::ifstream               imageFile(uri, std::ios::binary);
-    const nv_ktx::ErrorWithText maybeError = ktxImage.readFromStream(imageFile, ktxReadSettings);
+    const nv_ktx::ErrorWithText maybeError = ktxImage.readFromMemoryView(
+        std::span<const std::byte>(static_cast<const std::byte*>(mapped->file.data()), mapped->file.size()), ktxReadSettings);
     if(maybeError.has_value())
     {
       LOGW("Failed to read %s using nv_ktx: %s\n", nvutils::utf8FromPath(uri).c_str(), maybeError->c_str());
@@ -1052,14 +1450,15 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
       LOGW("This KTX image had %u array elements, but loadImage() cannot handle array textures.\n", ktxImage.num_layers_possibly_0);
       return;
     }
-    image.format = texture_formats::tryForceVkFormatTransferFunction(ktxImage.format, image.srgb);
+    image.format    = texture_formats::tryForceVkFormatTransferFunction(ktxImage.format, image.srgb);
+    fileAsksForMips = ktxImage.app_should_generate_mips;
 
-    // Add all mip-levels. We don't need the ktxImage after this so we can move instead of copy.
+    // Add all mip-levels as views of the mapping or of ktxImage's data.
     for(uint32_t i = 0; i < ktxImage.num_mips; i++)
     {
-      std::vector<char>& mip = ktxImage.subresource(i, 0, 0);
-      image.mipData.push_back(std::move(mip));
+      image.mipViews.push_back(ktxImage.subresourceBytes(i, 0, 0));
     }
+    image.mipViewOwner = std::move(mapped);
   }
   else if(uri.has_extension())
   {
@@ -1090,10 +1489,15 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
     // Read the header again to check if it has 16 bit data, e.g. for a heightmap.
     const bool is16Bit = stbi_is_16_bit_from_memory(imageFileData, imageFileSize);
 
+    // 8-bit RGB images are loaded as RGB, then expanded to RGBA by
+    // createImage() directly into staging memory, instead of by stb_image
+    // into a temporary buffer.
+    const bool expandRgb = !is16Bit && comp == 3;
+
     // Load the image
     stbi_uc* data = nullptr;
     size_t   bytesPerPixel{0};
-    int      requiredComponents = comp == 1 ? 1 : 4;
+    int      requiredComponents = (comp == 1 || expandRgb) ? comp : 4;
     if(is16Bit)
     {
       stbi_us* data16 = stbi_load_16_from_memory(imageFileData, imageFileSize, &w, &h, &comp, requiredComponents);
@@ -1110,6 +1514,9 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
       case 1:
         image.format = is16Bit ? VK_FORMAT_R16_UNORM : VK_FORMAT_R8_UNORM;
         break;
+      case 3:
+        image.format = isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        break;
       case 4:
         image.format = is16Bit ? VK_FORMAT_R16G16B16A16_UNORM :
                        isSrgb  ? VK_FORMAT_R8G8B8A8_SRGB :
@@ -1118,27 +1525,74 @@ void nvvkgltf::SceneVk::loadImage(const std::filesystem::path& basedir, const ti
         break;
     }
 
-    // Make a copy of the image data to be uploaded to vulkan later
+    // Hand stb_image's buffer over to createImage(), which copies it straight
+    // into staging memory.
+    std::shared_ptr<void> decoded(data, stbi_image_free);
     if(data && w > 0 && h > 0 && image.format != VK_FORMAT_UNDEFINED)
     {
-      VkDeviceSize bufferSize = static_cast<VkDeviceSize>(w) * h * bytesPerPixel;
+      const size_t bufferSize = static_cast<size_t>(w) * h * bytesPerPixel;
       image.size              = VkExtent2D{(uint32_t)w, (uint32_t)h};
-      image.mipData           = {{data, data + bufferSize}};
+      image.mipViews          = {{reinterpret_cast<const char*>(data), bufferSize}};
+      image.mipViewOwner      = std::move(decoded);
+      if(expandRgb)
+      {
+        image.decodedFormat = isSrgb ? VK_FORMAT_R8G8B8_SRGB : VK_FORMAT_R8G8B8_UNORM;
+      }
     }
-
-    stbi_image_free(data);
   }
   else if(gltfImage.width > 0 && gltfImage.height > 0 && !gltfImage.image.empty())
   {  // Loaded internally using GLB
     image.size   = VkExtent2D{(uint32_t)gltfImage.width, (uint32_t)gltfImage.height};
     image.format = isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
-    image.mipData.emplace_back(gltfImage.image.data(), gltfImage.image.data() + gltfImage.image.size());
+    // The model outlives createTextureImages(), so its pixels can be viewed.
+    image.mipViews = {{reinterpret_cast<const char*>(gltfImage.image.data()), gltfImage.image.size()}};
+  }
+
+  // createImage() generates the mips of single-mip images with blits. Generate
+  // them here instead if asked to, or if the device can't blit to the format.
+  if(image.getMipCount() != 1 || !(m_generateMipmaps || fileAsksForMips))
+    return;
+  VkFormatProperties formatProperties{};
+  vkGetPhysicalDeviceFormatProperties(m_physicalDevice, image.format, &formatProperties);
+  const bool canBlit = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT) != 0;
+  if(canBlit && !m_cpuMipGeneration && !fileAsksForMips)
+    return;
+
+  // Mips are generated in the decoded format; createImage() converts each one.
+  const VkFormat mipFormat = (image.decodedFormat != VK_FORMAT_UNDEFINED) ? image.decodedFormat : image.format;
+  if(!mip_generation::isFormatSupported(mipFormat))
+    return;  // createImage() blits if it can
+  nv_ktx::KTXImage mips;
+  mips.format       = mipFormat;
+  mips.mip_0_width  = image.size.width;
+  mips.mip_0_height = image.size.height;
+  mip_generation::ErrorWithText err = mips.allocate(1, 0, 1);
+  if(!err.has_value())
+  {
+    const std::span<const char> mip0 = image.getMip(0);
+    mips.subresource(0, 0, 0).assign(mip0.begin(), mip0.end());
+    // Filter in the color space the image is sampled in.
+    mip_generation::Settings settings;
+    settings.colorSpace = texture_formats::isVkFormatSRGB(image.format) ? mip_generation::ColorSpace::eSRGB :
+                                                                          mip_generation::ColorSpace::eLinear;
+    err = mip_generation::generateMips(mips, settings);
+  }
+  if(err.has_value())
+  {
+    LOGW("Failed to generate mips for %s: %s\n", image.imgName.c_str(), err->c_str());
+    return;
+  }
+  image.releaseMips();
+  image.mipData.resize(mips.num_mips);
+  for(uint32_t mip = 0; mip < mips.num_mips; mip++)
+  {
+    image.mipData[mip] = std::move(mips.subresource(mip, 0, 0));
   }
 }
 
 bool nvvkgltf::SceneVk::createImage(const VkCommandBuffer& cmd, nvvk::StagingUploader& staging, SceneImage& image)
 {
-  if(image.size.width == 0 || image.size.height == 0)
+  if(image.size.width == 0 || image.size.height == 0 || image.getMipCount() == 0)
     return false;
 
   VkFormat   format  = image.format;
@@ -1158,9 +1612,10 @@ bool nvvkgltf::SceneVk::createImage(const VkCommandBuffer& cmd, nvvk::StagingUpl
   imageCreateInfo.usage             = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
   // Mip-mapping images were defined (.ktx, .dds), use the number of levels defined
-  if(image.mipData.size() > 1)
+  const uint32_t numMips = static_cast<uint32_t>(image.getMipCount());
+  if(numMips > 1)
   {
-    imageCreateInfo.mipLevels = static_cast<uint32_t>(image.mipData.size());
+    imageCreateInfo.mipLevels = numMips;
   }
   else if(canGenerateMipmaps && m_generateMipmaps)
   {
@@ -1176,14 +1631,42 @@ bool nvvkgltf::SceneVk::createImage(const VkCommandBuffer& cmd, nvvk::StagingUpl
   // Track the image allocation
   m_memoryTracker.track(kMemCategoryImages, resultImage.allocation);
 
+  // Appends the copy of a mip level. Its texels are written into staging
+  // memory once: copied as-is, or converted from image.decodedFormat.
+  auto appendMip = [&](uint32_t mip, VkImageLayout newLayout) {
+    const std::span<const char> texels = image.getMip(mip);
+    const VkExtent3D            extent{std::max(1u, imgSize.width >> mip), std::max(1u, imgSize.height >> mip), 1};
+    VkImageSubresourceLayers    subresource{};
+    subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    subresource.layerCount = 1;
+    subresource.mipLevel   = mip;
+
+    if(image.decodedFormat == VK_FORMAT_UNDEFINED || image.decodedFormat == format)
+    {
+      NVVK_CHECK(staging.appendImageSub(resultImage, {}, extent, subresource, texels, newLayout));
+      return;
+    }
+
+    const size_t dstSize = size_t(extent.width) * extent.height * texture_conversion::getTexelSizeBytes(format);
+    char*        mapping = nullptr;
+    NVVK_CHECK(staging.appendImageSubMapping(resultImage, {}, extent, subresource, dstSize, mapping, newLayout));
+    const texture_conversion::ErrorWithText err =
+        texture_conversion::convert(image.decodedFormat, texels, format, {mapping, dstSize}, extent.width, extent.height);
+    if(err.has_value())
+    {
+      LOGW("Failed to convert %s from %s to %s: %s\n", image.imgName.c_str(), texture_formats::getVkFormatName(image.decodedFormat),
+           texture_formats::getVkFormatName(format), err->c_str());
+    }
+  };
+
   // Set the initial layout to TRANSFER_DST_OPTIMAL
   resultImage.descriptor.imageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;  // Setting this, tells the appendImage that the image is in this layout (no need to transfer)
   nvvk::cmdImageMemoryBarrier(cmd, {resultImage.image, VK_IMAGE_LAYOUT_UNDEFINED, resultImage.descriptor.imageLayout});
-  NVVK_CHECK(staging.appendImage(resultImage, std::span(image.mipData[0]), resultImage.descriptor.imageLayout));
+  appendMip(0, resultImage.descriptor.imageLayout);
   staging.cmdUploadAppended(cmd);  // Upload the first mip level
 
   // The image require to generate the mipmaps
-  if(image.mipData.size() == 1 && (canGenerateMipmaps && m_generateMipmaps))
+  if(numMips == 1 && (canGenerateMipmaps && m_generateMipmaps))
   {
     nvvk::cmdGenerateMipmaps(cmd, resultImage.image, imgSize, imageCreateInfo.mipLevels, 1, resultImage.descriptor.imageLayout);
   }
@@ -1191,19 +1674,7 @@ bool nvvkgltf::SceneVk::createImage(const VkCommandBuffer& cmd, nvvk::StagingUpl
   {
     for(uint32_t mip = 1; mip < (uint32_t)imageCreateInfo.mipLevels; mip++)
     {
-      imageCreateInfo.extent.width  = std::max(1u, image.size.width >> mip);
-      imageCreateInfo.extent.height = std::max(1u, image.size.height >> mip);
-
-      VkOffset3D               offset{};
-      VkImageSubresourceLayers subresource{};
-      subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      subresource.layerCount = 1;
-      subresource.mipLevel   = mip;
-
-      if(imageCreateInfo.extent.width > 0 && imageCreateInfo.extent.height > 0)
-      {
-        staging.appendImageSub(resultImage, offset, imageCreateInfo.extent, subresource, std::span(image.mipData[mip]));
-      }
+      appendMip(mip, VK_IMAGE_LAYOUT_UNDEFINED);
     }
     // Upload all the mip levels
     staging.cmdUploadAppended(cmd);
@@ -1221,10 +1692,10 @@ bool nvvkgltf::SceneVk::createImage(const VkCommandBuffer& cmd, nvvk::StagingUpl
     NVVK_DBG_NAME(resultImage.image);
   }
 
-  // Clear image.mipData as it is no longer needed
+  // Release the mip levels as they are no longer needed
   // image.srgb and image.imgName are preserved
   image.imageTexture = resultImage;
-  image.mipData.clear();
+  image.releaseMips();
 
   return true;
 }
@@ -1272,34 +1743,35 @@ std::vector<shaderio::GltfLight> getShaderLights(const std::vector<nvvkgltf::Ren
 
 void nvvkgltf::SceneVk::destroy()
 {
+  // Buffers without an allocation are views of the geometry arenas
   for(auto& vertexBuffer : m_vertexBuffers)
   {
-    if(vertexBuffer.position.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.position.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.position.allocation);
       m_alloc->destroyBuffer(vertexBuffer.position);
     }
-    if(vertexBuffer.normal.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.normal.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.normal.allocation);
       m_alloc->destroyBuffer(vertexBuffer.normal);
     }
-    if(vertexBuffer.tangent.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.tangent.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.tangent.allocation);
       m_alloc->destroyBuffer(vertexBuffer.tangent);
     }
-    if(vertexBuffer.texCoord0.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.texCoord0.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.texCoord0.allocation);
       m_alloc->destroyBuffer(vertexBuffer.texCoord0);
     }
-    if(vertexBuffer.texCoord1.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.texCoord1.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.texCoord1.allocation);
       m_alloc->destroyBuffer(vertexBuffer.texCoord1);
     }
-    if(vertexBuffer.color.buffer != VK_NULL_HANDLE)
+    if(vertexBuffer.color.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, vertexBuffer.color.allocation);
       m_alloc->destroyBuffer(vertexBuffer.color);
@@ -1309,13 +1781,21 @@ void nvvkgltf::SceneVk::destroy()
 
   for(auto& indicesBuffer : m_bIndices)
   {
-    if(indicesBuffer.buffer != VK_NULL_HANDLE)
+    if(indicesBuffer.allocation != nullptr)
     {
       m_memoryTracker.untrack(kMemCategoryGeometry, indicesBuffer.allocation);
       m_alloc->destroyBuffer(indicesBuffer);
     }
   }
   m_bIndices.clear();
+  m_indexOffsets.clear();
+
+  for(auto& arena : m_geometryArenas)
+  {
+    m_memoryTracker.untrack(kMemCategoryGeometry, arena.allocation);
+    m_alloc->destroyBuffer(arena);
+  }
+  m_geometryArenas.clear();
 
   if(m_bMaterial.buffer != VK_NULL_HANDLE)
   {
@@ -1347,6 +1827,10 @@ void nvvkgltf::SceneVk::destroy()
     m_memoryTracker.untrack(kMemCategorySceneData, m_bSceneDesc.allocation);
     m_alloc->destroyBuffer(m_bSceneDesc);
   }
+  m_uploadedRenderNodeCount = 0;
+  m_uploadedMaterials.clear();
+  m_uploadedTextureInfos.clear();
+  m_uploadedLights.clear();
 
   for(auto& texture : m_textures)
   {
@@ -1354,7 +1838,7 @@ void nvvkgltf::SceneVk::destroy()
   }
   for(auto& image : m_images)
   {
-    if(image.imageTexture.image != VK_NULL_HANDLE)
+    if(image.imageTexture.image != VK_NULL_HANDLE && !image.shared)
     {
       m_memoryTracker.untrack(kMemCategoryImages, image.imageTexture.allocation);
       m_alloc->destroyImage(image.imageTexture);
@@ -20,11 +20,15 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <set>
+#include <span>
 
 #include <nvvk/resource_allocator.hpp>
 
 #include "scene.hpp"
+#include "nvshaders/gltf_scene_io.h.slang"
+#include "nvutils/bit_array.hpp"
 #include "nvvk/sampler_pool.hpp"
 #include "nvvk/staging.hpp"
 #include "gpu_memory_tracker.hpp"
@@ -54,6 +58,20 @@ public:
     nvvk::Buffer texCoord0;
     nvvk::Buffer texCoord1;
     nvvk::Buffer color;
+
+    // With geometry arenas (see setGeometryArenaSize()), the buffers above
+    // are views of an arena: `buffer` is the arena's, `address` already
+    // includes the attribute's offset, and `allocation` is null. Vertex
+    // bindings need these offsets; they are 0 otherwise.
+    struct Offsets
+    {
+      VkDeviceSize position{};
+      VkDeviceSize normal{};
+      VkDeviceSize tangent{};
+      VkDeviceSize texCoord0{};
+      VkDeviceSize texCoord1{};
+      VkDeviceSize color{};
+    } offsets;
   };
 
   SceneVk() = default;
@@ -83,26 +101,101 @@ public:
   const nvvk::Buffer&               sceneDesc() const { return m_bSceneDesc; }
   const std::vector<VertexBuffers>& vertexBuffers() const { return m_vertexBuffers; }
   const std::vector<nvvk::Buffer>&  indices() const { return m_bIndices; }
+  const std::vector<VkDeviceSize>&  indexOffsets() const { return m_indexOffsets; }  // See VertexBuffers::Offsets
+  const std::vector<nvvk::Buffer>&  geometryArenas() const { return m_geometryArenas; }
   const std::vector<nvvk::Image>&   textures() const { return m_textures; }
   uint32_t                          nbTextures() const { return static_cast<uint32_t>(m_textures.size()); }
   const GpuMemoryTracker&           getMemoryTracker() const { return m_memoryTracker; }
   GpuMemoryTracker&                 getMemoryTracker() { return m_memoryTracker; }
 
+  struct ImageDedupStats
+  {
+    uint32_t duplicateCount = 0;  // Images that share another image's nvvk::Image
+    uint64_t savedBytes     = 0;  // Decoded bytes that weren't decoded or uploaded again
+    uint32_t cacheHits      = 0;  // Images copied from the DecodedImageCache instead of decoded
+  };
+  // Statistics on image deduplication from the last create().
+  const ImageDedupStats& getImageDedupStats() const { return m_imageDedupStats; }
+
+  // Host memory budget, in bytes, for images that createTextureImages() has
+  // decoded but not yet copied to staging; 0 means unlimited.
+  // Decoding pauses while the budget is used up, so that peak memory doesn't
+  // grow with the total size of the scene's textures.
+  void     setImageDecodeBudget(uint64_t bytes) { m_imageDecodeBudget = bytes; }
+  uint64_t getImageDecodeBudget() const { return m_imageDecodeBudget; }
+
+  // With this set, images that have a single mip (such as PNG and JPEG files)
+  // get their mip chains from mip_generation on the decoding threads, with a
+  // Kaiser filter in linear space for sRGB images, instead of from the blits
+  // of nvvk::cmdGenerateMipmaps(). Images whose format the device can't blit
+  // to, and KTX files that ask the app to generate mips, always get CPU mips.
+  // Only used if create() was asked to generate mipmaps.
+  void setCpuMipGeneration(bool enable) { m_cpuMipGeneration = enable; }
+  bool getCpuMipGeneration() const { return m_cpuMipGeneration; }
+
+  // Maximum size, in bytes, of the buffers ("geometry arenas") that create()
+  // packs the vertex attributes and indices of all primitives into. With
+  // 0, the default, each attribute and index array gets its own buffer.
+  // Arenas replace hundreds of thousands of allocations in large scenes by a
+  // few; the per-primitive buffers then become views with offsets (see
+  // VertexBuffers::Offsets and indexOffsets()). Must not exceed the device's
+  // maxBufferSize.
+  void         setGeometryArenaSize(VkDeviceSize bytes) { m_geometryArenaSize = bytes; }
+  VkDeviceSize getGeometryArenaSize() const { return m_geometryArenaSize; }
+
+  // After the first upload, updateRenderNodesBuffer(), updateMaterialBuffer()
+  // and updateRenderLightsBuffer() only upload the elements that changed,
+  // coalesced into a few ranges. Render nodes changed if the scene's revision
+  // of them is newer than the last upload (see Scene::getRenderNodeRevisions());
+  // materials and lights have no change tracking in the scene, so they are
+  // compared with what was uploaded last. These are the statistics of their
+  // last calls.
+  struct DeltaUploadStats
+  {
+    uint32_t changedElements = 0;  // Elements that changed since the last upload
+    uint32_t rangeCount      = 0;  // Ranges they were coalesced into, one appendBuffer() each
+    uint64_t uploadedBytes   = 0;
+  };
+  const DeltaUploadStats& getRenderNodesUploadStats() const { return m_renderNodesUploadStats; }
+  const DeltaUploadStats& getMaterialsUploadStats() const { return m_materialsUploadStats; }  // Includes texture infos
+  const DeltaUploadStats& getLightsUploadStats() const { return m_lightsUploadStats; }
+
 protected:
   struct SceneImage  // Image to be loaded and created
   {
     nvvk::Image imageTexture{};
+    bool        shared{false};  // imageTexture belongs to another SceneImage with the same contents
 
     // Loading information
     bool                           srgb{false};
     std::string                    imgName{};
     VkExtent2D                     size{0, 0};
     VkFormat                       format{VK_FORMAT_UNDEFINED};
-    std::vector<std::vector<char>> mipData{};
+    // Decoded mip levels: either owned by mipData, or views of memory that
+    // mipViewOwner keeps alive (a decoder's output, a mapped file), or that
+    // outlives the upload (the glTF model's buffers). Views are copied
+    // straight into staging memory by createImage(), without first being
+    // copied into mipData.
+    std::vector<std::vector<char>>     mipData{};
+    std::vector<std::span<const char>> mipViews{};
+    std::shared_ptr<const void>        mipViewOwner{};
+    // Format of the decoded texels when it differs from `format`;
+    // createImage() converts them while writing them to staging memory.
+    VkFormat decodedFormat{VK_FORMAT_UNDEFINED};
+
+    size_t                getMipCount() const { return mipViews.empty() ? mipData.size() : mipViews.size(); }
+    std::span<const char> getMip(size_t mip) const { return mipViews.empty() ? std::span<const char>(mipData[mip]) : mipViews[mip]; }
+    void                  releaseMips()
+    {
+      mipData.clear();
+      mipViews.clear();
+      mipViewOwner.reset();
+    }
   };
 
   VkBufferUsageFlags2 getBufferUsageFlags() const;
   virtual void createVertexBuffers(VkCommandBuffer cmd, nvvk::StagingUploader& staging, const nvvkgltf::Scene& scn);
+  void         createGeometryArenas(const nvvkgltf::Scene& scn);
   template <typename T>
   bool         updateAttributeBuffer(VkCommandBuffer            cmd,
                                      const std::string&         attributeName,
@@ -110,7 +203,25 @@ protected:
                                      const tinygltf::Primitive& primitive,
                                      nvvk::ResourceAllocator*   alloc,
                                      nvvk::StagingUploader*     staging,
-                                     nvvk::Buffer&              attributeBuffer);
+                                     nvvk::Buffer&              attributeBuffer,
+                                     VkDeviceSize               attributeOffset = 0);
+  // Uploads the elements whose bit is set in `dirty`, and adds to `stats`.
+  // `writeElements(first, dst)` writes elements `first` to
+  // `first + dst.size() - 1` into the staging memory `dst`.
+  template <typename T, typename WriteElements>
+  void appendDirtyRanges(nvvk::StagingUploader&   staging,
+                         const nvvk::Buffer&      buffer,
+                         const nvutils::BitArray& dirty,
+                         DeltaUploadStats&        stats,
+                         WriteElements&&          writeElements);
+  // Uploads the elements that differ from `uploaded` (all of them if the
+  // count changed), then makes `elements` the new `uploaded`.
+  template <typename T>
+  void appendChangedElements(nvvk::StagingUploader& staging,
+                             const nvvk::Buffer&    buffer,
+                             std::vector<T>&&       elements,
+                             std::vector<T>&        uploaded,
+                             DeltaUploadStats&      stats);
   virtual void createTextureImages(VkCommandBuffer              cmd,
                                    nvvk::StagingUploader&       staging,
                                    const tinygltf::Model&       model,
@@ -135,15 +246,33 @@ protected:
   nvvk::Buffer               m_bRenderNode;
   nvvk::Buffer               m_bSceneDesc;
   std::vector<nvvk::Buffer>  m_bIndices;
+  std::vector<VkDeviceSize>  m_indexOffsets;
   std::vector<VertexBuffers> m_vertexBuffers;
+  std::vector<nvvk::Buffer>  m_geometryArenas;
   std::vector<SceneImage>    m_images;
   std::vector<nvvk::Image>   m_textures;  // Vector of all textures of the scene
 
   std::set<int> m_sRgbImages;  // All images that are in sRGB (typically, only the one used by baseColorTexture)
 
-  bool m_generateMipmaps   = {};
-  bool m_rayTracingEnabled = {};
+  bool         m_generateMipmaps   = {};
+  bool         m_rayTracingEnabled = {};
+  bool         m_cpuMipGeneration  = false;
+  uint64_t     m_imageDecodeBudget = uint64_t(1) << 30;  // 1 GiB
+  VkDeviceSize m_geometryArenaSize = 0;
+
+  // Scene revision and render node count of the last upload of m_bRenderNode,
+  // and contents of the last upload of m_bMaterial, m_bTextureInfos and
+  // m_bLights, for delta uploads
+  uint64_t                                 m_uploadedRenderNodesRevision = 0;
+  size_t                                   m_uploadedRenderNodeCount     = 0;
+  std::vector<shaderio::GltfShadeMaterial> m_uploadedMaterials;
+  std::vector<shaderio::GltfTextureInfo>   m_uploadedTextureInfos;
+  std::vector<shaderio::GltfLight>         m_uploadedLights;
 
+  ImageDedupStats  m_imageDedupStats;
+  DeltaUploadStats m_renderNodesUploadStats;
+  DeltaUploadStats m_materialsUploadStats;
+  DeltaUploadStats m_lightsUploadStats;
   GpuMemoryTracker m_memoryTracker;  // GPU memory tracking
 };
 
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::parallel_produce_consume():
+* Every item is produced and consumed exactly once, items are started in
+  increasing order, and consume() runs on the calling thread.
+* The memory held by produced-but-unconsumed items stays within
+  memoryBudget + numWorkers * (largest item), both as reported in the stats
+  and as counted by the test itself.
+* Items larger than the whole budget still go through.
+* One worker alternates produce and consume on the calling thread.
+* produce() can use parallel_batches_pooled.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "nvutils/bounded_pipeline.hpp"
+#include "nvutils/parallel_work.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+// Item sizes between 1 and maxSize bytes.
+uint64_t itemSize(uint64_t item, uint64_t maxSize)
+{
+  return 1 + (item * 2654435761u) % maxSize;
+}
+
+void testBudget(uint64_t numItems, uint64_t budget, uint32_t numWorkers, uint64_t maxSize)
+{
+  const std::thread::id callingThread = std::this_thread::get_id();
+  std::vector<uint32_t> produced(numItems, 0);
+  std::vector<uint32_t> consumed(numItems, 0);
+  std::mutex            startMutex;
+  std::vector<uint64_t> startOrder;
+  std::atomic<int64_t>  held{0};  // Bytes of items being or done producing, and not yet consumed
+  std::atomic<int64_t>  peakHeld{0};
+  bool                  consumedOnCallingThread = true;
+
+  nvutils::BoundedPipelineSettings settings;
+  settings.memoryBudget = budget;
+  settings.numWorkers   = numWorkers;
+  const nvutils::BoundedPipelineStats stats = nvutils::parallel_produce_consume(
+      numItems,
+      [&](uint64_t item) -> uint64_t {
+        {
+          std::lock_guard<std::mutex> lock(startMutex);
+          startOrder.push_back(item);
+        }
+        const uint64_t bytes = itemSize(item, maxSize);
+        const int64_t  now   = held += int64_t(bytes);
+        int64_t        peak  = peakHeld.load();
+        while(now > peak && !peakHeld.compare_exchange_weak(peak, now))
+        {
+        }
+        produced[item]++;
+        std::this_thread::yield();
+        return bytes;
+      },
+      [&](uint64_t item) {
+        consumedOnCallingThread = consumedOnCallingThread && (std::this_thread::get_id() == callingThread);
+        CHECK(produced[item] == 1);
+        consumed[item]++;
+        held -= int64_t(itemSize(item, maxSize));
+      },
+      settings);
+
+  CHECK(std::all_of(produced.begin(), produced.end(), [](uint32_t n) { return n == 1; }));
+  CHECK(std::all_of(consumed.begin(), consumed.end(), [](uint32_t n) { return n == 1; }));
+  CHECK(std::is_sorted(startOrder.begin(), startOrder.end()));
+  CHECK(consumedOnCallingThread);
+  CHECK(held == 0);
+  if(budget != 0)
+  {
+    const uint64_t workers = std::min<uint64_t>(numWorkers, numItems);
+    const uint64_t bound   = budget + workers * maxSize;
+    CHECK(stats.peakBytes <= bound);
+    CHECK(uint64_t(peakHeld.load()) <= bound);
+  }
+  CHECK(stats.peakBytes >= ((numItems > 0) ? 1u : 0u));
+}
+
+void testSingleWorker()
+{
+  const std::thread::id callingThread = std::this_thread::get_id();
+  std::vector<int64_t>  events;  // item for produce, -1 - item for consume
+  bool                  onCallingThread = true;
+  nvutils::BoundedPipelineSettings settings;
+  settings.numWorkers                       = 1;
+  const nvutils::BoundedPipelineStats stats = nvutils::parallel_produce_consume(
+      5,
+      [&](uint64_t item) -> uint64_t {
+        onCallingThread = onCallingThread && (std::this_thread::get_id() == callingThread);
+        events.push_back(int64_t(item));
+        return 10 * (item + 1);
+      },
+      [&](uint64_t item) { events.push_back(-1 - int64_t(item)); }, settings);
+  CHECK(onCallingThread);
+  CHECK((events == std::vector<int64_t>{0, -1, 1, -2, 2, -3, 3, -4, 4, -5}));
+  CHECK(stats.peakBytes == 50);
+}
+
+void testNestedParallelism()
+{
+  std::atomic<uint64_t> sum{0};
+  nvutils::BoundedPipelineSettings settings;
+  settings.numWorkers   = 4;
+  settings.memoryBudget = 1;
+  nvutils::parallel_produce_consume(
+      16,
+      [&](uint64_t item) -> uint64_t {
+        nvutils::parallel_batches_pooled<1>(100, [&](uint64_t i, uint32_t) { sum += item * 100 + i; });
+        return 1;
+      },
+      [](uint64_t) {}, settings);
+  CHECK(sum == (1600 * 1599) / 2);
+}
+
+}  // namespace
+
+int main()
+{
+  testBudget(0, 100, 4, 10);
+  testBudget(1, 100, 4, 10);
+  testBudget(200, 0, 4, 50);     // Unlimited
+  testBudget(200, 64, 4, 50);    // Budget of about 2 items
+  testBudget(200, 1000, 8, 50);  // Budget of many items
+  testBudget(50, 10, 3, 100);    // Most items are larger than the budget
+  testBudget(100, 32, 1, 20);
+  testSingleWorker();
+  testNestedParallelism();
+  return test_check::result();
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::planBuildBatches() on hand-written cases (first fit
+decreasing by scratch size within a pass and by result size across passes,
+non-power-of-two alignments, and builds larger than the scratch capacity or
+result budget on their own), and the invariants of plans for random builds:
+every build is planned once, passes, batches and builds form contiguous
+ranges, scratch ranges are aligned, don't overlap and fit the capacity, and
+passes stay within the result budget.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "nvutils/build_batch_planner.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvutils::BuildBatch;
+using nvutils::BuildBatchItem;
+using nvutils::BuildBatchPlan;
+using nvutils::BuildBatchSettings;
+using nvutils::BuildPass;
+using nvutils::PlannedBuild;
+
+// The items of a batch, with their scratch offsets
+using Builds = std::vector<std::pair<uint32_t, uint64_t>>;
+
+Builds batchBuilds(const BuildBatchPlan& plan, uint32_t batch)
+{
+  Builds            result;
+  const BuildBatch& b = plan.batches[batch];
+  for(uint32_t i = b.firstBuild; i < b.firstBuild + b.buildCount; i++)
+  {
+    result.emplace_back(plan.builds[i].item, plan.builds[i].scratchOffset);
+  }
+  return result;
+}
+
+void checkPlan(const std::vector<BuildBatchItem>& items, const BuildBatchSettings& settings, const BuildBatchPlan& plan)
+{
+  // Every build once
+  CHECK(plan.builds.size() == items.size());
+  std::vector<uint32_t> count(items.size(), 0);
+  for(const PlannedBuild& build : plan.builds)
+  {
+    if(CHECK(build.item < items.size()))
+    {
+      count[build.item]++;
+    }
+  }
+  CHECK(std::all_of(count.begin(), count.end(), [](uint32_t c) { return c == 1; }));
+
+  // Passes cover the batches and builds in order
+  uint32_t nextBatch  = 0;
+  uint32_t nextBuild  = 0;
+  uint64_t maxScratch = 0;
+  for(const BuildPass& pass : plan.passes)
+  {
+    CHECK(pass.firstBatch == nextBatch && pass.batchCount > 0);
+    CHECK(pass.firstBuild == nextBuild && pass.buildCount > 0);
+    if(!CHECK(pass.firstBatch + pass.batchCount <= plan.batches.size()))
+    {
+      return;
+    }
+    uint64_t passResult = 0;
+    for(uint32_t b = pass.firstBatch; b < pass.firstBatch + pass.batchCount; b++)
+    {
+      const BuildBatch& batch = plan.batches[b];
+      CHECK(batch.firstBuild == nextBuild && batch.buildCount > 0);
+      uint64_t end         = 0;
+      uint64_t batchResult = 0;
+      for(const auto& [item, scratchOffset] : batchBuilds(plan, b))
+      {
+        CHECK(scratchOffset % settings.scratchAlignment == 0);
+        CHECK(scratchOffset >= end);  // In increasing order, not overlapping
+        end = scratchOffset + items[item].scratchSize;
+        batchResult += items[item].resultSize;
+      }
+      CHECK(batch.scratchSize == end);
+      CHECK(batch.resultSize == batchResult);
+      CHECK(batch.scratchSize <= settings.scratchCapacity || batch.buildCount == 1);
+      maxScratch = std::max(maxScratch, batch.scratchSize);
+      passResult += batch.resultSize;
+      nextBuild += batch.buildCount;
+    }
+    CHECK(pass.resultSize == passResult);
+    CHECK(pass.resultSize <= settings.resultBudget || pass.buildCount == 1);
+    CHECK(nextBuild == pass.firstBuild + pass.buildCount);
+    nextBatch += pass.batchCount;
+  }
+  CHECK(nextBatch == plan.batches.size());
+  CHECK(nextBuild == plan.builds.size());
+  CHECK(plan.maxScratchSize == maxScratch);
+}
+
+}  // namespace
+
+int main()
+{
+  // No builds
+  {
+    const BuildBatchPlan plan = nvutils::planBuildBatches({}, {.scratchCapacity = 100});
+    CHECK(plan.builds.empty() && plan.batches.empty() && plan.passes.empty() && plan.maxScratchSize == 0);
+  }
+
+  // In input order, 60 | 50 40 | 30 20 would need 3 batches; first fit
+  // decreasing needs 2 full ones.
+  {
+    const std::vector<BuildBatchItem> items = {{60, 1}, {50, 2}, {40, 3}, {30, 4}, {20, 5}};
+    const BuildBatchSettings          settings{.scratchCapacity = 100};
+    const BuildBatchPlan              plan = nvutils::planBuildBatches(items, settings);
+    checkPlan(items, settings, plan);
+    CHECK(plan.passes.size() == 1);
+    if(CHECK(plan.batches.size() == 2))
+    {
+      CHECK((batchBuilds(plan, 0) == Builds{{0, 0}, {2, 60}}));
+      CHECK((batchBuilds(plan, 1) == Builds{{1, 0}, {3, 50}, {4, 80}}));
+      CHECK(plan.batches[0].resultSize == 4 && plan.batches[1].resultSize == 11);
+    }
+    CHECK(plan.maxScratchSize == 100);
+  }
+
+  // Non-power-of-two alignment; the last build doesn't fit after alignment
+  {
+    const std::vector<BuildBatchItem> items = {{10, 0}, {10, 0}, {10, 0}, {10, 0}};
+    const BuildBatchSettings          settings{.scratchCapacity = 150, .scratchAlignment = 48};
+    const BuildBatchPlan              plan = nvutils::planBuildBatches(items, settings);
+    checkPlan(items, settings, plan);
+    if(CHECK(plan.batches.size() == 2))
+    {
+      CHECK((batchBuilds(plan, 0) == Builds{{0, 0}, {1, 48}, {2, 96}}));
+      CHECK((batchBuilds(plan, 1) == Builds{{3, 0}}));
+      CHECK(plan.batches[0].scratchSize == 106);
+    }
+  }
+
+  // Passes by result size: 70 30 | 50 40, with the builds of each pass
+  // batched by scratch size.
+  {
+    const std::vector<BuildBatchItem> items = {{10, 50}, {30, 70}, {20, 40}, {40, 30}};
+    const BuildBatchSettings          settings{.scratchCapacity = 50, .resultBudget = 100};
+    const BuildBatchPlan              plan = nvutils::planBuildBatches(items, settings);
+    checkPlan(items, settings, plan);
+    if(CHECK(plan.passes.size() == 2 && plan.batches.size() == 3))
+    {
+      CHECK(plan.passes[0].resultSize == 100 && plan.passes[0].batchCount == 2);
+      CHECK(plan.passes[1].resultSize == 90 && plan.passes[1].batchCount == 1);
+      CHECK((batchBuilds(plan, 0) == Builds{{3, 0}}));
+      CHECK((batchBuilds(plan, 1) == Builds{{1, 0}}));
+      CHECK((batchBuilds(plan, 2) == Builds{{2, 0}, {0, 20}}));
+    }
+  }
+
+  // Builds larger than the capacity or budget get their own batch or pass
+  {
+    const std::vector<BuildBatchItem> items = {{10, 10}, {150, 10}, {20, 500}, {30, 10}};
+    const BuildBatchSettings          settings{.scratchCapacity = 100, .resultBudget = 100};
+    const BuildBatchPlan              plan = nvutils::planBuildBatches(items, settings);
+    checkPlan(items, settings, plan);
+    if(CHECK(plan.passes.size() == 2 && plan.batches.size() == 3))
+    {
+      CHECK((batchBuilds(plan, 0) == Builds{{2, 0}}));
+      CHECK((batchBuilds(plan, 1) == Builds{{1, 0}}));
+      CHECK((batchBuilds(plan, 2) == Builds{{3, 0}, {0, 30}}));
+    }
+    CHECK(plan.maxScratchSize == 150);
+  }
+
+  // Random builds
+  uint32_t rng  = 1;
+  auto     next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+  for(uint32_t run = 0; run < 300; run++)
+  {
+    BuildBatchSettings settings;
+    settings.scratchCapacity  = 1 + next() % 100000;
+    settings.scratchAlignment = (next() % 3 == 0) ? 1 + next() % 300 : 256;
+    settings.resultBudget     = (next() % 4 == 0) ? ~uint64_t(0) : 1 + next() % 1000000;
+
+    std::vector<BuildBatchItem> items(next() % 200);
+    for(BuildBatchItem& item : items)
+    {
+      // Occasionally larger than the capacity or budget, or empty
+      item.scratchSize = next() % (settings.scratchCapacity / 4 + (next() % 16 == 0 ? settings.scratchCapacity * 2 : 1));
+      item.resultSize  = next() % 50000;
+    }
+    checkPlan(items, settings, nvutils::planBuildBatches(items, settings));
+  }
+
+  return test_check::result();
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::planCompaction() on hand-written cases (packing in the order
+of the old offsets, blocks above maxOccupancy staying in place, plans that
+wouldn't save a block being empty, leaving out the fullest block, and
+maxItemsPerBlock), and the invariants of plans for random fragmented blocks:
+every item of a source block moves exactly once and nothing else moves, new
+blocks don't overflow and their items don't overlap, and the plan frees more
+blocks than it creates.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "nvutils/compaction_planner.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvutils::CompactionItem;
+using nvutils::CompactionMove;
+using nvutils::CompactionPlan;
+using nvutils::CompactionSettings;
+
+bool sameMove(const CompactionMove& move, uint32_t item, uint32_t dstBlock, uint64_t dstOffset)
+{
+  return move.item == item && move.dstBlock == dstBlock && move.dstOffset == dstOffset;
+}
+
+void checkPlan(const std::vector<CompactionItem>& items, const CompactionSettings& settings, const CompactionPlan& plan)
+{
+  if(plan.empty())
+  {
+    CHECK(plan.sourceBlocks.empty() && plan.newBlockCount == 0 && plan.movedSize == 0);
+    return;
+  }
+
+  // Fewer new blocks than freed ones
+  CHECK(plan.newBlockCount < plan.sourceBlocks.size());
+  CHECK(std::is_sorted(plan.sourceBlocks.begin(), plan.sourceBlocks.end()));
+  CHECK(std::adjacent_find(plan.sourceBlocks.begin(), plan.sourceBlocks.end()) == plan.sourceBlocks.end());
+
+  std::map<uint32_t, uint64_t> usedSizes;
+  for(const CompactionItem& item : items)
+  {
+    usedSizes[item.block] += item.size;
+  }
+
+  // Exactly the items of the source blocks move, once each
+  std::vector<uint32_t> moveCount(items.size(), 0);
+  for(const CompactionMove& move : plan.moves)
+  {
+    if(CHECK(move.item < items.size()))
+    {
+      moveCount[move.item]++;
+    }
+  }
+  uint64_t movedSize = 0;
+  for(size_t i = 0; i < items.size(); i++)
+  {
+    const bool isSource = std::binary_search(plan.sourceBlocks.begin(), plan.sourceBlocks.end(), items[i].block);
+    CHECK(moveCount[i] == (isSource ? 1u : 0u));
+    movedSize += isSource ? items[i].size : 0;
+  }
+  CHECK(plan.movedSize == movedSize);
+  for(uint32_t block : plan.sourceBlocks)
+  {
+    CHECK(double(usedSizes[block]) <= settings.maxOccupancy * double(settings.blockCapacity));
+  }
+
+  // Sorted moves; new blocks are used, don't overflow, and items don't overlap
+  std::vector<uint64_t> itemCounts(plan.newBlockCount, 0);
+  for(size_t m = 0; m < plan.moves.size(); m++)
+  {
+    const CompactionMove& move = plan.moves[m];
+    if(!CHECK(move.dstBlock < plan.newBlockCount))
+    {
+      continue;
+    }
+    CHECK(move.dstOffset + items[move.item].size <= settings.blockCapacity);
+    itemCounts[move.dstBlock]++;
+    if(m > 0 && plan.moves[m - 1].dstBlock == move.dstBlock)
+    {
+      const CompactionMove& previous = plan.moves[m - 1];
+      CHECK(previous.dstOffset + items[previous.item].size <= move.dstOffset);
+    }
+    else if(m > 0)
+    {
+      CHECK(plan.moves[m - 1].dstBlock < move.dstBlock);
+    }
+  }
+  for(uint64_t count : itemCounts)
+  {
+    CHECK(count > 0 && count <= settings.maxItemsPerBlock);
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  // Three sparse blocks fit into one; the full block stays. Items of a block
+  // keep the order of their old offsets.
+  {
+    const std::vector<CompactionItem> items = {
+        {0, 50, 20},  // 0
+        {2, 0, 90},   // 1
+        {1, 0, 40},   // 2
+        {0, 0, 10},   // 3
+        {3, 10, 25},  // 4
+    };
+    const CompactionSettings settings{.blockCapacity = 100};
+    const CompactionPlan     plan = nvutils::planCompaction(items, settings);
+    checkPlan(items, settings, plan);
+    CHECK((plan.sourceBlocks == std::vector<uint32_t>{0, 1, 3}));
+    CHECK(plan.newBlockCount == 1);
+    CHECK(plan.movedSize == 95);
+    if(CHECK(plan.moves.size() == 4))
+    {
+      CHECK(sameMove(plan.moves[0], 3, 0, 0));
+      CHECK(sameMove(plan.moves[1], 0, 0, 10));
+      CHECK(sameMove(plan.moves[2], 2, 0, 30));
+      CHECK(sameMove(plan.moves[3], 4, 0, 70));
+    }
+  }
+
+  // Nothing to do for no items, a single sparse block, or blocks whose items
+  // don't fit together; three blocks of 49 still fit into two.
+  {
+    const CompactionSettings settings{.blockCapacity = 99};
+    CHECK(nvutils::planCompaction({}, settings).empty());
+    const std::vector<CompactionItem> single = {{4, 0, 10}, {4, 20, 10}};
+    CHECK(nvutils::planCompaction(single, settings).empty());
+    const std::vector<CompactionItem> halves = {{0, 0, 49}, {1, 0, 49}, {2, 0, 49}};
+    checkPlan(halves, settings, nvutils::planCompaction(halves, settings));
+    CHECK(nvutils::planCompaction(halves, settings).newBlockCount == 2);
+    const std::vector<CompactionItem> tooLarge = {{0, 0, 45}, {0, 50, 45}, {1, 0, 45}};
+    CHECK(nvutils::planCompaction(tooLarge, {.blockCapacity = 99, .maxOccupancy = 1.0}).empty());
+  }
+
+  // maxOccupancy selects the blocks.
+  {
+    const std::vector<CompactionItem> items = {{0, 0, 30}, {1, 0, 30}, {2, 0, 60}};
+    CHECK((nvutils::planCompaction(items, {.blockCapacity = 100, .maxOccupancy = 0.3}).sourceBlocks
+           == std::vector<uint32_t>{0, 1}));
+    CHECK(nvutils::planCompaction(items, {.blockCapacity = 100, .maxOccupancy = 0.29}).empty());
+  }
+
+  // With at most 2 items per block, block 5's three items need two new
+  // blocks; leaving it out lets blocks 7 and 9 share one.
+  {
+    const std::vector<CompactionItem> items = {{5, 0, 1}, {5, 10, 1}, {5, 20, 1}, {7, 0, 1}, {9, 0, 1}};
+    const CompactionSettings settings{.blockCapacity = 100, .maxItemsPerBlock = 2, .maxOccupancy = 1.0};
+    const CompactionPlan     plan = nvutils::planCompaction(items, settings);
+    checkPlan(items, settings, plan);
+    CHECK((plan.sourceBlocks == std::vector<uint32_t>{7, 9}));
+    CHECK(plan.newBlockCount == 1);
+    if(CHECK(plan.moves.size() == 2))
+    {
+      CHECK(sameMove(plan.moves[0], 3, 0, 0));
+      CHECK(sameMove(plan.moves[1], 4, 0, 1));
+    }
+  }
+
+  // Random fragmented blocks.
+  uint32_t rng  = 1;
+  auto     next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+  uint32_t nonEmptyPlans = 0;
+  for(uint32_t run = 0; run < 300; run++)
+  {
+    CompactionSettings settings;
+    settings.blockCapacity    = 64 + next() % 4096;
+    settings.maxItemsPerBlock = (next() % 4 == 0) ? 1 + next() % 16 : ~uint64_t(0);
+    settings.maxOccupancy     = double(next() % 101) / 100.0;
+
+    std::vector<CompactionItem> items;
+    const uint32_t              blockCount = 1 + next() % 40;
+    for(uint32_t block = 0; block < blockCount; block++)
+    {
+      // Live items at increasing offsets, leaving holes
+      uint64_t offset = 0;
+      while(true)
+      {
+        offset += next() % (settings.blockCapacity / 4 + 1);
+        const uint64_t size = 1 + next() % (settings.blockCapacity / 8 + 1);
+        if(offset + size > settings.blockCapacity || next() % 8 == 0)
+        {
+          break;
+        }
+        items.push_back({block * 3 + 1, offset, size});
+        offset += size;
+      }
+    }
+    // Shuffle, as the planner doesn't require any order
+    for(size_t i = items.size(); i > 1; i--)
+    {
+      std::swap(items[i - 1], items[next() % i]);
+    }
+
+    const CompactionPlan plan = nvutils::planCompaction(items, settings);
+    checkPlan(items, settings, plan);
+    nonEmptyPlans += plan.empty() ? 0 : 1;
+  }
+  CHECK(nonEmptyPlans > 50);
+
+  return test_check::result();
+}
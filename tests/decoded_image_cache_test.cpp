@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvvkgltf::DecodedImageCache: lookups only hit if both the encoded
+size and the whole digest match, images larger than the budget aren't
+cached, the least recently used images are evicted first, and a budget of 0
+disables and clears the cache.
+
+-----------------------------------------------------------------------------*/
+
+#include <span>
+#include <string_view>
+
+#include "nvvkgltf/decoded_image_cache.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvvkgltf::DecodedImageCache;
+
+DecodedImageCache::Key makeKey(std::string_view encoded)
+{
+  return {encoded.size(), nvutils::sha256(std::as_bytes(std::span(encoded.data(), encoded.size())))};
+}
+
+DecodedImageCache::Entry makeEntry(uint64_t bytes)
+{
+  DecodedImageCache::Entry entry;
+  entry.size   = {1, 1};
+  entry.format = VK_FORMAT_R8G8B8A8_UNORM;
+  entry.mipData.emplace_back(bytes, 'x');
+  return entry;
+}
+
+}  // namespace
+
+int main()
+{
+  DecodedImageCache& cache = DecodedImageCache::getInstance();
+  CHECK(!cache.isEnabled());
+  cache.setBudget(300);
+  CHECK(cache.isEnabled());
+
+  const DecodedImageCache::Key a = makeKey("image a");
+  const DecodedImageCache::Key b = makeKey("image b");
+  const DecodedImageCache::Key c = makeKey("image c");
+  cache.insert(a, makeEntry(100));
+  CHECK(cache.find(a) != nullptr);
+  CHECK(cache.find(b) == nullptr);
+
+  // The same digest with another size, and the same size with a digest that
+  // differs only in its last byte, are different images.
+  DecodedImageCache::Key otherSize = a;
+  otherSize.encodedSize++;
+  CHECK(cache.find(otherSize) == nullptr);
+  DecodedImageCache::Key otherDigest = a;
+  otherDigest.digest.back() ^= 1;
+  CHECK(cache.find(otherDigest) == nullptr);
+
+  // Too large for the budget.
+  cache.insert(makeKey("huge"), makeEntry(301));
+  CHECK(cache.find(makeKey("huge")) == nullptr);
+
+  // Using a makes b the least recently used, so it's evicted for d.
+  cache.insert(b, makeEntry(100));
+  cache.insert(c, makeEntry(100));
+  CHECK(cache.find(a) != nullptr);
+  cache.insert(makeKey("image d"), makeEntry(100));
+  CHECK(cache.getSizeBytes() == 300);
+  CHECK(cache.find(b) == nullptr);
+  CHECK(cache.find(a) != nullptr);
+  CHECK(cache.find(c) != nullptr);
+  const std::shared_ptr<const DecodedImageCache::Entry> d = cache.find(makeKey("image d"));
+  CHECK(d != nullptr && d->mipData.size() == 1 && d->mipData[0].size() == 100);
+
+  cache.setBudget(0);
+  CHECK(!cache.isEnabled());
+  CHECK(cache.getSizeBytes() == 0);
+  CHECK(cache.find(a) == nullptr);
+  // Entries that are still referenced stay valid.
+  CHECK(d->mipData[0].size() == 100);
+  return test_check::result();
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::coalesceDirtyRanges() on hand-written cases (no dirty
+elements, all dirty, bits at 64-bit word boundaries, gaps just below, at and
+above maxGap) and against a simple reference on random bit arrays: ranges are
+in increasing order, don't overlap, cover every dirty element, start and end
+with dirty elements, and are separated by more than maxGap clean elements.
+
+-----------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <vector>
+
+#include "nvutils/dirty_ranges.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvutils::DirtyRange;
+
+nvutils::BitArray makeBits(size_t size, const std::vector<size_t>& setBits)
+{
+  nvutils::BitArray bits(size);
+  for(size_t index : setBits)
+  {
+    bits.enableBit(index);
+  }
+  return bits;
+}
+
+// One element at a time: extend the last range if the gap is small enough.
+std::vector<DirtyRange> referenceRanges(const std::vector<bool>& dirty, uint64_t maxGap)
+{
+  std::vector<DirtyRange> ranges;
+  for(uint64_t i = 0; i < dirty.size(); i++)
+  {
+    if(!dirty[i])
+    {
+      continue;
+    }
+    if(!ranges.empty() && i - (ranges.back().first + ranges.back().count) <= maxGap)
+    {
+      ranges.back().count = i + 1 - ranges.back().first;
+    }
+    else
+    {
+      ranges.push_back({i, 1});
+    }
+  }
+  return ranges;
+}
+
+void checkRanges(const std::vector<bool>& dirty, uint64_t maxGap)
+{
+  nvutils::BitArray bits(dirty.size());
+  for(size_t i = 0; i < dirty.size(); i++)
+  {
+    bits.setBit(i, dirty[i]);
+  }
+  const std::vector<DirtyRange> ranges = nvutils::coalesceDirtyRanges(bits, maxGap);
+  CHECK(ranges == referenceRanges(dirty, maxGap));
+
+  std::vector<bool> covered(dirty.size(), false);
+  for(size_t r = 0; r < ranges.size(); r++)
+  {
+    const DirtyRange& range = ranges[r];
+    if(!CHECK(range.count > 0 && range.first + range.count <= dirty.size()))
+    {
+      continue;
+    }
+    CHECK(dirty[range.first] && dirty[range.first + range.count - 1]);
+    if(r > 0)
+    {
+      const uint64_t previousEnd = ranges[r - 1].first + ranges[r - 1].count;
+      CHECK(range.first > previousEnd + maxGap);
+    }
+    for(uint64_t i = range.first; i < range.first + range.count; i++)
+    {
+      covered[i] = true;
+    }
+  }
+  for(size_t i = 0; i < dirty.size(); i++)
+  {
+    if(dirty[i])
+    {
+      CHECK(covered[i]);
+    }
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  CHECK(nvutils::coalesceDirtyRanges(nvutils::BitArray()).empty());
+  CHECK(nvutils::coalesceDirtyRanges(nvutils::BitArray(1000)).empty());
+  CHECK((nvutils::coalesceDirtyRanges(nvutils::BitArray(130, 1)) == std::vector<DirtyRange>{{0, 130}}));
+
+  // Runs that cross 64-bit words stay one range.
+  CHECK((nvutils::coalesceDirtyRanges(makeBits(256, {62, 63, 64, 65, 127, 128}))
+         == std::vector<DirtyRange>{{62, 4}, {127, 2}}));
+  CHECK((nvutils::coalesceDirtyRanges(makeBits(200, {199})) == std::vector<DirtyRange>{{199, 1}}));
+
+  // Elements 10 and 14 have a gap of 3 clean elements.
+  const nvutils::BitArray gap3 = makeBits(20, {10, 14});
+  CHECK((nvutils::coalesceDirtyRanges(gap3, 0) == std::vector<DirtyRange>{{10, 1}, {14, 1}}));
+  CHECK((nvutils::coalesceDirtyRanges(gap3, 2) == std::vector<DirtyRange>{{10, 1}, {14, 1}}));
+  CHECK((nvutils::coalesceDirtyRanges(gap3, 3) == std::vector<DirtyRange>{{10, 5}}));
+  CHECK((nvutils::coalesceDirtyRanges(gap3, ~uint64_t(0)) == std::vector<DirtyRange>{{10, 5}}));
+
+  // Long gaps across many clean words.
+  CHECK((nvutils::coalesceDirtyRanges(makeBits(100000, {5, 99999}), 99992) == std::vector<DirtyRange>{{5, 1}, {99999, 1}}));
+  CHECK((nvutils::coalesceDirtyRanges(makeBits(100000, {5, 99999}), 99993) == std::vector<DirtyRange>{{5, 99995}}));
+
+  // Random bit arrays of varying density.
+  uint32_t rng  = 1;
+  auto     next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+  for(uint32_t run = 0; run < 300; run++)
+  {
+    std::vector<bool> dirty(next() % 700);
+    const uint32_t    density = 1 + next() % 64;  // One in `density` elements is dirty
+    for(size_t i = 0; i < dirty.size(); i++)
+    {
+      dirty[i] = next() % density == 0;
+    }
+    checkRanges(dirty, next() % 12);
+  }
+
+  return test_check::result();
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvvk::createEnvironmentAccel() against a serial reference that
+computes the importance of each texel (max(r, g, b) times its solid angle)
+with the same float operations, one texel after the other:
+
+* The integral is the reference's, the average luminance is within 1e-5 of
+  it, and the alpha channel holds max(r, g, b) / integral.
+* Each texel below average keeps its ratio q to the average, and has a
+  texel above average as its alias.
+* Per texel, the probability with which the alias table samples it (its own
+  q, plus 1 - q of each texel it's the alias of) is its q, and q is its
+  share of the importance to 1e-6. The float rounding of the ratios can
+  leave the qs summing to slightly more or less than the texel count; one
+  texel, the last one above average, takes that difference.
+
+The environments are small, odd-sized (so that rows end with a partial SIMD
+group), all black but one texel, and larger than the 64K-texel blocks that
+the alias table is built in, including blocks with only texels above
+average and blocks with none.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "nvvk/hdr_ibl.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+// A sky gradient with noise, and a small sun that is many times brighter
+std::vector<float> makeSky(uint32_t width, uint32_t height)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  uint32_t           rng = 1234;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      rng               = rng * 1664525u + 1013904223u;
+      const float noise = float(rng >> 8) / 16777216.0f;
+      const float sky   = 0.2f + 0.8f * float(height - y) / float(height);
+      const float dx    = float(x) / float(width) - 0.3f;
+      const float dy    = float(y) / float(height) - 0.25f;
+      const bool  sun   = dx * dx + dy * dy < 0.0001f;
+      float*      texel = &rgba[(size_t(y) * width + x) * 4];
+      texel[0]          = sun ? 20000.0f : sky * (0.5f + 0.5f * noise);
+      texel[1]          = sun ? 18000.0f : sky * (0.6f + 0.4f * noise);
+      texel[2]          = sun ? 15000.0f : sky * (0.9f + 0.2f * noise);
+      texel[3]          = 1.0f;
+    }
+  }
+  return rgba;
+}
+
+// Each row is white at `rowValue(y)`
+template <typename RowValue>
+std::vector<float> makeRows(uint32_t width, uint32_t height, RowValue rowValue)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    const float value = rowValue(y);
+    for(uint32_t x = 0; x < width; x++)
+    {
+      float* texel = &rgba[(size_t(y) * width + x) * 4];
+      texel[0] = texel[1] = texel[2] = value;
+      texel[3]                       = 1.0f;
+    }
+  }
+  return rgba;
+}
+
+struct Reference
+{
+  std::vector<float>  importance;
+  std::vector<float>  q;              // Ratio of each texel's importance to the average, in float
+  std::vector<double> probabilities;  // Share of each texel in the importance
+  double              integral = 0.0;
+  double              average  = 0.0;
+};
+
+// The importance as EnvironmentImportance::addRow() computes it, and the
+// ratios as buildAliasmap() does
+Reference makeReference(const std::vector<float>& rgba, uint32_t width, uint32_t height)
+{
+  const size_t size = size_t(width) * height;
+  Reference    reference;
+  reference.importance.resize(size);
+  const float stepPhi   = glm::two_pi<float>() / float(width);
+  const float stepTheta = glm::pi<float>() / float(height);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    const float cosTheta0 = y == 0 ? 1.0F : std::cos(float(y) * stepTheta);
+    const float cosTheta1 = std::cos(float(y + 1) * stepTheta);
+    const float area      = (cosTheta0 - cosTheta1) * stepPhi;
+    double      rowSum    = 0.0;
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const size_t i     = size_t(y) * width + x;
+      const float* texel = &rgba[i * 4];
+      reference.importance[i] = area * std::max(texel[0], std::max(texel[1], texel[2]));
+      rowSum += reference.importance[i];
+      reference.average += texel[0] * 0.2126 + texel[1] * 0.7152 + texel[2] * 0.0722;
+    }
+    reference.integral += rowSum;
+  }
+  reference.average /= double(size);
+  if(reference.integral == 0.0)
+  {
+    reference.integral = 1.0;
+  }
+
+  const float inverseAverage = float(double(size) / reference.integral);
+  reference.q.resize(size);
+  reference.probabilities.resize(size);
+  for(size_t i = 0; i < size; i++)
+  {
+    reference.q[i]             = reference.importance[i] * inverseAverage;
+    reference.probabilities[i] = double(reference.importance[i]) / reference.integral;
+  }
+  return reference;
+}
+
+// Probability with which each texel is sampled with `accel`, as
+// hdr_env_sampling.h.slang samples it
+std::vector<double> texelProbabilities(const std::vector<shaderio::EnvAccel>& accel)
+{
+  const double        inverseSize = 1.0 / double(accel.size());
+  std::vector<double> probabilities(accel.size(), 0.0);
+  for(size_t i = 0; i < accel.size(); i++)
+  {
+    const double q = std::clamp(double(accel[i].q), 0.0, 1.0);
+    probabilities[i] += q * inverseSize;
+    probabilities[accel[i].alias] += (1.0 - q) * inverseSize;
+  }
+  return probabilities;
+}
+
+void checkEnvironment(const std::vector<float>& rgba, uint32_t width, uint32_t height)
+{
+  const size_t       size   = size_t(width) * height;
+  std::vector<float> pixels = rgba;
+  float              average = 0.0f, integral = 0.0f;
+  const std::vector<shaderio::EnvAccel> accel = nvvk::createEnvironmentAccel(pixels.data(), width, height, average, integral);
+  if(!CHECK(accel.size() == size))
+  {
+    return;
+  }
+  const Reference reference = makeReference(rgba, width, height);
+
+  CHECK(integral == float(reference.integral));
+  CHECK(std::abs(average - reference.average) <= 1e-5 * reference.average);
+  bool pixelsMatch = true;
+  for(size_t i = 0; i < size; i++)
+  {
+    const float* texel = &rgba[i * 4];
+    const float  pdf   = std::max(texel[0], std::max(texel[1], texel[2])) * (1.0F / integral);
+    pixelsMatch = pixelsMatch && pixels[i * 4] == texel[0] && pixels[i * 4 + 1] == texel[1]
+                  && pixels[i * 4 + 2] == texel[2] && pixels[i * 4 + 3] == pdf;
+  }
+  CHECK(pixelsMatch);
+
+  // Without texels above average, which rounding can cause, each texel is
+  // its own alias
+  const bool hasLarge     = std::any_of(reference.q.begin(), reference.q.end(), [](float q) { return q >= 1.0f; });
+  bool       aliasesValid = true;
+  double     qSum         = 0.0;
+  for(size_t i = 0; i < size; i++)
+  {
+    qSum += reference.q[i];
+    aliasesValid = aliasesValid && accel[i].alias < size;
+    if(aliasesValid && reference.q[i] < 1.0f)
+    {
+      aliasesValid = accel[i].q == reference.q[i] && (hasLarge ? reference.q[accel[i].alias] >= 1.0f : accel[i].alias == i);
+    }
+  }
+  if(!CHECK(aliasesValid))
+  {
+    return;
+  }
+
+  const std::vector<double> probabilities = texelProbabilities(accel);
+  const double              residue       = std::abs(qSum - double(size));
+  double                    probabilitySum = 0.0;
+  uint32_t                  offTexels      = 0;  // Where the probability isn't q / size
+  bool                      offByResidue   = true;
+  bool                      qMatches       = true;
+  for(size_t i = 0; i < size; i++)
+  {
+    probabilitySum += probabilities[i];
+    const double q         = reference.q[i];
+    const double tolerance = 1e-6 * std::max(1.0, q);
+    const double error     = std::abs(probabilities[i] * double(size) - q);
+    if(error > tolerance)
+    {
+      offTexels++;
+      offByResidue = offByResidue && error <= residue + tolerance;
+    }
+    const double share = reference.probabilities[i] * double(size);
+    qMatches           = qMatches && std::abs(q - share) <= 1e-6 * share;
+  }
+  CHECK(std::abs(probabilitySum - 1.0) < 1e-9);
+  CHECK(offTexels <= 1 && offByResidue);
+  CHECK(qMatches);
+}
+
+void testSmall()
+{
+  checkEnvironment(makeSky(16, 8), 16, 8);
+  checkEnvironment(makeSky(64, 32), 64, 32);
+}
+
+void testOddSized()
+{
+  checkEnvironment(makeSky(37, 19), 37, 19);
+  checkEnvironment(makeSky(5, 3), 5, 3);
+  checkEnvironment(makeSky(1, 1), 1, 1);
+}
+
+void testSingleBrightTexel()
+{
+  const uint32_t     width = 64, height = 32;
+  std::vector<float> rgba  = makeRows(width, height, [](uint32_t) { return 0.0f; });
+  const size_t       sun   = size_t(11) * width + 41;
+  rgba[sun * 4 + 1]        = 1000.0f;
+  checkEnvironment(rgba, width, height);
+
+  // All the probability goes to that texel
+  std::vector<float> pixels = rgba;
+  float              average = 0.0f, integral = 0.0f;
+  const std::vector<shaderio::EnvAccel> accel = nvvk::createEnvironmentAccel(pixels.data(), width, height, average, integral);
+  const std::vector<double> probabilities = texelProbabilities(accel);
+  CHECK(std::abs(probabilities[sun] - 1.0) < 1e-9);
+  bool allAliased = true;
+  for(size_t i = 0; i < accel.size(); i++)
+  {
+    allAliased = allAliased && (i == sun || (accel[i].q == 0.0f && accel[i].alias == sun));
+  }
+  CHECK(allAliased);
+}
+
+void testBlockBoundaries()
+{
+  // Exactly 2 blocks; and blocks that end mid-row, with a partial last one
+  checkEnvironment(makeSky(512, 256), 512, 256);
+  checkEnvironment(makeSky(1001, 333), 1001, 333);
+
+  // 4 blocks of 256 rows: the second is bright and all above average, so it
+  // has no texels below average, while the others have only those. The
+  // third and fourth start in the middle of the second's texels.
+  checkEnvironment(makeRows(256, 1024, [](uint32_t y) { return y / 256 == 1 ? 1.0f : (y / 256 == 2 ? 0.01f : 0.0f); }), 256, 1024);
+}
+
+}  // namespace
+
+int main()
+{
+  testSmall();
+  testOddSized();
+  testSingleBrightTexel();
+  testBlockBoundaries();
+  return test_check::result();
+}
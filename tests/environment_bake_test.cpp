@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the CPU environment baker of nvshaders_host (hdr_env_bake.hpp):
+
+* The spherical harmonics of a constant, a linear and a quadratic
+  environment, which L2 represents exactly, against their analytic
+  coefficients (relative to the largest one), and the irradiance they give
+  for 1000 normals against its closed form (relative), on one thread and on
+  the thread pool.
+* bakeDiffuseCube() against evaluateIrradianceSH() / pi at the texel
+  directions.
+* The glossy cube of a constant environment, which must be that constant
+  at every roughness.
+* integrateBrdfLut(), whose SIMD path reimplements shaderio::integrateBrdf()
+  of hdr_prefilter_functions.h.slang, against it; and integrateBrdf() itself: a smooth surface seen head-on reflects
+  everything, and the scale and bias add up to at most 1.
+* Converting the cubes and table to KTX2 images, writing them to the
+  temporary directory and reading them back.
+
+-----------------------------------------------------------------------------*/
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvshaders/slang_types.h"
+#include "nvshaders/hdr_prefilter_functions.h.slang"
+#include "nvshaders_host/hdr_env_bake.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+const glm::vec3 kColor(1.0f, 0.5f, 0.25f);
+
+// An equirectangular environment with the given radiance at each texel center
+std::vector<float> makeEnvironment(uint32_t width, uint32_t height, const std::function<glm::vec3(glm::vec3)>& radiance)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      // The direction of the texel center, as getSphericalUv() maps it
+      const double    phi   = (double(x) + 0.5) / double(width) * 2.0 * M_PI - M_PI;
+      const double    theta = (double(y) + 0.5) / double(height) * M_PI;
+      const glm::vec3 value = radiance(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+      float*          texel = &rgba[(size_t(y) * width + x) * 4];
+      texel[0]              = value.x;
+      texel[1]              = value.y;
+      texel[2]              = value.z;
+      texel[3]              = 1.0f;
+    }
+  }
+  return rgba;
+}
+
+// An environment that's a polynomial of degree 2 at most in the direction,
+// with its spherical harmonics and irradiance in closed form
+struct AnalyticEnvironment
+{
+  std::function<glm::vec3(glm::vec3)> radiance;
+  nvshaders::SphericalHarmonicsL2     sh;
+  std::function<glm::vec3(glm::vec3)> irradiance;
+};
+
+std::vector<AnalyticEnvironment> makeAnalyticEnvironments()
+{
+  const glm::vec3 d = glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f));
+  // Normalization constants of the basis, see hdr_env_bake.hpp
+  const float k0  = float(0.5 * std::sqrt(1.0 / M_PI));
+  const float k1  = float(std::sqrt(3.0 / (4.0 * M_PI)));
+  const float k2  = float(0.5 * std::sqrt(15.0 / M_PI));
+  const float k20 = float(0.25 * std::sqrt(5.0 / M_PI));
+  const float k22 = float(0.25 * std::sqrt(15.0 / M_PI));
+  const float pi  = float(M_PI);
+
+  std::vector<AnalyticEnvironment> environments;
+
+  AnalyticEnvironment constant{[=](glm::vec3) { return kColor; }};
+  constant.sh.coefficients[0] = kColor * k0 * 4.0f * pi;
+  constant.irradiance         = [=](glm::vec3) { return kColor * pi; };
+  environments.push_back(constant);
+
+  // 1 + dot(w, d) / 2; the integral of w_i w_j is 4 pi / 3 if i == j
+  AnalyticEnvironment linear{[=](glm::vec3 w) { return kColor * (1.0f + 0.5f * glm::dot(w, d)); }};
+  linear.sh.coefficients[0] = kColor * k0 * 4.0f * pi;
+  linear.sh.coefficients[1] = kColor * 0.5f * k1 * 4.0f * pi / 3.0f * d.x;
+  linear.sh.coefficients[2] = kColor * 0.5f * k1 * 4.0f * pi / 3.0f * d.y;
+  linear.sh.coefficients[3] = kColor * 0.5f * k1 * 4.0f * pi / 3.0f * d.z;
+  linear.irradiance = [=](glm::vec3 n) { return kColor * (pi + 0.5f * 2.0f * pi / 3.0f * glm::dot(n, d)); };
+  environments.push_back(linear);
+
+  // dot(w, d)^2; the integral of w_i w_j w_k w_l is
+  // 4 pi / 15 (d_ij d_kl + d_ik d_jl + d_il d_jk)
+  AnalyticEnvironment quadratic{[=](glm::vec3 w) { return kColor * glm::dot(w, d) * glm::dot(w, d); }};
+  const float         c        = 4.0f * pi / 15.0f;
+  quadratic.sh.coefficients[0] = kColor * k0 * 4.0f * pi / 3.0f;
+  quadratic.sh.coefficients[4] = kColor * k2 * c * 2.0f * d.x * d.z;
+  quadratic.sh.coefficients[5] = kColor * k2 * c * 2.0f * d.x * d.y;
+  quadratic.sh.coefficients[6] = kColor * k20 * c * (6.0f * d.y * d.y - 2.0f);
+  quadratic.sh.coefficients[7] = kColor * k2 * c * 2.0f * d.y * d.z;
+  quadratic.sh.coefficients[8] = kColor * k22 * c * 2.0f * (d.z * d.z - d.x * d.x);
+  // Bands 0 and 2 of the cosine lobe scale by pi and pi / 4
+  quadratic.irradiance = [=](glm::vec3 n) {
+    return kColor * (pi / 3.0f + pi / 4.0f * (glm::dot(n, d) * glm::dot(n, d) - 1.0f / 3.0f));
+  };
+  environments.push_back(quadratic);
+  return environments;
+}
+
+void testSphericalHarmonics()
+{
+  const uint32_t width = 1024, height = 512;
+  for(const AnalyticEnvironment& analytic : makeAnalyticEnvironments())
+  {
+    const std::vector<float> rgba = makeEnvironment(width, height, analytic.radiance);
+    for(uint32_t threads : {1u, 0u})
+    {
+      const nvshaders::SphericalHarmonicsL2 projected = nvshaders::projectEnvironmentSH(rgba.data(), width, height, threads);
+      float largest = 0.0f, error = 0.0f;
+      for(size_t i = 0; i < projected.coefficients.size(); i++)
+      {
+        for(int c = 0; c < 3; c++)
+        {
+          largest = std::max(largest, std::abs(analytic.sh.coefficients[i][c]));
+          error   = std::max(error, std::abs(projected.coefficients[i][c] - analytic.sh.coefficients[i][c]));
+        }
+      }
+      CHECK(error <= 1e-4f * largest);
+
+      uint32_t rng  = 5678;
+      auto     next = [&] {
+        rng = rng * 1664525u + 1013904223u;
+        return float(rng >> 8) / 16777216.0f;
+      };
+      float irradianceError = 0.0f;
+      for(int i = 0; i < 1000; i++)
+      {
+        const float     z   = 2.0f * next() - 1.0f;
+        const float     phi = 2.0f * float(M_PI) * next();
+        const float     r   = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        const glm::vec3 n(r * std::cos(phi), r * std::sin(phi), z);
+        const glm::vec3 expected = analytic.irradiance(n);
+        const glm::vec3 actual   = nvshaders::evaluateIrradianceSH(projected, n);
+        for(int c = 0; c < 3; c++)
+        {
+          irradianceError = std::max(irradianceError, std::abs(actual[c] - expected[c]) / std::max(std::abs(expected[c]), 1e-3f));
+        }
+      }
+      CHECK(irradianceError < 1e-3f);
+    }
+  }
+}
+
+void testDiffuseCube()
+{
+  const AnalyticEnvironment       linear = makeAnalyticEnvironments()[1];
+  const uint32_t                  size   = 16;
+  const nvshaders::CubeMap        cube   = nvshaders::bakeDiffuseCube(linear.sh, size);
+  if(!CHECK(cube.size == size && cube.mips.size() == 1 && cube.mips[0].size() == size_t(6) * size * size * 4))
+  {
+    return;
+  }
+  float error = 0.0f;
+  for(uint32_t face = 0; face < 6; face++)
+  {
+    for(uint32_t y = 0; y < size; y++)
+    {
+      for(uint32_t x = 0; x < size; x++)
+      {
+        const glm::vec3 n = nvshaders::cubeMapDirection(face, (glm::vec2(x, y) + 0.5f) / float(size));
+        const glm::vec3 expected = nvshaders::evaluateIrradianceSH(linear.sh, glm::normalize(n)) / float(M_PI);
+        const float*    texel    = &cube.mips[0][((size_t(face) * size + y) * size + x) * 4];
+        for(int c = 0; c < 3; c++)
+        {
+          error = std::max(error, std::abs(texel[c] - expected[c]) / expected[c]);
+        }
+      }
+    }
+  }
+  CHECK(error < 1e-4f);
+}
+
+void testGlossyCube()
+{
+  // A constant environment prefilters to itself
+  const uint32_t           width = 256, height = 128, size = 32;
+  const std::vector<float> rgba  = makeEnvironment(width, height, [](glm::vec3) { return kColor; });
+  const nvshaders::CubeMap cube  = nvshaders::prefilterGlossyCube(rgba.data(), width, height, size, 32);
+  CHECK(cube.size == size && cube.mips.size() == 6);  // 32 down to 1
+  float error = 0.0f;
+  for(size_t mip = 0; mip < cube.mips.size(); mip++)
+  {
+    CHECK(cube.mips[mip].size() == size_t(6) * (size >> mip) * (size >> mip) * 4);
+    for(size_t i = 0; i + 3 < cube.mips[mip].size(); i += 4)
+    {
+      for(int c = 0; c < 3; c++)
+      {
+        error = std::max(error, std::abs(cube.mips[mip][i + c] - kColor[c]));
+      }
+    }
+  }
+  CHECK(error < 1e-4f);
+}
+
+void testBrdf()
+{
+  const uint32_t           size = 32;
+  const std::vector<float> lut  = nvshaders::integrateBrdfLut(size, 256);
+  if(!CHECK(lut.size() == size_t(size) * size * 2))
+  {
+    return;
+  }
+  float error = 0.0f;
+  for(uint32_t y = 0; y < size; y++)
+  {
+    for(uint32_t x = 0; x < size; x++)
+    {
+      // x is dot(N, V), y is 1 - roughness
+      const glm::vec2 expected = shaderio::integrateBrdf((float(x) + 0.5f) / float(size), 1.0f - (float(y) + 0.5f) / float(size), 256);
+      error = std::max({error, std::abs(lut[(size_t(y) * size + x) * 2] - expected.x),
+                        std::abs(lut[(size_t(y) * size + x) * 2 + 1] - expected.y)});
+      CHECK(expected.x >= 0.0f && expected.y >= 0.0f && expected.x + expected.y <= 1.0f + 1e-4f);
+    }
+  }
+  CHECK(error < 1e-5f);
+
+  // Nearly a mirror, seen head-on: all light is reflected, with F0
+  const glm::vec2 mirror = shaderio::integrateBrdf(0.999f, 0.01f, 1024);
+  CHECK(std::abs(mirror.x + mirror.y - 1.0f) < 1e-2f && mirror.y < 1e-2f);
+}
+
+bool writeAndReadKTX(const nv_ktx::KTXImage& written, const std::filesystem::path& path)
+{
+  nv_ktx::KTXImage copy = written;
+  if(!CHECK(!copy.writeKTX2File(path.string().c_str(), {})))
+  {
+    return false;
+  }
+  nv_ktx::KTXImage            read;
+  const nv_ktx::ErrorWithText error = read.readFromFile(path.string().c_str(), {});
+  std::filesystem::remove(path);
+  if(!CHECK(!error))
+  {
+    return false;
+  }
+  bool ok = read.format == written.format && read.mip_0_width == written.mip_0_width && read.num_mips == written.num_mips
+            && read.num_faces == written.num_faces;
+  for(uint32_t mip = 0; mip < written.num_mips && ok; mip++)
+  {
+    for(uint32_t face = 0; face < written.num_faces && ok; face++)
+    {
+      const std::span<const char> a = read.subresourceBytes(mip, 0, face);
+      const std::span<const char> b = written.subresourceBytes(mip, 0, face);
+      ok                            = std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+  }
+  return ok;
+}
+
+void testKTX()
+{
+  const std::vector<AnalyticEnvironment> analytic = makeAnalyticEnvironments();
+  const std::vector<float>               rgba     = makeEnvironment(64, 32, analytic[2].radiance);
+  const nvshaders::CubeMap               diffuse  = nvshaders::bakeDiffuseCube(analytic[2].sh, 8);
+  const nvshaders::CubeMap               glossy   = nvshaders::prefilterGlossyCube(rgba.data(), 64, 32, 16, 8);
+  const std::vector<float>               lut      = nvshaders::integrateBrdfLut(16, 64);
+
+  const std::filesystem::path temp = std::filesystem::temp_directory_path();
+  nv_ktx::KTXImage            image;
+  if(CHECK(!nvshaders::cubeMapToKTX(diffuse, image)))
+  {
+    CHECK(image.format == VK_FORMAT_R16G16B16A16_SFLOAT && image.num_faces == 6 && image.num_mips == 1);
+    CHECK(writeAndReadKTX(image, temp / "nvpro2_environment_bake_test_diffuse.ktx2"));
+  }
+  if(CHECK(!nvshaders::cubeMapToKTX(glossy, image)))
+  {
+    CHECK(image.num_faces == 6 && image.num_mips == 5);
+    CHECK(writeAndReadKTX(image, temp / "nvpro2_environment_bake_test_glossy.ktx2"));
+  }
+  if(CHECK(!nvshaders::brdfLutToKTX(lut, 16, image)))
+  {
+    CHECK(image.format == VK_FORMAT_R16G16_SFLOAT && image.num_faces == 1);
+    CHECK(writeAndReadKTX(image, temp / "nvpro2_environment_bake_test_brdf.ktx2"));
+  }
+  CHECK(nvshaders::brdfLutToKTX(std::span(lut).first(10), 16, image).has_value());
+}
+
+}  // namespace
+
+int main()
+{
+  testSphericalHarmonics();
+  testDiffuseCube();
+  testGlossyCube();
+  testBrdf();
+  testKTX();
+  return test_check::result();
+}
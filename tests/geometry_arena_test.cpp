@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvvkgltf::GeometryArenaLayout: ranges are aligned, in order, and don't
+overlap; a range that doesn't fit starts a new arena; oversized arrays get an
+arena of their own; empty arrays get invalid ranges; and the total and
+padding sizes add up. A randomized run checks the same invariants for many
+sizes and alignments.
+
+-----------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <vector>
+
+#include "nvvkgltf/geometry_arena.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvvkgltf::GeometryArenaLayout;
+
+bool sameRange(const GeometryArenaLayout::Range& range, uint32_t arena, uint64_t offset, uint64_t size)
+{
+  return range.arena == arena && range.offset == offset && range.size == size;
+}
+
+// Adds `sizes` to a layout and checks that every range is aligned, lies
+// within its arena, doesn't overlap the previous range, and that the sizes
+// reported by the layout match the ranges.
+void checkInvariants(uint64_t maxArenaSize, uint64_t alignment, const std::vector<uint64_t>& sizes)
+{
+  GeometryArenaLayout layout(maxArenaSize, alignment);
+  std::vector<GeometryArenaLayout::Range> ranges;
+  for(uint64_t size : sizes)
+  {
+    ranges.push_back(layout.add(size));
+  }
+
+  std::vector<uint64_t> arenaEnds(layout.getArenaCount(), 0);
+  uint64_t              usedBytes = 0;
+  uint32_t              lastArena = 0;
+  for(size_t i = 0; i < ranges.size(); i++)
+  {
+    const GeometryArenaLayout::Range& range = ranges[i];
+    if(sizes[i] == 0)
+    {
+      CHECK(!range.isValid());
+      continue;
+    }
+    if(!CHECK(range.isValid() && range.arena < layout.getArenaCount()))
+    {
+      continue;
+    }
+    CHECK(range.size == sizes[i]);
+    CHECK(range.offset % alignment == 0);
+    // Arenas are filled in order, and never revisited.
+    CHECK(range.arena >= lastArena);
+    lastArena = range.arena;
+    // Ranges in an arena follow each other.
+    CHECK(range.offset >= arenaEnds[range.arena]);
+    arenaEnds[range.arena] = range.offset + range.size;
+    // Only an array larger than the maximum may exceed it, and then alone.
+    if(range.offset + range.size > maxArenaSize)
+    {
+      CHECK(range.offset == 0);
+    }
+    usedBytes += range.size;
+  }
+
+  uint64_t totalSize = 0;
+  for(uint32_t arena = 0; arena < layout.getArenaCount(); arena++)
+  {
+    CHECK(layout.getArenaSizes()[arena] == arenaEnds[arena]);
+    totalSize += layout.getArenaSizes()[arena];
+  }
+  CHECK(layout.getTotalSize() == totalSize);
+  CHECK(layout.getTotalSize() == usedBytes + layout.getPaddingBytes());
+}
+
+}  // namespace
+
+int main()
+{
+  // Packing, alignment and arena changes.
+  {
+    GeometryArenaLayout layout(256, 16);
+    CHECK(layout.getArenaCount() == 0);
+    CHECK(layout.getTotalSize() == 0);
+
+    CHECK(sameRange(layout.add(100), 0, 0, 100));
+    CHECK(sameRange(layout.add(12), 0, 112, 12));   // 100 rounded up to 112
+    CHECK(sameRange(layout.add(128), 0, 128, 128));  // Ends exactly at 256
+    CHECK(sameRange(layout.add(1), 1, 0, 1));        // Doesn't fit: new arena
+    CHECK(sameRange(layout.add(1000), 2, 0, 1000));  // Too large: own arena
+    CHECK(sameRange(layout.add(4), 3, 0, 4));        // The oversized arena is full
+    CHECK(!layout.add(0).isValid());
+    CHECK(sameRange(layout.add(240), 3, 16, 240));
+
+    CHECK(layout.getArenaCount() == 4);
+    CHECK((layout.getArenaSizes() == std::vector<uint64_t>{256, 1, 1000, 256}));
+    CHECK(layout.getTotalSize() == 256 + 1 + 1000 + 256);
+    CHECK(layout.getPaddingBytes() == 12 + 4 + 12);
+  }
+
+  // An empty array doesn't start an arena.
+  {
+    GeometryArenaLayout layout(1024);
+    const GeometryArenaLayout::Range empty = layout.add(0);
+    CHECK(!empty.isValid());
+    CHECK(empty.arena == GeometryArenaLayout::kInvalidArena);
+    CHECK(layout.getArenaCount() == 0);
+  }
+
+  // The default alignment, and an alignment of 1, which packs tightly.
+  {
+    GeometryArenaLayout layout(1024);
+    layout.add(3);
+    CHECK(layout.add(3).offset == GeometryArenaLayout::kDefaultAlignment);
+
+    GeometryArenaLayout packed(1024, 1);
+    packed.add(3);
+    CHECK(sameRange(packed.add(5), 0, 3, 5));
+    CHECK(packed.getPaddingBytes() == 0);
+  }
+
+  // Sizes that don't fit into a 32-bit offset.
+  {
+    const uint64_t      gib = uint64_t(1) << 30;
+    GeometryArenaLayout layout(8 * gib, 256);
+    CHECK(sameRange(layout.add(5 * gib + 1), 0, 0, 5 * gib + 1));
+    CHECK(sameRange(layout.add(gib), 0, 5 * gib + 256, gib));
+    CHECK(sameRange(layout.add(2 * gib), 1, 0, 2 * gib));
+  }
+
+  // Randomized sizes, including empty and oversized ones.
+  uint32_t rng  = 1;
+  auto     next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+  for(uint32_t run = 0; run < 200; run++)
+  {
+    const uint64_t        alignment    = uint64_t(1) << (next() % 9);
+    const uint64_t        maxArenaSize = 1 + next() % 4096;
+    std::vector<uint64_t> sizes(next() % 100);
+    for(uint64_t& size : sizes)
+    {
+      size = (next() % 8 == 0) ? 0 : 1 + next() % (maxArenaSize + maxArenaSize / 4);
+    }
+    checkInvariants(maxArenaSize, alignment, sizes);
+  }
+
+  return test_check::result();
+}
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks mip_generation's quality and bookkeeping:
+* Box-filtered mip chains of float and 8-bit images against a scalar
+  reference that computes exact coverage weights in double precision,
+  including odd sizes such as 37 x 23.
+* sRGB: every 8-bit value round trips through linear space unchanged, and
+  black and white average to linear 50% gray rather than sRGB 50% gray.
+* Kaiser and Lanczos filters preserve constant images.
+* generateMips() on KTX and DDS images: mip counts and sizes, maxMips,
+  app_should_generate_mips, and identical output on one thread vs. the
+  thread pool.
+* Errors for unsupported formats, 3D textures, and small buffers.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <directx/dxgiformat.h>
+
+#include "nvimageformats/mip_generation.h"
+#include "nvimageformats/nv_dds.h"
+#include "nvimageformats/nv_ktx.h"
+
+#include "test_check.hpp"
+
+namespace {
+
+uint32_t g_rng = 12345;
+
+uint32_t nextRandom()
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return g_rng;
+}
+
+// A double-precision image with `channels` values per texel.
+struct RefImage
+{
+  uint32_t            width    = 0;
+  uint32_t            height   = 0;
+  uint32_t            channels = 0;
+  std::vector<double> values;
+
+  double& at(uint32_t x, uint32_t y, uint32_t c) { return values[(size_t(y) * width + x) * channels + c]; }
+  double  at(uint32_t x, uint32_t y, uint32_t c) const { return values[(size_t(y) * width + x) * channels + c]; }
+};
+
+// The weight of source texel `s` for destination texel `d` when box-filtering
+// `srcSize` texels down to `dstSize`: the length of the overlap of [s, s + 1)
+// with d's footprint, divided by the footprint's length.
+double boxWeight(uint32_t s, uint32_t d, uint32_t srcSize, uint32_t dstSize)
+{
+  const double scale   = double(srcSize) / double(dstSize);
+  const double lo      = double(d) * scale;
+  const double hi      = double(d + 1) * scale;
+  const double overlap = std::min(double(s) + 1.0, hi) - std::max(double(s), lo);
+  return std::max(overlap, 0.0) / scale;
+}
+
+// Box-filters `src` down to the next mip, texel by texel.
+RefImage referenceBoxMip(const RefImage& src)
+{
+  RefImage dst;
+  dst.width    = std::max(1u, src.width / 2);
+  dst.height   = std::max(1u, src.height / 2);
+  dst.channels = src.channels;
+  dst.values.assign(size_t(dst.width) * dst.height * dst.channels, 0.0);
+  for(uint32_t y = 0; y < dst.height; y++)
+  {
+    for(uint32_t x = 0; x < dst.width; x++)
+    {
+      for(uint32_t sy = 0; sy < src.height; sy++)
+      {
+        const double wy = boxWeight(sy, y, src.height, dst.height);
+        for(uint32_t sx = 0; wy > 0.0 && sx < src.width; sx++)
+        {
+          const double w = wy * boxWeight(sx, x, src.width, dst.width);
+          for(uint32_t c = 0; w > 0.0 && c < src.channels; c++)
+          {
+            dst.at(x, y, c) += w * src.at(sx, sy, c);
+          }
+        }
+      }
+    }
+  }
+  return dst;
+}
+
+double srgbToLinear(double c)
+{
+  return (c <= 0.04045) ? (c / 12.92) : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+double linearToSRGB(double c)
+{
+  return (c <= 0.0031308) ? (c * 12.92) : (1.055 * std::pow(c, 1.0 / 2.4) - 0.055);
+}
+
+mip_generation::Settings boxSettings(uint32_t numThreads = 0)
+{
+  mip_generation::Settings settings;
+  settings.filter     = mip_generation::Filter::eBox;
+  settings.numThreads = numThreads;
+  return settings;
+}
+
+// Makes a `width` x `height` RGBA image in `format` with random mip 0 texels.
+nv_ktx::KTXImage makeKTXImage(VkFormat format, uint32_t width, uint32_t height, uint32_t numLayers, size_t texelBytes)
+{
+  nv_ktx::KTXImage image;
+  image.format       = format;
+  image.mip_0_width  = width;
+  image.mip_0_height = height;
+  CHECK(!image.allocate(1, numLayers, 1).has_value());
+  for(uint32_t layer = 0; layer < std::max(1u, numLayers); layer++)
+  {
+    std::vector<char>& bytes = image.subresource(0, layer, 0);
+    bytes.resize(size_t(width) * height * texelBytes);
+    if(format == VK_FORMAT_R32G32B32A32_SFLOAT)
+    {
+      for(size_t i = 0; i < bytes.size() / sizeof(float); i++)
+      {
+        const float value = float(nextRandom() >> 8) / float(1 << 24);
+        memcpy(bytes.data() + i * sizeof(float), &value, sizeof(float));
+      }
+    }
+    else
+    {
+      for(char& c : bytes)
+      {
+        c = char(nextRandom() >> 24);
+      }
+    }
+  }
+  return image;
+}
+
+// Box-filters float and 8-bit UNORM images and compares each mip with the
+// scalar reference. Each reference mip is computed from the unquantized
+// previous one, as mip_generation does.
+void testBoxFilter(uint32_t width, uint32_t height)
+{
+  for(VkFormat format : {VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB})
+  {
+    const bool       isFloat    = (format == VK_FORMAT_R32G32B32A32_SFLOAT);
+    const bool       isSRGB     = (format == VK_FORMAT_R8G8B8A8_SRGB);
+    const size_t     texelBytes = isFloat ? 16 : 4;
+    nv_ktx::KTXImage image      = makeKTXImage(format, width, height, 0, texelBytes);
+
+    RefImage reference{width, height, 4, {}};
+    reference.values.resize(size_t(width) * height * 4);
+    const std::vector<char>& mip0 = image.subresource(0, 0, 0);
+    for(size_t i = 0; i < reference.values.size(); i++)
+    {
+      if(isFloat)
+      {
+        float value;
+        memcpy(&value, mip0.data() + i * sizeof(float), sizeof(float));
+        reference.values[i] = value;
+      }
+      else
+      {
+        const double value  = double(static_cast<uint8_t>(mip0[i])) / 255.0;
+        reference.values[i] = (isSRGB && (i % 4) < 3) ? srgbToLinear(value) : value;
+      }
+    }
+
+    if(!CHECK(!mip_generation::generateMips(image, boxSettings()).has_value()))
+    {
+      continue;
+    }
+    CHECK(image.num_mips == mip_generation::getFullMipCount(width, height));
+    for(uint32_t mip = 1; mip < image.num_mips; mip++)
+    {
+      reference                      = referenceBoxMip(reference);
+      const std::vector<char>& bytes = image.subresource(mip, 0, 0);
+      if(!CHECK(bytes.size() == reference.values.size() * (isFloat ? sizeof(float) : 1)))
+      {
+        break;
+      }
+      double maxError = 0.0;
+      for(size_t i = 0; i < reference.values.size(); i++)
+      {
+        if(isFloat)
+        {
+          float value;
+          memcpy(&value, bytes.data() + i * sizeof(float), sizeof(float));
+          maxError = std::max(maxError, std::abs(double(value) - reference.values[i]));
+        }
+        else
+        {
+          double expected = std::clamp(reference.values[i], 0.0, 1.0);
+          if(isSRGB && (i % 4) < 3)
+          {
+            expected = linearToSRGB(expected);
+          }
+          // Allow a difference of 1 where the reference is very close to
+          // halfway between two values.
+          maxError = std::max(maxError, std::abs(double(static_cast<uint8_t>(bytes[i])) - std::floor(expected * 255.0 + 0.5)));
+        }
+      }
+      CHECK(maxError <= (isFloat ? 1e-5 : 1.0));
+    }
+  }
+}
+
+// Splits 5 texels into 2, where the middle texel is shared.
+void testOddFootprint()
+{
+  const float       src[5] = {1.0f, 2.0f, 4.0f, 8.0f, 16.0f};
+  float             dst[2] = {};
+  const std::span   srcBytes(reinterpret_cast<const char*>(src), sizeof(src));
+  const std::span   dstBytes(reinterpret_cast<char*>(dst), sizeof(dst));
+  CHECK(!mip_generation::downsample(VK_FORMAT_R32_SFLOAT, 5, 1, srcBytes, 2, 1, dstBytes, boxSettings()).has_value());
+  CHECK(std::abs(dst[0] - (1.0f + 2.0f + 0.5f * 4.0f) / 2.5f) < 1e-5f);
+  CHECK(std::abs(dst[1] - (0.5f * 4.0f + 8.0f + 16.0f) / 2.5f) < 1e-5f);
+}
+
+void testSRGB()
+{
+  // Every 8-bit value survives conversion to linear and back: a 512 x 2
+  // image where texels 2v and 2v + 1 have value v becomes a 256 x 1 image
+  // where texel v has value v.
+  for(VkFormat format : {VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM})
+  {
+    std::vector<char> src(512 * 2 * 4);
+    for(size_t i = 0; i < src.size(); i++)
+    {
+      src[i] = char(((i / 4) % 512) / 2);
+    }
+    std::vector<char>        dst(256 * 4);
+    mip_generation::Settings settings = boxSettings();
+    settings.colorSpace               = mip_generation::ColorSpace::eSRGB;
+    CHECK(!mip_generation::downsample(format, 512, 2, src, 256, 1, dst, settings).has_value());
+    bool roundTrips = true;
+    for(size_t i = 0; i < dst.size(); i++)
+    {
+      roundTrips = roundTrips && (static_cast<uint8_t>(dst[i]) == i / 4);
+    }
+    CHECK(roundTrips);
+  }
+
+  // So do 16-bit values that are forced to sRGB.
+  {
+    std::vector<uint16_t> src(2 * 2 * 4);
+    for(size_t i = 0; i < src.size(); i++)
+    {
+      src[i] = uint16_t(0x1234 * (i % 4 + 1));
+    }
+    std::vector<uint16_t>    dst(4);
+    mip_generation::Settings settings = boxSettings();
+    settings.colorSpace               = mip_generation::ColorSpace::eSRGB;
+    CHECK(!mip_generation::downsample(VK_FORMAT_R16G16B16A16_UNORM, 2, 2,
+                                      {reinterpret_cast<const char*>(src.data()), src.size() * 2}, 1, 1,
+                                      {reinterpret_cast<char*>(dst.data()), dst.size() * 2}, settings)
+               .has_value());
+    CHECK(std::equal(dst.begin(), dst.end(), src.begin()));
+  }
+
+  // Black and white average to linear 50% gray in sRGB, and to sRGB 50% gray
+  // otherwise. Alpha is always averaged linearly.
+  const uint8_t src[2 * 4] = {0, 0, 0, 0, 255, 255, 255, 255};
+  const uint8_t srgbGray   = uint8_t(std::floor(linearToSRGB(0.5) * 255.0 + 0.5));
+  for(const auto& [format, colorSpace, expected] :
+      {std::tuple{VK_FORMAT_R8G8B8A8_SRGB, mip_generation::ColorSpace::eFromFormat, srgbGray},
+       std::tuple{VK_FORMAT_R8G8B8A8_UNORM, mip_generation::ColorSpace::eSRGB, srgbGray},
+       std::tuple{VK_FORMAT_R8G8B8A8_SRGB, mip_generation::ColorSpace::eLinear, uint8_t(128)},
+       std::tuple{VK_FORMAT_R8G8B8A8_UNORM, mip_generation::ColorSpace::eFromFormat, uint8_t(128)}})
+  {
+    uint8_t                  dst[4]   = {};
+    mip_generation::Settings settings = boxSettings();
+    settings.colorSpace               = colorSpace;
+    CHECK(!mip_generation::downsample(format, 2, 1, {reinterpret_cast<const char*>(src), sizeof(src)}, 1, 1,
+                                      {reinterpret_cast<char*>(dst), sizeof(dst)}, settings)
+               .has_value());
+    CHECK(dst[0] == expected && dst[1] == expected && dst[2] == expected);
+    CHECK(dst[3] == 128);
+  }
+}
+
+// Filters with negative lobes still have weights that sum to 1, including
+// at clamped edges and odd sizes.
+void testConstantImages()
+{
+  for(mip_generation::Filter filter : {mip_generation::Filter::eKaiser, mip_generation::Filter::eLanczos})
+  {
+    nv_ktx::KTXImage image;
+    image.format       = VK_FORMAT_R32G32_SFLOAT;
+    image.mip_0_width  = 37;
+    image.mip_0_height = 23;
+    CHECK(!image.allocate(1, 0, 1).has_value());
+    const float              constant[2] = {0.25f, 3.0f};
+    std::vector<char>&       mip0        = image.subresource(0, 0, 0);
+    for(uint32_t i = 0; i < 37 * 23; i++)
+    {
+      mip0.insert(mip0.end(), reinterpret_cast<const char*>(constant), reinterpret_cast<const char*>(constant) + 8);
+    }
+    mip_generation::Settings settings;
+    settings.filter = filter;
+    CHECK(!mip_generation::generateMips(image, settings).has_value());
+    float maxError = 0.0f;
+    for(uint32_t mip = 1; mip < image.num_mips; mip++)
+    {
+      const std::vector<char>& bytes = image.subresource(mip, 0, 0);
+      for(size_t i = 0; i < bytes.size() / sizeof(float); i++)
+      {
+        float value;
+        memcpy(&value, bytes.data() + i * sizeof(float), sizeof(float));
+        maxError = std::max(maxError, std::abs(value - constant[i % 2]) / constant[i % 2]);
+      }
+    }
+    CHECK(maxError < 1e-5f);
+  }
+}
+
+void testGenerateMips()
+{
+  // KTX: a texture array with odd sizes, a full chain vs. maxMips, and one
+  // thread vs. the thread pool.
+  for(mip_generation::Filter filter :
+      {mip_generation::Filter::eBox, mip_generation::Filter::eKaiser, mip_generation::Filter::eLanczos})
+  {
+    const nv_ktx::KTXImage original = makeKTXImage(VK_FORMAT_R8G8B8A8_SRGB, 37, 23, 2, 4);
+    nv_ktx::KTXImage       serial   = original;
+    nv_ktx::KTXImage       parallel = original;
+    serial.app_should_generate_mips = true;
+    mip_generation::Settings settings;
+    settings.filter     = filter;
+    settings.numThreads = 1;
+    CHECK(!mip_generation::generateMips(serial, settings).has_value());
+    settings.numThreads = 0;
+    CHECK(!mip_generation::generateMips(parallel, settings).has_value());
+    CHECK(!serial.app_should_generate_mips);
+    CHECK(serial.num_mips == 6);  // 37 x 23 down to 1 x 1
+    CHECK(parallel.num_mips == serial.num_mips);
+    for(uint32_t layer = 0; layer < 2; layer++)
+    {
+      const std::span<const char> originalMip0 = original.subresourceBytes(0, layer, 0);
+      CHECK(std::equal(originalMip0.begin(), originalMip0.end(), serial.subresource(0, layer, 0).begin(),
+                       serial.subresource(0, layer, 0).end()));
+      for(uint32_t mip = 0; mip < serial.num_mips; mip++)
+      {
+        const size_t expectedBytes = size_t(std::max(1u, 37u >> mip)) * std::max(1u, 23u >> mip) * 4;
+        CHECK(serial.subresource(mip, layer, 0).size() == expectedBytes);
+        CHECK(serial.subresource(mip, layer, 0) == parallel.subresource(mip, layer, 0));
+      }
+    }
+
+    nv_ktx::KTXImage truncated = original;
+    settings.maxMips           = 3;
+    CHECK(!mip_generation::generateMips(truncated, settings).has_value());
+    CHECK(truncated.num_mips == 3);
+    CHECK(truncated.subresource(2, 1, 0) == serial.subresource(2, 1, 0));
+  }
+
+  // DDS gives the same mips as KTX for the same data.
+  const nv_ktx::KTXImage ktxOriginal = makeKTXImage(VK_FORMAT_R32G32B32A32_SFLOAT, 19, 8, 0, 16);
+  nv_ktx::KTXImage       ktx         = ktxOriginal;
+  nv_dds::Image          dds;
+  dds.dxgiFormat = DXGI_FORMAT_R32G32B32A32_FLOAT;
+  dds.mip0Width  = 19;
+  dds.mip0Height = 8;
+  dds.mip0Depth  = 1;
+  CHECK(!dds.allocate(1, 1, 1).has_value());
+  const std::span<const char> ktxMip0 = ktxOriginal.subresourceBytes(0, 0, 0);
+  dds.subresource(0, 0, 0).data.assign(ktxMip0.begin(), ktxMip0.end());
+  CHECK(!mip_generation::generateMips(ktx).has_value());
+  CHECK(!mip_generation::generateMips(dds).has_value());
+  CHECK(dds.getNumMips() == ktx.num_mips);
+  for(uint32_t mip = 0; mip < std::min(dds.getNumMips(), ktx.num_mips); mip++)
+  {
+    const std::span<const char> ddsBytes = dds.subresource(mip, 0, 0).bytes();
+    const std::vector<char>&    ktxBytes = ktx.subresource(mip, 0, 0);
+    CHECK(std::equal(ddsBytes.begin(), ddsBytes.end(), ktxBytes.begin(), ktxBytes.end()));
+  }
+}
+
+void testErrors()
+{
+  std::vector<char> src(16 * 16 * 4);
+  std::vector<char> dst(8 * 8 * 4);
+  CHECK(!mip_generation::isFormatSupported(VK_FORMAT_BC7_UNORM_BLOCK));
+  CHECK(mip_generation::isFormatSupported(VK_FORMAT_R16G16B16A16_SFLOAT));
+  CHECK(mip_generation::downsample(VK_FORMAT_BC7_UNORM_BLOCK, 16, 16, src, 8, 8, dst).has_value());
+  CHECK(mip_generation::downsample(VK_FORMAT_R8G8B8A8_UNORM, 17, 16, src, 8, 8, dst).has_value());
+  CHECK(mip_generation::downsample(VK_FORMAT_R8G8B8A8_UNORM, 16, 16, src, 9, 8, dst).has_value());
+  CHECK(mip_generation::downsample(VK_FORMAT_R8G8B8A8_UNORM, 0, 16, src, 8, 8, dst).has_value());
+  CHECK(!mip_generation::downsample(VK_FORMAT_R8G8B8A8_UNORM, 16, 16, src, 8, 8, dst).has_value());
+
+  nv_ktx::KTXImage volume;
+  volume.format       = VK_FORMAT_R8G8B8A8_UNORM;
+  volume.mip_0_width  = 4;
+  volume.mip_0_height = 4;
+  volume.mip_0_depth  = 4;
+  CHECK(!volume.allocate(1, 0, 1).has_value());
+  CHECK(mip_generation::generateMips(volume).has_value());
+
+  // A mip 0 that's too small leaves the image unmodified.
+  nv_ktx::KTXImage small = makeKTXImage(VK_FORMAT_R8G8B8A8_UNORM, 8, 8, 0, 4);
+  small.subresource(0, 0, 0).resize(8 * 7 * 4);
+  CHECK(mip_generation::generateMips(small).has_value());
+  CHECK(small.num_mips == 1);
+}
+
+}  // namespace
+
+int main()
+{
+  testBoxFilter(64, 64);
+  testBoxFilter(37, 23);
+  testBoxFilter(1, 5);
+  testOddFootprint();
+  testSRGB();
+  testConstantImages();
+  testGenerateMips();
+  testErrors();
+  return test_check::result();
+}
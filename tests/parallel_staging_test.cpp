@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the staging space reservations of StagingUploader's parallel appends:
+
+* nvutils::AtomicLinearAllocator rounds sizes up to the alignment, fails
+  once the capacity is used up, and hands out ranges that don't overlap when
+  8 threads reserve at once.
+* StagingUploader::appendBufferParallel() from 8 threads, with staging space
+  from host memory (see HostStagingUploader), so that no device is needed:
+  endParallelAppend() appends one copy command per destination buffer, with
+  sorted, non-overlapping regions that are merged only where contiguous in
+  both staging and destination memory, and replaying the regions on the
+  host reproduces the uploaded data. Running out of staging space returns
+  VK_ERROR_OUT_OF_POOL_MEMORY, and mapped buffers are written directly.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "nvutils/atomic_linear_allocator.hpp"
+#include "nvvk/staging.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+constexpr uint32_t     kThreads       = 8;
+constexpr VkDeviceSize kStagingOffset = 256;  // Where the staging space starts in the staging buffer
+
+VkBuffer fakeBuffer(uintptr_t id)
+{
+  return reinterpret_cast<VkBuffer>(id * 0x1000);
+}
+
+// Hands out staging space from host memory rather than from a buffer of the
+// ResourceAllocator, and gives access to the appended copy commands.
+class HostStagingUploader : public nvvk::StagingUploader
+{
+public:
+  VkResult acquireStagingSpace(nvvk::BufferRange&          stagingSpace,
+                               size_t                      dataSize,
+                               const void*                 data,
+                               const nvvk::SemaphoreState& semaphoreState = {}) override
+  {
+    memory.assign(kStagingOffset + dataSize, 0);
+    stagingSpace.buffer  = fakeBuffer(100);
+    stagingSpace.offset  = kStagingOffset;
+    stagingSpace.range   = dataSize;
+    stagingSpace.mapping = memory.data() + kStagingOffset;
+    if(data)
+    {
+      memcpy(stagingSpace.mapping, data, dataSize);
+    }
+    return VK_SUCCESS;
+  }
+  void releaseStaging(bool forceAll = false) override {}
+
+  const Batch& getBatch() const { return m_batch; }
+
+  std::vector<uint8_t> memory;  // The staging buffer
+};
+
+struct Chunk
+{
+  uint32_t     buffer = 0;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size   = 0;
+};
+
+void testAtomicLinearAllocator()
+{
+  nvutils::AtomicLinearAllocator allocator(100, 16);
+  CHECK(allocator.getCapacity() == 100 && allocator.getAlignment() == 16);
+  CHECK(allocator.reserve(1) == 0);
+  CHECK(allocator.reserve(16) == 16);
+  CHECK(allocator.reserve(40) == 32);
+  CHECK(allocator.getReservedSize() == 80);
+  CHECK(allocator.reserve(20) == 80);  // Ends exactly at the capacity
+  CHECK(allocator.reserve(1) == nvutils::AtomicLinearAllocator::INVALID_OFFSET);
+  CHECK(allocator.reserve(0) == nvutils::AtomicLinearAllocator::INVALID_OFFSET);  // Full
+  CHECK(allocator.getReservedSize() == 100);
+  allocator.reset();
+  CHECK(allocator.getReservedSize() == 0);
+  CHECK(allocator.reserve(101) == nvutils::AtomicLinearAllocator::INVALID_OFFSET);
+  CHECK(allocator.reserve(1) == nvutils::AtomicLinearAllocator::INVALID_OFFSET);  // Once failed, fails until reset()
+  allocator.reset();
+  CHECK(allocator.reserve(100) == 0);
+
+  // Concurrent reservations: all succeed when they fit, and don't overlap.
+  // With half the capacity, the successful ones fill at most the capacity.
+  for(const uint64_t capacity : {uint64_t(1) << 24, uint64_t(1) << 16})
+  {
+    allocator.init(capacity, 16);
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> ranges(kThreads);
+    std::vector<uint32_t>                                   failures(kThreads, 0);
+    std::vector<std::thread>                                threads;
+    for(uint32_t t = 0; t < kThreads; t++)
+    {
+      threads.emplace_back([&, t]() {
+        for(uint64_t i = 0; i < 1000; i++)
+        {
+          const uint64_t size   = 1 + (i * 37 + t * 11) % 60;
+          const uint64_t offset = allocator.reserve(size);
+          if(offset == nvutils::AtomicLinearAllocator::INVALID_OFFSET)
+          {
+            failures[t]++;
+          }
+          else
+          {
+            ranges[t].push_back({offset, size});
+          }
+        }
+      });
+    }
+    for(std::thread& thread : threads)
+    {
+      thread.join();
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> all;
+    for(const auto& threadRanges : ranges)
+    {
+      all.insert(all.end(), threadRanges.begin(), threadRanges.end());
+    }
+    std::sort(all.begin(), all.end());
+    for(size_t i = 0; i < all.size(); i++)
+    {
+      CHECK(all[i].first % 16 == 0);
+      CHECK(all[i].first + all[i].second <= capacity);
+      if(i > 0)
+      {
+        CHECK(all[i - 1].first + all[i - 1].second <= all[i].first);
+      }
+    }
+    const auto threadsWithFailures = std::count_if(failures.begin(), failures.end(), [](uint32_t f) { return f != 0; });
+    if(capacity == uint64_t(1) << 24)
+    {
+      CHECK(threadsWithFailures == 0);
+      CHECK(all.size() == kThreads * 1000);
+    }
+    else
+    {
+      CHECK(threadsWithFailures != 0);
+    }
+  }
+}
+
+void testParallelAppend()
+{
+  nvvk::ResourceAllocator resourceAllocator;  // Not initialized; HostStagingUploader doesn't use it
+  HostStagingUploader     uploader;
+  uploader.init(&resourceAllocator);
+
+  // Three buffers, split into chunks of various sizes. Sizes that aren't
+  // multiples of PARALLEL_ALIGNMENT leave gaps in staging memory.
+  const VkDeviceSize bufferSize = 64 * 1024;
+  nvvk::Buffer       buffers[3];
+  std::vector<Chunk> chunks;
+  VkDeviceSize       stagingSize = 0;
+  for(uint32_t b = 0; b < 3; b++)
+  {
+    buffers[b].buffer     = fakeBuffer(b + 1);
+    buffers[b].bufferSize = bufferSize;
+    for(VkDeviceSize offset = 0; offset < bufferSize;)
+    {
+      const VkDeviceSize size = std::min(bufferSize - offset, VkDeviceSize(b == 0 ? 512 : 100 + (offset * 7) % 900));
+      chunks.push_back({b, offset, size});
+      stagingSize += (size + nvvk::StagingUploader::PARALLEL_ALIGNMENT - 1) / nvvk::StagingUploader::PARALLEL_ALIGNMENT
+                     * nvvk::StagingUploader::PARALLEL_ALIGNMENT;
+      offset += size;
+    }
+  }
+  auto expectedByte = [](uint32_t buffer, VkDeviceSize offset) { return uint8_t(buffer * 101 + offset * 13 + (offset >> 8)); };
+
+  CHECK(uploader.beginParallelAppend(stagingSize, kThreads) == VK_SUCCESS);
+  std::vector<std::thread> threads;
+  std::vector<VkResult>    results(kThreads, VK_SUCCESS);
+  for(uint32_t t = 0; t < kThreads; t++)
+  {
+    threads.emplace_back([&, t]() {
+      // Interleaved, so that the staging ranges of a buffer aren't in order
+      for(size_t c = t; c < chunks.size(); c += kThreads)
+      {
+        const Chunk&         chunk = chunks[chunks.size() - 1 - c];
+        std::vector<uint8_t> data(chunk.size);
+        for(VkDeviceSize i = 0; i < chunk.size; i++)
+        {
+          data[i] = expectedByte(chunk.buffer, chunk.offset + i);
+        }
+        const VkResult result = uploader.appendBufferParallel(t, buffers[chunk.buffer], chunk.offset, chunk.size, data.data());
+        if(result != VK_SUCCESS)
+        {
+          results[t] = result;
+        }
+      }
+    });
+  }
+  for(std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  for(VkResult result : results)
+  {
+    CHECK(result == VK_SUCCESS);
+  }
+  uploader.endParallelAppend();
+
+  // Replay the copy commands on the host.
+  const auto& batch = uploader.getBatch();
+  CHECK(batch.stagingSize == stagingSize);
+  CHECK(batch.copyBufferInfos.size() == 3);
+  std::map<VkBuffer, std::vector<uint8_t>> destinations;
+  size_t                                   regionIndex = 0;
+  for(const VkCopyBufferInfo2& info : batch.copyBufferInfos)
+  {
+    CHECK(info.srcBuffer == fakeBuffer(100));
+    CHECK(destinations.count(info.dstBuffer) == 0);
+    std::vector<uint8_t>& dst = destinations[info.dstBuffer];
+    dst.resize(bufferSize);
+    if(!CHECK(regionIndex + info.regionCount <= batch.copyBufferRegions.size()))
+    {
+      break;
+    }
+    for(uint32_t r = 0; r < info.regionCount; r++)
+    {
+      const VkBufferCopy2& region = batch.copyBufferRegions[regionIndex + r];
+      if(!CHECK(region.srcOffset >= kStagingOffset && region.srcOffset + region.size <= uploader.memory.size()
+                && region.dstOffset + region.size <= bufferSize))
+      {
+        continue;
+      }
+      memcpy(dst.data() + region.dstOffset, uploader.memory.data() + region.srcOffset, region.size);
+      if(r > 0)
+      {
+        // Sorted, not overlapping, and only separate where they can't be merged
+        const VkBufferCopy2& previous = batch.copyBufferRegions[regionIndex + r - 1];
+        CHECK(previous.dstOffset + previous.size <= region.dstOffset);
+        CHECK(previous.srcOffset + previous.size != region.srcOffset || previous.dstOffset + previous.size != region.dstOffset);
+      }
+    }
+    regionIndex += info.regionCount;
+  }
+  CHECK(regionIndex == batch.copyBufferRegions.size());
+  for(uint32_t b = 0; b < 3; b++)
+  {
+    const std::vector<uint8_t>& dst = destinations[buffers[b].buffer];
+    bool                        ok  = dst.size() == bufferSize;
+    for(VkDeviceSize i = 0; ok && i < bufferSize; i++)
+    {
+      ok = dst[i] == expectedByte(b, i);
+    }
+    CHECK(ok);
+  }
+  uploader.cancelAppended();
+
+  // Aligned chunks appended in order by one thread become one region.
+  CHECK(uploader.beginParallelAppend(4096, 1) == VK_SUCCESS);
+  std::vector<uint8_t> data(1024, 7);
+  for(VkDeviceSize offset = 0; offset < 4096; offset += 1024)
+  {
+    CHECK(uploader.appendBufferParallel(0, buffers[0], offset, 1024, data.data()) == VK_SUCCESS);
+  }
+  // Out of staging space
+  CHECK(uploader.appendBufferParallel(0, buffers[0], 8192, 16, data.data()) == VK_ERROR_OUT_OF_POOL_MEMORY);
+  // Empty appends and mapped buffers don't use staging space
+  CHECK(uploader.appendBufferParallel(0, buffers[1], 0, 0, nullptr) == VK_SUCCESS);
+  std::vector<uint8_t> mappedMemory(64, 0);
+  nvvk::Buffer         mapped;
+  mapped.buffer     = fakeBuffer(4);
+  mapped.bufferSize = mappedMemory.size();
+  mapped.mapping    = mappedMemory.data();
+  CHECK(uploader.appendBufferParallel(0, mapped, 16, 32, data.data()) == VK_SUCCESS);
+  CHECK(mappedMemory[15] == 0 && mappedMemory[16] == 7 && mappedMemory[47] == 7 && mappedMemory[48] == 0);
+  uploader.endParallelAppend();
+  CHECK(batch.copyBufferInfos.size() == 1);
+  CHECK(batch.copyBufferRegions.size() == 1);
+  if(batch.copyBufferRegions.size() == 1)
+  {
+    CHECK(batch.copyBufferRegions[0].srcOffset == kStagingOffset);
+    CHECK(batch.copyBufferRegions[0].dstOffset == 0);
+    CHECK(batch.copyBufferRegions[0].size == 4096);
+  }
+  uploader.cancelAppended();
+
+  uploader.deinit();
+}
+
+}  // namespace
+
+int main()
+{
+  testAtomicLinearAllocator();
+  testParallelAppend();
+  return test_check::result();
+}
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the Radiance RGBE decoder of nvutils/rgbe_decode.hpp:
+
+* decodeRgbe() to RGBA32F is bit-exact with stbi_loadf_from_memory(), for
+  run-length encoded and flat files, widths below 8 and from 32768 on
+  (which can only be flat), widths that aren't a multiple of 4, and all
+  exponents, including those that give denormal floats. To RGBA16F, it is
+  toHalf() of that. It doesn't depend on the number of threads,
+  and `rowFn` sees and can change every row.
+* parseRgbe() rejects files that aren't Radiance files, bad headers and
+  resolution lines, truncated files, invalid runs, and scanlines of the
+  wrong width; decodeRgbe() rejects invalid runs in the scanlines that
+  parseRgbe() found, and destinations that are too small.
+* halfToFloat() is bit-exact with glm::unpackHalf1x16() on all halves, and
+  floatToHalf() with toHalf(): glm::packHalf1x16(), except that values
+  halfway between two halves round to the even one, as hardware conversions
+  do, instead of up. That covers every half, the values halfway between them
+  and next to those, subnormals, infinities and NaNs, on the SIMD and the
+  scalar path.
+
+-----------------------------------------------------------------------------*/
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+
+#include "nvutils/rgbe_decode.hpp"
+
+// Use static definitions to avoid conflicts with other libraries' copies of
+// stb_image.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "test_check.hpp"
+
+namespace {
+
+// glm::packHalf1x16(), but rounding halfway cases to even
+uint16_t toHalf(float value)
+{
+  const uint16_t half      = glm::packHalf1x16(value);
+  const uint16_t magnitude = half & 0x7FFF;
+  if((magnitude & 1) == 0 || magnitude >= 0x7C00)
+  {
+    return half;
+  }
+  const double above = glm::unpackHalf1x16(magnitude);
+  const double below = glm::unpackHalf1x16(uint16_t(magnitude - 1));
+  const double target = std::abs(double(value));
+  return target - below == above - target ? uint16_t(half - 1) : half;
+}
+
+// RGBE bytes of `width` x `height` texels: noise over all exponents, with
+// rows that start with runs of the same texel, so that run-length encoding
+// has both runs and literals to store
+std::vector<uint8_t> makeTexels(uint32_t width, uint32_t height)
+{
+  std::vector<uint8_t> texels(size_t(width) * height * 4);
+  uint32_t             rng = 1234;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      uint8_t* texel = &texels[(size_t(y) * width + x) * 4];
+      if(x > 0 && x < (y * 7) % 40)
+      {
+        memcpy(texel, texel - 4, 4);
+        continue;
+      }
+      for(uint32_t c = 0; c < 4; c++)
+      {
+        rng      = rng * 1664525u + 1013904223u;
+        texel[c] = uint8_t(rng >> 24);
+      }
+      // Keep the first texel from looking like a run-length header
+      if(x == 0)
+      {
+        texel[0] |= 0x80;
+      }
+    }
+  }
+  return texels;
+}
+
+std::vector<char> makeHeader(uint32_t width, uint32_t height)
+{
+  const std::string header = "#?RADIANCE\n# made by rgbe_decode_test\nFORMAT=32-bit_rle_rgbe\n\n-Y "
+                             + std::to_string(height) + " +X " + std::to_string(width) + "\n";
+  return std::vector<char>(header.begin(), header.end());
+}
+
+// A file with uncompressed scanlines
+std::vector<char> encodeFlat(const std::vector<uint8_t>& texels, uint32_t width, uint32_t height)
+{
+  std::vector<char> file = makeHeader(width, height);
+  file.insert(file.end(), texels.begin(), texels.end());
+  return file;
+}
+
+// A file with the run-length encoding of newer Radiance versions: each
+// channel of a scanline in turn, as runs of 3 to 127 equal bytes and
+// literals of up to 128 bytes
+std::vector<char> encodeRunLengths(const std::vector<uint8_t>& texels, uint32_t width, uint32_t height)
+{
+  std::vector<char> file = makeHeader(width, height);
+  std::vector<char> literal;
+  auto              flushLiteral = [&]() {
+    if(!literal.empty())
+    {
+      file.push_back(char(literal.size()));
+      file.insert(file.end(), literal.begin(), literal.end());
+      literal.clear();
+    }
+  };
+  for(uint32_t y = 0; y < height; y++)
+  {
+    file.insert(file.end(), {char(2), char(2), char(width >> 8), char(width & 0xFF)});
+    for(uint32_t c = 0; c < 4; c++)
+    {
+      auto value = [&](uint32_t x) { return texels[(size_t(y) * width + x) * 4 + c]; };
+      for(uint32_t x = 0; x < width;)
+      {
+        uint32_t run = 1;
+        while(x + run < width && run < 127 && value(x + run) == value(x))
+        {
+          run++;
+        }
+        if(run >= 3)
+        {
+          flushLiteral();
+          file.push_back(char(128 + run));
+          file.push_back(char(value(x)));
+          x += run;
+        }
+        else
+        {
+          literal.push_back(char(value(x)));
+          x++;
+          if(literal.size() == 128)
+          {
+            flushLiteral();
+          }
+        }
+      }
+      flushLiteral();
+    }
+  }
+  return file;
+}
+
+// Decodes `file` with stb_image, as RGBA32F
+std::vector<float> decodeWithStb(const std::vector<char>& file)
+{
+  int    width = 0, height = 0, channels = 0;
+  float* rgba = stbi_loadf_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), int(file.size()), &width,
+                                       &height, &channels, 4);
+  if(rgba == nullptr)
+  {
+    return {};
+  }
+  std::vector<float> result(rgba, rgba + size_t(width) * height * 4);
+  stbi_image_free(rgba);
+  return result;
+}
+
+void checkDecode(const std::vector<char>& file, uint32_t width, uint32_t height, bool runLengthEncoded)
+{
+  nvutils::RgbeImage image;
+  if(!CHECK(!nvutils::parseRgbe(file, image)))
+  {
+    return;
+  }
+  CHECK(image.width == width && image.height == height && image.runLengthEncoded == runLengthEncoded);
+
+  const std::vector<float> expected = decodeWithStb(file);
+  if(!CHECK(expected.size() == size_t(width) * height * 4))
+  {
+    return;
+  }
+
+  std::vector<char> rgba32(nvutils::rgbeDecodedSizeBytes(nvutils::RgbeTarget::eRGBA32F, width, height));
+  CHECK(!nvutils::decodeRgbe(file, image, nvutils::RgbeTarget::eRGBA32F, rgba32));
+  CHECK(memcmp(rgba32.data(), expected.data(), rgba32.size()) == 0);
+
+  std::vector<char> serial(rgba32.size());
+  CHECK(!nvutils::decodeRgbe(file, image, nvutils::RgbeTarget::eRGBA32F, serial, {}, 1));
+  CHECK(serial == rgba32);
+
+  std::vector<uint16_t> expectedHalves(expected.size());
+  for(size_t i = 0; i < expected.size(); i++)
+  {
+    expectedHalves[i] = toHalf(expected[i]);
+  }
+  std::vector<char> rgba16(nvutils::rgbeDecodedSizeBytes(nvutils::RgbeTarget::eRGBA16F, width, height));
+  CHECK(!nvutils::decodeRgbe(file, image, nvutils::RgbeTarget::eRGBA16F, rgba16));
+  CHECK(memcmp(rgba16.data(), expectedHalves.data(), rgba16.size()) == 0);
+
+  // rowFn sees each row once, rounded to halves, and its changes are kept;
+  // on one thread, since it checks rows in shared state
+  std::vector<uint32_t> rowCalls(height, 0);
+  bool                  rowsMatch = true;
+  auto                  rowFn     = [&](uint32_t y, float* row) {
+    rowCalls[y]++;
+    for(uint32_t i = 0; i < width * 4; i++)
+    {
+      rowsMatch = rowsMatch && row[i] == glm::unpackHalf1x16(expectedHalves[size_t(y) * width * 4 + i]);
+    }
+    row[3] = 0.5f;
+  };
+  CHECK(!nvutils::decodeRgbe(file, image, nvutils::RgbeTarget::eRGBA16F, rgba16, rowFn, 1));
+  CHECK(rowsMatch && rowCalls == std::vector<uint32_t>(height, 1));
+  bool alphaChanged = true;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    uint16_t alpha;
+    memcpy(&alpha, rgba16.data() + (size_t(y) * width * 4 + 3) * sizeof(uint16_t), sizeof(alpha));
+    alphaChanged = alphaChanged && alpha == toHalf(0.5f);
+  }
+  CHECK(alphaChanged);
+}
+
+void testDecode()
+{
+  for(const auto& [width, height] : std::array<std::array<uint32_t, 2>, 4>{{{8, 3}, {61, 7}, {256, 16}, {1000, 5}}})
+  {
+    const std::vector<uint8_t> texels = makeTexels(width, height);
+    checkDecode(encodeRunLengths(texels, width, height), width, height, true);
+    checkDecode(encodeFlat(texels, width, height), width, height, false);
+  }
+
+  // Too narrow or too wide for run-length encoding
+  for(const auto& [width, height] : std::array<std::array<uint32_t, 2>, 4>{{{1, 1}, {5, 9}, {7, 4}, {32769, 2}}})
+  {
+    checkDecode(encodeFlat(makeTexels(width, height), width, height), width, height, false);
+  }
+
+  // All exponents, including 0 (black) and 1 to 9 (denormal floats), in
+  // each position of a SIMD group
+  std::vector<uint8_t> exponents(256 * 4 * 4);
+  for(uint32_t i = 0; i < 256 * 4; i++)
+  {
+    const uint8_t exponent = uint8_t(i / 4);
+    const uint8_t texel[4] = {uint8_t(255 - i % 256), uint8_t(i % 7 * 37), uint8_t(i % 4 == 0 ? 1 : 128), exponent};
+    memcpy(&exponents[i * 4], texel, 4);
+  }
+  exponents[0] |= 0x80;
+  checkDecode(encodeRunLengths(exponents, 64, 16), 64, 16, true);
+  checkDecode(encodeFlat(exponents, 64, 16), 64, 16, false);
+}
+
+// Returns the error of parseRgbe() for `file`, or an empty string if it
+// succeeded
+std::string parseError(const std::vector<char>& file)
+{
+  nvutils::RgbeImage image;
+  return nvutils::parseRgbe(file, image).value_or("");
+}
+
+std::vector<char> toFile(const std::string& text)
+{
+  return std::vector<char>(text.begin(), text.end());
+}
+
+void testErrors()
+{
+  const uint32_t             width = 61, height = 7;
+  const std::vector<uint8_t> texels  = makeTexels(width, height);
+  const std::vector<char>    rle     = encodeRunLengths(texels, width, height);
+  const std::vector<char>    flat    = encodeFlat(texels, width, height);
+  const size_t               dataPos = makeHeader(width, height).size();
+  CHECK(parseError(rle).empty() && parseError(flat).empty());
+
+  // Headers and resolution lines
+  CHECK(!nvutils::isRgbe(toFile("P6\n")) && !parseError(toFile("P6\n")).empty());
+  CHECK(parseError(toFile("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n")) == "The header was not terminated.");
+  CHECK(parseError(toFile("#?RADIANCE\nFORMAT=32-bit_rle_xyze\n\n-Y 1 +X 1\n0000")).find("FORMAT") != std::string::npos);
+  CHECK(parseError(toFile("#?RGBE\nFORMAT=32-bit_rle_rgbe\n\n+Y 1 +X 1\n0000")).find("resolution") != std::string::npos);
+  CHECK(parseError(toFile("#?RGBE\nFORMAT=32-bit_rle_rgbe\n\n-Y 1 +X 1")) == "The resolution line is missing.");
+  CHECK(parseError(toFile("#?RGBE\nFORMAT=32-bit_rle_rgbe\n\n-Y 0 +X 1\n")).find("size") != std::string::npos);
+  CHECK(parseError(toFile("#?RGBE\nFORMAT=32-bit_rle_rgbe\n\n-Y 1 +X 1\n0000")).empty());
+
+  // Truncated files
+  for(size_t removed : {size_t(1), size_t(100), rle.size() - dataPos})
+  {
+    const std::vector<char> truncatedFlat(flat.begin(), flat.end() - removed);
+    CHECK(parseError(truncatedFlat).find("too small") != std::string::npos);
+    const std::vector<char> truncatedRle(rle.begin(), rle.end() - removed);
+    CHECK(!parseError(truncatedRle).empty());
+  }
+
+  // The first count of the first scanline is a run or a literal; a count of 0,
+  // or one past the end of the scanline, is invalid
+  std::vector<char> invalid = rle;
+  invalid[dataPos + 4]      = char(0);
+  CHECK(parseError(invalid) == "Scanline 0 has an invalid run.");
+  invalid[dataPos + 4] = char(128 + width + 1);
+  CHECK(parseError(invalid) == "Scanline 0 has an invalid run.");
+  invalid[dataPos + 4] = char(width + 1);
+  CHECK(parseError(invalid) == "Scanline 0 has an invalid run.");
+
+  // Scanlines of the wrong width
+  std::vector<char> wrongWidth = rle;
+  wrongWidth[dataPos + 3]      = char(width - 1);
+  CHECK(parseError(wrongWidth) == "Scanline 0 is not run-length encoded, or has the wrong length.");
+
+  // Invalid runs in scanlines that parsed: decode a changed copy of the file
+  // with the scanlines found in the original
+  nvutils::RgbeImage image;
+  CHECK(!nvutils::parseRgbe(rle, image));
+  std::vector<char> changed = rle;
+  changed[dataPos + 4]      = char(0);
+  std::vector<char> rgba(nvutils::rgbeDecodedSizeBytes(nvutils::RgbeTarget::eRGBA32F, width, height));
+  CHECK(nvutils::decodeRgbe(changed, image, nvutils::RgbeTarget::eRGBA32F, rgba) == "Scanline 0 has invalid run lengths.");
+  changed = rle;
+  changed[image.scanlineOffsets[height - 1] + 4] = char(128);  // Literal longer than what's left of the scanline
+  CHECK(nvutils::decodeRgbe(changed, image, nvutils::RgbeTarget::eRGBA32F, rgba) == "Scanline 6 has invalid run lengths.");
+
+  // Destinations that are too small, and images of another file
+  std::vector<char> small(rgba.size() - 1);
+  CHECK(nvutils::decodeRgbe(rle, image, nvutils::RgbeTarget::eRGBA32F, small).has_value());
+  const std::vector<char> shorter(rle.begin(), rle.end() - 1);
+  CHECK(nvutils::decodeRgbe(shorter, image, nvutils::RgbeTarget::eRGBA32F, rgba).has_value());
+}
+
+uint32_t floatBits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bitsToFloat(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+bool isHalfNan(uint16_t half)
+{
+  return (half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0;
+}
+
+void testHalves()
+{
+  // All halves to floats
+  std::vector<uint16_t> halves(65536);
+  for(uint32_t i = 0; i < 65536; i++)
+  {
+    halves[i] = uint16_t(i);
+  }
+  std::vector<float> floats(halves.size());
+  nvutils::halfToFloat(halves.data(), halves.size(), floats.data());
+  bool halvesMatch = true;
+  for(uint32_t i = 0; i < 65536; i++)
+  {
+    const float expected = glm::unpackHalf1x16(halves[i]);
+    halvesMatch          = halvesMatch
+                  && (std::isnan(expected) ? std::isnan(floats[i]) && std::signbit(floats[i]) == std::signbit(expected) :
+                                             floatBits(floats[i]) == floatBits(expected));
+  }
+  CHECK(halvesMatch);
+
+  // Floats to halves: each half, each value halfway to the next one, and
+  // each value just off it, positive and negative; then zeros, float
+  // subnormals, values that overflow, infinities and NaNs
+  std::vector<float> values;
+  for(uint32_t i = 0; i < 0x7C00; i++)
+  {
+    const float value = glm::unpackHalf1x16(uint16_t(i));
+    const float next  = glm::unpackHalf1x16(uint16_t(i + 1));
+    const float half  = (value + next) * 0.5f;
+    for(float v : {value, half, std::nextafter(half, 0.0f), std::nextafter(half, next)})
+    {
+      values.push_back(v);
+      values.push_back(-v);
+    }
+  }
+  for(float v : {0.0f, -0.0f, bitsToFloat(1), bitsToFloat(0x007FFFFF), std::numeric_limits<float>::min(), 65504.0f,
+                 65519.99f, 65520.0f, 1e10f, std::numeric_limits<float>::max(), std::numeric_limits<float>::infinity(),
+                 -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(),
+                 -std::numeric_limits<float>::quiet_NaN(), bitsToFloat(0x7F800001), bitsToFloat(0x7FC00123)})
+  {
+    values.push_back(v);
+  }
+  values.push_back(1.0f);  // Leaves 1 to 3 values for the scalar path
+  std::vector<uint16_t> converted(values.size());
+  nvutils::floatToHalf(values.data(), values.size(), converted.data());
+  // One value at a time, everything takes the scalar path
+  std::vector<uint16_t> scalar(values.size());
+  for(size_t i = 0; i < values.size(); i++)
+  {
+    nvutils::floatToHalf(&values[i], 1, &scalar[i]);
+  }
+  bool valuesMatch = true;
+  for(size_t i = 0; i < values.size(); i++)
+  {
+    const uint16_t expected = toHalf(values[i]);
+    for(uint16_t half : {converted[i], scalar[i]})
+    {
+      valuesMatch = valuesMatch
+                    && (isHalfNan(expected) ? isHalfNan(half) && (half & 0x8000) == (expected & 0x8000) : half == expected);
+    }
+  }
+  CHECK(values.size() % 4 != 0 && valuesMatch);
+}
+
+}  // namespace
+
+int main()
+{
+  testDecode();
+  testErrors();
+  testHalves();
+  return test_check::result();
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::RingAllocator: alignment (including alignments that aren't
+powers of two), wrapping around the end of the ring, failure when the ring is
+full, release by fence, and the allocated and used sizes. A randomized run
+simulates frames in flight and checks that live allocations never overlap,
+stay inside the ring, and that an empty ring always has room.
+
+-----------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <deque>
+
+#include "nvutils/ring_allocator.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+using nvutils::RingAllocator;
+constexpr uint64_t kInvalid = RingAllocator::INVALID_OFFSET;
+
+struct Allocation
+{
+  uint64_t offset = 0;
+  uint64_t size   = 0;
+  uint64_t fence  = 0;
+};
+
+bool overlap(const Allocation& a, const Allocation& b)
+{
+  return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+void randomizedRun(uint64_t capacity, uint64_t alignment, uint32_t seed)
+{
+  RingAllocator          ring(capacity);
+  std::deque<Allocation> live;
+  uint32_t               rng  = seed;
+  auto                   next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+
+  const uint64_t inFlight = 1 + next() % 3;
+  for(uint64_t frame = 1; frame <= 500; frame++)
+  {
+    // Frames older than `inFlight` are done
+    if(frame > inFlight)
+    {
+      ring.release(frame - inFlight);
+      while(!live.empty() && live.front().fence <= frame - inFlight)
+      {
+        live.pop_front();
+      }
+    }
+
+    const uint32_t count = next() % 6;
+    for(uint32_t i = 0; i < count; i++)
+    {
+      const uint64_t size     = 1 + next() % (capacity / 3);
+      const bool     wasEmpty = ring.isEmpty();
+      const uint64_t offset   = ring.allocate(size, alignment, frame);
+      if(offset == kInvalid)
+      {
+        CHECK(!wasEmpty);
+        continue;
+      }
+      const Allocation allocation{offset, size, frame};
+      CHECK(offset % alignment == 0);
+      CHECK(offset + size <= capacity);
+      for(const Allocation& other : live)
+      {
+        CHECK(!overlap(allocation, other));
+      }
+      live.push_back(allocation);
+    }
+
+    uint64_t allocatedSize = 0;
+    for(const Allocation& allocation : live)
+    {
+      allocatedSize += allocation.size;
+    }
+    CHECK(ring.getAllocatedSize() == allocatedSize);
+    CHECK(ring.getUsedSize() >= allocatedSize && ring.getUsedSize() <= capacity);
+    CHECK(ring.isEmpty() == live.empty());
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  // Sequential allocations, alignment, and merging of a fence's allocations.
+  {
+    RingAllocator ring(1000);
+    CHECK(ring.getCapacity() == 1000);
+    CHECK(ring.isEmpty());
+    CHECK(ring.getUsedSize() == 0);
+    CHECK(ring.allocate(10, 48, 1) == 0);
+    CHECK(ring.allocate(10, 48, 1) == 48);
+    CHECK(ring.allocate(5, 1, 2) == 58);
+    CHECK(ring.allocate(7, 3, 2) == 63);
+    CHECK(ring.getAllocatedSize() == 32);
+    CHECK(ring.getUsedSize() == 70);
+
+    ring.release(1);
+    CHECK(ring.getAllocatedSize() == 12);
+    CHECK(ring.getUsedSize() == 70 - 58);
+    ring.release(2);
+    CHECK(ring.isEmpty());
+    CHECK(ring.getUsedSize() == 0);
+    // An empty ring starts over at 0
+    CHECK(ring.allocate(1, 16, 3) == 0);
+  }
+
+  // Invalid sizes.
+  {
+    RingAllocator ring(100);
+    CHECK(ring.allocate(0, 4, 1) == kInvalid);
+    CHECK(ring.allocate(101, 4, 1) == kInvalid);
+    CHECK(ring.isEmpty());
+    CHECK(ring.allocate(100, 4, 1) == 0);
+    CHECK(ring.allocate(1, 1, 1) == kInvalid);
+  }
+
+  // Wrapping around, and a full ring.
+  {
+    RingAllocator ring(100);
+    CHECK(ring.allocate(40, 4, 1) == 0);
+    CHECK(ring.allocate(40, 4, 2) == 40);
+    CHECK(ring.allocate(30, 4, 3) == kInvalid);  // Neither after 80, nor before 0
+    CHECK(ring.allocate(20, 4, 3) == 80);        // Exactly up to the end
+    CHECK(ring.getUsedSize() == 100);
+    CHECK(ring.allocate(1, 1, 3) == kInvalid);
+
+    ring.release(1);
+    CHECK(ring.getUsedSize() == 60);
+    CHECK(ring.allocate(41, 4, 4) == kInvalid);  // Larger than the free 40 bytes at 0
+    CHECK(ring.allocate(30, 4, 4) == 0);         // Wraps
+    CHECK(ring.allocate(12, 4, 4) == kInvalid);  // 32 + 12 > 40
+    CHECK(ring.allocate(8, 4, 4) == 32);         // Ends at the oldest allocation
+    CHECK(ring.getAllocatedSize() == 40 + 20 + 30 + 8);
+    CHECK(ring.getUsedSize() == 100);
+
+    ring.release(3);
+    CHECK(ring.getAllocatedSize() == 38);
+    CHECK(ring.getUsedSize() == 40);
+    // The space from 40 to the end is free again
+    CHECK(ring.allocate(60, 4, 5) == 40);
+    ring.releaseAll();
+    CHECK(ring.isEmpty());
+    CHECK(ring.getAllocatedSize() == 0);
+    CHECK(ring.allocate(100, 4, 6) == 0);
+  }
+
+  // Wrapping skips the space at the end, which is counted as used.
+  {
+    RingAllocator ring(100);
+    CHECK(ring.allocate(50, 1, 1) == 0);
+    CHECK(ring.allocate(45, 1, 2) == 50);
+    ring.release(1);
+    CHECK(ring.allocate(10, 1, 3) == 0);
+    CHECK(ring.getAllocatedSize() == 55);
+    CHECK(ring.getUsedSize() == 100 - 50 + 10);
+  }
+
+  // deinit() releases everything.
+  {
+    RingAllocator ring(64);
+    ring.allocate(10, 1, 1);
+    ring.deinit();
+    CHECK(ring.isEmpty());
+    CHECK(ring.getCapacity() == 0);
+    ring.init(32);
+    CHECK(ring.allocate(32, 1, 1) == 0);
+  }
+
+  for(uint32_t seed = 1; seed <= 40; seed++)
+  {
+    const uint64_t alignments[] = {1, 4, 16, 48, 256};
+    randomizedRun(1000 + seed * 37, alignments[seed % 5], seed);
+  }
+
+  return test_check::result();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nvutils::sha256() against the FIPS 180-4 example messages, and that
+hashing data in pieces of any size gives the same digest as hashing it at
+once.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "nvutils/sha256.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+std::string toHex(const nvutils::Sha256Digest& digest)
+{
+  static const char* kDigits = "0123456789abcdef";
+  std::string        result;
+  for(uint8_t byte : digest)
+  {
+    result += kDigits[byte >> 4];
+    result += kDigits[byte & 15];
+  }
+  return result;
+}
+
+nvutils::Sha256Digest sha256(std::string_view text)
+{
+  return nvutils::sha256(std::as_bytes(std::span(text.data(), text.size())));
+}
+
+}  // namespace
+
+int main()
+{
+  CHECK(toHex(sha256("")) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  CHECK(toHex(sha256("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // 56 bytes: the length doesn't fit in the first padded block.
+  CHECK(toHex(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"))
+        == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  const std::string million(1000000, 'a');
+  CHECK(toHex(sha256(million)) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+  // Pieces that start and end in the middle of blocks.
+  for(size_t pieceSize : {1, 7, 63, 64, 65, 1000})
+  {
+    nvutils::Sha256 sha;
+    for(size_t offset = 0; offset < million.size(); offset += pieceSize)
+    {
+      const size_t count = std::min(pieceSize, million.size() - offset);
+      sha.update(std::as_bytes(std::span(million.data() + offset, count)));
+    }
+    CHECK(sha.finish() == sha256(million));
+  }
+  return test_check::result();
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the concurrent mode of nvvk::BufferSubAllocator, with blocks backed by
+host memory (see HostBufferSubAllocator), so that no device is needed:
+
+* Sub-allocations from the per-thread caches, the locked path for larger
+  sizes, and dedicated blocks have the requested size and alignment and lie
+  within their block. Running into maxAllocatedSize returns
+  VK_ERROR_OUT_OF_DEVICE_MEMORY, and flushConcurrentCaches() returns every
+  cached sub-allocation and deferred free to the blocks.
+* A stress test: 8 threads sub-allocate and free mixed sizes and alignments,
+  pass some sub-allocations to the next thread to free, and use the locked
+  subAllocate() / subFree() in between. Each sub-allocation is filled with a
+  tag that is verified when it is freed, which catches overlapping ones.
+  Afterwards, all memory is returned and every block is destroyed.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "nvvk/buffer_suballocator.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+constexpr uint32_t     kThreads   = 8;
+constexpr VkDeviceSize kBlockSize = 256 * 1024;
+
+// Creates the blocks in host memory rather than with the ResourceAllocator,
+// and keeps track of them.
+class HostBufferSubAllocator : public nvvk::BufferSubAllocator
+{
+public:
+  size_t liveBlockCount() const
+  {
+    std::lock_guard<std::mutex> lock(m_hostMutex);
+    return m_hostBlocks.size();
+  }
+
+  // Whether `range` lies within one of the blocks, and its mapping and
+  // address match its offset.
+  bool isWithinBlock(const nvvk::BufferRange& range) const
+  {
+    std::lock_guard<std::mutex> lock(m_hostMutex);
+    auto it = m_hostBlocks.find(range.buffer);
+    if(it == m_hostBlocks.end())
+    {
+      return false;
+    }
+    const nvvk::Buffer& buffer = it->second.buffer;
+    return range.offset + range.range <= buffer.bufferSize && range.mapping == buffer.mapping + range.offset
+           && range.address == buffer.address + range.offset;
+  }
+
+protected:
+  VkResult createNewBuffer(nvvk::Buffer& buffer, VkDeviceSize size, uint32_t /*alignment*/, uint32_t /*blockIndex*/) override
+  {
+    std::lock_guard<std::mutex> lock(m_hostMutex);
+    m_nextId++;
+    HostBlock block;
+    block.memory            = std::make_unique<uint8_t[]>(size);
+    block.buffer.buffer     = reinterpret_cast<VkBuffer>(m_nextId * 0x1000);
+    block.buffer.bufferSize = size;
+    block.buffer.address    = VkDeviceAddress(m_nextId) << 40;
+    block.buffer.mapping    = block.memory.get();
+    buffer                  = block.buffer;
+    m_hostBlocks.emplace(buffer.buffer, std::move(block));
+    return VK_SUCCESS;
+  }
+
+  void destroyBlockBuffer(nvvk::Buffer& buffer) override
+  {
+    std::lock_guard<std::mutex> lock(m_hostMutex);
+    if(buffer.buffer)
+    {
+      CHECK(m_hostBlocks.erase(buffer.buffer) == 1);
+    }
+    buffer = {};
+  }
+
+  VkDeviceSize getMaxBufferSize() const override { return VkDeviceSize(4) << 30; }
+
+private:
+  struct HostBlock
+  {
+    std::unique_ptr<uint8_t[]> memory;
+    nvvk::Buffer               buffer;
+  };
+
+  mutable std::mutex              m_hostMutex;
+  std::map<VkBuffer, HostBlock>   m_hostBlocks;
+  uintptr_t                       m_nextId = 0;
+};
+
+bool isValidRange(const HostBufferSubAllocator& allocator, const nvvk::BufferRange& range, VkDeviceSize size, uint32_t alignment)
+{
+  return range.range == size && range.offset % alignment == 0 && allocator.isWithinBlock(range);
+}
+
+// The ResourceAllocator is only needed as a non-null pointer, as
+// HostBufferSubAllocator doesn't use it.
+nvvk::BufferSubAllocator::InitInfo makeInitInfo(nvvk::ResourceAllocator& resourceAllocator)
+{
+  nvvk::BufferSubAllocator::InitInfo info;
+  info.resourceAllocator       = &resourceAllocator;
+  info.debugName               = "test";
+  info.blockSize               = kBlockSize;
+  info.concurrentThreads       = kThreads;
+  info.concurrentMaxCachedSize = 4096;
+  info.concurrentBatchSize     = 8;
+  return info;
+}
+
+// Fills a sub-allocation with its tag, or checks that it still holds it
+void writeTag(const nvvk::BufferRange& range, uint32_t tag)
+{
+  for(VkDeviceSize i = 0; i + sizeof(tag) <= range.range; i += sizeof(tag))
+  {
+    memcpy(range.mapping + i, &tag, sizeof(tag));
+  }
+}
+
+bool hasTag(const nvvk::BufferRange& range, uint32_t tag)
+{
+  for(VkDeviceSize i = 0; i + sizeof(tag) <= range.range; i += sizeof(tag))
+  {
+    uint32_t value;
+    memcpy(&value, range.mapping + i, sizeof(value));
+    if(value != tag)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void testDirected()
+{
+  nvvk::ResourceAllocator resourceAllocator;
+
+  HostBufferSubAllocator allocator;
+  nvvk::BufferSubAllocator::InitInfo info = makeInitInfo(resourceAllocator);
+  info.keepLastBlock                      = false;
+  info.maxAllocatedSize                   = kBlockSize * 4;
+  CHECK(allocator.init(info) == VK_SUCCESS);
+  CHECK(allocator.liveBlockCount() == 0);
+
+  // Cached: the refill reserves a batch of the size class
+  nvvk::BufferSubAllocation small;
+  CHECK(allocator.subAllocateConcurrent(0, small, 100, 16) == VK_SUCCESS);
+  CHECK(isValidRange(allocator, allocator.subRange(small), 100, 16));
+  CHECK(allocator.getReport().requestedSize == 8 * 128);
+  CHECK(allocator.liveBlockCount() == 1);
+
+  // Non-power-of-two alignment
+  nvvk::BufferSubAllocation odd;
+  CHECK(allocator.subAllocateConcurrent(1, odd, 200, 48) == VK_SUCCESS);
+  CHECK(isValidRange(allocator, allocator.subRange(odd), 200, 48));
+
+  // Larger than the cached sizes, and larger than a block
+  nvvk::BufferSubAllocation large, dedicated;
+  CHECK(allocator.subAllocateConcurrent(0, large, 10000, 256) == VK_SUCCESS);
+  CHECK(isValidRange(allocator, allocator.subRange(large), 10000, 256));
+  CHECK(allocator.subAllocateConcurrent(0, dedicated, kBlockSize + 4, 16) == VK_SUCCESS);
+  CHECK(isValidRange(allocator, allocator.subRange(dedicated), kBlockSize + 4, 16));
+  CHECK(allocator.subRange(dedicated).buffer != allocator.subRange(small).buffer);
+
+  // The sub-allocations don't overlap
+  writeTag(allocator.subRange(small), 1);
+  writeTag(allocator.subRange(odd), 2);
+  writeTag(allocator.subRange(large), 3);
+  writeTag(allocator.subRange(dedicated), 4);
+  CHECK(hasTag(allocator.subRange(small), 1));
+  CHECK(hasTag(allocator.subRange(odd), 2));
+  CHECK(hasTag(allocator.subRange(large), 3));
+  CHECK(hasTag(allocator.subRange(dedicated), 4));
+
+  // Free on other threads than the allocating ones; `large` is deferred
+  allocator.subFreeConcurrent(1, small);
+  allocator.subFreeConcurrent(0, odd);
+  allocator.subFreeConcurrent(1, large);
+  allocator.subFreeConcurrent(1, dedicated);
+  CHECK(!small && !odd && !large && !dedicated);
+  allocator.subFreeConcurrent(0, small);  // Unset ones are fine
+
+  // The freed `small` is reused by the thread that freed it
+  nvvk::BufferSubAllocation reused;
+  CHECK(allocator.subAllocateConcurrent(1, reused, 120, 16) == VK_SUCCESS);
+  CHECK(isValidRange(allocator, allocator.subRange(reused), 120, 16));
+  allocator.subFreeConcurrent(1, reused);
+
+  allocator.flushConcurrentCaches();
+  nvvk::BufferSubAllocator::Report report = allocator.getReport();
+  CHECK(report.requestedSize == 0);
+  CHECK(report.reservedSize == 0);
+  CHECK(allocator.liveBlockCount() == 0);
+
+  // maxAllocatedSize holds 4 blocks of 64 sub-allocations of size class 4096
+  std::vector<nvvk::BufferSubAllocation> all;
+  VkResult                               result = VK_SUCCESS;
+  while(result == VK_SUCCESS && all.size() < 1000)
+  {
+    all.emplace_back();
+    result = allocator.subAllocateConcurrent(0, all.back(), 4000, 16);
+  }
+  CHECK(result == VK_ERROR_OUT_OF_DEVICE_MEMORY);
+  CHECK(!all.back());
+  CHECK(all.size() == 4 * 64 + 1);
+  CHECK(allocator.liveBlockCount() == 4);
+  for(size_t i = 0; i < all.size(); i++)
+  {
+    allocator.subFreeConcurrent(uint32_t(i % kThreads), all[i]);
+  }
+  allocator.flushConcurrentCaches();
+  CHECK(allocator.getReport().requestedSize == 0);
+  CHECK(allocator.liveBlockCount() == 0);
+
+  allocator.deinit();
+}
+
+// Sub-allocations handed to another thread to free
+struct Mailbox
+{
+  std::mutex                                                mutex;
+  std::deque<std::pair<nvvk::BufferSubAllocation, uint32_t>> items;
+};
+
+void testStress()
+{
+  nvvk::ResourceAllocator resourceAllocator;
+
+  HostBufferSubAllocator allocator;
+  nvvk::BufferSubAllocator::InitInfo info = makeInitInfo(resourceAllocator);
+  info.keepLastBlock                      = false;
+  CHECK(allocator.init(info) == VK_SUCCESS);
+
+  constexpr uint32_t kOps    = 20000;
+  constexpr uint32_t kWindow = 64;
+  const uint32_t     alignments[] = {4, 16, 48, 256};
+
+  Mailbox                  mailboxes[kThreads];
+  std::vector<std::thread> threads;
+  std::vector<uint32_t>    failures(kThreads, 0);
+  for(uint32_t t = 0; t < kThreads; t++)
+  {
+    threads.emplace_back([&, t]() {
+      struct Live
+      {
+        nvvk::BufferSubAllocation subAllocation;
+        uint32_t                  tag    = 0;
+        bool                      locked = false;
+      };
+      std::deque<Live> live;
+      uint32_t         rng  = 1 + t;
+      auto             next = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return rng >> 8;
+      };
+      auto release = [&](Live& item) {
+        failures[t] += hasTag(allocator.subRange(item.subAllocation), item.tag) ? 0 : 1;
+        if(item.locked)
+        {
+          allocator.subFree(item.subAllocation);
+        }
+        else
+        {
+          allocator.subFreeConcurrent(t, item.subAllocation);
+        }
+      };
+
+      for(uint32_t op = 0; op < kOps; op++)
+      {
+        // Mostly small, log-uniform sizes; some beyond the caches
+        VkDeviceSize size = VkDeviceSize(4) << (next() % 10);
+        size += next() % size;
+        if(next() % 50 == 0)
+        {
+          size = 5000 + next() % 20000;
+        }
+        const uint32_t alignment = alignments[next() % 4];
+
+        Live item;
+        item.tag    = (t << 24) | op;
+        item.locked = (next() % 16 == 0);
+        const VkResult result = item.locked ? allocator.subAllocate(item.subAllocation, size, alignment) :
+                                              allocator.subAllocateConcurrent(t, item.subAllocation, size, alignment);
+        const nvvk::BufferRange range = allocator.subRange(item.subAllocation);
+        if(result != VK_SUCCESS || !isValidRange(allocator, range, size, alignment))
+        {
+          failures[t]++;
+          continue;
+        }
+        writeTag(range, item.tag);
+
+        if(!item.locked && next() % 8 == 0)
+        {
+          Mailbox&                    mailbox = mailboxes[(t + 1) % kThreads];
+          std::lock_guard<std::mutex> lock(mailbox.mutex);
+          mailbox.items.emplace_back(item.subAllocation, item.tag);
+        }
+        else
+        {
+          live.push_back(item);
+        }
+        if(live.size() > kWindow)
+        {
+          release(live.front());
+          live.pop_front();
+        }
+
+        // Free what the previous thread passed on
+        std::deque<std::pair<nvvk::BufferSubAllocation, uint32_t>> received;
+        {
+          std::lock_guard<std::mutex> lock(mailboxes[t].mutex);
+          received.swap(mailboxes[t].items);
+        }
+        for(auto& [subAllocation, tag] : received)
+        {
+          Live passed{subAllocation, tag, false};
+          release(passed);
+        }
+      }
+      for(Live& item : live)
+      {
+        release(item);
+      }
+    });
+  }
+  for(std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  for(uint32_t t = 0; t < kThreads; t++)
+  {
+    CHECK(failures[t] == 0);
+    for(auto& [subAllocation, tag] : mailboxes[t].items)
+    {
+      CHECK(hasTag(allocator.subRange(subAllocation), tag));
+      allocator.subFreeConcurrent(t, subAllocation);
+    }
+  }
+
+  allocator.flushConcurrentCaches();
+  nvvk::BufferSubAllocator::Report report = allocator.getReport();
+  CHECK(report.requestedSize == 0);
+  CHECK(report.reservedSize == 0);
+  CHECK(allocator.liveBlockCount() == 0);
+
+  allocator.deinit();
+}
+
+}  // namespace
+
+int main()
+{
+  testDirected();
+  testStress();
+  return test_check::result();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks for nvpro_core2's tests. Unlike assert(), CHECK() is evaluated in all
+build configurations, and a failed check prints its location and continues,
+so that one run reports every failure. Tests return test_check::result()
+from main(), which CTest uses to pass or fail them.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace test_check {
+
+inline std::atomic<uint32_t> g_failures{0};
+
+inline void fail(const char* file, int line, const char* condition)
+{
+  fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, condition);
+  g_failures++;
+}
+
+// Returns EXIT_SUCCESS if no check failed, and EXIT_FAILURE otherwise.
+inline int result()
+{
+  const uint32_t failures = g_failures.load();
+  if(failures != 0)
+  {
+    fprintf(stderr, "%u check(s) failed.\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("All checks passed.\n");
+  return EXIT_SUCCESS;
+}
+
+}  // namespace test_check
+
+// Evaluates `condition`, and records a failure if it's false. Returns the
+// value of `condition`, so that tests can skip checks that depend on it.
+#define CHECK(condition) ((condition) ? true : (test_check::fail(__FILE__, __LINE__, #condition), false))
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Known-answer vectors for texture_decode_test.cpp: compressed blocks and the
+texels another decoder gives for them, so that the test doesn't only compare
+texture_decode with the Basis Universal functions it wraps.
+
+The texels are Mesa 22.3's (llvmpipe): each list of blocks was uploaded as
+one row of blocks with glCompressedTexImage2D() and read back with
+glGetTexImage(), as RGBA8 for BC7 and ASTC, and as RGBA16F for BC6H. Mesa
+decodes BPTC with its own decoder, and ASTC LDR with its software fallback.
+The BC7 and BC6H UFLOAT texels also agree with Pillow 12's BCn decoder.
+
+* BC7: a block of each mode, 0 to 7, with random bits.
+* BC6H UFLOAT: a block of each of the modes 0x00, 0x02, 0x06, 0x0A, 0x0E,
+  0x12, 0x16 and 0x1A, with random bits.
+* BC6H SFLOAT: a block of each of the modes 0x01, 0x1E, 0x03, 0x07, 0x0B and
+  0x0F, and a block of the reserved mode 0x13, which decodes to 0.
+  BC6H texels are RGB only; alpha is 1.
+* ASTC: random blocks that are valid and not void-extent blocks, with 1 to 4
+  partitions for 4x4, 1 and 2 for 6x6 and 8x5 (sRGB), and 1 for 12x12.
+
+Texels are in image order, rows from the top.
+
+-----------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace known_answers {
+
+const uint8_t kBC7Blocks[] = {
+    0x23, 0xC4, 0xAE, 0xB9, 0xE6, 0x1A, 0x9C, 0xD7, 0x52, 0x00, 0x9D, 0xA1, 0x25, 0xBD, 0x79, 0xD3,
+    0x0E, 0x14, 0x5A, 0x3D, 0xCB, 0xE4, 0x0A, 0xDE, 0x42, 0x18, 0x28, 0x12, 0xF6, 0xF6, 0x27, 0x8F,
+    0x94, 0x3E, 0x33, 0x40, 0x0E, 0xB7, 0x3C, 0x2F, 0x7D, 0x13, 0xD8, 0x19, 0x56, 0x49, 0xB5, 0x59,
+    0x98, 0xCE, 0xBC, 0x43, 0xBE, 0x49, 0x3F, 0x25, 0x77, 0xB1, 0xB2, 0x72, 0x14, 0xF3, 0xD8, 0xE7,
+    0x10, 0x7C, 0x6F, 0xA3, 0x7C, 0x60, 0xA9, 0x79, 0xEE, 0xEA, 0x14, 0xFC, 0x3B, 0xCB, 0xB7, 0x18,
+    0xA0, 0x43, 0x84, 0x26, 0xD2, 0xEA, 0x64, 0xD2, 0x37, 0xFE, 0x88, 0x49, 0x66, 0x57, 0xB8, 0x80,
+    0xC0, 0x6E, 0xC9, 0x8D, 0x7E, 0x08, 0x85, 0x56, 0x92, 0x85, 0x94, 0x2D, 0x0A, 0xD8, 0x4F, 0xFB,
+    0x80, 0xA6, 0x71, 0x21, 0xC2, 0x20, 0x14, 0x3A, 0x78, 0x81, 0x89, 0x4D, 0xCB, 0x5C, 0xD0, 0x39,
+};
+
+const uint8_t kBC7Texels[] = {
+    0x17, 0x44, 0xBF, 0xFF, 0x1A, 0x3F, 0xBC, 0xFF, 0x12, 0x4D, 0xC4, 0xFF, 0x63, 0x73, 0x63, 0xFF,
+    0x67, 0x35, 0x63, 0xFF, 0x67, 0x35, 0x63, 0xFF, 0x7F, 0x3F, 0x4C, 0xFF, 0x46, 0x53, 0x15, 0xFF,
+    0xFF, 0x73, 0xDE, 0xFF, 0xCC, 0x6B, 0xA0, 0xFF, 0xCC, 0x6B, 0xA0, 0xFF, 0xCC, 0x6B, 0xA0, 0xFF,
+    0x83, 0x84, 0xB7, 0xFF, 0xA0, 0xBD, 0xB4, 0xFF, 0x67, 0x4D, 0xBB, 0xFF, 0xD3, 0xBD, 0xA9, 0xFF,
+    0xE7, 0xDE, 0x52, 0x1C, 0xE4, 0xA5, 0x88, 0x1C, 0xE4, 0xA5, 0x88, 0x04, 0xDE, 0x31, 0xF7, 0x4D,
+    0x60, 0xB7, 0x50, 0x2E, 0x37, 0xB7, 0x45, 0x28, 0x60, 0xD6, 0x50, 0x2E, 0x87, 0xB7, 0x5A, 0x34,
+    0xB3, 0xDB, 0x24, 0x87, 0x78, 0xD5, 0x5B, 0x9C, 0x95, 0xD8, 0x3F, 0x91, 0x7F, 0xD6, 0x54, 0x99,
+    0x34, 0x86, 0x45, 0x04, 0x37, 0x29, 0xA4, 0x97, 0x63, 0x40, 0x80, 0x64, 0x48, 0x5D, 0x41, 0x35,
+    0x1C, 0x3A, 0xBA, 0xFF, 0x1C, 0x3A, 0xBA, 0xFF, 0x71, 0xB1, 0x84, 0xFF, 0x71, 0xB1, 0x84, 0xFF,
+    0x50, 0x2C, 0x78, 0xFF, 0x96, 0x48, 0x37, 0xFF, 0x3F, 0x21, 0x17, 0xFF, 0x4A, 0x6E, 0x13, 0xFF,
+    0x10, 0xEC, 0xCC, 0xFF, 0x31, 0xF7, 0x84, 0xFF, 0x6B, 0x6A, 0x83, 0xFF, 0x6B, 0x6A, 0x83, 0xFF,
+    0x83, 0x84, 0xB7, 0xFF, 0xA0, 0xBD, 0xB4, 0xFF, 0xF8, 0xC8, 0xCA, 0xFF, 0xAB, 0xB1, 0x85, 0xFF,
+    0xE7, 0xDE, 0x52, 0x59, 0xDE, 0x31, 0xF7, 0x59, 0xDE, 0x31, 0xF7, 0x4D, 0xE7, 0xDE, 0x52, 0x10,
+    0x10, 0xF4, 0x3A, 0x22, 0x10, 0xB7, 0x3A, 0x22, 0x10, 0xB7, 0x3A, 0x22, 0x60, 0xB7, 0x50, 0x2E,
+    0x9C, 0xD9, 0x39, 0x8F, 0x78, 0xD5, 0x5B, 0x9C, 0x5A, 0xD2, 0x76, 0xA6, 0xAA, 0xDA, 0x2C, 0x8A,
+    0x63, 0x40, 0x80, 0x64, 0x71, 0x08, 0x38, 0x9A, 0x5D, 0x31, 0x3C, 0x69, 0x0C, 0x14, 0xC7, 0xC7,
+    0xD4, 0x43, 0x1A, 0xFF, 0xCE, 0xEF, 0x08, 0xFF, 0x78, 0xCF, 0x94, 0xFF, 0x71, 0xB1, 0x84, 0xFF,
+    0x72, 0x3A, 0x58, 0xFF, 0xA1, 0x4C, 0x2C, 0xFF, 0x3C, 0x08, 0x18, 0xFF, 0x51, 0xA0, 0x11, 0xFF,
+    0x21, 0xF2, 0xA7, 0xFF, 0x10, 0xEC, 0xCC, 0xFF, 0x6B, 0x6A, 0x83, 0xFF, 0x18, 0xEF, 0xC6, 0xFF,
+    0x86, 0xA6, 0x64, 0xFF, 0xD3, 0xBD, 0xA9, 0xFF, 0x83, 0x84, 0xB7, 0xFF, 0xBC, 0xF4, 0xB0, 0xFF,
+    0xDE, 0x31, 0xF7, 0x28, 0xE4, 0xA5, 0x88, 0x10, 0xDE, 0x31, 0xF7, 0x59, 0xE4, 0xA5, 0x88, 0x28,
+    0x87, 0x99, 0x5A, 0x34, 0x60, 0xD6, 0x50, 0x2E, 0x87, 0xF4, 0x5A, 0x34, 0x10, 0xD6, 0x3A, 0x22,
+    0x6F, 0xD4, 0x63, 0x9F, 0xBA, 0xDC, 0x1E, 0x84, 0x7F, 0xD6, 0x54, 0x99, 0x5A, 0xD2, 0x76, 0xA6,
+    0x34, 0x86, 0x45, 0x04, 0x63, 0x40, 0x80, 0x64, 0x63, 0x40, 0x80, 0x64, 0x71, 0x08, 0x38, 0x9A,
+    0xCE, 0xEF, 0x08, 0xFF, 0xCF, 0xCD, 0x0C, 0xFF, 0xD1, 0x8A, 0x13, 0xFF, 0x78, 0xCF, 0x94, 0xFF,
+    0x5B, 0x31, 0x6D, 0xFF, 0x3C, 0x08, 0x18, 0xFF, 0x51, 0xA0, 0x11, 0xFF, 0x4D, 0x87, 0x12, 0xFF,
+    0x31, 0xF7, 0x84, 0xFF, 0x00, 0xE7, 0xEF, 0xFF, 0x41, 0xAE, 0xA6, 0xFF, 0x94, 0x29, 0x63, 0xFF,
+    0xF8, 0xC8, 0xCA, 0xFF, 0x83, 0x84, 0xB7, 0xFF, 0xA0, 0xBD, 0xB4, 0xFF, 0xBC, 0xF4, 0xB0, 0xFF,
+    0xE4, 0xA5, 0x88, 0x28, 0xE4, 0xA5, 0x88, 0x10, 0xDE, 0x31, 0xF7, 0x4D, 0xE4, 0xA5, 0x88, 0x04,
+    0x87, 0x99, 0x5A, 0x34, 0x60, 0x99, 0x50, 0x2E, 0x37, 0x99, 0x45, 0x28, 0x87, 0xD6, 0x5A, 0x34,
+    0x4A, 0xD0, 0x84, 0xAC, 0x9C, 0xD9, 0x39, 0x8F, 0x68, 0xD3, 0x69, 0xA1, 0x4A, 0xD0, 0x84, 0xAC,
+    0x0C, 0x14, 0xC7, 0xC7, 0x71, 0x08, 0x38, 0x9A, 0x48, 0x5D, 0x41, 0x35, 0x0C, 0x14, 0xC7, 0xC7,
+};
+
+const uint8_t kBC6HUnsignedBlocks[] = {
+    0xAC, 0x08, 0xDE, 0x49, 0xB7, 0xE9, 0xE4, 0x4E, 0xEB, 0x6B, 0x51, 0xB3, 0xCA, 0xCB, 0x3F, 0x52,
+    0xC2, 0x2D, 0x78, 0x14, 0x9A, 0x84, 0x5E, 0x94, 0xC6, 0x43, 0x45, 0x57, 0xF5, 0xFD, 0x1D, 0x53,
+    0x26, 0x43, 0x7B, 0xCB, 0x1E, 0x81, 0x52, 0xCA, 0x0F, 0xA4, 0xF6, 0xB8, 0x58, 0xC2, 0x3C, 0xD0,
+    0x2A, 0x14, 0xC3, 0x83, 0xBC, 0xF6, 0xC6, 0xFE, 0x42, 0xD0, 0x03, 0x63, 0x6A, 0xFA, 0x8E, 0x72,
+    0x4E, 0x1C, 0xA3, 0xA8, 0xFF, 0x8F, 0xCA, 0x1A, 0xA7, 0xBF, 0xE4, 0x8B, 0x62, 0x9F, 0xF2, 0x8B,
+    0x72, 0x97, 0xAF, 0x95, 0xDC, 0x99, 0x43, 0x77, 0x9F, 0x36, 0xBD, 0x92, 0x84, 0xD8, 0x08, 0xA1,
+    0x36, 0x93, 0x8E, 0x1A, 0xF9, 0x19, 0xBE, 0x6E, 0xF2, 0xCD, 0x2D, 0x9F, 0x6F, 0x08, 0xFF, 0x00,
+    0x7A, 0xFB, 0xCB, 0x16, 0x04, 0xD5, 0x40, 0xE4, 0x24, 0x09, 0x20, 0x29, 0x71, 0xDE, 0x64, 0x4C,
+};
+
+const uint16_t kBC6HUnsignedTexels[] = {
+    0x086A, 0x73D3, 0x70EB, 0x078B, 0x746F, 0x70A8, 0x0760, 0x748D, 0x709B, 0x07B7, 0x7450, 0x70B5,
+    0x1614, 0x4C98, 0x1011, 0x15BC, 0x4CB3, 0x0FDB, 0x1583, 0x4CC5, 0x0FB8, 0x159F, 0x4CBC, 0x0FC9,
+    0x2092, 0x2DD2, 0x72AD, 0x20B9, 0x2D32, 0x72E3, 0x2092, 0x2DD2, 0x72AD, 0x20B3, 0x2D4C, 0x72DA,
+    0x47C7, 0x74A4, 0x60F7, 0x47D6, 0x7457, 0x6163, 0x47D2, 0x744A, 0x617D, 0x47D4, 0x7450, 0x6170,
+    0x36D2, 0x4EAA, 0x7117, 0x36A5, 0x4C93, 0x6F2C, 0x369D, 0x4D61, 0x7003, 0x3486, 0x4FD0, 0x7272,
+    0x59CC, 0x2D70, 0x26F2, 0x59CC, 0x2D70, 0x26F2, 0x563F, 0x307F, 0x221A, 0x5890, 0x2FAE, 0x2388,
+    0x4A25, 0x0B05, 0x43ED, 0x4A37, 0x0C1C, 0x4421, 0x49EF, 0x07A1, 0x434A, 0x49DE, 0x068A, 0x4316,
+    0x6A52, 0x4962, 0x0592, 0x6A52, 0x4A33, 0x06A9, 0x638A, 0x4BC6, 0x04E3, 0x638A, 0x4BC6, 0x04E3,
+    0x078B, 0x746F, 0x70A8, 0x0813, 0x7410, 0x70D1, 0x083E, 0x73F2, 0x70DE, 0x0734, 0x74AC, 0x708E,
+    0x15F8, 0x4CA1, 0x0FFF, 0x159F, 0x4CBC, 0x0FC9, 0x1583, 0x4CC5, 0x0FB8, 0x169D, 0x4C42, 0x108F,
+    0x2050, 0x2DA9, 0x729C, 0x208B, 0x2DEC, 0x72A5, 0x209F, 0x2D9E, 0x72BF, 0x2092, 0x2DD2, 0x72AD,
+    0x4824, 0x7502, 0x60CF, 0x4806, 0x74E3, 0x60DC, 0x47E5, 0x74C3, 0x60EA, 0x47D0, 0x7443, 0x618A,
+    0x36B7, 0x4D64, 0x6FEC, 0x3486, 0x4FD0, 0x7272, 0x3563, 0x4ECF, 0x7171, 0x35CB, 0x4E55, 0x70F7,
+    0x596B, 0x2D23, 0x2801, 0x5890, 0x2FAE, 0x2388, 0x6216, 0x2C52, 0x296A, 0x5D74, 0x2DF4, 0x268D,
+    0x4785, 0x10A4, 0x4645, 0x47EE, 0x196E, 0x467A, 0x47A8, 0x1392, 0x4657, 0x4718, 0x0787, 0x460F,
+    0x6A52, 0x49CA, 0x061D, 0x6A52, 0x49CA, 0x061D, 0x638A, 0x46BB, 0x0C73, 0x638A, 0x4D00, 0x030C,
+    0x078B, 0x746F, 0x70A8, 0x07B7, 0x7450, 0x70B5, 0x0734, 0x74AC, 0x708E, 0x0753, 0x7357, 0x7186,
+    0x1583, 0x4CC5, 0x0FB8, 0x169D, 0x4C42, 0x108F, 0x1679, 0x4C81, 0x1074, 0x169D, 0x4C42, 0x108F,
+    0x20D7, 0x2DDF, 0x728A, 0x20F7, 0x2DEC, 0x7286, 0x209F, 0x2D9E, 0x72BF, 0x20B3, 0x2D4C, 0x72DA,
+    0x47D2, 0x744A, 0x617D, 0x4833, 0x7511, 0x60C8, 0x47F5, 0x74D2, 0x60E3, 0x4833, 0x7511, 0x60C8,
+    0x369D, 0x4C2B, 0x6ECD, 0x341D, 0x504A, 0x72EC, 0x35CB, 0x4E55, 0x70F7, 0x3563, 0x4ECF, 0x7171,
+    0x5890, 0x2FAE, 0x2388, 0x563F, 0x307F, 0x221A, 0x5FC5, 0x2D23, 0x27FB, 0x5D74, 0x2DF4, 0x268D,
+    0x4785, 0x10A4, 0x4645, 0x46F6, 0x049A, 0x45FE, 0x47CB, 0x1680, 0x4668, 0x47EE, 0x196E, 0x467A,
+    0x6A52, 0x4C4A, 0x0972, 0x6A52, 0x4B78, 0x085B, 0x638A, 0x4D00, 0x030C, 0x638A, 0x4D00, 0x030C,
+    0x083E, 0x73F2, 0x70DE, 0x0726, 0x72A5, 0x7091, 0x0726, 0x72A5, 0x7091, 0x071E, 0x7282, 0x7061,
+    0x165F, 0x4CAE, 0x1060, 0x1679, 0x4C81, 0x1074, 0x1670, 0x4C90, 0x106D, 0x1667, 0x4C9F, 0x1067,
+    0x2095, 0x2DC5, 0x7293, 0x20F7, 0x2DEC, 0x7286, 0x2071, 0x2DB6, 0x7298, 0x20B3, 0x2D4C, 0x72DA,
+    0x47D6, 0x7457, 0x6163, 0x47CB, 0x7435, 0x61A6, 0x47CE, 0x743C, 0x6199, 0x47F5, 0x74D2, 0x60E3,
+    0x369D, 0x4D61, 0x7003, 0x34EE, 0x4F56, 0x71F8, 0x341D, 0x504A, 0x72EC, 0x3486, 0x4FD0, 0x7272,
+    0x6216, 0x2C52, 0x296A, 0x5FC5, 0x2D23, 0x27FB, 0x5890, 0x2FAE, 0x2388, 0x5D74, 0x2DF4, 0x268D,
+    0x47EE, 0x196E, 0x467A, 0x46F6, 0x049A, 0x45FE, 0x46F6, 0x049A, 0x45FE, 0x46F6, 0x049A, 0x45FE,
+    0x6A52, 0x4A9B, 0x0734, 0x6A52, 0x4B10, 0x07CF, 0x638A, 0x4D00, 0x030C, 0x638A, 0x4D00, 0x030C,
+};
+
+const uint8_t kBC6HSignedBlocks[] = {
+    0x0D, 0xAC, 0xA5, 0xFF, 0xFF, 0x68, 0x15, 0xDE, 0xC0, 0x63, 0x9B, 0x8B, 0xD5, 0x66, 0xF5, 0x0E,
+    0x3E, 0x85, 0xDE, 0x76, 0x92, 0x53, 0x9E, 0x0D, 0xAD, 0x61, 0x8F, 0x91, 0x34, 0x19, 0x6E, 0x45,
+    0x43, 0x71, 0x89, 0xD8, 0x58, 0x09, 0x26, 0x63, 0x78, 0x9C, 0xA9, 0x09, 0xC2, 0xE9, 0x5A, 0xF7,
+    0xC7, 0x80, 0xE0, 0xC9, 0x35, 0x04, 0xAF, 0x9E, 0xA9, 0xD9, 0x1F, 0x56, 0xA2, 0x58, 0xE6, 0xC1,
+    0x4B, 0xEE, 0x0C, 0xCB, 0x9F, 0xCE, 0xC0, 0xDC, 0x12, 0x13, 0x86, 0xF9, 0x34, 0x81, 0xAA, 0x64,
+    0x8F, 0x3A, 0xFD, 0xC7, 0xF4, 0x19, 0x3A, 0x28, 0x1D, 0x90, 0x9B, 0x29, 0x66, 0x2F, 0x80, 0x59,
+    0x73, 0x33, 0x35, 0xA2, 0xC4, 0xCA, 0x24, 0x0C, 0x1E, 0xEC, 0x17, 0x5D, 0x01, 0xE6, 0x52, 0x5F,
+};
+
+const uint16_t kBC6HSignedTexels[] = {
+    0xAE13, 0xACCE, 0x8516, 0xB685, 0xCA3B, 0x83FF, 0xDC86, 0x2AAA, 0x034C, 0xC662, 0x8E8F, 0x81E0,
+    0xCC59, 0x9F8B, 0x20A2, 0xDB10, 0x8D90, 0x9550, 0x3820, 0x1B01, 0xE57A, 0x5730, 0x24D0, 0xDEF0,
+    0x81CF, 0x4469, 0x2011, 0x12C1, 0x45E2, 0x247E, 0x33F8, 0x4845, 0x2BA5, 0x1F68, 0x46CB, 0x2738,
+    0x0518, 0x700E, 0xA8B8, 0x0BB0, 0x695D, 0xB250, 0x0A6B, 0x6AA7, 0xB078, 0x0EBB, 0x6647, 0xB6BD,
+    0xC6CC, 0x5E91, 0xBFEF, 0xC6CC, 0x5E91, 0xBFEF, 0xC72E, 0x5E9E, 0xC08A, 0xC6CC, 0x5E91, 0xBFEF,
+    0xB09B, 0xC1E5, 0xD6D0, 0xB09A, 0xC1E5, 0xD6D0, 0xB09A, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0xBEF8, 0xE7A8, 0x82E8, 0xDC86, 0x2AAA, 0x034C, 0xC662, 0x8E8F, 0x81E0, 0x8B5A, 0x4C2B, 0x8991,
+    0xD628, 0x938E, 0x8354, 0x4CD5, 0x218B, 0xE11E, 0x2245, 0x141A, 0xEA14, 0xD628, 0x938E, 0x8354,
+    0x1F68, 0x46CB, 0x2738, 0x2751, 0x475C, 0x28EC, 0x1F68, 0x46CB, 0x2738, 0x9CB3, 0x427B, 0x1A47,
+    0x1103, 0x63F6, 0xBA10, 0x01CD, 0x7367, 0xA3ED, 0x0761, 0x6DBD, 0xAC0B, 0x061C, 0x6F07, 0xAA32,
+    0xC7BB, 0x5EB1, 0xC168, 0xC812, 0x5EBC, 0xC1F2, 0xC83E, 0x5EC2, 0xC237, 0xC95A, 0x5EE8, 0xC3F6,
+    0xB09B, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0, 0xB09A, 0xC1E5, 0xD6D0,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x8B5A, 0x4C2B, 0x8991, 0xD0E0, 0x0C8C, 0x0093, 0xC662, 0x8E8F, 0x81E0, 0xAE13, 0xACCE, 0x8516,
+    0xD628, 0x938E, 0x8354, 0x3820, 0x1B01, 0xE57A, 0x5730, 0x24D0, 0xDEF0, 0xB830, 0xB830, 0x6A90,
+    0x8E76, 0x4380, 0x1D57, 0x33F8, 0x4845, 0x2BA5, 0x1F68, 0x46CB, 0x2738, 0x4235, 0x494A, 0x2EB6,
+    0x0311, 0x721D, 0xA5C5, 0x0BB0, 0x695D, 0xB250, 0x0968, 0x6BAE, 0xAEFE, 0x061C, 0x6F07, 0xAA32,
+    0xC759, 0x5EA4, 0xC0CE, 0xC72E, 0x5E9E, 0xC08A, 0xC6CC, 0x5E91, 0xBFEF, 0xC812, 0x5EBC, 0xC1F2,
+    0xB09B, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0, 0xB09C, 0xC1E5, 0xD6D0, 0xB09A, 0xC1E5, 0xD6D0,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0xB168, 0xC4C8, 0x86C8, 0xC662, 0x8E8F, 0x81E0, 0xA5A1, 0x8F61, 0x862D, 0xBEF8, 0xE7A8, 0x82E8,
+    0x17EA, 0x10D5, 0xEC42, 0x427B, 0x1E46, 0xE34C, 0xD628, 0x938E, 0x8354, 0xD141, 0x998D, 0x0EA7,
+    0x2751, 0x475C, 0x28EC, 0x0484, 0x44DD, 0x216D, 0x12C1, 0x45E2, 0x247E, 0x4889, 0x49BF, 0x3013,
+    0x0761, 0x6DBD, 0xAC0B, 0x0FFF, 0x64FE, 0xB896, 0x01CD, 0x7367, 0xA3ED, 0x0DB7, 0x674E, 0xB544,
+    0xC875, 0x5ECA, 0xC28D, 0xC875, 0x5ECA, 0xC28D, 0xC759, 0x5EA4, 0xC0CE, 0xC7BB, 0x5EB1, 0xC168,
+    0xB09A, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0, 0xB09B, 0xC1E5, 0xD6D0,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+
+const uint8_t kASTC4x4Blocks[] = {
+    0xAE, 0x07, 0x98, 0xCB, 0x27, 0x0B, 0x7C, 0x1F, 0xA0, 0x2C, 0x80, 0xDF, 0xFE, 0xF7, 0xE6, 0x0B,
+    0xBF, 0xC9, 0xF3, 0xE5, 0xB4, 0x45, 0x0C, 0xEA, 0x21, 0x0B, 0x15, 0x0F, 0x71, 0xDF, 0x08, 0x82,
+    0x3E, 0x55, 0x88, 0x58, 0x9A, 0x19, 0x47, 0x7F, 0xF6, 0x93, 0xFC, 0x08, 0xF9, 0x10, 0x3C, 0xD3,
+    0x03, 0xDA, 0x84, 0x3E, 0xB8, 0xA7, 0xA8, 0x5C, 0x5D, 0x79, 0xB4, 0xA5, 0x17, 0x3C, 0xBA, 0xDE,
+};
+
+const uint8_t kASTC4x4Texels[] = {
+    0xCC, 0xE2, 0xCC, 0xFF, 0xD4, 0xDA, 0xD4, 0xFF, 0xDC, 0xDA, 0xDC, 0xFF, 0xE5, 0xE4, 0xE5, 0xFF,
+    0x40, 0x52, 0x33, 0xFF, 0x3B, 0x57, 0x31, 0xFF, 0x3B, 0x57, 0x31, 0xFF, 0x40, 0x52, 0x33, 0xFF,
+    0x51, 0x82, 0xBB, 0xFF, 0x51, 0x79, 0xAE, 0xFF, 0x51, 0x6E, 0x9F, 0xFF, 0x51, 0x65, 0x92, 0xFF,
+    0x31, 0x31, 0x31, 0x84, 0x31, 0x31, 0x31, 0x83, 0x33, 0x33, 0x33, 0x8D, 0x35, 0x6C, 0xA4, 0xFF,
+    0xDE, 0xDB, 0xDE, 0xFF, 0xDC, 0xE0, 0xDC, 0xFF, 0xDB, 0xDE, 0xDB, 0xFF, 0xD5, 0xD4, 0xD5, 0xFF,
+    0x3B, 0x57, 0x31, 0xFF, 0x3D, 0x54, 0x32, 0xFF, 0x45, 0x4C, 0x35, 0xFF, 0x59, 0x35, 0x3C, 0xFF,
+    0x7E, 0x82, 0xBB, 0xFF, 0x6C, 0x6E, 0x9F, 0xFF, 0x4D, 0x52, 0x75, 0xFF, 0x3B, 0x3E, 0x59, 0xFF,
+    0x30, 0x62, 0x95, 0xFF, 0x2C, 0x59, 0x87, 0xFF, 0x34, 0x34, 0x34, 0x8D, 0x32, 0x32, 0x32, 0x88,
+    0xE0, 0xD6, 0xE0, 0xFF, 0xDD, 0xDC, 0xDD, 0xFF, 0xD9, 0xDC, 0xD9, 0xFF, 0xD2, 0xD4, 0xD2, 0xFF,
+    0x46, 0x4B, 0x35, 0xFF, 0x4B, 0x45, 0x37, 0xFF, 0x53, 0x3B, 0x3A, 0xFF, 0x64, 0x29, 0x3F, 0xFF,
+    0x74, 0x70, 0xA1, 0xFF, 0x6E, 0x67, 0x94, 0xFF, 0x55, 0x50, 0x73, 0xFF, 0x4F, 0x47, 0x66, 0xFF,
+    0x32, 0x32, 0x32, 0x88, 0x35, 0x35, 0x35, 0x93, 0x34, 0x34, 0x34, 0x8E, 0x34, 0x34, 0x34, 0x90,
+    0xD3, 0xD1, 0xD3, 0xFF, 0xD4, 0xCE, 0xD4, 0xFF, 0xD6, 0xD4, 0xD6, 0xFF, 0xDA, 0xE5, 0xDA, 0xFF,
+    0x64, 0x29, 0x3F, 0xFF, 0x69, 0x23, 0x41, 0xFF, 0x69, 0x23, 0x41, 0xFF, 0x64, 0x29, 0x3F, 0xFF,
+    0xF4, 0xF7, 0xF7, 0xFF, 0xF7, 0xF9, 0xF9, 0xFF, 0xFA, 0xFB, 0xFB, 0xFF, 0xFD, 0xFD, 0xFD, 0xFF,
+    0xEA, 0x33, 0xD0, 0xFF, 0xCB, 0x2C, 0xB4, 0xFF, 0xE1, 0x31, 0xC8, 0xFF, 0x1E, 0x3E, 0x5E, 0xFF,
+};
+
+const uint8_t kASTC6x6Blocks[] = {
+    0x32, 0x44, 0x25, 0x25, 0x54, 0x69, 0xB0, 0x00, 0xD7, 0x27, 0xA4, 0x5F, 0x07, 0xB3, 0x23, 0x53,
+    0x41, 0x4C, 0x3A, 0xCC, 0x3A, 0x76, 0xB5, 0xAE, 0x76, 0x54, 0x70, 0x50, 0xC6, 0x76, 0xCF, 0x58,
+};
+
+const uint8_t kASTC6x6Texels[] = {
+    0x57, 0x0A, 0x66, 0x62, 0x57, 0x0A, 0x66, 0x62, 0x52, 0x09, 0x60, 0x60, 0x3F, 0x07, 0x4A, 0x5A,
+    0x45, 0x08, 0x51, 0x67, 0x57, 0x0A, 0x66, 0x80, 0x61, 0xB1, 0x4E, 0xFF, 0x61, 0xB1, 0x4E, 0xFF,
+    0x77, 0x9F, 0x5F, 0xFF, 0xC0, 0x62, 0x9A, 0xFF, 0xAA, 0x50, 0x88, 0xFF, 0x61, 0x50, 0x4E, 0xFF,
+    0x6D, 0x0D, 0x80, 0x6D, 0x6D, 0x0D, 0x80, 0x63, 0x6A, 0x0C, 0x7B, 0x5D, 0x5F, 0x0B, 0x6E, 0x5C,
+    0x62, 0x0B, 0x73, 0x68, 0x6D, 0x0D, 0x80, 0x7C, 0x94, 0xA3, 0x6A, 0xFF, 0x72, 0x85, 0x52, 0xFF,
+    0x6D, 0x76, 0x4E, 0xFF, 0xA4, 0x80, 0x76, 0xFF, 0xAA, 0x85, 0x7A, 0xFF, 0x94, 0x85, 0x6A, 0xFF,
+    0x87, 0x10, 0x9D, 0x7A, 0x87, 0x10, 0x9D, 0x66, 0x85, 0x10, 0x9B, 0x5A, 0x83, 0x10, 0x99, 0x5F,
+    0x83, 0x10, 0x99, 0x69, 0x87, 0x10, 0x9D, 0x78, 0xA4, 0xA3, 0x76, 0xFF, 0x83, 0x7B, 0x5E, 0xFF,
+    0x72, 0x6C, 0x52, 0xFF, 0x9F, 0x99, 0x72, 0xFF, 0xAA, 0x9E, 0x7A, 0xFF, 0xB5, 0x94, 0x82, 0xFF,
+    0x92, 0x12, 0xAA, 0x80, 0x87, 0x10, 0x9D, 0x68, 0x80, 0x0F, 0x95, 0x5C, 0x7E, 0x0F, 0x93, 0x62,
+    0x80, 0x0F, 0x95, 0x6B, 0x87, 0x10, 0x9D, 0x76, 0x77, 0xB1, 0x5F, 0xFF, 0xA3, 0xA5, 0x82, 0xFF,
+    0xB9, 0xA5, 0x94, 0xFF, 0x7E, 0xAB, 0x65, 0xFF, 0x9C, 0x93, 0x7C, 0xFF, 0xD6, 0x62, 0xAB, 0xFF,
+    0x92, 0x12, 0xAA, 0x80, 0x71, 0x0D, 0x84, 0x6B, 0x57, 0x0A, 0x66, 0x60, 0x4C, 0x09, 0x59, 0x66,
+    0x57, 0x0A, 0x66, 0x6D, 0x6D, 0x0D, 0x80, 0x76, 0x8D, 0xB1, 0x71, 0xFF, 0x9C, 0x99, 0x7C, 0xFF,
+    0x9C, 0x93, 0x7C, 0xFF, 0x70, 0xAB, 0x59, 0xFF, 0x8D, 0x8D, 0x71, 0xFF, 0xD6, 0x50, 0xAB, 0xFF,
+    0x92, 0x12, 0xAA, 0x80, 0x5B, 0x0B, 0x6A, 0x6D, 0x34, 0x06, 0x3D, 0x64, 0x22, 0x03, 0x28, 0x6A,
+    0x33, 0x05, 0x3B, 0x70, 0x57, 0x0A, 0x66, 0x76, 0xD6, 0xB1, 0xAB, 0xFF, 0x8D, 0x74, 0x71, 0xFF,
+    0x61, 0x62, 0x4E, 0xFF, 0x61, 0x9F, 0x4E, 0xFF, 0x8D, 0x8D, 0x71, 0xFF, 0xD6, 0x50, 0xAB, 0xFF,
+};
+
+const uint8_t kASTC8x5Blocks[] = {
+    0x11, 0x23, 0x36, 0xB3, 0xCA, 0x4C, 0xB0, 0xC2, 0x1F, 0xF9, 0x97, 0xA2, 0xF1, 0x4C, 0xC8, 0xA3,
+    0x5F, 0x8B, 0x10, 0x67, 0x18, 0xCA, 0x2F, 0x8F, 0x41, 0x9C, 0xA5, 0x92, 0xF2, 0x41, 0x8C, 0x0D,
+};
+
+const uint8_t kASTC8x5Texels[] = {
+    0x7D, 0x7D, 0x7D, 0xFF, 0x70, 0x70, 0x70, 0xFF, 0x6F, 0x6F, 0x6F, 0xFF, 0x73, 0x73, 0x73, 0xFF,
+    0x6D, 0x6D, 0x6D, 0xFF, 0x6A, 0x6A, 0x6A, 0xFF, 0x69, 0x69, 0x69, 0xFF, 0x6A, 0x6A, 0x6A, 0xFF,
+    0x56, 0x36, 0x0C, 0xC2, 0x53, 0x35, 0x0B, 0xC2, 0x51, 0x34, 0x0B, 0xC3, 0x4F, 0x32, 0x0B, 0xC3,
+    0x4C, 0x31, 0x0A, 0xC3, 0x4A, 0x2F, 0x0A, 0xC3, 0x45, 0x2C, 0x09, 0xC3, 0x43, 0x2B, 0x09, 0xC4,
+    0x77, 0x77, 0x77, 0xFF, 0x71, 0x71, 0x71, 0xFF, 0x6E, 0x6E, 0x6E, 0xFF, 0x71, 0x71, 0x71, 0xFF,
+    0x6F, 0x6F, 0x6F, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF, 0x6A, 0x6A, 0x6A, 0xFF, 0x6F, 0x6F, 0x6F, 0xFF,
+    0x45, 0x2C, 0x09, 0xC3, 0x41, 0x29, 0x09, 0xC4, 0x3A, 0x25, 0x08, 0xC4, 0x37, 0x23, 0x07, 0xC4,
+    0x33, 0x20, 0x07, 0xC5, 0x2E, 0x1D, 0x06, 0xC5, 0x27, 0x19, 0x05, 0xC6, 0x24, 0x17, 0x04, 0xC6,
+    0x72, 0x72, 0x72, 0xFF, 0x71, 0x71, 0x71, 0xFF, 0x6D, 0x6D, 0x6D, 0xFF, 0x6D, 0x6D, 0x6D, 0xFF,
+    0x6F, 0x6F, 0x6F, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF, 0x73, 0x73, 0x73, 0xFF,
+    0x5D, 0x3B, 0x0D, 0xC2, 0x56, 0x36, 0x0C, 0xC2, 0x48, 0x2E, 0x0A, 0xC3, 0x41, 0x29, 0x09, 0xC4,
+    0x3A, 0x25, 0x08, 0xC4, 0x33, 0x20, 0x07, 0xC5, 0x27, 0x19, 0x05, 0xC6, 0x20, 0x14, 0x04, 0xC6,
+    0x6C, 0x6C, 0x6C, 0xFF, 0x6F, 0x6F, 0x6F, 0xFF, 0x6F, 0x6F, 0x6F, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF,
+    0x70, 0x70, 0x70, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF, 0x6B, 0x6B, 0x6B, 0xFF, 0x77, 0x77, 0x77, 0xFF,
+    0x8C, 0x76, 0x68, 0xFF, 0x89, 0x78, 0x66, 0xFF, 0x80, 0x7D, 0x5F, 0xFF, 0x7C, 0x7E, 0x5C, 0xFF,
+    0x74, 0x82, 0x56, 0xFF, 0x73, 0x83, 0x55, 0xFF, 0x6D, 0x86, 0x50, 0xFF, 0x65, 0x8A, 0x4A, 0xFF,
+    0x66, 0x66, 0x66, 0xFF, 0x70, 0x70, 0x70, 0xFF, 0x6E, 0x6E, 0x6E, 0xFF, 0x68, 0x68, 0x68, 0xFF,
+    0x70, 0x70, 0x70, 0xFF, 0x6C, 0x6C, 0x6C, 0xFF, 0x6D, 0x6D, 0x6D, 0xFF, 0x7B, 0x7B, 0x7B, 0xFF,
+    0x5D, 0x8D, 0x43, 0xFF, 0x5E, 0x8D, 0x45, 0xFF, 0x62, 0x8B, 0x47, 0xFF, 0x63, 0x8A, 0x48, 0xFF,
+    0x65, 0x8A, 0x4A, 0xFF, 0x66, 0x89, 0x4B, 0xFF, 0x68, 0x88, 0x4C, 0xFF, 0x69, 0x87, 0x4D, 0xFF,
+};
+
+const uint8_t kASTC12x12Blocks[] = {
+    0x74, 0x00, 0xD6, 0x4A, 0xE7, 0x49, 0xA9, 0xF4, 0x28, 0xD5, 0xDB, 0x71, 0x08, 0x65, 0x90, 0x81,
+};
+
+const uint8_t kASTC12x12Texels[] = {
+    0xE1, 0xE1, 0xE1, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xE1, 0xE1, 0xE1, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xD3, 0xD3, 0xD3, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF,
+    0xDC, 0xDC, 0xDC, 0xFF, 0xD8, 0xD8, 0xD8, 0xFF, 0xD8, 0xD8, 0xD8, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xDC, 0xDC, 0xDC, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE4, 0xE4, 0xE4, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xDD, 0xDD, 0xDD, 0xFF, 0xDD, 0xDD, 0xDD, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xDC, 0xDC, 0xDC, 0xFF,
+    0xD7, 0xD7, 0xD7, 0xFF, 0xDD, 0xDD, 0xDD, 0xFF, 0xDD, 0xDD, 0xDD, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xD7, 0xD7, 0xD7, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xDA, 0xDA, 0xDA, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xE8, 0xE8, 0xE8, 0xFF, 0xE8, 0xE8, 0xE8, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xD7, 0xD7, 0xD7, 0xFF,
+    0xD4, 0xD4, 0xD4, 0xFF, 0xE2, 0xE2, 0xE2, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xD5, 0xD5, 0xD5, 0xFF,
+    0xD5, 0xD5, 0xD5, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xD5, 0xD5, 0xD5, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xD9, 0xD9, 0xD9, 0xFF, 0xE7, 0xE7, 0xE7, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xDF, 0xDF, 0xDF, 0xFF,
+    0xDF, 0xDF, 0xDF, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xDF, 0xDF, 0xDF, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xDE, 0xDE, 0xDE, 0xFF, 0xEC, 0xEC, 0xEC, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF,
+    0xE9, 0xE9, 0xE9, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xE3, 0xE3, 0xE3, 0xFF, 0xE3, 0xE3, 0xE3, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xE1, 0xE1, 0xE1, 0xFF, 0xEC, 0xEC, 0xEC, 0xFF, 0xDE, 0xDE, 0xDE, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xDE, 0xDE, 0xDE, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xD6, 0xD6, 0xD6, 0xFF,
+    0xE9, 0xE9, 0xE9, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xD6, 0xD6, 0xD6, 0xFF,
+    0xE1, 0xE1, 0xE1, 0xFF, 0xE7, 0xE7, 0xE7, 0xFF, 0xD9, 0xD9, 0xD9, 0xFF, 0xDF, 0xDF, 0xDF, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xD9, 0xD9, 0xD9, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xDB, 0xDB, 0xDB, 0xFF,
+    0xDF, 0xDF, 0xDF, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xDB, 0xDB, 0xDB, 0xFF,
+    0xE1, 0xE1, 0xE1, 0xFF, 0xE2, 0xE2, 0xE2, 0xFF, 0xD4, 0xD4, 0xD4, 0xFF, 0xD5, 0xD5, 0xD5, 0xFF,
+    0xEE, 0xEE, 0xEE, 0xFF, 0xD4, 0xD4, 0xD4, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xE0, 0xE0, 0xE0, 0xFF,
+    0xD5, 0xD5, 0xD5, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE0, 0xE0, 0xE0, 0xFF,
+    0xDD, 0xDD, 0xDD, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xDA, 0xDA, 0xDA, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xEB, 0xEB, 0xEB, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xEB, 0xEB, 0xEB, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF,
+    0xD3, 0xD3, 0xD3, 0xFF, 0xE4, 0xE4, 0xE4, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE4, 0xE4, 0xE4, 0xFF,
+    0xD8, 0xD8, 0xD8, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE4, 0xE4, 0xE4, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xE6, 0xE6, 0xE6, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xE6, 0xE6, 0xE6, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF,
+    0xD3, 0xD3, 0xD3, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE9, 0xE9, 0xE9, 0xFF,
+    0xD3, 0xD3, 0xD3, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF,
+    0xE1, 0xE1, 0xE1, 0xFF, 0xD3, 0xD3, 0xD3, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF,
+    0xD3, 0xD3, 0xD3, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF, 0xE1, 0xE1, 0xE1, 0xFF, 0xEE, 0xEE, 0xEE, 0xFF,
+};
+
+}  // namespace known_answers
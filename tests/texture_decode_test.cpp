@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks that texture_decode::decodeImage() is bit-exact against Basis
+Universal's block decoders (BC1, BC3, BC4, BC5, BC6H, BC7 and ASTC) and
+against the format specifications (BC2 alpha, and signed BC4 and BC5), on
+random and hand-made blocks in images whose sizes aren't multiples of the
+block size, for both decode targets and with one thread vs. the thread pool.
+
+Since those references are the functions texture_decode wraps, it also
+compares decodeImage() with known-answer texels of BC7, BC6H and ASTC blocks
+from an independent decoder (texture_decode_known_answers.hpp).
+
+Then checks nv_ktx's ReadSettings::decode_astc_without_device_support on
+ASTC files transcoded from UASTC, read from streams, memory views, and with
+KTXLevelReader.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <basisu_gpu_texture.h>
+#include <basisu_astc_helpers.h>  // Must come after basisu_gpu_texture.h
+#include <glm/gtc/packing.hpp>
+
+#include "nvimageformats/nv_ktx.h"
+#include "nvimageformats/texture_decode.h"
+#include "nvutils/logger.hpp"
+
+#include "test_check.hpp"
+#include "texture_decode_known_answers.hpp"
+
+namespace {
+
+uint32_t g_rng = 12345;
+
+uint32_t nextRandom()
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return g_rng;
+}
+
+struct FormatCase
+{
+  VkFormat    format;
+  const char* name;
+  uint32_t    blockWidth;
+  uint32_t    blockHeight;
+  uint32_t    blockBytes;
+  bool        halfTexels;  // Whether the format decodes to half floats
+};
+
+const FormatCase kFormats[] = {
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK, "BC1 RGB", 4, 4, 8, false},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, "BC1 RGBA", 4, 4, 8, false},
+    {VK_FORMAT_BC2_UNORM_BLOCK, "BC2", 4, 4, 16, false},
+    {VK_FORMAT_BC3_SRGB_BLOCK, "BC3", 4, 4, 16, false},
+    {VK_FORMAT_BC4_UNORM_BLOCK, "BC4 UNORM", 4, 4, 8, false},
+    {VK_FORMAT_BC4_SNORM_BLOCK, "BC4 SNORM", 4, 4, 8, true},
+    {VK_FORMAT_BC5_UNORM_BLOCK, "BC5 UNORM", 4, 4, 16, false},
+    {VK_FORMAT_BC5_SNORM_BLOCK, "BC5 SNORM", 4, 4, 16, true},
+    {VK_FORMAT_BC6H_UFLOAT_BLOCK, "BC6H UFLOAT", 4, 4, 16, true},
+    {VK_FORMAT_BC6H_SFLOAT_BLOCK, "BC6H SFLOAT", 4, 4, 16, true},
+    {VK_FORMAT_BC7_UNORM_BLOCK, "BC7", 4, 4, 16, false},
+    {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, "ASTC 4x4 UNORM", 4, 4, 16, false},
+    {VK_FORMAT_ASTC_5x4_SRGB_BLOCK, "ASTC 5x4 SRGB", 5, 4, 16, false},
+    {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, "ASTC 6x6 UNORM", 6, 6, 16, false},
+    {VK_FORMAT_ASTC_8x5_SRGB_BLOCK, "ASTC 8x5 SRGB", 8, 5, 16, false},
+    {VK_FORMAT_ASTC_10x8_UNORM_BLOCK, "ASTC 10x8 UNORM", 10, 8, 16, false},
+    {VK_FORMAT_ASTC_12x12_SRGB_BLOCK, "ASTC 12x12 SRGB", 12, 12, 16, false},
+    {VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK, "ASTC 4x4 SFLOAT", 4, 4, 16, true},
+    {VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK, "ASTC 8x8 SFLOAT", 8, 8, 16, true},
+};
+
+bool isASTC(VkFormat format)
+{
+  return (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+         || (format >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK && format <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK);
+}
+
+// Fills a block with random bits, then sometimes makes it a block that
+// exercises a particular decoder branch.
+void makeBlock(const FormatCase& f, uint8_t* block)
+{
+  for(uint32_t i = 0; i < f.blockBytes; i++)
+  {
+    block[i] = uint8_t(nextRandom() >> 24);
+  }
+  const uint32_t variant = nextRandom() % 4;
+  if(isASTC(f.format))
+  {
+    // An LDR (or, for SFLOAT, sometimes HDR) void-extent block: a constant
+    // color with no extent coordinates.
+    if(variant == 0)
+    {
+      const uint8_t header[8] = {0xFC, uint8_t((f.halfTexels && (nextRandom() & 1)) ? 0xFF : 0xFD), 0xFF, 0xFF,
+                                 0xFF, 0xFF, 0xFF, 0xFF};
+      memcpy(block, header, sizeof(header));
+    }
+    return;
+  }
+  // BC1 to BC3: swap the endpoints to switch between 3- and 4-color modes.
+  // BC4 and BC5: likewise for 6- and 8-value modes.
+  const uint32_t endpointOffset = (f.format == VK_FORMAT_BC2_UNORM_BLOCK || f.format == VK_FORMAT_BC3_SRGB_BLOCK) ? 8 : 0;
+  if(variant == 0 && f.format <= VK_FORMAT_BC3_SRGB_BLOCK)
+  {
+    std::swap(block[endpointOffset + 0], block[endpointOffset + 2]);
+    std::swap(block[endpointOffset + 1], block[endpointOffset + 3]);
+  }
+  else if(variant == 0 || variant == 1)
+  {
+    block[0] = block[1];  // Equal endpoints
+    if(f.format <= VK_FORMAT_BC3_SRGB_BLOCK)
+    {
+      block[endpointOffset + 0] = block[endpointOffset + 2];
+      block[endpointOffset + 1] = block[endpointOffset + 3];
+    }
+  }
+}
+
+// Decodes a block using Basis Universal, or the specifications of the
+// formats Basis Universal doesn't decode, into 8-bit RGBA or half float RGBA
+// texels. Sets `compareRGB` to false if Basis Universal's decode of a BC3
+// block's color disagrees with the specification (it decodes color0 <=
+// color1 as 3-color mode, while the specification says BC3 always uses
+// 4-color mode).
+void referenceDecode(const FormatCase& f, const uint8_t* block, uint8_t* rgba8, uint16_t* rgba16f, bool& compareRGB)
+{
+  compareRGB                         = true;
+  const uint32_t     numTexels       = f.blockWidth * f.blockHeight;
+  basisu::color_rgba pixels[12 * 12] = {};
+  for(uint32_t i = 0; i < numTexels; i++)
+  {
+    pixels[i].set(0, 0, 0, 255);
+  }
+  switch(f.format)
+  {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+      basisu::unpack_bc1(block, pixels, false);
+      break;
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+      basisu::unpack_bc1(block, pixels, true);
+      break;
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+      // Basis Universal has no BC2 decoder, but BC2 color blocks are BC3
+      // color blocks; the alpha is 4 bits per texel.
+      compareRGB = !basisu::unpack_bc1(block + 8, pixels, true);
+      for(uint32_t i = 0; i < 16; i++)
+      {
+        pixels[i].a = uint8_t(((block[i / 2] >> (4 * (i % 2))) & 15) * 17);
+      }
+      break;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+      compareRGB = basisu::unpack_bc3(block, pixels);
+      break;
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+      basisu::unpack_bc4(block, &pixels[0].r, sizeof(basisu::color_rgba));
+      break;
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+      basisu::unpack_bc5(block, pixels);
+      break;
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+      if(!basisu::unpack_bc7(block, pixels))
+      {
+        memset(pixels, 0, sizeof(basisu::color_rgba) * 16);
+      }
+      break;
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    {
+      // D3D10 functional specification, section 19.5.12
+      const uint32_t numChannels = (f.format == VK_FORMAT_BC4_SNORM_BLOCK) ? 1 : 2;
+      for(uint32_t i = 0; i < 16; i++)
+      {
+        rgba16f[4 * i + 0] = rgba16f[4 * i + 1] = rgba16f[4 * i + 2] = glm::packHalf1x16(0.0f);
+        rgba16f[4 * i + 3]                                           = glm::packHalf1x16(1.0f);
+      }
+      for(uint32_t c = 0; c < numChannels; c++)
+      {
+        const uint8_t* channel = block + 8 * c;
+        const float    e0      = std::max(float(int8_t(channel[0])), -127.0f) / 127.0f;
+        const float    e1      = std::max(float(int8_t(channel[1])), -127.0f) / 127.0f;
+        uint64_t       bits    = 0;
+        for(int b = 7; b >= 2; b--)
+        {
+          bits = (bits << 8) | channel[b];
+        }
+        for(uint32_t i = 0; i < 16; i++)
+        {
+          const uint32_t index = (bits >> (3 * i)) & 7;
+          float          value = 0.0f;
+          if(index < 2)
+          {
+            value = (index == 0) ? e0 : e1;
+          }
+          else if(int8_t(channel[0]) > int8_t(channel[1]))
+          {
+            value = (float(8 - index) * e0 + float(index - 1) * e1) / 7.0f;
+          }
+          else if(index < 6)
+          {
+            value = (float(6 - index) * e0 + float(index - 1) * e1) / 5.0f;
+          }
+          else
+          {
+            value = (index == 6) ? -1.0f : 1.0f;
+          }
+          rgba16f[4 * i + c] = glm::packHalf1x16(value);
+        }
+      }
+      return;
+    }
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    {
+      uint16_t rgb[16 * 3];
+      if(!basisu::unpack_bc6h(block, rgb, f.format == VK_FORMAT_BC6H_SFLOAT_BLOCK))
+      {
+        memset(rgb, 0, sizeof(rgb));
+      }
+      for(uint32_t i = 0; i < 16; i++)
+      {
+        memcpy(rgba16f + 4 * i, rgb + 3 * i, 3 * sizeof(uint16_t));
+        rgba16f[4 * i + 3] = glm::packHalf1x16(1.0f);
+      }
+      return;
+    }
+    default:
+    {
+      // ASTC
+      const bool srgb = f.format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && f.format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK
+                        && (f.format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) % 2 == 1;
+      const astc_helpers::decode_mode mode =
+          f.halfTexels ? astc_helpers::cDecodeModeHDR16 : (srgb ? astc_helpers::cDecodeModeSRGB8 : astc_helpers::cDecodeModeLDR8);
+      astc_helpers::log_astc_block logicalBlock;
+      void* out = f.halfTexels ? static_cast<void*>(rgba16f) : static_cast<void*>(rgba8);
+      if(astc_helpers::unpack_block(block, logicalBlock, f.blockWidth, f.blockHeight)
+         && astc_helpers::decode_block(logicalBlock, out, f.blockWidth, f.blockHeight, mode))
+      {
+        return;
+      }
+      // Magenta
+      for(uint32_t i = 0; i < numTexels; i++)
+      {
+        if(f.halfTexels)
+        {
+          rgba16f[4 * i + 0] = rgba16f[4 * i + 2] = rgba16f[4 * i + 3] = glm::packHalf1x16(1.0f);
+          rgba16f[4 * i + 1]                                           = glm::packHalf1x16(0.0f);
+        }
+        else
+        {
+          rgba8[4 * i + 0] = rgba8[4 * i + 2] = rgba8[4 * i + 3] = 255;
+          rgba8[4 * i + 1]                                       = 0;
+        }
+      }
+      return;
+    }
+  }
+  memcpy(rgba8, pixels, 4 * size_t(numTexels));
+}
+
+// The conversions decodeImage() documents between its decode targets.
+uint16_t unorm8ToHalf(uint8_t value)
+{
+  return glm::packHalf1x16(float(value) / 255.0f);
+}
+
+uint8_t halfToUnorm8(uint16_t value)
+{
+  const float f = glm::unpackHalf1x16(value);
+  return std::isnan(f) ? 0 : uint8_t(std::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Decodes a random width x height image in each target and with 1 and all
+// threads, and compares every texel against the reference decode of its
+// block.
+void testFormat(const FormatCase& f, uint32_t width, uint32_t height)
+{
+  const uint32_t blocksX = (width + f.blockWidth - 1) / f.blockWidth;
+  const uint32_t blocksY = (height + f.blockHeight - 1) / f.blockHeight;
+  CHECK(texture_decode::isDecodeSupported(f.format));
+  CHECK(texture_decode::encodedSizeBytes(f.format, width, height) == size_t(blocksX) * blocksY * f.blockBytes);
+
+  std::vector<char> encoded(size_t(blocksX) * blocksY * f.blockBytes);
+  for(size_t b = 0; b < size_t(blocksX) * blocksY; b++)
+  {
+    makeBlock(f, reinterpret_cast<uint8_t*>(encoded.data()) + b * f.blockBytes);
+  }
+
+  for(texture_decode::DecodeTarget target : {texture_decode::DecodeTarget::eRGBA8, texture_decode::DecodeTarget::eRGBA16F})
+  {
+    std::vector<char> decoded[2];
+    for(uint32_t threads = 0; threads < 2; threads++)
+    {
+      decoded[threads].resize(texture_decode::decodedSizeBytes(target, width, height));
+      const texture_decode::ErrorWithText error =
+          texture_decode::decodeImage(f.format, width, height, encoded, target, decoded[threads], threads == 0 ? 1 : 0);
+      if(!CHECK(!error.has_value()))
+      {
+        LOGW("%s: %s\n", f.name, error->c_str());
+        return;
+      }
+    }
+    CHECK(decoded[0] == decoded[1]);
+
+    uint32_t mismatches = 0;
+    for(uint32_t by = 0; by < blocksY; by++)
+    {
+      for(uint32_t bx = 0; bx < blocksX; bx++)
+      {
+        const uint8_t* block = reinterpret_cast<const uint8_t*>(encoded.data()) + (size_t(by) * blocksX + bx) * f.blockBytes;
+        uint8_t        rgba8[4 * 12 * 12]   = {};
+        uint16_t       rgba16f[4 * 12 * 12] = {};
+        bool           compareRGB           = true;
+        referenceDecode(f, block, rgba8, rgba16f, compareRGB);
+        for(uint32_t y = 0; y < f.blockHeight && by * f.blockHeight + y < height; y++)
+        {
+          for(uint32_t x = 0; x < f.blockWidth && bx * f.blockWidth + x < width; x++)
+          {
+            const uint32_t i     = y * f.blockWidth + x;
+            const size_t   texel = size_t(by * f.blockHeight + y) * width + (bx * f.blockWidth + x);
+            for(uint32_t c = (compareRGB ? 0 : 3); c < 4; c++)
+            {
+              bool equal = false;
+              if(target == texture_decode::DecodeTarget::eRGBA8)
+              {
+                const uint8_t expected = f.halfTexels ? halfToUnorm8(rgba16f[4 * i + c]) : rgba8[4 * i + c];
+                equal                  = uint8_t(decoded[0][4 * texel + c]) == expected;
+              }
+              else
+              {
+                const uint16_t expected = f.halfTexels ? rgba16f[4 * i + c] : unorm8ToHalf(rgba8[4 * i + c]);
+                uint16_t       actual   = 0;
+                memcpy(&actual, decoded[0].data() + 8 * texel + 2 * c, sizeof(actual));
+                equal = actual == expected;
+              }
+              mismatches += equal ? 0 : 1;
+            }
+          }
+        }
+      }
+    }
+    if(!CHECK(mismatches == 0))
+    {
+      LOGW("%s, %s: %u values differed from the reference decoder\n", f.name,
+           target == texture_decode::DecodeTarget::eRGBA8 ? "RGBA8" : "RGBA16F", mismatches);
+    }
+  }
+}
+
+struct KnownAnswerCase
+{
+  VkFormat                  format;
+  const char*               name;
+  uint32_t                  blockWidth;
+  uint32_t                  blockHeight;
+  std::span<const uint8_t>  blocks;
+  std::span<const uint8_t>  texelsRGBA8;   // For formats that decode to 8 bits
+  std::span<const uint16_t> texelsRGB16F;  // For BC6H
+};
+
+// Decodes each list of known-answer blocks as a row of blocks in both
+// targets, and compares with the known texels; in the other target, with
+// the conversions decodeImage() documents.
+void testKnownAnswers()
+{
+  using namespace known_answers;
+  const KnownAnswerCase cases[] = {
+      {VK_FORMAT_BC7_UNORM_BLOCK, "BC7", 4, 4, kBC7Blocks, kBC7Texels, {}},
+      {VK_FORMAT_BC6H_UFLOAT_BLOCK, "BC6H UFLOAT", 4, 4, kBC6HUnsignedBlocks, {}, kBC6HUnsignedTexels},
+      {VK_FORMAT_BC6H_SFLOAT_BLOCK, "BC6H SFLOAT", 4, 4, kBC6HSignedBlocks, {}, kBC6HSignedTexels},
+      {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, "ASTC 4x4 UNORM", 4, 4, kASTC4x4Blocks, kASTC4x4Texels, {}},
+      {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, "ASTC 6x6 UNORM", 6, 6, kASTC6x6Blocks, kASTC6x6Texels, {}},
+      {VK_FORMAT_ASTC_8x5_SRGB_BLOCK, "ASTC 8x5 SRGB", 8, 5, kASTC8x5Blocks, kASTC8x5Texels, {}},
+      {VK_FORMAT_ASTC_12x12_UNORM_BLOCK, "ASTC 12x12 UNORM", 12, 12, kASTC12x12Blocks, kASTC12x12Texels, {}},
+  };
+  for(const KnownAnswerCase& c : cases)
+  {
+    const uint32_t        width  = uint32_t(c.blocks.size() / 16) * c.blockWidth;
+    const uint32_t        height = c.blockHeight;
+    const size_t          texels = size_t(width) * height;
+    std::span<const char> encoded(reinterpret_cast<const char*>(c.blocks.data()), c.blocks.size());
+    CHECK(c.texelsRGBA8.size() == texels * 4 || c.texelsRGB16F.size() == texels * 3);
+
+    for(texture_decode::DecodeTarget target : {texture_decode::DecodeTarget::eRGBA8, texture_decode::DecodeTarget::eRGBA16F})
+    {
+      std::vector<char> decoded(texture_decode::decodedSizeBytes(target, width, height));
+      if(!CHECK(!texture_decode::decodeImage(c.format, width, height, encoded, target, decoded).has_value()))
+      {
+        continue;
+      }
+      uint32_t mismatches = 0;
+      for(size_t i = 0; i < texels; i++)
+      {
+        for(uint32_t ch = 0; ch < 4; ch++)
+        {
+          bool equal = false;
+          if(c.texelsRGB16F.empty())
+          {
+            const uint8_t expected = c.texelsRGBA8[4 * i + ch];
+            if(target == texture_decode::DecodeTarget::eRGBA8)
+            {
+              equal = uint8_t(decoded[4 * i + ch]) == expected;
+            }
+            else
+            {
+              uint16_t actual = 0;
+              memcpy(&actual, decoded.data() + 8 * i + 2 * ch, sizeof(actual));
+              equal = actual == unorm8ToHalf(expected);
+            }
+          }
+          else
+          {
+            const uint16_t expected = (ch < 3) ? c.texelsRGB16F[3 * i + ch] : glm::packHalf1x16(1.0f);
+            if(target == texture_decode::DecodeTarget::eRGBA8)
+            {
+              equal = uint8_t(decoded[4 * i + ch]) == halfToUnorm8(expected);
+            }
+            else
+            {
+              uint16_t actual = 0;
+              memcpy(&actual, decoded.data() + 8 * i + 2 * ch, sizeof(actual));
+              equal = actual == expected;
+            }
+          }
+          mismatches += equal ? 0 : 1;
+        }
+      }
+      if(!CHECK(mismatches == 0))
+      {
+        LOGW("%s, %s: %u values differed from the known answers\n", c.name,
+             target == texture_decode::DecodeTarget::eRGBA8 ? "RGBA8" : "RGBA16F", mismatches);
+      }
+    }
+  }
+}
+
+void testErrors()
+{
+  CHECK(!texture_decode::isDecodeSupported(VK_FORMAT_R8G8B8A8_UNORM));
+  CHECK(texture_decode::encodedSizeBytes(VK_FORMAT_R8G8B8A8_UNORM, 4, 4) == 0);
+
+  std::vector<char> encoded(8 * 4);
+  std::vector<char> decoded(4 * 8 * 8);
+  const VkFormat    format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+  CHECK(!texture_decode::decodeImage(format, 8, 8, encoded, texture_decode::DecodeTarget::eRGBA8, decoded).has_value());
+  CHECK(texture_decode::decodeImage(format, 8, 12, encoded, texture_decode::DecodeTarget::eRGBA8, decoded).has_value());
+  CHECK(texture_decode::decodeImage(format, 8, 8, encoded, texture_decode::DecodeTarget::eRGBA16F, decoded).has_value());
+  CHECK(texture_decode::decodeImage(VK_FORMAT_R8G8B8A8_UNORM, 8, 8, encoded, texture_decode::DecodeTarget::eRGBA8, decoded)
+            .has_value());
+}
+
+std::string writeKTX2(nv_ktx::KTXImage& image, const nv_ktx::WriteSettings& writeSettings)
+{
+  std::ostringstream          stream;
+  const nv_ktx::ErrorWithText error = image.writeKTX2Stream(stream, writeSettings);
+  if(!CHECK(!error.has_value()))
+  {
+    LOGW("Writing a KTX2 file failed: %s\n", error->c_str());
+  }
+  return stream.str();
+}
+
+// Checks that `decodedImage` is `astcImage` decoded with texture_decode.
+void checkDecodedImage(const nv_ktx::KTXImage& astcImage, const nv_ktx::KTXImage& decodedImage, uint32_t firstMip, uint32_t numMips)
+{
+  CHECK(decodedImage.format == (astcImage.is_srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM));
+  for(uint32_t mip = firstMip; mip < firstMip + numMips; mip++)
+  {
+    const uint32_t        width  = std::max(1u, astcImage.mip_0_width >> mip);
+    const uint32_t        height = std::max(1u, astcImage.mip_0_height >> mip);
+    std::vector<char>     expected(texture_decode::decodedSizeBytes(texture_decode::DecodeTarget::eRGBA8, width, height));
+    std::span<const char> astc = astcImage.subresourceBytes(mip, 0, 0);
+    CHECK(!texture_decode::decodeImage(astcImage.format, width, height, astc, texture_decode::DecodeTarget::eRGBA8, expected)
+               .has_value());
+    const std::span<const char> actual = decodedImage.subresourceBytes(mip, 0, 0);
+    if(!CHECK(actual.size() == expected.size() && std::equal(actual.begin(), actual.end(), expected.begin())))
+    {
+      LOGW("Mip %u of the image nv_ktx decoded differed from texture_decode's\n", mip);
+    }
+  }
+}
+
+void testKTXFallback()
+{
+  // Make an ASTC 4x4 image by transcoding UASTC.
+  nv_ktx::KTXImage source;
+  source.format       = VK_FORMAT_B8G8R8A8_UNORM;
+  source.mip_0_width  = 37;
+  source.mip_0_height = 21;
+  source.is_srgb      = false;
+  source.allocate(3, 0, 1);
+  for(uint32_t mip = 0; mip < 3; mip++)
+  {
+    const uint32_t     width  = std::max(1u, source.mip_0_width >> mip);
+    const uint32_t     height = std::max(1u, source.mip_0_height >> mip);
+    std::vector<char>& pixels = source.subresource(mip, 0, 0);
+    pixels.resize(size_t(width) * height * 4);
+    for(size_t i = 0; i < pixels.size(); i++)
+    {
+      pixels[i] = char((i % 4 == 3) ? 255 : nextRandom() >> 24);
+    }
+  }
+  nv_ktx::WriteSettings uastcSettings;
+  uastcSettings.encode_rgba8_to_format = nv_ktx::EncodeRGBA8ToFormat::UASTC;
+  uastcSettings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+  const std::string uastcFile          = writeKTX2(source, uastcSettings);
+
+  nv_ktx::ReadSettings astcSettings;
+  astcSettings.device_supports_astc = true;
+  nv_ktx::KTXImage astcImage;
+  std::istringstream uastcStream(uastcFile);
+  if(!CHECK(!astcImage.readFromStream(uastcStream, astcSettings).has_value())
+     || !CHECK(astcImage.format == VK_FORMAT_ASTC_4x4_UNORM_BLOCK))
+  {
+    return;
+  }
+
+  // Some of those blocks should be valid, and decode exactly as Basis
+  // Universal decodes them.
+  std::vector<char> decoded(texture_decode::decodedSizeBytes(texture_decode::DecodeTarget::eRGBA8, 37, 21));
+  CHECK(!texture_decode::decodeImage(astcImage.format, 37, 21, astcImage.subresourceBytes(0, 0, 0),
+                                     texture_decode::DecodeTarget::eRGBA8, decoded)
+             .has_value());
+  uint32_t magentaTexels = 0;
+  for(size_t i = 0; i < decoded.size(); i += 4)
+  {
+    magentaTexels += (uint8_t(decoded[i]) == 255 && decoded[i + 1] == 0 && uint8_t(decoded[i + 2]) == 255) ? 1 : 0;
+  }
+  CHECK(magentaTexels < 37 * 21);
+
+  // Write it as plain and Zstandard-supercompressed ASTC files.
+  nv_ktx::WriteSettings plainSettings;
+  nv_ktx::WriteSettings zstdSettings;
+  zstdSettings.supercompression = nv_ktx::WriteSupercompressionType::ZSTD;
+  for(const nv_ktx::WriteSettings& writeSettings : {plainSettings, zstdSettings})
+  {
+    const std::string astcFile = writeKTX2(astcImage, writeSettings);
+
+    nv_ktx::ReadSettings readSettings;
+    readSettings.decode_astc_without_device_support = true;
+    for(uint32_t numThreads : {1u, 0u})
+    {
+      readSettings.num_threads = numThreads;
+      nv_ktx::KTXImage   fromStream;
+      std::istringstream stream(astcFile);
+      CHECK(!fromStream.readFromStream(stream, readSettings).has_value());
+      checkDecodedImage(astcImage, fromStream, 0, 3);
+
+      nv_ktx::KTXImage fromView;
+      CHECK(!fromView.readFromMemoryView({reinterpret_cast<const std::byte*>(astcFile.data()), astcFile.size()}, readSettings)
+                 .has_value());
+      checkDecodedImage(astcImage, fromView, 0, 3);
+    }
+
+    // KTXLevelReader reports the decoded format before reading any mips.
+    nv_ktx::KTXLevelReader levelReader;
+    std::istringstream     stream(astcFile);
+    CHECK(!levelReader.open(stream, readSettings).has_value());
+    CHECK(levelReader.image.format == VK_FORMAT_R8G8B8A8_UNORM);
+    CHECK(!levelReader.readMips(1, 2).has_value());
+    checkDecodedImage(astcImage, levelReader.image, 1, 2);
+    CHECK(!levelReader.readMips(0, 1).has_value());
+    checkDecodedImage(astcImage, levelReader.image, 0, 1);
+
+    // Nothing is decoded if the device supports ASTC, or by default.
+    for(bool deviceSupportsASTC : {true, false})
+    {
+      nv_ktx::ReadSettings keepSettings;
+      keepSettings.device_supports_astc               = deviceSupportsASTC;
+      keepSettings.decode_astc_without_device_support = deviceSupportsASTC;
+      nv_ktx::KTXImage   kept;
+      std::istringstream keptStream(astcFile);
+      CHECK(!kept.readFromStream(keptStream, keepSettings).has_value());
+      CHECK(kept.format == VK_FORMAT_ASTC_4x4_UNORM_BLOCK);
+    }
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  for(const FormatCase& f : kFormats)
+  {
+    // Sizes that aren't multiples of any block size, and a single texel.
+    testFormat(f, 61, 37);
+    testFormat(f, 1, 1);
+  }
+  testKnownAnswers();
+  testErrors();
+  testKTXFallback();
+  return test_check::result();
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the TLAS update helpers of nvvk/tlas_instances.hpp:
+
+* nvvk::updateTlasInstances() writes and marks exactly the instances that
+  differ from the previous ones, calls onChanged() once for each of them
+  (from worker threads), and only ever sets bits of `dirty`.
+* nvvk::TlasRefitTracker's degradation estimate: 0 after a build and for
+  instances that stay or move back, the added surface area of the union of
+  built and current bounds for translated, rotated and scaled instances,
+  relative to the built area, and the refit-or-rebuild decision of an
+  animation that drifts away, as nvvkgltf::SceneRtx::updateTopLevelAS()
+  makes it.
+
+-----------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "nvvk/tlas_instances.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+bool nearlyEqual(float a, float b)
+{
+  return std::abs(a - b) <= 1e-5f * std::max(1.0f, std::abs(b));
+}
+
+// A scene node per instance; instances are made from them
+struct Node
+{
+  float    x       = 0.0f;
+  uint32_t blas    = 0;
+  bool     visible = true;
+};
+
+void makeInstance(const Node& node, VkAccelerationStructureInstanceKHR& instance)
+{
+  if(!node.visible)
+  {
+    return;  // Stays zeroed
+  }
+  instance.transform.matrix[0][0]         = 1.0f;
+  instance.transform.matrix[1][1]         = 1.0f;
+  instance.transform.matrix[2][2]         = 1.0f;
+  instance.transform.matrix[0][3]         = node.x;
+  instance.accelerationStructureReference = 0x10000 + node.blas * 256;
+  instance.mask                           = 0xFF;
+  instance.instanceCustomIndex            = node.blas;
+}
+
+void testUpdateTlasInstances()
+{
+  // More than a batch of 2048, so that several threads take part
+  const size_t      count = 5000;
+  std::vector<Node> nodes(count);
+  uint32_t          rng  = 1;
+  auto              next = [&rng]() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+  };
+  for(size_t i = 0; i < count; i++)
+  {
+    nodes[i] = {float(i), uint32_t(next() % 16), next() % 10 != 0};
+  }
+
+  std::vector<VkAccelerationStructureInstanceKHR> instances(count);
+  std::vector<std::atomic<uint32_t>>              changedCalls(count);
+  auto                                            update = [&](nvutils::BitArray& dirty) {
+    for(std::atomic<uint32_t>& calls : changedCalls)
+    {
+      calls = 0;
+    }
+    nvvk::updateTlasInstances(
+        instances, dirty, [&](uint64_t i, VkAccelerationStructureInstanceKHR& instance) { makeInstance(nodes[i], instance); },
+        [&](uint64_t i) { changedCalls[i]++; });
+  };
+  auto matchesNodes = [&]() {
+    for(size_t i = 0; i < count; i++)
+    {
+      VkAccelerationStructureInstanceKHR expected{};
+      makeInstance(nodes[i], expected);
+      if(memcmp(&expected, &instances[i], sizeof(expected)) != 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // From zeroed instances, all but the hidden ones change
+  {
+    nvutils::BitArray dirty(count);
+    update(dirty);
+    CHECK(matchesNodes());
+    bool ok = true;
+    for(size_t i = 0; i < count; i++)
+    {
+      ok = ok && dirty.getBit(i) == nodes[i].visible && changedCalls[i] == (nodes[i].visible ? 1u : 0u);
+    }
+    CHECK(ok);
+  }
+
+  // Nothing changed
+  {
+    nvutils::BitArray dirty(count);
+    update(dirty);
+    CHECK(dirty.countSetBits() == 0);
+  }
+
+  // Change some nodes; some changes don't alter their instance
+  for(uint32_t round = 0; round < 5; round++)
+  {
+    for(uint32_t c = 0; c < 300; c++)
+    {
+      const size_t i = next() % count;
+      switch(next() % 4)
+      {
+        case 0:
+          nodes[i].x += 1.0f;
+          break;
+        case 1:
+          nodes[i].blas = (nodes[i].blas + 1) % 16;
+          break;
+        case 2:
+          nodes[i].visible = !nodes[i].visible;
+          break;
+        default:
+          break;  // Touched, but the same
+      }
+    }
+    // Changes can cancel out, e.g. hiding and showing again
+    std::vector<bool> changed(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      VkAccelerationStructureInstanceKHR expected{};
+      makeInstance(nodes[i], expected);
+      changed[i] = memcmp(&expected, &instances[i], sizeof(expected)) != 0;
+    }
+
+    // Bits that were already set stay set
+    nvutils::BitArray dirty(count);
+    dirty.enableBit(0);
+    dirty.enableBit(count - 1);
+    update(dirty);
+    CHECK(matchesNodes());
+    bool ok = true;
+    for(size_t i = 0; i < count; i++)
+    {
+      const bool preset = (i == 0 || i == count - 1);
+      ok = ok && dirty.getBit(i) == (changed[i] || preset) && changedCalls[i] == (changed[i] ? 1u : 0u);
+    }
+    CHECK(ok);
+  }
+
+  // The overload without onChanged
+  {
+    nodes[7].x += 0.5f;
+    nvutils::BitArray dirty(count);
+    nvvk::updateTlasInstances(instances, dirty, [&](uint64_t i, VkAccelerationStructureInstanceKHR& instance) {
+      makeInstance(nodes[i], instance);
+    });
+    CHECK(dirty.countSetBits() == 1 && dirty.getBit(7));
+    CHECK(matchesNodes());
+  }
+}
+
+void testTlasRefitTracker()
+{
+  const glm::vec3 center(0.0f);
+  const glm::vec3 halfExtent(1.0f);  // Surface area 24
+  const glm::mat4 identity(1.0f);
+
+  auto translation = [](float x) { return glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, 0.0f)); };
+
+  nvvk::TlasRefitTracker tracker;
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // 4 unit boxes side by side, 96 surface area in all
+  tracker.init(4);
+  CHECK(tracker.size() == 4);
+  for(size_t i = 0; i < 4; i++)
+  {
+    tracker.setBuilt(i, translation(4.0f * float(i)), center, halfExtent);
+  }
+  tracker.commitBuild();
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // Refitting where they were built adds nothing
+  tracker.setRefit(1, translation(4.0f), center, halfExtent);
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // Moving by 2 along x: the union is 4 x 2 x 2, surface area 40, i.e. 16 more
+  tracker.setRefit(0, translation(2.0f), center, halfExtent);
+  CHECK(nearlyEqual(tracker.getDegradation(), 16.0f / 96.0f));
+
+  // Growth replaces that of the previous refit rather than adding up
+  tracker.setRefit(0, translation(2.0f), center, halfExtent);
+  CHECK(nearlyEqual(tracker.getDegradation(), 16.0f / 96.0f));
+
+  // Moving inside the built bounds (a smaller box) adds nothing
+  tracker.setRefit(2, translation(8.5f), center, glm::vec3(0.5f));
+  CHECK(nearlyEqual(tracker.getDegradation(), 16.0f / 96.0f));
+
+  // Rotating by 45 degrees around z in place: half extent (sqrt 2, sqrt 2, 1)
+  const float rotatedArea = 8.0f * (2.0f + 2.0f * std::sqrt(2.0f));
+  tracker.setRefit(3, translation(12.0f) * glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), glm::vec3(0, 0, 1)),
+                   center, halfExtent);
+  CHECK(nearlyEqual(tracker.getDegradation(), (16.0f + rotatedArea - 24.0f) / 96.0f));
+
+  // Moving back stops counting
+  tracker.setRefit(0, translation(0.0f), center, halfExtent);
+  tracker.setRefit(3, translation(12.0f), center, halfExtent);
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // Scaling by 2 and an off-center object-space box
+  tracker.setRefit(1, translation(4.0f) * glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), center, halfExtent);
+  CHECK(nearlyEqual(tracker.getDegradation(), (96.0f - 24.0f) / 96.0f));
+  tracker.setRefit(1, translation(3.0f), glm::vec3(1.0f, 0.0f, 0.0f), halfExtent);
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // A rebuild resets it
+  tracker.setRefit(0, translation(100.0f), center, halfExtent);
+  CHECK(tracker.getDegradation() > 1.0f);
+  tracker.setBuilt(0, translation(100.0f), center, halfExtent);
+  tracker.commitBuild();
+  CHECK(tracker.getDegradation() == 0.0f);
+
+  // Nothing built with an area: any growth counts as fully degraded
+  tracker.init(1);
+  tracker.setBuilt(0, identity, center, glm::vec3(0.0f));
+  tracker.commitBuild();
+  CHECK(tracker.getDegradation() == 0.0f);
+  tracker.setRefit(0, identity, center, halfExtent);
+  CHECK(tracker.getDegradation() == 1.0f);
+
+  tracker.deinit();
+  CHECK(tracker.size() == 0 && tracker.getDegradation() == 0.0f);
+
+  // An animation: 100 boxes, a tenth of which drift by 0.25 per frame. With
+  // SceneRtx's default threshold of 0.5, the TLAS is refit for a while, then
+  // rebuilt, and the degradation starts from 0 again.
+  {
+    const size_t       count     = 100;
+    const float        threshold = 0.5f;
+    std::vector<float> x(count);
+    tracker.init(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      x[i] = 4.0f * float(i);
+      tracker.setBuilt(i, translation(x[i]), center, halfExtent);
+    }
+    tracker.commitBuild();
+
+    uint32_t rebuilds       = 0;
+    uint32_t refitsInARow   = 0;
+    uint32_t maxRefitsInRow = 0;
+    float    previous       = 0.0f;
+    bool     monotonic      = true;
+    for(uint32_t frame = 0; frame < 200; frame++)
+    {
+      for(size_t i = 0; i < count; i += 10)
+      {
+        x[i] += 0.25f;
+        tracker.setRefit(i, translation(x[i]), center, halfExtent);
+      }
+      const float degradation = tracker.getDegradation();
+      if(degradation > threshold)
+      {
+        rebuilds++;
+        refitsInARow = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+          tracker.setBuilt(i, translation(x[i]), center, halfExtent);
+        }
+        tracker.commitBuild();
+        CHECK(tracker.getDegradation() == 0.0f);
+        previous = 0.0f;
+      }
+      else
+      {
+        monotonic = monotonic && degradation > previous;
+        previous  = degradation;
+        refitsInARow++;
+        maxRefitsInRow = std::max(maxRefitsInRow, refitsInARow);
+      }
+    }
+    CHECK(monotonic);
+    // A box moved by d has a union of surface area 24 + 8 d, so the 10
+    // moving boxes add 20 per frame; refits stop at half of 2400.
+    CHECK(maxRefitsInRow == 60);
+    CHECK(rebuilds == 3);
+  }
+}
+
+}  // namespace
+
+int main()
+{
+  testUpdateTlasInstances();
+  testTlasRefitTracker();
+  return test_check::result();
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks the CPU tonemapper of nvshaders_host (tonemapper_cpu.hpp) against the
+scalar functions of tonemap_functions.h.slang, for each tonemapping method,
+with the default settings and with graded ones (exposure, white balance,
+contrast, brightness, saturation, vignette, auto-exposure, center metering),
+on an image whose width isn't a multiple of 4:
+
+* The float output is within 1e-5 of shaderio::applyTonemap()'s, which the
+  vector pow(), log2() and exp2() limit. Where applyTonemap() takes pow() of
+  a negative value and gives NaN, the output must be finite.
+* RGBA8 values are off by 1 at most, in fewer than 0.1% of them, and are
+  exactly the float output converted to UNORM8.
+* Alpha passes through, and the output doesn't depend on the number of
+  threads or on tonemapping in place, bit for bit.
+* The histogram is exactly the one inputToHistogramBucket() and
+  centerMeteringWeight() give, and computeExposureHistogram() builds the
+  same.
+
+Then, that computeExposureLuminance() of a uniform image is its luminance to
+1.5 buckets in mean and median mode, and adaptExposureLuminance()'s limits.
+
+These compare with the C++ build of the shader functions; comparing with
+the shaders on a device is not part of this test.
+
+-----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "nvshaders/slang_types.h"
+#include "nvshaders/tonemap_functions.h.slang"
+#include "nvshaders_host/tonemapper_cpu.hpp"
+
+#include "test_check.hpp"
+
+namespace {
+
+// Hues across, -10 to +10 EV down, with noise and a few black pixels
+std::vector<float> makeImage(uint32_t width, uint32_t height)
+{
+  std::vector<float> rgba(size_t(width) * height * 4);
+  uint32_t           rng = 1234;
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      rng               = rng * 1664525u + 1013904223u;
+      const float noise = float(rng >> 8) / 16777216.0f;
+      const float ev    = -10.0f + 20.0f * (float(y) + noise) / float(height);
+      const float hue   = 6.2831853f * float(x) / float(width);
+      const float scale = std::exp2(ev);
+      float*      texel = &rgba[(size_t(y) * width + x) * 4];
+      const bool  black = (rng >> 4) % 97 == 0;
+      texel[0]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue));
+      texel[1]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue - 2.0943951f));
+      texel[2]          = black ? 0.0f : scale * (0.55f + 0.45f * std::cos(hue + 2.0943951f));
+      texel[3]          = float(x % 256) / 255.0f;
+    }
+  }
+  return rgba;
+}
+
+uint8_t toUnorm8(float value)
+{
+  return uint8_t(std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+// The Tonemap shader with the scalar functions
+void tonemapScalar(const float* rgba, uint32_t width, uint32_t height, shaderio::TonemapperData tm, float exposureLuminance, float* outRgba)
+{
+  tm.inputMatrix = shaderio::getColorCorrectionMatrix(tm.exposure, tm.temperature, tm.tint);
+  const float exposureMultiplier = 0.18f / std::max(0.001f, exposureLuminance);
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const float* texel = rgba + (size_t(y) * width + x) * 4;
+      glm::vec3    color(texel[0], texel[1], texel[2]);
+      if(tm.autoExposure == 1)
+      {
+        color *= exposureMultiplier;
+      }
+      color      = shaderio::applyTonemap(tm, color, glm::vec2(float(x), float(y)), glm::vec2(float(width), float(height)));
+      float* out = outRgba + (size_t(y) * width + x) * 4;
+      out[0]     = color.x;
+      out[1]     = color.y;
+      out[2]     = color.z;
+      out[3]     = texel[3];
+    }
+  }
+}
+
+// The Histogram shader with the scalar functions
+nvshaders::ExposureHistogram histogramScalar(const float* rgba, uint32_t width, uint32_t height, const shaderio::TonemapperData& tm)
+{
+  nvshaders::ExposureHistogram histogram{};
+  for(uint32_t y = 0; y < height; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+    {
+      const float*    texel  = rgba + (size_t(y) * width + x) * 4;
+      const glm::vec2 uv     = glm::vec2(float(x), float(y)) / glm::vec2(float(width), float(height));
+      const float     weight = shaderio::centerMeteringWeight(tm, uv, float(width) / float(height));
+      histogram[shaderio::inputToHistogramBucket(tm, glm::vec3(texel[0], texel[1], texel[2]))] += uint32_t(weight * 255.0f);
+    }
+  }
+  return histogram;
+}
+
+void testTonemapImage()
+{
+  const uint32_t           width = 253, height = 200;
+  const std::vector<float> image  = makeImage(width, height);
+  const size_t             values = image.size();
+
+  shaderio::TonemapperData graded;
+  graded.exposure             = 1.5f;
+  graded.temperature          = 5000.0f;
+  graded.tint                 = -0.005f;
+  graded.contrast             = 1.1f;
+  graded.brightness           = 0.9f;
+  graded.saturation           = 1.2f;
+  graded.vignette             = 0.2f;
+  graded.autoExposure         = 1;
+  graded.enableCenterMetering = 1;
+
+  std::vector<float>   reference(values), output(values), serial(values), inPlace(values);
+  std::vector<uint8_t> unorm(values);
+  for(int method = 0; method < shaderio::ToneMapMethod::eCount; method++)
+  {
+    for(const bool isGraded : {false, true})
+    {
+      shaderio::TonemapperData tm = isGraded ? graded : shaderio::TonemapperData{};
+      tm.method                   = method;
+      const float luminance       = isGraded ? 0.5f : 1.0f;
+
+      tonemapScalar(image.data(), width, height, tm, luminance, reference.data());
+      nvshaders::ExposureHistogram histogram{};
+      nvshaders::tonemapImage(image.data(), width, height, tm, luminance, output.data(), &histogram);
+      nvshaders::tonemapImage(image.data(), width, height, tm, luminance, unorm.data());
+
+      float  maxError         = 0.0f;
+      bool   finite           = true;
+      bool   unormConsistent  = true;
+      int    maxUnormError    = 0;
+      size_t unormMismatches  = 0;
+      bool   alphaPassesThrough = true;
+      for(size_t i = 0; i < values; i++)
+      {
+        finite          = finite && std::isfinite(output[i]);
+        unormConsistent = unormConsistent && unorm[i] == toUnorm8(output[i]);
+        if(i % 4 == 3)
+        {
+          alphaPassesThrough = alphaPassesThrough && memcmp(&output[i], &image[i], sizeof(float)) == 0;
+        }
+        if(!std::isfinite(reference[i]))
+        {
+          continue;  // pow() of a negative value in the shader
+        }
+        maxError            = std::max(maxError, std::abs(output[i] - reference[i]));
+        const int unormError = std::abs(int(unorm[i]) - int(toUnorm8(reference[i])));
+        maxUnormError        = std::max(maxUnormError, unormError);
+        unormMismatches += (unormError != 0) ? 1 : 0;
+      }
+      CHECK(finite);
+      CHECK(maxError <= 1e-5f);
+      CHECK(maxUnormError <= 1 && unormMismatches * 1000 < values);
+      CHECK(unormConsistent);
+      CHECK(alphaPassesThrough);
+
+      CHECK(histogram == histogramScalar(image.data(), width, height, tm));
+      nvshaders::ExposureHistogram histogramOnly{};
+      nvshaders::computeExposureHistogram(image.data(), width, height, tm, histogramOnly);
+      CHECK(histogramOnly == histogram);
+
+      nvshaders::ExposureHistogram serialHistogram{};
+      nvshaders::tonemapImage(image.data(), width, height, tm, luminance, serial.data(), &serialHistogram, 1);
+      CHECK(memcmp(serial.data(), output.data(), values * sizeof(float)) == 0 && serialHistogram == histogram);
+
+      inPlace = image;
+      nvshaders::tonemapImage(inPlace.data(), width, height, tm, luminance, inPlace.data());
+      CHECK(memcmp(inPlace.data(), output.data(), values * sizeof(float)) == 0);
+    }
+  }
+
+  // Inactive: the pixels pass through
+  shaderio::TonemapperData inactive;
+  inactive.isActive = 0;
+  nvshaders::tonemapImage(image.data(), width, height, inactive, 1.0f, output.data());
+  CHECK(memcmp(output.data(), image.data(), values * sizeof(float)) == 0);
+
+  // Empty images
+  nvshaders::ExposureHistogram histogram{};
+  nvshaders::tonemapImage(image.data(), 0, height, graded, 1.0f, output.data(), &histogram);
+  nvshaders::computeExposureHistogram(image.data(), width, 0, graded, histogram);
+  CHECK(histogram == nvshaders::ExposureHistogram{});
+}
+
+void testExposure()
+{
+  // A uniform image's luminance, in mean and median mode; as in the
+  // AutoExposure shader, the mean lands on the start of the pixels' bucket,
+  // and the median on the center of the one before.
+  for(uint32_t averageMode : {0u, 1u})
+  {
+    for(float luminance : {0.01f, 0.18f, 3.0f, 100.0f})
+    {
+      const std::vector<float> uniform(size_t(64) * 64 * 4, luminance);
+      shaderio::TonemapperData tm;
+      tm.averageMode = averageMode;
+      nvshaders::ExposureHistogram histogram{};
+      nvshaders::computeExposureHistogram(uniform.data(), 64, 64, tm, histogram);
+      const float target  = nvshaders::computeExposureLuminance(histogram, tm);
+      const float buckets = std::abs(std::log2(target / luminance)) / ((tm.evMaxValue - tm.evMinValue) / 254.0f);
+      CHECK(buckets <= 1.5f);
+    }
+  }
+
+  CHECK(nvshaders::adaptExposureLuminance(0.5f, 2.0f, 0.0f) == 0.5f);
+  CHECK(std::abs(nvshaders::adaptExposureLuminance(0.5f, 2.0f, 100.0f) - 2.0f) < 1e-6f);
+  const float halfway = nvshaders::adaptExposureLuminance(0.5f, 2.0f, 1.0f);
+  CHECK(std::abs(halfway - 1.25f) < 1e-6f);
+}
+
+}  // namespace
+
+int main()
+{
+  testTonemapImage();
+  testExposure();
+  return test_check::result();
+}
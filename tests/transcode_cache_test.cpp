@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nv_ktx::TranscodeCache:
+* Lookups only succeed if the source size, digest, and output size all
+  match, and entries are evicted least recently used first.
+* Reading UASTC and ETC1S files through a cache gives the same subresources
+  as reading them without one, and hits on the second read.
+* Files with the same size and format but different contents don't share
+  entries.
+
+-----------------------------------------------------------------------------*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nvimageformats/nv_ktx.h"
+
+#include "test_check.hpp"
+
+namespace {
+
+uint32_t g_rng = 12345;
+
+uint32_t nextRandom()
+{
+  g_rng = g_rng * 1664525u + 1013904223u;
+  return g_rng;
+}
+
+nv_ktx::TranscodeCache::Key makeKey(uint64_t sourceSize, uint8_t firstDigestByte)
+{
+  nv_ktx::TranscodeCache::Key key;
+  key.source_size = sourceSize;
+  key.digest[0]   = firstDigestByte;
+  return key;
+}
+
+void testLookups()
+{
+  nv_ktx::TranscodeCache  cache(64);
+  const std::vector<char> data(16, 'x');
+  std::vector<char>       output(16);
+  cache.insert(makeKey(100, 1), data);
+  CHECK(cache.find(makeKey(100, 1), output));
+  CHECK(output == data);
+  // Same digest, different source size; different digest; different output size.
+  CHECK(!cache.find(makeKey(101, 1), output));
+  CHECK(!cache.find(makeKey(100, 2), output));
+  std::vector<char> largerOutput(17);
+  CHECK(!cache.find(makeKey(100, 1), largerOutput));
+  CHECK(cache.getHitCount() == 1 && cache.getMissCount() == 3);
+
+  // Keys whose digests differ only in their last byte are different keys.
+  nv_ktx::TranscodeCache::Key last = makeKey(100, 1);
+  last.digest[31]                  = 1;
+  CHECK(!cache.find(last, output));
+
+  // Fill the 64-byte cache; using key 1 makes key 2 the least recently used.
+  cache.insert(makeKey(100, 2), data);
+  cache.insert(makeKey(100, 3), data);
+  cache.insert(makeKey(100, 4), data);
+  CHECK(cache.find(makeKey(100, 1), output));
+  cache.insert(makeKey(100, 5), data);
+  CHECK(cache.getSizeBytes() == 64);
+  CHECK(!cache.find(makeKey(100, 2), output));
+  CHECK(cache.find(makeKey(100, 1), output));
+  CHECK(cache.find(makeKey(100, 5), output));
+
+  // Too large to cache.
+  std::vector<char> tooLarge(65);
+  cache.insert(makeKey(100, 6), tooLarge);
+  CHECK(!cache.find(makeKey(100, 6), tooLarge));
+  cache.clear();
+  CHECK(cache.getSizeBytes() == 0);
+}
+
+std::string writeRandomKTX2(nv_ktx::EncodeRGBA8ToFormat encoding, uint32_t width, uint32_t height)
+{
+  nv_ktx::KTXImage image;
+  image.format       = VK_FORMAT_B8G8R8A8_UNORM;
+  image.mip_0_width  = width;
+  image.mip_0_height = height;
+  image.allocate(1, 0, 1);
+  std::vector<char>& pixels = image.subresource(0, 0, 0);
+  pixels.resize(size_t(width) * height * 4);
+  for(char& c : pixels)
+  {
+    c = char(nextRandom() >> 24);
+  }
+  nv_ktx::WriteSettings settings;
+  settings.encode_rgba8_to_format = encoding;
+  settings.uastc_encoding_quality = nv_ktx::UASTCEncodingQuality::FASTEST;
+  std::ostringstream stream;
+  CHECK(!image.writeKTX2Stream(stream, settings).has_value());
+  return stream.str();
+}
+
+std::vector<char> readMip0(const std::string& file, nv_ktx::TranscodeCache* cache)
+{
+  nv_ktx::ReadSettings settings;
+  settings.transcode_cache = cache;
+  nv_ktx::KTXImage   image;
+  std::istringstream stream(file);
+  if(!CHECK(!image.readFromStream(stream, settings).has_value()))
+  {
+    return {};
+  }
+  return image.subresource(0, 0, 0);
+}
+
+void testReads(nv_ktx::EncodeRGBA8ToFormat encoding)
+{
+  const std::string fileA = writeRandomKTX2(encoding, 64, 48);
+  const std::string fileB = writeRandomKTX2(encoding, 64, 48);
+
+  nv_ktx::TranscodeCache  cache;
+  const std::vector<char> expectedA = readMip0(fileA, nullptr);
+  const std::vector<char> expectedB = readMip0(fileB, nullptr);
+  CHECK(expectedA != expectedB);
+
+  CHECK(readMip0(fileA, &cache) == expectedA);
+  CHECK(cache.getHitCount() == 0);
+  CHECK(readMip0(fileA, &cache) == expectedA);
+  CHECK(cache.getHitCount() == 1);
+  // Same size and format, different contents: a miss.
+  CHECK(readMip0(fileB, &cache) == expectedB);
+  CHECK(cache.getHitCount() == 1);
+  CHECK(readMip0(fileB, &cache) == expectedB);
+  CHECK(cache.getHitCount() == 2);
+}
+
+}  // namespace
+
+int main()
+{
+  testLookups();
+  testReads(nv_ktx::EncodeRGBA8ToFormat::UASTC);
+  testReads(nv_ktx::EncodeRGBA8ToFormat::ETC1S_RGBA);
+  return test_check::result();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025, NVIDIA CORPORATION.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*-----------------------------------------------------------------------------
+
+Checks nv_ktx::ZstdDictionary and ZstdDictionaryCache:
+* The ID of a fixed raw-content dictionary is pinned: files store it, so it
+  must not change between platforms, builds, or versions. The expected value
+  is the first 4 bytes of the data's SHA-256 digest, computed separately,
+  mapped into [32768, 2^32).
+* Changing a byte changes the ID; empty dictionaries don't load.
+* A KTX2 file written with a dictionary reads back through a cache that has
+  it, and doesn't read without one.
+
+-----------------------------------------------------------------------------*/
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nvimageformats/nv_ktx.h"
+
+#include "test_check.hpp"
+
+namespace {
+
+std::vector<char> makeDictionaryData()
+{
+  std::vector<char> data(4096);
+  for(size_t i = 0; i < data.size(); i++)
+  {
+    data[i] = char((i * 31 + i / 7) & 0xFF);
+  }
+  return data;
+}
+
+void testIDs()
+{
+  std::vector<char> data = makeDictionaryData();
+
+  // SHA-256 of `data` starts with 62c834f4, which is 1657287924;
+  // 32768 + 1657287924 % (2^32 - 32768) == 1657320692.
+  nv_ktx::ZstdDictionary dictionary;
+  CHECK(!dictionary.load(data).has_value());
+  CHECK(dictionary.getID() == 1657320692u);
+
+  nv_ktx::ZstdDictionary same;
+  CHECK(!same.load(data).has_value());
+  CHECK(same.getID() == dictionary.getID());
+
+  data[0] ^= 1;
+  nv_ktx::ZstdDictionary changed;
+  CHECK(!changed.load(data).has_value());
+  CHECK(changed.getID() == 3435239446u);
+
+  nv_ktx::ZstdDictionary empty;
+  CHECK(empty.load({}).has_value());
+  CHECK(empty.getID() == 0);
+}
+
+void testRoundTrip()
+{
+  auto dictionary = std::make_shared<nv_ktx::ZstdDictionary>();
+  CHECK(!dictionary->load(makeDictionaryData()).has_value());
+
+  nv_ktx::KTXImage image;
+  image.format       = VK_FORMAT_R8G8B8A8_UNORM;
+  image.mip_0_width  = 16;
+  image.mip_0_height = 16;
+  image.allocate(1, 1, 1);
+  std::vector<char>& pixels = image.subresource(0, 0, 0);
+  pixels.resize(16 * 16 * 4);
+  for(size_t i = 0; i < pixels.size(); i++)
+  {
+    pixels[i] = char((i * 31 + i / 7) & 0xFF);
+  }
+
+  nv_ktx::WriteSettings writeSettings;
+  writeSettings.supercompression = nv_ktx::WriteSupercompressionType::ZSTD;
+  writeSettings.zstd_dictionary  = dictionary.get();
+  std::ostringstream outStream;
+  CHECK(!image.writeKTX2Stream(outStream, writeSettings).has_value());
+  const std::string file = outStream.str();
+
+  nv_ktx::ZstdDictionaryCache dictionaries;
+  dictionaries.add(dictionary);
+  CHECK(dictionaries.find(1657320692u) == dictionary);
+
+  nv_ktx::ReadSettings readSettings;
+  readSettings.zstd_dictionaries = &dictionaries;
+  nv_ktx::KTXImage   readImage;
+  std::istringstream inStream(file);
+  CHECK(!readImage.readFromStream(inStream, readSettings).has_value());
+  CHECK(readImage.subresource(0, 0, 0) == pixels);
+
+  nv_ktx::KTXImage   withoutDictionary;
+  std::istringstream withoutStream(file);
+  CHECK(withoutDictionary.readFromStream(withoutStream, {}).has_value());
+}
+
+}  // namespace
+
+int main()
+{
+  testIDs();
+  testRoundTrip();
+  return test_check::result();
+}